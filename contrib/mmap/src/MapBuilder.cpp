@@ -26,6 +26,7 @@
 #include "DetourCommon.h"
 
 #include <climits>
+#include <thread>
 
 using namespace VMAP;
 
@@ -33,7 +34,7 @@ namespace MMAP
 {
     MapBuilder::MapBuilder(float maxWalkableAngle, bool skipLiquid,
                            bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
-                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath) :
+                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath, uint32 threads) :
         m_terrainBuilder(NULL),
         m_debugOutput(debugOutput),
         m_skipContinents(skipContinents),
@@ -41,6 +42,8 @@ namespace MMAP
         m_skipBattlegrounds(skipBattlegrounds),
         m_maxWalkableAngle(maxWalkableAngle),
         m_bigBaseUnit(bigBaseUnit),
+        m_threads(threads ? threads : 1),
+        m_hasTileHashes(false),
         m_rcContext(NULL),
         m_offMeshFilePath(offMeshFilePath)
     {
@@ -206,7 +209,10 @@ namespace MMAP
             return;
         }
 
-        buildTile(mapID, tileX, tileY, navMesh, 1, 1);
+        loadTileHashes(mapID);
+        buildTile(mapID, tileX, tileY, navMesh, 1, 1, false);
+        saveTileHashes(mapID);
+
         dtFreeNavMesh(navMesh);
     }
 
@@ -245,20 +251,32 @@ namespace MMAP
         // now start building mmtiles for each tile
         printf("[Map %03i] We have %u tiles.                          \n", mapID, uint32(tiles->size()));
 
+        // tile id and position in the tile list for the console output
+        std::vector<std::pair<uint32, uint32> > buildList;
         uint32 currentTile = 0;
         for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
         {
             currentTile++;
-            uint32 tileX, tileY;
+            buildList.push_back(std::make_pair(*it, currentTile));
+        }
 
-            // unpack tile coords
-            StaticMapTree::unpackTileID((*it), tileX, tileY);
+        loadTileHashes(mapID);
 
-            if (shouldSkipTile(mapID, tileX, tileY))
-                continue;
+        std::atomic<uint32> nextTile(0);
+        uint32 threadCount = std::min(m_threads, uint32(buildList.size()));
+        if (threadCount > 1)
+        {
+            std::vector<std::thread> workers;
+            for (uint32 i = 0; i < threadCount; ++i)
+                workers.push_back(std::thread(&MapBuilder::buildTiles, this, mapID, std::cref(buildList), std::ref(nextTile), navMesh, uint32(tiles->size())));
 
-            buildTile(mapID, tileX, tileY, navMesh, currentTile, uint32(tiles->size()));
+            for (std::thread& worker : workers)
+                worker.join();
         }
+        else
+            buildTiles(mapID, buildList, nextTile, navMesh, uint32(tiles->size()));
+
+        saveTileHashes(mapID);
 
         dtFreeNavMesh(navMesh);
 
@@ -266,7 +284,18 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount)
+    void MapBuilder::buildTiles(uint32 mapID, std::vector<std::pair<uint32, uint32> > const& tiles, std::atomic<uint32>& nextTile, dtNavMesh* navMesh, uint32 tileCount)
+    {
+        for (uint32 i = nextTile++; i < tiles.size(); i = nextTile++)
+        {
+            uint32 tileX, tileY;
+            StaticMapTree::unpackTileID(tiles[i].first, tileX, tileY);
+            buildTile(mapID, tileX, tileY, navMesh, tiles[i].second, tileCount, true);
+        }
+    }
+
+    /**************************************************************************/
+    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount, bool skipUnchanged)
     {
         printf("[Map %03i] Building tile [%02u,%02u] (%02u / %02u)    \n", mapID, tileX, tileY, curTile, tileCount);
 
@@ -300,8 +329,16 @@ namespace MMAP
 
         m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
 
+        // an existing tile is kept as long as it was built from the same input
+        uint64 hash = getTileHash(meshData);
+        if (skipUnchanged && !m_debugOutput && isTileUnchanged(mapID, tileX, tileY, hash))
+            return;
+
         // build navmesh tile
         buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+
+        std::lock_guard<std::mutex> guard(m_tileHashesLock);
+        m_tileHashes[StaticMapTree::packTileID(tileX, tileY)] = hash;
     }
 
     /**************************************************************************/
@@ -685,6 +722,9 @@ namespace MMAP
                 continue;
             }
 
+            // the tiles of a map may be built by several threads
+            std::lock_guard<std::mutex> guard(m_navMeshLock);
+
             dtTileRef tileRef = 0;
             printf("%s Adding tile to navmesh...                          \r", tileString);
             // DT_TILE_FREE_DATA tells detour to unallocate memory when the tile
@@ -851,4 +891,111 @@ namespace MMAP
         return true;
     }
 
+    /**************************************************************************/
+    void MapBuilder::loadTileHashes(uint32 mapID)
+    {
+        m_tileHashes.clear();
+        m_hasTileHashes = false;
+
+        char fileName[25];
+        sprintf(fileName, "mmaps/%03u.mmhash", mapID);
+        FILE* file = fopen(fileName, "r");
+        if (!file)
+            return;
+
+        m_hasTileHashes = true;
+
+        unsigned int tileX, tileY;
+        unsigned long long hash;
+        while (fscanf(file, "%u %u %llx", &tileX, &tileY, &hash) == 3)
+            m_tileHashes[StaticMapTree::packTileID(tileX, tileY)] = uint64(hash);
+
+        fclose(file);
+    }
+
+    /**************************************************************************/
+    void MapBuilder::saveTileHashes(uint32 mapID)
+    {
+        char fileName[25];
+        sprintf(fileName, "mmaps/%03u.mmhash", mapID);
+        FILE* file = fopen(fileName, "w");
+        if (!file)
+        {
+            char message[1024];
+            sprintf(message, "[Map %03i] Failed to open %s for writing!             \n", mapID, fileName);
+            perror(message);
+            return;
+        }
+
+        for (TileHashes::const_iterator itr = m_tileHashes.begin(); itr != m_tileHashes.end(); ++itr)
+        {
+            uint32 tileX, tileY;
+            StaticMapTree::unpackTileID(itr->first, tileX, tileY);
+            fprintf(file, "%02u %02u %016llx\n", tileX, tileY, (unsigned long long)itr->second);
+        }
+
+        fclose(file);
+    }
+
+    /**************************************************************************/
+    static void addDataToHash(uint64& hash, void const* data, size_t size)
+    {
+        unsigned char const* bytes = static_cast<unsigned char const*>(data);
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+
+    template<class T>
+    static void addArrayToHash(uint64& hash, G3D::Array<T> const& array)
+    {
+        uint32 size = uint32(array.size());
+        addDataToHash(hash, &size, sizeof(size));
+        if (size)
+            addDataToHash(hash, array.getCArray(), size * sizeof(T));
+    }
+
+    /**************************************************************************/
+    uint64 MapBuilder::getTileHash(MeshData& meshData)
+    {
+        // FNV-1a over the loaded geometry and the settings it is built with
+        uint64 hash = 14695981039346656037ULL;
+        uint32 settings[] = { uint32(MMAP_VERSION), uint32(DT_NAVMESH_VERSION), uint32(m_bigBaseUnit), uint32(m_terrainBuilder->usesLiquids()) };
+        addDataToHash(hash, settings, sizeof(settings));
+        addDataToHash(hash, &m_maxWalkableAngle, sizeof(m_maxWalkableAngle));
+
+        addArrayToHash(hash, meshData.solidVerts);
+        addArrayToHash(hash, meshData.solidTris);
+        addArrayToHash(hash, meshData.liquidVerts);
+        addArrayToHash(hash, meshData.liquidTris);
+        addArrayToHash(hash, meshData.liquidType);
+        addArrayToHash(hash, meshData.offMeshConnections);
+        addArrayToHash(hash, meshData.offMeshConnectionRads);
+        addArrayToHash(hash, meshData.offMeshConnectionDirs);
+        addArrayToHash(hash, meshData.offMeshConnectionsAreas);
+        addArrayToHash(hash, meshData.offMeshConnectionsFlags);
+
+        return hash;
+    }
+
+    /**************************************************************************/
+    bool MapBuilder::isTileUnchanged(uint32 mapID, uint32 tileX, uint32 tileY, uint64 hash)
+    {
+        if (!shouldSkipTile(mapID, tileX, tileY))
+            return false;
+
+        std::lock_guard<std::mutex> guard(m_tileHashesLock);
+        uint32 tileID = StaticMapTree::packTileID(tileX, tileY);
+        TileHashes::const_iterator itr = m_tileHashes.find(tileID);
+        if (itr != m_tileHashes.end())
+            return itr->second == hash;
+
+        // tiles built before the hashes were recorded are taken as built from the current input
+        if (!m_hasTileHashes)
+        {
+            m_tileHashes[tileID] = hash;
+            return true;
+        }
+
+        return false;
+    }
 }
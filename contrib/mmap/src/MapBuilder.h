@@ -22,6 +22,8 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <atomic>
+#include <mutex>
 
 #include "TerrainBuilder.h"
 #include "IntermediateValues.h"
@@ -39,6 +41,7 @@ using namespace VMAP;
 namespace MMAP
 {
     typedef std::map<uint32, std::set<uint32>*> TileList;
+    typedef std::map<uint32, uint64> TileHashes;            // input hash by tile id
     struct Tile
     {
         Tile() : chf(NULL), solid(NULL), cset(NULL), pmesh(NULL), dmesh(NULL) {}
@@ -67,7 +70,8 @@ namespace MMAP
                        bool skipBattlegrounds   = false,
                        bool debugOutput         = false,
                        bool bigBaseUnit         = false,
-                       const char* offMeshFilePath = NULL);
+                       const char* offMeshFilePath = NULL,
+                       uint32 threads           = 1);
 
             ~MapBuilder();
 
@@ -87,7 +91,10 @@ namespace MMAP
 
             void buildNavMesh(uint32 mapID, dtNavMesh*& navMesh);
 
-            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount);
+            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount, bool skipUnchanged);
+
+            // builds the tiles of the list taken by index, run by every worker thread of buildMap
+            void buildTiles(uint32 mapID, std::vector<std::pair<uint32, uint32> > const& tiles, std::atomic<uint32>& nextTile, dtNavMesh* navMesh, uint32 tileCount);
 
             // move map building
             void buildMoveMapTile(uint32 mapID,
@@ -107,6 +114,12 @@ namespace MMAP
             bool isTransportMap(uint32 mapID);
             bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY);
 
+            // input hashes of the built tiles, a tile is only rebuilt when its terrain, models, offmesh connections or settings changed
+            void loadTileHashes(uint32 mapID);
+            void saveTileHashes(uint32 mapID);
+            uint64 getTileHash(MeshData& meshData);
+            bool isTileUnchanged(uint32 mapID, uint32 tileX, uint32 tileY, uint64 hash);
+
             TerrainBuilder* m_terrainBuilder;
             TileList m_tiles;
 
@@ -120,6 +133,15 @@ namespace MMAP
             float m_maxWalkableAngle;
             bool m_bigBaseUnit;
 
+            // tiles of a map are built by this many threads, they share the read only terrain builder
+            uint32 m_threads;
+            // the navmesh of the map is only used to validate the tiles, one at a time
+            std::mutex m_navMeshLock;
+
+            TileHashes m_tileHashes;                        // of the map being built
+            bool m_hasTileHashes;                           // false when the map was built before the hashes were recorded
+            std::mutex m_tileHashesLock;
+
             // build performance - not really used for now
             rcContext* m_rcContext;
     };
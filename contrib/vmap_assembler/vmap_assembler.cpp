@@ -18,24 +18,30 @@
 
 #include <string>
 #include <iostream>
+#include <cstdlib>
+#include <thread>
 
 #include "TileAssembler.h"
 
 //=======================================================
 int main(int argc, char* argv[])
 {
-    if (argc != 3)
+    if (argc != 3 && argc != 4)
     {
-        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir>" << std::endl;
+        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir> [threads, 0 for all cores]" << std::endl;
         return 1;
     }
 
     std::string src = argv[1];
     std::string dest = argv[2];
 
+    uint32 threads = argc == 4 ? uint32(atoi(argv[3])) : 1;
+    if (!threads)
+        threads = std::thread::hardware_concurrency();
+
     std::cout << "using " << src << " as source directory and writing output to " << dest << std::endl;
 
-    VMAP::TileAssembler tileAssembler(src, dest);
+    VMAP::TileAssembler tileAssembler(src, dest, threads);
 
     if (!tileAssembler.convertWorld2())
     {
@@ -21,6 +21,8 @@
 
 #include "Utilities/LinkedReference/RefManager.h"
 
+#include <vector>
+
 template<class OBJECT> class GridReference;
 
 template<class OBJECT>
@@ -44,5 +46,37 @@ class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
         iterator end() { return iterator(nullptr); }
         iterator rbegin() { return iterator(getLast()); }
         iterator rend() { return iterator(nullptr); }
+
+        // Dense copy of the list in unspecified order, walked instead of the list by the read only visitors.
+        // Must not be iterated by a visitor that can add or remove objects of this container.
+        typedef std::vector<OBJECT*> ObjectArray;
+        ObjectArray const& getObjects() const { return m_objects; }
+
+    private:
+        friend class GridReference<OBJECT>;
+
+        void addObject(GridReference<OBJECT>* ref)
+        {
+            ref->m_objectIndex = m_objects.size();
+            m_objects.push_back(ref->getSource());
+            m_objectRefs.push_back(ref);
+        }
+
+        // swap with the last element, so removal stays O(1)
+        void removeObject(GridReference<OBJECT>* ref)
+        {
+            size_t const index = ref->m_objectIndex;
+            GridReference<OBJECT>* last = m_objectRefs.back();
+
+            m_objects[index] = m_objects.back();
+            m_objectRefs[index] = last;
+            last->m_objectIndex = index;
+
+            m_objects.pop_back();
+            m_objectRefs.pop_back();
+        }
+
+        ObjectArray m_objects;
+        std::vector<GridReference<OBJECT>*> m_objectRefs;
 };
 #endif
@@ -33,25 +33,29 @@ class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
             // called from link()
             this->getTarget()->insertFirst(this);
             this->getTarget()->incSize();
+            this->getTarget()->addObject(this);
         }
 
         void targetObjectDestroyLink() override
         {
             // called from unlink()
             if (this->isValid())
+            {
                 this->getTarget()->decSize();
+                this->getTarget()->removeObject(this);
+            }
         }
 
         void sourceObjectDestroyLink() override
         {
-            // called from invalidate()
+            // called from invalidate(), only done by the destructor of the manager whose object array is already gone
             this->getTarget()->decSize();
         }
 
     public:
 
         GridReference()
-            : Reference<GridRefManager<OBJECT>, OBJECT>()
+            : Reference<GridRefManager<OBJECT>, OBJECT>(), m_objectIndex(0)
         {
         }
 
@@ -64,6 +68,11 @@ class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
         {
             return (GridReference*)Reference<GridRefManager<OBJECT>, OBJECT>::next();
         }
+
+    private:
+        friend class GridRefManager<OBJECT>;
+
+        size_t m_objectIndex;                               // position in the object array of the manager
 };
 
 #endif
@@ -27,18 +27,19 @@
 #include "Timer.h"
 
 #include <cassert>
+#include <bitset>
 
 class GridInfo
 {
     public:
 
         GridInfo()
-            : i_timer(0), i_unloadActiveLockCount(0), i_unloadExplicitLock(false)
+            : i_timer(0), i_timerUpdateTime(0), i_unloadActiveLockCount(0), i_unloadExplicitLock(false)
         {
         }
 
         GridInfo(time_t expiry, bool unload = true)
-            : i_timer(expiry), i_unloadActiveLockCount(0), i_unloadExplicitLock(!unload)
+            : i_timer(expiry), i_timerUpdateTime(0), i_unloadActiveLockCount(0), i_unloadExplicitLock(!unload)
         {
         }
 
@@ -57,9 +58,14 @@ class GridInfo
         void ResetTimeTracker(time_t interval) { i_timer.Reset(interval); }
         void UpdateTimeTracker(time_t diff) { i_timer.Update(diff); }
 
+        // map clock the timer was last updated at, the timer is only updated when the grid state is due
+        uint64 getTimerUpdateTime() const { return i_timerUpdateTime; }
+        void setTimerUpdateTime(uint64 time) { i_timerUpdateTime = time; }
+
     private:
 
         TimeTracker i_timer;
+        uint64 i_timerUpdateTime;
         uint16 i_unloadActiveLockCount : 16;                // lock from active object spawn points (prevent clone loading)
         bool i_unloadExplicitLock      : 1;                 // explicit manual lock or config setting
 };
@@ -120,6 +126,10 @@ class NGrid
         bool isGridObjectDataLoaded() const { return i_GridObjectDataLoaded; }
         void setGridObjectDataLoaded(bool pLoaded) { i_GridObjectDataLoaded = pLoaded; }
 
+        // cells whose grid objects are loaded, all of them unless the map loads cells lazily
+        bool isCellObjectDataLoaded(uint32 x, uint32 y) const { return i_cellObjectDataLoaded.test(x * N + y); }
+        void setCellObjectDataLoaded(uint32 x, uint32 y) { i_cellObjectDataLoaded.set(x * N + y); }
+
         GridInfo* getGridInfoRef() { return &i_GridInfo; }
         const TimeTracker& getTimeTracker() const { return i_GridInfo.getTimeTracker(); }
         bool getUnloadLock() const { return i_GridInfo.getUnloadLock(); }
@@ -194,6 +204,7 @@ class NGrid
         grid_state_t i_cellstate;
         GridType i_cells[N][N];
         bool i_GridObjectDataLoaded;
+        std::bitset<N * N> i_cellObjectDataLoaded;
 };
 
 #endif
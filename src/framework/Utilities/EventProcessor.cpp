@@ -18,9 +18,12 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_order = 0;
     m_aborting = false;
 }
 
@@ -35,12 +38,12 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.front().time <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        BasicEvent* Event = m_events.front().event;
+        std::pop_heap(m_events.begin(), m_events.end());
+        m_events.pop_back();
 
         if (!Event->to_Abort)
         {
@@ -63,39 +66,37 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    // first, abort all existing events, Abort calls may queue new ones and modify the list
+    EventList events;
+    EventList kept;
+    while (!m_events.empty())
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+        events.swap(m_events);
+        for (EventListEntry const& entry : events)
         {
-            delete i_old->second;
-
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
+            entry.event->to_Abort = true;
+            entry.event->Abort(m_time);
+            if (force || entry.event->IsDeletable())
+                delete entry.event;
+            else
+                kept.push_back(entry);
         }
+        events.clear();
     }
 
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
+    m_events.swap(kept);
+    std::make_heap(m_events.begin(), m_events.end());
 }
 
 void EventProcessor::KillEvent(BasicEvent* event)
 {
-    for (EventList::iterator iter = m_events.begin(); iter != m_events.end();)
-    {
-        if (iter->second == event)
-        {
-            delete iter->second;
-            iter = m_events.erase(iter);
-        }
-        else ++iter;
-    }
+    EventList::iterator end = std::remove_if(m_events.begin(), m_events.end(), [event](EventListEntry const& entry) { return entry.event == event; });
+    if (end == m_events.end())
+        return;
+
+    m_events.erase(end, m_events.end());
+    std::make_heap(m_events.begin(), m_events.end());
+    delete event;
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -104,7 +105,8 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    m_events.emplace_back(e_time, m_order++, Event);
+    std::push_heap(m_events.begin(), m_events.end());
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
@@ -21,7 +21,7 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
@@ -55,7 +55,24 @@ class BasicEvent
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+// queued event, events of equal time execute in insertion order
+struct EventListEntry
+{
+    EventListEntry(uint64 time, uint64 order, BasicEvent* event) : time(time), order(order), event(event) {}
+
+    // later entries compare lower, so the earliest one is on top of the heap
+    bool operator<(EventListEntry const& other) const
+    {
+        return time != other.time ? time > other.time : order > other.order;
+    }
+
+    uint64 time;                                            // execution time
+    uint64 order;                                           // insertion number
+    BasicEvent* event;
+};
+
+// binary heap on a vector, the storage is kept across events so queueing an event does not allocate
+typedef std::vector<EventListEntry> EventList;
 
 class EventProcessor
 {
@@ -69,12 +86,14 @@ class EventProcessor
         void KillEvent(BasicEvent* Event);
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         uint64 CalculateTime(uint64 t_offset) const;
-        EventList& GetEvents() { return m_events; }
+        // entries are in heap order, not by time
+        EventList const& GetEvents() const { return m_events; }
 
     protected:
 
         uint64 m_time;
         EventList m_events;
+        uint64 m_order;                                     // insertion number of the next event
         bool m_aborting;
 };
 
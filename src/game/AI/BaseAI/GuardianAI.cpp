@@ -91,11 +91,10 @@ void GuardianAI::EnterEvadeMode()
     m_creature->TriggerEvadeEvents();
 
     // Handle Evade events
+    if (!HasEventType(EVENT_T_EVADE))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-    {
-        if (i.event.event_type == EVENT_T_EVADE)
-            CheckAndReadyEventForExecution(i);
-    }
+    ForEachEvent(EVENT_T_EVADE, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder); });
     ProcessEvents();
 }
@@ -46,12 +46,11 @@ void TotemAI::EnterEvadeMode()
     m_creature->CombatStopWithPets(true);
 
     // Handle Evade events
+    if (!HasEventType(EVENT_T_EVADE))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-    {
-        if (i.event.event_type == EVENT_T_EVADE)
-            CheckAndReadyEventForExecution(i);
-    }
+    ForEachEvent(EVENT_T_EVADE, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder); });
     ProcessEvents();
 }
 
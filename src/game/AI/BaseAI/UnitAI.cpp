@@ -42,7 +42,8 @@ UnitAI::UnitAI(Unit* unit) :
     m_meleeEnabled(true),
     m_reactState(REACT_AGGRESSIVE),
     m_combatScriptHappening(false),
-    m_currentAIOrder(ORDER_NONE)
+    m_currentAIOrder(ORDER_NONE),
+    m_scriptId(0)
 {
 }
 
@@ -86,6 +87,22 @@ void UnitAI::MoveInLineOfSight(Unit* who)
     DetectOrAttack(who);
 }
 
+bool UnitAI::IsInAggroReach(Unit* who) const
+{
+    if (GetReactState() < REACT_DEFENSIVE || m_unit->IsNeutralToAll())
+        return false;
+
+    // same distances as CheckForHelp and DetectOrAttack use, squared distance from center to center
+    float reach = 0.f;
+    if (who->GetObjectGuid().IsCreature() && who->isInCombat())
+        reach = 10.0f + m_unit->GetObjectBoundingRadius() + who->GetObjectBoundingRadius();
+
+    if (HasReactState(REACT_AGGRESSIVE))
+        reach = std::max(reach, m_unit->GetAttackDistance(who));
+
+    return reach > 0.f && m_unit->GetDistance(who, true, DIST_CALC_NONE) <= reach * reach;
+}
+
 void UnitAI::EnterEvadeMode()
 {
     m_unit->RemoveAllAurasOnEvade();
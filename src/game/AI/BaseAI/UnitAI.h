@@ -300,6 +300,13 @@ class UnitAI
          */
         virtual bool IsVisible(Unit* /*who*/) const;
 
+        /**
+         * Broadphase of the relocation notifiers, checked before the visibility of who
+         * Note: AIs may only return false if their MoveInLineOfSight cannot react to who at its current distance
+         * @param pWho Unit* who moved near the creature
+         */
+        virtual bool CanReactInLineOfSight(Unit* /*who*/) const { return true; }
+
         /// Check if this AI can be replaced in possess case
         // virtual bool IsControllable() const { return false; }
 
@@ -364,6 +371,9 @@ class UnitAI
          */
         virtual bool AssistPlayerInCombat(Unit* /*who*/) { return false; }
 
+        // reach of the help call and the attack of UnitAI::MoveInLineOfSight, for AIs not reacting in another way
+        bool IsInAggroReach(Unit* who) const;
+
         /*
          * Called when a spell is interrupted
          * @param spellInfo to specify which spell was interrupted
@@ -422,6 +432,10 @@ class UnitAI
         void SetAIOrder(AIOrders order) { m_currentAIOrder = order; }
         AIOrders GetAIOrder() const { return m_currentAIOrder; }
 
+        // ScriptName id of an AI created by ScriptDevAIMgr, 0 for the AIs of the core
+        void SetScriptId(uint32 scriptId) { m_scriptId = scriptId; }
+        uint32 GetScriptId() const { return m_scriptId; }
+
         bool DoFlee();
         virtual bool DoRetreat() { return false; } // implemented for creatures
         void DoDistance(); // TODO
@@ -487,6 +501,7 @@ class UnitAI
 
         bool m_combatScriptHappening;                    // disables normal combat functions without leaving combat
         AIOrders m_currentAIOrder;
+        uint32 m_scriptId;
 
         Spell const* m_currentSpell;
 };
@@ -94,9 +94,9 @@ inline bool IsEventFlagsFitForNormalMap(uint8 eFlags)
 CreatureEventAI::CreatureEventAI(Creature* creature) : CreatureAI(creature),
     m_EventUpdateTime(0),
     m_EventDiff(0),
+    m_eventTypeMask(0),
     m_depth(0),
     m_Phase(0),
-    m_HasOOCLoSEvent(false),
     m_InvinceabilityHpLevel(0),
     m_throwAIEventMask(0),
     m_throwAIEventStep(0),
@@ -173,9 +173,6 @@ void CreatureEventAI::InitAI()
                 if (storeEvent)
                 {
                     m_CreatureEventAIList.push_back(CreatureEventAIHolder(i));
-                    // Cache for fast use
-                    if (i.event_type == EVENT_T_OOC_LOS)
-                        m_HasOOCLoSEvent = true;
 
                     for (uint32 actionIdx = 0; actionIdx < MAX_ACTIONS; ++actionIdx)
                         if (i.action[actionIdx].type == ACTION_T_CAST)
@@ -209,6 +206,31 @@ void CreatureEventAI::InitAI()
                 m_creature->GetEntry(), m_creature->GetGuidStr().c_str(), aiName.c_str());
         }
     }
+
+    BuildEventTypeIndex();
+}
+
+void CreatureEventAI::BuildEventTypeIndex()
+{
+    // counting sort of the list positions by type, events of a type keep their list order
+    uint16 counts[EVENT_T_END] = {};
+    for (CreatureEventAIHolder const& holder : m_CreatureEventAIList)
+        ++counts[holder.event.event_type];
+
+    m_eventTypeMask = 0;
+    m_eventTypeOffsets[0] = 0;
+    for (uint32 type = 0; type < EVENT_T_END; ++type)
+    {
+        m_eventTypeOffsets[type + 1] = m_eventTypeOffsets[type] + counts[type];
+        if (counts[type])
+            m_eventTypeMask |= uint64(1) << type;
+    }
+
+    uint16 next[EVENT_T_END];
+    std::copy(m_eventTypeOffsets, m_eventTypeOffsets + EVENT_T_END, next);
+    m_eventsByType.resize(m_CreatureEventAIList.size());
+    for (uint32 i = 0; i < m_CreatureEventAIList.size(); ++i)
+        m_eventsByType[next[m_CreatureEventAIList[i].event.event_type]++] = uint16(i);
 }
 
 bool CreatureEventAI::IsTimerExecutedEvent(EventAI_Type type) const
@@ -419,8 +441,7 @@ bool CreatureEventAI::CheckEvent(CreatureEventAIHolder& holder, Unit* actionInvo
             if (!m_creature->isInCombat())
                 return false;
 
-            CreatureEventAI_EventComputedData const& data = (*sEventAIMgr.GetEAIComputedDataMap().find(event.event_id)).second; // always found
-            Unit* pUnit = DoSelectLowestHpFriendly(float(event.friendly_hp.radius), float(event.friendly_hp.hpDeficit), false, data.friendlyHp.targetSelf);
+            Unit* pUnit = DoSelectLowestHpFriendly(float(event.friendly_hp.radius), float(event.friendly_hp.hpDeficit), false, event.computed.friendlyHp.targetSelf);
             if (!pUnit)
                 return false;
 
@@ -799,20 +820,16 @@ bool CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
         case ACTION_T_CAST:
         {
             uint32 selectFlags = 0;
-            uint32 spellId = 0;
+            SpellEntry const* forSpell = nullptr;
             if (!(action.cast.castFlags & (CAST_TRIGGERED | CAST_FORCE_CAST | CAST_FORCE_TARGET_SELF)))
             {
-                spellId = action.cast.spellId;
-                SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(spellId);
-                if (!spellInfo)
+                if (!action.spellInfo)
                     return false;
-                if (!IsIgnoreLosSpellCast(spellInfo))
-                    selectFlags = SELECT_FLAG_IN_LOS;
-                if (action.cast.castFlags & CAST_PLAYER_ONLY)
-                    selectFlags |= SELECT_FLAG_PLAYER;
+                forSpell = action.spellInfo;
+                selectFlags = action.castSelectFlags;
             }
 
-            Unit* target = GetTargetByType(action.cast.target, actionInvoker, AIEventSender, eventTarget, failedTargetSelection, spellId, selectFlags);
+            Unit* target = GetTargetByType(action.cast.target, actionInvoker, AIEventSender, eventTarget, failedTargetSelection, forSpell, selectFlags);
             if (failedTargetSelection)
                 return false;
             uint32 castFlags = action.cast.castFlags &~ (CAST_MAIN_SPELL | CAST_PLAYER_ONLY | CAST_DISTANCE_YOURSELF);
@@ -1402,13 +1419,12 @@ void CreatureEventAI::Reset()
 
 void CreatureEventAI::JustReachedHome()
 {
-    IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    if (HasEventType(EVENT_T_REACHED_HOME))
     {
-        if (i.event.event_type == EVENT_T_REACHED_HOME)
-            CheckAndReadyEventForExecution(i);
+        IncreaseDepthIfNecessary();
+        ForEachEvent(EVENT_T_REACHED_HOME, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder); });
+        ProcessEvents();
     }
-    ProcessEvents();
 
     Reset();
 }
@@ -1418,12 +1434,11 @@ void CreatureEventAI::EnterEvadeMode()
     UnitAI::EnterEvadeMode();
 
     // Handle Evade events
+    if (!HasEventType(EVENT_T_EVADE))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-    {
-        if (i.event.event_type == EVENT_T_EVADE)
-            CheckAndReadyEventForExecution(i);
-    }
+    ForEachEvent(EVENT_T_EVADE, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder); });
     ProcessEvents();
 }
 
@@ -1435,13 +1450,12 @@ void CreatureEventAI::JustDied(Unit* killer)
         SendAIEventAround(AI_EVENT_JUST_DIED, killer, 0, AIEVENT_DEFAULT_THROW_RADIUS);
 
     // Handle On Death events
-    IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    if (HasEventType(EVENT_T_DEATH))
     {
-        if (i.event.event_type == EVENT_T_DEATH)
-            CheckAndReadyEventForExecution(i, killer);
+        IncreaseDepthIfNecessary();
+        ForEachEvent(EVENT_T_DEATH, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder, killer); });
+        ProcessEvents(killer);
     }
-    ProcessEvents(killer);
 
     // reset phase after any death state events
     m_Phase = 0;
@@ -1449,45 +1463,41 @@ void CreatureEventAI::JustDied(Unit* killer)
 
 void CreatureEventAI::KilledUnit(Unit* victim)
 {
+    if (!HasEventType(EVENT_T_KILL))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-    {
-        if (i.event.event_type == EVENT_T_KILL)
-            CheckAndReadyEventForExecution(i, victim);
-    }
+    ForEachEvent(EVENT_T_KILL, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder, victim); });
     ProcessEvents(victim);
 }
 
 void CreatureEventAI::JustSummoned(Creature* summoned)
 {
+    if (!HasEventType(EVENT_T_SUMMONED_UNIT))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-    {
-        if (i.event.event_type == EVENT_T_SUMMONED_UNIT)
-            CheckAndReadyEventForExecution(i, summoned);
-    }
+    ForEachEvent(EVENT_T_SUMMONED_UNIT, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder, summoned); });
     ProcessEvents(summoned);
 }
 
 void CreatureEventAI::SummonedCreatureJustDied(Creature* summoned)
 {
+    if (!HasEventType(EVENT_T_SUMMONED_JUST_DIED))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-    {
-        if (i.event.event_type == EVENT_T_SUMMONED_JUST_DIED)
-            CheckAndReadyEventForExecution(i, summoned);
-    }
+    ForEachEvent(EVENT_T_SUMMONED_JUST_DIED, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder, summoned); });
     ProcessEvents(summoned);
 }
 
 void CreatureEventAI::SummonedCreatureDespawn(Creature* summoned)
 {
+    if (!HasEventType(EVENT_T_SUMMONED_JUST_DESPAWN))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-    {
-        if (i.event.event_type == EVENT_T_SUMMONED_JUST_DESPAWN)
-            CheckAndReadyEventForExecution(i, summoned);
-    }
+    ForEachEvent(EVENT_T_SUMMONED_JUST_DESPAWN, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder, summoned); });
     ProcessEvents(summoned);
 }
 
@@ -1495,13 +1505,15 @@ void CreatureEventAI::ReceiveAIEvent(AIEventType eventType, Unit* sender, Unit*
 {
     MANGOS_ASSERT(sender);
 
+    if (!HasEventType(EVENT_T_RECEIVE_AI_EVENT))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& itr : m_CreatureEventAIList)
+    ForEachEvent(EVENT_T_RECEIVE_AI_EVENT, [&](CreatureEventAIHolder& holder)
     {
-        if (itr.event.event_type == EVENT_T_RECEIVE_AI_EVENT &&
-                itr.event.receiveAIEvent.eventType == uint32(eventType) && (!itr.event.receiveAIEvent.senderEntry || itr.event.receiveAIEvent.senderEntry == sender->GetEntry()))
-            CheckAndReadyEventForExecution(itr, invoker, sender);
-    }
+        if (holder.event.receiveAIEvent.eventType == uint32(eventType) && (!holder.event.receiveAIEvent.senderEntry || holder.event.receiveAIEvent.senderEntry == sender->GetEntry()))
+            CheckAndReadyEventForExecution(holder, invoker, sender);
+    });
     ProcessEvents(invoker, sender);
 }
 
@@ -1543,58 +1555,69 @@ void CreatureEventAI::EnterCombat(Unit* enemy)
 void CreatureEventAI::MoveInLineOfSight(Unit* who)
 {
     // Check for OOC LOS Event
-    IncreaseDepthIfNecessary();
-    if (m_HasOOCLoSEvent && !m_creature->getVictim())
+    if (HasEventType(EVENT_T_OOC_LOS) && !m_creature->getVictim())
     {
-        for (auto& itr : m_CreatureEventAIList)
+        IncreaseDepthIfNecessary();
+        ForEachEvent(EVENT_T_OOC_LOS, [&](CreatureEventAIHolder& holder)
         {
-            if (itr.event.event_type == EVENT_T_OOC_LOS)
-            {
-                // can trigger if closer than fMaxAllowedRange
-                float fMaxAllowedRange = (float)itr.event.ooc_los.maxRange;
+            // can trigger if closer than fMaxAllowedRange
+            float fMaxAllowedRange = (float)holder.event.ooc_los.maxRange;
 
-                // who must be player type if this option is turned on
-                if (!itr.event.ooc_los.playerOnly || who->GetTypeId() == TYPEID_PLAYER)
+            // who must be player type if this option is turned on
+            if (!holder.event.ooc_los.playerOnly || who->GetTypeId() == TYPEID_PLAYER)
+            {
+                // if friendly event && who is not hostile OR hostile event && who is hostile
+                if ((holder.event.ooc_los.noHostile && !m_creature->IsEnemy(who)) ||
+                        ((!holder.event.ooc_los.noHostile) && m_creature->IsEnemy(who)))
                 {
-                    // if friendly event && who is not hostile OR hostile event && who is hostile
-                    if ((itr.event.ooc_los.noHostile && !m_creature->IsEnemy(who)) ||
-                            ((!itr.event.ooc_los.noHostile) && m_creature->IsEnemy(who)))
-                    {
-                        // if range is ok and we are actually in LOS
-                        if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
-                            CheckAndReadyEventForExecution(itr, who);
-                    }
+                    // if range is ok and we are actually in LOS
+                    if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
+                        CheckAndReadyEventForExecution(holder, who);
                 }
             }
-        }
+        });
         ProcessEvents(who);
     }
 
     UnitAI::MoveInLineOfSight(who);
 }
 
+// the max range of the LOS events is not checked here, the events are rare
+bool CreatureEventAI::CanReactInLineOfSight(Unit* who) const
+{
+    return HasEventType(EVENT_T_OOC_LOS) || IsInAggroReach(who);
+}
+
 void CreatureEventAI::SpellHit(Unit* unit, const SpellEntry* spellInfo)
 {
+    if (!HasEventType(EVENT_T_SPELLHIT))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-        if (i.event.event_type == EVENT_T_SPELLHIT)
-            // If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!i.event.spell_hit.spellId || spellInfo->Id == i.event.spell_hit.spellId)
-                if (spellInfo->SchoolMask & i.event.spell_hit.schoolMask)
-                    CheckAndReadyEventForExecution(i, unit);
+    ForEachEvent(EVENT_T_SPELLHIT, [&](CreatureEventAIHolder& holder)
+    {
+        // If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.event.spell_hit.spellId || spellInfo->Id == holder.event.spell_hit.spellId)
+            if (spellInfo->SchoolMask & holder.event.spell_hit.schoolMask)
+                CheckAndReadyEventForExecution(holder, unit);
+    });
 
     ProcessEvents(unit);
 }
 
 void CreatureEventAI::SpellHitTarget(Unit* target, const SpellEntry* spellInfo)
 {
+    if (!HasEventType(EVENT_T_SPELLHIT_TARGET))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-        if (i.event.event_type == EVENT_T_SPELLHIT_TARGET)
-            // If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!i.event.spell_hit_target.spellId || spellInfo->Id == i.event.spell_hit_target.spellId)
-                if (spellInfo->SchoolMask & i.event.spell_hit_target.schoolMask)
-                    CheckAndReadyEventForExecution(i, target);
+    ForEachEvent(EVENT_T_SPELLHIT_TARGET, [&](CreatureEventAIHolder& holder)
+    {
+        // If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.event.spell_hit_target.spellId || spellInfo->Id == holder.event.spell_hit_target.spellId)
+            if (spellInfo->SchoolMask & holder.event.spell_hit_target.schoolMask)
+                CheckAndReadyEventForExecution(holder, target);
+    });
 
     ProcessEvents(target);
 }
@@ -1643,7 +1666,7 @@ inline int32 CreatureEventAI::GetRandActionParam(uint32 rnd, int32 param1, int32
     return 0;
 }
 
-inline Unit* CreatureEventAI::GetTargetByType(uint32 target, Unit* actionInvoker, Unit* AIEventSender, Unit* eventTarget, bool& isError, uint32 forSpellId, uint32 selectFlags) const
+inline Unit* CreatureEventAI::GetTargetByType(uint32 target, Unit* actionInvoker, Unit* AIEventSender, Unit* eventTarget, bool& isError, SpellEntry const* forSpell, uint32 selectFlags) const
 {
     Unit* resTarget;
     switch (target)
@@ -1656,47 +1679,47 @@ inline Unit* CreatureEventAI::GetTargetByType(uint32 target, Unit* actionInvoker
                 isError = true;
             return resTarget;
         case TARGET_T_HOSTILE_SECOND_AGGRO:
-            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_TOPAGGRO, 1, forSpellId, selectFlags);
+            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_TOPAGGRO, 1, forSpell, selectFlags);
             if (!resTarget)
                 isError = true;
             return resTarget;
         case TARGET_T_HOSTILE_LAST_AGGRO:
-            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_BOTTOMAGGRO, 0, forSpellId, selectFlags);
+            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_BOTTOMAGGRO, 0, forSpell, selectFlags);
             if (!resTarget)
                 isError = true;
             return resTarget;
         case TARGET_T_HOSTILE_RANDOM:
-            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 0, forSpellId, selectFlags);
+            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 0, forSpell, selectFlags);
             if (!resTarget)
                 isError = true;
             return resTarget;
         case TARGET_T_HOSTILE_RANDOM_NOT_TOP:
-            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 1, forSpellId, selectFlags);
+            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 1, forSpell, selectFlags);
             if (!resTarget)
                 isError = true;
             return resTarget;
         case TARGET_T_HOSTILE_RANDOM_PLAYER:
-            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 0, forSpellId, SELECT_FLAG_PLAYER | selectFlags);
+            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 0, forSpell, SELECT_FLAG_PLAYER | selectFlags);
             if (!resTarget)
                 isError = true;
             return resTarget;
         case TARGET_T_HOSTILE_RANDOM_NOT_TOP_PLAYER:
-            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 1, forSpellId, SELECT_FLAG_PLAYER | selectFlags);
+            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 1, forSpell, SELECT_FLAG_PLAYER | selectFlags);
             if (!resTarget)
                 isError = true;
             return resTarget;
         case TARGET_T_HOSTILE_RANDOM_MANA:
-            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 0, forSpellId, SELECT_FLAG_POWER_MANA | selectFlags);
+            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_RANDOM, 0, forSpell, SELECT_FLAG_POWER_MANA | selectFlags);
             if (!resTarget)
                 isError = true;
             return resTarget;
         case TARGET_T_NEAREST_AOE_TARGET:
-            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_NEAREST_BY, 0, forSpellId, SELECT_FLAG_USE_EFFECT_RADIUS | selectFlags);
+            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_NEAREST_BY, 0, forSpell, SELECT_FLAG_USE_EFFECT_RADIUS | selectFlags);
             if (!resTarget)
                 isError = true;
             return nullptr; // Only used to check if it exists
         case TARGET_T_HOSTILE_FARTHEST_AWAY:
-            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_FARTHEST_AWAY, 0, forSpellId, SELECT_FLAG_NOT_IN_MELEE_RANGE | selectFlags);
+            resTarget = m_creature->SelectAttackingTarget(ATTACKING_TARGET_FARTHEST_AWAY, 0, forSpell, SELECT_FLAG_NOT_IN_MELEE_RANGE | selectFlags);
             if (!resTarget)
                 isError = true;
             return resTarget;
@@ -1772,17 +1795,15 @@ void CreatureEventAI::DoFindFriendlyMissingBuff(CreatureList& list, float range,
 
 void CreatureEventAI::ReceiveEmote(Player* player, uint32 textEmote)
 {
+    if (!HasEventType(EVENT_T_RECEIVE_EMOTE))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& itr : m_CreatureEventAIList)
+    ForEachEvent(EVENT_T_RECEIVE_EMOTE, [&](CreatureEventAIHolder& holder)
     {
-        if (itr.event.event_type == EVENT_T_RECEIVE_EMOTE)
-        {
-            if (itr.event.receive_emote.emoteId != textEmote)
-                continue;
-
-            CheckAndReadyEventForExecution(itr, player);
-        }
-    }
+        if (holder.event.receive_emote.emoteId == textEmote)
+            CheckAndReadyEventForExecution(holder, player);
+    });
     ProcessEvents(player);
 }
 
@@ -1822,11 +1843,11 @@ void CreatureEventAI::DamageTaken(Unit* dealer, uint32& damage, DamageEffectType
 
 void CreatureEventAI::JustPreventedDeath(Unit* attacker)
 {
+    if (!HasEventType(EVENT_T_DEATH_PREVENTED))
+        return;
+
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-        if (i.event.event_type == EVENT_T_DEATH_PREVENTED)
-            // If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            CheckAndReadyEventForExecution(i, attacker);
+    ForEachEvent(EVENT_T_DEATH_PREVENTED, [&](CreatureEventAIHolder& holder) { CheckAndReadyEventForExecution(holder, attacker); });
 
     ProcessEvents(attacker);
 }
@@ -544,6 +544,22 @@ struct CreatureEventAI_Action
             uint32 param3;
         } raw;
     };
+
+    // resolved at load, so that the action does not look the row up again on each execution
+    SpellEntry const* spellInfo;                            // ACTION_T_CAST, nullptr for nonexistent spells
+    uint32 castSelectFlags;                                 // ACTION_T_CAST, target select flags of a not triggered cast
+};
+
+struct CreatureEventAI_EventComputedData
+{
+    union
+    {
+        // EVENT_T_FRIENDLY_HP
+        struct
+        {
+            bool targetSelf;
+        } friendlyHp;
+    };
 };
 
 struct CreatureEventAI_Event
@@ -733,18 +749,8 @@ struct CreatureEventAI_Event
     };
 
     CreatureEventAI_Action action[MAX_ACTIONS];
-};
 
-struct CreatureEventAI_EventComputedData
-{
-    union
-    {
-        // EVENT_T_FRIENDLY_HP
-        struct
-        {
-            bool targetSelf;
-        } friendlyHp;
-    };
+    CreatureEventAI_EventComputedData computed;             // filled at load from the actions
 };
 
 #define AIEVENT_DEFAULT_THROW_RADIUS    30.0f
@@ -752,7 +758,6 @@ struct CreatureEventAI_EventComputedData
 // Event_Map
 typedef std::vector<CreatureEventAI_Event> CreatureEventAI_Event_Vec;
 typedef std::unordered_map<uint32, CreatureEventAI_Event_Vec> CreatureEventAI_Event_Map;
-typedef std::unordered_map<uint32, CreatureEventAI_EventComputedData> CreatureEventAI_EventComputedData_Map;
 
 struct CreatureEventAI_Summon
 {
@@ -805,6 +810,7 @@ class CreatureEventAI : public CreatureAI
         void JustSummoned(Creature* summoned) override;
         // void AttackStart(Unit* who) override;
         void MoveInLineOfSight(Unit* who) override;
+        bool CanReactInLineOfSight(Unit* who) const override;
         void SpellHit(Unit* unit, const SpellEntry* spellInfo) override;
         void SpellHitTarget(Unit* target, const SpellEntry* spell) override;
         void DamageTaken(Unit* dealer, uint32& damage, DamageEffectType damagetype, SpellEntry const* spellInfo) override;
@@ -825,12 +831,21 @@ class CreatureEventAI : public CreatureAI
         void ResetEvent(CreatureEventAIHolder& holder);
         void CheckAndReadyEventForExecution(CreatureEventAIHolder& holder, Unit* actionInvoker = nullptr, Unit* AIEventSender = nullptr);
         void IncreaseDepthIfNecessary() { if (m_depth >= m_creatureEventAITempList.size()) m_creatureEventAITempList.resize(m_depth + 1); }
+
+        // events of one type in list order, hooks without such events return after checking the mask
+        bool HasEventType(EventAI_Type type) const { return (m_eventTypeMask & (uint64(1) << type)) != 0; }
+        template<class Func> void ForEachEvent(EventAI_Type type, Func func)
+        {
+            for (uint32 i = m_eventTypeOffsets[type]; i < m_eventTypeOffsets[type + 1]; ++i)
+                func(m_CreatureEventAIList[m_eventsByType[i]]);
+        }
+        void BuildEventTypeIndex();
         virtual bool ProcessEvent(CreatureEventAIHolder& holder, Unit* actionInvoker = nullptr, Unit* AIEventSender = nullptr);
         virtual bool ProcessAction(CreatureEventAI_Action const& action, uint32 rnd, uint32 eventId, Unit* actionInvoker, Unit* AIEventSender, Unit* eventTarget);
         inline uint32 GetRandActionParam(uint32 rnd, uint32 param1, uint32 param2, uint32 param3) const;
         inline int32 GetRandActionParam(uint32 rnd, int32 param1, int32 param2, int32 param3) const;
         /// If the bool& param is true, an error should be reported
-        inline Unit* GetTargetByType(uint32 target, Unit* actionInvoker, Unit* AIEventSender, Unit* eventTarget, bool& isError, uint32 forSpellId = 0, uint32 selectFlags = 0) const;
+        inline Unit* GetTargetByType(uint32 target, Unit* actionInvoker, Unit* AIEventSender, Unit* eventTarget, bool& isError, SpellEntry const* forSpell = nullptr, uint32 selectFlags = 0) const;
 
         bool SpawnedEventConditionsCheck(CreatureEventAI_Event const& event) const;
 
@@ -869,10 +884,12 @@ class CreatureEventAI : public CreatureAI
         typedef std::vector<CreatureEventAIHolder> CreatureEventAIList;
         CreatureEventAIList m_CreatureEventAIList;          // Holder for events (stores enabled, time, and eventid)
         std::vector<std::vector<std::reference_wrapper<CreatureEventAIHolder>>> m_creatureEventAITempList; // Holder for events that are ready to go off
+        std::vector<uint16> m_eventsByType;                 // indexes into m_CreatureEventAIList grouped by event type
+        uint16 m_eventTypeOffsets[EVENT_T_END + 1];         // start of each type in m_eventsByType
+        uint64 m_eventTypeMask;                             // types with at least one event
         uint32 m_depth;
 
         uint8  m_Phase;                                     // Current phase, max 32 phases
-        bool   m_HasOOCLoSEvent;                            // Cache if a OOC-LoS Event exists
         uint32 m_InvinceabilityHpLevel;                     // Minimal health level allowed at damage apply
 
         uint32 m_throwAIEventMask;                          // Automatically throw AIEvents that are encoded into this mask
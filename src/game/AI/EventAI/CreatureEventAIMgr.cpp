@@ -599,6 +599,8 @@ void CreatureEventAIMgr::LoadCreatureEventAI_Scripts()
                 CreatureEventAI_Action& action = temp.action[j];
 
                 action.type = EventAI_ActionType(action_type);
+                action.spellInfo = nullptr;
+                action.castSelectFlags = 0;
                 action.raw.param1 = fields[13 + (j * 4)].GetUInt32();
                 action.raw.param2 = fields[14 + (j * 4)].GetUInt32();
                 action.raw.param3 = fields[15 + (j * 4)].GetUInt32();
@@ -721,6 +723,12 @@ void CreatureEventAIMgr::LoadCreatureEventAI_Scripts()
                         if (action.cast.castFlags & CAST_FORCE_TARGET_SELF)
                             action.cast.castFlags |= CAST_TRIGGERED;
 
+                        action.spellInfo = spell;
+                        if (spell && !IsIgnoreLosSpellCast(spell))
+                            action.castSelectFlags = SELECT_FLAG_IN_LOS;
+                        if (action.cast.castFlags & CAST_PLAYER_ONLY)
+                            action.castSelectFlags |= SELECT_FLAG_PLAYER;
+
                         IsValidTargetType(temp.event_type, action.type, action.cast.target, i, j + 1);
 
                         // Some Advanced target type checks - Can have false positives
@@ -1070,32 +1078,24 @@ void CreatureEventAIMgr::LoadCreatureEventAI_Scripts()
                 }
             }
 
-            // Add to list
-            m_CreatureEventAI_Event_Map[creature_id].push_back(temp);
-            ++Count;
-
             switch (temp.event_type)
             {
                 case EVENT_T_FRIENDLY_HP:
                 {
                     // compute data at the end
-                    CreatureEventAI_EventComputedData data;
-                    data.friendlyHp.targetSelf = true;
-                    for (uint32 j = 0; j < MAX_ACTIONS; ++j)
-                    {
-                        CreatureEventAI_Action& action = temp.action[j];
-                        if (temp.action[j].type == ACTION_T_CAST && temp.action[j].cast.target == TARGET_T_EVENT_SPECIFIC)
-                        {
-                            SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(temp.action[j].cast.spellId);
-                            if (spellInfo->HasAttribute(SPELL_ATTR_EX_CANT_TARGET_SELF))
-                                data.friendlyHp.targetSelf = false;
-                        }
-                    }
-                    m_creatureEventAI_ComputedDataMap.emplace(temp.event_id, data);
+                    temp.computed.friendlyHp.targetSelf = true;
+                    for (CreatureEventAI_Action const& action : temp.action)
+                        if (action.type == ACTION_T_CAST && action.cast.target == TARGET_T_EVENT_SPECIFIC && action.spellInfo
+                                && action.spellInfo->HasAttribute(SPELL_ATTR_EX_CANT_TARGET_SELF))
+                            temp.computed.friendlyHp.targetSelf = false;
                     break;
                 }
                 default: break;
             }
+
+            // Add to list
+            m_CreatureEventAI_Event_Map[creature_id].push_back(temp);
+            ++Count;
         }
         while (result->NextRow());
 
@@ -343,7 +343,10 @@ UnitAI* ScriptDevAIMgr::GetCreatureAI(Creature* pCreature) const
     if (!pTempScript || !pTempScript->GetAI)
         return nullptr;
 
-    return pTempScript->GetAI(pCreature);
+    UnitAI* ai = pTempScript->GetAI(pCreature);
+    if (ai)
+        ai->SetScriptId(pCreature->GetScriptId());
+    return ai;
 }
 
 GameObjectAI* ScriptDevAIMgr::GetGameObjectAI(GameObject* gameobject) const
@@ -0,0 +1,145 @@
+/* This file is part of the ScriptDev2 Project. See AUTHORS file for Copyright information
+ * This program is free software licensed under GPL version 2
+ * Please see the included DOCS/LICENSE.TXT for more information */
+
+#include "AI/ScriptDevAI/ScriptProfiler.h"
+#include "AI/ScriptDevAI/ScriptDevAIMgr.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+std::atomic<bool> ScriptProfiler::m_enabled(false);
+std::atomic<uint32> ScriptProfiler::m_sampleRate(16);
+
+namespace
+{
+    struct ProfileEntry
+    {
+        ProfileEntry() : count(0), totalUs(0), maxUs(0) {}
+
+        uint64 count;                                       // sampled calls
+        uint64 totalUs;
+        uint64 maxUs;
+    };
+
+    // every thread records into its own table, the lock is only contended while a report is built
+    struct ProfileTable
+    {
+        std::mutex lock;
+        std::unordered_map<uint32, ProfileEntry> entries;
+        uint32 sampleRate;                                  // rate the entries were sampled with
+    };
+
+    std::mutex tablesLock;
+    std::vector<std::shared_ptr<ProfileTable>> tables;      // kept after their thread is gone
+
+    ProfileTable& GetThreadTable()
+    {
+        static thread_local std::shared_ptr<ProfileTable> table;
+        if (!table)
+        {
+            table = std::make_shared<ProfileTable>();
+            table->sampleRate = ScriptProfiler::GetSampleRate();
+            std::lock_guard<std::mutex> guard(tablesLock);
+            tables.push_back(table);
+        }
+        return *table;
+    }
+
+    char const* const hookNames[MAX_SCRIPT_PROFILE_HOOK] = { "UpdateAI", "JustDied", "MoveInLineOfSight" };
+}
+
+bool ScriptProfiler::Sample()
+{
+    static thread_local uint32 counter = 0;
+    if (++counter < GetSampleRate())
+        return false;
+
+    counter = 0;
+    return true;
+}
+
+void ScriptProfiler::Record(uint32 key, uint64 us)
+{
+    ProfileTable& table = GetThreadTable();
+    std::lock_guard<std::mutex> guard(table.lock);
+
+    // a changed rate restarts the table, scaling mixed samples would be wrong
+    uint32 const rate = GetSampleRate();
+    if (table.sampleRate != rate)
+    {
+        table.entries.clear();
+        table.sampleRate = rate;
+    }
+
+    ProfileEntry& entry = table.entries[key];
+    ++entry.count;
+    entry.totalUs += us;
+    entry.maxUs = std::max(entry.maxUs, us);
+}
+
+void ScriptProfiler::Reset()
+{
+    std::lock_guard<std::mutex> guard(tablesLock);
+    for (auto const& table : tables)
+    {
+        std::lock_guard<std::mutex> tableGuard(table->lock);
+        table->entries.clear();
+    }
+}
+
+std::vector<ScriptProfiler::Summary> ScriptProfiler::GetTopEntries(size_t count)
+{
+    std::unordered_map<uint32, Summary> merged;
+    {
+        std::lock_guard<std::mutex> guard(tablesLock);
+        for (auto const& table : tables)
+        {
+            std::lock_guard<std::mutex> tableGuard(table->lock);
+            for (auto const& itr : table->entries)
+            {
+                Summary& summary = merged[itr.first];
+                if (!summary.count)
+                {
+                    summary.scriptId = itr.first >> 8;
+                    summary.hook = ScriptProfileHook(itr.first & 0xFF);
+                }
+                summary.count += itr.second.count * table->sampleRate;
+                summary.totalUs += itr.second.totalUs * table->sampleRate;
+                summary.maxUs = std::max(summary.maxUs, itr.second.maxUs);
+            }
+        }
+    }
+
+    std::vector<Summary> summaries;
+    summaries.reserve(merged.size());
+    for (auto const& itr : merged)
+        summaries.push_back(itr.second);
+
+    std::sort(summaries.begin(), summaries.end(), [](Summary const& a, Summary const& b) { return a.totalUs > b.totalUs; });
+    if (summaries.size() > count)
+        summaries.resize(count);
+
+    return summaries;
+}
+
+char const* ScriptProfiler::GetHookName(ScriptProfileHook hook)
+{
+    return hook < MAX_SCRIPT_PROFILE_HOOK ? hookNames[hook] : "unknown";
+}
+
+void ScriptProfiler::LogReport(size_t count)
+{
+    std::vector<Summary> summaries = GetTopEntries(count);
+    if (summaries.empty())
+        return;
+
+    sLog.outString("Script profile, top " SIZEFMTD " entries by total time, 1 of %u calls sampled:", summaries.size(), GetSampleRate());
+    for (Summary const& summary : summaries)
+        sLog.outString("%8" PRIu64 " calls %8" PRIu64 " ms total avg " UI64FMTD " us max " UI64FMTD " us: %s %s",
+                       summary.count, summary.totalUs / 1000, summary.totalUs / summary.count, summary.maxUs,
+                       sScriptDevAIMgr.GetScriptName(summary.scriptId), GetHookName(summary.hook));
+}
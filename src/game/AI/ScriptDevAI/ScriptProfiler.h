@@ -0,0 +1,84 @@
+/* This file is part of the ScriptDev2 Project. See AUTHORS file for Copyright information
+ * This program is free software licensed under GPL version 2
+ * Please see the included DOCS/LICENSE.TXT for more information */
+
+#ifndef SC_SCRIPTPROFILER_H
+#define SC_SCRIPTPROFILER_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+enum ScriptProfileHook
+{
+    SCRIPT_PROFILE_UPDATE_AI        = 0,                    // UnitAI::UpdateAI
+    SCRIPT_PROFILE_JUST_DIED        = 1,                    // UnitAI::JustDied
+    SCRIPT_PROFILE_MOVE_IN_LOS      = 2,                    // UnitAI::MoveInLineOfSight
+    MAX_SCRIPT_PROFILE_HOOK
+};
+
+// Sampled per script cost of the creature AIs created by ScriptDevAIMgr, collected while enabled.
+// Works like SpellProfiler, only every SampleRate-th scope of a thread is timed and the report is scaled back.
+class ScriptProfiler
+{
+    public:
+        struct Summary
+        {
+            uint32 scriptId;
+            ScriptProfileHook hook;
+            uint64 count;                                   // estimated calls
+            uint64 totalUs;                                 // estimated total time
+            uint64 maxUs;                                   // of the sampled calls
+        };
+
+        // scriptId 0 is an AI of the core and is never timed
+        class Scope
+        {
+            public:
+                Scope(ScriptProfileHook hook, uint32 scriptId) : m_sampled(scriptId && IsEnabled() && Sample())
+                {
+                    if (m_sampled)
+                    {
+                        m_key = (scriptId << 8) | hook;
+                        m_start = std::chrono::steady_clock::now();
+                    }
+                }
+                ~Scope()
+                {
+                    if (m_sampled)
+                        Record(m_key, uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count()));
+                }
+
+                Scope(Scope const&) = delete;
+                Scope& operator=(Scope const&) = delete;
+
+            private:
+                bool m_sampled;
+                uint32 m_key;
+                std::chrono::steady_clock::time_point m_start;
+        };
+
+        static void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+        static void SetSampleRate(uint32 rate) { m_sampleRate.store(rate ? rate : 1, std::memory_order_relaxed); }
+        static uint32 GetSampleRate() { return m_sampleRate.load(std::memory_order_relaxed); }
+
+        static void Reset();
+
+        // entries ordered by estimated total time
+        static std::vector<Summary> GetTopEntries(size_t count);
+        static void LogReport(size_t count);
+
+        static char const* GetHookName(ScriptProfileHook hook);
+
+    private:
+        static bool Sample();
+        static void Record(uint32 key, uint64 us);
+
+        static std::atomic<bool> m_enabled;
+        static std::atomic<uint32> m_sampleRate;
+};
+
+#endif
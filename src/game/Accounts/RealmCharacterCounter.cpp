@@ -0,0 +1,140 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Accounts/RealmCharacterCounter.h"
+#include "Database/DatabaseEnv.h"
+#include "World/World.h"
+
+#include <sstream>
+
+INSTANTIATE_SINGLETON_1(RealmCharacterCounter);
+
+// accounts per statement, keeps the INSERT well below MAX_QUERY_LEN
+static const uint32 FLUSH_CHUNK_SIZE = 500;
+
+void RealmCharacterCounter::Load(uint32 accountId)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_accounts.find(accountId) != m_accounts.end())
+            return;
+
+        m_accounts[accountId];
+    }
+
+    LoginDatabase.AsyncPQuery(&RealmCharacterCounter::HandleLoadResult, accountId,
+                              "SELECT realmid, numchars FROM realmcharacters WHERE acctid = '%u'", accountId);
+}
+
+void RealmCharacterCounter::HandleLoadResult(QueryResult* result, uint32 accountId)
+{
+    RealmCharacterCounter& counter = sRealmCharacterCounter;
+    std::lock_guard<std::mutex> guard(counter.m_lock);
+
+    auto itr = counter.m_accounts.find(accountId);
+    if (itr == counter.m_accounts.end())
+    {
+        delete result;
+        return;
+    }
+
+    AccountCounts& counts = itr->second;
+    counts.otherRealms = 0;
+
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            if (fields[0].GetUInt32() != realmID)
+                counts.otherRealms += fields[1].GetUInt32();
+            // a count set while the query ran is newer than the row
+            else if (counter.m_pending.find(accountId) == counter.m_pending.end())
+                counts.thisRealm = fields[1].GetUInt8();
+        }
+        while (result->NextRow());
+        delete result;
+    }
+
+    counts.loaded = true;
+}
+
+void RealmCharacterCounter::Forget(uint32 accountId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_accounts.erase(accountId);
+}
+
+bool RealmCharacterCounter::GetAccountTotal(uint32 accountId, uint32& total)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_accounts.find(accountId);
+    if (itr == m_accounts.end() || !itr->second.loaded)
+        return false;
+
+    total = itr->second.otherRealms + itr->second.thisRealm;
+    return true;
+}
+
+void RealmCharacterCounter::SetRealmCount(uint32 accountId, uint8 count)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_accounts.find(accountId);
+    if (itr != m_accounts.end())
+        itr->second.thisRealm = count;
+
+    m_pending[accountId] = count;
+}
+
+void RealmCharacterCounter::Flush()
+{
+    std::map<uint32, uint8> pending;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        pending.swap(m_pending);
+    }
+
+    if (pending.empty())
+        return;
+
+    // the rows of one chunk are replaced in one transaction
+    auto itr = pending.begin();
+    while (itr != pending.end())
+    {
+        std::ostringstream accounts;
+        std::ostringstream rows;
+        for (uint32 count = 0; itr != pending.end() && count < FLUSH_CHUNK_SIZE; ++itr, ++count)
+        {
+            if (count)
+            {
+                accounts << ",";
+                rows << ",";
+            }
+            accounts << itr->first;
+            rows << "(" << realmID << "," << itr->first << "," << uint32(itr->second) << ")";
+        }
+
+        LoginDatabase.BeginTransaction();
+        LoginDatabase.PExecute("DELETE FROM realmcharacters WHERE realmid = '%u' AND acctid IN (%s)", realmID, accounts.str().c_str());
+        LoginDatabase.PExecute("INSERT INTO realmcharacters (realmid, acctid, numchars) VALUES %s", rows.str().c_str());
+        LoginDatabase.CommitTransaction();
+    }
+}
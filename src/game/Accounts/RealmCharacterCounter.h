@@ -0,0 +1,71 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef REALMCHARACTERCOUNTER_H
+#define REALMCHARACTERCOUNTER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+class QueryResult;
+
+/**
+ * Character counts of the accounts in realmcharacters, kept in memory so creating a character does not wait for the login database.
+ * The counts of the other realms are read asynchronously when the account opens the character screen,
+ * the counts of this realm are written in bulk by the world timer.
+ */
+class RealmCharacterCounter
+{
+    public:
+        // reads the counts of the account from the login database unless known
+        void Load(uint32 accountId);
+        // drops the counts of an account whose session ends, a pending count is still written
+        void Forget(uint32 accountId);
+
+        // characters of the account on all realms, false while the counts are not loaded
+        bool GetAccountTotal(uint32 accountId, uint32& total);
+        void SetRealmCount(uint32 accountId, uint8 count);
+
+        // writes the changed counts of this realm with one DELETE and one INSERT
+        void Flush();
+
+    private:
+        struct AccountCounts
+        {
+            AccountCounts() : loaded(false), otherRealms(0), thisRealm(0) {}
+
+            bool loaded;
+            uint32 otherRealms;
+            uint8 thisRealm;
+        };
+
+        static void HandleLoadResult(QueryResult* result, uint32 accountId);
+
+        std::mutex m_lock;
+        std::unordered_map<uint32, AccountCounts> m_accounts;
+        std::map<uint32, uint8> m_pending;                  // counts of this realm to write, by account id
+};
+
+#define sRealmCharacterCounter MaNGOS::Singleton<RealmCharacterCounter>::Instance()
+
+#endif
@@ -592,16 +592,16 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
-    // Sort
-    AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
-    std::vector<AuctionEntry*> auctions;
-    auctions.reserve(aucs.size());
+    // converting string that we try to find to lower case
+    std::wstring wsearchedname;
+    if (!Utf8toWStr(searchedname, wsearchedname))
+        return;
 
-    for (const auto& auc : aucs)
-        auctions.push_back(auc.second);
+    wstrToLower(wsearchedname);
 
-    AuctionSorter sorter(Sort, GetPlayer());
-    std::sort(auctions.begin(), auctions.end(), sorter);
+    // candidates from the class index, only the matching ones get sorted
+    std::vector<AuctionEntry*> auctions;
+    auctionHouse->GetAuctionsForItemClass(isFull ? 0xffffffff : auctionMainCategory, isFull ? 0xffffffff : auctionSubCategory, auctions);
 
     // remove fake death
     if (GetPlayer()->IsFeigningDeath())
@@ -615,14 +615,8 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     uint32 totalcount = 0;
     data << uint32(0);
 
-    // converting string that we try to find to lower case
-    std::wstring wsearchedname;
-    if (!Utf8toWStr(searchedname, wsearchedname))
-        return;
-
-    wstrToLower(wsearchedname);
-
-    BuildListAuctionItems(auctions, data, wsearchedname, listfrom, levelmin, levelmax, usable,
+    AuctionSorter sorter(Sort, GetPlayer());
+    BuildListAuctionItems(auctions, sorter, data, wsearchedname, listfrom, levelmin, levelmax, usable,
                           auctionSlotID, auctionMainCategory, auctionSubCategory, quality, count, totalcount, isFull != 0);
 
     data.put<uint32>(0, count);
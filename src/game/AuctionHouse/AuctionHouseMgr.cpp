@@ -77,7 +77,7 @@ uint32 AuctionHouseMgr::GetAuctionDeposit(AuctionHouseEntry const* entry, uint32
 }
 
 // does not clear ram
-void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction)
+void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction, MailInsertBatch* batch /*= nullptr*/)
 {
     Item* pItem = GetAItem(auction->itemGuidLow);
     if (!pItem)
@@ -141,7 +141,9 @@ void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction)
 
         // set owner to bidder (to prevent delete item with sender char deleting)
         // owner in `data` will set at mail receive and item extracting
-        CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = '%u' WHERE guid='%u'", auction->bidder, auction->itemGuidLow);
+        static SqlStatementID updItemOwner;
+        SqlStatement stmt = CharacterDatabase.CreateStatement(updItemOwner, "UPDATE item_instance SET owner_guid = ? WHERE guid = ?");
+        stmt.PExecute(auction->bidder, auction->itemGuidLow);
 
         if (bidder)
             bidder->GetSession()->SendAuctionBidderNotification(auction, true);
@@ -152,19 +154,21 @@ void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction)
         // will delete item or place to receiver mail list
         MailDraft(msgAuctionWonSubject.str(), msgAuctionWonBody.str())
         .AddItem(pItem)
-        .SendMailTo(MailReceiver(bidder, bidder_guid), auction, MAIL_CHECK_MASK_COPIED);
+        .SendMailTo(MailReceiver(bidder, bidder_guid), auction, MAIL_CHECK_MASK_COPIED, 0, batch);
     }
     // receiver not exist
     else
     {
-        CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid='%u'", auction->itemGuidLow);
+        static SqlStatementID delItem;
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delItem, "DELETE FROM item_instance WHERE guid = ?");
+        stmt.PExecute(auction->itemGuidLow);
         RemoveAItem(auction->itemGuidLow);                  // we have to remove the item, before we delete it !!
         auction->itemGuidLow = 0;
         delete pItem;
     }
 }
 
-void AuctionHouseMgr::SendAuctionSalePendingMail(AuctionEntry* auction)
+void AuctionHouseMgr::SendAuctionSalePendingMail(AuctionEntry* auction, MailInsertBatch* batch /*= nullptr*/)
 {
     ObjectGuid owner_guid = ObjectGuid(HIGHGUID_PLAYER, auction->owner);
     Player* owner = sObjectMgr.GetPlayer(owner_guid);
@@ -189,12 +193,12 @@ void AuctionHouseMgr::SendAuctionSalePendingMail(AuctionEntry* auction)
         DEBUG_LOG("AuctionSalePending body string : %s", msgAuctionSalePendingBody.str().c_str());
 
         MailDraft(msgAuctionSalePendingSubject.str(), msgAuctionSalePendingBody.str())
-        .SendMailTo(MailReceiver(owner, owner_guid), auction, MAIL_CHECK_MASK_COPIED);
+        .SendMailTo(MailReceiver(owner, owner_guid), auction, MAIL_CHECK_MASK_COPIED, 0, batch);
     }
 }
 
 // call this method to send mail to auction owner, when auction is successful, it does not clear ram
-void AuctionHouseMgr::SendAuctionSuccessfulMail(AuctionEntry* auction)
+void AuctionHouseMgr::SendAuctionSuccessfulMail(AuctionEntry* auction, MailInsertBatch* batch /*= nullptr*/)
 {
     ObjectGuid owner_guid = ObjectGuid(HIGHGUID_PLAYER, auction->owner);
     Player* owner = sObjectMgr.GetPlayer(owner_guid);
@@ -229,12 +233,12 @@ void AuctionHouseMgr::SendAuctionSuccessfulMail(AuctionEntry* auction)
 
         MailDraft(msgAuctionSuccessfulSubject.str(), auctionSuccessfulBody.str())
         .SetMoney(profit)
-        .SendMailTo(MailReceiver(owner, owner_guid), auction, MAIL_CHECK_MASK_COPIED, HOUR);
+        .SendMailTo(MailReceiver(owner, owner_guid), auction, MAIL_CHECK_MASK_COPIED, HOUR, batch);
     }
 }
 
 // does not clear ram
-void AuctionHouseMgr::SendAuctionExpiredMail(AuctionEntry* auction)
+void AuctionHouseMgr::SendAuctionExpiredMail(AuctionEntry* auction, MailInsertBatch* batch /*= nullptr*/)
 {
     // return an item in auction to its owner by mail
     Item* pItem = GetAItem(auction->itemGuidLow);
@@ -266,12 +270,14 @@ void AuctionHouseMgr::SendAuctionExpiredMail(AuctionEntry* auction)
         // will delete item or place to receiver mail list
         MailDraft(subject.str())
         .AddItem(pItem)
-        .SendMailTo(MailReceiver(owner, owner_guid), auction, MAIL_CHECK_MASK_COPIED);
+        .SendMailTo(MailReceiver(owner, owner_guid), auction, MAIL_CHECK_MASK_COPIED, 0, batch);
     }
     // owner not found
     else
     {
-        CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid='%u'", auction->itemGuidLow);
+        static SqlStatementID delItem;
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delItem, "DELETE FROM item_instance WHERE guid = ?");
+        stmt.PExecute(auction->itemGuidLow);
         RemoveAItem(auction->itemGuidLow);                  // we have to remove the item, before we delete it !!
         auction->itemGuidLow = 0;
         delete pItem;
@@ -281,7 +287,8 @@ void AuctionHouseMgr::SendAuctionExpiredMail(AuctionEntry* auction)
 void AuctionHouseMgr::LoadAuctionItems()
 {
     // data needs to be at first place for Item::LoadFromDB 0  1        2
-    QueryResult* result = CharacterDatabase.Query("SELECT data,itemguid,item_template FROM auction JOIN item_instance ON itemguid = guid");
+    // streamed, the item data of all auctions is too large to be buffered at once
+    QueryResult* result = CharacterDatabase.QueryStream("SELECT data,itemguid,item_template FROM auction JOIN item_instance ON itemguid = guid");
 
     if (!result)
     {
@@ -488,7 +495,7 @@ bool AuctionHouseMgr::RemoveAItem(uint32 id)
 void AuctionHouseMgr::Update()
 {
     for (auto& mAuction : mAuctions)
-        mAuction.Update();
+        mAuction.Update(sWorld.getConfig(CONFIG_UINT32_AUCTION_EXPIRED_PER_UPDATE));
 }
 
 uint32 AuctionHouseMgr::GetAuctionHouseTeam(AuctionHouseEntry const* house)
@@ -569,33 +576,156 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(Unit* unit)
     return sAuctionHouseStore.LookupEntry(houseid);
 }
 
-void AuctionHouseObject::Update()
+std::wstring const& AuctionHouseMgr::GetSearchName(ItemPrototype const* proto, int locIdx)
+{
+    uint64 key = (uint64(uint32(locIdx + 1)) << 32) | proto->ItemId;
+    auto itr = m_searchNames.find(key);
+    if (itr != m_searchNames.end())
+        return itr->second;
+
+    std::string name = proto->Name1;
+    sObjectMgr.GetItemLocaleStrings(proto->ItemId, locIdx, &name);
+
+    // names not convertible stay empty and never match a search, like with Utf8FitTo
+    std::wstring& searchName = m_searchNames[key];
+    if (Utf8toWStr(name, searchName))
+        wstrToLower(searchName);
+    else
+        searchName.clear();
+    return searchName;
+}
+
+void AuctionHouseObject::AddAuction(AuctionEntry* ah)
+{
+    MANGOS_ASSERT(ah);
+    AuctionsMap[ah->Id] = ah;
+    IndexAuction(ah);
+}
+
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+        return false;
+
+    UnindexAuction(itr->second);
+    AuctionsMap.erase(itr);
+    return true;
+}
+
+void AuctionHouseObject::SetExpireTime(AuctionEntry* auction, time_t expireTime)
+{
+    m_auctionsByExpireTime.erase(std::make_pair(auction->expireTime, auction->Id));
+    auction->expireTime = expireTime;
+    m_auctionsByExpireTime.insert(std::make_pair(auction->expireTime, auction->Id));
+}
+
+void AuctionHouseObject::IndexAuction(AuctionEntry* auction)
+{
+    m_auctionsByExpireTime.insert(std::make_pair(auction->expireTime, auction->Id));
+
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+    {
+        m_auctionsByClass[GetItemClassKey(0xFFFF, 0xFFFF)].insert(auction);
+        return;
+    }
+
+    m_auctionsByClass[GetItemClassKey(proto->Class, proto->SubClass)].insert(auction);
+    if (!auction->owner)
+        ++m_serverAuctionCount[GetItemClassKey(proto->Quality, proto->Class)];
+}
+
+void AuctionHouseObject::UnindexAuction(AuctionEntry* auction)
+{
+    m_auctionsByExpireTime.erase(std::make_pair(auction->expireTime, auction->Id));
+
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    AuctionClassIndex::iterator itr = m_auctionsByClass.find(proto ? GetItemClassKey(proto->Class, proto->SubClass) : GetItemClassKey(0xFFFF, 0xFFFF));
+    if (itr != m_auctionsByClass.end())
+    {
+        itr->second.erase(auction);
+        if (itr->second.empty())
+            m_auctionsByClass.erase(itr);
+    }
+
+    if (proto && !auction->owner)
+    {
+        auto countItr = m_serverAuctionCount.find(GetItemClassKey(proto->Quality, proto->Class));
+        if (countItr != m_serverAuctionCount.end() && countItr->second && !--countItr->second)
+            m_serverAuctionCount.erase(countItr);
+    }
+}
+
+void AuctionHouseObject::GetAuctionsForItemClass(uint32 itemClass, uint32 itemSubClass, std::vector<AuctionEntry*>& auctions) const
+{
+    if (itemClass == 0xffffffff)
+    {
+        auctions.reserve(AuctionsMap.size());
+        for (const auto& auc : AuctionsMap)
+            auctions.push_back(auc.second);
+        return;
+    }
+
+    // no prototype uses values that do not fit the key
+    if (itemClass >= 0xFFFF || (itemSubClass != 0xffffffff && itemSubClass >= 0xFFFF))
+        return;
+
+    AuctionClassIndex::const_iterator first, last;
+    if (itemSubClass == 0xffffffff)
+    {
+        first = m_auctionsByClass.lower_bound(GetItemClassKey(itemClass, 0));
+        last = m_auctionsByClass.lower_bound(GetItemClassKey(itemClass + 1, 0));
+    }
+    else
+    {
+        first = m_auctionsByClass.find(GetItemClassKey(itemClass, itemSubClass));
+        if (first == m_auctionsByClass.end())
+            return;
+        last = std::next(first);
+    }
+
+    for (; first != last; ++first)
+        auctions.insert(auctions.end(), first->second.begin(), first->second.end());
+}
+
+void AuctionHouseObject::Update(uint32 limit)
 {
     time_t curTime = sWorld.GetGameTime();
-    ///- Handle expired auctions
-    for (AuctionEntryMap::iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end();)
+    if (m_auctionsByExpireTime.empty() || curTime < m_auctionsByExpireTime.begin()->first)
+        return;
+
+    CharacterDatabase.BeginTransaction();
+    MailInsertBatch batch;
+
+    ///- Handle expired auctions, each of them leaves the index
+    for (; limit && !m_auctionsByExpireTime.empty() && m_auctionsByExpireTime.begin()->first <= curTime; --limit)
     {
-        if (curTime < itr->second->expireTime)
+        AuctionEntryMap::iterator itr = AuctionsMap.find(m_auctionsByExpireTime.begin()->second);
+        if (itr == AuctionsMap.end())
         {
-            itr++;
+            m_auctionsByExpireTime.erase(m_auctionsByExpireTime.begin());
             continue;
         }
 
-        ///- perform the transaction if there was bidder.  this will alyways have the side effect of
-        ///- removing the auction from the collection.  therefore we must increment the iterator here.
+        ///- perform the transaction if there was bidder, this removes the auction from the collection
         if (itr->second->bid)
-            (itr++)->second->AuctionBidWinning();
+            itr->second->AuctionBidWinning(nullptr, &batch);
         ///- cancel the auction if there was no bidder and clear the auction
         else
         {
-            sAuctionMgr.SendAuctionExpiredMail(itr->second);
+            sAuctionMgr.SendAuctionExpiredMail(itr->second, &batch);
 
             itr->second->DeleteFromDB();
             sAuctionMgr.RemoveAItem(itr->second->itemGuidLow);
+            UnindexAuction(itr->second);
             delete itr->second;
-            AuctionsMap.erase(itr++);
+            AuctionsMap.erase(itr);
         }
     }
+
+    batch.Flush();
+    CharacterDatabase.CommitTransaction();
 }
 
 void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount)
@@ -786,67 +916,67 @@ bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc
     return false;                                           // "equal" by all sorts
 }
 
-void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
+void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*>& auctions, AuctionSorter const& sorter, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
         uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull) const
 {
     int loc_idx = _player->GetSession()->GetSessionDbLocaleIndex();
 
-    for (auto Aentry : auctions)
+    // drop the auctions not matching first, only the result is sorted
+    auctions.erase(std::remove_if(auctions.begin(), auctions.end(), [&](AuctionEntry* Aentry)
     {
         Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
         if (!item)
-            continue;
+            return true;
 
         if (isFull)
-        {
-            ++count;
-            Aentry->BuildAuctionInfo(data);
-        }
-        else
-        {
-            ItemPrototype const* proto = item->GetProto();
+            return false;
 
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
-                continue;
+        ItemPrototype const* proto = item->GetProto();
 
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-                continue;
+        if (itemClass != 0xffffffff && proto->Class != itemClass)
+            return true;
 
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-                continue;
+        if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
+            return true;
 
-            if (quality != 0xffffffff && proto->Quality < quality)
-                continue;
+        if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
+            return true;
 
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-                continue;
+        if (quality != 0xffffffff && proto->Quality < quality)
+            return true;
 
-            if (usable != 0x00)
-            {
-                if (_player->CanUseItem(item) != EQUIP_ERR_OK)
-                    continue;
+        if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
+            return true;
 
-                if (proto->Class == ITEM_CLASS_RECIPE)
+        if (usable != 0x00)
+        {
+            if (_player->CanUseItem(item) != EQUIP_ERR_OK)
+                return true;
+
+            if (proto->Class == ITEM_CLASS_RECIPE)
+            {
+                if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
                 {
-                    if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
-                    {
-                        if (_player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
-                            continue;
-                    }
+                    if (_player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
+                        return true;
                 }
             }
+        }
 
-            std::string name = proto->Name1;
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+        if (!wsearchedname.empty() && sAuctionMgr.GetSearchName(proto, loc_idx).find(wsearchedname) == std::wstring::npos)
+            return true;
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-                continue;
+        return false;
+    }), auctions.end());
 
-            if (count < 50 && totalcount >= listfrom)
-            {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
-            }
+    std::sort(auctions.begin(), auctions.end(), sorter);
+
+    for (auto Aentry : auctions)
+    {
+        if (isFull || (count < 50 && totalcount >= listfrom))
+        {
+            ++count;
+            Aentry->BuildAuctionInfo(data);
         }
 
         ++totalcount;
@@ -949,32 +1079,48 @@ uint32 AuctionEntry::GetAuctionOutBid() const
 
 void AuctionEntry::DeleteFromDB() const
 {
-    // No SQL injection (Id is integer)
-    CharacterDatabase.PExecute("DELETE FROM auction WHERE id = '%u'", Id);
+    static SqlStatementID delAuction;
+    SqlStatement stmt = CharacterDatabase.CreateStatement(delAuction, "DELETE FROM auction WHERE id = ?");
+    stmt.PExecute(Id);
 }
 
 void AuctionEntry::SaveToDB() const
 {
-    // No SQL injection (no strings)
-    CharacterDatabase.PExecute("INSERT INTO auction (id,houseid,itemguid,item_template,item_count,item_randompropertyid,itemowner,buyoutprice,time,buyguid,lastbid,startbid,deposit) "
-                               "VALUES ('%u', '%u', '%u', '%u', '%u', '%i', '%u', '%u', '" UI64FMTD "', '%u', '%u', '%u', '%u')",
-                               Id, auctionHouseEntry->houseId, itemGuidLow, itemTemplate, itemCount, itemRandomPropertyId, owner, buyout, (uint64)expireTime, bidder, bid, startbid, deposit);
+    static SqlStatementID insAuction;
+    SqlStatement stmt = CharacterDatabase.CreateStatement(insAuction, "INSERT INTO auction (id,houseid,itemguid,item_template,item_count,item_randompropertyid,itemowner,buyoutprice,time,buyguid,lastbid,startbid,deposit) "
+                        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    stmt.addUInt32(Id);
+    stmt.addUInt32(auctionHouseEntry->houseId);
+    stmt.addUInt32(itemGuidLow);
+    stmt.addUInt32(itemTemplate);
+    stmt.addUInt32(itemCount);
+    stmt.addInt32(itemRandomPropertyId);
+    stmt.addUInt32(owner);
+    stmt.addUInt32(buyout);
+    stmt.addUInt64(uint64(expireTime));
+    stmt.addUInt32(bidder);
+    stmt.addUInt32(bid);
+    stmt.addUInt32(startbid);
+    stmt.addUInt32(deposit);
+    stmt.Execute();
 }
 
-void AuctionEntry::AuctionBidWinning(Player* newbidder)
+void AuctionEntry::AuctionBidWinning(Player* newbidder, MailInsertBatch* batch)
 {
-    sAuctionMgr.SendAuctionSalePendingMail(this);
-    sAuctionMgr.SendAuctionSuccessfulMail(this);
-    sAuctionMgr.SendAuctionWonMail(this);
+    sAuctionMgr.SendAuctionSalePendingMail(this, batch);
+    sAuctionMgr.SendAuctionSuccessfulMail(this, batch);
+    sAuctionMgr.SendAuctionWonMail(this, batch);
 
     sAuctionMgr.RemoveAItem(this->itemGuidLow);
     sAuctionMgr.GetAuctionsMap(this->auctionHouseEntry)->RemoveAuction(this->Id);
 
-    CharacterDatabase.BeginTransaction();
+    if (!batch)
+        CharacterDatabase.BeginTransaction();
     this->DeleteFromDB();
     if (newbidder)
         newbidder->SaveInventoryAndGoldToDB();
-    CharacterDatabase.CommitTransaction();
+    if (!batch)
+        CharacterDatabase.CommitTransaction();
 
     delete this;
 }
@@ -1009,8 +1155,10 @@ bool AuctionEntry::UpdateBid(uint32 newbid, Player* newbidder /*=nullptr*/)
             auction_owner->GetSession()->SendAuctionOwnerNotification(this, false);
 
         // after this update we should save player's money ...
+        static SqlStatementID updAuctionBid;
         CharacterDatabase.BeginTransaction();
-        CharacterDatabase.PExecute("UPDATE auction SET buyguid = '%u', lastbid = '%u' WHERE id = '%u'", bidder, bid, Id);
+        SqlStatement stmt = CharacterDatabase.CreateStatement(updAuctionBid, "UPDATE auction SET buyguid = ?, lastbid = ? WHERE id = ?");
+        stmt.PExecute(bidder, bid, Id);
         if (newbidder)
             newbidder->SaveInventoryAndGoldToDB();
         CharacterDatabase.CommitTransaction();
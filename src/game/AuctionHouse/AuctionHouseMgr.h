@@ -21,11 +21,18 @@
 
 #include "Common.h"
 #include "Server/DBCStructure.h"
+#include "MemoryTracker.h"
+
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 class Item;
+class MailInsertBatch;
 class Player;
 class Unit;
 class WorldPacket;
+struct ItemPrototype;
 
 #define MIN_AUCTION_TIME (12*HOUR)
 #define MAX_AUCTION_SORT 12
@@ -67,6 +74,7 @@ struct AuctionEntry
     uint32 bidder;                                          // current bidder player lowguid, can be 0 if bid generated by server, use 'bid'!=0 for check bid existance
     uint32 deposit;                                         // deposit can be calculated only when creating auction
     AuctionHouseEntry const* auctionHouseEntry;             // in AuctionHouse.dbc
+    TrackedMemory<MEMORY_TAG_AUCTIONS, AuctionEntry> trackedMemory;
 
     // helpers
     uint32 GetHouseId() const { return auctionHouseEntry->houseId; }
@@ -76,7 +84,8 @@ struct AuctionEntry
     bool BuildAuctionInfo(WorldPacket& data) const;
     void DeleteFromDB() const;
     void SaveToDB() const;
-    void AuctionBidWinning(Player* newbidder = nullptr);
+    // with a batch the mails and deletes go into the transaction the caller has open
+    void AuctionBidWinning(Player* newbidder = nullptr, MailInsertBatch* batch = nullptr);
 
     // -1,0,+1 order result
     int CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Player* viewPlayer) const;
@@ -103,11 +112,7 @@ class AuctionHouseObject
         AuctionEntryMap const& GetAuctions() const { return AuctionsMap; }
         AuctionEntryMapBounds GetAuctionsBounds() const {return AuctionEntryMapBounds(AuctionsMap.begin(), AuctionsMap.end()); }
 
-        void AddAuction(AuctionEntry* ah)
-        {
-            MANGOS_ASSERT(ah);
-            AuctionsMap[ah->Id] = ah;
-        }
+        void AddAuction(AuctionEntry* ah);
 
         AuctionEntry* GetAuction(uint32 id) const
         {
@@ -115,16 +120,42 @@ class AuctionHouseObject
             return itr != AuctionsMap.end() ? itr->second : nullptr;
         }
 
-        bool RemoveAuction(uint32 id) { return !!AuctionsMap.erase(id); }
+        bool RemoveAuction(uint32 id);
 
-        void Update();
+        // use instead of writing expireTime of an added auction, keeps the expire time index in order
+        void SetExpireTime(AuctionEntry* auction, time_t expireTime);
+
+        // auctions of the item class and subclass, 0xffffffff for any, unordered
+        void GetAuctionsForItemClass(uint32 itemClass, uint32 itemSubClass, std::vector<AuctionEntry*>& auctions) const;
+
+        // auctions without an owner player (AHBot) by item quality and class
+        uint32 GetServerAuctionCount(uint32 quality, uint32 itemClass) const
+        {
+            auto itr = m_serverAuctionCount.find(GetItemClassKey(quality, itemClass));
+            return itr != m_serverAuctionCount.end() ? itr->second : 0;
+        }
+
+        // ends at most limit expired auctions, their mails and deletes in one transaction
+        void Update(uint32 limit);
 
         void BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
         void BuildListOwnerItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
 
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = nullptr);
     private:
+        // item class in the high, subclass in the low 16 bits
+        typedef std::map<uint32, std::unordered_set<AuctionEntry*>> AuctionClassIndex;
+        // expire time and auction id, soonest first
+        typedef std::set<std::pair<time_t, uint32>> AuctionExpireIndex;
+
+        static uint32 GetItemClassKey(uint32 itemClass, uint32 itemSubClass) { return (itemClass << 16) | (itemSubClass & 0xFFFF); }
+        void IndexAuction(AuctionEntry* auction);
+        void UnindexAuction(AuctionEntry* auction);
+
         AuctionEntryMap AuctionsMap;
+        AuctionClassIndex m_auctionsByClass;                // AuctionsMap by prototype class and subclass
+        std::unordered_map<uint32, uint32> m_serverAuctionCount;    // by prototype quality and class, same key layout
+        AuctionExpireIndex m_auctionsByExpireTime;
 };
 
 class AuctionSorter
@@ -170,10 +201,10 @@ class AuctionHouseMgr
         }
 
         // auction messages
-        void SendAuctionWonMail(AuctionEntry* auction);
-        void SendAuctionSalePendingMail(AuctionEntry* auction);
-        static void SendAuctionSuccessfulMail(AuctionEntry* auction);
-        void SendAuctionExpiredMail(AuctionEntry* auction);
+        void SendAuctionWonMail(AuctionEntry* auction, MailInsertBatch* batch = nullptr);
+        void SendAuctionSalePendingMail(AuctionEntry* auction, MailInsertBatch* batch = nullptr);
+        static void SendAuctionSuccessfulMail(AuctionEntry* auction, MailInsertBatch* batch = nullptr);
+        void SendAuctionExpiredMail(AuctionEntry* auction, MailInsertBatch* batch = nullptr);
         static uint32 GetAuctionDeposit(AuctionHouseEntry const* entry, uint32 time, Item* pItem);
 
         static uint32 GetAuctionHouseTeam(AuctionHouseEntry const* house);
@@ -189,9 +220,15 @@ class AuctionHouseMgr
 
         void Update();
 
+        // lower case name used by the browse search, built once per item entry and locale
+        std::wstring const& GetSearchName(ItemPrototype const* proto, int locIdx);
+        void ClearSearchNames() { m_searchNames.clear(); }
+
     private:
         AuctionHouseObject  mAuctions[MAX_AUCTION_HOUSE_TYPE];
 
+        std::unordered_map<uint64, std::wstring> m_searchNames;   // by locale index and item entry
+
         ItemMap             mAitems;
 };
 
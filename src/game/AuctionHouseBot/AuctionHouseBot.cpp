@@ -57,7 +57,7 @@ typedef std::map<uint32, BuyerAuctionEval > CheckEntryMap;
 struct AHB_Buyer_Config
 {
     public:
-        AHB_Buyer_Config() : FactionChance(0), BuyerEnabled(false), BuyerPriceRatio(0), m_houseType(AUCTION_HOUSE_NEUTRAL) {}
+        AHB_Buyer_Config() : FactionChance(0), BuyerEnabled(false), BuyerPriceRatio(0), ScanCursor(0), ScanStart(0), LastScanStart(0), m_houseType(AUCTION_HOUSE_NEUTRAL) {}
 
         void Initialize(AuctionHouseType houseType)
         {
@@ -73,6 +73,12 @@ struct AHB_Buyer_Config
         bool             BuyerEnabled;
         uint32           BuyerPriceRatio;
 
+        // the auction house is scanned in slices, SameItemInfo is replaced once a scan reached the end
+        BuyerItemInfoMap ScanItemInfo;
+        uint32           ScanCursor;                        // next auction id to scan, 0 starts a new scan
+        time_t           ScanStart;
+        time_t           LastScanStart;                     // start of the last finished scan
+
     private:
         AuctionHouseType m_houseType;
 };
@@ -385,6 +391,7 @@ void AuctionBotConfig::GetConfigFromFile()
     setConfigMinMax(CONFIG_UINT32_AHBOT_BUYER_CHANCE_RATIO_HORDE   , "AuctionHouseBot.Buyer.Horde.Chance.Ratio"   , 3, 1, 100);
     setConfigMinMax(CONFIG_UINT32_AHBOT_BUYER_CHANCE_RATIO_NEUTRAL , "AuctionHouseBot.Buyer.Neutral.Chance.Ratio" , 3, 1, 100);
     setConfigMinMax(CONFIG_UINT32_AHBOT_BUYER_RECHECK_INTERVAL     , "AuctionHouseBot.Buyer.Recheck.Interval"     , 20, 1, DAY / MINUTE);
+    setConfig(CONFIG_UINT32_AHBOT_BUYER_SCAN_PER_CYCLE             , "AuctionHouseBot.Buyer.ScanPerCycle"         , 1000);
 
     setConfig(CONFIG_BOOL_AHBOT_DEBUG_SELLER                 , "AuctionHouseBot.DEBUG.Seller"               , false);
     setConfig(CONFIG_BOOL_AHBOT_DEBUG_BUYER                  , "AuctionHouseBot.DEBUG.Buyer"                , false);
@@ -527,12 +534,20 @@ void AuctionBotBuyer::LoadConfig()
 
 uint32 AuctionBotBuyer::GetBuyableEntry(AHB_Buyer_Config& config) const
 {
-    config.SameItemInfo.clear();
     uint32 count = 0;
     time_t Now = time(nullptr);
 
-    AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(config.GetHouseType())->GetAuctionsBounds();
-    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+    if (!config.ScanCursor)
+    {
+        config.ScanItemInfo.clear();
+        config.ScanStart = Now;
+    }
+
+    // continue the scan where the last cycle stopped, at most ScanPerCycle auctions
+    uint32 scanLimit = sAuctionBotConfig.getConfig(CONFIG_UINT32_AHBOT_BUYER_SCAN_PER_CYCLE);
+    AuctionHouseObject::AuctionEntryMap const& auctions = sAuctionMgr.GetAuctionsMap(config.GetHouseType())->GetAuctions();
+    AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctions.lower_bound(config.ScanCursor);
+    for (uint32 scanned = 0; itr != auctions.end() && (!scanLimit || scanned < scanLimit); ++itr, ++scanned)
     {
         AuctionEntry* Aentry = itr->second;
         Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
@@ -541,7 +556,7 @@ uint32 AuctionBotBuyer::GetBuyableEntry(AHB_Buyer_Config& config) const
             ItemPrototype const* prototype = item->GetProto();
             if (prototype)
             {
-                BuyerItemInfo& buyerItem = config.SameItemInfo[item->GetEntry()];    // Structure constructor will make sure Element are correctly initialised if entry is created here.
+                BuyerItemInfo& buyerItem = config.ScanItemInfo[item->GetEntry()];    // Structure constructor will make sure Element are correctly initialised if entry is created here.
                 ++buyerItem.ItemCount;
                 buyerItem.BuyPrice = buyerItem.BuyPrice + (double(Aentry->buyout) / item->GetCount());
                 buyerItem.BidPrice = buyerItem.BidPrice + (double(Aentry->startbid) / item->GetCount());
@@ -588,6 +603,15 @@ uint32 AuctionBotBuyer::GetBuyableEntry(AHB_Buyer_Config& config) const
         }
     }
 
+    if (itr == auctions.end())
+    {
+        config.SameItemInfo.swap(config.ScanItemInfo);
+        config.LastScanStart = config.ScanStart;
+        config.ScanCursor = 0;
+    }
+    else
+        config.ScanCursor = itr->first;
+
     DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: %u items added to buyable vector for ah type: %u", count, config.GetHouseType());
     DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: SameItemInfo size = " SIZEFMTD, config.SameItemInfo.size());
     return count;
@@ -595,11 +619,10 @@ uint32 AuctionBotBuyer::GetBuyableEntry(AHB_Buyer_Config& config) const
 
 void AuctionBotBuyer::PrepareListOfEntry(AHB_Buyer_Config& config) const
 {
-    time_t Now = time(nullptr) - 5;
-
+    // entries not seen by the last finished scan are no longer buyable
     for (CheckEntryMap::iterator itr = config.CheckedEntry.begin(); itr != config.CheckedEntry.end();)
     {
-        if (itr->second.LastExist  < (Now - 5))
+        if (itr->second.LastExist < config.LastScanStart)
             itr = config.CheckedEntry.erase(itr);
         else
             ++itr;
@@ -859,7 +882,8 @@ bool AuctionBotBuyer::Update(AuctionHouseType houseType)
     if (sAuctionBotConfig.getConfigBuyerEnabled(houseType))
     {
         DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: %s buying ...", AuctionBotConfig::GetHouseTypeName(houseType));
-        if (GetBuyableEntry(m_HouseConfig[houseType]) > 0)
+        GetBuyableEntry(m_HouseConfig[houseType]);
+        if (!m_HouseConfig[houseType].CheckedEntry.empty())
             addNewAuctionBuyerBotBid(m_HouseConfig[houseType]);
         return true;
     }
@@ -1418,31 +1442,15 @@ void AuctionBotSeller::LoadSellerValues(AHB_Seller_Config& config) const
 // Fill ItemInfos object with real content of AH.
 uint32 AuctionBotSeller::SetStat(AHB_Seller_Config& config) const
 {
-    std::vector<std::vector<uint32> > ItemsInAH(MAX_AUCTION_QUALITY, std::vector< uint32 > (MAX_ITEM_CLASS));
+    // ahbot items are counted by the auction house on add and remove
+    AuctionHouseObject const* auctionHouse = sAuctionMgr.GetAuctionsMap(config.GetHouseType());
 
-    AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(config.GetHouseType())->GetAuctionsBounds();
-    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
-    {
-        AuctionEntry* Aentry = itr->second;
-        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (item)
-        {
-            ItemPrototype const* prototype = item->GetProto();
-            if (prototype)
-            {
-                if (!Aentry->owner)                         // Add only ahbot items
-                {
-                    ++ItemsInAH[prototype->Quality][prototype->Class];
-                }
-            }
-        }
-    }
     uint32 count = 0;
     for (uint32 j = 0; j < MAX_AUCTION_QUALITY; ++j)
     {
         for (uint32 i = 0; i < MAX_ITEM_CLASS; ++i)
         {
-            config.SetMissedItemsPerClass((AuctionQuality) j, (ItemClass) i, ItemsInAH[j][i]);
+            config.SetMissedItemsPerClass((AuctionQuality) j, (ItemClass) i, auctionHouse->GetServerAuctionCount(j, i));
             count += config.GetMissedItemsPerClass((AuctionQuality) j, (ItemClass) i);
         }
     }
@@ -1755,13 +1763,14 @@ void AuctionHouseBot::Rebuild(bool all) const
 {
     for (uint32 i = 0; i < MAX_AUCTION_HOUSE_TYPE; ++i)
     {
-        AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i))->GetAuctionsBounds();
+        AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i));
+        AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
         for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
             AuctionEntry* entry = itr->second;
             if (!entry->owner)                              // ahbot auction
                 if (all || entry->bid == 0)                 // expire now auction if no bid or forced
-                    entry->expireTime = sWorld.GetGameTime();
+                    auctionHouse->SetExpireTime(entry, sWorld.GetGameTime());
         }
     }
 }
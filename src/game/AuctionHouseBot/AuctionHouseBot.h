@@ -82,6 +82,7 @@ enum AuctionBotConfigUInt32Values
     CONFIG_UINT32_AHBOT_BUYER_CHANCE_RATIO_HORDE,
     CONFIG_UINT32_AHBOT_BUYER_CHANCE_RATIO_NEUTRAL,
     CONFIG_UINT32_AHBOT_BUYER_RECHECK_INTERVAL,
+    CONFIG_UINT32_AHBOT_BUYER_SCAN_PER_CYCLE,
     CONFIG_UINT32_AHBOT_CLASS_MISC_MOUNT_MIN_REQ_LEVEL,
     CONFIG_UINT32_AHBOT_CLASS_MISC_MOUNT_MAX_REQ_LEVEL,
     CONFIG_UINT32_AHBOT_CLASS_MISC_MOUNT_MIN_SKILL_RANK,
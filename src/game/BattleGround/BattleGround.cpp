@@ -173,6 +173,9 @@ BattleGround::BattleGround(): m_BuffChange(false), m_ArenaBuffSpawned(false), m_
 {
     m_TypeID            = BattleGroundTypeId(0);
     m_Status            = STATUS_NONE;
+    m_pvpLogDataBuildTime = 0;
+    m_pvpLogDataScoresSize = 0;
+    m_pvpLogDataStatus  = STATUS_NONE;
     m_ClientInstanceID  = 0;
     m_EndTime           = 0;
     m_BracketId         = BG_BRACKET_ID_TEMPLATE;
@@ -1176,6 +1179,26 @@ void BattleGround::Reset()
     for (BattleGroundScoreMap::const_iterator itr = m_PlayerScores.begin(); itr != m_PlayerScores.end(); ++itr)
         delete itr->second;
     m_PlayerScores.clear();
+
+    m_pvpLogDataPayload.reset();
+}
+
+void BattleGround::SendPvpLogData(WorldSession* session)
+{
+    uint32 now = WorldTimer::getMSTime();
+
+    // joins, leaves and the end of the battle show at once, score changes when the interval passed
+    if (!m_pvpLogDataPayload || m_pvpLogDataStatus != GetStatus() || m_pvpLogDataScoresSize != m_PlayerScores.size() ||
+            WorldTimer::getMSTimeDiff(m_pvpLogDataBuildTime, now) >= sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_SCOREBOARD_INTERVAL))
+    {
+        sBattleGroundMgr.BuildPvpLogDataPacket(m_pvpLogData, this);
+        m_pvpLogDataPayload.reset(new SharedPacketPayload(m_pvpLogData));
+        m_pvpLogDataBuildTime = now;
+        m_pvpLogDataScoresSize = m_PlayerScores.size();
+        m_pvpLogDataStatus = GetStatus();
+    }
+
+    session->SendPacket(*m_pvpLogDataPayload);
 }
 
 void BattleGround::StartBattleGround()
@@ -23,6 +23,7 @@
 #include "Globals/SharedDefines.h"
 #include "Maps/Map.h"
 #include "ByteBuffer.h"
+#include "WorldPacket.h"
 #include "Entities/ObjectGuid.h"
 
 // magic event-numbers
@@ -364,6 +365,9 @@ class BattleGround
         BattleGroundScoreMap::const_iterator GetPlayerScoresEnd() const { return m_PlayerScores.end(); }
         uint32 GetPlayerScoresSize() const { return m_PlayerScores.size(); }
 
+        // the scoreboard polled by the players is shared, rebuilt at most once per Battleground.ScoreboardInterval unless players joined or left
+        void SendPvpLogData(WorldSession* session);
+
         void StartBattleGround();
 
         /* Location */
@@ -579,6 +583,13 @@ class BattleGround
         uint32 m_PrematureCountDownTimer;
         char const* m_Name;
 
+        /* Scoreboard */
+        WorldPacket m_pvpLogData;
+        std::unique_ptr<SharedPacketPayload> m_pvpLogDataPayload;
+        uint32 m_pvpLogDataBuildTime;
+        uint32 m_pvpLogDataScoresSize;
+        BattleGroundStatus m_pvpLogDataStatus;
+
         /* Player lists */
         typedef std::deque<ObjectGuid> OfflineQueue;
         OfflineQueue m_OfflineQueue;                        // Player GUID
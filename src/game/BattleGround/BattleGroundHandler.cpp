@@ -301,9 +301,7 @@ void WorldSession::HandlePVPLogDataOpcode(WorldPacket& /*recv_data*/)
     if (bg->isArena())
         return;
 
-    WorldPacket data;
-    sBattleGroundMgr.BuildPvpLogDataPacket(data, bg);
-    SendPacket(data);
+    bg->SendPvpLogData(this);
 
     DEBUG_LOG("WORLD: Sent MSG_PVP_LOG_DATA Message");
 }
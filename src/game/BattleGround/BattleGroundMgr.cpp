@@ -59,6 +59,9 @@ BattleGroundQueue::BattleGroundQueue()
                 m_WaitTimes[i][j][k] = 0;
         }
     }
+
+    for (uint32& count : m_WaitingGroupCount)
+        count = 0;
 }
 
 BattleGroundQueue::~BattleGroundQueue()
@@ -136,6 +139,15 @@ bool BattleGroundQueue::SelectionPool::AddGroup(GroupQueueInfo* ginfo, uint32 de
     return PlayerCount < desiredCount;
 }
 
+// moves the group to the front of another queue of its bracket
+void BattleGroundQueue::MoveGroupToQueue(GroupsQueueType::iterator itr, uint32 index)
+{
+    GroupQueueInfo* ginfo = *itr;
+    m_QueuedGroups[ginfo->BracketId][index].push_front(ginfo);
+    m_QueuedGroups[ginfo->BracketId][ginfo->QueueIndex].erase(itr);
+    ginfo->QueueIndex = index;
+}
+
 /*********************************************************/
 /***               BATTLEGROUND QUEUES                 ***/
 /*********************************************************/
@@ -155,6 +167,7 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* grp, BattleGr
     ginfo->GroupTeam                 = leader->GetTeam();
     ginfo->ArenaTeamRating           = arenaRating;
     ginfo->OpponentsTeamRating       = 0;
+    ginfo->BracketId                 = bracketId;
 
     ginfo->Players.clear();
 
@@ -167,6 +180,7 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* grp, BattleGr
         ++index;                                            // BG_QUEUE_*_ALLIANCE -> BG_QUEUE_*_HORDE
 
     DEBUG_LOG("Adding Group to BattleGroundQueue bgTypeId : %u, bracket_id : %u, index : %u", BgTypeId, bracketId, index);
+    ginfo->QueueIndex = index;
 
     uint32 lastOnlineTime = WorldTimer::getMSTime();
 
@@ -203,6 +217,7 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* grp, BattleGr
 
         // add GroupInfo to m_QueuedGroups
         m_QueuedGroups[bracketId][index].push_back(ginfo);
+        ++m_WaitingGroupCount[bracketId];
 
         // announce to world, this code needs mutex
         if (arenaType == ARENA_TYPE_NONE && !isRated && !isPremade && sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN))
@@ -296,8 +311,6 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // Player *plr = sObjectMgr.GetPlayer(guid);
     // std::lock_guard<std::recursive_mutex> guard(m_Lock);
 
-    int32 bracket_id = -1;                                  // signed for proper for-loop finish
-
     // remove player from map, if he's there
     QueuedPlayersMap::iterator itr = m_QueuedPlayers.find(guid);
     if (itr == m_QueuedPlayers.end())
@@ -307,33 +320,12 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     }
 
     GroupQueueInfo* group = itr->second.GroupInfo;
-    GroupsQueueType::iterator group_itr;
-    // mostly people with the highest levels are in battlegrounds, thats why
-    // we count from MAX_BATTLEGROUND_QUEUES - 1 to 0
-    // variable index removes useless searching in other team's queue
-    uint32 index = BattleGround::GetTeamIndexByTeamId(group->GroupTeam);
-
-    for (int8 bracket_id_tmp = MAX_BATTLEGROUND_BRACKETS - 1; bracket_id_tmp >= 0 && bracket_id == -1; --bracket_id_tmp)
-    {
-        // we must check premade and normal team's queue - because when players from premade are joining bg,
-        // they leave groupinfo so we can't use its players size to find out index
-        for (uint8 j = index; j < BG_QUEUE_GROUP_TYPES_COUNT; j += BG_QUEUE_NORMAL_ALLIANCE)
-        {
-            for (GroupsQueueType::iterator group_itr_tmp = m_QueuedGroups[bracket_id_tmp][j].begin(); group_itr_tmp != m_QueuedGroups[bracket_id_tmp][j].end(); ++group_itr_tmp)
-            {
-                if ((*group_itr_tmp) == group)
-                {
-                    bracket_id = bracket_id_tmp;
-                    group_itr = group_itr_tmp;
-                    // we must store index to be able to erase iterator
-                    index = j;
-                    break;
-                }
-            }
-        }
-    }
+    // the group knows its queue, only that one is searched
+    BattleGroundBracketId bracket_id = group->BracketId;
+    GroupsQueueType& queue = m_QueuedGroups[bracket_id][group->QueueIndex];
+    GroupsQueueType::iterator group_itr = std::find(queue.begin(), queue.end(), group);
     // player can't be in queue without group, but just in case
-    if (bracket_id == -1)
+    if (group_itr == queue.end())
     {
         sLog.outError("BattleGroundQueue: ERROR Cannot find groupinfo for %s", guid.GetString().c_str());
         return;
@@ -384,7 +376,9 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // remove group queue info if needed
     if (group->Players.empty())
     {
-        m_QueuedGroups[bracket_id][index].erase(group_itr);
+        if (!group->IsInvitedToBGInstanceGUID)
+            --m_WaitingGroupCount[bracket_id];
+        queue.erase(group_itr);
         delete group;
     }
     // if group wasn't empty, so it wasn't deleted, and player have left a rated
@@ -441,6 +435,7 @@ bool BattleGroundQueue::InviteGroupToBG(GroupQueueInfo* ginfo, BattleGround* bg,
         // not yet invited
         // set invitation
         ginfo->IsInvitedToBGInstanceGUID = bg->GetInstanceID();
+        --m_WaitingGroupCount[ginfo->BracketId];
         BattleGroundTypeId bgTypeId = bg->GetTypeID();
         BattleGroundQueueTypeId bgQueueTypeId = BattleGroundMgr::BGQueueTypeId(bgTypeId, bg->GetArenaType());
         BattleGroundBracketId bracket_id = bg->GetBracketId();
@@ -623,8 +618,7 @@ bool BattleGroundQueue::CheckPremadeMatch(BattleGroundBracketId bracket_id, uint
             if (!(*itr)->IsInvitedToBGInstanceGUID && ((*itr)->JoinTime < time_before || (*itr)->Players.size() < MinPlayersPerTeam))
             {
                 // we must insert group to normal queue and erase pointer from premade queue
-                m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].push_front((*itr));
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i].erase(itr);
+                MoveGroupToQueue(itr, BG_QUEUE_NORMAL_ALLIANCE + i);
             }
         }
     }
@@ -717,16 +711,14 @@ bool BattleGroundQueue::CheckSkirmishForSameFaction(BattleGroundBracketId bracke
     {
         // set correct team
         (*itr)->GroupTeam = otherTeamId;
-        // add team to other queue
-        m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + otherTeamIdx].push_front(*itr);
-        // remove team from old queue
+        // move team to other queue
         GroupsQueueType::iterator itr2 = itr_team;
         ++itr2;
         for (; itr2 != m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + teamIdx].end(); ++itr2)
         {
             if (*itr2 == *itr)
             {
-                m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + teamIdx].erase(itr2);
+                MoveGroupToQueue(itr2, BG_QUEUE_NORMAL_ALLIANCE + otherTeamIdx);
                 break;
             }
         }
@@ -742,11 +734,8 @@ should be called from BattleGround::RemovePlayer function in some cases
 void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketId bracket_id, ArenaType arenaType, bool isRated, uint32 arenaRating)
 {
     // std::lock_guard<std::recursive_mutex> guard(m_Lock);
-    // if no players in queue - do nothing
-    if (m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].empty() &&
-            m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].empty() &&
-            m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE].empty() &&
-            m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_HORDE].empty())
+    // if no players waiting in queue - do nothing, invited groups only wait to enter or leave
+    if (!m_WaitingGroupCount[bracket_id])
         return;
 
     // battleground with free slot for player should be always in the beggining of the queue
@@ -991,16 +980,13 @@ void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketI
             // now we must move team if we changed its faction to another faction queue, because then we will spam log by errors in Queue::RemovePlayer
             if ((*(itr_team[TEAM_INDEX_ALLIANCE]))->GroupTeam != ALLIANCE)
             {
-                // add to alliance queue
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].push_front(*(itr_team[TEAM_INDEX_ALLIANCE]));
-                // erase from horde queue
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].erase(itr_team[TEAM_INDEX_ALLIANCE]);
+                // move from horde to alliance queue
+                MoveGroupToQueue(itr_team[TEAM_INDEX_ALLIANCE], BG_QUEUE_PREMADE_ALLIANCE);
                 itr_team[TEAM_INDEX_ALLIANCE] = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].begin();
             }
             if ((*(itr_team[TEAM_INDEX_HORDE]))->GroupTeam != HORDE)
             {
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].push_front(*(itr_team[TEAM_INDEX_HORDE]));
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].erase(itr_team[TEAM_INDEX_HORDE]);
+                MoveGroupToQueue(itr_team[TEAM_INDEX_HORDE], BG_QUEUE_PREMADE_HORDE);
                 itr_team[TEAM_INDEX_HORDE] = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].begin();
             }
 
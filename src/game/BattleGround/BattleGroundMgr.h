@@ -61,6 +61,8 @@ struct GroupQueueInfo                                       // stores informatio
     uint32  IsInvitedToBGInstanceGUID;                      // was invited to certain BG
     uint32  ArenaTeamRating;                                // if rated match, inited to the rating of the team
     uint32  OpponentsTeamRating;                            // for rated arena matches
+    BattleGroundBracketId BracketId;                        // bracket of the queue holding the group
+    uint32  QueueIndex;                                     // BattleGroundQueueGroupTypes of the queue holding the group
 };
 
 enum BattleGroundQueueGroupTypes
@@ -132,6 +134,10 @@ class BattleGroundQueue
         SelectionPool m_SelectionPools[PVP_TEAM_COUNT];
 
         bool InviteGroupToBG(GroupQueueInfo* ginfo, BattleGround* bg, Team side);
+        void MoveGroupToQueue(GroupsQueueType::iterator itr, uint32 index);
+
+        // groups of the bracket not invited yet, an update has nothing to match without any
+        uint32 m_WaitingGroupCount[MAX_BATTLEGROUND_BRACKETS];
         uint32 m_WaitTimes[PVP_TEAM_COUNT][MAX_BATTLEGROUND_BRACKETS][COUNT_OF_PLAYERS_TO_AVERAGE_WAIT_TIME];
         uint32 m_WaitTimeLastPlayer[PVP_TEAM_COUNT][MAX_BATTLEGROUND_BRACKETS];
         uint32 m_SumOfWaitTimes[PVP_TEAM_COUNT][MAX_BATTLEGROUND_BRACKETS];
@@ -36,6 +36,10 @@
 #include "AuctionHouseBot/AuctionHouseBot.h"
 
 #include <cstdarg>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <unordered_map>
 
 // Supported shift-links (client generated and server side)
 // |color|Harea:area_id|h[name]|h|r
@@ -61,6 +65,116 @@
 
 bool ChatHandler::load_command_table = true;
 
+/// Case insensitive prefix tree of the command names of one table, the names never change after compile
+class ChatCommandTrie
+{
+    public:
+        explicit ChatCommandTrie(ChatCommand const* table) : m_nodes(1)
+        {
+            for (uint32 i = 0; table[i].Name != nullptr; ++i)
+            {
+                if (!*table[i].Name)
+                {
+                    m_emptyNameEntries.push_back(i);
+                    continue;
+                }
+
+                uint32 node = 0;
+                for (char const* c = table[i].Name; *c; ++c)
+                {
+                    node = GetOrAddChild(node, Lower(*c));
+                    m_nodes[node].entries.push_back(i);
+                }
+            }
+
+            // "" commands match any abbreviation, keep them at their place in the table order
+            if (!m_emptyNameEntries.empty())
+            {
+                for (uint32 node = 1; node < m_nodes.size(); ++node)
+                {
+                    std::vector<uint32> merged;
+                    std::merge(m_nodes[node].entries.begin(), m_nodes[node].entries.end(), m_emptyNameEntries.begin(), m_emptyNameEntries.end(), std::back_inserter(merged));
+                    m_nodes[node].entries.swap(merged);
+                }
+            }
+        }
+
+        /// Entries hasStringAbbr accepts for the abbreviation, in table order
+        std::vector<uint32> const& Find(char const* part) const
+        {
+            if (!*part)
+                return m_emptyNameEntries;
+
+            uint32 node = 0;
+            for (; *part; ++part)
+            {
+                node = GetChild(node, Lower(*part));
+                if (!node)
+                    return m_emptyNameEntries;
+            }
+            return m_nodes[node].entries;
+        }
+
+    private:
+        struct Node
+        {
+            std::vector<std::pair<char, uint32>> children;
+            std::vector<uint32> entries;                    // commands with this name prefix
+        };
+
+        static char Lower(char c) { return char(tolower(c)); }
+
+        uint32 GetChild(uint32 node, char c) const
+        {
+            for (auto const& child : m_nodes[node].children)
+                if (child.first == c)
+                    return child.second;
+            return 0;
+        }
+
+        uint32 GetOrAddChild(uint32 node, char c)
+        {
+            if (uint32 child = GetChild(node, c))
+                return child;
+
+            uint32 child = m_nodes.size();
+            m_nodes[node].children.push_back(std::make_pair(c, child));
+            m_nodes.emplace_back();
+            return child;
+        }
+
+        std::vector<Node> m_nodes;                          // root first
+        std::vector<uint32> m_emptyNameEntries;
+};
+
+/// Tries of the command table and of all its subcommand tables
+class ChatCommandTries
+{
+    public:
+        explicit ChatCommandTries(ChatCommand const* table) { Add(table); }
+
+        ChatCommandTrie const* Find(ChatCommand const* table) const
+        {
+            auto itr = m_tries.find(table);
+            return itr != m_tries.end() ? &itr->second : nullptr;
+        }
+
+    private:
+        void Add(ChatCommand const* table)
+        {
+            if (!m_tries.emplace(table, ChatCommandTrie(table)).second)
+                return;
+
+            for (uint32 i = 0; table[i].Name != nullptr; ++i)
+                if (table[i].ChildCommands)
+                    Add(table[i].ChildCommands);
+        }
+
+        std::unordered_map<ChatCommand const*, ChatCommandTrie> m_tries;
+};
+
+static std::atomic<ChatCommandTries const*> s_commandTries(nullptr);  // set once the command table is loaded
+
 ChatCommand* ChatHandler::getCommandTable()
 {
     static ChatCommand accountSetCommandTable[] =
@@ -250,6 +364,21 @@ ChatCommand* ChatHandler::getCommandTable()
         { "maps",           SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugMaps,                       "", nullptr },
         { "tempspawn",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleShowTemporarySpawnList,          "", nullptr },
         { "gridsloaded",    SEC_ADMINISTRATOR,  false, &ChatHandler::HandleGridsLoadedCount,                "", nullptr },
+        { "compression",    SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugCompression,                "", nullptr },
+        { "packets",        SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugPacketAllocations,          "", nullptr },
+        { "sql",            SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugSqlStatistics,              "", nullptr },
+        { "auras",          SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugAuraModifierCache,          "", nullptr },
+        { "spells",         SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugSpellProfile,               "", nullptr },
+        { "opcodes",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodeProfile,              "", nullptr },
+        { "dbscripts",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugDbScriptStats,              "", nullptr },
+        { "idleupdates",    SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugIdleUpdates,                "", nullptr },
+        { "entitypool",     SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugEntityPool,                 "", nullptr },
+        { "ticks",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugMapTickProfile,             "", nullptr },
+        { "locks",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugLockProfile,                "", nullptr },
+        { "eventspawns",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugEventSpawns,                "", nullptr },
+        { "respawns",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugScheduledRespawns,          "", nullptr },
+        { "stealth",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugStealthDetectionCache,      "", nullptr },
+        { "itemdata",       SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugItemDataBenchmark,          "", nullptr },
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
@@ -280,9 +409,12 @@ ChatCommand* ChatHandler::getCommandTable()
         { "moveflag",       SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugMoveflags,                  "", nullptr },
         { "visibility",     SEC_MODERATOR,      false, nullptr,                                             "", debugVisibilityCommandTable },
         { "perf",           SEC_ADMINISTRATOR,  false, nullptr,                                             "", debugPerformanceCommandTable },
+        { "scripts",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugScriptProfile,              "", nullptr },
         { "lootdropstats",  SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugLootDropStats,              "", nullptr },
         { "utf8overflow",   SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOverflowCommand,            "", nullptr },
         { "chatfreeze",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugChatFreezeCommand,          "", nullptr },
+        { "capture",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketCapture,              "", nullptr },
+        { "replay",         SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugPacketReplay,               "", nullptr },
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
@@ -738,6 +870,7 @@ ChatCommand* ChatHandler::getCommandTable()
         { "idleshutdown",   SEC_ADMINISTRATOR,  true,  nullptr,                                        "", serverIdleShutdownCommandTable },
         { "info",           SEC_PLAYER,         true,  &ChatHandler::HandleServerInfoCommand,          "", nullptr },
         { "log",            SEC_CONSOLE,        true,  nullptr,                                        "", serverLogCommandTable },
+        { "memory",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerMemoryCommand,        "", nullptr },
         { "motd",           SEC_PLAYER,         true,  &ChatHandler::HandleServerMotdCommand,          "", nullptr },
         { "plimit",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerPLimitCommand,        "", nullptr },
         { "resetallraid",   SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerResetAllRaidCommand,  "", nullptr },
@@ -905,6 +1038,9 @@ ChatCommand* ChatHandler::getCommandTable()
         // check hardcoded part integrity
         CheckIntegrity(commandTable, nullptr);
 
+        static ChatCommandTries const commandTries(commandTable);
+        s_commandTries = &commandTries;
+
         QueryResult* result = WorldDatabase.Query("SELECT name,security,help FROM command");
         if (result)
         {
@@ -1193,20 +1329,35 @@ ChatCommandSearchResult ChatHandler::FindCommand(ChatCommand* table, char const*
 
     while (*text == ' ') ++text;
 
-    // search first level command in table
-    for (uint32 i = 0; table[i].Name != nullptr; ++i)
+    // matching names in table order, from the prefix trees of the hardcoded tables
+    std::vector<uint32> scanned;
+    std::vector<uint32> const* candidates = &scanned;
+    ChatCommandTries const* tries = exactlyName ? nullptr : s_commandTries.load();
+    ChatCommandTrie const* trie = tries ? tries->Find(table) : nullptr;
+    if (trie)
+        candidates = &trie->Find(cmd.c_str());
+    else
     {
-        if (exactlyName)
+        for (uint32 i = 0; table[i].Name != nullptr; ++i)
         {
-            size_t len = strlen(table[i].Name);
-            if (strncmp(table[i].Name, cmd.c_str(), len + 1) != 0)
-                continue;
-        }
-        else
-        {
-            if (!hasStringAbbr(table[i].Name, cmd.c_str()))
-                continue;
+            if (exactlyName)
+            {
+                size_t len = strlen(table[i].Name);
+                if (strncmp(table[i].Name, cmd.c_str(), len + 1) != 0)
+                    continue;
+            }
+            else
+            {
+                if (!hasStringAbbr(table[i].Name, cmd.c_str()))
+                    continue;
+            }
+            scanned.push_back(i);
         }
+    }
+
+    // search first level command in table
+    for (uint32 i : *candidates)
+    {
         // select subcommand from child commands list
         if (table[i].ChildCommands != nullptr)
         {
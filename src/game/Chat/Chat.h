@@ -42,6 +42,7 @@ class MailDraft;
 class Object;
 class GameObject;
 class Creature;
+class LootStore;
 class Pet;
 class Player;
 class Unit;
@@ -275,6 +276,24 @@ class ChatHandler
         bool HandleDebugMaps(char* args);
         bool HandleShowTemporarySpawnList(char* args);
         bool HandleGridsLoadedCount(char* args);
+        bool HandleDebugCompression(char* args);
+        bool HandleDebugPacketAllocations(char* args);
+        bool HandleDebugSqlStatistics(char* args);
+        bool HandleDebugSpellProfile(char* args);
+        bool HandleDebugScriptProfile(char* args);
+        bool HandleDebugOpcodeProfile(char* args);
+        bool HandleDebugMapTickProfile(char* args);
+        bool HandleDebugLockProfile(char* args);
+        bool HandleDebugEventSpawns(char* args);
+        bool HandleDebugScheduledRespawns(char* args);
+        bool HandleDebugStealthDetectionCache(char* args);
+        bool HandleDebugItemDataBenchmark(char* args);
+        bool HandleDebugPacketCapture(char* args);
+        bool HandleDebugPacketReplay(char* args);
+        bool HandleDebugDbScriptStats(char* args);
+        bool HandleDebugIdleUpdates(char* args);
+        bool HandleDebugEntityPool(char* args);
+        bool HandleDebugAuraModifierCache(char* args);
 
         bool HandleDebugPlayCinematicCommand(char* args);
         bool HandleDebugPlaySoundCommand(char* args);
@@ -517,6 +536,7 @@ class ChatHandler
         bool HandleReloadLootTemplatesProspectingCommand(char* args);
         bool HandleReloadLootTemplatesReferenceCommand(char* args);
         bool HandleReloadLootTemplatesSkinningCommand(char* args);
+        bool HandleReloadLootTemplatesInBackground(LootStore& store, void (*loader)(LootStore&), char const* publishedText);
         bool HandleReloadMailLevelRewardCommand(char* args);
         bool HandleReloadMangosStringCommand(char* args);
         bool HandleReloadNpcGossipCommand(char* args);
@@ -572,6 +592,7 @@ class ChatHandler
         bool HandleServerInfoCommand(char* args);
         bool HandleServerLogFilterCommand(char* args);
         bool HandleServerLogLevelCommand(char* args);
+        bool HandleServerMemoryCommand(char* args);
         bool HandleServerMotdCommand(char* args);
         bool HandleServerPLimitCommand(char* args);
         bool HandleServerResetAllRaidCommand(char* args);
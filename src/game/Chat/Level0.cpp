@@ -29,6 +29,7 @@
 #include "SystemConfig.h"
 #include "revision.h"
 #include "Util.h"
+#include "Server/WorldSocket.h"
 
 bool ChatHandler::HandleHelpCommand(char* args)
 {
@@ -106,6 +107,13 @@ bool ChatHandler::HandleServerInfoCommand(char* /*args*/)
     PSendSysMessage(LANG_CONNECTED_USERS, activeClientsNum, maxActiveClientsNum, queuedClientsNum, maxQueuedClientsNum);
     PSendSysMessage(LANG_UPTIME, str.c_str());
 
+    if (GetAccessLevel() > SEC_PLAYER)
+    {
+        uint32 pending, peak, refused, averageWaitMs;
+        WorldSocket::GetAuthStatistics(pending, peak, refused, averageWaitMs);
+        PSendSysMessage("Pending authentications: %u (peak %u, refused %u, average wait %u ms)", pending, peak, refused, averageWaitMs);
+    }
+
     return true;
 }
 
@@ -51,6 +51,7 @@
 #include "MotionGenerators/MoveMap.h"                       // for mmap manager
 #include "MotionGenerators/PathFinder.h"                    // for mmap commands
 #include "Movement/MoveSplineInit.h"
+#include "Entities/CharEnumCache.h"
 
 #include <fstream>
 #include <map>
@@ -2237,6 +2238,7 @@ bool ChatHandler::HandleNpcShowLootCommand(char* /*args*/)
         return true;
     }
 
+    creature->m_loot->GenerateDeferredItems(m_session ? m_session->GetPlayer() : nullptr);
     creature->m_loot->PrintLootList(*this, m_session);
     return true;
 }
@@ -3595,6 +3597,7 @@ bool ChatHandler::HandleCharacterRenameCommand(char* args)
 
         PSendSysMessage(LANG_RENAME_PLAYER_GUID, oldNameLink.c_str(), target_guid.GetCounter());
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '1' WHERE guid = '%u'", target_guid.GetCounter());
+        sCharEnumCache.InvalidateCharacter(target_guid.GetCounter());
     }
 
     return true;
@@ -5018,7 +5021,8 @@ bool ChatHandler::HandleMmapLocCommand(char* /*args*/)
 
     // calculate navmesh tile location
     const dtNavMesh* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(player->GetMapId());
-    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(player->GetMapId(), player->GetInstanceId());
+    MMAP::PooledNavMeshQuery query(MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQueryPool(player->GetMapId()));
+    const dtNavMeshQuery* navmeshquery = query.get();
     if (!navmesh || !navmeshquery)
     {
         PSendSysMessage("NavMesh not loaded for current map.");
@@ -5063,8 +5067,7 @@ bool ChatHandler::HandleMmapLoadedTilesCommand(char* /*args*/)
     uint32 mapid = m_session->GetPlayer()->GetMapId();
 
     const dtNavMesh* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(mapid);
-    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(mapid, m_session->GetPlayer()->GetInstanceId());
-    if (!navmesh || !navmeshquery)
+    if (!navmesh)
     {
         PSendSysMessage("NavMesh not loaded for current map.");
         return true;
@@ -55,8 +55,11 @@
 #include "AI/EventAI/CreatureEventAIMgr.h"
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "Server/SQLStorages.h"
+#include "Server/QueryResponseCache.h"
 #include "Loot/LootMgr.h"
 #include "World/WorldState.h"
+#include "Entities/CharEnumCache.h"
+#include "MemoryTracker.h"
 
 static uint32 ahbotQualityIds[MAX_AUCTION_QUALITY] =
 {
@@ -257,6 +260,13 @@ bool ChatHandler::HandleReloadAllAreaCommand(char* /*args*/)
 
 bool ChatHandler::HandleReloadAllLootCommand(char* /*args*/)
 {
+    if (sWorld.IsBackgroundReloadRunning())
+    {
+        SendSysMessage("Another table is reloading currently, please attempt reload later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
     sLog.outString("Re-Loading Loot Tables...");
     LoadLootTables();
     SendGlobalSysMessage("DB tables `*_loot_template` reloaded.");
@@ -423,6 +433,13 @@ bool ChatHandler::HandleReloadCreatureQuestInvRelationsCommand(char* /*args*/)
 
 bool ChatHandler::HandleReloadConditionsCommand(char* /*args*/)
 {
+    if (sWorld.IsBackgroundReloadRunning())
+    {
+        SendSysMessage("Another table is reloading currently, please attempt reload later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
     sLog.outString("Re-Loading `conditions`... ");
     sObjectMgr.LoadConditions();
     SendGlobalSysMessage("DB table `conditions` reloaded.");
@@ -502,6 +519,7 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Quest Templates...");
     sObjectMgr.LoadQuests();
+    QueryResponseCache::Clear(QUERY_RESPONSE_QUEST);
     SendGlobalSysMessage("DB table `quest_template` (quest definitions) reloaded.");
 
     /// dependent also from `gameobject` but this table not reloaded anyway
@@ -511,80 +529,70 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
     return true;
 }
 
-bool ChatHandler::HandleReloadLootTemplatesCreatureCommand(char* /*args*/)
+// the table is read by a worker thread while the server keeps running, the old templates stay in use until it is done
+bool ChatHandler::HandleReloadLootTemplatesInBackground(LootStore& store, void (*loader)(LootStore&), char const* publishedText)
 {
-    sLog.outString("Re-Loading Loot Tables... (`creature_loot_template`)");
-    LoadLootTemplates_Creature();
-    LootTemplates_Creature.CheckLootRefs();
-    SendGlobalSysMessage("DB table `creature_loot_template` reloaded.");
+    if (!ReloadLootTemplatesInBackground(store, loader, publishedText))
+    {
+        SendSysMessage("Another table is reloading currently, please attempt reload later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    sLog.outString("Re-Loading Loot Tables... (`%s`) in background", store.GetName());
+    PSendSysMessage("DB table `%s` is reloading in background.", store.GetName());
     return true;
 }
 
+bool ChatHandler::HandleReloadLootTemplatesCreatureCommand(char* /*args*/)
+{
+    return HandleReloadLootTemplatesInBackground(LootTemplates_Creature, &LoadLootTemplates_Creature, "DB table `creature_loot_template` reloaded.");
+}
+
 bool ChatHandler::HandleReloadLootTemplatesDisenchantCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`disenchant_loot_template`)");
-    LoadLootTemplates_Disenchant();
-    LootTemplates_Disenchant.CheckLootRefs();
-    SendGlobalSysMessage("DB table `disenchant_loot_template` reloaded.");
-    return true;
+    return HandleReloadLootTemplatesInBackground(LootTemplates_Disenchant, &LoadLootTemplates_Disenchant, "DB table `disenchant_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesFishingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`fishing_loot_template`)");
-    LoadLootTemplates_Fishing();
-    LootTemplates_Fishing.CheckLootRefs();
-    SendGlobalSysMessage("DB table `fishing_loot_template` reloaded.");
-    return true;
+    return HandleReloadLootTemplatesInBackground(LootTemplates_Fishing, &LoadLootTemplates_Fishing, "DB table `fishing_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesGameobjectCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`gameobject_loot_template`)");
-    LoadLootTemplates_Gameobject();
-    LootTemplates_Gameobject.CheckLootRefs();
-    SendGlobalSysMessage("DB table `gameobject_loot_template` reloaded.");
-    return true;
+    return HandleReloadLootTemplatesInBackground(LootTemplates_Gameobject, &LoadLootTemplates_Gameobject, "DB table `gameobject_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesItemCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`item_loot_template`)");
-    LoadLootTemplates_Item();
-    LootTemplates_Item.CheckLootRefs();
-    SendGlobalSysMessage("DB table `item_loot_template` reloaded.");
-    return true;
+    return HandleReloadLootTemplatesInBackground(LootTemplates_Item, &LoadLootTemplates_Item, "DB table `item_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesPickpocketingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`pickpocketing_loot_template`)");
-    LoadLootTemplates_Pickpocketing();
-    LootTemplates_Pickpocketing.CheckLootRefs();
-    SendGlobalSysMessage("DB table `pickpocketing_loot_template` reloaded.");
-    return true;
+    return HandleReloadLootTemplatesInBackground(LootTemplates_Pickpocketing, &LoadLootTemplates_Pickpocketing, "DB table `pickpocketing_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesProspectingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`prospecting_loot_template`)");
-    LoadLootTemplates_Prospecting();
-    LootTemplates_Prospecting.CheckLootRefs();
-    SendGlobalSysMessage("DB table `prospecting_loot_template` reloaded.");
-    return true;
+    return HandleReloadLootTemplatesInBackground(LootTemplates_Prospecting, &LoadLootTemplates_Prospecting, "DB table `prospecting_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesMailCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`mail_loot_template`)");
-    LoadLootTemplates_Mail();
-    LootTemplates_Mail.CheckLootRefs();
-    SendGlobalSysMessage("DB table `mail_loot_template` reloaded.");
-    return true;
+    return HandleReloadLootTemplatesInBackground(LootTemplates_Mail, &LoadLootTemplates_Mail, "DB table `mail_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadLootTemplatesReferenceCommand(char* /*args*/)
 {
+    if (sWorld.IsBackgroundReloadRunning())
+    {
+        SendSysMessage("Another table is reloading currently, please attempt reload later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
     sLog.outString("Re-Loading Loot Tables... (`reference_loot_template`)");
     LoadLootTemplates_Reference();
     SendGlobalSysMessage("DB table `reference_loot_template` reloaded.");
@@ -593,11 +601,7 @@ bool ChatHandler::HandleReloadLootTemplatesReferenceCommand(char* /*args*/)
 
 bool ChatHandler::HandleReloadLootTemplatesSkinningCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`skinning_loot_template`)");
-    LoadLootTemplates_Skinning();
-    LootTemplates_Skinning.CheckLootRefs();
-    SendGlobalSysMessage("DB table `skinning_loot_template` reloaded.");
-    return true;
+    return HandleReloadLootTemplatesInBackground(LootTemplates_Skinning, &LoadLootTemplates_Skinning, "DB table `skinning_loot_template` reloaded.");
 }
 
 bool ChatHandler::HandleReloadMangosStringCommand(char* /*args*/)
@@ -1060,6 +1064,7 @@ bool ChatHandler::HandleReloadLocalesCreatureCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Creature ...");
     sObjectMgr.LoadCreatureLocales();
+    QueryResponseCache::Clear(QUERY_RESPONSE_CREATURE);
     SendGlobalSysMessage("DB table `locales_creature` reloaded.");
     return true;
 }
@@ -1068,6 +1073,7 @@ bool ChatHandler::HandleReloadLocalesGameobjectCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Gameobject ... ");
     sObjectMgr.LoadGameObjectLocales();
+    QueryResponseCache::Clear(QUERY_RESPONSE_GAMEOBJECT);
     SendGlobalSysMessage("DB table `locales_gameobject` reloaded.");
     return true;
 }
@@ -1084,6 +1090,8 @@ bool ChatHandler::HandleReloadLocalesItemCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Item ... ");
     sObjectMgr.LoadItemLocales();
+    sAuctionMgr.ClearSearchNames();
+    QueryResponseCache::Clear(QUERY_RESPONSE_ITEM);
     SendGlobalSysMessage("DB table `locales_item` reloaded.");
     return true;
 }
@@ -1116,6 +1124,7 @@ bool ChatHandler::HandleReloadLocalesQuestCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Quest ... ");
     sObjectMgr.LoadQuestLocales();
+    QueryResponseCache::Clear(QUERY_RESPONSE_QUEST);
     SendGlobalSysMessage("DB table `locales_quest` reloaded.");
     return true;
 }
@@ -4876,6 +4885,7 @@ bool ChatHandler::HandleResetSpellsCommand(char* args)
     else
     {
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE guid = '%u'", uint32(AT_LOGIN_RESET_SPELLS), target_guid.GetCounter());
+        sCharEnumCache.InvalidateCharacter(target_guid.GetCounter());
         PSendSysMessage(LANG_RESET_SPELLS_OFFLINE, target_name.c_str());
     }
 
@@ -4903,6 +4913,7 @@ bool ChatHandler::HandleResetTalentsCommand(char* args)
     {
         uint32 at_flags = AT_LOGIN_RESET_TALENTS;
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE guid = '%u'", at_flags, target_guid.GetCounter());
+        sCharEnumCache.InvalidateCharacter(target_guid.GetCounter());
         std::string nameLink = playerLink(target_name);
         PSendSysMessage(LANG_RESET_TALENTS_OFFLINE, nameLink.c_str());
         return true;
@@ -6054,6 +6065,23 @@ bool ChatHandler::HandleMovespeedShowCommand(char* /*args*/)
     return true;
 }
 
+bool ChatHandler::HandleServerMemoryCommand(char* /*args*/)
+{
+    int64 total = 0;
+    for (uint32 i = 0; i < MAX_MEMORY_TAG; ++i)
+    {
+        MemoryTag const tag = MemoryTag(i);
+        total += MemoryTracker::GetBytes(tag);
+        PSendSysMessage("%s: " SI64FMTD " KB in " SI64FMTD " allocations", MemoryTracker::GetTagName(tag), MemoryTracker::GetBytes(tag) / 1024, MemoryTracker::GetCount(tag));
+    }
+
+    if (uint64 resident = MemoryTracker::GetResidentBytes())
+        PSendSysMessage("Tracked " SI64FMTD " KB of " UI64FMTD " KB resident.", total / 1024, resident / 1024);
+    else
+        PSendSysMessage("Tracked " SI64FMTD " KB.", total / 1024);
+    return true;
+}
+
 bool ChatHandler::HandleServerPLimitCommand(char* args)
 {
     if (*args)
@@ -31,9 +31,19 @@
 #include "Maps/MapManager.h"
 #include "Globals/ObjectMgr.h"
 #include "Entities/ObjectGuid.h"
+#include "Entities/UpdateData.h"
+#include "World/World.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 #include "Maps/InstanceData.h"
 #include "Cinematics/M2Stores.h"
+#include "Database/SqlStatistics.h"
+#include "Spells/SpellProfiler.h"
+#include "Server/OpcodeProfiler.h"
+#include "Maps/MapTickProfiler.h"
+#include "Server/PacketCapture.h"
+#include "ProfiledMutex.h"
+#include "AI/ScriptDevAI/ScriptProfiler.h"
+#include "Entities/EntityPool.h"
 
 bool ChatHandler::HandleDebugSendSpellFailCommand(char* args)
 {
@@ -1213,6 +1223,14 @@ bool ChatHandler::HandleDebugMaps(char* /*args*/)
         if (!player)
             return true;
 
+        MapQueryCache const& queryCache = player->GetMap()->GetQueryCache();
+        PSendSysMessage("Query cache of current map >> LOS: " UI64FMTD "/" UI64FMTD " hits, Height: " UI64FMTD "/" UI64FMTD " hits",
+            queryCache.GetLineOfSightHits(), queryCache.GetLineOfSightLookups(), queryCache.GetHeightHits(), queryCache.GetHeightLookups());
+        PSendSysMessage("Movement heartbeats of current map >> Sent: " UI64FMTD ", Suppressed for distant viewers: " UI64FMTD,
+            player->GetMap()->GetMovementHeartbeatsSent(), player->GetMap()->GetMovementHeartbeatsSuppressed());
+        PSendSysMessage("AI budget of current map >> Deferred updates last tick: %u, total: " UI64FMTD,
+            player->GetMap()->GetDeferredUpdatesLastTick(), player->GetMap()->GetDeferredUpdatesTotal());
+
         if (player->GetMap()->IsContinent())
             return true;
 
@@ -1256,6 +1274,518 @@ bool ChatHandler::HandleGridsLoadedCount(char* /*args*/)
     return true;
 }
 
+bool ChatHandler::HandleDebugCompression(char* /*args*/)
+{
+    UpdateData::CompressionStats const& stats = UpdateData::GetCompressionStats();
+
+    uint64 packets = stats.packets;
+    uint64 bytesIn = stats.bytesIn;
+    uint64 bytesOut = stats.bytesOut;
+    uint64 timeUs = stats.timeUs;
+
+    PSendSysMessage("Update packet compression (level %u):", sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    PSendSysMessage("Packets: " UI64FMTD " In: " UI64FMTD " bytes Out: " UI64FMTD " bytes", packets, bytesIn, bytesOut);
+    if (packets && bytesIn)
+        PSendSysMessage("Ratio: %.3f Avg time: %.2fus Total time: " UI64FMTD "ms", float(bytesOut) / bytesIn, float(timeUs) / packets, timeUs / 1000);
+    return true;
+}
+
+// .debug perf packets [on|off] - toggle packet allocation tracking, without argument show the gathered counters
+bool ChatHandler::HandleDebugPacketAllocations(char* args)
+{
+    bool enable;
+    if (ExtractOnOff(&args, enable))
+    {
+        if (enable)
+        {
+            ByteBuffer::PoolStats& poolStats = ByteBuffer::GetPoolStats();
+            poolStats.hits = 0;
+            poolStats.misses = 0;
+            for (auto& count : opcodeAllocCount)
+                count = 0;
+        }
+
+        ByteBuffer::SetAllocationTracking(enable);
+        PSendSysMessage("Packet allocation tracking %s.", enable ? "enabled" : "disabled");
+        return true;
+    }
+
+    ByteBuffer::PoolStats const& poolStats = ByteBuffer::GetPoolStats();
+    uint64 hits = poolStats.hits;
+    uint64 misses = poolStats.misses;
+
+    PSendSysMessage("Packet allocation tracking is %s.", ByteBuffer::IsTrackingAllocations() ? "enabled" : "disabled");
+    PSendSysMessage("Buffer pool hits: " UI64FMTD " misses: " UI64FMTD, hits, misses);
+
+    std::vector<std::pair<uint32, uint16>> counts;
+    for (uint16 i = 0; i < NUM_MSG_TYPES; ++i)
+        if (uint32 count = opcodeAllocCount[i])
+            counts.emplace_back(count, i);
+
+    std::sort(counts.begin(), counts.end(), std::greater<std::pair<uint32, uint16>>());
+    if (counts.size() > 15)
+        counts.resize(15);
+
+    for (auto const& count : counts)
+        PSendSysMessage("%s: %u", LookupOpcodeName(count.second), count.first);
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugSqlStatistics(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        SqlStatistics::Reset();
+        SendSysMessage("SQL statistics reset.");
+        return true;
+    }
+
+    bool enable;
+    if (ExtractOnOff(&args, enable))
+    {
+        if (enable)
+            SqlStatistics::Reset();
+
+        SqlStatistics::SetEnabled(enable);
+        PSendSysMessage("SQL statistics %s.", enable ? "enabled" : "disabled");
+        return true;
+    }
+
+    PSendSysMessage("SQL statistics are %s.", SqlStatistics::IsEnabled() ? "enabled" : "disabled");
+
+    for (SqlStatistics::Summary const& summary : SqlStatistics::GetTopStatements(15))
+        PSendSysMessage(UI64FMTD " calls, " UI64FMTD " ms, p50 " UI64FMTD " us, p99 " UI64FMTD " us, " UI64FMTD " rows: %s",
+                        summary.count, summary.totalUs / 1000, summary.p50Us, summary.p99Us, summary.rows, summary.statement.c_str());
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugAuraModifierCache(char* /*args*/)
+{
+    Unit::AuraModifierCacheStats const& stats = Unit::GetAuraModifierCacheStats();
+    uint64 hits = stats.hits;
+    uint64 misses = stats.misses;
+
+    PSendSysMessage("Aura modifier cache >> Hits: " UI64FMTD " Misses: " UI64FMTD, hits, misses);
+    if (hits + misses)
+        PSendSysMessage("Hit rate: %.1f%%", 100.0f * hits / (hits + misses));
+    return true;
+}
+
+bool ChatHandler::HandleDebugSpellProfile(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        SpellProfiler::Reset();
+        SendSysMessage("Spell profile reset.");
+        return true;
+    }
+
+    bool enable;
+    if (ExtractOnOff(&args, enable))
+    {
+        if (enable)
+            SpellProfiler::Reset();
+
+        SpellProfiler::SetEnabled(enable);
+        PSendSysMessage("Spell profiling %s.", enable ? "enabled" : "disabled");
+        return true;
+    }
+
+    PSendSysMessage("Spell profiling is %s, 1 of %u calls sampled.", SpellProfiler::IsEnabled() ? "enabled" : "disabled", SpellProfiler::GetSampleRate());
+
+    for (SpellProfiler::Summary const& summary : SpellProfiler::GetTopEntries(15))
+        PSendSysMessage(UI64FMTD " calls, " UI64FMTD " ms, avg " UI64FMTD " us, max " UI64FMTD " us: %s",
+                        summary.count, summary.totalUs / 1000, summary.totalUs / summary.count, summary.maxUs, SpellProfiler::GetEntryName(summary).c_str());
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugOpcodeProfile(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        OpcodeProfiler::Reset();
+        SendSysMessage("Opcode profile reset.");
+        return true;
+    }
+
+    bool enable;
+    if (ExtractOnOff(&args, enable))
+    {
+        if (enable)
+            OpcodeProfiler::Reset();
+
+        OpcodeProfiler::SetEnabled(enable);
+        PSendSysMessage("Opcode profiling %s.", enable ? "enabled" : "disabled");
+        return true;
+    }
+
+    bool sessions = ExtractLiteralArg(&args, "sessions") != nullptr;
+    uint32 const seconds = OpcodeProfiler::GetCollectTime();
+
+    PSendSysMessage("Opcode profiling is %s, collected for %u seconds.", OpcodeProfiler::IsEnabled() ? "enabled" : "disabled", seconds);
+
+    if (sessions)
+    {
+        for (OpcodeProfiler::SessionSummary const& session : OpcodeProfiler::GetTopSessions(15))
+            PSendSysMessage("account %u: " UI64FMTD " packets, %.1f/s, " UI64FMTD " bytes, " UI64FMTD " ms, max " UI64FMTD " us (%s)",
+                            session.accountId, session.count, double(session.count) / seconds, session.bytes, session.totalUs / 1000, session.maxUs, LookupOpcodeName(session.maxOpcode));
+        return true;
+    }
+
+    for (OpcodeProfiler::Summary const& summary : OpcodeProfiler::GetTopEntries(15))
+        PSendSysMessage(UI64FMTD " packets, %.1f/s, " UI64FMTD " bytes, " UI64FMTD " ms, avg " UI64FMTD " us, max " UI64FMTD " us [%s]: %s (%s)",
+                        summary.count, double(summary.count) / seconds, summary.bytes, summary.totalUs / 1000, summary.totalUs / summary.count, summary.maxUs,
+                        OpcodeProfiler::GetBucketString(summary).c_str(), LookupOpcodeName(summary.opcode), OpcodeProfiler::GetPathName(summary.path));
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugMapTickProfile(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        MapTickProfiler::Reset();
+        SendSysMessage("Map tick profile reset.");
+        return true;
+    }
+
+    bool enable;
+    if (ExtractOnOff(&args, enable))
+    {
+        if (enable)
+            MapTickProfiler::Reset();
+
+        MapTickProfiler::SetEnabled(enable);
+        PSendSysMessage("Map tick profiling %s.", enable ? "enabled" : "disabled");
+        return true;
+    }
+
+    if (ExtractLiteralArg(&args, "slow"))
+    {
+        uint32 threshold;
+        if (!ExtractUInt32(&args, threshold))
+            return false;
+
+        MapTickProfiler::SetSlowTickThreshold(threshold);
+        PSendSysMessage("Map ticks longer than %u ms are traced while profiling.", threshold);
+        return true;
+    }
+
+    PSendSysMessage("Map tick profiling is %s, slow tick threshold %u ms.", MapTickProfiler::IsEnabled() ? "enabled" : "disabled", MapTickProfiler::GetSlowTickThreshold());
+
+    // phases of a single map, otherwise the maps with the highest total time of every phase
+    uint32 mapId;
+    std::vector<MapTickProfiler::Summary> summaries = ExtractUInt32(&args, mapId) ? MapTickProfiler::GetMapEntries(mapId) : MapTickProfiler::GetEntries(3);
+
+    for (MapTickProfiler::Summary const& summary : summaries)
+    {
+        if (summary.mapId == MAP_TICK_ALL_MAPS)
+            PSendSysMessage("%s all maps: " UI64FMTD " ticks, avg " UI64FMTD " us, p50 " UI64FMTD " us, p95 " UI64FMTD " us, p99 " UI64FMTD " us, max " UI64FMTD " us",
+                            MapTickProfiler::GetPhaseName(summary.phase), summary.count, summary.totalUs / summary.count, summary.p50Us, summary.p95Us, summary.p99Us, summary.maxUs);
+        else
+            PSendSysMessage("%s map %u: " UI64FMTD " ticks, avg " UI64FMTD " us, p50 " UI64FMTD " us, p95 " UI64FMTD " us, p99 " UI64FMTD " us, max " UI64FMTD " us",
+                            MapTickProfiler::GetPhaseName(summary.phase), summary.mapId, summary.count, summary.totalUs / summary.count, summary.p50Us, summary.p95Us, summary.p99Us, summary.maxUs);
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugLockProfile(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        LockProfiler::Reset();
+        SendSysMessage("Lock profile reset.");
+        return true;
+    }
+
+    bool enable;
+    if (ExtractOnOff(&args, enable))
+    {
+        if (enable)
+            LockProfiler::Reset();
+
+        LockProfiler::SetEnabled(enable);
+        PSendSysMessage("Lock profiling %s.", enable ? "enabled" : "disabled");
+        return true;
+    }
+
+    uint32 const seconds = LockProfiler::GetCollectTime();
+
+    PSendSysMessage("Lock profiling is %s, collected for %u seconds.", LockProfiler::IsEnabled() ? "enabled" : "disabled", seconds);
+
+    for (LockProfiler::Summary const& summary : LockProfiler::GetEntries())
+        PSendSysMessage(UI64FMTD " locks, %.1f/s, %.1f%% contended, wait " UI64FMTD " ms, max " UI64FMTD " us, hold " UI64FMTD " ms, max " UI64FMTD " us: %s",
+                        summary.acquisitions, double(summary.acquisitions) / seconds, summary.contentions * 100.0 / summary.acquisitions,
+                        summary.waitUs / 1000, summary.maxWaitUs, summary.holdUs / 1000, summary.maxHoldUs, summary.name.c_str());
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugEventSpawns(char* /*args*/)
+{
+    PSendSysMessage("Game event spawns per map update: %u", sWorld.getConfig(CONFIG_UINT32_GAME_EVENT_SPAWN_BATCH_SIZE));
+
+    size_t total = 0;
+    sMapMgr.DoForAllMaps([&](Map* map)
+    {
+        if (size_t queued = map->GetQueuedEventSpawns())
+        {
+            PSendSysMessage("Map %u (instance %u): " SIZEFMTD " queued game event spawns", map->GetId(), map->GetInstanceId(), queued);
+            total += queued;
+        }
+    });
+
+    PSendSysMessage("Total queued game event spawns: " SIZEFMTD, total);
+    return true;
+}
+
+bool ChatHandler::HandleDebugScheduledRespawns(char* /*args*/)
+{
+    size_t total = 0;
+    sMapMgr.DoForAllMaps([&](Map* map)
+    {
+        if (size_t scheduled = map->GetScheduledRespawns())
+        {
+            PSendSysMessage("Map %u (instance %u): " SIZEFMTD " scheduled respawns", map->GetId(), map->GetInstanceId(), scheduled);
+            total += scheduled;
+        }
+    });
+
+    // entries of objects respawned early or removed stay queued until their time, they wake nothing
+    PSendSysMessage("Total scheduled respawns: " SIZEFMTD, total);
+    return true;
+}
+
+bool ChatHandler::HandleDebugStealthDetectionCache(char* /*args*/)
+{
+    VisibilityData::StealthDetectionCacheStats const& stats = VisibilityData::GetStealthDetectionCacheStats();
+    uint64 hits = stats.hits;
+    uint64 misses = stats.misses;
+
+    PSendSysMessage("Stealth detection cache >> Hits: " UI64FMTD " Misses: " UI64FMTD, hits, misses);
+    if (hits + misses)
+        PSendSysMessage("Hit rate: %.1f%%", 100.0f * hits / (hits + misses));
+    return true;
+}
+
+bool ChatHandler::HandleDebugItemDataBenchmark(char* args)
+{
+    uint32 iterations;
+    if (!ExtractOptUInt32(&args, iterations, 100000) || !iterations)
+        return false;
+
+    Player* player = getSelectedPlayer();
+    if (!player)
+        player = m_session->GetPlayer();
+
+    Item* item = nullptr;
+    for (uint8 slot = EQUIPMENT_SLOT_START; slot < INVENTORY_SLOT_ITEM_END && !item; ++slot)
+        item = player->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
+
+    if (!item)
+    {
+        SendSysMessage("The player has no item to serialize.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    uint16 const count = item->GetValuesCount();
+    std::string data;
+
+    // the stream based code that was used before, kept here to compare
+    Clock::time_point start = Clock::now();
+    for (uint32 n = 0; n < iterations; ++n)
+    {
+        std::ostringstream ss;
+        for (uint16 i = 0; i < count; ++i)
+            ss << item->GetUInt32Value(i) << " ";
+        data = ss.str();
+    }
+    Clock::time_point legacySaved = Clock::now();
+    uint32 checksum = 0;
+    for (uint32 n = 0; n < iterations; ++n)
+    {
+        Tokens tokens = StrSplit(data, " ");
+        for (auto const& token : tokens)
+            checksum += uint32(std::stoul(token));
+    }
+    Clock::time_point legacyLoaded = Clock::now();
+
+    for (uint32 n = 0; n < iterations; ++n)
+        item->SaveValues(data);
+    Clock::time_point saved = Clock::now();
+    // loads the values the item already has
+    for (uint32 n = 0; n < iterations; ++n)
+        item->LoadValues(data.c_str());
+    Clock::time_point loaded = Clock::now();
+
+    auto nsPerItem = [iterations](Clock::time_point from, Clock::time_point to)
+    {
+        return uint32(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count() / iterations);
+    };
+
+    PSendSysMessage("Item %u, %u values, " SIZEFMTD " bytes of text, %u iterations (checksum %u)", item->GetEntry(), count, data.size(), iterations, checksum);
+    PSendSysMessage("Stream save %u ns, split load %u ns per item", nsPerItem(start, legacySaved), nsPerItem(legacySaved, legacyLoaded));
+    PSendSysMessage("SaveValues %u ns, LoadValues %u ns per item", nsPerItem(legacyLoaded, saved), nsPerItem(saved, loaded));
+    return true;
+}
+
+bool ChatHandler::HandleDebugPacketCapture(char* args)
+{
+    bool enable;
+    if (ExtractOnOff(&args, enable))
+        PacketCapture::SetEnabled(enable);
+
+    PSendSysMessage("Packet capture is %s, the files are written to '%s'.", PacketCapture::IsEnabled() ? "enabled" : "disabled", PacketCapture::GetDirectory().c_str());
+    return true;
+}
+
+bool ChatHandler::HandleDebugPacketReplay(char* args)
+{
+    if (ExtractLiteralArg(&args, "stop"))
+    {
+        Player* target = getSelectedPlayer();
+        if (!target)
+        {
+            SendSysMessage(LANG_NO_CHAR_SELECTED);
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        if (sPacketReplayMgr.Stop(target->GetSession()->GetAccountId()))
+            PSendSysMessage("Replay to %s stopped.", target->GetName());
+        else
+            PSendSysMessage("No replay to %s running.", target->GetName());
+        return true;
+    }
+
+    char* fileName = ExtractQuotedOrLiteralArg(&args);
+    if (!fileName)
+    {
+        std::vector<PacketReplayMgr::Status> replays = sPacketReplayMgr.GetStatus();
+        for (PacketReplayMgr::Status const& status : replays)
+            PSendSysMessage("Account %u: %s at %.1fx, " SIZEFMTD " of " SIZEFMTD " packets queued", status.accountId, status.fileName.c_str(), status.speed, status.queued, status.total);
+        PSendSysMessage("%u replays running.", uint32(replays.size()));
+        return true;
+    }
+
+    // the recorded pace up to ten times faster, or slower for reproducing a single sequence
+    float speed = 1.0f;
+    if (*args && (!ExtractFloat(&args, speed) || speed <= 0.0f || speed > 10.0f))
+    {
+        SendSysMessage("The speed must be above 0 and at most 10.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    Player* target = getSelectedPlayer();
+    if (!target)
+    {
+        SendSysMessage(LANG_NO_CHAR_SELECTED);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::string error;
+    if (!sPacketReplayMgr.Start(fileName, target->GetSession()->GetAccountId(), speed, error))
+    {
+        PSendSysMessage("Replay failed: %s.", error.c_str());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Replaying %s to %s at %.1fx.", fileName, target->GetName(), speed);
+    return true;
+}
+
+bool ChatHandler::HandleDebugScriptProfile(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        ScriptProfiler::Reset();
+        SendSysMessage("Script profile reset.");
+        return true;
+    }
+
+    bool enable;
+    if (ExtractOnOff(&args, enable))
+    {
+        if (enable)
+            ScriptProfiler::Reset();
+
+        ScriptProfiler::SetEnabled(enable);
+        PSendSysMessage("Script profiling %s.", enable ? "enabled" : "disabled");
+        return true;
+    }
+
+    PSendSysMessage("Script profiling is %s, 1 of %u calls sampled.", ScriptProfiler::IsEnabled() ? "enabled" : "disabled", ScriptProfiler::GetSampleRate());
+
+    for (ScriptProfiler::Summary const& summary : ScriptProfiler::GetTopEntries(15))
+        PSendSysMessage(UI64FMTD " calls, " UI64FMTD " ms, avg " UI64FMTD " us, max " UI64FMTD " us: %s %s",
+                        summary.count, summary.totalUs / 1000, summary.totalUs / summary.count, summary.maxUs,
+                        sScriptDevAIMgr.GetScriptName(summary.scriptId), ScriptProfiler::GetHookName(summary.hook));
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugDbScriptStats(char* /*args*/)
+{
+    ScriptMgr::ScriptTableStatsList stats = sScriptMgr.GetScriptTableStats();
+    if (stats.empty())
+    {
+        SendSysMessage("No db scripts executed yet.");
+        return true;
+    }
+
+    for (auto const& itr : stats)
+        PSendSysMessage("%s >> Started: " UI64FMTD " Steps: " UI64FMTD " Terminated: " UI64FMTD,
+                        itr.first.c_str(), itr.second.started, itr.second.steps, itr.second.terminated);
+    return true;
+}
+
+bool ChatHandler::HandleDebugIdleUpdates(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        Creature::ResetIdleUpdateCounters();
+        SendSysMessage("Idle update counters reset.");
+        return true;
+    }
+
+    PSendSysMessage("Idle update interval: %u ms, movement types mask: %u, AI types mask: %u",
+                    sWorld.getConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL),
+                    sWorld.getConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_MOVEMENT_TYPES),
+                    sWorld.getConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_AI_TYPES));
+    PSendSysMessage("Creature updates avoided: " UI64FMTD " Updates run with the skipped time: " UI64FMTD,
+                    Creature::GetIdleSkippedUpdates(), Creature::GetIdleUpdates());
+    return true;
+}
+
+bool ChatHandler::HandleDebugEntityPool(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        EntityPool::ResetStats();
+        SendSysMessage("Entity pool counters reset.");
+        return true;
+    }
+
+    for (uint32 i = 0; i < MAX_ENTITY_POOL_TYPE; ++i)
+    {
+        EntityPool::Stats stats = EntityPool::GetStats(EntityPoolType(i));
+        uint32 reusePct = stats.allocations ? uint32(stats.reused * 100 / stats.allocations) : 0;
+        PSendSysMessage("%s: allocations " UI64FMTD " reused " UI64FMTD " (%u%%) pooled " UI64FMTD " freed " UI64FMTD " idle %u KB",
+                        EntityPool::GetTypeName(EntityPoolType(i)), stats.allocations, stats.reused, reusePct, stats.released, stats.freed,
+                        uint32(std::max<int64>(stats.pooledBytes, 0) / 1024));
+    }
+    return true;
+}
+
 bool ChatHandler::HandleDebugWaypoint(char* args)
 {
     Creature* target = getSelectedCreature();
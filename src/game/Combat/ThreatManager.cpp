@@ -81,7 +81,7 @@ float ThreatCalcHelper::CalcThreat(Unit* hatedUnit, Unit* hatingUnit, float thre
 //============================================================
 
 HostileReference::HostileReference(Unit* unit, ThreatManager* threatManager, float threat) : 
-    m_hostileState(STATE_NORMAL), m_tauntState(STATE_NONE)
+    m_hostileState(STATE_NORMAL), m_tauntState(STATE_NONE), m_meleeReachable(false)
 {
     iThreat = threat;
     iFadeoutThreadReduction = 0.f;
@@ -307,18 +307,20 @@ void ThreatContainer::update(bool force)
 {
     if ((iDirty || force) && iThreatList.size() > 1)
     {
-        iThreatList.sort([&](const HostileReference* lhs, const HostileReference* rhs)->bool
+        // reach is checked once per reference instead of twice per comparison
+        if (force)
+        {
+            Unit* owner = iThreatList.front()->getSource()->getOwner();
+            for (HostileReference* ref : iThreatList)
+                ref->m_meleeReachable = owner->CanReachWithMeleeAttack(ref->getTarget());
+        }
+
+        iThreatList.sort([force](const HostileReference* lhs, const HostileReference* rhs)->bool
         {
             if (lhs->GetTauntState() != rhs->GetTauntState())
                 return lhs->GetTauntState() > rhs->GetTauntState();
-            Unit* owner = lhs->getSource()->getOwner();
-            if (force)
-            {
-                bool first = owner->CanReachWithMeleeAttack(lhs->getTarget());
-                bool second = owner->CanReachWithMeleeAttack(rhs->getTarget());
-                if (first != second)
-                    return first > second;
-            }
+            if (force && lhs->m_meleeReachable != rhs->m_meleeReachable)
+                return lhs->m_meleeReachable > rhs->m_meleeReachable;
             if (lhs->GetHostileState() != rhs->GetHostileState())
                 return lhs->GetHostileState() > rhs->GetHostileState();
             return lhs->getThreat() > rhs->getThreat(); // reverse sorting
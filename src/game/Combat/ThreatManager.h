@@ -24,7 +24,7 @@
 #include "Utilities/LinkedReference/Reference.h"
 #include "Entities/UnitEvents.h"
 #include "Entities/ObjectGuid.h"
-#include <list>
+#include "Entities/StableVector.h"
 
 //==============================================================
 
@@ -58,6 +58,8 @@ enum TauntState : uint32
 //==============================================================
 class HostileReference : public Reference<Unit, ThreatManager>
 {
+        friend class ThreatContainer;
+
     public:
         HostileReference(Unit* unit, ThreatManager* threatManager, float threat);
 
@@ -139,12 +141,14 @@ class HostileReference : public Reference<Unit, ThreatManager>
         ObjectGuid iUnitGuid;
         bool m_online;
         bool iAccessible;
+        bool m_meleeReachable;                              // sort key stored by ThreatContainer::update
 };
 
 //==============================================================
 class ThreatManager;
 
-typedef std::list<HostileReference*> ThreatList;
+// kept ordered by ThreatContainer::update, references may be added or removed while the list is iterated
+typedef StableVector<HostileReference> ThreatList;
 
 
 class ThreatContainer
@@ -177,7 +181,7 @@ class ThreatContainer
         void remove(HostileReference* ref) { iThreatList.remove(ref); }
         void addReference(HostileReference* hostileReference) { iThreatList.push_back(hostileReference); }
         void clearReferences();
-        // Sort the list if necessary
+        // Sort the list if necessary, the order only changes a little between updates
         void update(bool force);
 
         ThreatList iThreatList;
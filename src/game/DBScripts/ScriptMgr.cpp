@@ -33,6 +33,8 @@
 #include "Mails/Mail.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 
+#include <algorithm>
+
 ScriptMapMapName sQuestEndScripts;
 ScriptMapMapName sQuestStartScripts;
 ScriptMapMapName sSpellScripts;
@@ -51,6 +53,35 @@ ScriptMgr::ScriptMgr()
     m_scheduledScripts = 0;
 }
 
+void ScriptMgr::CountScriptStart(const char* table)
+{
+    std::lock_guard<std::mutex> guard(m_tableStatsLock);
+    ++m_tableStats[table].started;
+}
+
+void ScriptMgr::CountScriptStep(const char* table, bool terminated)
+{
+    std::lock_guard<std::mutex> guard(m_tableStatsLock);
+    ScriptTableStats& stats = m_tableStats[table];
+    ++stats.steps;
+    if (terminated)
+        ++stats.terminated;
+}
+
+ScriptMgr::ScriptTableStatsList ScriptMgr::GetScriptTableStats() const
+{
+    ScriptTableStatsList list;
+    {
+        std::lock_guard<std::mutex> guard(m_tableStatsLock);
+        list.reserve(m_tableStats.size());
+        for (auto const& itr : m_tableStats)
+            list.emplace_back(itr.first, itr.second);
+    }
+
+    std::sort(list.begin(), list.end(), [](ScriptTableStatsList::value_type const& a, ScriptTableStatsList::value_type const& b) { return a.second.steps > b.second.steps; });
+    return list;
+}
+
 // /////////////////////////////////////////////////////////
 //              DB SCRIPTS (loaders of static data)
 // /////////////////////////////////////////////////////////
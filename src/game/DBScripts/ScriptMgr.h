@@ -24,6 +24,8 @@
 #include "Server/DBCEnums.h"
 
 #include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 class Map;
 class Object;
@@ -593,6 +595,20 @@ class ScriptMgr
         uint32 DecreaseScheduledScriptCount() { return (uint32)--m_scheduledScripts; }
         uint32 DecreaseScheduledScriptCount(size_t count) { return (uint32)(m_scheduledScripts -= count); }
         bool IsScriptScheduled() const { return m_scheduledScripts > 0; }
+
+        struct ScriptTableStats
+        {
+            ScriptTableStats() : started(0), steps(0), terminated(0) {}
+
+            uint64 started;                                 // scripts scheduled by Map::ScriptsStart
+            uint64 steps;                                   // commands executed
+            uint64 terminated;                              // scripts ended early by one of their commands
+        };
+        typedef std::vector<std::pair<std::string, ScriptTableStats>> ScriptTableStatsList;
+
+        void CountScriptStart(const char* table);
+        void CountScriptStep(const char* table, bool terminated);
+        ScriptTableStatsList GetScriptTableStats() const;
         static bool CanSpellEffectStartDBScript(SpellEntry const* spellinfo, SpellEffectIndex effIdx);
         static void CollectPossibleEventIds(std::set<uint32>& eventIds);
 
@@ -613,6 +629,10 @@ class ScriptMgr
 
         // atomic op counter for active scripts amount
         std::atomic_long m_scheduledScripts;
+
+        // by table name pointer, counted from all map threads
+        mutable std::mutex m_tableStatsLock;
+        std::unordered_map<const char*, ScriptTableStats> m_tableStats;
 };
 
 // Starters for events
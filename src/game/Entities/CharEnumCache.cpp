@@ -0,0 +1,109 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Entities/CharEnumCache.h"
+
+INSTANTIATE_SINGLETON_1(CharEnumCache);
+
+void CharEnumCache::SetLifetime(uint32 seconds)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_lifetime = seconds;
+    if (!m_lifetime)
+    {
+        m_enums.clear();
+        m_accounts.clear();
+    }
+}
+
+bool CharEnumCache::Get(uint32 accountId, WorldPacket& packet)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_enums.find(accountId);
+    if (itr == m_enums.end())
+        return false;
+
+    if (itr->second.expireTime <= time(nullptr))
+    {
+        Erase(itr);
+        return false;
+    }
+
+    packet = itr->second.packet;
+    return true;
+}
+
+bool CharEnumCache::IsCached(uint32 accountId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_enums.find(accountId);
+    return itr != m_enums.end() && itr->second.expireTime > time(nullptr);
+}
+
+void CharEnumCache::Set(uint32 accountId, WorldPacket const& packet, std::vector<uint32> const& characters)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if (!m_lifetime)
+        return;
+
+    auto itr = m_enums.find(accountId);
+    if (itr != m_enums.end())
+        Erase(itr);
+
+    CachedEnum& cached = m_enums[accountId];
+    cached.expireTime = time(nullptr) + m_lifetime;
+    cached.packet = packet;
+    cached.characters = characters;
+
+    for (uint32 guidLow : characters)
+        m_accounts[guidLow] = accountId;
+}
+
+void CharEnumCache::InvalidateAccount(uint32 accountId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_enums.find(accountId);
+    if (itr != m_enums.end())
+        Erase(itr);
+}
+
+void CharEnumCache::InvalidateCharacter(uint32 guidLow)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto accountItr = m_accounts.find(guidLow);
+    if (accountItr == m_accounts.end())
+        return;
+
+    auto itr = m_enums.find(accountItr->second);
+    if (itr != m_enums.end())
+        Erase(itr);
+}
+
+void CharEnumCache::Erase(std::unordered_map<uint32, CachedEnum>::iterator itr)
+{
+    for (uint32 guidLow : itr->second.characters)
+        m_accounts.erase(guidLow);
+
+    m_enums.erase(itr);
+}
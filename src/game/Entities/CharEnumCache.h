@@ -0,0 +1,70 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef CHARENUMCACHE_H
+#define CHARENUMCACHE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "WorldPacket.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * SMSG_CHAR_ENUM packets of the accounts, so returning to the character screen or reconnecting does not read the character list again.
+ * An account is dropped whenever one of its characters is saved, created, deleted, renamed, flagged by a command or changes guild.
+ * Entries also expire after the configured lifetime, for the changes made by hand in the database.
+ */
+class CharEnumCache
+{
+    public:
+        CharEnumCache() : m_lifetime(0) {}
+
+        // 0 disables the cache
+        void SetLifetime(uint32 seconds);
+
+        bool Get(uint32 accountId, WorldPacket& packet);
+        bool IsCached(uint32 accountId);
+        void Set(uint32 accountId, WorldPacket const& packet, std::vector<uint32> const& characters);
+
+        void InvalidateAccount(uint32 accountId);
+        // for the paths knowing only the character, drops the account that listed it
+        void InvalidateCharacter(uint32 guidLow);
+
+    private:
+        struct CachedEnum
+        {
+            time_t expireTime;
+            WorldPacket packet;
+            std::vector<uint32> characters;
+        };
+
+        void Erase(std::unordered_map<uint32, CachedEnum>::iterator itr);
+
+        std::mutex m_lock;
+        std::unordered_map<uint32, CachedEnum> m_enums;    // by account id
+        std::unordered_map<uint32, uint32> m_accounts;     // account id by character guid, for the listed characters
+        uint32 m_lifetime;
+};
+
+#define sCharEnumCache MaNGOS::Singleton<CharEnumCache>::Instance()
+
+#endif
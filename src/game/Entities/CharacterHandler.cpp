@@ -37,6 +37,9 @@
 #include "Social/SocialMgr.h"
 #include "Util.h"
 #include "Tools/Language.h"
+#include "Entities/CharEnumCache.h"
+#include "Entities/CharacterNameCache.h"
+#include "Accounts/RealmCharacterCounter.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 
 #ifdef BUILD_PLAYERBOT
@@ -100,11 +103,14 @@ bool LoginQueryHolder::Initialize()
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADBGDATA,          "SELECT instance_id, team, join_x, join_y, join_z, join_o, join_map FROM character_battleground_data WHERE guid = '%u'", m_guid.GetCounter());
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSKILLS,          "SELECT skill, value, max FROM character_skills WHERE guid = '%u'", m_guid.GetCounter());
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILS,           "SELECT id,messageType,sender,receiver,subject,itemTextId,expire_time,deliver_time,money,cod,checked,stationery,mailTemplateId,has_items FROM mail WHERE receiver = '%u' ORDER BY id DESC", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS,     "SELECT data, mail_id, item_guid, item_template FROM mail_items JOIN item_instance ON item_guid = guid WHERE receiver = '%u'", m_guid.GetCounter());
+    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS,     "SELECT mail_id, item_guid, item_template FROM mail_items WHERE receiver = '%u'", m_guid.GetCounter());
 
     return res;
 }
 
+// seconds a character list read during the login queue is used for
+static const time_t CHAR_ENUM_PREFETCH_LIFETIME = 60;
+
 // don't call WorldSession directly
 // it may get deleted before the query callbacks get executed
 // instead pass an account id to this handler
@@ -117,6 +123,14 @@ class CharacterHandler
                 session->HandleCharEnum(result);
         }
 
+        void HandleCharEnumPrefetchCallback(QueryResult* result, uint32 account)
+        {
+            if (WorldSession* session = sWorld.FindSession(account))
+                session->HandlePrefetchedCharEnum(result);
+            else
+                delete result;
+        }
+
         void HandlePlayerLoginCallback(QueryResult* /*dummy*/, SqlQueryHolder* holder)
         {
             if (!holder) return;
@@ -157,6 +171,7 @@ void WorldSession::HandleCharEnum(QueryResult* result)
     WorldPacket data(SMSG_CHAR_ENUM, 100);                  // we guess size
 
     uint8 num = 0;
+    std::vector<uint32> characters;
 
     data << num;
 
@@ -166,6 +181,7 @@ void WorldSession::HandleCharEnum(QueryResult* result)
         {
             uint32 guidlow = (*result)[0].GetUInt32();
             DETAIL_LOG("Build enum data for char guid %u from account %u.", guidlow, GetAccountId());
+            characters.push_back(guidlow);
             if (Player::BuildEnumData(result, data))
                 ++num;
         }
@@ -176,13 +192,18 @@ void WorldSession::HandleCharEnum(QueryResult* result)
 
     data.put<uint8>(0, num);
 
+    sCharEnumCache.Set(GetAccountId(), data, characters);
+
     SendPacket(data, true);
 }
 
-void WorldSession::HandleCharEnumOpcode(WorldPacket& /*recv_data*/)
+/// get all the data necessary for loading all characters (along with their pets) on the account
+static void QueryCharEnum(uint32 accountId, void (CharacterHandler::*callback)(QueryResult*, uint32))
 {
-    /// get all the data necessary for loading all characters (along with their pets) on the account
-    CharacterDatabase.AsyncPQuery(&chrHandler, &CharacterHandler::HandleCharEnumCallback, GetAccountId(),
+    // on the connection of the account's saves, so the list is read after the last one and can be cached
+    SqlAsyncKeyScope asyncKey(accountId);
+
+    CharacterDatabase.AsyncPQuery(&chrHandler, callback, accountId,
                                   !sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED) ?
                                   //   ------- Query Without Declined Names --------
                                   //           0               1                2                3                 4                  5                       6                        7
@@ -206,7 +227,48 @@ void WorldSession::HandleCharEnumOpcode(WorldPacket& /*recv_data*/)
                                   "LEFT JOIN character_declinedname ON characters.guid = character_declinedname.guid "
                                   "LEFT JOIN guild_member ON characters.guid = guild_member.guid "
                                   "WHERE characters.account = '%u' ORDER BY characters.guid",
-                                  PET_SAVE_AS_CURRENT, GetAccountId());
+                                  PET_SAVE_AS_CURRENT, accountId);
+}
+
+void WorldSession::HandleCharEnumOpcode(WorldPacket& /*recv_data*/)
+{
+    // needed by the account limit check of character creation
+    sRealmCharacterCounter.Load(GetAccountId());
+
+    WorldPacket data;
+    if (sCharEnumCache.Get(GetAccountId(), data))
+    {
+        SendPacket(data, true);
+        return;
+    }
+
+    ///- The list read during the login queue is used once, characters can only change by console meanwhile
+    if (m_charEnumPrefetchTime + CHAR_ENUM_PREFETCH_LIFETIME > time(nullptr))
+    {
+        m_charEnumPrefetchTime = 0;
+        HandleCharEnum(m_prefetchedCharEnum.release());
+        return;
+    }
+    m_prefetchedCharEnum.reset();
+
+    QueryCharEnum(GetAccountId(), &CharacterHandler::HandleCharEnumCallback);
+}
+
+void WorldSession::PrefetchCharEnum()
+{
+    if (m_charEnumPrefetching || m_charEnumPrefetchTime + CHAR_ENUM_PREFETCH_LIFETIME > time(nullptr) || sCharEnumCache.IsCached(GetAccountId()))
+        return;
+
+    m_charEnumPrefetching = true;
+    QueryCharEnum(GetAccountId(), &CharacterHandler::HandleCharEnumPrefetchCallback);
+}
+
+void WorldSession::HandlePrefetchedCharEnum(QueryResult* result)
+{
+    // accounts without characters get no result, it is kept as an empty list
+    m_charEnumPrefetching = false;
+    m_charEnumPrefetchTime = time(nullptr);
+    m_prefetchedCharEnum.reset(result);
 }
 
 void WorldSession::HandleCharCreateOpcode(WorldPacket& recv_data)
@@ -301,21 +363,24 @@ void WorldSession::HandleCharCreateOpcode(WorldPacket& recv_data)
         return;
     }
 
-    QueryResult* resultacct = LoginDatabase.PQuery("SELECT SUM(numchars) FROM realmcharacters WHERE acctid = '%u'", GetAccountId());
-    if (resultacct)
+    // the counts are loaded when the character screen opens, the login database is only asked if that did not finish yet
+    uint32 acctcharcount = 0;
+    if (!sRealmCharacterCounter.GetAccountTotal(GetAccountId(), acctcharcount))
     {
-        Field* fields = resultacct->Fetch();
-        uint32 acctcharcount = fields[0].GetUInt32();
-        delete resultacct;
-
-        if (acctcharcount >= sWorld.getConfig(CONFIG_UINT32_CHARACTERS_PER_ACCOUNT))
+        if (QueryResult* resultacct = LoginDatabase.PQuery("SELECT SUM(numchars) FROM realmcharacters WHERE acctid = '%u'", GetAccountId()))
         {
-            data << (uint8)CHAR_CREATE_ACCOUNT_LIMIT;
-            SendPacket(data, true);
-            return;
+            acctcharcount = resultacct->Fetch()[0].GetUInt32();
+            delete resultacct;
         }
     }
 
+    if (acctcharcount >= sWorld.getConfig(CONFIG_UINT32_CHARACTERS_PER_ACCOUNT))
+    {
+        data << (uint8)CHAR_CREATE_ACCOUNT_LIMIT;
+        SendPacket(data, true);
+        return;
+    }
+
     QueryResult* result = CharacterDatabase.PQuery("SELECT COUNT(guid) FROM characters WHERE account = '%u'", GetAccountId());
     uint8 charcount = 0;
     if (result)
@@ -397,8 +462,9 @@ void WorldSession::HandleCharCreateOpcode(WorldPacket& recv_data)
     pNewChar->SaveToDB();
     charcount += 1;
 
-    LoginDatabase.PExecute("DELETE FROM realmcharacters WHERE acctid= '%u' AND realmid = '%u'", GetAccountId(), realmID);
-    LoginDatabase.PExecute("INSERT INTO realmcharacters (numchars, acctid, realmid) VALUES (%u, %u, %u)",  charcount, GetAccountId(), realmID);
+    sCharacterNameCache.Add(pNewChar->GetGUIDLow(), name, race_, gender, class_);
+
+    sRealmCharacterCounter.SetRealmCount(GetAccountId(), charcount);
 
     data << (uint8)CHAR_CREATE_SUCCESS;
     SendPacket(data, true);
@@ -644,6 +710,7 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
 
             guild->DisplayGuildBankTabsInfo(this);
 
+            guild->SetMemberOnline(pCurrChar->GetObjectGuid(), true);
             guild->BroadcastEvent(GE_SIGNED_ON, pCurrChar->GetObjectGuid(), pCurrChar->GetName());
         }
         else
@@ -801,6 +868,7 @@ void WorldSession::HandlePlayerReconnect()
 {
     // stop logout timer if need
     LogoutRequest(0);
+    RemoveLingerProtection();
 
     // set loading flag
     m_playerLoading = true;
@@ -850,6 +918,7 @@ void WorldSession::HandlePlayerReconnect()
             SendPacket(data);
             DEBUG_LOG("WORLD: Sent guild-motd (SMSG_GUILD_EVENT)");
 
+            guild->SetMemberOnline(_player->GetObjectGuid(), true);
             guild->BroadcastEvent(GE_SIGNED_ON, _player->GetObjectGuid(), _player->GetName());
         }
         else
@@ -1077,6 +1146,9 @@ void WorldSession::HandleChangePlayerNameOpcodeCallBack(QueryResult* result, uin
     CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid ='%u'", guidLow);
     CharacterDatabase.CommitTransaction();
 
+    sCharEnumCache.InvalidateAccount(accountId);
+    sCharacterNameCache.SetName(guidLow, newname);
+
     sLog.outChar("Account: %d (IP: %s) Character:[%s] (guid:%u) Changed name to: %s", session->GetAccountId(), session->GetRemoteAddress().c_str(), oldname.c_str(), guidLow, newname.c_str());
 
     WorldPacket data(SMSG_CHAR_RENAME, 1 + 8 + (newname.size() + 1));
@@ -1160,6 +1232,8 @@ void WorldSession::HandleSetPlayerDeclinedNamesOpcode(WorldPacket& recv_data)
         return;
     }
 
+    sCharacterNameCache.SetDeclinedNames(guid.GetCounter(), declinedname);
+
     for (auto& i : declinedname.name)
         CharacterDatabase.escape_string(i);
 
@@ -1169,6 +1243,8 @@ void WorldSession::HandleSetPlayerDeclinedNamesOpcode(WorldPacket& recv_data)
                                guid.GetCounter(), declinedname.name[0].c_str(), declinedname.name[1].c_str(), declinedname.name[2].c_str(), declinedname.name[3].c_str(), declinedname.name[4].c_str());
     CharacterDatabase.CommitTransaction();
 
+    sCharEnumCache.InvalidateAccount(GetAccountId());
+
     WorldPacket data(SMSG_SET_PLAYER_DECLINED_NAMES_RESULT, 4 + 8);
     data << uint32(0);                                      // OK
     data << ObjectGuid(guid);
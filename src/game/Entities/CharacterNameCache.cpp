@@ -0,0 +1,195 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Entities/CharacterNameCache.h"
+#include "Database/DatabaseEnv.h"
+#include "Server/WorldSession.h"
+#include "World/World.h"
+#include "ProgressBar.h"
+
+INSTANTIATE_SINGLETON_1(CharacterNameCache);
+
+void CharacterNameCache::Load()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    m_names.clear();
+
+    // deleted characters keep their row with an empty name, cached as well so their queries stay off the database too
+    //                                                    0     1     2     3       4
+    QueryResult* result = CharacterDatabase.QueryStream("SELECT guid, name, race, gender, class FROM characters");
+    if (!result)
+    {
+        BarGoLink bar(1);
+        bar.step();
+        sLog.outString(">> Loaded 0 character names");
+        sLog.outString();
+        return;
+    }
+
+    BarGoLink bar(result->GetRowCount());
+
+    do
+    {
+        bar.step();
+
+        Field* fields = result->Fetch();
+
+        CachedName& cached = m_names[fields[0].GetUInt32()];
+        cached.name = fields[1].GetCppString();
+        cached.race = fields[2].GetUInt8();
+        cached.gender = fields[3].GetUInt8();
+        cached.classid = fields[4].GetUInt8();
+    }
+    while (result->NextRow());
+
+    delete result;
+
+    uint32 declinedCount = 0;
+    if (sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED))
+    {
+        //                                                   0     1         2       3           4             5
+        result = CharacterDatabase.QueryStream("SELECT guid, genitive, dative, accusative, instrumental, prepositional FROM character_declinedname");
+        if (result)
+        {
+            do
+            {
+                Field* fields = result->Fetch();
+
+                auto itr = m_names.find(fields[0].GetUInt32());
+                // if the first declined name field is empty, the rest must be too
+                if (itr == m_names.end() || fields[1].GetCppString().empty())
+                    continue;
+
+                itr->second.declined.resize(MAX_DECLINED_NAME_CASES);
+                for (int i = 0; i < MAX_DECLINED_NAME_CASES; ++i)
+                    itr->second.declined[i] = fields[1 + i].GetCppString();
+
+                ++declinedCount;
+            }
+            while (result->NextRow());
+
+            delete result;
+        }
+    }
+
+    sLog.outString(">> Loaded " SIZEFMTD " character names, %u with declined names", m_names.size(), declinedCount);
+    sLog.outString();
+}
+
+bool CharacterNameCache::Get(uint32 guidLow, CharacterNameQueryResponse& response)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_names.find(guidLow);
+    if (itr == m_names.end())
+        return false;
+
+    CachedName const& cached = itr->second;
+
+    response.guid = ObjectGuid(HIGHGUID_PLAYER, guidLow);
+    response.name = cached.name;
+    response.realm = "";
+
+    if (!cached.name.empty())
+    {
+        response.race = cached.race;
+        response.gender = cached.gender;
+        response.classid = cached.classid;
+    }
+
+    if (sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED) && !cached.declined.empty())
+    {
+        for (int i = 0; i < MAX_DECLINED_NAME_CASES; ++i)
+            response.declined.name[i] = cached.declined[i];
+    }
+
+    return true;
+}
+
+bool CharacterNameCache::GetName(uint32 guidLow, std::string& name)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_names.find(guidLow);
+    if (itr == m_names.end() || itr->second.name.empty())
+        return false;
+
+    name = itr->second.name;
+    return true;
+}
+
+bool CharacterNameCache::GetRace(uint32 guidLow, uint8& race)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_names.find(guidLow);
+    if (itr == m_names.end() || itr->second.name.empty())
+        return false;
+
+    race = itr->second.race;
+    return true;
+}
+
+void CharacterNameCache::Add(uint32 guidLow, std::string const& name, uint8 race, uint8 gender, uint8 classid)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    CachedName& cached = m_names[guidLow];
+    cached.name = name;
+    cached.declined.clear();
+    cached.race = race;
+    cached.gender = gender;
+    cached.classid = classid;
+}
+
+void CharacterNameCache::SetName(uint32 guidLow, std::string const& name)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_names.find(guidLow);
+    if (itr == m_names.end())
+        return;
+
+    itr->second.name = name;
+    itr->second.declined.clear();
+}
+
+void CharacterNameCache::SetDeclinedNames(uint32 guidLow, DeclinedName const& declined)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_names.find(guidLow);
+    if (itr == m_names.end())
+        return;
+
+    if (declined.name[0].empty())
+    {
+        itr->second.declined.clear();
+        return;
+    }
+
+    itr->second.declined.assign(std::begin(declined.name), std::end(declined.name));
+}
+
+void CharacterNameCache::Remove(uint32 guidLow)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_names.erase(guidLow);
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef CHARACTERNAMECACHE_H
+#define CHARACTERNAMECACHE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct CharacterNameQueryResponse;
+struct DeclinedName;
+
+/**
+ * Name, race, gender, class and declined names of every character, so name queries for offline characters do not read the database.
+ * Filled at startup and kept current on create, rename, declined name change and delete.
+ * Characters added behind the server's back (player dumps) are read once on their first query and kept from then on.
+ */
+class CharacterNameCache
+{
+    public:
+        void Load();
+
+        bool Get(uint32 guidLow, CharacterNameQueryResponse& response);
+        bool GetName(uint32 guidLow, std::string& name);
+        bool GetRace(uint32 guidLow, uint8& race);
+
+        void Add(uint32 guidLow, std::string const& name, uint8 race, uint8 gender, uint8 classid);
+        // the declined names of the old name are dropped like in the database
+        void SetName(uint32 guidLow, std::string const& name);
+        void SetDeclinedNames(uint32 guidLow, DeclinedName const& declined);
+        void Remove(uint32 guidLow);
+
+    private:
+        struct CachedName
+        {
+            std::string name;
+            std::vector<std::string> declined;              // empty or MAX_DECLINED_NAME_CASES, only some locales use them
+            uint8 race;
+            uint8 gender;
+            uint8 classid;
+        };
+
+        std::mutex m_lock;
+        std::unordered_map<uint32, CachedName> m_names;    // by character guid
+};
+
+#define sCharacterNameCache MaNGOS::Singleton<CharacterNameCache>::Instance()
+
+#endif
@@ -48,8 +48,14 @@ void Corpse::AddToWorld()
 {
     ///- Register the corpse for guid lookup
     if (!IsInWorld())
+    {
         sObjectAccessor.AddObject(this);
 
+        // a resurrectable corpse in world expires on its map
+        if (m_type != CORPSE_BONES)
+            GetMap()->ScheduleCorpseExpiry(this);
+    }
+
     WorldObject::AddToWorld();
 }
 
@@ -266,9 +272,9 @@ bool Corpse::isVisibleForInState(Player const* u, WorldObject const* viewPoint,
     return IsInWorld() && u->IsInWorld() && IsWithinDistInMap(viewPoint, GetMap()->GetVisibilityDistance(), false);
 }
 
-bool Corpse::IsExpired(time_t t) const
+time_t Corpse::GetExpiryTime() const
 {
     if (m_type == CORPSE_BONES)
-        return m_time < t - 60 * MINUTE;
-    return m_time < t - 3 * DAY;
+        return m_time + 60 * MINUTE;
+    return m_time + 3 * DAY;
 }
@@ -88,12 +88,15 @@ class Corpse : public WorldObject
 
         GridReference<Corpse>& GetGridRef() { return m_gridRef; }
 
-        bool IsExpired(time_t t) const;
+        bool IsExpired(time_t t) const { return GetExpiryTime() < t; }
+        time_t GetExpiryTime() const;
     private:
         GridReference<Corpse> m_gridRef;
 
         CorpseType m_type;
         time_t m_time;
         GridPair m_grid;                                    // gride for corpse position for fast search
+
+        TrackedMemory<MEMORY_TAG_OTHER_OBJECTS, Corpse> m_trackedMemory;
 };
 #endif
@@ -45,6 +45,7 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "Grids/CellImpl.h"
 #include "Movement/MoveSplineInit.h"
+#include "Movement/MoveSpline.h"
 #include "Entities/CreatureLinkingMgr.h"
 
 // apply implementation of the singletons
@@ -130,10 +131,14 @@ bool CreatureCreatePos::Relocate(Creature* cr) const
     return true;
 }
 
+std::atomic<uint64> Creature::s_idleSkippedUpdates(0);
+std::atomic<uint64> Creature::s_idleUpdates(0);
+
 Creature::Creature(CreatureSubtype subtype) : Unit(),
     m_lootMoney(0), m_lootGroupRecipientId(0),
     m_lootStatus(CREATURE_LOOT_STATUS_NONE),
-    m_respawnTime(0), m_respawnDelay(25), m_respawnOverriden(false), m_respawnOverrideOnce(false), m_corpseDelay(60), m_canAggro(false),
+    m_respawnTime(0), m_respawnSleepTime(0), m_respawnDelay(25), m_respawnOverriden(false), m_respawnOverrideOnce(false), m_corpseDelay(60),
+    m_idleUpdateDiff(0), m_idleUpdateAIType(0), m_canAggro(false),
     m_respawnradius(5.0f), m_subtype(subtype), m_defaultMovementType(IDLE_MOTION_TYPE),
     m_equipmentId(0), m_AlreadyCallAssistance(false),
     m_isDeadByDefault(false),
@@ -621,8 +626,21 @@ uint32 Creature::ChooseDisplayId(const CreatureInfo* cinfo, const CreatureData*
     return display_id;
 }
 
-void Creature::Update(const uint32 diff)
+void Creature::Update(const uint32 update_diff)
 {
+    // idle creatures are updated every CreatureIdleUpdateInterval only, with the time they skipped
+    m_idleUpdateDiff += update_diff;
+    if (m_idleUpdateDiff < sWorld.getConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL) && CanUpdateAtIdleRate())
+    {
+        ++s_idleSkippedUpdates;
+        return;
+    }
+
+    const uint32 diff = m_idleUpdateDiff;
+    if (diff != update_diff)
+        ++s_idleUpdates;
+    m_idleUpdateDiff = 0;
+
     switch (m_deathState)
     {
         case JUST_ALIVED:
@@ -639,6 +657,7 @@ void Creature::Update(const uint32 diff)
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_AI_AND_MOVEGENSS, "Respawning...");
                 m_respawnTime = 0;
+                m_respawnSleepTime = 0;
                 SetCanAggro(false);
                 delete m_loot;
                 m_loot = nullptr;
@@ -674,6 +693,12 @@ void Creature::Update(const uint32 diff)
                 if (uint16 poolid = sPoolMgr.IsPartOfAPool<Creature>(GetGUIDLow()))
                     sPoolMgr.UpdatePool<Creature>(*GetMap()->GetPersistentState(), poolid, GetGUIDLow());
             }
+            else if (m_respawnTime > time(nullptr) && m_respawnSleepTime != m_respawnTime)
+            {
+                // nothing to do until the respawn time, the cell updates skip the creature until the map wakes it
+                m_respawnSleepTime = m_respawnTime;
+                GetMap()->ScheduleRespawn(GetObjectGuid(), m_respawnTime);
+            }
             break;
         }
         case CORPSE:
@@ -718,6 +743,51 @@ void Creature::Update(const uint32 diff)
     }
 }
 
+bool Creature::DeferUpdate(uint32 diff)
+{
+    // combat, evade and controlled creatures are always updated, any other one catches up after MapUpdate.AIBudget.MaxDelay
+    // temporary summons are not deferred, their lifetime is counted in their own Update
+    if (isInCombat() || GetCombatManager().IsInEvadeMode() || GetMasterGuid() || isActiveObject() || IsTemporarySummon())
+        return false;
+
+    if (m_idleUpdateDiff + diff > sWorld.getConfig(CONFIG_UINT32_MAP_AI_BUDGET_MAX_DELAY))
+        return false;
+
+    m_idleUpdateDiff += diff;
+    return true;
+}
+
+bool Creature::CanUpdateAtIdleRate() const
+{
+    if (m_deathState != ALIVE || !(m_idleUpdateAIType & sWorld.getConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_AI_TYPES)))
+        return false;
+
+    if (!(sWorld.getConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_MOVEMENT_TYPES) & (1 << i_motionMaster.GetCurrentMovementGeneratorType())))
+        return false;
+
+    // anything that acts on its own timer or was told to act keeps the full rate
+    if (isInCombat() || GetCombatManager().IsInEvadeMode() || GetMasterGuid() || isActiveObject())
+        return false;
+
+    if (!movespline->Finalized() || IsNonMeleeSpellCasted(false) || !m_events.GetEvents().empty())
+        return false;
+
+    // periodic auras tick once per update and timed auras would expire late
+    for (auto const& itr : GetSpellAuraHolderMap())
+    {
+        SpellAuraHolder const* holder = itr.second;
+        if (!holder->IsPermanent())
+            return false;
+
+        for (uint32 i = EFFECT_INDEX_0; i < MAX_EFFECT_INDEX; ++i)
+            if (Aura const* aura = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
+                if (aura->IsPeriodic())
+                    return false;
+    }
+
+    return true;
+}
+
 void Creature::RegenerateAll(uint32 update_diff)
 {
     if (m_regenTimer > 0)
@@ -829,6 +899,13 @@ bool Creature::AIM_Initialize()
     i_motionMaster.Initialize();
     m_ai.reset(FactorySelector::selectAI(this));
 
+    if (GetScriptId())
+        m_idleUpdateAIType = IDLE_UPDATE_AI_SCRIPT;
+    else if (GetAIName() == "EventAI")
+        m_idleUpdateAIType = IDLE_UPDATE_AI_EVENTAI;
+    else
+        m_idleUpdateAIType = IDLE_UPDATE_AI_CORE;
+
     // Handle Spawned Events, also calls Reset()
     m_ai->JustRespawned();
 
@@ -2288,7 +2365,7 @@ Unit* Creature::SelectAttackingTarget(AttackingTarget target, uint32 position, S
             suitableUnits.reserve(threatlist.size() - position);
 
             if (position)
-                advance(itr, position);
+                std::advance(itr, position);
 
             for (; itr != threatlist.end(); ++itr)
             {
@@ -2307,7 +2384,7 @@ Unit* Creature::SelectAttackingTarget(AttackingTarget target, uint32 position, S
         case ATTACKING_TARGET_TOPAGGRO:
         {
             if (position)
-                advance(itr, position);
+                std::advance(itr, position);
 
             for (; itr != threatlist.end(); ++itr)
             {
@@ -2325,7 +2402,7 @@ Unit* Creature::SelectAttackingTarget(AttackingTarget target, uint32 position, S
             ThreatList::const_reverse_iterator ritr = threatlist.rbegin();
 
             if (position)
-                advance(ritr, position);
+                std::advance(ritr, position);
 
             for (; ritr != threatlist.rend(); ++ritr)
             {
@@ -2400,7 +2477,7 @@ void Creature::SelectAttackingTargets(std::vector<Unit*>& selectedTargets, Attac
         case ATTACKING_TARGET_ALL_SUITABLE:
         {
             if (position)
-                advance(itr, position);
+                std::advance(itr, position);
 
             for (; itr != threatlist.end(); ++itr)
             {
@@ -2682,22 +2759,40 @@ void Creature::FillGuidsListFromThreatList(GuidVector& guids, uint32 maxamount /
         guids.push_back((*itr)->getUnitGuid());
 }
 
-struct AddCreatureToRemoveListInMapsWorker
+void Creature::AddToRemoveListInMap(uint32 db_guid, CreatureData const* data, Map* map)
 {
-    AddCreatureToRemoveListInMapsWorker(ObjectGuid guid) : i_guid(guid) {}
+    if (Creature* pCreature = map->GetCreature(data->GetObjectGuid(db_guid)))
+        pCreature->AddObjectToRemoveList();
+}
 
-    void operator()(Map* map)
+void Creature::SpawnInMap(uint32 db_guid, CreatureData const* data, Map* map)
+{
+    // We use spawn coords to spawn, a grid loaded after the spawn data was added already has it
+    if (map->IsLoaded(data->posX, data->posY) && !map->GetCreature(data->GetObjectGuid(db_guid)))
     {
-        if (Creature* pCreature = map->GetCreature(i_guid))
-            pCreature->AddObjectToRemoveList();
+        Creature* pCreature = new Creature;
+        // DEBUG_LOG("Spawning creature %u",*itr);
+        if (!pCreature->LoadFromDB(db_guid, map))
+        {
+            delete pCreature;
+        }
     }
+}
 
-    ObjectGuid i_guid;
+struct AddCreatureToRemoveListInMapsWorker
+{
+    AddCreatureToRemoveListInMapsWorker(uint32 guid, CreatureData const* data)
+        : i_guid(guid), i_data(data) {}
+
+    void operator()(Map* map) { Creature::AddToRemoveListInMap(i_guid, i_data, map); }
+
+    uint32 i_guid;
+    CreatureData const* i_data;
 };
 
 void Creature::AddToRemoveListInMaps(uint32 db_guid, CreatureData const* data)
 {
-    AddCreatureToRemoveListInMapsWorker worker(data->GetObjectGuid(db_guid));
+    AddCreatureToRemoveListInMapsWorker worker(db_guid, data);
     sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
 }
 
@@ -2706,19 +2801,7 @@ struct SpawnCreatureInMapsWorker
     SpawnCreatureInMapsWorker(uint32 guid, CreatureData const* data)
         : i_guid(guid), i_data(data) {}
 
-    void operator()(Map* map)
-    {
-        // We use spawn coords to spawn
-        if (map->IsLoaded(i_data->posX, i_data->posY))
-        {
-            Creature* pCreature = new Creature;
-            // DEBUG_LOG("Spawning creature %u",*itr);
-            if (!pCreature->LoadFromDB(i_guid, map))
-            {
-                delete pCreature;
-            }
-        }
-    }
+    void operator()(Map* map) { Creature::SpawnInMap(i_guid, i_data, map); }
 
     uint32 i_guid;
     CreatureData const* i_data;
@@ -26,6 +26,7 @@
 #include "Grids/Cell.h"
 #include "Util.h"
 
+#include <atomic>
 #include <list>
 #include <memory>
 
@@ -570,6 +571,14 @@ struct SelectAttackingTargetParams
     };
 };
 
+// AI groups that may be updated at the idle rate, see CreatureIdleUpdateAITypes
+enum CreatureIdleUpdateAIType
+{
+    IDLE_UPDATE_AI_CORE                 = 0x01,             // AIs of the core, selected by AIName or by permit
+    IDLE_UPDATE_AI_EVENTAI              = 0x02,             // EventAI
+    IDLE_UPDATE_AI_SCRIPT               = 0x04,             // AIs of a ScriptName
+};
+
 class Creature : public Unit
 {
     public:
@@ -592,7 +601,15 @@ class Creature : public Unit
 
         char const* GetSubName() const { return GetCreatureInfo()->SubName; }
 
-        void Update(const uint32 diff) override;  // overwrite Unit::Update
+        void Update(const uint32 update_diff) override;  // overwrite Unit::Update
+
+        // updates skipped and run at the idle rate since the start or the last reset, see CreatureIdleUpdateInterval
+        static uint64 GetIdleSkippedUpdates() { return s_idleSkippedUpdates; }
+        static uint64 GetIdleUpdates() { return s_idleUpdates; }
+        static void ResetIdleUpdateCounters() { s_idleSkippedUpdates = 0; s_idleUpdates = 0; }
+
+        // skips this update for an out of combat creature when the map AI budget is spent, the time is added to the next one
+        bool DeferUpdate(uint32 diff);
 
         virtual void RegenerateAll(uint32 update_diff);
         uint32 GetEquipmentId() const { return m_equipmentId; }
@@ -776,6 +793,10 @@ class Creature : public Unit
         void Respawn();
         void SaveRespawnTime() override;
 
+        // dead and scheduled for the current respawn time, any change of the respawn time wakes it for a normal update
+        bool IsSleepingUntilRespawn() const { return m_deathState == DEAD && m_respawnSleepTime && m_respawnSleepTime == m_respawnTime; }
+        void WakeUpForRespawn(time_t scheduledTime) { if (m_respawnSleepTime == scheduledTime) m_respawnSleepTime = 0; }
+
         uint32 GetRespawnDelay() const { return m_respawnDelay; }
         void SetRespawnDelay(uint32 delay, bool once = false) { m_respawnDelay = delay; m_respawnOverriden = true; m_respawnOverrideOnce = once; }
 
@@ -785,6 +806,8 @@ class Creature : public Unit
         // Functions spawn/remove creature with DB guid in all loaded map copies (if point grid loaded in map)
         static void AddToRemoveListInMaps(uint32 db_guid, CreatureData const* data);
         static void SpawnInMaps(uint32 db_guid, CreatureData const* data);
+        static void AddToRemoveListInMap(uint32 db_guid, CreatureData const* data, Map* map);
+        static void SpawnInMap(uint32 db_guid, CreatureData const* data, Map* map);
 
         void SendZoneUnderAttackMessage(Player* attacker) const;
 
@@ -879,6 +902,7 @@ class Creature : public Unit
         void UnsummonCleanup(); // cleans up data before unsummon of various creatures
 
         bool IsCorpseExpired() const;
+        bool CanUpdateAtIdleRate() const;
 
         // vendor items
         VendorItemCounts m_vendorItemCounts;
@@ -891,10 +915,13 @@ class Creature : public Unit
         /// Timers
         TimePoint m_corpseExpirationTime;                   // (msecs) time point of corpse decay
         time_t m_respawnTime;                               // (secs) time of next respawn
+        time_t m_respawnSleepTime;                          // (secs) respawn time the map queue wakes the creature at, 0 when awake
         uint32 m_respawnDelay;                              // (secs) delay between corpse disappearance and respawning
         bool m_respawnOverriden;
         bool m_respawnOverrideOnce;
         uint32 m_corpseDelay;                               // (secs) delay between death and corpse disappearance
+        uint32 m_idleUpdateDiff;                            // (msecs) update time accumulated while updated at the idle rate
+        uint32 m_idleUpdateAIType;                          // CreatureIdleUpdateAIType of the selected AI
         TimePoint m_pickpocketRestockTime;                  // (msecs) time point of pickpocket restock
         bool m_canAggro;                                    // controls response of creature to attacks
         float m_respawnradius;
@@ -933,8 +960,13 @@ class Creature : public Unit
         std::set<uint32> m_hitBySpells;
 
     private:
+        static std::atomic<uint64> s_idleSkippedUpdates;
+        static std::atomic<uint64> s_idleUpdates;
+
         GridReference<Creature> m_gridRef;
         CreatureInfo const* m_creatureInfo;                 // in heroic mode can different from sObjectMgr::GetCreatureTemplate(GetEntry())
+
+        TrackedMemory<MEMORY_TAG_CREATURES, Creature> m_trackedMemory;
 };
 
 class ForcedDespawnDelayEvent : public BasicEvent
@@ -336,6 +336,8 @@ void CreatureLinkingHolder::AddSlaveToHolder(Creature* pCreature)
     if (!pInfo)
         return;
 
+    ++m_holderVersion;                                      // Links resolved before may miss this slave
+
     if (pInfo->mapId == INVALID_MAP_ID)                     // Guid case, store master->slaves for fast access
     {
         HolderMapBounds bounds = m_holderGuidMap.equal_range(pInfo->masterId);
@@ -394,6 +396,8 @@ void CreatureLinkingHolder::AddMasterToHolder(Creature* pCreature)
     if (!sCreatureLinkingMgr.IsLinkedMaster(pCreature))
         return;
 
+    ++m_holderVersion;                                      // Also when reloaded, slaves may have cached no master in range
+
     // Check, if already stored
     BossGuidMapBounds bounds = m_masterGuid.equal_range(pCreature->GetEntry());
     for (BossGuidMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
@@ -429,42 +433,28 @@ void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventTyp
         case LINKING_EVENT_DESPAWN: eventFlagFilter = EVENT_MASK_ON_DESPAWN; reverseEventFlagFilter = 0;                        break;
     }
 
-    // Process Slaves (by entry)
-    HolderMapBounds bounds = m_holderMap.equal_range(pSource->GetEntry());
-    for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
-        ProcessSlaveGuidList(eventType, pSource, itr->second.linkingFlag & eventFlagFilter, itr->second.searchRange, itr->second.linkedGuids, pEnemy);
+    // Mass pulls reach a creature over many links, its aggro on the same enemy is processed once per map update
+    if (eventType == LINKING_EVENT_AGGRO && !IsNewAggroEvent(pSource, pEnemy))
+        return;
 
-    // Process Slaves (by guid)
-    bounds = m_holderGuidMap.equal_range(pSource->GetGUIDLow());
-    for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
-        ProcessSlaveGuidList(eventType, pSource, itr->second.linkingFlag & eventFlagFilter, itr->second.searchRange, itr->second.linkedGuids, pEnemy);
+    // Process Slaves (by entry and by guid)
+    LinkedSlaveList slaves = GetLinkedSlaves(pSource);
+    for (LinkedSlave const& slave : slaves)
+    {
+        uint32 flag = slave.linkingFlag & eventFlagFilter;
+        if (!flag)
+            continue;
+
+        if (Creature* pSlave = pSource->GetMap()->GetCreature(slave.guid))
+            ProcessSlave(eventType, pSource, flag, pSlave, pEnemy);
+    }
 
     // Process Master
     if (CreatureLinkingInfo const* pInfo = sCreatureLinkingMgr.GetLinkedTriggerInformation(pSource))
     {
         if (pInfo->linkingFlag & reverseEventFlagFilter)
         {
-            Creature* pMaster = nullptr;
-            if (pInfo->mapId != INVALID_MAP_ID)             // entry case
-            { 
-                BossGuidMapBounds finds = m_masterGuid.equal_range(pInfo->masterId);
-                for (BossGuidMap::const_iterator itr = finds.first; itr != finds.second; ++itr)
-                {
-                    Creature* master = pSource->GetMap()->GetCreature(itr->second);
-                    if (master && IsSlaveInRangeOfMaster(pSource, master, pInfo->searchRange))
-                    {
-                        pMaster = master;
-                        break;
-                    }
-                }
-            }
-            else                                            // guid case
-            {
-                CreatureData const* masterData = sObjectMgr.GetCreatureData(pInfo->masterDBGuid);
-                CreatureInfo const* cInfo = ObjectMgr::GetCreatureTemplate(masterData->id);
-                pMaster = pSource->GetMap()->GetCreature(ObjectGuid(cInfo->GetHighGuid(), cInfo->Entry, pInfo->masterDBGuid));
-            }
-
+            Creature* pMaster = GetLinkedMaster(pSource, pInfo);
             if (pMaster)
             {
                 switch (eventType)
@@ -500,32 +490,115 @@ void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventTyp
     }
 }
 
-// Helper function, to process a slave list
-void CreatureLinkingHolder::ProcessSlaveGuidList(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, uint16 searchRange, GuidList& slaveGuidList, Unit* pEnemy)
+// Helper function, drops the resolved links once masters or slaves were added
+void CreatureLinkingHolder::ValidateCache()
 {
-    if (!flag)
+    if (m_cacheVersion == m_holderVersion)
         return;
 
-    for (GuidList::iterator slave_itr = slaveGuidList.begin(); slave_itr != slaveGuidList.end();)
+    m_linkedSlaves.clear();
+    m_linkedMasters.clear();
+    m_cacheVersion = m_holderVersion;
+}
+
+// Helper function, returns the slaves in range of a source, resolved on its first event
+CreatureLinkingHolder::LinkedSlaveList CreatureLinkingHolder::GetLinkedSlaves(Creature* pSource)
+{
+    std::lock_guard<std::mutex> guard(m_cacheLock);
+    ValidateCache();
+
+    std::unordered_map<ObjectGuid, LinkedSlaveList>::iterator itr = m_linkedSlaves.find(pSource->GetObjectGuid());
+    if (itr != m_linkedSlaves.end())
+        return itr->second;
+
+    LinkedSlaveList& slaves = m_linkedSlaves[pSource->GetObjectGuid()];
+    AddLinkedSlaves(pSource, m_holderMap.equal_range(pSource->GetEntry()), slaves);
+    AddLinkedSlaves(pSource, m_holderGuidMap.equal_range(pSource->GetGUIDLow()), slaves);
+    return slaves;
+}
+
+// Helper function, to resolve the slave lists of a source
+void CreatureLinkingHolder::AddLinkedSlaves(Creature* pSource, HolderMapBounds bounds, LinkedSlaveList& slaves)
+{
+    for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
     {
-        Creature* pSlave = pSource->GetMap()->GetCreature(*slave_itr);
-        if (!pSlave)
+        GuidList& slaveGuidList = itr->second.linkedGuids;
+        for (GuidList::iterator slave_itr = slaveGuidList.begin(); slave_itr != slaveGuidList.end();)
         {
-            // Remove old guid first
-            slave_itr = slaveGuidList.erase(slave_itr);
-            continue;
+            Creature* pSlave = pSource->GetMap()->GetCreature(*slave_itr);
+            if (!pSlave)
+            {
+                // Remove old guid first
+                slave_itr = slaveGuidList.erase(slave_itr);
+                continue;
+            }
+
+            ++slave_itr;
+
+            // Ignore Pets
+            if (pSlave->IsPet())
+                continue;
+
+            if (IsSlaveInRangeOfMaster(pSlave, pSource, itr->second.searchRange))
+                slaves.push_back({ pSlave->GetObjectGuid(), itr->second.linkingFlag });
         }
+    }
+}
 
-        ++slave_itr;
+// Helper function, returns the master of a source, the first in range for the entry case
+Creature* CreatureLinkingHolder::GetLinkedMaster(Creature* pSource, CreatureLinkingInfo const* pInfo)
+{
+    std::lock_guard<std::mutex> guard(m_cacheLock);
+    ValidateCache();
 
-        // Ignore Pets
-        if (pSlave->IsPet())
-            continue;
+    std::unordered_map<ObjectGuid, ObjectGuid>::const_iterator cached = m_linkedMasters.find(pSource->GetObjectGuid());
+    if (cached != m_linkedMasters.end())
+    {
+        if (!cached->second)
+            return nullptr;
+        if (Creature* pMaster = pSource->GetMap()->GetCreature(cached->second))
+            return pMaster;
+    }
 
-        // Handle single slave
-        if (IsSlaveInRangeOfMaster(pSlave, pSource, searchRange))
-            ProcessSlave(eventType, pSource, flag, pSlave, pEnemy);
+    Creature* pMaster = nullptr;
+    if (pInfo->mapId != INVALID_MAP_ID)                     // entry case
+    {
+        BossGuidMapBounds finds = m_masterGuid.equal_range(pInfo->masterId);
+        for (BossGuidMap::const_iterator itr = finds.first; itr != finds.second; ++itr)
+        {
+            Creature* master = pSource->GetMap()->GetCreature(itr->second);
+            if (master && IsSlaveInRangeOfMaster(pSource, master, pInfo->searchRange))
+            {
+                pMaster = master;
+                break;
+            }
+        }
+    }
+    else                                                    // guid case
+    {
+        CreatureData const* masterData = sObjectMgr.GetCreatureData(pInfo->masterDBGuid);
+        CreatureInfo const* cInfo = ObjectMgr::GetCreatureTemplate(masterData->id);
+        pMaster = pSource->GetMap()->GetCreature(ObjectGuid(cInfo->GetHighGuid(), cInfo->Entry, pInfo->masterDBGuid));
     }
+
+    // Masters by entry invalidate the cache when loaded, a missing master by guid is searched again
+    if (pMaster || pInfo->mapId != INVALID_MAP_ID)
+        m_linkedMasters[pSource->GetObjectGuid()] = pMaster ? pMaster->GetObjectGuid() : ObjectGuid();
+    return pMaster;
+}
+
+// Helper function, true for the first aggro of a source on an enemy in the current map update
+bool CreatureLinkingHolder::IsNewAggroEvent(Creature* pSource, Unit* pEnemy)
+{
+    std::lock_guard<std::mutex> guard(m_cacheLock);
+
+    uint32 cycle = pSource->GetMap()->GetUpdateCycle();
+    if (cycle != m_aggroCycle)
+    {
+        m_aggroCycle = cycle;
+        m_aggroEvents.clear();
+    }
+    return m_aggroEvents.insert(std::make_pair(pSource->GetObjectGuid(), pEnemy->GetObjectGuid())).second;
 }
 
 // Helper function, to process a single slave
@@ -726,24 +799,7 @@ bool CreatureLinkingHolder::TryFollowMaster(Creature* pCreature)
     if (!pInfo || !(pInfo->linkingFlag & FLAG_FOLLOW))
         return false;
 
-    Creature* pMaster = nullptr;
-    if (pInfo->mapId != INVALID_MAP_ID)                     // entry case
-    {
-        BossGuidMapBounds finds = m_masterGuid.equal_range(pInfo->masterId);
-        for (BossGuidMap::const_iterator itr = finds.first; itr != finds.second; ++itr)
-        {
-            pMaster = pCreature->GetMap()->GetCreature(itr->second);
-            if (pMaster && IsSlaveInRangeOfMaster(pCreature, pMaster, pInfo->searchRange))
-                break;
-        }
-    }
-    else                                                    // guid case
-    {
-        CreatureData const* masterData = sObjectMgr.GetCreatureData(pInfo->masterDBGuid);
-        CreatureInfo const* cInfo = ObjectMgr::GetCreatureTemplate(masterData->id);
-        pMaster = pCreature->GetMap()->GetCreature(ObjectGuid(cInfo->GetHighGuid(), cInfo->Entry, pInfo->masterDBGuid));
-    }
-
+    Creature* pMaster = GetLinkedMaster(pCreature, pInfo);
     if (pMaster && pMaster->isAlive())
     {
         SetFollowing(pCreature, pMaster);
@@ -38,6 +38,8 @@
 #include "Common.h"
 #include "Entities/ObjectGuid.h"
 
+#include <mutex>
+
 class Unit;
 class Creature;
 class Map;
@@ -144,7 +146,7 @@ class CreatureLinkingMgr
 class CreatureLinkingHolder
 {
     public:                                                 // Constructors
-        CreatureLinkingHolder() {}
+        CreatureLinkingHolder() : m_holderVersion(1), m_cacheVersion(0), m_aggroCycle(0) {}
 
     public:                                                 // Accessors
         // Function to add slave-NPCs to the holder
@@ -179,13 +181,19 @@ class CreatureLinkingHolder
             ObjectGuid linkedGuid;
         };
 
+        // Slave resolved for a source, the range check on the respawn positions is done when the list is built
+        struct LinkedSlave
+        {
+            ObjectGuid guid;
+            uint16 linkingFlag;
+        };
+        typedef std::vector<LinkedSlave> LinkedSlaveList;
+
         typedef std::multimap < uint32 /*masterEntryOrGuid*/, InfoAndGuids > HolderMap;
         typedef std::pair<HolderMap::iterator, HolderMap::iterator> HolderMapBounds;
         typedef std::multimap < uint32 /*Entry*/, ObjectGuid > BossGuidMap;
         typedef std::pair<BossGuidMap::const_iterator, BossGuidMap::const_iterator> BossGuidMapBounds;
 
-        // Helper function, to process a slave list
-        void ProcessSlaveGuidList(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, uint16 searchRange, GuidList& slaveGuidList, Unit* pEnemy);
         // Helper function, to process a single slave
         void ProcessSlave(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, Creature* pSlave, Unit* pEnemy);
         // Helper function to set following
@@ -195,6 +203,13 @@ class CreatureLinkingHolder
         bool IsSlaveInRangeOfMaster(Creature const* pBoss, float sX, float sY, uint16 searchRange) const;
         // Another helper function
         bool IsRespawnReady(uint32 dbLowGuid, Map* _map) const;
+        // Helper functions to resolve the links of a source once, until a master or slave is added to the holder
+        void ValidateCache();
+        LinkedSlaveList GetLinkedSlaves(Creature* pSource);
+        void AddLinkedSlaves(Creature* pSource, HolderMapBounds bounds, LinkedSlaveList& slaves);
+        Creature* GetLinkedMaster(Creature* pSource, CreatureLinkingInfo const* pInfo);
+        // Helper function, true for the first aggro of a source on an enemy in the current map update
+        bool IsNewAggroEvent(Creature* pSource, Unit* pEnemy);
 
         // Storage of Data (boss, flag, searchRange, GuidList) for action triggering
         HolderMap m_holderMap;
@@ -202,6 +217,16 @@ class CreatureLinkingHolder
         HolderMap m_holderGuidMap;
         // boss_entry, guid for reverse action triggering and check alive
         BossGuidMap m_masterGuid;
+
+        // Links resolved per source, dropped when m_holderVersion changes
+        uint32 m_holderVersion;
+        uint32 m_cacheVersion;
+        std::unordered_map<ObjectGuid, LinkedSlaveList> m_linkedSlaves;
+        std::unordered_map<ObjectGuid, ObjectGuid> m_linkedMasters;     // empty guid for a source without master in range
+        std::mutex m_cacheLock;                                         // the caches are shared by the cells of a parallel update
+        // source and enemy of the aggro events of the current map update
+        uint32 m_aggroCycle;
+        std::set<std::pair<ObjectGuid, ObjectGuid> > m_aggroEvents;
 };
 
 #define sCreatureLinkingMgr MaNGOS::Singleton<CreatureLinkingMgr>::Instance()
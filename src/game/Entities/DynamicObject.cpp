@@ -138,9 +138,25 @@ void DynamicObject::Update(const uint32 diff)
     // have radius and work as persistent effect
     if (m_radius)
     {
-        // TODO: make a timer and update this in larger intervals
+        // candidates come from the unit buckets of the map, overlapping areas read the same few buckets instead of
+        // visiting the cells each, and the 2d distance rejects most of them before the full target checks
+        float const x = GetPositionX();
+        float const y = GetPositionY();
+        float const radius = m_radius;
+        auto inRange = [this, x, y, radius](Unit* target)
+        {
+            float const dx = target->GetPositionX() - x;
+            float const dy = target->GetPositionY() - y;
+            float const reach = radius + GetCombinedCombatReach(target, false);
+            return dx * dx + dy * dy <= reach * reach;
+        };
+
+        std::vector<Unit*> targets;
+        GetMap()->GetUnitSpatialHash().SearchUnits(x, y, m_radius + GetCombatReach(), targets, inRange);
+
         MaNGOS::DynamicObjectUpdater notifier(*this, caster, m_positive);
-        Cell::VisitAllObjects(this, notifier, m_radius);
+        for (Unit* target : targets)
+            notifier.VisitHelper(target);
     }
 
     if (deleteThis)
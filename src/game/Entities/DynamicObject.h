@@ -23,6 +23,7 @@
 #include "Server/DBCEnums.h"
 #include "Spells/SpellTargetDefines.h"
 #include "Entities/Unit.h"
+#include "Entities/EntityPool.h"
 
 enum DynamicObjectType
 {
@@ -38,6 +39,10 @@ class DynamicObject : public WorldObject
     public:
         explicit DynamicObject();
 
+        // one is created for every area spell, the memory is recycled by EntityPool
+        void* operator new(size_t size) { return EntityPool::Allocate(ENTITY_POOL_DYNAMICOBJECT, size); }
+        void operator delete(void* block, size_t size) { EntityPool::Release(ENTITY_POOL_DYNAMICOBJECT, block, size); }
+
         void AddToWorld() override;
         void RemoveFromWorld() override;
 
@@ -91,5 +96,7 @@ class DynamicObject : public WorldObject
         int32 m_basePoints;
     private:
         GridReference<DynamicObject> m_gridRef;
+
+        TrackedMemory<MEMORY_TAG_OTHER_OBJECTS, DynamicObject> m_trackedMemory;
 };
 #endif
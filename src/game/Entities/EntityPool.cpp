@@ -0,0 +1,172 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Entities/EntityPool.h"
+
+#include <atomic>
+#include <new>
+#include <vector>
+
+namespace
+{
+    uint32 const MAX_POOLED_BLOCKS = 256;                   // per type, size and thread
+
+    struct PoolCounters
+    {
+        std::atomic<uint64> allocations;
+        std::atomic<uint64> reused;
+        std::atomic<uint64> released;
+        std::atomic<uint64> freed;
+        std::atomic<int64> pooledBytes;
+    };
+
+    PoolCounters counters[MAX_ENTITY_POOL_TYPE];
+
+    struct PoolBucket
+    {
+        EntityPoolType type;
+        size_t size;
+        std::vector<void*> blocks;
+    };
+
+    // objects deleted after the pool of their thread is destroyed, at exit, bypass it
+    thread_local bool threadPoolDestroyed = false;
+
+    struct ThreadPool
+    {
+        ~ThreadPool()
+        {
+            threadPoolDestroyed = true;
+            for (PoolBucket& bucket : buckets)
+            {
+                for (void* block : bucket.blocks)
+                    ::operator delete(block);
+                counters[bucket.type].pooledBytes -= int64(bucket.size * bucket.blocks.size());
+            }
+        }
+
+        // few sizes are ever pooled, a linear search beats hashing
+        PoolBucket& GetBucket(EntityPoolType type, size_t size)
+        {
+            for (PoolBucket& bucket : buckets)
+                if (bucket.type == type && bucket.size == size)
+                    return bucket;
+
+            buckets.push_back(PoolBucket());
+            PoolBucket& bucket = buckets.back();
+            bucket.type = type;
+            bucket.size = size;
+            bucket.blocks.reserve(MAX_POOLED_BLOCKS);
+            return bucket;
+        }
+
+        std::vector<PoolBucket> buckets;
+    };
+
+    ThreadPool& GetThreadPool()
+    {
+        static thread_local ThreadPool pool;
+        return pool;
+    }
+
+    char const* const poolTypeNames[MAX_ENTITY_POOL_TYPE] = { "tempspawn", "totem", "pet", "dynamicobject", "values" };
+}
+
+void* EntityPool::Allocate(EntityPoolType type, size_t size)
+{
+    PoolCounters& counter = counters[type];
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (!threadPoolDestroyed)
+    {
+        PoolBucket& bucket = GetThreadPool().GetBucket(type, size);
+        if (!bucket.blocks.empty())
+        {
+            void* block = bucket.blocks.back();
+            bucket.blocks.pop_back();
+            counter.reused.fetch_add(1, std::memory_order_relaxed);
+            counter.pooledBytes.fetch_sub(int64(size), std::memory_order_relaxed);
+            return block;
+        }
+    }
+
+    return ::operator new(size);
+}
+
+void EntityPool::Release(EntityPoolType type, void* block, size_t size)
+{
+    if (!block)
+        return;
+
+    PoolCounters& counter = counters[type];
+    if (!threadPoolDestroyed)
+    {
+        PoolBucket& bucket = GetThreadPool().GetBucket(type, size);
+        if (bucket.blocks.size() < MAX_POOLED_BLOCKS)
+        {
+            bucket.blocks.push_back(block);
+            counter.released.fetch_add(1, std::memory_order_relaxed);
+            counter.pooledBytes.fetch_add(int64(size), std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    counter.freed.fetch_add(1, std::memory_order_relaxed);
+    ::operator delete(block);
+}
+
+uint32* EntityPool::AllocateValues(uint16 count)
+{
+    uint32* values = static_cast<uint32*>(Allocate(ENTITY_POOL_VALUES, count * sizeof(uint32)));
+    memset(values, 0, count * sizeof(uint32));
+    return values;
+}
+
+void EntityPool::ReleaseValues(uint32* values, uint16 count)
+{
+    Release(ENTITY_POOL_VALUES, values, count * sizeof(uint32));
+}
+
+EntityPool::Stats EntityPool::GetStats(EntityPoolType type)
+{
+    PoolCounters const& counter = counters[type];
+    Stats stats;
+    stats.allocations = counter.allocations.load(std::memory_order_relaxed);
+    stats.reused = counter.reused.load(std::memory_order_relaxed);
+    stats.released = counter.released.load(std::memory_order_relaxed);
+    stats.freed = counter.freed.load(std::memory_order_relaxed);
+    stats.pooledBytes = counter.pooledBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EntityPool::ResetStats()
+{
+    // pooledBytes is the state of the free lists, not a statistic
+    for (PoolCounters& counter : counters)
+    {
+        counter.allocations = 0;
+        counter.reused = 0;
+        counter.released = 0;
+        counter.freed = 0;
+    }
+}
+
+char const* EntityPool::GetTypeName(EntityPoolType type)
+{
+    return type < MAX_ENTITY_POOL_TYPE ? poolTypeNames[type] : "unknown";
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_ENTITYPOOL_H
+#define MANGOS_ENTITYPOOL_H
+
+#include "Common.h"
+
+enum EntityPoolType
+{
+    ENTITY_POOL_TEMPSPAWN           = 0,                    // TemporarySpawn and TemporarySpawnWaypoint
+    ENTITY_POOL_TOTEM               = 1,
+    ENTITY_POOL_PET                 = 2,
+    ENTITY_POOL_DYNAMICOBJECT       = 3,
+    ENTITY_POOL_VALUES              = 4,                    // update field arrays of every object
+    MAX_ENTITY_POOL_TYPE
+};
+
+// Free lists for the memory of short lived entities, kept by every thread for the sizes it released.
+// Only the memory is recycled, an entity is still constructed anew on its block.
+// Blocks released while a free list is full go back to the heap.
+class EntityPool
+{
+    public:
+        struct Stats
+        {
+            uint64 allocations;                             // blocks handed out
+            uint64 reused;                                  // of them taken from a free list
+            uint64 released;                                // blocks put into a free list
+            uint64 freed;                                   // blocks returned to the heap
+            int64 pooledBytes;                              // memory waiting in the free lists of all threads
+        };
+
+        static void* Allocate(EntityPoolType type, size_t size);
+        static void Release(EntityPoolType type, void* block, size_t size);
+
+        // zeroed update field array
+        static uint32* AllocateValues(uint16 count);
+        static void ReleaseValues(uint32* values, uint16 count);
+
+        static Stats GetStats(EntityPoolType type);
+        static void ResetStats();
+        static char const* GetTypeName(EntityPoolType type);
+};
+
+#endif
@@ -77,6 +77,7 @@ GameObject::GameObject() : WorldObject(),
     m_valuesCount = GAMEOBJECT_END;
 
     m_respawnTime = 0;
+    m_respawnSleepTime = 0;
     m_respawnDelay = 25;
     m_respawnOverriden = false;
     m_respawnOverrideOnce = false;
@@ -109,8 +110,14 @@ void GameObject::AddToWorld()
 {
     ///- Register the gameobject for guid lookup
     if (!IsInWorld())
+    {
         GetMap()->GetObjectsStore().insert<GameObject>(GetObjectGuid(), (GameObject*)this);
 
+        // capture points tick on the players the map keeps around them, the margin covers the bounding radii of the range check
+        if (GetGoType() == GAMEOBJECT_TYPE_CAPTURE_POINT)
+            GetMap()->AddPlayerTrigger(GetObjectGuid(), GetPositionX(), GetPositionY(), GetPositionZ(), GetGOInfo()->capturePoint.radius + GetObjectBoundingRadius() + CAPTURE_POINT_TRIGGER_MARGIN);
+    }
+
     if (m_model)
         GetMap()->InsertGameObjectModel(*m_model);
 
@@ -153,6 +160,9 @@ void GameObject::RemoveFromWorld()
         if (m_model && GetMap()->ContainsGameObjectModel(*m_model))
             GetMap()->RemoveGameObjectModel(*m_model);
 
+        if (GetGoType() == GAMEOBJECT_TYPE_CAPTURE_POINT)
+            GetMap()->RemovePlayerTrigger(GetObjectGuid());
+
         GetMap()->GetObjectsStore().erase<GameObject>(GetObjectGuid(), (GameObject*)nullptr);
     }
 
@@ -334,6 +344,7 @@ void GameObject::Update(const uint32 diff)
                 if (m_respawnTime <= time(nullptr))            // timer expired
                 {
                     m_respawnTime = 0;
+                    m_respawnSleepTime = 0;
                     ClearAllUsesData();
 
                     switch (GetGoType())
@@ -378,6 +389,12 @@ void GameObject::Update(const uint32 diff)
                             break;
                     }
                 }
+                else if (m_spawnedByDefault && m_respawnSleepTime != m_respawnTime)
+                {
+                    // despawned until the respawn time, the cell updates skip the object until the map wakes it
+                    m_respawnSleepTime = m_respawnTime;
+                    GetMap()->ScheduleRespawn(GetObjectGuid(), m_respawnTime);
+                }
             }
 
             if (IsSpawned())
@@ -410,11 +427,14 @@ void GameObject::Update(const uint32 diff)
                             // Should trap trigger?
                             Unit* target = nullptr;                     // pointer to appropriate target if found any
 
+                            // the spatial hash of the map only holds units, a trap radius is far below a cell so it touches few buckets
+                            UnitSpatialHash const& spatialHash = GetMap()->GetUnitSpatialHash();
+                            float const searchRadius = radius + GetObjectBoundingRadius();
+
                             if (std::function<bool(Unit*)>* functor = sScriptDevAIMgr.OnTrapSearch(this))
                             {
                                 MaNGOS::AnyUnitFulfillingConditionInRangeCheck u_check(this, *functor, radius);
-                                MaNGOS::UnitSearcher<MaNGOS::AnyUnitFulfillingConditionInRangeCheck> checker(target, u_check);
-                                Cell::VisitAllObjects(this, checker, radius);
+                                target = spatialHash.SearchUnit(GetPositionX(), GetPositionY(), searchRadius, u_check);
                             }
                             else
                             {
@@ -423,22 +443,19 @@ void GameObject::Update(const uint32 diff)
                                     case 1: // friendly
                                     {
                                         MaNGOS::AnyFriendlyUnitInObjectRangeCheck u_check(this, nullptr, radius);
-                                        MaNGOS::UnitSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck> checker(target, u_check);
-                                        Cell::VisitAllObjects(this, checker, radius);
+                                        target = spatialHash.SearchUnit(GetPositionX(), GetPositionY(), searchRadius, u_check);
                                         break;
                                     }
                                     case 2: // all
                                     {
                                         MaNGOS::AnyUnitInObjectRangeCheck u_check(this, radius);
-                                        MaNGOS::UnitSearcher<MaNGOS::AnyUnitInObjectRangeCheck> checker(target, u_check);
-                                        Cell::VisitAllObjects(this, checker, radius);
+                                        target = spatialHash.SearchUnit(GetPositionX(), GetPositionY(), searchRadius, u_check);
                                         break;
                                     }
                                     default: // unfriendly
                                     {
                                         MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, radius);
-                                        MaNGOS::UnitSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> checker(target, u_check);
-                                        Cell::VisitAllObjects(this, checker, radius);
+                                        target = spatialHash.SearchUnit(GetPositionX(), GetPositionY(), searchRadius, u_check);
                                         break;
                                     }
                                 }
@@ -1908,6 +1925,7 @@ void GameObject::UpdateCollisionState() const
         return;
 
     m_model->enable(IsCollisionEnabled() ? true : false);
+    GetMap()->OnGameObjectModelChanged();
 }
 
 void GameObject::UpdateModel()
@@ -1998,22 +2016,44 @@ void GameObject::AddToSkillupList(Player* player)
     m_SkillupSet.insert(player->GetObjectGuid());
 }
 
-struct AddGameObjectToRemoveListInMapsWorker
+void GameObject::AddToRemoveListInMap(uint32 db_guid, GameObjectData const* data, Map* map)
 {
-    AddGameObjectToRemoveListInMapsWorker(ObjectGuid guid) : i_guid(guid) {}
+    if (GameObject* pGameobject = map->GetGameObject(ObjectGuid(HIGHGUID_GAMEOBJECT, data->id, db_guid)))
+        pGameobject->AddObjectToRemoveList();
+}
 
-    void operator()(Map* map)
+void GameObject::SpawnInMap(uint32 db_guid, GameObjectData const* data, Map* map)
+{
+    // Spawn if necessary (loaded grids only), a grid loaded after the spawn data was added already has it
+    if (map->IsLoaded(data->posX, data->posY) && !map->GetGameObject(ObjectGuid(HIGHGUID_GAMEOBJECT, data->id, db_guid)))
     {
-        if (GameObject* pGameobject = map->GetGameObject(i_guid))
-            pGameobject->AddObjectToRemoveList();
+        GameObject* pGameobject = new GameObject;
+        // DEBUG_LOG("Spawning gameobject %u", *itr);
+        if (!pGameobject->LoadFromDB(db_guid, map))
+        {
+            delete pGameobject;
+        }
+        else
+        {
+            map->Add(pGameobject);
+        }
     }
+}
 
-    ObjectGuid i_guid;
+struct AddGameObjectToRemoveListInMapsWorker
+{
+    AddGameObjectToRemoveListInMapsWorker(uint32 guid, GameObjectData const* data)
+        : i_guid(guid), i_data(data) {}
+
+    void operator()(Map* map) { GameObject::AddToRemoveListInMap(i_guid, i_data, map); }
+
+    uint32 i_guid;
+    GameObjectData const* i_data;
 };
 
 void GameObject::AddToRemoveListInMaps(uint32 db_guid, GameObjectData const* data)
 {
-    AddGameObjectToRemoveListInMapsWorker worker(ObjectGuid(HIGHGUID_GAMEOBJECT, data->id, db_guid));
+    AddGameObjectToRemoveListInMapsWorker worker(db_guid, data);
     sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
 }
 
@@ -2022,23 +2062,7 @@ struct SpawnGameObjectInMapsWorker
     SpawnGameObjectInMapsWorker(uint32 guid, GameObjectData const* data)
         : i_guid(guid), i_data(data) {}
 
-    void operator()(Map* map)
-    {
-        // Spawn if necessary (loaded grids only)
-        if (map->IsLoaded(i_data->posX, i_data->posY))
-        {
-            GameObject* pGameobject = new GameObject;
-            // DEBUG_LOG("Spawning gameobject %u", *itr);
-            if (!pGameobject->LoadFromDB(i_guid, map))
-            {
-                delete pGameobject;
-            }
-            else
-            {
-                map->Add(pGameobject);
-            }
-        }
-    }
+    void operator()(Map* map) { GameObject::SpawnInMap(i_guid, i_data, map); }
 
     uint32 i_guid;
     GameObjectData const* i_data;
@@ -2085,11 +2109,22 @@ void GameObject::TickCapturePoint()
     GameObjectInfo const* info = GetGOInfo();
     float radius = info->capturePoint.radius;
 
-    // search for players in radius
+    // players in radius, out of the ones the map tracks around the capture point
+    GuidVector triggerPlayers;
+    GetMap()->GetPlayerTriggerPlayers(GetObjectGuid(), triggerPlayers);
+
+    if (triggerPlayers.empty() && m_UniqueUsers.empty())
+    {
+        SetActiveObjectState(false);
+        return;
+    }
+
     PlayerList capturingPlayers;
     MaNGOS::AnyPlayerInCapturePointRange u_check(this, radius);
-    MaNGOS::PlayerListSearcher<MaNGOS::AnyPlayerInCapturePointRange> checker(capturingPlayers, u_check);
-    Cell::VisitWorldObjects(this, checker, radius);
+    for (ObjectGuid const& guid : triggerPlayers)
+        if (Player* player = GetMap()->GetPlayer(guid))
+            if (player->IsInWorld() && u_check(player))
+                capturingPlayers.push_back(player);
 
     GuidSet tempUsers(m_UniqueUsers);
     uint32 neutralPercent = info->capturePoint.neutralPercent;
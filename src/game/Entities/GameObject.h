@@ -632,6 +632,8 @@ enum CapturePointSliderValue
     CAPTURE_SLIDER_MIDDLE           = 50                    // middle
 };
 
+#define CAPTURE_POINT_TRIGGER_MARGIN    5.0f                // yards added to the radius of the map player trigger of a capture point
+
 enum GameobjectExtraFlags
 {
     GAMEOBJECT_EXTRA_FLAG_CUSTOM_ANIM_ON_USE = 0x00000001,    // GO that plays custom animation on usage
@@ -722,6 +724,14 @@ class GameObject : public WorldObject
                    (m_respawnTime == 0 && m_spawnedByDefault);
         }
         bool IsSpawnedByDefault() const { return m_spawnedByDefault; }
+
+        // despawned and scheduled for the current respawn time, without timers or AI that need the update meanwhile
+        bool IsSleepingUntilRespawn() const
+        {
+            return m_respawnSleepTime && m_respawnSleepTime == m_respawnTime && m_lootState == GO_READY &&
+                   !m_delayedActionTimer && !m_AI && !IsSpawned();
+        }
+        void WakeUpForRespawn(time_t scheduledTime) { if (m_respawnSleepTime == scheduledTime) m_respawnSleepTime = 0; }
         uint32 GetRespawnDelay() const { return m_respawnDelay; }
         void SetRespawnDelay(uint32 delay, bool once = false) { m_respawnDelay = delay; m_respawnOverriden = true; m_respawnOverrideOnce = once; }
         void SetForcedDespawn() { m_forcedDespawn = true; };
@@ -731,6 +741,8 @@ class GameObject : public WorldObject
         // Functions spawn/remove gameobject with DB guid in all loaded map copies (if point grid loaded in map)
         static void AddToRemoveListInMaps(uint32 db_guid, GameObjectData const* data);
         static void SpawnInMaps(uint32 db_guid, GameObjectData const* data);
+        static void AddToRemoveListInMap(uint32 db_guid, GameObjectData const* data, Map* map);
+        static void SpawnInMap(uint32 db_guid, GameObjectData const* data, Map* map);
 
         GameobjectTypes GetGoType() const { return GameobjectTypes(GetUInt32Value(GAMEOBJECT_TYPE_ID)); }
         void SetGoType(GameobjectTypes type) { SetUInt32Value(GAMEOBJECT_TYPE_ID, type); }
@@ -829,6 +841,7 @@ class GameObject : public WorldObject
 
     protected:
         uint32      m_spellId;
+        time_t      m_respawnSleepTime;                     // (secs) respawn time the map queue wakes the object at, 0 when awake
         time_t      m_respawnTime;                          // (secs) time of next respawn (or despawn if GO have owner()),
         uint32      m_respawnDelay;                     // (secs) if 0 then current GO state no dependent from timer
         bool        m_respawnOverriden;
@@ -884,6 +897,8 @@ class GameObject : public WorldObject
         void UpdateCollisionState() const;                  // updates state in Map's dynamic collision tree
 
         GridReference<GameObject> m_gridRef;
+
+        TrackedMemory<MEMORY_TAG_GAMEOBJECTS, GameObject> m_trackedMemory;
 };
 
 #endif
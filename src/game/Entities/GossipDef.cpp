@@ -22,6 +22,7 @@
 #include "Server/Opcodes.h"
 #include "WorldPacket.h"
 #include "Server/WorldSession.h"
+#include "Server/QueryResponseCache.h"
 #include "Tools/Formulas.h"
 
 GossipMenu::GossipMenu(WorldSession* session) : m_session(session)
@@ -433,7 +434,11 @@ void PlayerMenu::SendQuestGiverQuestDetails(Quest const* pQuest, ObjectGuid guid
 }
 
 // send only static data in this packet!
-void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest) const
+// position of the honor reward, the only field depending on the player
+static size_t const QUEST_QUERY_RESPONSE_HONOR_POS = 15 * sizeof(uint32);
+
+// the response without honor reward, the same for all players of the locale
+static void BuildQuestQueryResponse(WorldPacket& data, Quest const* pQuest, int loc_idx)
 {
     std::string ObjectiveText[QUEST_OBJECTIVES_COUNT];
     std::string Title = pQuest->GetTitle();
@@ -444,7 +449,6 @@ void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest) const
     for (int i = 0; i < QUEST_OBJECTIVES_COUNT; ++i)
         ObjectiveText[i] = pQuest->ObjectiveText[i];
 
-    int loc_idx = GetMenuSession()->GetSessionDbLocaleIndex();
     if (loc_idx >= 0)
     {
         if (QuestLocale const* ql = sObjectMgr.GetQuestLocale(pQuest->GetQuestId()))
@@ -464,8 +468,6 @@ void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest) const
         }
     }
 
-    WorldPacket data(SMSG_QUEST_QUERY_RESPONSE, 100);       // guess size
-
     data << uint32(pQuest->GetQuestId());                   // quest id
     data << uint32(pQuest->GetQuestMethod());               // Accepted values: 0, 1 or 2. 0==IsAutoComplete() (skip objectives/details)
     data << int32(pQuest->GetQuestLevel());                 // may be -1, static data, in other cases must be used dynamic level: Player::GetQuestLevelForPlayer (0 is not known, but assuming this is no longer valid for quest intended for client)
@@ -491,8 +493,9 @@ void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest) const
     data << uint32(pQuest->GetRewSpell());                  // reward spell, this spell will display (icon) (casted if RewSpellCast==0)
     data << uint32(pQuest->GetRewSpellCast());              // casted spell
 
-    // rewarded honor points
-    data << uint32(MaNGOS::Honor::hk_honor_at_level(GetMenuSession()->GetPlayer()->getLevel(), pQuest->GetRewHonorableKills()));
+    // rewarded honor points, set per player
+    MANGOS_ASSERT(data.wpos() == QUEST_QUERY_RESPONSE_HONOR_POS);
+    data << uint32(0);
     data << uint32(pQuest->GetSrcItemId());                 // source item id
     data << uint32(pQuest->GetQuestFlags());                // quest flags
     data << uint32(pQuest->GetCharTitleId());               // CharTitleId, new 2.4.0, player gets this title (id from CharTitles)
@@ -548,8 +551,29 @@ void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest) const
 
     for (iI = 0; iI < QUEST_OBJECTIVES_COUNT; ++iI)
         data << ObjectiveText[iI];
+}
 
-    GetMenuSession()->SendPacket(data);
+void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest) const
+{
+    int loc_idx = GetMenuSession()->GetSessionDbLocaleIndex();
+
+    QueryResponseCache::Response response = QueryResponseCache::Find(QUERY_RESPONSE_QUEST, pQuest->GetQuestId(), loc_idx);
+    if (!response)
+    {
+        WorldPacket data(SMSG_QUEST_QUERY_RESPONSE, 100);   // guess size
+        BuildQuestQueryResponse(data, pQuest, loc_idx);
+        response = QueryResponseCache::Add(QUERY_RESPONSE_QUEST, pQuest->GetQuestId(), loc_idx, data);
+    }
+
+    uint32 honor = uint32(MaNGOS::Honor::hk_honor_at_level(GetMenuSession()->GetPlayer()->getLevel(), pQuest->GetRewHonorableKills()));
+    if (!honor)
+        GetMenuSession()->SendPacket(response->GetPayload());
+    else
+    {
+        WorldPacket data(response->GetPacket());
+        data.put<uint32>(QUEST_QUERY_RESPONSE_HONOR_POS, honor);
+        GetMenuSession()->SendPacket(data);
+    }
 
     DEBUG_LOG("WORLD: Sent SMSG_QUEST_QUERY_RESPONSE questid=%u", pQuest->GetQuestId());
 }
@@ -306,12 +306,11 @@ void Item::SaveToDB()
             SqlStatement stmt = CharacterDatabase.CreateStatement(delItem, "DELETE FROM item_instance WHERE guid = ?");
             stmt.PExecute(guid);
 
-            std::ostringstream ss;
-            for (uint16 i = 0; i < m_valuesCount; ++i)
-                ss << GetUInt32Value(i) << " ";
+            std::string data;
+            SaveValues(data);
 
             stmt = CharacterDatabase.CreateStatement(insItem, "INSERT INTO item_instance (guid,owner_guid,data) VALUES (?, ?, ?)");
-            stmt.PExecute(guid, GetOwnerGuid().GetCounter(), ss.str().c_str());
+            stmt.PExecute(guid, GetOwnerGuid().GetCounter(), data.c_str());
         } break;
         case ITEM_CHANGED:
         {
@@ -320,11 +319,10 @@ void Item::SaveToDB()
 
             SqlStatement stmt = CharacterDatabase.CreateStatement(updInstance, "UPDATE item_instance SET data = ?, owner_guid = ? WHERE guid = ?");
 
-            std::ostringstream ss;
-            for (uint16 i = 0; i < m_valuesCount; ++i)
-                ss << GetUInt32Value(i) << " ";
+            std::string data;
+            SaveValues(data);
 
-            stmt.PExecute(ss.str().c_str(), GetOwnerGuid().GetCounter(), guid);
+            stmt.PExecute(data.c_str(), GetOwnerGuid().GetCounter(), guid);
 
             if (HasFlag(ITEM_FIELD_FLAGS, ITEM_DYNFLAG_WRAPPED))
             {
@@ -502,11 +500,10 @@ bool Item::LoadFromDB(uint32 guidLow, Field* fields, ObjectGuid ownerGuid)
 
         SqlStatement stmt = CharacterDatabase.CreateStatement(updItem, "UPDATE item_instance SET data = ?, owner_guid = ? WHERE guid = ?");
 
-        std::ostringstream ss;
-        for (uint16 i = 0; i < m_valuesCount; ++i)
-            ss << GetUInt32Value(i) << " ";
+        std::string data;
+        SaveValues(data);
 
-        stmt.addString(ss);
+        stmt.addString(data);
         stmt.addUInt32(GetOwnerGuid().GetCounter());
         stmt.addUInt32(guidLow);
         stmt.Execute();
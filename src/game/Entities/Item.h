@@ -373,6 +373,8 @@ class Item : public Object
         bool mb_in_trade;                                   // true if item is currently in trade-window
         ItemLootUpdateState m_lootState;
         uint32 m_enchantmentModifier; // used by one script and removed in wotlk
+
+        TrackedMemory<MEMORY_TAG_ITEMS, Item> m_trackedMemory;
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include "Common.h"
 #include "WorldPacket.h"
 #include "Server/WorldSession.h"
+#include "Server/QueryResponseCache.h"
 #include "Server/Opcodes.h"
 #include "Log.h"
 #include "Globals/ObjectMgr.h"
@@ -290,6 +291,12 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
     {
         int loc_idx = GetSessionDbLocaleIndex();
 
+        if (QueryResponseCache::Response response = QueryResponseCache::Find(QUERY_RESPONSE_ITEM, item, loc_idx))
+        {
+            SendPacket(response->GetPayload());
+            return;
+        }
+
         std::string name = pProto->Name1;
         std::string description = pProto->Description;
         sObjectMgr.GetItemLocaleStrings(pProto->ItemId, loc_idx, &name, &description);
@@ -415,7 +422,7 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
         data << int32(pProto->RequiredDisenchantSkill);
         data << float(pProto->ArmorDamageModifier);
         data << uint32(pProto->Duration);                   // added in 2.4.2.8209, duration (seconds)
-        SendPacket(data);
+        SendPacket(QueryResponseCache::Add(QUERY_RESPONSE_ITEM, item, loc_idx, data)->GetPayload());
     }
     else
     {
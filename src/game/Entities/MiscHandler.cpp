@@ -40,6 +40,7 @@
 #include "OutdoorPvP/OutdoorPvP.h"
 #include "Entities/Pet.h"
 #include "Social/SocialMgr.h"
+#include "Social/WhoListCache.h"
 
 void WorldSession::HandleRepopRequestOpcode(WorldPacket& recv_data)
 {
@@ -142,83 +143,65 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
     data << uint32(matchcount);                             // placeholder, count of players matching criteria
     data << uint32(displaycount);                           // placeholder, count of players displayed
 
-    // TODO: Guard Player map
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+    std::shared_ptr<WhoListSnapshot const> snapshot = sWhoListCache.GetSnapshot();
+
+    // zone buckets if zones are asked for, else the level range of the whole list
+    WhoListSnapshot::EntryList const& entries = snapshot->GetEntries();
+    std::pair<uint32, uint32> levelRange = snapshot->GetLevelRange(level_min, level_max);
+    std::vector<WhoListSnapshot::IndexList const*> zoneLists;
+    for (uint32 i = 0; i < zones_count; ++i)
     {
-        Player* pl = itr->second;
+        if (std::find(zoneids, zoneids + i, zoneids[i]) != zoneids + i)
+            continue;
+        if (WhoListSnapshot::IndexList const* zoneList = snapshot->GetZoneEntries(zoneids[i]))
+            zoneLists.push_back(zoneList);
+    }
 
+    auto filter = [&](WhoListEntry const& entry)
+    {
         if (security == SEC_PLAYER)
         {
             // player can see member of other team only if CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST
-            if (pl->GetTeam() != team && !allowTwoSideWhoList)
-                continue;
+            if (entry.team != uint32(team) && !allowTwoSideWhoList)
+                return;
 
             // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
-            if (pl->GetSession()->GetSecurity() > gmLevelInWhoList)
-                continue;
+            if (entry.security > uint32(gmLevelInWhoList))
+                return;
         }
 
-        // do not process players which are not in world
-        if (!pl->IsInWorld())
-            continue;
-
-        // check if target is globally visible for player
-        if (!pl->IsVisibleGloballyFor(_player))
-            continue;
-
-        // check if target's level is in level range
-        uint32 lvl = pl->getLevel();
-        if (lvl < level_min || lvl > level_max)
-            continue;
-
-        // check if class matches classmask
-        uint32 class_ = pl->getClass();
-        if (!(classmask & (1 << class_)))
-            continue;
-
-        // check if race matches racemask
-        uint32 race = pl->getRace();
-        if (!(racemask & (1 << race)))
-            continue;
-
-        uint32 pzoneid = pl->GetZoneId();
-        uint8 gender = pl->getGender();
-
-        bool z_show = true;
-        for (uint32 i = 0; i < zones_count; ++i)
+        // check if target is globally visible for player, see Player::IsVisibleGloballyFor
+        if (entry.guid != _player->GetObjectGuid() && entry.visibility != VISIBILITY_ON)
         {
-            if (zoneids[i] == pzoneid)
+            if (security > SEC_PLAYER)
             {
-                z_show = true;
-                break;
+                if (entry.security > uint32(security))
+                    return;
             }
-
-            z_show = false;
+            else if (entry.visibility == VISIBILITY_OFF)
+                return;
         }
-        if (!z_show)
-            continue;
 
-        std::string pname = pl->GetName();
-        std::wstring wpname;
-        if (!Utf8toWStr(pname, wpname))
-            continue;
-        wstrToLower(wpname);
+        // check if target's level is in level range
+        if (entry.level < level_min || entry.level > level_max)
+            return;
 
-        if (!(wplayer_name.empty() || wpname.find(wplayer_name) != std::wstring::npos))
-            continue;
+        // check if class matches classmask
+        if (!(classmask & (1 << entry.class_)))
+            return;
 
-        std::string gname = sGuildMgr.GetGuildNameById(pl->GetGuildId());
-        std::wstring wgname;
-        if (!Utf8toWStr(gname, wgname))
-            continue;
-        wstrToLower(wgname);
+        // check if race matches racemask
+        if (!(racemask & (1 << entry.race)))
+            return;
 
-        if (!(wguild_name.empty() || wgname.find(wguild_name) != std::wstring::npos))
-            continue;
+        if (!(wplayer_name.empty() || entry.wname.find(wplayer_name) != std::wstring::npos))
+            return;
+
+        if (!(wguild_name.empty() || entry.wguildName.find(wguild_name) != std::wstring::npos))
+            return;
 
         std::string aname;
-        if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(pzoneid))
+        if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(entry.zoneId))
             aname = areaEntry->area_name[GetSessionDbcLocale()];
 
         bool s_show = true;
@@ -226,8 +209,8 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
         {
             if (!str[i].empty())
             {
-                if (wgname.find(str[i]) != std::wstring::npos ||
-                        wpname.find(str[i]) != std::wstring::npos ||
+                if (entry.wguildName.find(str[i]) != std::wstring::npos ||
+                        entry.wname.find(str[i]) != std::wstring::npos ||
                         Utf8FitTo(aname, str[i]))
                 {
                     s_show = true;
@@ -237,21 +220,33 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
             }
         }
         if (!s_show)
-            continue;
+            return;
 
         // 49 is maximum player count sent to client
         if (++matchcount > 49)
-            continue;
+            return;
 
         ++displaycount;
 
-        data << pname;                                      // player name
-        data << gname;                                      // guild name
-        data << uint32(lvl);                                // player level
-        data << uint32(class_);                             // player class
-        data << uint32(race);                               // player race
-        data << uint8(gender);                              // player gender
-        data << uint32(pzoneid);                            // player zone id
+        data << entry.name;                                 // player name
+        data << entry.guildName;                            // guild name
+        data << uint32(entry.level);                        // player level
+        data << uint32(entry.class_);                       // player class
+        data << uint32(entry.race);                         // player race
+        data << uint8(entry.gender);                        // player gender
+        data << uint32(entry.zoneId);                       // player zone id
+    };
+
+    if (zones_count)
+    {
+        for (WhoListSnapshot::IndexList const* zoneList : zoneLists)
+            for (uint32 index : *zoneList)
+                filter(entries[index]);
+    }
+    else
+    {
+        for (uint32 index = levelRange.first; index < levelRange.second; ++index)
+            filter(entries[index]);
     }
 
     if (sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS) && matchcount > sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS))
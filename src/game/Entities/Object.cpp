@@ -34,7 +34,9 @@
 #include "Grids/GridNotifiers.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "Maps/ObjectPosSelector.h"
+#include "Maps/UnitSpatialHash.h"
 #include "Entities/TemporarySpawn.h"
+#include "Entities/EntityPool.h"
 #include "Movement/packet_builder.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "Chat/Chat.h"
@@ -51,6 +53,7 @@ Object::Object(): m_updateFlag(0), m_itsNewObject(false)
 
     m_inWorld           = false;
     m_objectUpdated     = false;
+    m_clientUpdateIndex = 0;
     m_loot              = nullptr;
 }
 
@@ -69,17 +72,16 @@ Object::~Object()
         MANGOS_ASSERT(false);
     }
 
-    delete[] m_uint32Values;
+    EntityPool::ReleaseValues(m_uint32Values, m_valuesCount);
 
     delete m_loot;
 }
 
 void Object::_InitValues()
 {
-    m_uint32Values = new uint32[ m_valuesCount ];
-    memset(m_uint32Values, 0, m_valuesCount * sizeof(uint32));
+    m_uint32Values = EntityPool::AllocateValues(m_valuesCount);
 
-    m_changedValues.resize(m_valuesCount, false);
+    m_changedValues.resize((m_valuesCount + 31) / 32, 0);
 
     m_objectUpdated = false;
 }
@@ -184,6 +186,9 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData* data, Player* target) c
 
 void Object::SendCreateUpdateToPlayer(Player* player) const
 {
+    if (player->GetSession()->IsBotSession())
+        return;
+
     // send create update to player
     UpdateData upd;
     WorldPacket packet;
@@ -193,18 +198,67 @@ void Object::SendCreateUpdateToPlayer(Player* player) const
     player->GetSession()->SendPacket(packet);
 }
 
-void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
+// values update blocks of one object already built in this update pass, shared by viewers of the same class
+class ValuesUpdateCache
 {
-    ByteBuffer buf(500);
+    public:
+        struct Entry
+        {
+            UpdateMask mask;
+            uint32 viewerClass;
+            ByteBuffer block;
+        };
 
-    buf << uint8(UPDATETYPE_VALUES);
-    buf << GetPackGUID();
+        Entry const* Find(UpdateMask const& mask, uint32 viewerClass) const
+        {
+            for (Entry const& entry : m_entries)
+                if (entry.viewerClass == viewerClass && entry.mask == mask)
+                    return &entry;
+            return nullptr;
+        }
+
+        void Add(UpdateMask const& mask, uint32 viewerClass, ByteBuffer const& block)
+        {
+            m_entries.push_back({ mask, viewerClass, block });
+        }
 
+    private:
+        std::vector<Entry> m_entries;
+};
+
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateCache* cache) const
+{
     UpdateMask updateMask;
     updateMask.SetCount(m_valuesCount);
 
     _SetUpdateBits(&updateMask, target);
-    BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+
+    uint32 viewerClass = 0;
+    if (cache && !GetValuesUpdateViewerClass(updateMask, target, viewerClass))
+        cache = nullptr;
+
+    if (cache)
+    {
+        if (ValuesUpdateCache::Entry const* entry = cache->Find(updateMask, viewerClass))
+        {
+            data->AddUpdateBlock(entry->block);
+            return;
+        }
+    }
+
+    ByteBuffer buf(500);
+
+    buf << uint8(UPDATETYPE_VALUES);
+    buf << GetPackGUID();
+
+    if (cache)
+    {
+        UpdateMask const viewerMask = updateMask;
+        BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+        cache->Add(viewerMask, viewerClass, buf);
+    }
+    else
+        BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
 
     data->AddUpdateBlock(buf);
 }
@@ -359,6 +413,69 @@ void Object::BuildMovementUpdate(ByteBuffer* data, uint8 updateFlags) const
     }
 }
 
+// unit stat values hidden by Fog of War
+static bool IsFogOfWarStatsField(uint16 index)
+{
+    return index == UNIT_FIELD_RANGEDATTACKTIME ||
+           index == UNIT_FIELD_MINDAMAGE || index == UNIT_FIELD_MAXDAMAGE ||
+           index == UNIT_FIELD_MINOFFHANDDAMAGE || index == UNIT_FIELD_MAXOFFHANDDAMAGE ||
+           (index >= UNIT_FIELD_STAT0 && index < UNIT_FIELD_BASE_MANA) ||
+           index == UNIT_FIELD_BASE_HEALTH || index == UNIT_FIELD_ATTACK_POWER ||
+           index == UNIT_FIELD_ATTACK_POWER_MODS || index == UNIT_FIELD_ATTACK_POWER_MULTIPLIER ||
+           index == UNIT_FIELD_RANGED_ATTACK_POWER || index == UNIT_FIELD_RANGED_ATTACK_POWER_MODS ||
+           index == UNIT_FIELD_RANGED_ATTACK_POWER_MULTIPLIER || index == UNIT_FIELD_MINRANGEDDAMAGE ||
+           index == UNIT_FIELD_MAXRANGEDDAMAGE || (index >= UNIT_FIELD_POWER_COST_MODIFIER && index <= UNIT_FIELD_MAXHEALTHMODIFIER);
+}
+
+bool Object::GetValuesUpdateViewerClass(UpdateMask const& updateMask, Player* target, uint32& viewerClass) const
+{
+    enum
+    {
+        VIEWER_CLASS_HEALTH     = 0x01,                     // sees real health values
+        VIEWER_CLASS_STATS      = 0x02,                     // sees real stat values
+        VIEWER_CLASS_GM         = 0x04,                     // sees not selectable units as selectable
+    };
+
+    viewerClass = 0;
+
+    // every index with a per target check in BuildValuesUpdate has to be handled here
+    if (isType(TYPEMASK_UNIT))
+    {
+        Unit const* unit = static_cast<Unit const*>(this);
+
+        // per caster aura state, per target npc flags, loot and tap flags, cross faction group faction
+        if (unit->HasAuraState(AURA_STATE_CONFLAGRATE) || updateMask.GetBit(UNIT_NPC_FLAGS) ||
+                updateMask.GetBit(UNIT_DYNAMIC_FLAGS) || updateMask.GetBit(UNIT_FIELD_FACTIONTEMPLATE))
+            return false;
+
+        if ((updateMask.GetBit(UNIT_FIELD_HEALTH) || updateMask.GetBit(UNIT_FIELD_MAXHEALTH)) && unit->IsFogOfWarVisibleHealth(target))
+            viewerClass |= VIEWER_CLASS_HEALTH;
+
+        if (updateMask.GetBit(UNIT_FIELD_FLAGS) && target->isGameMaster())
+            viewerClass |= VIEWER_CLASS_GM;
+
+        for (uint32 index = updateMask.GetFirstSetBit(); index < updateMask.GetCount(); index = updateMask.GetNextSetBit(index))
+        {
+            if (IsFogOfWarStatsField(index))
+            {
+                if (unit->IsFogOfWarVisibleStats(target))
+                    viewerClass |= VIEWER_CLASS_STATS;
+                break;
+            }
+        }
+        return true;
+    }
+
+    if (isType(TYPEMASK_CORPSE))
+        return !sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP) || !updateMask.GetBit(CORPSE_FIELD_BYTES_1);
+
+    // quest activation state of the target
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return static_cast<GameObject const*>(this)->IsTransport();
+
+    return true;
+}
+
 void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const
 {
     if (!target)
@@ -408,353 +525,330 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     MANGOS_ASSERT(updateMask && updateMask->GetCount() == m_valuesCount);
 
     *data << (uint8)updateMask->GetBlockCount();
-    data->append(updateMask->GetMask(), updateMask->GetLength());
+    for (uint32 block = 0; block < updateMask->GetBlockCount(); ++block)
+        *data << updateMask->GetBlock(block);
 
     // 2 specialized loops for speed optimization in non-unit case
     if (isType(TYPEMASK_UNIT))                              // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->GetFirstSetBit(); index < m_valuesCount; index = updateMask->GetNextSetBit(index))
         {
-            if (updateMask->GetBit(index))
+            if (index == UNIT_NPC_FLAGS)
             {
-                if (index == UNIT_NPC_FLAGS)
-                {
-                    uint32 appendValue = m_uint32Values[index];
+                uint32 appendValue = m_uint32Values[index];
 
-                    if (GetTypeId() == TYPEID_UNIT)
+                if (GetTypeId() == TYPEID_UNIT)
+                {
+                    if (appendValue & UNIT_NPC_FLAG_TRAINER)
                     {
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
-                        }
+                        if (!((Creature*)this)->IsTrainerOf(target, false))
+                            appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
+                    }
 
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
-                        {
-                            if (target->getClass() != CLASS_HUNTER)
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                        }
+                    if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
+                    {
+                        if (target->getClass() != CLASS_HUNTER)
+                            appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
+                    }
 
-                        if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
+                    if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
+                    {
+                        QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
+                        for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
                         {
-                            QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                            Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                            if (target->CanSeeStartQuest(pQuest))
                             {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanSeeStartQuest(pQuest))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
+                                appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                                break;
                             }
+                        }
 
-                            bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                        bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
+                        for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                        {
+                            Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                            if (target->CanRewardQuest(pQuest, false))
                             {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanRewardQuest(pQuest, false))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
+                                appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                                break;
                             }
                         }
                     }
-
-                    *data << uint32(appendValue);
                 }
-                else if (index == UNIT_FIELD_AURASTATE)
+
+                *data << uint32(appendValue);
+            }
+            else if (index == UNIT_FIELD_AURASTATE)
+            {
+                if (IsPerCasterAuraState)
                 {
-                    if (IsPerCasterAuraState)
-                    {
-                        // IsPerCasterAuraState set if related pet caster aura state set already
-                        if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
-                            *data << m_uint32Values[index];
-                        else
-                            *data << (m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1)));
-                    }
-                    else
+                    // IsPerCasterAuraState set if related pet caster aura state set already
+                    if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
                         *data << m_uint32Values[index];
+                    else
+                        *data << (m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1)));
                 }
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-                {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
-                }
+                else
+                    *data << m_uint32Values[index];
+            }
+            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+            else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
+            {
+                // convert from float to uint32 and send
+                *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+            }
 
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if ((index >= UNIT_FIELD_NEGSTAT0 && index <= UNIT_FIELD_NEGSTAT4) ||
-                         (index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
-                         (index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
-                         (index >= UNIT_FIELD_POSSTAT0 && index <= UNIT_FIELD_POSSTAT4))
-                {
-                    *data << uint32(m_floatValues[index]);
-                }
-                else if (index == UNIT_FIELD_HEALTH || index == UNIT_FIELD_MAXHEALTH)
-                {
-                    uint32 value = m_uint32Values[index];
+            // there are some float values which may be negative or can't get negative due to other checks
+            else if ((index >= UNIT_FIELD_NEGSTAT0 && index <= UNIT_FIELD_NEGSTAT4) ||
+                     (index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
+                     (index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
+                     (index >= UNIT_FIELD_POSSTAT0 && index <= UNIT_FIELD_POSSTAT4))
+            {
+                *data << uint32(m_floatValues[index]);
+            }
+            else if (index == UNIT_FIELD_HEALTH || index == UNIT_FIELD_MAXHEALTH)
+            {
+                uint32 value = m_uint32Values[index];
 
-                    // Fog of War: replace absolute health values with percentages for non-allied units according to settings
-                    if (!static_cast<const Unit*>(this)->IsFogOfWarVisibleHealth(target))
+                // Fog of War: replace absolute health values with percentages for non-allied units according to settings
+                if (!static_cast<const Unit*>(this)->IsFogOfWarVisibleHealth(target))
+                {
+                    switch (index)
                     {
-                        switch (index)
-                        {
-                            case UNIT_FIELD_HEALTH:     value = uint32(ceil((100.0 * value) / m_uint32Values[UNIT_FIELD_MAXHEALTH]));   break;
-                            case UNIT_FIELD_MAXHEALTH:  value = 100;                                                                    break;
-                        }
+                        case UNIT_FIELD_HEALTH:     value = uint32(ceil((100.0 * value) / m_uint32Values[UNIT_FIELD_MAXHEALTH]));   break;
+                        case UNIT_FIELD_MAXHEALTH:  value = 100;                                                                    break;
                     }
-
-                    *data << value;
-                }
-                // Fog of War: hide stat values for non-allied units according to settings
-                else if ((index == UNIT_FIELD_RANGEDATTACKTIME ||
-                          index == UNIT_FIELD_MINDAMAGE || index == UNIT_FIELD_MAXDAMAGE ||
-                          index == UNIT_FIELD_MINOFFHANDDAMAGE || index == UNIT_FIELD_MAXOFFHANDDAMAGE ||
-                          (index >= UNIT_FIELD_STAT0 && index < UNIT_FIELD_BASE_MANA) ||
-                          index == UNIT_FIELD_BASE_HEALTH || index == UNIT_FIELD_ATTACK_POWER ||
-                          index == UNIT_FIELD_ATTACK_POWER_MODS || index == UNIT_FIELD_ATTACK_POWER_MULTIPLIER ||
-                          index == UNIT_FIELD_RANGED_ATTACK_POWER || index == UNIT_FIELD_RANGED_ATTACK_POWER_MODS ||
-                          index == UNIT_FIELD_RANGED_ATTACK_POWER_MULTIPLIER || index == UNIT_FIELD_MINRANGEDDAMAGE ||
-                          index == UNIT_FIELD_MAXRANGEDDAMAGE || (index >= UNIT_FIELD_POWER_COST_MODIFIER && index <= UNIT_FIELD_MAXHEALTHMODIFIER)) &&
-                          !static_cast<const Unit*>(this)->IsFogOfWarVisibleStats(target))
-                {
-                    *data << uint32(0);
                 }
 
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
+                *data << value;
+            }
+            // Fog of War: hide stat values for non-allied units according to settings
+            else if (IsFogOfWarStatsField(index) && !static_cast<const Unit*>(this)->IsFogOfWarVisibleStats(target))
+            {
+                *data << uint32(0);
+            }
+
+            // Gamemasters should be always able to select units - remove not selectable flag
+            else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
+            {
+                *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
+            }
+            // Hide lootable animation for unallowed players
+            // Handle tapped flag
+            // Hide special-info for non empathy-casters,
+            else if (index == UNIT_DYNAMIC_FLAGS)
+            {
+                uint32 dynflagsValue = m_uint32Values[index];
+
+                // Checking SPELL_AURA_EMPATHY and caster
+                if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO && ((Unit*)this)->isAlive())
                 {
-                    *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
+                    bool bIsEmpathy = false;
+                    bool bIsCaster = false;
+                    Unit::AuraList const& mAuraEmpathy = ((Unit*)this)->GetAurasByType(SPELL_AURA_EMPATHY);
+                    for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
+                    {
+                        bIsEmpathy = true;              // Empathy by aura set
+                        if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
+                            bIsCaster = true;           // target is the caster of an empathy aura
+                    }
+                    if (bIsEmpathy && !bIsCaster)       // Empathy by aura, but target is not the caster
+                        dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
                 }
+
                 // Hide lootable animation for unallowed players
                 // Handle tapped flag
-                // Hide special-info for non empathy-casters,
-                else if (index == UNIT_DYNAMIC_FLAGS)
+                if (GetTypeId() == TYPEID_UNIT)
                 {
-                    uint32 dynflagsValue = m_uint32Values[index];
+                    Creature* creature = (Creature*)this;
+                    bool setTapFlags = false;
 
-                    // Checking SPELL_AURA_EMPATHY and caster
-                    if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO && ((Unit*)this)->isAlive())
+                    if (creature->isAlive())
                     {
-                        bool bIsEmpathy = false;
-                        bool bIsCaster = false;
-                        Unit::AuraList const& mAuraEmpathy = ((Unit*)this)->GetAurasByType(SPELL_AURA_EMPATHY);
-                        for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
+                        // creature is alive so, not lootable
+                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+
+                        if (creature->isInCombat())
+                        {
+                            // as creature is in combat we have to manage tap flags
+                            setTapFlags = true;
+                        }
+                        else
                         {
-                            bIsEmpathy = true;              // Empathy by aura set
-                            if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
-                                bIsCaster = true;           // target is the caster of an empathy aura
+                            // creature is not in combat so its not tapped
+                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED;
+                            //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                         }
-                        if (bIsEmpathy && !bIsCaster)       // Empathy by aura, but target is not the caster
-                            dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
                     }
-
-                    // Hide lootable animation for unallowed players
-                    // Handle tapped flag
-                    if (GetTypeId() == TYPEID_UNIT)
+                    else
                     {
-                        Creature* creature = (Creature*)this;
-                        bool setTapFlags = false;
-
-                        if (creature->isAlive())
+                        // check m_loot flag
+                        if (creature->m_loot && creature->m_loot->CanLoot(target))
                         {
-                            // creature is alive so, not lootable
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-
-                            if (creature->isInCombat())
-                            {
-                                // as creature is in combat we have to manage tap flags
-                                setTapFlags = true;
-                            }
-                            else
-                            {
-                                // creature is not in combat so its not tapped
-                                dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED;
-                                //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                            }
+                            // creature is dead and this player can loot it
+                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
+                            //sLog.outString(">> %s is lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                         }
                         else
                         {
-                            // check m_loot flag
-                            if (creature->m_loot && creature->m_loot->CanLoot(target))
-                            {
-                                // creature is dead and this player can loot it
-                                dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
-                                //sLog.outString(">> %s is lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                            }
-                            else
-                            {
-                                // creature is dead but this player cannot loot it
-                                dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                                //sLog.outString(">> %s is not lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                            }
-
-                            // as creature is died we have to manage tap flags
-                            setTapFlags = true;
+                            // creature is dead but this player cannot loot it
+                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+                            //sLog.outString(">> %s is not lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                         }
 
-                        // check tap flags
-                        if (setTapFlags)
-                        {
-                            if (creature->IsTappedBy(target))
-                            {
-                                // creature is in combat or died and tapped by this player
-                                dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED;
-                                //sLog.outString(">> %s is tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                            }
-                            else
-                            {
-                                // creature is in combat or died but not tapped by this player
-                                dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
-                                //sLog.outString(">> %s is not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                            }
-                        }
+                        // as creature is died we have to manage tap flags
+                        setTapFlags = true;
                     }
 
-                    if (GetTypeId() == TYPEID_UNIT || GetTypeId() == TYPEID_PLAYER)
+                    // check tap flags
+                    if (setTapFlags)
                     {
-                        Unit* unit = (Unit*)this; // hunters mark effects should only be visible to owners and not all players
-                        if (!unit->HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetObjectGuid()))
-                            dynflagsValue &= ~UNIT_DYNFLAG_TRACK_UNIT;
+                        if (creature->IsTappedBy(target))
+                        {
+                            // creature is in combat or died and tapped by this player
+                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED;
+                            //sLog.outString(">> %s is tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
+                        }
+                        else
+                        {
+                            // creature is in combat or died but not tapped by this player
+                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
+                            //sLog.outString(">> %s is not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
+                        }
                     }
+                }
 
-                    *data << dynflagsValue;
+                if (GetTypeId() == TYPEID_UNIT || GetTypeId() == TYPEID_PLAYER)
+                {
+                    Unit* unit = (Unit*)this; // hunters mark effects should only be visible to owners and not all players
+                    if (!unit->HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetObjectGuid()))
+                        dynflagsValue &= ~UNIT_DYNFLAG_TRACK_UNIT;
                 }
-                else if (index == UNIT_FIELD_FACTIONTEMPLATE)
+
+                *data << dynflagsValue;
+            }
+            else if (index == UNIT_FIELD_FACTIONTEMPLATE)
+            {
+                uint32 value = m_uint32Values[index];
+
+                // [XFACTION]: Alter faction if detected crossfaction group interaction when updating faction field:
+                if (this != target && GetTypeId() == TYPEID_PLAYER)
                 {
-                    uint32 value = m_uint32Values[index];
+                    Player const* thisPlayer = static_cast<Player const*>(this);
 
-                    // [XFACTION]: Alter faction if detected crossfaction group interaction when updating faction field:
-                    if (this != target && GetTypeId() == TYPEID_PLAYER)
+                    if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP) && target->IsInGroup(thisPlayer))
                     {
-                        Player const* thisPlayer = static_cast<Player const*>(this);
+                        const uint32 targetTeam = target->GetTeam();
 
-                        if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP) && target->IsInGroup(thisPlayer))
+                        if (thisPlayer->GetTeam() != targetTeam && value == Player::getFactionForRace(thisPlayer->getRace()))
                         {
-                            const uint32 targetTeam = target->GetTeam();
-
-                            if (thisPlayer->GetTeam() != targetTeam && value == Player::getFactionForRace(thisPlayer->getRace()))
+                            switch (targetTeam)
                             {
-                                switch (targetTeam)
-                                {
-                                    case ALLIANCE:  value = 1054;   break;  // "Alliance Generic"
-                                    case HORDE:     value = 1495;   break;  // "Horde Generic"
-                                }
+                                case ALLIANCE:  value = 1054;   break;  // "Alliance Generic"
+                                case HORDE:     value = 1495;   break;  // "Horde Generic"
                             }
                         }
                     }
-
-                    *data << value;
-                }
-                else                                        // Unhandled index, just send
-                {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[index];
                 }
+
+                *data << value;
+            }
+            else                                        // Unhandled index, just send
+            {
+                // send in current format (float as float, uint32 as uint32)
+                *data << m_uint32Values[index];
             }
         }
     }
     else if (isType(TYPEMASK_CORPSE))                       // corpse case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->GetFirstSetBit(); index < m_valuesCount; index = updateMask->GetNextSetBit(index))
         {
-            if (updateMask->GetBit(index))
+            if (index == CORPSE_FIELD_BYTES_1)
             {
-                if (index == CORPSE_FIELD_BYTES_1)
+                uint32 value = m_uint32Values[index];
+
+                // [XFACTION]: Alter race field if detected crossfaction group interaction:
+                if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP))
                 {
-                    uint32 value = m_uint32Values[index];
+                    Corpse const* thisCorpse = static_cast<Corpse const*>(this);
+                    ObjectGuid const& ownerGuid = thisCorpse->GetOwnerGuid();
+                    Group const* targetGroup = target->GetGroup();
 
-                    // [XFACTION]: Alter race field if detected crossfaction group interaction:
-                    if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP))
+                    if (ownerGuid != target->GetObjectGuid() && targetGroup && targetGroup->IsMember(ownerGuid))
                     {
-                        Corpse const* thisCorpse = static_cast<Corpse const*>(this);
-                        ObjectGuid const& ownerGuid = thisCorpse->GetOwnerGuid();
-                        Group const* targetGroup = target->GetGroup();
+                        const uint8 targetRace = target->getRace();
 
-                        if (ownerGuid != target->GetObjectGuid() && targetGroup && targetGroup->IsMember(ownerGuid))
-                        {
-                            const uint8 targetRace = target->getRace();
-
-                            if (Player::TeamForRace(thisCorpse->getRace()) != Player::TeamForRace(targetRace))
-                                value = ((value &~ uint32(0xFF << 8)) | (uint32(targetRace) << 8));
-                        }
+                        if (Player::TeamForRace(thisCorpse->getRace()) != Player::TeamForRace(targetRace))
+                            value = ((value &~ uint32(0xFF << 8)) | (uint32(targetRace) << 8));
                     }
-
-                    *data << value;
                 }
-                else
-                    *data << m_uint32Values[index];         // other cases
+
+                *data << value;
             }
+            else
+                *data << m_uint32Values[index];         // other cases
         }
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->GetFirstSetBit(); index < m_valuesCount; index = updateMask->GetNextSetBit(index))
         {
-            if (updateMask->GetBit(index))
+            // send in current format (float as float, uint32 as uint32)
+            if (index == GAMEOBJECT_DYN_FLAGS)
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYN_FLAGS)
-                {
-                    // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
-                    //      most likely related to "can enter map" and then should be 0 if can not enter
+                // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
+                //      most likely related to "can enter map" and then should be 0 if can not enter
 
-                    if (IsActivateToQuest)
+                if (IsActivateToQuest)
+                {
+                    GameObject const* gameObject = static_cast<GameObject const*>(this);
+                    switch (((GameObject*)this)->GetGoType())
                     {
-                        GameObject const* gameObject = static_cast<GameObject const*>(this);
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(0);
-                                break;
-                            case GAMEOBJECT_TYPE_CHEST:
-                                if (gameObject->GetLootState() == GO_READY || gameObject->GetLootState() == GO_ACTIVATED)
-                                    *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                else
-                                    *data << uint16(0);
-                                *data << uint16(0);
-                                break;
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
+                        case GAMEOBJECT_TYPE_QUESTGIVER:
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
+                            *data << uint16(0);
+                            break;
+                        case GAMEOBJECT_TYPE_CHEST:
+                            if (gameObject->GetLootState() == GO_READY || gameObject->GetLootState() == GO_ACTIVATED)
                                 *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
+                            else
                                 *data << uint16(0);
-                                break;
-                            default:
-                                *data << uint32(0);         // unknown, not happen.
-                                break;
-                        }
+                            *data << uint16(0);
+                            break;
+                        case GAMEOBJECT_TYPE_GENERIC:
+                        case GAMEOBJECT_TYPE_SPELL_FOCUS:
+                        case GAMEOBJECT_TYPE_GOOBER:
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
+                            *data << uint16(0);
+                            break;
+                        default:
+                            *data << uint32(0);         // unknown, not happen.
+                            break;
                     }
-                    else
-                        *data << uint32(0);                 // disable quest object
                 }
                 else
-                    *data << m_uint32Values[index];         // other cases
+                    *data << uint32(0);                 // disable quest object
             }
+            else
+                *data << m_uint32Values[index];         // other cases
         }
     }
     else                                                    // other objects case (no special index checks)
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateMask->GetFirstSetBit(); index < m_valuesCount; index = updateMask->GetNextSetBit(index))
         {
-            if (updateMask->GetBit(index))
-            {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[index];
-            }
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[index];
         }
     }
 }
 
 void Object::ClearUpdateMask(bool remove)
 {
-    if (m_uint32Values)
-    {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-            m_changedValues[index] = false;
-    }
+    if (!m_changedValues.empty())
+        memset(m_changedValues.data(), 0, m_changedValues.size() * sizeof(uint32));
 
     if (m_objectUpdated)
     {
@@ -768,33 +862,62 @@ bool Object::LoadValues(const char* data)
 {
     if (!m_uint32Values) _InitValues();
 
-    Tokens tokens = StrSplit(data, " ");
+    // parsed in place, items of every login and bank or mail load pass here
+    uint16 index = 0;
+    for (char const* pos = data;;)
+    {
+        while (*pos == ' ')
+            ++pos;
 
-    if (tokens.size() != m_valuesCount)
-        return false;
+        if (!*pos)
+            break;
+
+        char* end;
+        unsigned long value = strtoul(pos, &end, 10);
+        if (end == pos || index >= m_valuesCount)
+            return false;
+
+        m_uint32Values[index++] = uint32(value);
+        pos = end;
+    }
+
+    return index == m_valuesCount;
+}
 
-    Tokens::iterator iter;
-    int index;
-    for (iter = tokens.begin(), index = 0; index < m_valuesCount; ++iter, ++index)
+void Object::SaveValues(std::string& data) const
+{
+    // up to 10 digits and the separator for each value
+    data.resize(m_valuesCount * 11);
+
+    char* pos = &data[0];
+    for (uint16 i = 0; i < m_valuesCount; ++i)
     {
-        m_uint32Values[index] = std::stoul(*iter);
+        char digits[10];
+        char* digit = digits;
+        uint32 value = m_uint32Values[i];
+        do
+        {
+            *digit++ = char('0' + value % 10);
+            value /= 10;
+        }
+        while (value);
+
+        while (digit != digits)
+            *pos++ = *--digit;
+        *pos++ = ' ';
     }
 
-    return true;
+    data.resize(pos - &data[0]);
 }
 
 void Object::_SetUpdateBits(UpdateMask* updateMask, Player* /*target*/) const
 {
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (m_changedValues[index])
-            updateMask->SetBit(index);
+    updateMask->SetBlocks(m_changedValues.data());
 }
 
 void Object::_SetCreateBits(UpdateMask* updateMask, Player* /*target*/) const
 {
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (GetUInt32Value(index) != 0)
-            updateMask->SetBit(index);
+    updateMask->SetNonZeroBits(m_uint32Values);
 }
 
 void Object::SetInt32Value(uint16 index, int32 value)
@@ -804,7 +927,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     if (m_int32Values[index] != value)
     {
         m_int32Values[index] = value;
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -816,7 +939,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     if (m_uint32Values[index] != value)
     {
         m_uint32Values[index] = value;
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -828,8 +951,8 @@ void Object::SetUInt64Value(uint16 index, const uint64& value)
     {
         m_uint32Values[index] = *((uint32*)&value);
         m_uint32Values[index + 1] = *(((uint32*)&value) + 1);
-        m_changedValues[index] = true;
-        m_changedValues[index + 1] = true;
+        SetChangedValue(index);
+        SetChangedValue(index + 1);
         MarkForClientUpdate();
     }
 }
@@ -841,7 +964,7 @@ void Object::SetFloatValue(uint16 index, float value)
     if (m_floatValues[index] != value)
     {
         m_floatValues[index] = value;
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -860,7 +983,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -879,7 +1002,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -941,7 +1064,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -955,7 +1078,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -973,7 +1096,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     if (!(uint8(m_uint32Values[index] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -991,7 +1114,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     if (uint8(m_uint32Values[index] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1003,7 +1126,7 @@ void Object::SetShortFlag(uint16 index, bool highpart, uint16 newFlag)
     if (!(uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1015,7 +1138,7 @@ void Object::RemoveShortFlag(uint16 index, bool highpart, uint16 oldFlag)
     if (uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        SetChangedValue(index);
         MarkForClientUpdate();
     }
 }
@@ -1037,8 +1160,12 @@ bool Object::PrintEntryError(char const* descr) const
 }
 
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateCache* cache) const
 {
+    // bots keep their state from the objects themselves, values blocks would be built only to be dropped
+    if (pl->GetSession()->IsBotSession())
+        return;
+
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
     if (iter == update_players.end())
@@ -1048,7 +1175,7 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, cache);
 }
 
 void Object::AddToClientUpdateList()
@@ -1083,7 +1210,7 @@ void Object::MarkForClientUpdate()
 
 void Object::ForceValuesUpdateAtIndex(uint16 index)
 {
-    m_changedValues[index] = true;
+    SetChangedValue(index);
     if (m_inWorld && !m_objectUpdated)
     {
         AddToClientUpdateList();
@@ -1116,7 +1243,11 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
     m_position.o = orientation;
 
     if (isType(TYPEMASK_UNIT))
+    {
         ((Unit*)this)->m_movementInfo.ChangePosition(x, y, z, orientation);
+        if (UnitSpatialHash* spatialHash = ((Unit*)this)->GetSpatialHash())
+            spatialHash->Relocate((Unit*)this);
+    }
 }
 
 void WorldObject::Relocate(float x, float y, float z)
@@ -1126,7 +1257,11 @@ void WorldObject::Relocate(float x, float y, float z)
     m_position.z = z;
 
     if (isType(TYPEMASK_UNIT))
+    {
         ((Unit*)this)->m_movementInfo.ChangePosition(x, y, z, GetOrientation());
+        if (UnitSpatialHash* spatialHash = ((Unit*)this)->GetSpatialHash())
+            spatialHash->Relocate((Unit*)this);
+    }
 }
 
 void WorldObject::SetOrientation(float orientation)
@@ -2169,10 +2304,12 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter.getSource()->GetOwner();
             if (owner != &i_object && owner->HaveAtClient(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, &i_cache);
         }
     }
 
+    ValuesUpdateCache i_cache;
+
     template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
 };
 
@@ -21,6 +21,7 @@
 
 #include "Common.h"
 #include "ByteBuffer.h"
+#include "MemoryTracker.h"
 #include "Entities/UpdateFields.h"
 #include "Entities/UpdateData.h"
 #include "Entities/ObjectGuid.h"
@@ -125,6 +126,7 @@ class Unit;
 class Group;
 class Map;
 class UpdateMask;
+class ValuesUpdateCache;
 class InstanceData;
 class TerrainInfo;
 class TransportInfo;
@@ -398,7 +400,11 @@ class Object
         void MarkForClientUpdate();
         void SendForcedObjectUpdate();
 
-        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        // slot in the client update list of the map, only meaningful while the object is listed there
+        size_t GetClientUpdateIndex() const { return m_clientUpdateIndex; }
+        void SetClientUpdateIndex(size_t index) { m_clientUpdateIndex = index; }
+
+        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateCache* cache = nullptr) const;
         void BuildForcedValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
         void BuildMovementUpdateBlock(UpdateData* data, uint8 flags = 0) const;
@@ -581,7 +587,9 @@ class Object
 
         void ClearUpdateMask(bool remove);
 
+        // space separated decimal values as stored in item_instance.data
         bool LoadValues(const char* data);
+        void SaveValues(std::string& data) const;
 
         uint16 GetValuesCount() const { return m_valuesCount; }
 
@@ -609,7 +617,9 @@ class Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint8 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const;
+        // false when BuildValuesUpdate output for the mask depends on more of the target than the returned class
+        bool GetValuesUpdateViewerClass(UpdateMask const& updateMask, Player* target, uint32& viewerClass) const;
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateCache* cache = nullptr) const;
 
         uint16 m_objectType;
 
@@ -623,13 +633,16 @@ class Object
             float*  m_floatValues;
         };
 
-        std::vector<bool> m_changedValues;
+        void SetChangedValue(uint16 index) { m_changedValues[index >> 5] |= 1u << (index & 0x1F); }
+
+        std::vector<uint32> m_changedValues;                // changed values bitset in the block layout of UpdateMask
 
         uint16 m_valuesCount;
 
         bool m_objectUpdated;
 
     private:
+        size_t m_clientUpdateIndex;
         bool m_inWorld;
         bool m_itsNewObject;
 
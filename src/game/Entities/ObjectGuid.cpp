@@ -105,3 +105,38 @@ template uint32 ObjectGuidGenerator<HIGHGUID_PET>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_DYNAMICOBJECT>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_CORPSE>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_GROUP>::Generate();
+
+// guids leased by a thread at once, unused ones of a block are lost at shutdown
+static uint32 const GUID_BLOCK_SIZE = 64;
+
+template<HighGuid high>
+uint32 SharedObjectGuidGenerator<high>::Reserve(uint32 count)
+{
+    uint32 first = m_nextGuid.fetch_add(count);
+    if (first >= ObjectGuid::GetMaxCounter(high) - count)
+    {
+        sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", ObjectGuid::GetTypeName(high));
+        World::StopNow(ERROR_EXIT_CODE);
+    }
+    return first;
+}
+
+template<HighGuid high>
+uint32 SharedObjectGuidGenerator<high>::GenerateFromBlock()
+{
+    // the block leased by this thread is [t_next, t_end)
+    static thread_local uint32 t_next = 0;
+    static thread_local uint32 t_end = 0;
+
+    if (t_next == t_end)
+    {
+        t_next = Reserve(GUID_BLOCK_SIZE);
+        t_end = t_next + GUID_BLOCK_SIZE;
+    }
+    return t_next++;
+}
+
+template class SharedObjectGuidGenerator<HIGHGUID_ITEM>;
+template class SharedObjectGuidGenerator<HIGHGUID_PLAYER>;
+template class SharedObjectGuidGenerator<HIGHGUID_CORPSE>;
+template class SharedObjectGuidGenerator<HIGHGUID_GROUP>;
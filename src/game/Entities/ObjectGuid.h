@@ -22,6 +22,8 @@
 #include "Common.h"
 #include "ByteBuffer.h"
 
+#include <atomic>
+
 enum TypeID
 {
     TYPEID_OBJECT        = 0,
@@ -238,6 +240,29 @@ class ObjectGuidGenerator
         uint32 m_nextGuid;
 };
 
+// Generator shared by the map threads. Frequently created types lease a block of guids for the
+// calling thread and hand it out without synchronisation, the other ones take single guids.
+// The thread blocks are per guid type, so only one generator of each type may use GenerateFromBlock.
+template<HighGuid high>
+class SharedObjectGuidGenerator
+{
+    public:                                                 // constructors
+        explicit SharedObjectGuidGenerator(uint32 start = 1) : m_nextGuid(start) {}
+
+    public:                                                 // modifiers
+        void Set(uint32 val) { m_nextGuid.store(val); }
+        uint32 Generate() { return Reserve(1); }
+        uint32 GenerateFromBlock();
+
+    public:                                                 // accessors
+        uint32 GetNextAfterMaxUsed() const { return m_nextGuid.load(); }
+
+    private:
+        uint32 Reserve(uint32 count);
+
+        std::atomic<uint32> m_nextGuid;
+};
+
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid);
 ByteBuffer& operator>> (ByteBuffer& buf, ObjectGuid&       guid);
 
@@ -32,7 +32,7 @@ constexpr float VisibilityDistances[AsUnderlyingType(VisibilityDistanceType::Max
     MAX_VISIBILITY_DISTANCE
 };
 
-VisibilityData::VisibilityData(WorldObject* owner) : m_visibilityDistanceOverride(0.f), m_invisibilityMask(0), m_detectInvisibilityMask(0), m_owner(owner)
+VisibilityData::VisibilityData(WorldObject* owner) : m_visibilityDistanceOverride(0.f), m_invisibilityMask(0), m_detectInvisibilityMask(0), m_stealthMask(0), m_stealthDetectionGeneration(0), m_owner(owner)
 {
     memset(m_invisibilityValues, 0, sizeof(m_invisibilityValues));
     memset(m_invisibilityDetectValues, 0, sizeof(m_invisibilityDetectValues));
@@ -152,9 +152,23 @@ void VisibilityData::SetStealthMask(uint32 index, bool apply)
         m_stealthMask |= (1 << index);
     else
         m_stealthMask &= ~(1 << index);
+
+    m_stealthDetectionCache.clear();
 }
 
-float VisibilityData::GetStealthVisibilityDistance(Unit const* target, bool alert) const
+void VisibilityData::AddStealthDetectionStrength(StealthType type, uint32 value)
+{
+    m_stealthDetectStrength[type] += value;
+    m_stealthDetectionGeneration = ++m_stealthDetectionGenerationCounter;
+}
+
+// viewers beyond this are not worth tracking, the cache is refilled from those still looking
+#define MAX_STEALTH_DETECTION_CACHE_SIZE 128
+
+std::atomic<uint32> VisibilityData::m_stealthDetectionGenerationCounter(0);
+VisibilityData::StealthDetectionCacheStats VisibilityData::m_stealthDetectionCacheStats;
+
+int32 VisibilityData::CalculateStealthDetectionValue(Unit const* target) const
 {
     // Starting points
     int32 detectionValue = 30;
@@ -171,6 +185,44 @@ float VisibilityData::GetStealthVisibilityDistance(Unit const* target, bool aler
             detectionValue -= int32(owner->GetLevelForTarget(dynamic_cast<Unit*>(m_owner)) - 1) * 5;
 
     detectionValue -= GetStealthStrength(STEALTH_UNIT);
+    return detectionValue;
+}
+
+float VisibilityData::GetStealthVisibilityDistance(Unit const* target, bool alert) const
+{
+    int32 detectionValue;
+
+    // traps depend on their owner's level as well, they are few and not cached
+    if (m_owner->GetTypeId() == TYPEID_GAMEOBJECT)
+        detectionValue = CalculateStealthDetectionValue(target);
+    else
+    {
+        uint32 viewerGeneration = target->GetVisibilityData().m_stealthDetectionGeneration;
+        uint32 viewerLevel = target->getLevel();
+        uint32 ownerLevel = static_cast<Unit*>(m_owner)->getLevel();
+
+        auto itr = m_stealthDetectionCache.find(target->GetObjectGuid());
+        if (itr != m_stealthDetectionCache.end() && itr->second.viewerGeneration == viewerGeneration &&
+            itr->second.viewerLevel == viewerLevel && itr->second.ownerLevel == ownerLevel)
+        {
+            m_stealthDetectionCacheStats.hits.fetch_add(1, std::memory_order_relaxed);
+            detectionValue = itr->second.detectionValue;
+        }
+        else
+        {
+            m_stealthDetectionCacheStats.misses.fetch_add(1, std::memory_order_relaxed);
+            detectionValue = CalculateStealthDetectionValue(target);
+
+            if (itr == m_stealthDetectionCache.end() && m_stealthDetectionCache.size() >= MAX_STEALTH_DETECTION_CACHE_SIZE)
+                m_stealthDetectionCache.clear();
+
+            StealthDetectionEntry& entry = m_stealthDetectionCache[target->GetObjectGuid()];
+            entry.detectionValue = detectionValue;
+            entry.viewerGeneration = viewerGeneration;
+            entry.viewerLevel = viewerLevel;
+            entry.ownerLevel = ownerLevel;
+        }
+    }
 
     // Calculate max distance
     float visibilityRange = float(detectionValue) * 0.3f + target->GetCombatReach();
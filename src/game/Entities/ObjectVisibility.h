@@ -20,6 +20,10 @@
 #define __OBJECT_VISIBILITY_H
 
 #include "Common.h"
+#include "Entities/ObjectGuid.h"
+
+#include <atomic>
+#include <unordered_map>
 
 class WorldObject;
 class Unit;
@@ -75,13 +79,24 @@ class VisibilityData
         // stealth
         uint32 GetStealthMask() const { return m_stealthMask; }
         void SetStealthMask(uint32 index, bool apply);
-        void AddStealthStrength(StealthType type, uint32 value) { m_stealthStrength[type] += value; }
-        void AddStealthDetectionStrength(StealthType type, uint32 value) { m_stealthDetectStrength[type] += value; }
+        void AddStealthStrength(StealthType type, uint32 value) { m_stealthStrength[type] += value; m_stealthDetectionCache.clear(); }
+        void AddStealthDetectionStrength(StealthType type, uint32 value);
         uint32 GetStealthStrength(StealthType type) const { return m_stealthStrength[type]; }
         uint32 GetStealthDetectionStrength(StealthType type) const { return m_stealthDetectStrength[type]; }
 
         float GetStealthVisibilityDistance(Unit const* target, bool alert = false) const;
+
+        struct StealthDetectionCacheStats
+        {
+            StealthDetectionCacheStats() : hits(0), misses(0) {}
+
+            std::atomic<uint64> hits;
+            std::atomic<uint64> misses;
+        };
+        static StealthDetectionCacheStats const& GetStealthDetectionCacheStats() { return m_stealthDetectionCacheStats; }
     private:
+        int32 CalculateStealthDetectionValue(Unit const* target) const;
+
         // visibility
         float m_visibilityDistanceOverride;
         // invisibility
@@ -94,6 +109,20 @@ class VisibilityData
         uint32 m_stealthStrength[STEALTH_TYPE_MAX];
         uint32 m_stealthDetectStrength[STEALTH_TYPE_MAX];
 
+        // detection value against each viewer of a stealthed unit, dropped when our stealth changes
+        // and rechecked against the viewer's detection generation and both levels
+        struct StealthDetectionEntry
+        {
+            int32 detectionValue;
+            uint32 viewerGeneration;
+            uint32 viewerLevel;
+            uint32 ownerLevel;
+        };
+        mutable std::unordered_map<ObjectGuid, StealthDetectionEntry> m_stealthDetectionCache;
+        uint32 m_stealthDetectionGeneration;                // unique over all objects, reused guids can not match an old entry
+        static std::atomic<uint32> m_stealthDetectionGenerationCounter;
+        static StealthDetectionCacheStats m_stealthDetectionCacheStats;
+
         WorldObject* m_owner;
 };
 
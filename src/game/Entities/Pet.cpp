@@ -53,6 +53,7 @@ Pet::Pet(PetType type) :
     m_removed(false), m_happinessTimer(7500), m_loyaltyTimer(12000), m_petType(type), m_duration(0),
     m_loyaltyPoints(0), m_bonusdamage(0), m_loading(false),
     m_xpRequiredForNextLoyaltyLevel(0), m_declinedname(nullptr),
+    m_savedSlot(-1), m_savedCooldownsHash(uint64(-1)), m_savedAuras(true),
     m_petModeFlags(PET_MODE_DEFAULT), m_originalCharminfo(nullptr)
 {
     m_name = "Pet";
@@ -271,6 +272,7 @@ bool Pet::LoadPetFromDB(Player* owner, uint32 petentry /*= 0*/, uint32 petnumber
     }
 
     m_charmInfo->SetPetNumber(pet_number, isControlled());
+    m_savedSlot = int32(fields[10].GetUInt32());
 
     SetOwnerGuid(owner->GetObjectGuid());
     SetDisplayId(fields[3].GetUInt32());
@@ -482,37 +484,43 @@ void Pet::SavePetToDB(PetSaveMode mode, Player* owner)
             loyalty = GetLoyaltyLevel();
 
         uint32 ownerLow = GetOwnerGuid().GetCounter();
-        // remove current data
-        static SqlStatementID delPet ;
-        static SqlStatementID insPet ;
-
-        SqlStatement stmt = CharacterDatabase.CreateStatement(delPet, "DELETE FROM character_pet WHERE owner = ? AND id = ?");
-        stmt.PExecute(ownerLow, m_charmInfo->GetPetNumber());
+        uint32 petNumber = m_charmInfo->GetPetNumber();
 
-        // prevent duplicate using slot (except PET_SAVE_NOT_IN_SLOT)
-        if (mode <= PET_SAVE_LAST_STABLE_SLOT)
+        // the other pets only move when this one changes its slot
+        if (m_savedSlot != int32(mode))
         {
-            static SqlStatementID updPet ;
+            // prevent duplicate using slot (except PET_SAVE_NOT_IN_SLOT)
+            if (mode <= PET_SAVE_LAST_STABLE_SLOT)
+            {
+                static SqlStatementID updPet ;
 
-            stmt = CharacterDatabase.CreateStatement(updPet, "UPDATE character_pet SET slot = ? WHERE owner = ? AND slot = ?");
-            stmt.PExecute(uint32(PET_SAVE_NOT_IN_SLOT), ownerLow, uint32(mode));
-        }
+                SqlStatement stmt = CharacterDatabase.CreateStatement(updPet, "UPDATE character_pet SET slot = ? WHERE owner = ? AND slot = ?");
+                stmt.PExecute(uint32(PET_SAVE_NOT_IN_SLOT), ownerLow, uint32(mode));
+            }
 
-        // prevent existence another hunter pet in PET_SAVE_AS_CURRENT and PET_SAVE_NOT_IN_SLOT
-        if (getPetType() == HUNTER_PET && (mode == PET_SAVE_AS_CURRENT || mode > PET_SAVE_LAST_STABLE_SLOT))
-        {
-            static SqlStatementID del ;
+            // prevent existence another hunter pet in PET_SAVE_AS_CURRENT and PET_SAVE_NOT_IN_SLOT
+            if (getPetType() == HUNTER_PET && (mode == PET_SAVE_AS_CURRENT || mode > PET_SAVE_LAST_STABLE_SLOT))
+            {
+                static SqlStatementID del ;
 
-            stmt = CharacterDatabase.CreateStatement(del, "DELETE FROM character_pet WHERE owner = ? AND (slot = ? OR slot > ?)");
-            stmt.PExecute(ownerLow, uint32(PET_SAVE_AS_CURRENT), uint32(PET_SAVE_LAST_STABLE_SLOT));
+                SqlStatement stmt = CharacterDatabase.CreateStatement(del, "DELETE FROM character_pet WHERE owner = ? AND (slot = ? OR slot > ?) AND id <> ?");
+                stmt.PExecute(ownerLow, uint32(PET_SAVE_AS_CURRENT), uint32(PET_SAVE_LAST_STABLE_SLOT), petNumber);
+            }
         }
 
-        // save pet
-        SqlStatement savePet = CharacterDatabase.CreateStatement(insPet, "INSERT INTO character_pet "
-                               "( id, entry,  owner, modelid, level, exp, Reactstate, loyaltypoints, loyalty, trainpoint, slot, name, renamed, curhealth, curmana, curhappiness, abdata, TeachSpelldata, savetime, resettalents_cost, resettalents_time, CreatedBySpell, PetType, xpForNextLoyalty) "
-                               "VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        // save pet, a pet loaded from or saved to the DB before rewrites its row in place
+        static SqlStatementID insPet ;
+        static SqlStatementID updPetRow ;
+
+        SqlStatement savePet = m_savedSlot >= 0 ?
+                               CharacterDatabase.CreateStatement(updPetRow, "UPDATE character_pet SET "
+                                       "entry = ?, owner = ?, modelid = ?, level = ?, exp = ?, Reactstate = ?, loyaltypoints = ?, loyalty = ?, trainpoint = ?, slot = ?, name = ?, renamed = ?, curhealth = ?, curmana = ?, curhappiness = ?, "
+                                       "abdata = ?, TeachSpelldata = ?, savetime = ?, resettalents_cost = ?, resettalents_time = ?, CreatedBySpell = ?, PetType = ?, xpForNextLoyalty = ? "
+                                       "WHERE id = ?") :
+                               CharacterDatabase.CreateStatement(insPet, "INSERT INTO character_pet "
+                                       "( entry,  owner, modelid, level, exp, Reactstate, loyaltypoints, loyalty, trainpoint, slot, name, renamed, curhealth, curmana, curhappiness, abdata, TeachSpelldata, savetime, resettalents_cost, resettalents_time, CreatedBySpell, PetType, xpForNextLoyalty, id) "
+                                       "VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
 
-        savePet.addUInt32(m_charmInfo->GetPetNumber());
         savePet.addUInt32(GetEntry());
         savePet.addUInt32(ownerLow);
         savePet.addUInt32(GetNativeDisplayId());
@@ -559,13 +567,19 @@ void Pet::SavePetToDB(PetSaveMode mode, Player* owner)
         else
             savePet.addUInt32(0);
 
+        savePet.addUInt32(petNumber);
         savePet.Execute();
         CharacterDatabase.CommitTransaction();
+
+        m_savedSlot = int32(mode);
     }
     else
     {
         RemoveAllAuras(AURA_REMOVE_BY_DELETE);
         DeleteFromDB(m_charmInfo->GetPetNumber());
+        m_savedSlot = -1;
+        m_savedCooldownsHash = uint64(-1);
+        m_savedAuras = false;
     }
 }
 
@@ -1638,14 +1652,35 @@ void Pet::_LoadSpellCooldowns()
 
 void Pet::_SaveSpellCooldowns()
 {
+    TimePoint currTime = GetMap()->GetCurrentClockTime();
+
+    // order independent signature of what would be written, the rows only change with it
+    uint64 hash = 0;
+    for (auto& cdItr : m_cooldownMap)
+    {
+        auto& cdData = cdItr.second;
+        if (cdData->IsPermanent())
+            continue;
+
+        TimePoint sTime = currTime;
+        cdData->GetSpellCDExpireTime(sTime);
+
+        uint64 entry = uint64(cdItr.first) << 32;
+        entry ^= uint64(Clock::to_time_t(sTime)) * 0x9E3779B97F4A7C15ULL;
+        hash += entry * 0xFF51AFD7ED558CCDULL + 1;
+    }
+
+    if (hash == m_savedCooldownsHash)
+        return;
+
+    m_savedCooldownsHash = hash;
+
     static SqlStatementID delSpellCD;
     static SqlStatementID insSpellCD;
 
     SqlStatement stmt = CharacterDatabase.CreateStatement(delSpellCD, "DELETE FROM pet_spell_cooldown WHERE guid = ?");
     stmt.PExecute(m_charmInfo->GetPetNumber());
 
-    TimePoint currTime = GetMap()->GetCurrentClockTime();
-
     for (auto& cdItr : m_cooldownMap)
     {
         auto& cdData = cdItr.second;
@@ -1829,14 +1864,19 @@ void Pet::_LoadAuras(uint32 timediff)
 
 void Pet::_SaveAuras()
 {
+    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
+
+    // nothing stored and nothing to store
+    if (auraHolders.empty() && !m_savedAuras)
+        return;
+
     static SqlStatementID delAuras ;
     static SqlStatementID insAuras ;
 
     SqlStatement stmt = CharacterDatabase.CreateStatement(delAuras, "DELETE FROM pet_aura WHERE guid = ?");
     stmt.PExecute(m_charmInfo->GetPetNumber());
 
-    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
-
+    m_savedAuras = false;
     if (auraHolders.empty())
         return;
 
@@ -1906,6 +1946,8 @@ void Pet::_SaveAuras()
             stmt.addInt32(holder->GetAuraDuration());
             stmt.addUInt32(effIndexMask);
             stmt.Execute();
+
+            m_savedAuras = true;
         }
     }
 }
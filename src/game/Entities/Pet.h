@@ -23,6 +23,7 @@
 #include "Entities/ObjectGuid.h"
 #include "Entities/Creature.h"
 #include "Entities/Unit.h"
+#include "Entities/EntityPool.h"
 
 enum PetType
 {
@@ -154,6 +155,10 @@ class Pet : public Creature
         explicit Pet(PetType type = MAX_PET_TYPE);
         virtual ~Pet();
 
+        // pets and guardians are recreated on every summon, their memory is recycled by EntityPool
+        void* operator new(size_t size) { return EntityPool::Allocate(ENTITY_POOL_PET, size); }
+        void operator delete(void* block, size_t size) { EntityPool::Release(ENTITY_POOL_PET, block, size); }
+
         void AddToWorld() override;
         void RemoveFromWorld() override;
 
@@ -309,6 +314,9 @@ class Pet : public Creature
         bool    m_loading;
         uint32  m_xpRequiredForNextLoyaltyLevel;
         DeclinedName* m_declinedname;
+        int32   m_savedSlot;                                // slot of the character_pet row, -1 while the pet has none
+        uint64  m_savedCooldownsHash;                       // signature of the cooldowns last written to the DB
+        bool    m_savedAuras;                               // pet_aura may hold rows of this pet
 
     private:
         PetModeFlags m_petModeFlags;
@@ -30,6 +30,7 @@
 #include "Quests/QuestDef.h"
 #include "Entities/GossipDef.h"
 #include "Entities/UpdateData.h"
+#include "Entities/UpdateFieldFlags.h"
 #include "Chat/Channel.h"
 #include "Chat/ChannelMgr.h"
 #include "Maps/MapManager.h"
@@ -41,6 +42,9 @@
 #include "Globals/ObjectMgr.h"
 #include "Globals/ObjectAccessor.h"
 #include "Tools/Formulas.h"
+#include "Tools/CharacterWriteBehind.h"
+#include "Entities/CharEnumCache.h"
+#include "Entities/CharacterNameCache.h"
 #include "Groups/Group.h"
 #include "Guilds/Guild.h"
 #include "Guilds/GuildMgr.h"
@@ -87,10 +91,6 @@
 #define SKILL_PERM_BONUS(x)    int16(PAIR32_HIPART(x))
 #define MAKE_SKILL_BONUS(t, p) MAKE_PAIR32(t,p)
 
-#ifdef BUILD_PLAYERBOT
-extern Config botConfig;
-#endif
-
 enum CharacterFlags
 {
     CHARACTER_FLAG_NONE                 = 0x00000000,
@@ -472,6 +472,7 @@ void TradeData::SetAccepted(bool state, bool crosssend /*= false*/)
 //== Player ====================================================
 
 UpdateMask Player::updateVisualBits;
+UpdateMask Player::updateGroupVisualBits;
 
 Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(this), m_camera(this), m_reputationMgr(this)
 {
@@ -531,6 +532,7 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     // group is initialized in the reference constructor
     SetGroupInvite(nullptr);
     m_groupUpdateMask = 0;
+    m_groupUpdateTimer = 0;
 
     duel = nullptr;
 
@@ -561,11 +563,21 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     m_WeeklyQuestChanged = false;
     m_MonthlyQuestChanged = false;
 
+    m_questGiverStatusCacheExpireTime = 0;
+    m_questGiverStatusGeneration = 0;
+
+    m_conditionMemoMap = nullptr;
+    m_conditionMemoCycle = 0;
+    m_conditionMemoGeneration = 0;
+
     m_lastLiquid = nullptr;
 
     m_drunkTimer = 0;
     m_drunk = 0;
     m_restTime = 0;
+
+    m_enchantDurationElapsed = 0;
+    m_enchantDurationNextExpire = 0;
     m_deathTimer = 0;
     m_deathExpireTime = 0;
 
@@ -597,6 +609,8 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     //////////////////// Rest System/////////////////////
 
     m_mailsUpdated = false;
+    m_mailedItemsLoaded = false;
+    m_mailedItemsLoading = false;
     unReadMails = 0;
     m_nextMailDelivereTime = 0;
 
@@ -643,6 +657,8 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     m_lastFallZ = 0;
 
     m_createdInstanceClearTimer = MINUTE * IN_MILLISECONDS;
+    m_enteredInstancesChanged = false;
+    m_savedCooldownsHash = uint64(-1);
 
     m_cinematicMgr = nullptr;
 
@@ -1381,6 +1397,8 @@ void Player::Update(const uint32 diff)
     Unit::Update(diff);
     SetCanDelayTeleport(false);
 
+    m_reputationMgr.SendPendingStates();
+
     time_t now = time(nullptr);
 
     UpdatePvPFlagTimer(diff);
@@ -1506,7 +1524,7 @@ void Player::Update(const uint32 diff)
         if (diff >= m_nextSave)
         {
             // m_nextSave reseted in SaveToDB call
-            SaveToDB();
+            SaveToDB(true);
             DETAIL_LOG("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
         }
         else
@@ -1566,8 +1584,14 @@ void Player::Update(const uint32 diff)
     else
         m_createdInstanceClearTimer -= diff;
 
-    // Group update
-    SendUpdateToOutOfRangeGroupMembers();
+    // Group update, at most once per interval so health and power ticks of the interval share one packet
+    if (m_groupUpdateTimer <= diff)
+    {
+        SendUpdateToOutOfRangeGroupMembers();
+        m_groupUpdateTimer = sWorld.getConfig(CONFIG_UINT32_GROUP_UPDATE_INTERVAL);
+    }
+    else
+        m_groupUpdateTimer -= diff;
 
     Pet* pet = GetPet();
     if (pet && !pet->IsWithinDistInMap(this, GetMap()->GetVisibilityDistance()) && (GetCharmGuid() && (pet->GetObjectGuid() != GetCharmGuid())))
@@ -2038,6 +2062,10 @@ bool Player::TeleportTo(uint32 mapid, float x, float y, float z, float orientati
             // if the player is saved before worldport ack (at logout for example)
             // this will be used instead of the current location in SaveToDB
 
+            // the destination terrain is prepared while the client loads, the map is only created at the worldport ack
+            if (!m_transport)
+                sTerrainMgr.PrewarmGrid(mapid, final_x, final_y);
+
             // move packet sent by client always after far teleport
             // code for finish transfer to new map called in WorldSession::HandleMoveWorldportAckOpcode at client packet
             SetSemaphoreTeleportFar(true);
@@ -2624,6 +2652,7 @@ void Player::GiveLevel(uint32 level)
         MailDraft(mailReward->mailTemplateId).SendMailTo(this, MailSender(MAIL_CREATURE, mailReward->senderEntry));
 
     // resend quests status directly
+    InvalidateQuestStateCaches();
     SendQuestGiverStatusMultiple();
 }
 
@@ -3624,6 +3653,30 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
 
 void Player::_SaveSpellCooldowns()
 {
+    // order independent signature of what would be written, the rows only change with it
+    uint64 hash = 0;
+    for (auto& cdItr : m_cooldownMap)
+    {
+        auto& cdData = cdItr.second;
+        if (cdData->IsPermanent())
+            continue;
+
+        TimePoint sTime = TimePoint::min();
+        TimePoint cTime = TimePoint::min();
+        cdData->GetSpellCDExpireTime(sTime);
+        cdData->GetCatCDExpireTime(cTime);
+
+        uint64 entry = (uint64(cdData->GetSpellId()) << 32) ^ (uint64(cdData->GetCategory()) << 16) ^ cdData->GetItemId();
+        entry ^= uint64(Clock::to_time_t(sTime)) * 0x9E3779B97F4A7C15ULL;
+        entry ^= uint64(Clock::to_time_t(cTime)) * 0xC2B2AE3D27D4EB4FULL;
+        hash += entry * 0xFF51AFD7ED558CCDULL + 1;
+    }
+
+    if (hash == m_savedCooldownsHash)
+        return;
+
+    m_savedCooldownsHash = hash;
+
     static SqlStatementID deleteSpellCooldown;
 
     // delete all old cooldown
@@ -3756,7 +3809,7 @@ Mail* Player::GetMail(uint32 id)
     return nullptr;
 }
 
-void Player::SaveItemToInventory(Item* item)
+void Player::SaveItemToInventory(Item* item, SqlBatchInsert* inventoryInserts /*= nullptr*/)
 {
     Bag* container = item->GetContainer();
     uint32 bag_guid = container ? container->GetGUIDLow() : 0;
@@ -3769,6 +3822,16 @@ void Player::SaveItemToInventory(Item* item)
     {
         case ITEM_NEW:
         {
+            if (inventoryInserts)
+            {
+                inventoryInserts->addUInt32(GetGUIDLow());
+                inventoryInserts->addUInt32(bag_guid);
+                inventoryInserts->addUInt8(item->GetSlot());
+                inventoryInserts->addUInt32(item->GetGUIDLow());
+                inventoryInserts->addUInt32(item->GetEntry());
+                break;
+            }
+
             SqlStatement stmt = CharacterDatabase.CreateStatement(insertInventory, "INSERT INTO character_inventory (guid,bag,slot,item,item_template) VALUES (?, ?, ?, ?, ?)");
             stmt.addUInt32(GetGUIDLow());
             stmt.addUInt32(bag_guid);
@@ -3812,11 +3875,8 @@ void Player::_SetCreateBits(UpdateMask* updateMask, Player* target) const
     }
     else
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-        {
-            if (GetUInt32Value(index) != 0 && updateVisualBits.GetBit(index))
-                updateMask->SetBit(index);
-        }
+        updateMask->SetNonZeroBits(m_uint32Values);
+        *updateMask &= GetVisibleBitsFor(target);
     }
 }
 
@@ -3829,102 +3889,15 @@ void Player::_SetUpdateBits(UpdateMask* updateMask, Player* target) const
     else
     {
         Object::_SetUpdateBits(updateMask, target);
-        *updateMask &= updateVisualBits;
+        *updateMask &= GetVisibleBitsFor(target);
     }
 }
 
 void Player::InitVisibleBits()
 {
-    updateVisualBits.SetCount(PLAYER_END);
-
-    // TODO: really implement OWNER_ONLY and GROUP_ONLY. Flags can be found in UpdateFields.h
-
-    updateVisualBits.SetBit(OBJECT_FIELD_GUID);
-    updateVisualBits.SetBit(OBJECT_FIELD_TYPE);
-    updateVisualBits.SetBit(OBJECT_FIELD_SCALE_X);
-    updateVisualBits.SetBit(UNIT_FIELD_CHARM + 0);
-    updateVisualBits.SetBit(UNIT_FIELD_CHARM + 1);
-    updateVisualBits.SetBit(UNIT_FIELD_SUMMON + 0);
-    updateVisualBits.SetBit(UNIT_FIELD_SUMMON + 1);
-    updateVisualBits.SetBit(UNIT_FIELD_CHARMEDBY + 0);
-    updateVisualBits.SetBit(UNIT_FIELD_CHARMEDBY + 1);
-    updateVisualBits.SetBit(UNIT_FIELD_TARGET + 0);
-    updateVisualBits.SetBit(UNIT_FIELD_TARGET + 1);
-    updateVisualBits.SetBit(UNIT_FIELD_CHANNEL_OBJECT + 0);
-    updateVisualBits.SetBit(UNIT_FIELD_CHANNEL_OBJECT + 1);
-    updateVisualBits.SetBit(UNIT_FIELD_HEALTH);
-    updateVisualBits.SetBit(UNIT_FIELD_POWER1);
-    updateVisualBits.SetBit(UNIT_FIELD_POWER2);
-    updateVisualBits.SetBit(UNIT_FIELD_POWER3);
-    updateVisualBits.SetBit(UNIT_FIELD_POWER4);
-    updateVisualBits.SetBit(UNIT_FIELD_POWER5);
-    updateVisualBits.SetBit(UNIT_FIELD_MAXHEALTH);
-    updateVisualBits.SetBit(UNIT_FIELD_MAXPOWER1);
-    updateVisualBits.SetBit(UNIT_FIELD_MAXPOWER2);
-    updateVisualBits.SetBit(UNIT_FIELD_MAXPOWER3);
-    updateVisualBits.SetBit(UNIT_FIELD_MAXPOWER4);
-    updateVisualBits.SetBit(UNIT_FIELD_MAXPOWER5);
-    updateVisualBits.SetBit(UNIT_FIELD_LEVEL);
-    updateVisualBits.SetBit(UNIT_FIELD_FACTIONTEMPLATE);
-    updateVisualBits.SetBit(UNIT_FIELD_BYTES_0);
-    updateVisualBits.SetBit(UNIT_FIELD_FLAGS);
-    updateVisualBits.SetBit(UNIT_FIELD_FLAGS_2);
-    for (uint16 i = UNIT_FIELD_AURA; i < UNIT_FIELD_AURASTATE; ++i)
-        updateVisualBits.SetBit(i);
-    updateVisualBits.SetBit(UNIT_FIELD_AURASTATE);
-    updateVisualBits.SetBit(UNIT_FIELD_BASEATTACKTIME + 0);
-    updateVisualBits.SetBit(UNIT_FIELD_BASEATTACKTIME + 1);
-    updateVisualBits.SetBit(UNIT_FIELD_BOUNDINGRADIUS);
-    updateVisualBits.SetBit(UNIT_FIELD_COMBATREACH);
-    updateVisualBits.SetBit(UNIT_FIELD_DISPLAYID);
-    updateVisualBits.SetBit(UNIT_FIELD_NATIVEDISPLAYID);
-    updateVisualBits.SetBit(UNIT_FIELD_MOUNTDISPLAYID);
-    updateVisualBits.SetBit(UNIT_FIELD_BYTES_1);
-    updateVisualBits.SetBit(UNIT_FIELD_PETNUMBER);
-    updateVisualBits.SetBit(UNIT_FIELD_PET_NAME_TIMESTAMP);
-    updateVisualBits.SetBit(UNIT_DYNAMIC_FLAGS);
-    updateVisualBits.SetBit(UNIT_CHANNEL_SPELL);
-    updateVisualBits.SetBit(UNIT_MOD_CAST_SPEED);
-    updateVisualBits.SetBit(UNIT_FIELD_BYTES_2);
-
-    updateVisualBits.SetBit(PLAYER_DUEL_ARBITER + 0);
-    updateVisualBits.SetBit(PLAYER_DUEL_ARBITER + 1);
-    updateVisualBits.SetBit(PLAYER_FLAGS);
-    updateVisualBits.SetBit(PLAYER_GUILDID);
-    updateVisualBits.SetBit(PLAYER_GUILDRANK);
-    updateVisualBits.SetBit(PLAYER_BYTES);
-    updateVisualBits.SetBit(PLAYER_BYTES_2);
-    updateVisualBits.SetBit(PLAYER_BYTES_3);
-    updateVisualBits.SetBit(PLAYER_DUEL_TEAM);
-    updateVisualBits.SetBit(PLAYER_GUILD_TIMESTAMP);
-
-    // PLAYER_QUEST_LOG_x also visible bit on official (but only on party/raid)...
-    for (uint16 i = PLAYER_QUEST_LOG_1_1; i < PLAYER_QUEST_LOG_25_2; i += MAX_QUEST_OFFSET)
-        updateVisualBits.SetBit(i);
-
-    // Players visible items are not inventory stuff
-    //431) = 884 (0x374) = main weapon
-    for (uint16 i = 0; i < EQUIPMENT_SLOT_END; i++)
-    {
-        // item creator
-        updateVisualBits.SetBit(PLAYER_VISIBLE_ITEM_1_CREATOR + (i * MAX_VISIBLE_ITEM_OFFSET) + 0);
-        updateVisualBits.SetBit(PLAYER_VISIBLE_ITEM_1_CREATOR + (i * MAX_VISIBLE_ITEM_OFFSET) + 1);
-
-        uint16 visual_base = PLAYER_VISIBLE_ITEM_1_0 + (i * MAX_VISIBLE_ITEM_OFFSET);
-
-        // item entry
-        updateVisualBits.SetBit(visual_base + 0);
-
-        // item enchantment IDs
-        for (uint8 j = 0; j < MAX_INSPECTED_ENCHANTMENT_SLOT; ++j)
-            updateVisualBits.SetBit(visual_base + 1 + j);
-
-        // random properties
-        updateVisualBits.SetBit(PLAYER_VISIBLE_ITEM_1_PROPERTIES + 0 + (i * MAX_VISIBLE_ITEM_OFFSET));
-        updateVisualBits.SetBit(PLAYER_VISIBLE_ITEM_1_PROPERTIES + 1 + (i * MAX_VISIBLE_ITEM_OFFSET));
-    }
-
-    updateVisualBits.SetBit(PLAYER_CHOSEN_TITLE);
+    // other players see the public fields, group members also see the quest log entries
+    BuildPlayerUpdateFieldMask(updateVisualBits, UF_FLAG_PUBLIC | UF_FLAG_DYNAMIC);
+    BuildPlayerUpdateFieldMask(updateGroupVisualBits, UF_FLAG_PUBLIC | UF_FLAG_DYNAMIC | UF_FLAG_GROUP_ONLY);
 }
 
 void Player::BuildCreateUpdateBlockForPlayer(UpdateData* data, Player* target) const
@@ -4081,6 +4054,11 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
     if (accountId == 0)
         updateRealmChars = false;
 
+    if (accountId)
+        sCharEnumCache.InvalidateAccount(accountId);
+    else
+        sCharEnumCache.InvalidateCharacter(playerguid.GetCounter());
+
     uint32 charDelete_method = sWorld.getConfig(CONFIG_UINT32_CHARDELETE_METHOD);
     uint32 charDelete_minLvl = sWorld.getConfig(CONFIG_UINT32_CHARDELETE_MIN_LEVEL);
 
@@ -4278,11 +4256,13 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             CharacterDatabase.PExecute("DELETE FROM guild_eventlog WHERE PlayerGuid1 = '%u' OR PlayerGuid2 = '%u'", lowguid, lowguid);
             CharacterDatabase.PExecute("DELETE FROM guild_bank_eventlog WHERE PlayerGuid = '%u'", lowguid);
             CharacterDatabase.CommitTransaction();
+            sCharacterNameCache.Remove(lowguid);
             break;
         }
         // The character gets unlinked from the account, the name gets freed up and appears as deleted ingame
         case 1:
             CharacterDatabase.PExecute("UPDATE characters SET deleteInfos_Name=name, deleteInfos_Account=account, deleteDate='" UI64FMTD "', name='', account=0 WHERE guid=%u", uint64(time(nullptr)), lowguid);
+            sCharacterNameCache.SetName(lowguid, "");
             break;
         default:
             sLog.outError("Player::DeleteFromDB: Unsupported delete method: %u.", charDelete_method);
@@ -5551,6 +5531,8 @@ void Player::SetSkill(SkillStatusMap::iterator itr, uint16 value, uint16 max, ui
     if (status.uState == SKILL_DELETED)
         return;
 
+    InvalidateQuestStateCaches();
+
     if (value)  // Update
     {
         if (step)
@@ -5595,6 +5577,8 @@ void Player::SetSkill(uint16 id, uint16 value, uint16 max, uint16 step/* = 0*/)
         SetSkill(itr, value, max, step);
     else if (value)                                     // Add new
     {
+        InvalidateQuestStateCaches();
+
         if (!exists)
         {
             SkillLineEntry const* entry = sSkillLineStore.LookupEntry(id);
@@ -6044,16 +6028,23 @@ void Player::SendInitialActionButtons() const
 {
     DETAIL_LOG("Initializing Action Buttons for '%u'", GetGUIDLow());
 
-    WorldPacket data(SMSG_ACTION_BUTTONS, (MAX_ACTION_BUTTONS * 4));
-    for (uint8 button = 0; button < MAX_ACTION_BUTTONS; ++button)
+    // the buttons are ordered, one pass fills the slots and the rest stays empty
+    uint32 buttons[MAX_ACTION_BUTTONS] = {};
+    for (const auto& actionButton : m_actionButtons)
     {
-        ActionButtonList::const_iterator itr = m_actionButtons.find(button);
-        if (itr != m_actionButtons.end() && itr->second.uState != ACTIONBUTTON_DELETED)
-            data << uint32(itr->second.packedData);
-        else
-            data << uint32(0);
+        if (actionButton.first >= MAX_ACTION_BUTTONS)
+            break;
+
+        if (actionButton.second.uState != ACTIONBUTTON_DELETED)
+        {
+            buttons[actionButton.first] = actionButton.second.packedData;
+            EndianConvert(buttons[actionButton.first]);
+        }
     }
 
+    WorldPacket data(SMSG_ACTION_BUTTONS, sizeof(buttons));
+    data.append(buttons, MAX_ACTION_BUTTONS);
+
     GetSession()->SendPacket(data);
     DETAIL_LOG("Action Buttons for '%u' Initialized", GetGUIDLow());
 }
@@ -7147,6 +7138,8 @@ void Player::_ApplyItemBonuses(ItemPrototype const* proto, uint8 slot, bool appl
     if (slot >= INVENTORY_SLOT_BAG_END || !proto)
         return;
 
+    StatUpdateBatch statBatch(this);
+
     for (uint32 i = 0; i < MAX_ITEM_PROTO_STATS; ++i)
     {
         float val = float(proto->ItemStat[i].ItemStatValue);
@@ -7997,7 +7990,8 @@ void Player::SendInitWorldStates(uint32 zoneid, uint32 areaid) const
 
     uint32 count = 0;                                       // count of world states in packet
 
-    WorldPacket data(SMSG_INIT_WORLD_STATES, (4 + 4 + 4 + 2 + 8 * 8)); // guess
+    // guess, outdoor pvp zones and battlegrounds send 15-30 states, one allocation covers most of them
+    WorldPacket data(SMSG_INIT_WORLD_STATES, (4 + 4 + 4 + 2 + 8 * 32));
     data << uint32(mapid);                                  // mapid
     data << uint32(zoneid);                                 // zone id
     data << uint32(areaid);                                 // area id, new 2.1.0
@@ -8457,26 +8451,59 @@ InventoryResult Player::CanUnequipItems(uint32 item, uint32 count) const
     return res;
 }
 
-uint32 Player::GetItemCount(uint32 item, bool inBankAlso, Item* skipItem) const
+void Player::AddItemToEntryIndex(Item* pItem)
 {
-    uint32 count = 0;
-    for (int i = EQUIPMENT_SLOT_START; i < INVENTORY_SLOT_ITEM_END; ++i)
+    m_itemsByEntry.emplace(pItem->GetEntry(), pItem);
+
+    // an equipped bag brings its content along
+    if (pItem->IsBag())
     {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem != skipItem &&  pItem->GetEntry() == item)
-            count += pItem->GetCount();
+        Bag* pBag = (Bag*)pItem;
+        for (uint32 i = 0; i < pBag->GetBagSize(); ++i)
+            if (Item* bagItem = pBag->GetItemByPos(i))
+                AddItemToEntryIndex(bagItem);
     }
-    for (int i = KEYRING_SLOT_START; i < KEYRING_SLOT_END; ++i)
+}
+
+void Player::RemoveItemFromEntryIndex(Item* pItem)
+{
+    auto bounds = m_itemsByEntry.equal_range(pItem->GetEntry());
+    for (auto itr = bounds.first; itr != bounds.second; ++itr)
     {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem != skipItem && pItem->GetEntry() == item)
-            count += pItem->GetCount();
+        if (itr->second == pItem)
+        {
+            m_itemsByEntry.erase(itr);
+            break;
+        }
     }
-    for (int i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_END; ++i)
+
+    if (pItem->IsBag())
     {
-        Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pBag)
-            count += pBag->GetItemCount(item, skipItem);
+        Bag* pBag = (Bag*)pItem;
+        for (uint32 i = 0; i < pBag->GetBagSize(); ++i)
+            if (Item* bagItem = pBag->GetItemByPos(i))
+                RemoveItemFromEntryIndex(bagItem);
+    }
+}
+
+// same positions as the former slot scans: the bags placed in the bank bag slots themselves are never counted
+bool Player::IsCountedItemPos(uint8 bag, uint8 slot, bool inBankAlso)
+{
+    if (!IsBankPos(bag, slot))
+        return true;
+
+    return inBankAlso && !(bag == INVENTORY_SLOT_BAG_0 && slot >= BANK_SLOT_BAG_START && slot < BANK_SLOT_BAG_END);
+}
+
+uint32 Player::GetItemCount(uint32 item, bool inBankAlso, Item* skipItem) const
+{
+    uint32 count = 0;
+    auto bounds = m_itemsByEntry.equal_range(item);
+    for (auto itr = bounds.first; itr != bounds.second; ++itr)
+    {
+        Item* pItem = itr->second;
+        if (pItem != skipItem && IsCountedItemPos(pItem->GetBagSlot(), pItem->GetSlot(), inBankAlso))
+            count += pItem->GetCount();
     }
 
     if (skipItem && skipItem->GetProto()->GemProperties)
@@ -8487,24 +8514,8 @@ uint32 Player::GetItemCount(uint32 item, bool inBankAlso, Item* skipItem) const
             if (pItem && pItem != skipItem && pItem->GetProto()->Socket[0].Color)
                 count += pItem->GetGemCountWithID(item);
         }
-    }
-
-    if (inBankAlso)
-    {
-        for (int i = BANK_SLOT_ITEM_START; i < BANK_SLOT_ITEM_END; ++i)
-        {
-            Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-            if (pItem && pItem != skipItem && pItem->GetEntry() == item)
-                count += pItem->GetCount();
-        }
-        for (int i = BANK_SLOT_BAG_START; i < BANK_SLOT_BAG_END; ++i)
-        {
-            Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-            if (pBag)
-                count += pBag->GetItemCount(item, skipItem);
-        }
 
-        if (skipItem && skipItem->GetProto()->GemProperties)
+        if (inBankAlso)
         {
             for (int i = BANK_SLOT_ITEM_START; i < BANK_SLOT_ITEM_END; ++i)
             {
@@ -8752,72 +8763,17 @@ bool Player::IsValidPos(uint8 bag, uint8 slot, bool explicit_pos) const
 bool Player::HasItemCount(uint32 item, uint32 count, bool inBankAlso) const
 {
     uint32 tempcount = 0;
-    for (int i = EQUIPMENT_SLOT_START; i < INVENTORY_SLOT_ITEM_END; ++i)
-    {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-        {
-            tempcount += pItem->GetCount();
-            if (tempcount >= count)
-                return true;
-        }
-    }
-    for (int i = KEYRING_SLOT_START; i < KEYRING_SLOT_END; ++i)
+    auto bounds = m_itemsByEntry.equal_range(item);
+    for (auto itr = bounds.first; itr != bounds.second; ++itr)
     {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
+        Item* pItem = itr->second;
+        if (!pItem->IsInTrade() && IsCountedItemPos(pItem->GetBagSlot(), pItem->GetSlot(), inBankAlso))
         {
             tempcount += pItem->GetCount();
             if (tempcount >= count)
                 return true;
         }
     }
-    for (int i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_END; ++i)
-    {
-        if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-        {
-            for (uint32 j = 0; j < pBag->GetBagSize(); ++j)
-            {
-                Item* pItem = GetItemByPos(i, j);
-                if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-                {
-                    tempcount += pItem->GetCount();
-                    if (tempcount >= count)
-                        return true;
-                }
-            }
-        }
-    }
-
-    if (inBankAlso)
-    {
-        for (int i = BANK_SLOT_ITEM_START; i < BANK_SLOT_ITEM_END; ++i)
-        {
-            Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-            if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-            {
-                tempcount += pItem->GetCount();
-                if (tempcount >= count)
-                    return true;
-            }
-        }
-        for (int i = BANK_SLOT_BAG_START; i < BANK_SLOT_BAG_END; ++i)
-        {
-            if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            {
-                for (uint32 j = 0; j < pBag->GetBagSize(); ++j)
-                {
-                    Item* pItem = GetItemByPos(i, j);
-                    if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-                    {
-                        tempcount += pItem->GetCount();
-                        if (tempcount >= count)
-                            return true;
-                    }
-                }
-            }
-        }
-    }
 
     return false;
 }
@@ -10279,6 +10235,7 @@ Item* Player::_StoreItem(uint16 pos, Item* pItem, uint32 count, bool clone, bool
 
             pItem->SetSlot(slot);
             pItem->SetContainer(nullptr);
+            AddItemToEntryIndex(pItem);
 
             if (IsInWorld() && update)
             {
@@ -10291,6 +10248,7 @@ Item* Player::_StoreItem(uint16 pos, Item* pItem, uint32 count, bool clone, bool
         else if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, bag))
         {
             pBag->StoreItem(slot, pItem);
+            AddItemToEntryIndex(pItem);
             if (IsInWorld() && update)
             {
                 pItem->AddToWorld();
@@ -10509,6 +10467,7 @@ void Player::VisualizeItem(uint8 slot, Item* pItem)
     pItem->SetGuidValue(ITEM_FIELD_OWNER, GetObjectGuid());
     pItem->SetSlot(slot);
     pItem->SetContainer(nullptr);
+    AddItemToEntryIndex(pItem);
 
     if (slot < EQUIPMENT_SLOT_END)
         SetVisibleItemSlot(slot, pItem);
@@ -10580,6 +10539,7 @@ void Player::RemoveItem(uint8 bag, uint8 slot, bool update)
             if (pBag)
                 pBag->RemoveItem(slot);
         }
+        RemoveItemFromEntryIndex(pItem);
         pItem->SetGuidValue(ITEM_FIELD_CONTAINED, ObjectGuid());
         // pItem->SetGuidValue(ITEM_FIELD_OWNER, ObjectGuid()); not clear owner at remove (it will be set at store). This used in mail and auction code
         pItem->SetSlot(NULL_SLOT);
@@ -10701,6 +10661,7 @@ void Player::DestroyItem(uint8 bag, uint8 slot, bool update)
         }
         else if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, bag))
             pBag->RemoveItem(slot);
+        RemoveItemFromEntryIndex(pItem);
 
         if (IsInWorld() && update)
         {
@@ -11553,6 +11514,17 @@ void Player::UpdateItemDuration(uint32 time, bool realtimeonly)
 
 void Player::UpdateEnchantTime(uint32 time)
 {
+    if (m_enchantDuration.empty())
+        return;
+
+    m_enchantDurationElapsed += time;
+    if (m_enchantDurationElapsed < m_enchantDurationNextExpire)
+        return;
+
+    time = m_enchantDurationElapsed;
+    m_enchantDurationElapsed = 0;
+    m_enchantDurationNextExpire = std::numeric_limits<uint32>::max();
+
     for (EnchantDurationList::iterator itr = m_enchantDuration.begin(), next; itr != m_enchantDuration.end(); itr = next)
     {
         MANGOS_ASSERT(itr->item);
@@ -11570,11 +11542,25 @@ void Player::UpdateEnchantTime(uint32 time)
         else if (itr->leftduration > time)
         {
             itr->leftduration -= time;
+            m_enchantDurationNextExpire = std::min(m_enchantDurationNextExpire, itr->leftduration);
             ++next;
         }
     }
 }
 
+// brings leftduration up to date for readers, nothing expires here as the elapsed time is below every leftduration
+void Player::ApplyEnchantDurationElapsed()
+{
+    if (!m_enchantDurationElapsed)
+        return;
+
+    for (auto& enchantDuration : m_enchantDuration)
+        enchantDuration.leftduration -= std::min(enchantDuration.leftduration, m_enchantDurationElapsed);
+
+    m_enchantDurationNextExpire -= std::min(m_enchantDurationNextExpire, m_enchantDurationElapsed);
+    m_enchantDurationElapsed = 0;
+}
+
 void Player::AddEnchantmentDurations(Item* item)
 {
     for (int x = 0; x < MAX_ENCHANTMENT_SLOT; ++x)
@@ -11590,6 +11576,8 @@ void Player::AddEnchantmentDurations(Item* item)
 
 void Player::RemoveEnchantmentDurations(Item* item)
 {
+    ApplyEnchantDurationElapsed();
+
     for (EnchantDurationList::iterator itr = m_enchantDuration.begin(); itr != m_enchantDuration.end();)
     {
         if (itr->item == item)
@@ -11651,6 +11639,8 @@ void Player::AddEnchantmentDuration(Item* item, EnchantmentSlot slot, uint32 dur
     if (slot >= MAX_ENCHANTMENT_SLOT)
         return;
 
+    ApplyEnchantDurationElapsed();
+
     for (EnchantDurationList::iterator itr = m_enchantDuration.begin(); itr != m_enchantDuration.end(); ++itr)
     {
         if (itr->item == item && itr->slot == slot)
@@ -11663,6 +11653,7 @@ void Player::AddEnchantmentDuration(Item* item, EnchantmentSlot slot, uint32 dur
     if (item && duration > 0)
     {
         GetSession()->SendItemEnchantTimeUpdate(GetObjectGuid(), item->GetObjectGuid(), slot, uint32(duration / 1000));
+        m_enchantDurationNextExpire = m_enchantDuration.empty() ? duration : std::min(m_enchantDurationNextExpire, duration);
         m_enchantDuration.push_back(EnchantDuration(item, slot, duration));
     }
 }
@@ -11999,6 +11990,8 @@ void Player::ApplyEnchantment(Item* item, EnchantmentSlot slot, bool apply, bool
 
 void Player::SendEnchantmentDurations()
 {
+    ApplyEnchantDurationElapsed();
+
     for (EnchantDurationList::const_iterator itr = m_enchantDuration.begin(); itr != m_enchantDuration.end(); ++itr)
     {
         GetSession()->SendItemEnchantTimeUpdate(GetObjectGuid(), itr->item->GetObjectGuid(), itr->slot, uint32(itr->leftduration) / 1000);
@@ -12145,18 +12138,18 @@ void Player::PrepareGossipMenu(WorldObject* pSource, uint32 menuId)
                 case GOSSIP_OPTION_BOT:
                 {
 #ifdef BUILD_PLAYERBOT
-                    if (botConfig.GetBoolDefault("PlayerbotAI.DisableBots", false) && !pCreature->isInnkeeper())
+                    PlayerbotMgr::Settings const& botSettings = PlayerbotMgr::GetSettings();
+                    if (botSettings.disableBots && !pCreature->isInnkeeper())
                     {
                         ChatHandler(this).PSendSysMessage("|cffff0000Playerbot system is currently disabled!");
                         hasMenuItem = false;
                         break;
                     }
 
-                    int32 cost = botConfig.GetIntDefault("PlayerbotAI.BotguyCost", 0);
+                    int32 cost = botSettings.botguyCost;
                     if (cost >= 0)
                     {
-                        std::string reqQuestIds = botConfig.GetStringDefault("PlayerbotAI.BotguyQuests", "");
-                        if ((reqQuestIds == "" || requiredQuests(reqQuestIds.c_str())) && !pCreature->isInnkeeper() && this->GetMoney() >= (uint32)cost)
+                        if ((botSettings.botguyQuests.empty() || requiredQuests(botSettings.botguyQuests)) && !pCreature->isInnkeeper() && this->GetMoney() >= (uint32)cost)
                             pCreature->LoadBotMenu(this);
                     }
 #endif
@@ -12425,7 +12418,7 @@ void Player::OnGossipSelect(WorldObject* pSource, uint32 gossipListId, uint32 me
             // DEBUG_LOG("GOSSIP_OPTION_BOT");
             PlayerTalkClass->CloseGossip();
             uint32 guidlo = PlayerTalkClass->GossipOptionSender(gossipListId);
-            int32 cost = botConfig.GetIntDefault("PlayerbotAI.BotguyCost", 0);
+            int32 cost = PlayerbotMgr::GetSettings().botguyCost;
 
             if (!GetPlayerbotMgr())
                 SetPlayerbotMgr(new PlayerbotMgr(this));
@@ -12440,7 +12433,7 @@ void Player::OnGossipSelect(WorldObject* pSource, uint32 gossipListId, uint32 me
                 if (resultchar)
                 {
                     Field* fields = resultchar->Fetch();
-                    int maxnum = botConfig.GetIntDefault("PlayerbotAI.MaxNumBots", 9);
+                    int maxnum = PlayerbotMgr::GetSettings().maxNumBots;
                     int acctcharcount = fields[0].GetUInt32();
                     if (!(m_session->GetSecurity() > SEC_PLAYER))
                         if (acctcharcount > maxnum)
@@ -12456,7 +12449,7 @@ void Player::OnGossipSelect(WorldObject* pSource, uint32 gossipListId, uint32 me
                 if (resultlvl)
                 {
                     Field* fields = resultlvl->Fetch();
-                    int maxlvl = botConfig.GetIntDefault("PlayerbotAI.RestrictBotLevel", 80);
+                    int maxlvl = PlayerbotMgr::GetSettings().restrictBotLevel;
                     int charlvl = fields[0].GetUInt32();
                     if (!(m_session->GetSecurity() > SEC_PLAYER))
                         if (charlvl > maxlvl)
@@ -13322,7 +13315,8 @@ void Player::RewardQuest(Quest const* pQuest, uint32 reward, Object* questGiver,
     for (SpellAreaForAreaMap::const_iterator itr = saBounds.first; itr != saBounds.second; ++itr)
         itr->second->ApplyOrRemoveSpellIfCan(this, zone, area, false);
 
-    // resend quests status directly
+    // resend quests status directly, the rewarded flag is set after the status change dropped the cache
+    InvalidateQuestStateCaches();
     SendQuestGiverStatusMultiple();
 }
 
@@ -14088,18 +14082,25 @@ void Player::KilledMonsterCredit(uint32 entry, ObjectGuid guid)
 {
     uint32 addkillcount = 1;
 
-    for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
+    // only the quests with a kill objective for this entry, most kills have none
+    QuestRelationsMapBounds bounds = sObjectMgr.GetQuestKillCreditMapBounds(entry);
+    for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
     {
-        uint32 questid = GetQuestSlotQuestId(i);
-        if (!questid)
+        uint32 questid = itr->second;
+
+        QuestStatusMap::iterator statusItr = mQuestStatus.find(questid);
+        if (statusItr == mQuestStatus.end() || statusItr->second.m_status != QUEST_STATUS_INCOMPLETE)
+            continue;
+
+        if (FindQuestSlot(questid) >= MAX_QUEST_LOG_SIZE)
             continue;
 
         Quest const* qInfo = sObjectMgr.GetQuestTemplate(questid);
         if (!qInfo)
             continue;
         // just if !ingroup || !noraidgroup || raidgroup
-        QuestStatusData& q_status = mQuestStatus[questid];
-        if (q_status.m_status == QUEST_STATUS_INCOMPLETE && (!GetGroup() || !GetGroup()->isRaidGroup() || qInfo->IsAllowedInRaid()))
+        QuestStatusData& q_status = statusItr->second;
+        if (!GetGroup() || !GetGroup()->isRaidGroup() || qInfo->IsAllowedInRaid())
         {
             if (qInfo->HasSpecialFlag(QUEST_SPECIAL_FLAG_KILL_OR_CAST))
             {
@@ -14305,6 +14306,9 @@ enum TitleFactions
 
 void Player::ReputationChanged(FactionEntry const* factionEntry)
 {
+    InvalidateQuestStateCaches();
+
+
     ReputationMgr const& repMgr = GetReputationMgr();
     for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
     {
@@ -14566,6 +14570,65 @@ void Player::SendQuestUpdateAddCreatureOrGo(Quest const* pQuest, ObjectGuid guid
         SetQuestSlotCounter(slot, uint8(creatureOrGO_idx), uint8(count));
 }
 
+std::atomic<uint32> Player::s_questGiverStatusGeneration(0);
+
+uint32 Player::GetQuestGiverDialogStatus(Object const* questgiver) const
+{
+    uint32 const lifetime = sWorld.getConfig(CONFIG_UINT32_QUEST_GIVER_STATUS_CACHE_LIFETIME);
+    if (!lifetime)
+        return GetSession()->getDialogStatus(this, questgiver, DIALOG_STATUS_NONE);
+
+    time_t const now = sWorld.GetGameTime();
+    uint32 const generation = s_questGiverStatusGeneration.load(std::memory_order_relaxed);
+    if (m_questGiverStatusCacheExpireTime <= now || m_questGiverStatusGeneration != generation)
+    {
+        m_questGiverStatusCache.clear();
+        m_questGiverStatusCacheExpireTime = now + lifetime;
+        m_questGiverStatusGeneration = generation;
+    }
+
+    // the status only depends on the quests related to the entry, all spawns of it share it
+    uint64 const key = (uint64(questgiver->GetTypeId()) << 32) | questgiver->GetEntry();
+    auto itr = m_questGiverStatusCache.find(key);
+    if (itr != m_questGiverStatusCache.end())
+        return itr->second;
+
+    uint32 dialogStatus = GetSession()->getDialogStatus(this, questgiver, DIALOG_STATUS_NONE);
+    m_questGiverStatusCache[key] = uint8(dialogStatus);
+    return dialogStatus;
+}
+
+bool Player::GetConditionMemo(uint32 key, bool& result) const
+{
+    if (!IsInWorld())
+        return false;
+
+    Map const* map = GetMap();
+    uint32 const generation = s_questGiverStatusGeneration.load(std::memory_order_relaxed);
+    if (m_conditionMemoMap != map || m_conditionMemoCycle != map->GetUpdateCycle() || m_conditionMemoGeneration != generation)
+    {
+        m_conditionMemo.clear();
+        m_conditionMemoMap = map;
+        m_conditionMemoCycle = map->GetUpdateCycle();
+        m_conditionMemoGeneration = generation;
+        return false;
+    }
+
+    auto itr = m_conditionMemo.find(key);
+    if (itr == m_conditionMemo.end())
+        return false;
+
+    result = itr->second;
+    return true;
+}
+
+void Player::SetConditionMemo(uint32 key, bool result) const
+{
+    // GetConditionMemo started the memo of the current cycle
+    if (IsInWorld() && m_conditionMemoMap == GetMap())
+        m_conditionMemo[key] = result;
+}
+
 void Player::SendQuestGiverStatusMultiple() const
 {
     uint32 count = 0;
@@ -14589,7 +14652,7 @@ void Player::SendQuestGiverStatusMultiple() const
             uint8 dialogStatus = sScriptDevAIMgr.GetDialogStatus(this, questgiver);
 
             if (dialogStatus == DIALOG_STATUS_UNDEFINED)
-                dialogStatus = GetSession()->getDialogStatus(this, questgiver, DIALOG_STATUS_NONE);
+                dialogStatus = GetQuestGiverDialogStatus(questgiver);
 
             data << questgiver->GetObjectGuid();
             data << uint8(dialogStatus);
@@ -14608,7 +14671,7 @@ void Player::SendQuestGiverStatusMultiple() const
             uint8 dialogStatus = sScriptDevAIMgr.GetDialogStatus(this, questgiver);
 
             if (dialogStatus == DIALOG_STATUS_UNDEFINED)
-                dialogStatus = GetSession()->getDialogStatus(this, questgiver, DIALOG_STATUS_NONE);
+                dialogStatus = GetQuestGiverDialogStatus(questgiver);
 
             data << questgiver->GetObjectGuid();
             data << uint8(dialogStatus);
@@ -15138,7 +15201,7 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
 
     // Mail
     _LoadMails(holder->GetResult(PLAYER_LOGIN_QUERY_LOADMAILS));
-    _LoadMailedItems(holder->GetResult(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS));
+    _LoadMailedItemInfos(holder->GetResult(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS));
     UpdateNextMailTimeAndUnreads();
 
     _LoadSpells(holder->GetResult(PLAYER_LOGIN_QUERY_LOADSPELLS));
@@ -15204,7 +15267,7 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
         SetMap(sMapMgr.CreateMap(GetMapId(), this));
         SaveRecallPosition();                           // save as recall also to prevent recall and fall from sky
     }
-    else if (!m_taxiTracker.GetRoadmap().empty() && !m_taxiTracker.GetAtlas().empty())
+    else if (!m_taxiTracker.GetRoadmap().empty() && !m_taxiTracker.IsAtlasEmpty())
     {
         if (size_t nodeResume = m_taxiTracker.GetResumeWaypointIndex())
         {
@@ -15676,10 +15739,82 @@ void Player::_LoadItemLoot(QueryResult* result)
     }
 }
 
-// load mailed item which should receive current player
+// load which items the mails of current player hold, the Item objects are created by _LoadMailedItems
+void Player::_LoadMailedItemInfos(QueryResult* result)
+{
+    //         0        1          2
+    // "SELECT mail_id, item_guid, item_template FROM mail_items WHERE receiver = '%u'", GUID_LOPART(m_guid)
+    if (!result)
+        return;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        uint32 mail_id       = fields[0].GetUInt32();
+        uint32 item_guid_low = fields[1].GetUInt32();
+        uint32 item_template = fields[2].GetUInt32();
+
+        Mail* mail = GetMail(mail_id);
+        if (!mail)
+            continue;
+
+        if (!ObjectMgr::GetItemPrototype(item_template))
+        {
+            sLog.outError("Player %u has unknown item_template (ProtoType) in mailed items(GUID: %u template: %u) in mail (%u), deleted.", GetGUIDLow(), item_guid_low, item_template, mail->messageID);
+            CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
+            CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", item_guid_low);
+            continue;
+        }
+
+        mail->AddItem(item_guid_low, item_template);
+    }
+    while (result->NextRow());
+
+    delete result;
+}
+
+// data needs to be at first place for Item::LoadFromDB
+#define MAILED_ITEMS_QUERY "SELECT data, mail_id, item_guid, item_template FROM mail_items JOIN item_instance ON item_guid = guid WHERE receiver = '%u'"
+
+void Player::LoadMailedItemsIfNeeded()
+{
+    if (m_mailedItemsLoaded)
+        return;
+
+    // a prefetch still on its way finds the items loaded and drops its result
+    m_mailedItemsLoaded = true;
+    m_mailedItemsLoading = false;
+
+    _LoadMailedItems(CharacterDatabase.PQuery(MAILED_ITEMS_QUERY, GetGUIDLow()));
+}
+
+void Player::PrefetchMailedItems()
+{
+    if (m_mailedItemsLoaded || m_mailedItemsLoading)
+        return;
+
+    m_mailedItemsLoading = true;
+    CharacterDatabase.AsyncPQuery(&WorldSession::HandleMailedItemsLoadCallBack, GetSession()->GetAccountId(), GetGUIDLow(), MAILED_ITEMS_QUERY, GetGUIDLow());
+}
+
+void Player::HandleMailedItemsLoaded(QueryResult* result)
+{
+    // loaded synchronously in the meantime or requested by an earlier login of the character
+    if (m_mailedItemsLoaded || !m_mailedItemsLoading)
+    {
+        delete result;
+        return;
+    }
+
+    m_mailedItemsLoaded = true;
+    m_mailedItemsLoading = false;
+
+    _LoadMailedItems(result);
+}
+
+// create the mailed items which should receive current player
 void Player::_LoadMailedItems(QueryResult* result)
 {
-    // data needs to be at first place for Item::LoadFromDB
     //         0     1        2          3
     // "SELECT data, mail_id, item_guid, item_template FROM mail_items JOIN item_instance ON item_guid = guid WHERE receiver = '%u'", GUID_LOPART(m_guid)
     if (!result)
@@ -15692,22 +15827,26 @@ void Player::_LoadMailedItems(QueryResult* result)
         uint32 item_guid_low = fields[2].GetUInt32();
         uint32 item_template = fields[3].GetUInt32();
 
+        // the mails changed since the login: items taken, returned or mailed after it are already handled or created
         Mail* mail = GetMail(mail_id);
-        if (!mail)
+        if (!mail || mail->state == MAIL_STATE_DELETED || GetMItem(item_guid_low))
             continue;
-        mail->AddItem(item_guid_low, item_template);
 
-        ItemPrototype const* proto = ObjectMgr::GetItemPrototype(item_template);
-
-        if (!proto)
+        bool inMail = false;
+        for (MailItemInfoVec::const_iterator itr = mail->items.begin(); itr != mail->items.end(); ++itr)
         {
-            sLog.outError("Player %u has unknown item_template (ProtoType) in mailed items(GUID: %u template: %u) in mail (%u), deleted.", GetGUIDLow(), item_guid_low, item_template, mail->messageID);
-            CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
-            CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", item_guid_low);
-            continue;
+            if (itr->item_guid == item_guid_low)
+            {
+                inMail = true;
+                break;
+            }
         }
 
-        Item* item = NewItemOrBag(proto);
+        // unknown templates were dropped from the mail at login
+        if (!inMail)
+            continue;
+
+        Item* item = NewItemOrBag(ObjectMgr::GetItemPrototype(item_template));
 
         if (!item->LoadFromDB(item_guid_low, fields, GetObjectGuid()))
         {
@@ -16377,7 +16516,7 @@ bool Player::_LoadHomeBind(QueryResult* result)
 /***                   SAVE SYSTEM                     ***/
 /*********************************************************/
 
-void Player::SaveToDB()
+void Player::SaveToDB(bool incremental /*= false*/)
 {
     // we should assure this: ASSERT((m_nextSave != sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE)));
     // delay auto save at any saves (manual, in code, or autosave)
@@ -16396,137 +16535,206 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
+    // keep all writes of this account on the same async connection
+    SqlAsyncKeyScope asyncKey(GetSession()->GetAccountId());
+
+    sCharEnumCache.InvalidateAccount(GetSession()->GetAccountId());
+
     CharacterDatabase.BeginTransaction();
 
-    static SqlStatementID delChar ;
-    static SqlStatementID insChar ;
+    // buffered columns go first, the full save below overwrites them with the current values
+    sCharacterWriteBehind.Flush(GetGUIDLow());
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
+    if (incremental)
+    {
+        // the row exists for every character in world, rewrite its columns in place
+        static SqlStatementID updChar ;
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(updChar, "UPDATE characters SET account = ?, name = ?, race = ?, class = ?, gender = ?, level = ?, xp = ?, money = ?, playerBytes = ?, playerBytes2 = ?, playerFlags = ?, "
+                            "map = ?, dungeon_difficulty = ?, position_x = ?, position_y = ?, position_z = ?, orientation = ?, "
+                            "taximask = ?, online = ?, cinematic = ?, "
+                            "totaltime = ?, leveltime = ?, rest_bonus = ?, logout_time = ?, is_logout_resting = ?, resettalents_cost = ?, resettalents_time = ?, "
+                            "trans_x = ?, trans_y = ?, trans_z = ?, trans_o = ?, transguid = ?, extra_flags = ?, stable_slots = ?, at_login = ?, zone = ?, "
+                            "death_expire_time = ?, taxi_path = ?, arenaPoints = ?, totalHonorPoints = ?, todayHonorPoints = ?, yesterdayHonorPoints = ?, totalKills = ?, "
+                            "todayKills = ?, yesterdayKills = ?, chosenTitle = ?, watchedFaction = ?, drunk = ?, health = ?, power1 = ?, power2 = ?, power3 = ?, "
+                            "power4 = ?, power5 = ?, exploredZones = ?, equipmentCache = ?, ammoId = ?, knownTitles = ?, actionBars = ? "
+                            "WHERE guid = ?");
+
+        _BindCharacterRow(stmt);
+        stmt.addUInt32(GetGUIDLow());
+        stmt.Execute();
+    }
+    else
+    {
+        static SqlStatementID delChar ;
+        static SqlStatementID insChar ;
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
+
+        SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
+                                  "map, dungeon_difficulty, position_x, position_y, position_z, orientation, "
+                                  "taximask, online, cinematic, "
+                                  "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
+                                  "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
+                                  "death_expire_time, taxi_path, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, "
+                                  "todayKills, yesterdayKills, chosenTitle, watchedFaction, drunk, health, power1, power2, power3, "
+                                  "power4, power5, exploredZones, equipmentCache, ammoId, knownTitles, actionBars) "
+                                  "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?) ");
+
+        uberInsert.addUInt32(GetGUIDLow());
+        _BindCharacterRow(uberInsert);
+        uberInsert.Execute();
+    }
 
-    SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
-                              "map, dungeon_difficulty, position_x, position_y, position_z, orientation, "
-                              "taximask, online, cinematic, "
-                              "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
-                              "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
-                              "death_expire_time, taxi_path, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, "
-                              "todayKills, yesterdayKills, chosenTitle, watchedFaction, drunk, health, power1, power2, power3, "
-                              "power4, power5, exploredZones, equipmentCache, ammoId, knownTitles, actionBars) "
-                              "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?) ");
-
-    uberInsert.addUInt32(GetGUIDLow());
-    uberInsert.addUInt32(GetSession()->GetAccountId());
-    uberInsert.addString(m_name);
-    uberInsert.addUInt8(getRace());
-    uberInsert.addUInt8(getClass());
-    uberInsert.addUInt8(getGender());
-    uberInsert.addUInt32(getLevel());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_XP));
-    uberInsert.addUInt32(GetMoney());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FLAGS));
+    if (m_mailsUpdated)                                     // save mails only when needed
+        _SaveMail();
+
+    _SaveBGData();
+    _SaveInventory();
+    _SaveQuestStatus();
+    _SaveDailyQuestStatus();
+    _SaveWeeklyQuestStatus();
+    _SaveMonthlyQuestStatus();
+    _SaveSpells();
+    if (!incremental)
+        m_savedCooldownsHash = uint64(-1);                  // full saves always rewrite the cooldowns
+    _SaveSpellCooldowns();
+    _SaveActions();
+    _SaveAuras();
+    _SaveSkills();
+    if (!incremental || m_enteredInstancesChanged)
+        _SaveNewInstanceIdTimer();
+    m_reputationMgr.SaveToDB();
+    GetSession()->SaveTutorialsData();                      // changed only while character in game
+
+    CharacterDatabase.CommitTransaction();
+
+    // check if stats should only be saved on logout
+    // save stats can be out of transaction
+    if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
+        _SaveStats();
+
+    // save pet (hunter pet level and experience and all type pets health/mana except priest pet).
+    if (Pet* pet = GetPet())
+        pet->SavePetToDB(PET_SAVE_AS_CURRENT, this);
+}
+
+// all characters columns but guid, in the order of the statements in SaveToDB
+void Player::_BindCharacterRow(SqlStatement& stmt)
+{
+    stmt.addUInt32(GetSession()->GetAccountId());
+    stmt.addString(m_name);
+    stmt.addUInt8(getRace());
+    stmt.addUInt8(getClass());
+    stmt.addUInt8(getGender());
+    stmt.addUInt32(getLevel());
+    stmt.addUInt32(GetUInt32Value(PLAYER_XP));
+    stmt.addUInt32(GetMoney());
+    stmt.addUInt32(GetUInt32Value(PLAYER_BYTES));
+    stmt.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
+    stmt.addUInt32(GetUInt32Value(PLAYER_FLAGS));
 
     if (!IsBeingTeleported())
     {
-        uberInsert.addUInt32(GetMapId());
-        uberInsert.addUInt32(uint32(GetDifficulty()));
-        uberInsert.addFloat(finiteAlways(GetPositionX()));
-        uberInsert.addFloat(finiteAlways(GetPositionY()));
-        uberInsert.addFloat(finiteAlways(GetPositionZ()));
-        uberInsert.addFloat(finiteAlways(GetOrientation()));
+        stmt.addUInt32(GetMapId());
+        stmt.addUInt32(uint32(GetDifficulty()));
+        stmt.addFloat(finiteAlways(GetPositionX()));
+        stmt.addFloat(finiteAlways(GetPositionY()));
+        stmt.addFloat(finiteAlways(GetPositionZ()));
+        stmt.addFloat(finiteAlways(GetOrientation()));
     }
     else
     {
-        uberInsert.addUInt32(GetTeleportDest().mapid);
-        uberInsert.addUInt32(uint32(GetDifficulty()));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_x));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_y));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_z));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().orientation));
+        stmt.addUInt32(GetTeleportDest().mapid);
+        stmt.addUInt32(uint32(GetDifficulty()));
+        stmt.addFloat(finiteAlways(GetTeleportDest().coord_x));
+        stmt.addFloat(finiteAlways(GetTeleportDest().coord_y));
+        stmt.addFloat(finiteAlways(GetTeleportDest().coord_z));
+        stmt.addFloat(finiteAlways(GetTeleportDest().orientation));
     }
 
     std::ostringstream ss;
     ss << m_taxi;                                   // string with TaxiMaskSize numbers
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
-    uberInsert.addUInt32(IsInWorld() ? 1 : 0);
+    stmt.addUInt32(IsInWorld() ? 1 : 0);
 
-    uberInsert.addUInt32(m_cinematic);
+    stmt.addUInt32(m_cinematic);
 
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
+    stmt.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
+    stmt.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
 
-    uberInsert.addFloat(finiteAlways(m_rest_bonus));
-    uberInsert.addUInt64(uint64(time(nullptr)));
-    uberInsert.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
+    stmt.addFloat(finiteAlways(m_rest_bonus));
+    stmt.addUInt64(uint64(time(nullptr)));
+    stmt.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
     // save, far from tavern/city
     // save, but in tavern/city
-    uberInsert.addUInt32(m_resetTalentsCost);
-    uberInsert.addUInt64(uint64(m_resetTalentsTime));
+    stmt.addUInt32(m_resetTalentsCost);
+    stmt.addUInt64(uint64(m_resetTalentsTime));
 
     Position const* transportPosition = m_movementInfo.GetTransportPos();
-    uberInsert.addFloat(finiteAlways(transportPosition->x));
-    uberInsert.addFloat(finiteAlways(transportPosition->y));
-    uberInsert.addFloat(finiteAlways(transportPosition->z));
-    uberInsert.addFloat(finiteAlways(transportPosition->o));
+    stmt.addFloat(finiteAlways(transportPosition->x));
+    stmt.addFloat(finiteAlways(transportPosition->y));
+    stmt.addFloat(finiteAlways(transportPosition->z));
+    stmt.addFloat(finiteAlways(transportPosition->o));
 
     if (m_transport)
-        uberInsert.addUInt32(m_transport->GetGUIDLow());
+        stmt.addUInt32(m_transport->GetGUIDLow());
     else
-        uberInsert.addUInt32(0);
+        stmt.addUInt32(0);
 
-    uberInsert.addUInt32(m_ExtraFlags);
+    stmt.addUInt32(m_ExtraFlags);
 
-    uberInsert.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
+    stmt.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
 
-    uberInsert.addUInt32(uint32(m_atLoginFlags));
+    stmt.addUInt32(uint32(m_atLoginFlags));
 
-    uberInsert.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
+    stmt.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
 
-    uberInsert.addUInt64(uint64(m_deathExpireTime));
+    stmt.addUInt64(uint64(m_deathExpireTime));
 
     ss << m_taxiTracker.Save();
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
-    uberInsert.addUInt32(GetArenaPoints());
+    stmt.addUInt32(GetArenaPoints());
 
-    uberInsert.addUInt32(GetHonorPoints());
+    stmt.addUInt32(GetHonorPoints());
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION));
+    stmt.addUInt32(GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION));
+    stmt.addUInt32(GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORBALE_KILLS));
+    stmt.addUInt32(GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORBALE_KILLS));
 
-    uberInsert.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 0));
+    stmt.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 0));
 
-    uberInsert.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 1));
+    stmt.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 1));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_CHOSEN_TITLE));
+    stmt.addUInt32(GetUInt32Value(PLAYER_CHOSEN_TITLE));
 
     // FIXME: at this moment send to DB as unsigned, including unit32(-1)
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
+    stmt.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
 
-    uberInsert.addUInt16(uint16(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE));
+    stmt.addUInt16(uint16(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE));
 
-    uberInsert.addUInt32(GetHealth());
+    stmt.addUInt32(GetHealth());
 
     for (uint32 i = 0; i < MAX_POWERS; ++i)
-        uberInsert.addUInt32(GetPower(Powers(i)));
+        stmt.addUInt32(GetPower(Powers(i)));
 
     for (uint32 i = 0; i < PLAYER_EXPLORED_ZONES_SIZE; ++i) // string
     {
         ss << GetUInt32Value(PLAYER_EXPLORED_ZONES_1 + i) << " ";
     }
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
     for (uint32 i = 0; i < EQUIPMENT_SLOT_END; ++i)         // string: item id, ench (perm/temp)
     {
@@ -16536,48 +16744,17 @@ void Player::SaveToDB()
         uint32 ench2 = GetUInt32Value(PLAYER_VISIBLE_ITEM_1_0 + i * MAX_VISIBLE_ITEM_OFFSET + 1 + TEMP_ENCHANTMENT_SLOT);
         ss << uint32(MAKE_PAIR32(ench1, ench2)) << " ";
     }
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
+    stmt.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
 
     for (uint32 i = 0; i < 2; ++i)
     {
         ss << GetUInt32Value(PLAYER__FIELD_KNOWN_TITLES + i) << " ";
     }
-    uberInsert.addString(ss);
-
-    uberInsert.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
-
-    uberInsert.Execute();
-
-    if (m_mailsUpdated)                                     // save mails only when needed
-        _SaveMail();
-
-    _SaveBGData();
-    _SaveInventory();
-    _SaveQuestStatus();
-    _SaveDailyQuestStatus();
-    _SaveWeeklyQuestStatus();
-    _SaveMonthlyQuestStatus();
-    _SaveSpells();
-    _SaveSpellCooldowns();
-    _SaveActions();
-    _SaveAuras();
-    _SaveSkills();
-    _SaveNewInstanceIdTimer();
-    m_reputationMgr.SaveToDB();
-    GetSession()->SaveTutorialsData();                      // changed only while character in game
-
-    CharacterDatabase.CommitTransaction();
+    stmt.addString(ss);
 
-    // check if stats should only be saved on logout
-    // save stats can be out of transaction
-    if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
-        _SaveStats();
-
-    // save pet (hunter pet level and experience and all type pets health/mana except priest pet).
-    if (Pet* pet = GetPet())
-        pet->SavePetToDB(PET_SAVE_AS_CURRENT, this);
+    stmt.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
 }
 
 // fast save function for item/money cheating preventing - save only inventory and money state
@@ -16589,10 +16766,7 @@ void Player::SaveInventoryAndGoldToDB()
 
 void Player::SaveGoldToDB() const
 {
-    static SqlStatementID updateGold ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(updateGold, "UPDATE characters SET money = ? WHERE guid = ?");
-    stmt.PExecute(GetMoney(), GetGUIDLow());
+    sCharacterWriteBehind.SetColumn("characters", GetGUIDLow(), GetSession()->GetAccountId(), "money", GetMoney());
 }
 
 void Player::_SaveActions()
@@ -16648,7 +16822,6 @@ void Player::_SaveActions()
 void Player::_SaveAuras()
 {
     static SqlStatementID deleteAuras ;
-    static SqlStatementID insertAuras ;
 
     SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
     stmt.PExecute(GetGUIDLow());
@@ -16658,9 +16831,8 @@ void Player::_SaveAuras()
     if (auraHolders.empty())
         return;
 
-    stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
-            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    SqlBatchInsert insertAuras(CharacterDatabase, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
+            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask)", 15);
 
     for (const auto& auraHolder : auraHolders)
     {
@@ -16696,25 +16868,26 @@ void Player::_SaveAuras()
             if (!effIndexMask)
                 continue;
 
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt64(holder->GetCasterGuid().GetRawValue());
-            stmt.addUInt32(holder->GetCastItemGuid().GetCounter());
-            stmt.addUInt32(holder->GetId());
-            stmt.addUInt32(holder->GetStackAmount());
-            stmt.addUInt8(holder->GetAuraCharges());
+            insertAuras.addUInt32(GetGUIDLow());
+            insertAuras.addUInt64(holder->GetCasterGuid().GetRawValue());
+            insertAuras.addUInt32(holder->GetCastItemGuid().GetCounter());
+            insertAuras.addUInt32(holder->GetId());
+            insertAuras.addUInt32(holder->GetStackAmount());
+            insertAuras.addUInt8(holder->GetAuraCharges());
 
             for (int i : damage)
-                stmt.addInt32(i);
+                insertAuras.addInt32(i);
 
             for (unsigned int i : periodicTime)
-                stmt.addUInt32(i);
+                insertAuras.addUInt32(i);
 
-            stmt.addInt32(holder->GetAuraMaxDuration());
-            stmt.addInt32(holder->GetAuraDuration());
-            stmt.addUInt32(effIndexMask);
-            stmt.Execute();
+            insertAuras.addInt32(holder->GetAuraMaxDuration());
+            insertAuras.addInt32(holder->GetAuraDuration());
+            insertAuras.addUInt32(effIndexMask);
         }
     }
+
+    insertAuras.Execute();
 }
 
 void Player::_SaveInventory()
@@ -16739,6 +16912,7 @@ void Player::_SaveInventory()
     }
 
     // update enchantment durations
+    ApplyEnchantDurationElapsed();
     for (EnchantDurationList::const_iterator itr = m_enchantDuration.begin(); itr != m_enchantDuration.end(); ++itr)
     {
         itr->item->SetEnchantmentDuration(itr->slot, itr->leftduration);
@@ -16773,12 +16947,15 @@ void Player::_SaveInventory()
         return;
     }
 
+    // new inventory rows are sent as one multi-row insert
+    SqlBatchInsert inventoryInserts(CharacterDatabase, "INSERT INTO character_inventory (guid,bag,slot,item,item_template)", 5);
     for (auto item : m_itemUpdateQueue)
     {
         if (!item) continue;
 
-        SaveItemToInventory(item);
+        SaveItemToInventory(item, &inventoryInserts);
     }
+    inventoryInserts.Execute();
     m_itemUpdateQueue.clear();
 }
 
@@ -16861,10 +17038,10 @@ void Player::_SaveMail()
 
 void Player::_SaveQuestStatus()
 {
-    static SqlStatementID insertQuestStatus ;
-
     static SqlStatementID updateQuestStatus ;
 
+    SqlBatchInsert insertQuestStatus(CharacterDatabase, "INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4)", 14);
+
     // we don't need transactions here.
     for (auto& mQuestStatu : mQuestStatus)
     {
@@ -16873,20 +17050,16 @@ void Player::_SaveQuestStatus()
         {
             case QUEST_NEW :
             {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(insertQuestStatus, "INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) "
-                                    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(mQuestStatu.first);
-                stmt.addUInt8(questStatus.m_status);
-                stmt.addUInt8(questStatus.m_rewarded);
-                stmt.addUInt8(questStatus.m_explored);
-                stmt.addUInt64(uint64(questStatus.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()));
+                insertQuestStatus.addUInt32(GetGUIDLow());
+                insertQuestStatus.addUInt32(mQuestStatu.first);
+                insertQuestStatus.addUInt8(questStatus.m_status);
+                insertQuestStatus.addUInt8(questStatus.m_rewarded);
+                insertQuestStatus.addUInt8(questStatus.m_explored);
+                insertQuestStatus.addUInt64(uint64(questStatus.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()));
                 for (unsigned int k : questStatus.m_creatureOrGOcount)
-                    stmt.addUInt32(k);
+                    insertQuestStatus.addUInt32(k);
                 for (unsigned int k : questStatus.m_itemcount)
-                    stmt.addUInt32(k);
-                stmt.Execute();
+                    insertQuestStatus.addUInt32(k);
             }
             break;
             case QUEST_CHANGED :
@@ -16912,6 +17085,8 @@ void Player::_SaveQuestStatus()
         }
         questStatus.uState = QUEST_UNCHANGED;
     }
+
+    insertQuestStatus.Execute();
 }
 
 void Player::_SaveDailyQuestStatus()
@@ -17032,10 +17207,10 @@ void Player::_SaveSkills()
 void Player::_SaveSpells()
 {
     static SqlStatementID delSpells ;
-    static SqlStatementID insSpells ;
 
     SqlStatement stmtDel = CharacterDatabase.CreateStatement(delSpells, "DELETE FROM character_spell WHERE guid = ? and spell = ?");
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insSpells, "INSERT INTO character_spell (guid,spell,active,disabled) VALUES (?, ?, ?, ?)");
+    // inserts are sent after all deletes as one multi-row insert, changed spells are deleted before they are inserted again
+    SqlBatchInsert stmtIns(CharacterDatabase, "INSERT INTO character_spell (guid,spell,active,disabled)", 4);
 
     for (PlayerSpellMap::iterator itr = m_spells.begin(); itr != m_spells.end();)
     {
@@ -17046,7 +17221,12 @@ void Player::_SaveSpells()
 
         // add only changed/new not dependent spells
         if (!playerSpell.dependent && (playerSpell.state == PLAYERSPELL_NEW || playerSpell.state == PLAYERSPELL_CHANGED))
-            stmtIns.PExecute(GetGUIDLow(), itr->first, uint8(playerSpell.active ? 1 : 0), uint8(playerSpell.disabled ? 1 : 0));
+        {
+            stmtIns.addUInt32(GetGUIDLow());
+            stmtIns.addUInt32(itr->first);
+            stmtIns.addUInt8(uint8(playerSpell.active ? 1 : 0));
+            stmtIns.addUInt8(uint8(playerSpell.disabled ? 1 : 0));
+        }
 
         if (playerSpell.state == PLAYERSPELL_REMOVED)
             m_spells.erase(itr++);
@@ -17056,6 +17236,8 @@ void Player::_SaveSpells()
             ++itr;
         }
     }
+
+    stmtIns.Execute();
 }
 
 // save player stats -- only for external usage
@@ -18083,10 +18265,17 @@ bool Player::TaxiFlightInterrupt(bool cancel /*= true*/)
 const Taxi::Map& Player::GetTaxiPathSpline() const
 {
     // Bugcheck: container continuity error
-    MANGOS_ASSERT(!m_taxiTracker.GetAtlas().empty());
+    MANGOS_ASSERT(!m_taxiTracker.IsAtlasEmpty());
     return m_taxiTracker.GetMap();
 }
 
+const Movement::PointsArray& Player::GetTaxiPathSplinePoints() const
+{
+    // Bugcheck: container continuity error
+    MANGOS_ASSERT(!m_taxiTracker.IsAtlasEmpty());
+    return m_taxiTracker.GetSpline();
+}
+
 int32 Player::GetTaxiPathSplineOffset() const
 {
     return int32(m_taxiTracker.GetResumeWaypointIndex());
@@ -18141,7 +18330,7 @@ bool Player::OnTaxiFlightUpdate(const size_t waypointIndex, const bool movement)
         case Taxi::TRACKER_FLIGHT:
         {
             // Bugcheck: container continuity error
-            MANGOS_ASSERT(!m_taxiTracker.GetAtlas().empty());
+            MANGOS_ASSERT(!m_taxiTracker.IsAtlasEmpty());
 
             // Check for spline interference before updating the container
             if (!movement)
@@ -18158,7 +18347,7 @@ bool Player::OnTaxiFlightUpdate(const size_t waypointIndex, const bool movement)
             const bool start = (!waypointIndex && !m_taxiTracker.GetCurrentWaypoint());
             if (waypointIndex > current || start)
             {
-                Taxi::Map map = m_taxiTracker.GetMap();
+                const Taxi::Map& map = m_taxiTracker.GetMap();
                 for (size_t next = (start ? current : current + 1); next <= waypointIndex; ++next)
                 {
                     const TaxiPathNodeEntry* entry = map.at(next);
@@ -18220,7 +18409,7 @@ bool Player::OnTaxiFlightSplineUpdate()
         case Taxi::TRACKER_TRANSFER:
         {
             // Bugcheck: container continuity error
-            MANGOS_ASSERT(!m_taxiTracker.GetAtlas().empty());
+            MANGOS_ASSERT(!m_taxiTracker.IsAtlasEmpty());
 
             const Taxi::Map& map = m_taxiTracker.GetMap();
 
@@ -19110,7 +19299,9 @@ void Player::UpdateVisibilityOf(WorldObject const* viewPoint, T* target, UpdateD
         if (target->isVisibleForInState(this, viewPoint, false))
         {
             visibleNow.insert(target);
-            target->BuildCreateUpdateBlockForPlayer(&data, this);
+            // the client side list is still kept for bots, it drives the visibility notifications
+            if (!GetSession()->IsBotSession())
+                target->BuildCreateUpdateBlockForPlayer(&data, this);
             UpdateVisibilityOf_helper(m_clientGUIDs, target);
 
             DEBUG_FILTER_LOG(LOG_FILTER_VISIBILITY_CHANGES, "UpdateVisibilityOf(TemplateV): %s is visible now for %s. Distance = %f", target->GetGuidStr().c_str(), GetGuidStr().c_str(), GetDistance(target));
@@ -19572,6 +19763,8 @@ void Player::SendAuraDurationsForTarget(Unit* target)
 
 void Player::SetDailyQuestStatus(uint32 quest_id)
 {
+    InvalidateQuestStateCaches();
+
     for (uint32 quest_daily_idx = 0; quest_daily_idx < PLAYER_MAX_DAILY_QUESTS; ++quest_daily_idx)
     {
         if (!GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1 + quest_daily_idx))
@@ -19585,18 +19778,24 @@ void Player::SetDailyQuestStatus(uint32 quest_id)
 
 void Player::SetWeeklyQuestStatus(uint32 quest_id)
 {
+    InvalidateQuestStateCaches();
+
     m_weeklyquests.insert(quest_id);
     m_WeeklyQuestChanged = true;
 }
 
 void Player::SetMonthlyQuestStatus(uint32 quest_id)
 {
+    InvalidateQuestStateCaches();
+
     m_monthlyquests.insert(quest_id);
     m_MonthlyQuestChanged = true;
 }
 
 void Player::ResetDailyQuestStatus()
 {
+    InvalidateQuestStateCaches();
+
     for (uint32 quest_daily_idx = 0; quest_daily_idx < PLAYER_MAX_DAILY_QUESTS; ++quest_daily_idx)
         SetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1 + quest_daily_idx, 0);
 
@@ -19606,6 +19805,8 @@ void Player::ResetDailyQuestStatus()
 
 void Player::ResetWeeklyQuestStatus()
 {
+    InvalidateQuestStateCaches();
+
     if (m_weeklyquests.empty())
         return;
 
@@ -19616,6 +19817,8 @@ void Player::ResetWeeklyQuestStatus()
 
 void Player::ResetMonthlyQuestStatus()
 {
+    InvalidateQuestStateCaches();
+
     if (m_monthlyquests.empty())
         return;
 
@@ -19801,6 +20004,8 @@ bool Player::HasQuestForGO(int32 GOId) const
 
 void Player::UpdateForQuestWorldObjects()
 {
+    InvalidateQuestStateCaches();
+
     if (m_clientGUIDs.empty())
         return;
 
@@ -20639,7 +20844,7 @@ void Player::SaveTitles()
     std::string playerTitles;
     for (uint32 i = 0; i < 2; ++i)
         playerTitles += std::to_string(GetUInt32Value(PLAYER__FIELD_KNOWN_TITLES + i)) + " ";
-    CharacterDatabase.PExecute("UPDATE characters SET KnownTitles='%s' WHERE guid = '%u'", playerTitles.data(), GetGUIDLow());
+    sCharacterWriteBehind.SetColumn("characters", GetGUIDLow(), GetSession()->GetAccountId(), "knownTitles", playerTitles);
 }
 
 Item* Player::ConvertItem(Item* item, uint32 newItemId)
@@ -21129,7 +21334,7 @@ void Player::RemoveAtLoginFlag(AtLoginFlags f, bool in_db_also /*= false*/)
     m_atLoginFlags &= ~f;
 
     if (in_db_also)
-        CharacterDatabase.PExecute("UPDATE characters set at_login = at_login & ~ %u WHERE guid ='%u'", uint32(f), GetGUIDLow());
+        sCharacterWriteBehind.SetColumn("characters", GetGUIDLow(), GetSession()->GetAccountId(), "at_login", uint32(m_atLoginFlags));
 }
 
 void Player::SendClearCooldown(uint32 spell_id, Unit* target) const
@@ -21683,7 +21888,10 @@ bool Player::CanEnterNewInstance(uint32 instanceId)
 void Player::AddNewInstanceId(uint32 instanceId)
 {
     if (m_enteredInstances.find(instanceId) == m_enteredInstances.end())
+    {
         m_enteredInstances.emplace(instanceId, std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now() + std::chrono::hours(1)));
+        m_enteredInstancesChanged = true;
+    }
 }
 
 void Player::_LoadCreatedInstanceTimers()
@@ -21710,6 +21918,8 @@ void Player::_LoadCreatedInstanceTimers()
 
 void Player::_SaveNewInstanceIdTimer()
 {
+    m_enteredInstancesChanged = false;
+
     CharacterDatabase.PExecute("DELETE FROM account_instances_entered WHERE AccountId = '%u'", m_session->GetAccountId());
 
     if (m_enteredInstances.empty())
@@ -21734,7 +21944,10 @@ void Player::UpdateNewInstanceIdTimers(TimePoint const& now)
     for (auto iter = m_enteredInstances.begin(); iter != m_enteredInstances.end();)
     {
         if ((*iter).second < now)
+        {
             iter = m_enteredInstances.erase(iter);
+            m_enteredInstancesChanged = true;
+        }
         else
             ++iter;
     }
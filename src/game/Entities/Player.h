@@ -52,6 +52,8 @@ class PlayerMenu;
 class Transport;
 class UpdateMask;
 class SpellCastTargets;
+class SqlStatement;
+class SqlBatchInsert;
 class PlayerSocial;
 class DungeonPersistentState;
 class Spell;
@@ -910,7 +912,9 @@ class Player : public Unit
         void CleanupsBeforeDelete() override;
 
         static UpdateMask updateVisualBits;
+        static UpdateMask updateGroupVisualBits;
         static void InitVisibleBits();
+        UpdateMask const& GetVisibleBitsFor(Player const* target) const { return target->IsInGroup(this) ? updateGroupVisualBits : updateVisualBits; }
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
@@ -1056,6 +1060,7 @@ class Player : public Unit
         void ToggleTaxiDebug() { m_taxiTracker.m_debug = !m_taxiTracker.m_debug; }
 
         Taxi::Map const& GetTaxiPathSpline() const;
+        Movement::PointsArray const& GetTaxiPathSplinePoints() const;
         int32 GetTaxiPathSplineOffset() const;
 
         void OnTaxiFlightStart(const TaxiPathEntry* path);
@@ -1344,6 +1349,20 @@ class Player : public Unit
         void SendQuestUpdateAddCreatureOrGo(Quest const* pQuest, ObjectGuid guid, uint32 creatureOrGO_idx, uint32 count);
         void SendQuestGiverStatusMultiple() const;
 
+        // dialog status of the quest givers by entry, quest, level, reputation and skill changes drop the cached ones
+        uint32 GetQuestGiverDialogStatus(Object const* questgiver) const;
+        void InvalidateQuestStateCaches() const
+        {
+            m_questGiverStatusCache.clear();
+            m_conditionMemo.clear();
+        }
+
+        // results of PlayerCondition::IsMemoizable conditions, kept for one update cycle of the map of the player
+        bool GetConditionMemo(uint32 key, bool& result) const;
+        void SetConditionMemo(uint32 key, bool result) const;
+        // game events toggle quests and conditions of every player
+        static void InvalidateAllQuestGiverStatusCaches() { s_questGiverStatusGeneration.fetch_add(1, std::memory_order_relaxed); }
+
         ObjectGuid GetDividerGuid() const { return m_dividerGuid; }
         void SetDividerGuid(ObjectGuid guid) { m_dividerGuid = guid; }
         void ClearDividerGuid() { m_dividerGuid.Clear(); }
@@ -1359,7 +1378,7 @@ class Player : public Unit
         void chompAndTrim(std::string& str);
         bool getNextQuestId(const std::string& pString, unsigned int& pStartPos, unsigned int& pId);
         void skill(std::list<uint32>& m_spellsToLearn);
-        bool requiredQuests(const char* pQuestIdString);
+        bool requiredQuests(std::vector<uint32> const& questIds) const;
         PlayerMails::reverse_iterator GetMailRBegin() { return m_mail.rbegin();}
         PlayerMails::reverse_iterator GetMailREnd() { return m_mail.rend();}
         void UpdateMail();
@@ -1380,7 +1399,8 @@ class Player : public Unit
         /***                   SAVE SYSTEM                     ***/
         /*********************************************************/
 
-        void SaveToDB();
+        // incremental saves are used by autosave, they update the character row in place and skip unchanged sections
+        void SaveToDB(bool incremental = false);
         void SaveInventoryAndGoldToDB();                    // fast save function for item/money cheating preventing
         void SaveGoldToDB() const;
         static void SetUInt32ValueInArray(Tokens& tokens, uint16 index, uint32 value);
@@ -1480,6 +1500,12 @@ class Player : public Unit
             return mMitems.erase(id) ? true : false;
         }
 
+        // the login only reads which items each mail holds, their Item objects are created on first use of the mailbox
+        bool IsMailedItemsLoaded() const { return m_mailedItemsLoaded; }
+        void LoadMailedItemsIfNeeded();
+        void PrefetchMailedItems();
+        void HandleMailedItemsLoaded(QueryResult* result);
+
         void PetSpellInitialize() const;
         void CharmSpellInitialize() const;
         void PossessSpellInitialize();
@@ -1642,6 +1668,9 @@ class Player : public Unit
         float GetManaBonusFromIntellect() const;
 
         bool UpdateStats(Stats stat) override;
+        void UpdateStatValue(Stats stat);
+        void UpdateStatDependentBonuses();
+        void UpdateModifiedStats(uint32 unitModMask) override;
         bool UpdateAllStats() override;
         void UpdateResistances(uint32 school) override;
         void UpdateArmor() override;
@@ -2230,7 +2259,7 @@ class Player : public Unit
         void UpdateEverything();
 
         // Public Save system functions
-        void SaveItemToInventory(Item* item); // optimization for gift wrapping
+        void SaveItemToInventory(Item* item, SqlBatchInsert* inventoryInserts = nullptr); // optimization for gift wrapping
         void SaveTitles(); // optimization for arena rewards
 
     protected:
@@ -2273,6 +2302,7 @@ class Player : public Unit
         void _LoadInventory(QueryResult* result, uint32 timediff);
         void _LoadItemLoot(QueryResult* result);
         void _LoadMails(QueryResult* result);
+        void _LoadMailedItemInfos(QueryResult* result);
         void _LoadMailedItems(QueryResult* result);
         void _LoadQuestStatus(QueryResult* result);
         void _LoadDailyQuestStatus(QueryResult* result);
@@ -2293,6 +2323,7 @@ class Player : public Unit
         /***                   SAVE SYSTEM                     ***/
         /*********************************************************/
 
+        void _BindCharacterRow(SqlStatement& stmt);
         void _SaveActions();
         void _SaveAuras();
         void _SaveInventory();
@@ -2350,6 +2381,10 @@ class Player : public Unit
         Item* m_items[PLAYER_SLOTS_COUNT];
         uint32 m_currentBuybackSlot;
 
+        // items stored in equipment, inventory, keyring, bank and bags (not buyback) by entry
+        typedef std::unordered_multimap<uint32, Item*> ItemEntryIndex;
+        ItemEntryIndex m_itemsByEntry;
+
         std::vector<Item*> m_itemUpdateQueue;
         bool m_itemUpdateQueueBlocked;
 
@@ -2367,6 +2402,8 @@ class Player : public Unit
         uint32 m_ArenaTeamIdInvited;
 
         PlayerMails m_mail;
+        bool m_mailedItemsLoaded;
+        bool m_mailedItemsLoading;                          // waiting for PrefetchMailedItems
         PlayerSpellMap m_spells;
 
         ActionButtonList m_actionButtons;
@@ -2380,6 +2417,10 @@ class Player : public Unit
         int32 m_SpellModRemoveCount;
         SpellFamily m_spellClassName; // s_spellClassSet
         EnchantDurationList m_enchantDuration;
+        // ms not yet taken from the leftduration of m_enchantDuration, the list is walked only once it reaches the soonest expiry
+        uint32 m_enchantDurationElapsed;
+        uint32 m_enchantDurationNextExpire;
+        void ApplyEnchantDurationElapsed();
         ItemDurationList m_itemDuration;
 
         ObjectGuid m_resurrectGuid;
@@ -2400,6 +2441,16 @@ class Player : public Unit
         bool   m_WeeklyQuestChanged;
         bool   m_MonthlyQuestChanged;
 
+        mutable std::unordered_map<uint64, uint8> m_questGiverStatusCache;  // by type id and entry
+        mutable time_t m_questGiverStatusCacheExpireTime;   // conditions can depend on anything, the cache is dropped regularly
+        mutable uint32 m_questGiverStatusGeneration;
+        static std::atomic<uint32> s_questGiverStatusGeneration;
+
+        mutable std::unordered_map<uint32, bool> m_conditionMemo;   // by condition entry and source type
+        mutable Map const* m_conditionMemoMap;
+        mutable uint32 m_conditionMemoCycle;
+        mutable uint32 m_conditionMemoGeneration;           // of s_questGiverStatusGeneration, game events change the results
+
         uint32 m_drunkTimer;
         uint16 m_drunk;
         uint32 m_weaponChangeTimer;
@@ -2441,6 +2492,7 @@ class Player : public Unit
         GroupReference m_originalGroup;
         Group* m_groupInvite;
         uint32 m_groupUpdateMask;
+        uint32 m_groupUpdateTimer;                          // changes of the member are merged until it expires
 
         // Player summoning
         time_t m_summon_expire;
@@ -2456,6 +2508,9 @@ class Player : public Unit
         InventoryResult _CanStoreItem_InBag(uint8 bag, ItemPosCountVec& dest, ItemPrototype const* pProto, uint32& count, bool merge, bool non_specialized, Item* pSrcItem, uint8 skip_bag, uint8 skip_slot) const;
         InventoryResult _CanStoreItem_InInventorySlots(uint8 slot_begin, uint8 slot_end, ItemPosCountVec& dest, ItemPrototype const* pProto, uint32& count, bool merge, Item* pSrcItem, uint8 skip_bag, uint8 skip_slot) const;
         Item* _StoreItem(uint16 pos, Item* pItem, uint32 count, bool clone, bool update);
+        void AddItemToEntryIndex(Item* pItem);
+        void RemoveItemFromEntryIndex(Item* pItem);
+        static bool IsCountedItemPos(uint8 bag, uint8 slot, bool inBankAlso);
 
         CinematicMgrUPtr m_cinematicMgr;
 
@@ -2541,7 +2596,12 @@ class Player : public Unit
         float m_energyRegenRate;
 
         std::unordered_map<uint32, TimePoint> m_enteredInstances;
+        bool m_enteredInstancesChanged;
         uint32 m_createdInstanceClearTimer;
+
+        uint64 m_savedCooldownsHash;                        // signature of the cooldowns last written to the DB
+
+        TrackedMemory<MEMORY_TAG_PLAYERS, Player> m_trackedMemory;
 };
 
 void AddItemsSetItem(Player* player, Item* item);
@@ -22,12 +22,14 @@
 #include "Database/DatabaseImpl.h"
 #include "WorldPacket.h"
 #include "Server/WorldSession.h"
+#include "Server/QueryResponseCache.h"
 #include "Server/Opcodes.h"
 #include "Log.h"
 #include "World/World.h"
 #include "Globals/ObjectMgr.h"
 #include "Entities/ObjectGuid.h"
 #include "Entities/Player.h"
+#include "Entities/CharacterNameCache.h"
 #include "Entities/NPCHandler.h"
 #include "Server/SQLStorages.h"
 
@@ -113,6 +115,10 @@ void WorldSession::SendNameQueryResponseFromDBCallBack(QueryResult* result, uint
             response.declined.name[i] = fields[(5 + i)].GetCppString();
     }
 
+    // character added while running without passing the cache (player dump), keep it for the next queries
+    sCharacterNameCache.Add(response.guid.GetCounter(), response.name, uint8(response.race), uint8(response.gender), uint8(response.classid));
+    sCharacterNameCache.SetDeclinedNames(response.guid.GetCounter(), response.declined);
+
     if (session->m_sessionState != WORLD_SESSION_STATE_READY)
         session->m_offlineNameResponses.push_back(response);
     else
@@ -161,7 +167,20 @@ void WorldSession::HandleNameQueryOpcode(WorldPacket& recv_data)
             SendNameQueryResponse(response);
     }
     else
-        SendNameQueryResponseFromDB(guid);
+    {
+        CharacterNameQueryResponse response;
+
+        if (!guid.IsPlayer() || !sCharacterNameCache.Get(guid.GetCounter(), response))
+        {
+            SendNameQueryResponseFromDB(guid);
+            return;
+        }
+
+        if (m_sessionState != WORLD_SESSION_STATE_READY)
+            m_offlineNameResponses.push_back(response);
+        else
+            SendNameQueryResponse(response);
+    }
 }
 
 void WorldSession::HandleQueryTimeOpcode(WorldPacket& /*recv_data*/)
@@ -182,6 +201,12 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
     {
         int loc_idx = GetSessionDbLocaleIndex();
 
+        if (QueryResponseCache::Response response = QueryResponseCache::Find(QUERY_RESPONSE_CREATURE, entry, loc_idx))
+        {
+            SendPacket(response->GetPayload());
+            return;
+        }
+
         char const* name = ci->Name;
         char const* subName = ci->SubName;
         sObjectMgr.GetCreatureLocaleStrings(entry, loc_idx, &name, &subName);
@@ -207,7 +232,7 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
         data << float(ci->HealthMultiplier);                 // health multiplier
         data << float(ci->PowerMultiplier);                   // mana multiplier
         data << uint8(ci->RacialLeader);
-        SendPacket(data);
+        SendPacket(QueryResponseCache::Add(QUERY_RESPONSE_CREATURE, entry, loc_idx, data)->GetPayload());
         DEBUG_LOG("WORLD: Sent SMSG_CREATURE_QUERY_RESPONSE");
     }
     else
@@ -232,11 +257,18 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
     const GameObjectInfo* info = ObjectMgr::GetGameObjectInfo(entryID);
     if (info)
     {
+        int loc_idx = GetSessionDbLocaleIndex();
+
+        if (QueryResponseCache::Response response = QueryResponseCache::Find(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx))
+        {
+            SendPacket(response->GetPayload());
+            return;
+        }
+
         std::string Name = info->name;
         std::string IconName = info->IconName;
         std::string CastBarCaption = info->castBarCaption;
 
-        int loc_idx = GetSessionDbLocaleIndex();
         if (loc_idx >= 0)
         {
             GameObjectLocale const* gl = sObjectMgr.GetGameObjectLocale(entryID);
@@ -260,7 +292,7 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
         data << uint8(0);                                   // 2.0.3, string
         data.append(info->raw.data, 24);
         data << float(info->size);                          // go size
-        SendPacket(data);
+        SendPacket(QueryResponseCache::Add(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx, data)->GetPayload());
         DEBUG_LOG("WORLD: Sent SMSG_GAMEOBJECT_QUERY_RESPONSE");
     }
     else
@@ -0,0 +1,248 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_STABLEVECTOR_H
+#define MANGOS_STABLEVECTOR_H
+
+#include "Common.h"
+
+#include <iterator>
+#include <vector>
+
+/**
+ * Contiguous list of pointers that keeps the iteration guarantees of std::list.
+ * Elements added while iterating are visited like with a list, elements removed while iterating
+ * are only cleared and skipped, and every iterator stays valid until it is destroyed.
+ *
+ * The container counts its live iterators and closes the cleared slots once the last one is gone,
+ * so an aura handler may add or remove auras of the list its caller is walking.
+ */
+template<class T>
+class StableVector
+{
+    public:
+        class iterator
+        {
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef T* value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef T* const* pointer;
+                typedef T* const& reference;
+
+                iterator() : m_owner(nullptr), m_index(0) {}
+                iterator(StableVector const* owner, size_t index) : m_owner(owner), m_index(index) { Attach(); }
+                iterator(iterator const& other) : m_owner(other.m_owner), m_index(other.m_index) { Attach(); }
+                ~iterator() { Detach(); }
+
+                iterator& operator=(iterator const& other)
+                {
+                    if (m_owner != other.m_owner)
+                    {
+                        Detach();
+                        m_owner = other.m_owner;
+                        Attach();
+                    }
+                    m_index = other.m_index;
+                    return *this;
+                }
+
+                reference operator*() const { return m_owner->m_items[m_index]; }
+                pointer operator->() const { return &m_owner->m_items[m_index]; }
+
+                iterator& operator++()
+                {
+                    ++m_index;
+                    m_owner->SkipForward(m_index);
+                    return *this;
+                }
+
+                iterator operator++(int)
+                {
+                    iterator old(*this);
+                    ++*this;
+                    return old;
+                }
+
+                iterator& operator--()
+                {
+                    if (m_index == END_INDEX)
+                        m_index = m_owner->m_items.size();
+                    do
+                        --m_index;
+                    while (!m_owner->m_items[m_index]);
+                    return *this;
+                }
+
+                iterator operator--(int)
+                {
+                    iterator old(*this);
+                    --*this;
+                    return old;
+                }
+
+                // end() is a sentinel like the one of std::list, elements appended during a loop are still reached
+                bool operator==(iterator const& other) const { return Position() == other.Position(); }
+                bool operator!=(iterator const& other) const { return Position() != other.Position(); }
+
+            private:
+                friend class StableVector;
+
+                void Attach() { if (m_owner) ++m_owner->m_iterators; }
+                void Detach()
+                {
+                    if (m_owner && --m_owner->m_iterators == 0 && m_owner->m_cleared)
+                        const_cast<StableVector*>(m_owner)->Compact();
+                }
+
+                size_t Position() const { return m_index < m_owner->m_items.size() ? m_index : END_INDEX; }
+
+                StableVector const* m_owner;
+                size_t m_index;
+        };
+
+        typedef iterator const_iterator;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef reverse_iterator const_reverse_iterator;
+
+        StableVector() : m_size(0), m_cleared(0), m_iterators(0) {}
+        StableVector(StableVector const& other) : m_size(0), m_cleared(0), m_iterators(0) { *this = other; }
+
+        StableVector& operator=(StableVector const& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                m_items.reserve(other.m_size);
+                for (T* item : other.m_items)
+                    if (item)
+                        m_items.push_back(item);
+                m_size = m_items.size();
+            }
+            return *this;
+        }
+
+        iterator begin() const
+        {
+            size_t index = 0;
+            SkipForward(index);
+            return iterator(this, index);
+        }
+        iterator end() const { return iterator(this, END_INDEX); }
+        reverse_iterator rbegin() const { return reverse_iterator(end()); }
+        reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        T* front() const { return *begin(); }
+
+        void push_back(T* item)
+        {
+            m_items.push_back(item);
+            ++m_size;
+        }
+
+        // removes all occurrences of item
+        void remove(T* item)
+        {
+            for (size_t i = 0; i < m_items.size(); ++i)
+                if (m_items[i] == item)
+                    Clear(i);
+
+            if (!m_iterators && m_cleared)
+                Compact();
+        }
+
+        iterator erase(iterator itr)
+        {
+            size_t index = itr.Position();
+            Clear(index);
+            ++index;
+            SkipForward(index);
+            return iterator(this, index);
+        }
+
+        void clear()
+        {
+            if (m_iterators)
+            {
+                for (size_t i = 0; i < m_items.size(); ++i)
+                    if (m_items[i])
+                        Clear(i);
+                return;
+            }
+
+            m_items.clear();
+            m_size = 0;
+            m_cleared = 0;
+        }
+
+        // orders the items like std::stable_sort, as insertion sort because callers keep the list almost ordered
+        // cleared slots are moved behind the items and closed once no iterator is left
+        template<class Compare>
+        void sort(Compare comp)
+        {
+            for (size_t i = 1; i < m_items.size(); ++i)
+            {
+                T* item = m_items[i];
+                if (!item)
+                    continue;
+
+                size_t j = i;
+                for (; j > 0 && (!m_items[j - 1] || comp(item, m_items[j - 1])); --j)
+                    m_items[j] = m_items[j - 1];
+                m_items[j] = item;
+            }
+
+            if (!m_iterators && m_cleared)
+                Compact();
+        }
+
+    private:
+        static size_t const END_INDEX = size_t(-1);
+
+        void SkipForward(size_t& index) const
+        {
+            while (index < m_items.size() && !m_items[index])
+                ++index;
+        }
+
+        void Clear(size_t index)
+        {
+            m_items[index] = nullptr;
+            --m_size;
+            ++m_cleared;
+        }
+
+        void Compact()
+        {
+            size_t count = 0;
+            for (T* item : m_items)
+                if (item)
+                    m_items[count++] = item;
+            m_items.resize(count);
+            m_cleared = 0;
+        }
+
+        std::vector<T*> m_items;
+        size_t m_size;                                      // items not cleared
+        size_t m_cleared;                                   // cleared slots waiting for Compact
+        mutable uint32 m_iterators;                         // live iterators, slots can only be closed without any
+};
+
+#endif
@@ -34,6 +34,14 @@ bool Player::UpdateStats(Stats stat)
     if (stat > STAT_SPIRIT)
         return false;
 
+    UpdateStatValue(stat);
+    UpdateStatDependentBonuses();
+
+    return true;
+}
+
+void Player::UpdateStatValue(Stats stat)
+{
     // value = ((base_value * base_pct) + total_value) * total_pct
     float value  = GetTotalStatValue(stat);
 
@@ -69,6 +77,11 @@ bool Player::UpdateStats(Stats stat)
         default:
             break;
     }
+}
+
+// values depending on any stat
+void Player::UpdateStatDependentBonuses()
+{
     // Need update (exist AP from stat auras)
     UpdateAttackPowerAndDamage();
     UpdateAttackPowerAndDamage(true);
@@ -76,8 +89,30 @@ bool Player::UpdateStats(Stats stat)
     UpdateSpellHealingBonus();
     UpdateSpellDamageBonus();
     UpdateManaRegen();
+}
 
-    return true;
+void Player::UpdateModifiedStats(uint32 unitModMask)
+{
+    // several stats of a batch share one pass over the bonuses depending on all of them
+    bool statChanged = false;
+    for (int i = STAT_STRENGTH; i < MAX_STATS; ++i)
+    {
+        if (unitModMask & (1 << (UNIT_MOD_STAT_START + i)))
+        {
+            UpdateStatValue(Stats(i));
+            statChanged = true;
+        }
+    }
+
+    unitModMask &= ~(((1 << MAX_STATS) - 1) << UNIT_MOD_STAT_START);
+
+    if (statChanged)
+    {
+        UpdateStatDependentBonuses();
+        unitModMask &= ~((1 << UNIT_MOD_ATTACK_POWER) | (1 << UNIT_MOD_ATTACK_POWER_RANGED));
+    }
+
+    Unit::UpdateModifiedStats(unitModMask);
 }
 
 void Player::UpdateSpellHealingBonus()
@@ -21,6 +21,10 @@
 #include "Globals/ObjectMgr.h"
 #include "World/World.h"
 
+#include "ProgressBar.h"
+
+#include <map>
+#include <mutex>
 #include <sstream>
 
 /////////////////////////////////////////////////
@@ -31,6 +35,151 @@
 
 using namespace Taxi;
 
+// Itineraries of fresh rides by the path id and node range of each of their routes
+typedef std::map<std::vector<uint32>, std::shared_ptr<const Itinerary> > ItineraryMap;
+static ItineraryMap s_itineraries;
+static std::mutex s_itinerariesLock;
+
+// rides of unusual multi-route chains are resolved one by one past this
+#define MAX_CACHED_ITINERARIES 8192
+
+/// Build the itinerary of the routes, nullptr if a map spline of it is too short for a taxi
+static std::shared_ptr<Itinerary> BuildItinerary(const Roadmap& routes, Index nodeResume, size_t& resumeIndex)
+{
+    std::shared_ptr<Itinerary> itinerary = std::make_shared<Itinerary>();
+    Atlas& atlas = itinerary->atlas;
+
+    const Route& current = routes.front();
+
+    // Open a new map in the atlas
+    atlas.push_back(Taxi::Map());
+    // Start populating map(s)
+    const TaxiPathNodeEntry* prev = nullptr;
+    for (auto i = routes.begin(); i != routes.end(); ++i)
+    {
+        const TaxiPathNodeList& nodes = sTaxiPathNodesByPath[(*i).pathID];
+        for (auto j = nodes.begin(); j != nodes.end(); ++j)
+        {
+            // Abide route trimmed routes when building a spline
+            if ((*j)->index > (*i).nodeEnd || (*j)->index < (*i).nodeStart)
+                continue;
+
+            // Resume node defined: we are loading, additional care is required
+            if (nodeResume && (*i).pathID == current.pathID)
+            {
+                // Internal algorithm sanity check: make sure resume node for current route will end up on the same map
+                // Dont build spline for preceding nodes which are located on another map
+                if ((*j)->index < nodes[nodeResume]->index && (*j)->mapid != nodes[nodeResume]->mapid)
+                    continue;
+                // When resume node reached on the route: calculate resume location index on the spline (which will be equal to the current size on push)
+                if ((*j)->index == nodeResume)
+                    resumeIndex = atlas.back().size();
+            }
+            // Detect level change and insert a new map
+            if ((*j)->index >= (*i).nodeStart && (*j)->index <= (*i).nodeEnd)
+            {
+                if (prev && (*j)->mapid != prev->mapid)
+                {
+                    // Detect map change and advance atlas by adding a new map
+                    if (sMapStore.LookupEntry((*j)->mapid))
+                    {
+                        // Latest finished map spline is suspiciously short
+                        if (atlas.back().size() <= 2)
+                            return nullptr;
+                        atlas.push_back(Taxi::Map());
+                    }
+                    else
+                    {
+                        sLog.outError("TAXI: Malformed flight path node detected and ignored. Node %u on flight path id %u refers non-existent mapid %u",
+                                      (*j)->index, (*j)->path, (*j)->mapid);
+                        continue;
+                    }
+                }
+            }
+            // Add entry to the latest Map
+            atlas.back().push_back((*j));
+            if ((*j)->index > (*i).nodeStart)
+                prev = (*j);
+        }
+    }
+    // Latest finished map spline is suspiciously short
+    if (atlas.back().size() <= 2)
+        return nullptr;
+
+    for (auto i = atlas.begin(); i != atlas.end(); ++i)
+    {
+        itinerary->splines.push_back(Movement::PointsArray());
+        Movement::PointsArray& spline = itinerary->splines.back();
+        spline.reserve((*i).size());
+        for (auto j = (*i).begin(); j != (*i).end(); ++j)
+            spline.push_back(G3D::Vector3((*j)->x, (*j)->y, (*j)->z));
+    }
+
+    return itinerary;
+}
+
+static std::vector<uint32> GetItineraryKey(const Roadmap& routes)
+{
+    std::vector<uint32> key;
+    key.reserve(routes.size() * 3);
+    for (auto i = routes.begin(); i != routes.end(); ++i)
+    {
+        key.push_back((*i).pathID);
+        key.push_back((*i).nodeStart);
+        key.push_back((*i).nodeEnd);
+    }
+    return key;
+}
+
+/// Find the shared itinerary of a fresh ride, building it on the first flight of a multi-route chain
+static std::shared_ptr<const Itinerary> FindItinerary(const Roadmap& routes)
+{
+    std::vector<uint32> key = GetItineraryKey(routes);
+
+    std::lock_guard<std::mutex> guard(s_itinerariesLock);
+
+    ItineraryMap::const_iterator itr = s_itineraries.find(key);
+    if (itr != s_itineraries.end())
+        return itr->second;
+
+    size_t resumeIndex = 0;
+    std::shared_ptr<const Itinerary> itinerary = BuildItinerary(routes, 0, resumeIndex);
+    if (itinerary && s_itineraries.size() < MAX_CACHED_ITINERARIES)
+        s_itineraries[key] = itinerary;
+
+    return itinerary;
+}
+
+void Taxi::LoadItineraries()
+{
+    std::lock_guard<std::mutex> guard(s_itinerariesLock);
+
+    s_itineraries.clear();
+
+    BarGoLink bar(sTaxiPathStore.GetNumRows());
+
+    for (uint32 pathID = 0; pathID < sTaxiPathStore.GetNumRows(); ++pathID)
+    {
+        bar.step();
+
+        TaxiPathEntry const* entry = sTaxiPathStore.LookupEntry(pathID);
+        if (!entry || pathID >= sTaxiPathNodesByPath.size() || sTaxiPathNodesByPath[pathID].empty())
+            continue;
+
+        // Same route as Tracker::AddRoute makes for a single flight
+        TaxiPathNodeList const& nodes = sTaxiPathNodesByPath[pathID];
+        Roadmap routes;
+        routes.push_back(Route(entry->ID, entry->from, entry->to, nodes.front()->index, nodes.back()->index, 0));
+
+        size_t resumeIndex = 0;
+        if (std::shared_ptr<const Itinerary> itinerary = BuildItinerary(routes, 0, resumeIndex))
+            s_itineraries[GetItineraryKey(routes)] = itinerary;
+    }
+
+    sLog.outString(">> Resolved " SIZEFMTD " taxi flight path splines", s_itineraries.size());
+    sLog.outString();
+}
+
 std::string Tracker::Save()
 {
     // Writes in modified format.
@@ -43,7 +192,7 @@ std::string Tracker::Save()
         return "";
 
     // Bugcheck: container continuity error
-    MANGOS_ASSERT(!m_routes.empty() && !m_atlas.empty());
+    MANGOS_ASSERT(!m_routes.empty() && !IsAtlasEmpty());
 
     std::ostringstream stream;
 
@@ -239,62 +388,17 @@ bool Tracker::Prepare(Index nodeResume /*= 0*/)
     // Sanity check: make sure that resume node for current route hasn't gotten cut off or out of bounds
     nodeResume = std::min(nodeResume, current.nodeEnd);
 
-    m_atlas.clear();
-    // Open a new map in the atlas
-    m_atlas.push_back(Map());
-    // Start populating map(s)
-    const TaxiPathNodeEntry* prev = nullptr;
-    for (auto i = m_routes.begin(); i != m_routes.end(); ++i)
-    {
-        const TaxiPathNodeList& nodes = sTaxiPathNodesByPath[(*i).pathID];
-        for (auto j = nodes.begin(); j != nodes.end(); ++j)
-        {
-            // Abide route trimmed routes when building a spline
-            if ((*j)->index > (*i).nodeEnd || (*j)->index < (*i).nodeStart)
-                continue;
+    // Resumed rides start mid-route, only fresh ones share their itinerary
+    if (nodeResume)
+        m_itinerary = BuildItinerary(m_routes, nodeResume, m_resumeIndex);
+    else
+        m_itinerary = FindItinerary(m_routes);
 
-            // Resume node defined: we are loading, additional care is required
-            if (nodeResume && (*i).pathID == current.pathID)
-            {
-                // Internal algorithm sanity check: make sure resume node for current route will end up on the same map
-                // Dont build spline for preceding nodes which are located on another map
-                if ((*j)->index < nodes[nodeResume]->index && (*j)->mapid != nodes[nodeResume]->mapid)
-                    continue;
-                // When resume node reached on the route: calculate resume location index on the spline (which will be equal to the current size on push)
-                if ((*j)->index == nodeResume)
-                {
-                    m_resumeIndex = m_atlas.back().size();
-                    m_locationIndex = m_resumeIndex;
-                }
-            }
-            // Detect level change and insert a new map
-            if ((*j)->index >= (*i).nodeStart && (*j)->index <= (*i).nodeEnd)
-            {
-                if (prev && (*j)->mapid != prev->mapid)
-                {
-                    // Detect map change and advance atlas by adding a new map
-                    if (sMapStore.LookupEntry((*j)->mapid))
-                    {
-                        // Bugcheck: latest finished map spline is suspiciously short
-                        MANGOS_ASSERT(m_atlas.back().size() > 2);
-                        m_atlas.push_back(Map());
-                    }
-                    else
-                    {
-                        sLog.outError("TAXI: Malformed flight path node detected and ignored. Node %u on flight path id %u refers non-existent mapid %u",
-                                      (*j)->index, (*j)->path, (*j)->mapid);
-                        continue;
-                    }
-                }
-            }
-            // Add entry to the latest Map
-            m_atlas.back().push_back((*j));
-            if ((*j)->index > (*i).nodeStart)
-                prev = (*j);
-        }
-    }
     // Bugcheck: latest finished map spline is suspiciously short
-    MANGOS_ASSERT(m_atlas.back().size() > 2);
+    MANGOS_ASSERT(m_itinerary);
+
+    m_mapIndex = 0;
+    m_locationIndex = m_resumeIndex;
 
     m_state = TRACKER_STANDBY;
     return true;
@@ -308,7 +412,8 @@ bool Tracker::Clear(bool forced)
     m_routes.clear();
     m_cost = 0;
     m_displayId = 0;
-    m_atlas.clear();
+    m_itinerary.reset();
+    m_mapIndex = 0;
     m_location = nullptr;
     m_locationIndex = 0;
     m_resumeIndex = 0;
@@ -326,7 +431,7 @@ bool Tracker::UpdateRoute(const TaxiPathNodeEntry* entry, PathID& start, PathID&
         return false;
 
     // Bugcheck: continuity error - either routes or splines are missing
-    MANGOS_ASSERT(!m_atlas.empty() && !m_routes.empty())
+    MANGOS_ASSERT(!IsAtlasEmpty() && !m_routes.empty())
 
     const Map& map = GetMap();
 
@@ -344,9 +449,9 @@ bool Tracker::UpdateRoute(const TaxiPathNodeEntry* entry, PathID& start, PathID&
 
     if (entry == map.back())
     {
-        // Acknowledge spline end: nuke current map in the atlas, reset location index
+        // Acknowledge spline end: advance to the next map in the atlas, reset location index
         // That does not mean, however, that taxi ride was completed right away, as it can be a multimap flight route
-        m_atlas.pop_front();
+        ++m_mapIndex;
         m_location = nullptr;
         m_locationIndex = 0;
         m_resumeIndex = 0;
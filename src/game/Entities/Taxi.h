@@ -20,9 +20,11 @@
 #define _TAXI_H
 
 #include "Server/DBCStores.h"
+#include "Movement/MoveSplineInitArgs.h"
 
 #include <string>
 #include <deque>
+#include <memory>
 
 /////////////////////////////////////////////////
 /// @file       Taxi.h
@@ -62,6 +64,16 @@ namespace Taxi
     /// Atlas contains one or more Maps in a sequential order
     typedef std::deque<Map> Atlas;
 
+    /// Itinerary is a Roadmap resolved into its Atlas and the spline points of every Map, immutable once built and shared between rides
+    struct Itinerary
+    {
+        Atlas atlas;
+        std::deque<Movement::PointsArray> splines;  // Positions of the waypoints of each Map in the atlas
+    };
+
+    /// Resolve the Itinerary of every taxi flight path at startup, multi-route rides are resolved on their first flight
+    void LoadItineraries();
+
     enum TrackerState
     {
         TRACKER_EMPTY    = 0, // Container is empty
@@ -76,7 +88,7 @@ namespace Taxi
     {
         public:
             explicit Tracker(Player& owner) :
-                m_owner(owner), m_state(TRACKER_EMPTY), m_cost(0), m_displayId(0), m_location(nullptr), m_locationIndex(0), m_resumeIndex(0), m_debug(false) {}
+                m_owner(owner), m_state(TRACKER_EMPTY), m_cost(0), m_displayId(0), m_location(nullptr), m_locationIndex(0), m_resumeIndex(0), m_mapIndex(0), m_debug(false) {}
 
             // Disable funny ctors
             Tracker(Tracker const&) = delete;
@@ -98,9 +110,11 @@ namespace Taxi
             /// Get all pre-calculated routes
             const Roadmap& GetRoadmap() const { return m_routes; }
             /// Get the current spline for the map
-            const Map& GetMap() const { return m_atlas.front(); }
-            /// Get a collection of splines for the entire ride
-            const Atlas& GetAtlas() const { return m_atlas; }
+            const Map& GetMap() const { return m_itinerary->atlas[m_mapIndex]; }
+            /// Get the spline points of the current map
+            const Movement::PointsArray& GetSpline() const { return m_itinerary->splines[m_mapIndex]; }
+            /// Check if the splines for the entire ride are all flown or not prepared
+            bool IsAtlasEmpty() const { return !m_itinerary || m_mapIndex >= m_itinerary->atlas.size(); }
 
             /// Get cost of the current route
             uint32 GetCost() const { return (!m_routes.empty() ? m_routes.front().cost : 0); }
@@ -147,7 +161,8 @@ namespace Taxi
             size_t m_locationIndex;
             size_t m_resumeIndex;
             Roadmap m_routes;
-            Atlas m_atlas;
+            std::shared_ptr<const Itinerary> m_itinerary;
+            size_t m_mapIndex;      // Current map of the itinerary
 
         public:
             bool m_debug;
@@ -20,6 +20,7 @@
 #define MANGOSSERVER_TEMPSPAWN_H
 
 #include "Entities/Creature.h"
+#include "Entities/EntityPool.h"
 #include "Globals/ObjectAccessor.h"
 
 class TemporarySpawn : public Creature
@@ -28,6 +29,10 @@ class TemporarySpawn : public Creature
         explicit TemporarySpawn(ObjectGuid summoner = ObjectGuid());
         virtual ~TemporarySpawn() {};
 
+        // summons are created and removed constantly, their memory is recycled by EntityPool
+        void* operator new(size_t size) { return EntityPool::Allocate(ENTITY_POOL_TEMPSPAWN, size); }
+        void operator delete(void* block, size_t size) { EntityPool::Release(ENTITY_POOL_TEMPSPAWN, block, size); }
+
         void Update(const uint32 diff) override;
         void SetSummonProperties(TempSpawnType type, uint32 lifetime);
         void Summon(TempSpawnType type, uint32 lifetime);
@@ -20,6 +20,7 @@
 #define MANGOSSERVER_TOTEM_H
 
 #include "Entities/Creature.h"
+#include "Entities/EntityPool.h"
 
 enum TotemType
 {
@@ -33,6 +34,11 @@ class Totem : public Creature
     public:
         explicit Totem();
         virtual ~Totem() {}
+
+        // totems are created and removed with every cast, their memory is recycled by EntityPool
+        void* operator new(size_t size) { return EntityPool::Allocate(ENTITY_POOL_TOTEM, size); }
+        void operator delete(void* block, size_t size) { EntityPool::Release(ENTITY_POOL_TOTEM, block, size); }
+
         bool Create(uint32 guidlow, CreatureCreatePos& cPos, CreatureInfo const* cinfo, Unit* owner);
         void Update(const uint32 diff) override;
         void Summon(Unit* owner);
@@ -110,6 +110,7 @@ void MapManager::LoadTransports()
 
         // If we someday decide to use the grid to track transports, here:
         t->SetMap(sMapMgr.CreateMap(mapid, t));
+        t->GetMap()->AddTransport(t);
 
         // t->GetMap()->Add<GameObject>((GameObject *)t);
         ++count;
@@ -435,7 +436,7 @@ void Transport::MoveToNextWayPoint()
 
 void Transport::TeleportTransport(uint32 newMapid, float x, float y, float z)
 {
-    Map const* oldMap = GetMap();
+    Map* oldMap = GetMap();
     Relocate(x, y, z);
 
     for (PlayerSet::iterator itr = m_passengers.begin(); itr != m_passengers.end();)
@@ -465,13 +466,19 @@ void Transport::TeleportTransport(uint32 newMapid, float x, float y, float z)
     // player far teleport would try to create same instance, but we need it NOW for transport...
     // correct me if I'm wrong O.o
     Map* newMap = sMapMgr.CreateMap(newMapid, this);
-    SetMap(newMap);
+    if (oldMap == newMap)
+        return;
 
-    if (oldMap != newMap)
+    // the new map can be updated by another thread right now, it takes the transport over when it handles its messages
+    // until then no map updates the transport
+    UpdateForMap(oldMap);
+    oldMap->RemoveTransport(this);
+    newMap->AddMessage([this](Map* map)
     {
-        UpdateForMap(oldMap);
-        UpdateForMap(newMap);
-    }
+        SetMap(map);
+        map->AddTransport(this);
+        UpdateForMap(map);
+    });
 }
 
 bool Transport::AddPassenger(Player* passenger)
@@ -505,8 +512,11 @@ void Transport::Update(const uint32 /*diff*/)
 
         DoEventIfAny(*m_curr, false);
 
+        // the map of the next waypoint continues the path once it took the transport over
+        bool const mapChange = m_curr->second.mapid != GetMapId();
+
         // first check help in case client-server transport coordinates de-synchronization
-        if (m_curr->second.mapid != GetMapId() || m_curr->second.teleport)
+        if (mapChange || m_curr->second.teleport)
         {
             TeleportTransport(m_curr->second.mapid, m_curr->second.x, m_curr->second.y, m_curr->second.z);
         }
@@ -530,6 +540,9 @@ void Transport::Update(const uint32 /*diff*/)
             DETAIL_FILTER_LOG(LOG_FILTER_TRANSPORT_MOVES, " ************ BEGIN ************** %s", GetName());
 
         DETAIL_FILTER_LOG(LOG_FILTER_TRANSPORT_MOVES, "%s moved to %f %f %f %d", GetName(), m_curr->second.x, m_curr->second.y, m_curr->second.z, m_curr->second.mapid);
+
+        if (mapChange)
+            break;
     }
 }
 
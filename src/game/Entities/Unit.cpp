@@ -32,6 +32,7 @@
 #include "Spells/SpellAuras.h"
 #include "Globals/ObjectAccessor.h"
 #include "AI/CreatureAISelector.h"
+#include "AI/ScriptDevAI/ScriptProfiler.h"
 #include "Entities/TemporarySpawn.h"
 #include "Entities/Pet.h"
 #include "Util.h"
@@ -328,18 +329,31 @@ Unit::Unit() :
         m_currentSpell = nullptr;
 
     m_castCounter = 0;
+    m_movementHeartbeatCount = 0;
+    m_pendingCombatLogAge = 0;
 
     // m_Aura = nullptr;
     // m_AurasCheck = 2000;
     // m_removeAuraTimer = 4;
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
+    m_procHoldersMask = 0;
+    m_auraUpdatePending = 0;
+    m_auraUpdateDelay = 0;
     m_AuraFlags = 0;
 
     m_Visibility = VISIBILITY_ON;
     m_AINotifyEvent = nullptr;
+    m_visibilityNotifyEvent = nullptr;
+
+    m_spatialHash = nullptr;
+    m_spatialBucketX = 0;
+    m_spatialBucketY = 0;
+    m_spatialIndex = 0;
 
     m_transform = 0;
     m_canModifyStats = false;
+    m_statUpdateBatchDepth = 0;
+    m_pendingStatUpdateMask = 0;
 
     for (auto& i : m_spellImmune)
         i.clear();
@@ -474,7 +488,10 @@ void Unit::Update(const uint32 diff)
     i_motionMaster.UpdateMotion(diff);
 
     if (AI() && isAlive())
+    {
+        ScriptProfiler::Scope profile(SCRIPT_PROFILE_UPDATE_AI, AI()->GetScriptId());
         AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map)
+    }
 
     GetCombatManager().Update(diff);
 
@@ -483,6 +500,14 @@ void Unit::Update(const uint32 diff)
         ModifyAuraState(AURA_STATE_HEALTHLESS_20_PERCENT, GetHealth() < GetMaxHealth() * 0.20f);
         ModifyAuraState(AURA_STATE_HEALTHLESS_35_PERCENT, GetHealth() < GetMaxHealth() * 0.35f);
     }
+
+    if (!m_pendingCombatLog.empty())
+    {
+        if (m_pendingCombatLogAge >= sWorld.getConfig(CONFIG_UINT32_COMBAT_LOG_COALESCE_MAX_DELAY))
+            FlushCombatLog();
+        else
+            m_pendingCombatLogAge += diff;
+    }
 }
 
 void Unit::AddCooldown(SpellEntry const& spellEntry, ItemPrototype const* /*itemProto*/, bool /*permanent*/, uint32 forcedDuration)
@@ -641,6 +666,27 @@ void Unit::SendHeartBeat()
     SendMessageToSet(data, true);
 }
 
+void Unit::SendMovementHeartbeatToSet(WorldPacket const& data, Player const* skipped_receiver)
+{
+    if (!IsInWorld())
+        return;
+
+    float fullRateDist = sWorld.getConfig(CONFIG_FLOAT_MOVEMENT_LOD_RADIUS);
+    uint32 interval = sWorld.getConfig(CONFIG_UINT32_MOVEMENT_LOD_HEARTBEAT_INTERVAL);
+    if (fullRateDist <= 0.0f || interval <= 1)
+    {
+        SendMessageToSetExcept(data, skipped_receiver);
+        return;
+    }
+
+    // distant viewers only need to follow the rough path, start and stop packets still reach them right away
+    bool toDistant = ++m_movementHeartbeatCount % interval == 0;
+
+    MaNGOS::MovementHeartbeatDeliverer notifier(*this, data, skipped_receiver, fullRateDist, toDistant);
+    Cell::VisitWorldObjects(this, notifier, GetMap()->GetVisibilityDistance());
+    GetMap()->AddMovementHeartbeatStats(notifier.i_sent, notifier.i_suppressed);
+}
+
 void Unit::SendMoveRoot(bool state, bool broadcastOnly)
 {
     const Player* player = GetClientControlling();
@@ -1255,7 +1301,10 @@ void Unit::JustKilledCreature(Unit* killer, Creature* victim, Player* responsibl
     /* ******************************* Inform various hooks ************************************ */
     // Inform victim's AI
     if (victim->AI())
+    {
+        ScriptProfiler::Scope profile(SCRIPT_PROFILE_JUST_DIED, victim->AI()->GetScriptId());
         victim->AI()->JustDied(killer);
+    }
 
     // Inform Owner
     Unit* pOwner = victim->GetMaster();
@@ -2342,6 +2391,7 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* caster, SpellSchoolMask schoolMa
         mod->m_amount -= currentAbsorb;
         if ((*i)->GetHolder()->DropAuraCharge())
             mod->m_amount = 0;
+        InvalidateAuraModifierCache(mod->m_auraname);
         // Need remove it later
         if (mod->m_amount <= 0)
             existExpired = true;
@@ -2400,6 +2450,7 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* caster, SpellSchoolMask schoolMa
         (*i)->OnManaAbsorb(currentAbsorb);
 
         (*i)->GetModifier()->m_amount -= currentAbsorb;
+        InvalidateAuraModifierCache((*i)->GetModifier()->m_auraname);
         if ((*i)->GetModifier()->m_amount <= 0)
         {
             RemoveAurasDueToSpell((*i)->GetId());
@@ -4118,13 +4169,23 @@ void Unit::_UpdateSpells(uint32 time)
         }
     }
 
-    // update auras
+    // update auras only when a timer of one of them runs out, they get all the time passed since their last update
+    m_auraUpdatePending += time;
+    if (m_auraUpdatePending < m_auraUpdateDelay)
+        return;
+
+    uint32 diff = m_auraUpdatePending;
+    m_auraUpdatePending = 0;
+    m_auraUpdateDelay = UINT32_MAX;                         // lowered by the holders, or reset to 0 by ResyncAuraUpdates during the update
+
     // m_AurasUpdateIterator can be updated in inderect called code at aura remove to skip next planned to update but removed auras
     for (m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.begin(); m_spellAuraHoldersUpdateIterator != m_spellAuraHolders.end();)
     {
         SpellAuraHolder* i_holder = m_spellAuraHoldersUpdateIterator->second;
         ++m_spellAuraHoldersUpdateIterator;                 // need shift to next for allow update if need into aura update
-        i_holder->UpdateHolder(time);
+        i_holder->UpdateHolder(diff);
+        if (!i_holder->IsDeleted())
+            m_auraUpdateDelay = std::min(m_auraUpdateDelay, i_holder->GetUpdateDelay());
     }
 
     // remove expired auras
@@ -4142,6 +4203,20 @@ void Unit::_UpdateSpells(uint32 time)
     }
 }
 
+void Unit::ResyncAuraUpdates()
+{
+    // no timer runs out within the pending time, so the holders only count down
+    if (m_auraUpdatePending)
+    {
+        uint32 diff = m_auraUpdatePending;
+        m_auraUpdatePending = 0;
+        for (auto& itr : m_spellAuraHolders)
+            itr.second->UpdateHolder(diff);
+    }
+
+    m_auraUpdateDelay = 0;
+}
+
 void Unit::_UpdateAutoRepeatSpell()
 {
     // check "real time" interrupts
@@ -4449,50 +4524,90 @@ void Unit::DeMorph()
     SetDisplayId(GetNativeDisplayId());
 }
 
+Unit::AuraModifierCacheStats Unit::m_auraModifierCacheStats;
+
+template<typename T, class Calculator>
+T Unit::GetCachedAuraModifier(AuraType auratype, AuraModifierCacheKind kind, uint32 misc, Calculator calculate) const
+{
+    AuraList const& auras = GetAurasByType(auratype);
+    if (auras.size() < AURA_MODIFIER_CACHE_MIN_AURAS)
+        return calculate(auras);
+
+    uint64 key = MakeAuraModifierCacheKey(auratype, kind, misc);
+    auto itr = m_auraModifierCache.find(key);
+    if (itr != m_auraModifierCache.end())
+    {
+        m_auraModifierCacheStats.hits.fetch_add(1, std::memory_order_relaxed);
+        return T(itr->second);
+    }
+
+    m_auraModifierCacheStats.misses.fetch_add(1, std::memory_order_relaxed);
+    T result = calculate(auras);
+    m_auraModifierCache.emplace(key, double(result));
+    return result;
+}
+
+void Unit::InvalidateAuraModifierCache(AuraType auratype)
+{
+    if (m_auraModifierCache.empty())
+        return;
+
+    m_auraModifierCache.erase(m_auraModifierCache.lower_bound(MakeAuraModifierCacheKey(auratype, AuraModifierCacheKind(0), 0)),
+                              m_auraModifierCache.lower_bound(MakeAuraModifierCacheKey(AuraType(auratype + 1), AuraModifierCacheKind(0), 0)));
+}
+
 int32 Unit::GetTotalAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
+    return GetCachedAuraModifier<int32>(auratype, AURA_MODIFIER_TOTAL, 0, [](AuraList const& mTotalAuraList)
+    {
+        int32 modifier = 0;
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        modifier += i->GetModifier()->m_amount;
+        for (auto i : mTotalAuraList)
+            modifier += i->GetModifier()->m_amount;
 
-    return modifier;
+        return modifier;
+    });
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
-    float multiplier = 1.0f;
+    return GetCachedAuraModifier<float>(auratype, AURA_MULTIPLIER_TOTAL, 0, [](AuraList const& mTotalAuraList)
+    {
+        float multiplier = 1.0f;
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        multiplier *= (100.0f + i->GetModifier()->m_amount) / 100.0f;
+        for (auto i : mTotalAuraList)
+            multiplier *= (100.0f + i->GetModifier()->m_amount) / 100.0f;
 
-    return multiplier;
+        return multiplier;
+    });
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
+    return GetCachedAuraModifier<int32>(auratype, AURA_MODIFIER_MAX_POSITIVE, 0, [](AuraList const& mTotalAuraList)
+    {
+        int32 modifier = 0;
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        if (i->GetModifier()->m_amount > modifier)
-            modifier = i->GetModifier()->m_amount;
+        for (auto i : mTotalAuraList)
+            if (i->GetModifier()->m_amount > modifier)
+                modifier = i->GetModifier()->m_amount;
 
-    return modifier;
+        return modifier;
+    });
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
+    return GetCachedAuraModifier<int32>(auratype, AURA_MODIFIER_MAX_NEGATIVE, 0, [](AuraList const& mTotalAuraList)
+    {
+        int32 modifier = 0;
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        if (i->GetModifier()->m_amount < modifier)
-            modifier = i->GetModifier()->m_amount;
+        for (auto i : mTotalAuraList)
+            if (i->GetModifier()->m_amount < modifier)
+                modifier = i->GetModifier()->m_amount;
 
-    return modifier;
+        return modifier;
+    });
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -4500,16 +4615,18 @@ int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask)
     if (!misc_mask)
         return 0;
 
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
+    return GetCachedAuraModifier<int32>(auratype, AURA_MODIFIER_TOTAL_BY_MASK, misc_mask, [misc_mask](AuraList const& mTotalAuraList)
     {
-        Modifier* mod = i->GetModifier();
-        if (mod->m_miscvalue & misc_mask)
-            modifier += mod->m_amount;
-    }
-    return modifier;
+        int32 modifier = 0;
+
+        for (auto i : mTotalAuraList)
+        {
+            Modifier* mod = i->GetModifier();
+            if (mod->m_miscvalue & misc_mask)
+                modifier += mod->m_amount;
+        }
+        return modifier;
+    });
 }
 
 float Unit::GetTotalAuraMultiplierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -4517,16 +4634,18 @@ float Unit::GetTotalAuraMultiplierByMiscMask(AuraType auratype, uint32 misc_mask
     if (!misc_mask)
         return 1.0f;
 
-    float multiplier = 1.0f;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
+    return GetCachedAuraModifier<float>(auratype, AURA_MULTIPLIER_TOTAL_BY_MASK, misc_mask, [misc_mask](AuraList const& mTotalAuraList)
     {
-        Modifier* mod = i->GetModifier();
-        if (mod->m_miscvalue & misc_mask)
-            multiplier *= (100.0f + mod->m_amount) / 100.0f;
-    }
-    return multiplier;
+        float multiplier = 1.0f;
+
+        for (auto i : mTotalAuraList)
+        {
+            Modifier* mod = i->GetModifier();
+            if (mod->m_miscvalue & misc_mask)
+                multiplier *= (100.0f + mod->m_amount) / 100.0f;
+        }
+        return multiplier;
+    });
 }
 
 int32 Unit::GetMaxPositiveAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -4534,17 +4653,19 @@ int32 Unit::GetMaxPositiveAuraModifierByMiscMask(AuraType auratype, uint32 misc_
     if (!misc_mask)
         return 0;
 
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
+    return GetCachedAuraModifier<int32>(auratype, AURA_MODIFIER_MAX_POSITIVE_BY_MASK, misc_mask, [misc_mask](AuraList const& mTotalAuraList)
     {
-        Modifier* mod = i->GetModifier();
-        if (mod->m_miscvalue & misc_mask && mod->m_amount > modifier)
-            modifier = mod->m_amount;
-    }
+        int32 modifier = 0;
+
+        for (auto i : mTotalAuraList)
+        {
+            Modifier* mod = i->GetModifier();
+            if (mod->m_miscvalue & misc_mask && mod->m_amount > modifier)
+                modifier = mod->m_amount;
+        }
 
-    return modifier;
+        return modifier;
+    });
 }
 
 int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -4552,75 +4673,85 @@ int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auratype, uint32 misc_
     if (!misc_mask)
         return 0;
 
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
+    return GetCachedAuraModifier<int32>(auratype, AURA_MODIFIER_MAX_NEGATIVE_BY_MASK, misc_mask, [misc_mask](AuraList const& mTotalAuraList)
     {
-        Modifier* mod = i->GetModifier();
-        if (mod->m_miscvalue & misc_mask && mod->m_amount < modifier)
-            modifier = mod->m_amount;
-    }
+        int32 modifier = 0;
+
+        for (auto i : mTotalAuraList)
+        {
+            Modifier* mod = i->GetModifier();
+            if (mod->m_miscvalue & misc_mask && mod->m_amount < modifier)
+                modifier = mod->m_amount;
+        }
 
-    return modifier;
+        return modifier;
+    });
 }
 
 int32 Unit::GetTotalAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
+    return GetCachedAuraModifier<int32>(auratype, AURA_MODIFIER_TOTAL_BY_VALUE, uint32(misc_value), [misc_value](AuraList const& mTotalAuraList)
     {
-        Modifier* mod = i->GetModifier();
-        if (mod->m_miscvalue == misc_value)
-            modifier += mod->m_amount;
-    }
-    return modifier;
+        int32 modifier = 0;
+
+        for (auto i : mTotalAuraList)
+        {
+            Modifier* mod = i->GetModifier();
+            if (mod->m_miscvalue == misc_value)
+                modifier += mod->m_amount;
+        }
+        return modifier;
+    });
 }
 
 float Unit::GetTotalAuraMultiplierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    float multiplier = 1.0f;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
+    return GetCachedAuraModifier<float>(auratype, AURA_MULTIPLIER_TOTAL_BY_VALUE, uint32(misc_value), [misc_value](AuraList const& mTotalAuraList)
     {
-        Modifier* mod = i->GetModifier();
-        if (mod->m_miscvalue == misc_value)
-            multiplier *= (100.0f + mod->m_amount) / 100.0f;
-    }
-    return multiplier;
+        float multiplier = 1.0f;
+
+        for (auto i : mTotalAuraList)
+        {
+            Modifier* mod = i->GetModifier();
+            if (mod->m_miscvalue == misc_value)
+                multiplier *= (100.0f + mod->m_amount) / 100.0f;
+        }
+        return multiplier;
+    });
 }
 
 int32 Unit::GetMaxPositiveAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
+    return GetCachedAuraModifier<int32>(auratype, AURA_MODIFIER_MAX_POSITIVE_BY_VALUE, uint32(misc_value), [misc_value](AuraList const& mTotalAuraList)
     {
-        Modifier* mod = i->GetModifier();
-        if (mod->m_miscvalue == misc_value && mod->m_amount > modifier)
-            modifier = mod->m_amount;
-    }
+        int32 modifier = 0;
+
+        for (auto i : mTotalAuraList)
+        {
+            Modifier* mod = i->GetModifier();
+            if (mod->m_miscvalue == misc_value && mod->m_amount > modifier)
+                modifier = mod->m_amount;
+        }
 
-    return modifier;
+        return modifier;
+    });
 }
 
 int32 Unit::GetMaxNegativeAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
+    return GetCachedAuraModifier<int32>(auratype, AURA_MODIFIER_MAX_NEGATIVE_BY_VALUE, uint32(misc_value), [misc_value](AuraList const& mTotalAuraList)
     {
-        Modifier* mod = i->GetModifier();
-        if (mod->m_miscvalue == misc_value && mod->m_amount < modifier)
-            modifier = mod->m_amount;
-    }
+        int32 modifier = 0;
+
+        for (auto i : mTotalAuraList)
+        {
+            Modifier* mod = i->GetModifier();
+            if (mod->m_miscvalue == misc_value && mod->m_amount < modifier)
+                modifier = mod->m_amount;
+        }
 
-    return modifier;
+        return modifier;
+    });
 }
 
 bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
@@ -4785,7 +4916,9 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     holder->_AddSpellAuraHolder();
     if (m_spellUpdateHappening)
         holder->SetCreationDelayFlag();
+    ResyncAuraUpdates();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    AddProcHolder(holder);
 
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
@@ -4805,7 +4938,10 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
 void Unit::AddAuraToModList(Aura* aura)
 {
     if (aura->GetModifier()->m_auraname < TOTAL_AURAS)
+    {
         m_modAuras[aura->GetModifier()->m_auraname].push_back(aura);
+        InvalidateAuraModifierCache(aura->GetModifier()->m_auraname);
+    }
 }
 
 void Unit::RemoveRankAurasDueToSpell(uint32 spellId)
@@ -5319,6 +5455,7 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
             break;
         }
     }
+    RemoveProcHolder(holder);
 
     holder->SetRemoveMode(mode);
     holder->UnregisterAndCleanupTrackedAuras();
@@ -5367,6 +5504,7 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        InvalidateAuraModifierCache(Aur->GetModifier()->m_auraname);
     }
 
     // Set remove mode
@@ -5805,7 +5943,7 @@ void Unit::SendSpellNonMeleeDamageLog(SpellNonMeleeDamage* log) const
         }
     }
 
-    SendMessageToSet(data, true);
+    SendCombatLogMessage(data);
 }
 
 void Unit::SendSpellNonMeleeDamageLog(Unit* target, uint32 spellID, uint32 damage, SpellSchoolMask damageSchoolMask, uint32 absorbedDamage, int32 resist, bool isPeriodic, uint32 blocked, bool criticalHit, bool split)
@@ -5865,7 +6003,7 @@ void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo) const
             return;
     }
 
-    aura->GetTarget()->SendMessageToSet(data, true);
+    aura->GetTarget()->SendCombatLogMessage(data);
 }
 
 void Unit::SendSpellMiss(Unit* target, uint32 spellID, SpellMissInfo missInfo) const
@@ -5879,7 +6017,7 @@ void Unit::SendSpellMiss(Unit* target, uint32 spellID, SpellMissInfo missInfo) c
     data << target->GetObjectGuid();                        // target GUID
     data << uint8(missInfo);
     // end loop
-    SendMessageToSet(data, true);
+    SendCombatLogMessage(data);
 }
 
 void Unit::SendSpellDamageResist(Unit* target, uint32 spellId) const
@@ -6909,7 +7047,39 @@ void Unit::SendHealSpellLog(Unit* pVictim, uint32 SpellID, uint32 Damage, bool c
     data << uint32(Damage);
     data << uint8(critical ? 1 : 0);
     data << uint8(0);                                       // unused in client?
-    SendMessageToSet(data, true);
+    SendCombatLogMessage(data);
+}
+
+void Unit::SendCombatLogMessage(WorldPacket const& data) const
+{
+    if (!IsInWorld() || !sWorld.getConfig(CONFIG_BOOL_COMBAT_LOG_COALESCE))
+    {
+        SendMessageToSet(data, true);
+        return;
+    }
+
+    if (m_pendingCombatLog.empty())
+        m_pendingCombatLogAge = 0;
+
+    m_pendingCombatLog.push_back(data);
+}
+
+void Unit::FlushCombatLog() const
+{
+    if (m_pendingCombatLog.empty())
+        return;
+
+    if (IsInWorld())
+    {
+        // like Player::SendMessageToSet the player gets its own logs even while its camera is elsewhere
+        Player const* player = GetTypeId() == TYPEID_PLAYER ? static_cast<Player const*>(this) : nullptr;
+        GetMap()->MessageBroadcast(this, m_pendingCombatLog, player);
+        if (player)
+            for (WorldPacket const& data : m_pendingCombatLog)
+                player->GetSession()->SendPacket(data);
+    }
+
+    m_pendingCombatLog.clear();
 }
 
 void Unit::SendEnergizeSpellLog(Unit* pVictim, uint32 SpellID, uint32 Damage, Powers powertype) const
@@ -6920,7 +7090,7 @@ void Unit::SendEnergizeSpellLog(Unit* pVictim, uint32 SpellID, uint32 Damage, Po
     data << uint32(SpellID);
     data << uint32(powertype);
     data << uint32(Damage);
-    SendMessageToSet(data, true);
+    SendCombatLogMessage(data);
 }
 
 void Unit::SendEnvironmentalDamageLog(uint8 type, uint32 damage, uint32 absorb, int32 resist) const
@@ -8507,6 +8677,7 @@ void Unit::UpdateVisibilityAndView()
             if (!owner || !IsVisibleForOrDetect(owner, this, false))
             {
                 alist.erase(it);
+                InvalidateAuraModifierCache(*type);
                 RemoveAura(aura);
                 it = alist.begin();
             }
@@ -9189,6 +9360,37 @@ bool Unit::HandleStatModifier(UnitMods unitMod, UnitModifierType modifierType, f
     if (!CanModifyStats())
         return false;
 
+    if (m_statUpdateBatchDepth)
+        m_pendingStatUpdateMask |= 1 << unitMod;
+    else
+        UpdateStatsForModifier(unitMod);
+
+    return true;
+}
+
+void Unit::EndStatUpdateBatch()
+{
+    MANGOS_ASSERT(m_statUpdateBatchDepth);
+
+    if (--m_statUpdateBatchDepth || !m_pendingStatUpdateMask)
+        return;
+
+    uint32 unitModMask = m_pendingStatUpdateMask;
+    m_pendingStatUpdateMask = 0;
+
+    if (CanModifyStats())
+        UpdateModifiedStats(unitModMask);
+}
+
+void Unit::UpdateModifiedStats(uint32 unitModMask)
+{
+    for (uint32 i = 0; i < UNIT_MOD_END; ++i)
+        if (unitModMask & (1 << i))
+            UpdateStatsForModifier(UnitMods(i));
+}
+
+void Unit::UpdateStatsForModifier(UnitMods unitMod)
+{
     switch (unitMod)
     {
         case UNIT_MOD_STAT_STRENGTH:
@@ -9223,8 +9425,6 @@ bool Unit::HandleStatModifier(UnitMods unitMod, UnitModifierType modifierType, f
         default:
             break;
     }
-
-    return true;
 }
 
 float Unit::GetModifierValue(UnitMods unitMod, UnitModifierType modifierType) const
@@ -9570,6 +9770,7 @@ uint32 Unit::GetCreatePowers(Powers power) const
 void Unit::AddToWorld()
 {
     WorldObject::AddToWorld();
+    GetMap()->GetUnitSpatialHash().Insert(this);
     ScheduleAINotify(GetTypeId() == TYPEID_UNIT && !HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED) ? sWorld.getConfig(CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY) : 0);
 }
 
@@ -9578,6 +9779,7 @@ void Unit::RemoveFromWorld()
     // cleanup
     if (IsInWorld())
     {
+        FlushCombatLog();
         CombatStop();
         RemoveNotOwnTrackedTargetAuras();
         BreakCharmOutgoing();
@@ -9589,6 +9791,9 @@ void Unit::RemoveFromWorld()
         GetViewPoint().Event_RemovedFromWorld();
     }
 
+    if (m_spatialHash)
+        m_spatialHash->Remove(this);
+
     Object::RemoveFromWorld();
 }
 
@@ -10917,13 +11122,13 @@ void Unit::StopAttackFaction(uint32 faction_id)
 
 void Unit::CleanupDeletedAuras()
 {
-    for (SpellAuraHolderList::const_iterator iter = m_deletedHolders.begin(); iter != m_deletedHolders.end(); ++iter)
-        delete *iter;
+    for (SpellAuraHolder* holder : m_deletedHolders)
+        delete holder;
     m_deletedHolders.clear();
 
     // really delete auras "deleted" while processing its ApplyModify code
-    for (AuraList::const_iterator itr = m_deletedAuras.begin(); itr != m_deletedAuras.end(); ++itr)
-        delete *itr;
+    for (Aura* aura : m_deletedAuras)
+        delete aura;
     m_deletedAuras.clear();
 }
 
@@ -11028,6 +11233,29 @@ class UnitVisitObjectsInRangeNotifyEvent : public BasicEvent
         Unit & m_owner;
 };
 
+// batches the relocations done in the delay into one visibility update
+class UnitRelocationVisibilityNotifyEvent : public BasicEvent
+{
+    public:
+        UnitRelocationVisibilityNotifyEvent(Unit& owner) : BasicEvent(), m_owner(owner) {}
+
+        bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+        {
+            m_owner.FinalizeVisibilityNotifyEvent();
+            if (m_owner.IsInWorld())
+                m_owner.UpdateRelocationVisibility();
+            return true;
+        }
+
+        void Abort(uint64) override
+        {
+            m_owner.FinalizeVisibilityNotifyEvent();
+        }
+
+    private:
+        Unit& m_owner;
+};
+
 void Unit::ScheduleAINotify(uint32 delay, bool forced)
 {
     if (!IsAINotifyScheduled())
@@ -11052,7 +11280,7 @@ void Unit::AbortAINotifyEvent()
     }
 }
 
-void Unit::OnRelocated()
+void Unit::UpdateRelocationVisibility()
 {
     // switch to use G3D::Vector3 is good idea, maybe
     float dx = m_last_notified_position.x - GetPositionX();
@@ -11068,6 +11296,19 @@ void Unit::OnRelocated()
         GetViewPoint().Call_UpdateVisibilityForOwner();
         UpdateObjectVisibility();
     }
+}
+
+void Unit::OnRelocated()
+{
+    uint32 const delay = World::GetRelocationVisibilityNotifyDelay();
+    if (!delay)
+        UpdateRelocationVisibility();
+    else if (!IsVisibilityNotifyScheduled())
+    {
+        m_visibilityNotifyEvent = new UnitRelocationVisibilityNotifyEvent(*this);
+        m_events.AddEvent(m_visibilityNotifyEvent, m_events.CalculateTime(delay));
+    }
+
     ScheduleAINotify(World::GetRelocationAINotifyDelay());
 }
 
@@ -11733,8 +11974,7 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
     UnitList targets;
     // Maximum spell range=100m ?
     MaNGOS::AnyUnitInObjectRangeCheck u_check(this, 100.0f);
-    MaNGOS::UnitListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(targets, u_check);
-    Cell::VisitAllObjects(this, searcher, GetMap()->GetVisibilityDistance());
+    GetMap()->GetUnitSpatialHash().SearchUnits(GetPositionX(), GetPositionY(), 100.0f + GetObjectBoundingRadius(), targets, u_check);
     for (auto& target : targets)
     {
         if (!CanAttack(target))
@@ -11747,11 +11987,15 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
         if (!killDelayed)
             continue;
         // 2/ Interrupt spells that are not referenced but that still have an event (like delayed spell)
-        for (auto i_events = target->m_events.GetEvents().begin(); i_events != target->m_events.GetEvents().end(); ++i_events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_events->second))
-                if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
-                    if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
-                        event->GetSpell()->cancel();
+        // collected first, cancel() may queue events and the event list is a vector
+        std::vector<SpellEvent*> spellEvents;
+        for (EventListEntry const& entry : target->m_events.GetEvents())
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(entry.event))
+                if (event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
+                    spellEvents.push_back(event);
+        for (SpellEvent* event : spellEvents)
+            if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
+                event->GetSpell()->cancel();
     }
 }
 
@@ -28,6 +28,7 @@
 
 #include "Common.h"
 #include "Entities/Object.h"
+#include "Entities/StableVector.h"
 #include "Server/Opcodes.h"
 #include "Spells/SpellAuraDefines.h"
 #include "Entities/UpdateFields.h"
@@ -45,6 +46,7 @@
 #include "AI/BaseAI/UnitAI.h"
 #include "PlayerDefines.h"
 
+#include <atomic>
 #include <list>
 
 enum SpellInterruptFlags
@@ -243,6 +245,7 @@ class Pet;
 class PetAura;
 class Totem;
 class SpellCastTargets;
+class UnitSpatialHash;
 
 struct SpellImmune
 {
@@ -1209,8 +1212,8 @@ class Unit : public WorldObject
         typedef std::multimap<uint32 /*spellId*/, SpellAuraHolder*> SpellAuraHolderMap;
         typedef std::pair<SpellAuraHolderMap::iterator, SpellAuraHolderMap::iterator> SpellAuraHolderBounds;
         typedef std::pair<SpellAuraHolderMap::const_iterator, SpellAuraHolderMap::const_iterator> SpellAuraHolderConstBounds;
-        typedef std::list<SpellAuraHolder*> SpellAuraHolderList;
-        typedef std::list<Aura*> AuraList;
+        typedef std::vector<SpellAuraHolder*> SpellAuraHolderList;
+        typedef StableVector<Aura> AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<uint32 /*playerGuidLow*/> ComboPointHolderSet;
         typedef std::map<SpellEntry const*, ObjectGuid /*targetGuid*/> TrackedAuraTargetMap;
@@ -1843,6 +1846,9 @@ class Unit : public WorldObject
         void SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo) const;
         void SendSpellMiss(Unit* target, uint32 spellID, SpellMissInfo missInfo) const;
         void SendSpellDamageResist(Unit* target, uint32 spellId) const;
+        // combat log broadcast, queued until the end of the update with Visibility.CombatLogCoalesce
+        void SendCombatLogMessage(WorldPacket const& data) const;
+        void FlushCombatLog() const;
         static void SendSpellOrDamageImmune(ObjectGuid casterGuid, Unit* target, uint32 spellId);
 
         void SendEnchantmentLog(ObjectGuid targetGuid, uint32 itemEntry, uint32 enchantId) const;
@@ -1858,6 +1864,8 @@ class Unit : public WorldObject
         // if used additional args in ... part then floats must explicitly casted to double
         void SendTeleportPacket(float x, float y, float z, float ori);
         void SendHeartBeat();
+        // relays a client movement heartbeat of this unit, viewers beyond Visibility.MovementLOD.Radius only get some of them
+        void SendMovementHeartbeatToSet(WorldPacket const& data, Player const* skipped_receiver);
 
         void SendMoveRoot(bool state, bool broadcastOnly = false);
 
@@ -2106,6 +2114,9 @@ class Unit : public WorldObject
         Powers GetPowerTypeByAuraGroup(UnitMods unitMod) const;
         bool CanModifyStats() const { return m_canModifyStats; }
         void SetCanModifyStats(bool modifyStats) { m_canModifyStats = modifyStats; }
+        // modifier groups changed inside a batch are recalculated once when the outermost batch ends
+        void BeginStatUpdateBatch() { ++m_statUpdateBatchDepth; }
+        void EndStatUpdateBatch();
         virtual bool UpdateStats(Stats stat) = 0;
         virtual bool UpdateAllStats() = 0;
         virtual void UpdateResistances(uint32 school) = 0;
@@ -2114,6 +2125,8 @@ class Unit : public WorldObject
         virtual void UpdateMaxPower(Powers power) = 0;
         virtual void UpdateAttackPowerAndDamage(bool ranged = false) = 0;
         virtual void UpdateDamagePhysical(WeaponAttackType attType) = 0;
+        virtual void UpdateModifiedStats(uint32 unitModMask);
+        void UpdateStatsForModifier(UnitMods unitMod);
         float GetTotalAttackPowerValue(WeaponAttackType attType) const;
 
         float GetBaseWeaponDamage(WeaponAttackType attType, WeaponDamageRange damageRange, uint8 index = 0) const;
@@ -2202,6 +2215,23 @@ class Unit : public WorldObject
         int32 GetMaxPositiveAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const;
         int32 GetMaxNegativeAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const;
 
+        // the aggregates above are cached per aura type, must be called whenever an aura of that type is added, removed or changes its amount
+        void InvalidateAuraModifierCache(AuraType auratype);
+
+        // holders are only updated once one of their timers runs out, until then the passed time is kept here
+        uint32 GetPendingAuraUpdateTime() const { return m_auraUpdatePending; }
+        // passes the pending time to the holders and updates them on the next tick, must be called before holder timers are changed
+        void ResyncAuraUpdates();
+
+        struct AuraModifierCacheStats
+        {
+            AuraModifierCacheStats() : hits(0), misses(0) {}
+
+            std::atomic<uint64> hits;
+            std::atomic<uint64> misses;
+        };
+        static AuraModifierCacheStats const& GetAuraModifierCacheStats() { return m_auraModifierCacheStats; }
+
         Aura* GetDummyAura(uint32 spell_id) const;
 
         uint32 m_AuraFlags;
@@ -2250,6 +2280,8 @@ class Unit : public WorldObject
         uint32 MeleeDamageBonusTaken(Unit* caster, uint32 pdamage, WeaponAttackType attType, SpellSchoolMask schoolMask, SpellEntry const* spellProto = nullptr, DamageEffectType damagetype = DIRECT_DAMAGE, uint32 stack = 1, bool flat = true);
 
         bool IsTriggeredAtSpellProcEvent(ProcExecutionData& data, SpellAuraHolder* holder, SpellProcEventEntry const*& spellProcEvent);
+        void AddProcHolder(SpellAuraHolder* holder);
+        void RemoveProcHolder(SpellAuraHolder* holder);
         // only to be used in proc handlers - basepoints is expected to be a MAX_EFFECT_INDEX sized array
         SpellAuraProcResult TriggerProccedSpell(Unit* target, int32* basepoints, uint32 triggeredSpellId, Item* castItem, Aura* triggeredByAura, uint32 cooldown);
         SpellAuraProcResult TriggerProccedSpell(Unit* target, int32* basepoints, SpellEntry const* spellInfo, Item* castItem, Aura* triggeredByAura, uint32 cooldown);
@@ -2381,12 +2413,19 @@ class Unit : public WorldObject
         // Movement info
         MovementInfo m_movementInfo;
         Movement::MoveSpline* movespline;
+        uint32 m_movementHeartbeatCount;                    // client heartbeats relayed by SendMovementHeartbeatToSet
+        mutable std::vector<WorldPacket> m_pendingCombatLog; // queued by SendCombatLogMessage
+        mutable uint32 m_pendingCombatLogAge;               // update time passed since the first queued log
 
         void ScheduleAINotify(uint32 delay, bool forced = false);
         bool IsAINotifyScheduled() const { return m_AINotifyEvent != nullptr;}
         void FinalizeAINotifyEvent() { m_AINotifyEvent = nullptr; }
         void AbortAINotifyEvent();
+        bool IsVisibilityNotifyScheduled() const { return m_visibilityNotifyEvent != nullptr; }
+        void FinalizeVisibilityNotifyEvent() { m_visibilityNotifyEvent = nullptr; }
+        void UpdateRelocationVisibility();
         void OnRelocated();
+        UnitSpatialHash* GetSpatialHash() const { return m_spatialHash; }
 
         bool IsLinkingEventTrigger() { return m_isCreatureLinkingTrigger; }
         void TriggerAggroLinkingEvent(Unit* enemy);
@@ -2497,7 +2536,17 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
-        AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
+        uint32 m_auraUpdatePending;                         // time passed since the holders were last updated
+        uint32 m_auraUpdateDelay;                           // time until a timer of one of the holders runs out
+        struct ProcHolderEntry
+        {
+            ProcHolderEntry(SpellAuraHolder* _holder, uint32 _procFlags) : holder(_holder), procFlags(_procFlags) {}
+            SpellAuraHolder* holder;
+            uint32 procFlags;                               // proc flags the holder can trigger at, never 0
+        };
+        std::vector<ProcHolderEntry> m_procHolders;         // holders of m_spellAuraHolders that can proc, in the same order
+        uint32 m_procHoldersMask;                           // union of m_procHolders proc flags
+        std::vector<Aura*> m_deletedAuras;                  // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
         std::map<uint32, Aura*> m_classScripts;
         std::vector<Aura*> m_scriptedLocations[SCRIPT_LOCATION_MAX];
@@ -2514,11 +2563,41 @@ class Unit : public WorldObject
         uint32 m_transform;
 
         AuraList m_modAuras[TOTAL_AURAS];
+
+        // aura lists shorter than this are cheaper to walk than to look up
+        enum { AURA_MODIFIER_CACHE_MIN_AURAS = 4 };
+
+        enum AuraModifierCacheKind
+        {
+            AURA_MODIFIER_TOTAL,
+            AURA_MULTIPLIER_TOTAL,
+            AURA_MODIFIER_MAX_POSITIVE,
+            AURA_MODIFIER_MAX_NEGATIVE,
+            AURA_MODIFIER_TOTAL_BY_MASK,
+            AURA_MULTIPLIER_TOTAL_BY_MASK,
+            AURA_MODIFIER_MAX_POSITIVE_BY_MASK,
+            AURA_MODIFIER_MAX_NEGATIVE_BY_MASK,
+            AURA_MODIFIER_TOTAL_BY_VALUE,
+            AURA_MULTIPLIER_TOTAL_BY_VALUE,
+            AURA_MODIFIER_MAX_POSITIVE_BY_VALUE,
+            AURA_MODIFIER_MAX_NEGATIVE_BY_VALUE,
+        };
+
+        static uint64 MakeAuraModifierCacheKey(AuraType auratype, AuraModifierCacheKind kind, uint32 misc) { return (uint64(auratype) << 40) | (uint64(kind) << 32) | misc; }
+        template<typename T, class Calculator>
+        T GetCachedAuraModifier(AuraType auratype, AuraModifierCacheKind kind, uint32 misc, Calculator calculate) const;
+
+        // by MakeAuraModifierCacheKey, ordered so InvalidateAuraModifierCache can drop all entries of a type at once
+        // double holds both the int32 sums and the float multipliers exactly
+        mutable std::map<uint64, double> m_auraModifierCache;
+        static AuraModifierCacheStats m_auraModifierCacheStats;
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
 
         WeaponDamageInfo m_weaponDamageInfo;
 
         bool m_canModifyStats;
+        uint32 m_statUpdateBatchDepth;
+        uint32 m_pendingStatUpdateMask;                     // 1 << UnitMods changed in the current batch
         // std::list< spellEffectPair > AuraSpells[TOTAL_AURAS];  // TODO: use this if ok for mem
 
         float m_speed_rate[MAX_MOVE_TYPE];
@@ -2602,6 +2681,7 @@ class Unit : public WorldObject
         UnitVisibility m_Visibility;
         Position m_last_notified_position;
         BasicEvent* m_AINotifyEvent;
+        BasicEvent* m_visibilityNotifyEvent;
         ShortTimeTracker m_movesplineTimer;
 
         Diminishing m_Diminishing;
@@ -2636,6 +2716,14 @@ class Unit : public WorldObject
 
         uint64 m_auraUpdateMask;
 
+    private:
+        friend class UnitSpatialHash;
+
+        UnitSpatialHash* m_spatialHash;                     // map buckets holding the unit while in world
+        uint32 m_spatialBucketX;
+        uint32 m_spatialBucketY;
+        uint32 m_spatialIndex;
+
     private:                                                // Error traps for some wrong args using
         // this will catch and prevent build for any cases when all optional args skipped and instead triggered used non boolean type
         // no bodies expected for this declarations
@@ -2734,6 +2822,20 @@ bool Unit::CheckAllControlledUnits(Func const& func, uint32 controlledMask) cons
     return false;
 }
 
+// Scope of several stat modifier changes of one unit, e.g. all stats of one aura or all bonuses of one item
+class StatUpdateBatch
+{
+    public:
+        explicit StatUpdateBatch(Unit* unit) : m_unit(unit) { m_unit->BeginStatUpdateBatch(); }
+        ~StatUpdateBatch() { m_unit->EndStatUpdateBatch(); }
+
+        StatUpdateBatch(StatUpdateBatch const&) = delete;
+        StatUpdateBatch& operator=(StatUpdateBatch const&) = delete;
+
+    private:
+        Unit* m_unit;
+};
+
 // Helper for targets nearest to the spell target
 // The spell target is always first unless there is a target at _completely_ the same position (unbelievable case)
 struct TargetDistanceOrderNear : public std::binary_function<Unit const, Unit const, bool>
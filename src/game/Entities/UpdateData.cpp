@@ -17,6 +17,7 @@
  */
 
 #include <zlib.h>
+#include <chrono>
 
 #include "Common.h"
 #include "Entities/UpdateData.h"
@@ -47,29 +48,84 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     ++m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+UpdateData::CompressionStats UpdateData::m_compressionStats;
+
+namespace
 {
-    z_stream c_stream;
+    // deflate state of one thread, allocated once and only reset between packets
+    class UpdateDeflateStream
+    {
+        public:
+            UpdateDeflateStream() : m_level(-1) {}
+            ~UpdateDeflateStream()
+            {
+                if (m_level >= 0)
+                    deflateEnd(&m_stream);
+            }
+
+            z_stream* Acquire(int level)
+            {
+                // compression level changed by config reload
+                if (m_level >= 0 && m_level != level)
+                {
+                    deflateEnd(&m_stream);
+                    m_level = -1;
+                }
+
+                int z_res;
+                if (m_level < 0)
+                {
+                    m_stream.zalloc = (alloc_func)nullptr;
+                    m_stream.zfree = (free_func)nullptr;
+                    m_stream.opaque = (voidpf)nullptr;
+
+                    z_res = deflateInit(&m_stream, level);
+                    if (z_res != Z_OK)
+                    {
+                        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                        return nullptr;
+                    }
+                    m_level = level;
+                    return &m_stream;
+                }
+
+                z_res = deflateReset(&m_stream);
+                if (z_res != Z_OK)
+                {
+                    sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+                    deflateEnd(&m_stream);
+                    m_level = -1;
+                    return nullptr;
+                }
+                return &m_stream;
+            }
+
+        private:
+            z_stream m_stream;
+            int m_level;
+    };
+
+    thread_local UpdateDeflateStream t_deflateStream;
+}
 
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = t_deflateStream.Acquire(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
@@ -77,14 +133,14 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
@@ -92,15 +148,12 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
+    *dst_size = c_stream->total_out;
 
-    *dst_size = c_stream.total_out;
+    m_compressionStats.packets += 1;
+    m_compressionStats.bytesIn += src_size;
+    m_compressionStats.bytesOut += *dst_size;
+    m_compressionStats.timeUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
 }
 
 bool UpdateData::BuildPacket(WorldPacket& packet, bool hasTransport)
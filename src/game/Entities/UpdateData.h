@@ -22,6 +22,8 @@
 #include "ByteBuffer.h"
 #include "Entities/ObjectGuid.h"
 
+#include <atomic>
+
 class WorldPacket;
 
 enum ObjectUpdateType
@@ -60,11 +62,25 @@ class UpdateData
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
+        // totals of all SMSG_COMPRESSED_UPDATE_OBJECT compressions since startup
+        struct CompressionStats
+        {
+            CompressionStats() : packets(0), bytesIn(0), bytesOut(0), timeUs(0) {}
+
+            std::atomic<uint64> packets;
+            std::atomic<uint64> bytesIn;
+            std::atomic<uint64> bytesOut;
+            std::atomic<uint64> timeUs;
+        };
+        static CompressionStats const& GetCompressionStats() { return m_compressionStats; }
+
     protected:
         uint32 m_blockCount;
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
 
         static void Compress(void* dst, uint32* dst_size, void* src, int src_size);
+
+        static CompressionStats m_compressionStats;
 };
 #endif
@@ -0,0 +1,387 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Entities/UpdateFieldFlags.h"
+#include "Entities/UpdateMask.h"
+
+struct UpdateFieldRange
+{
+    uint16 index;
+    uint16 size;
+    uint32 flags;
+};
+
+// object, unit and player fields in the order of UpdateFields.h, has to be kept in sync with it
+static UpdateFieldRange const PlayerUpdateFieldRanges[] =
+{
+    { OBJECT_FIELD_GUID,                             2, UF_FLAG_PUBLIC },
+    { OBJECT_FIELD_TYPE,                             1, UF_FLAG_PUBLIC },
+    { OBJECT_FIELD_ENTRY,                            1, UF_FLAG_PUBLIC },
+    { OBJECT_FIELD_SCALE_X,                          1, UF_FLAG_PUBLIC },
+    { OBJECT_FIELD_PADDING,                          1, UF_FLAG_NONE },
+    { UNIT_FIELD_CHARM,                              2, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_SUMMON,                             2, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_CHARMEDBY,                          2, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_SUMMONEDBY,                         2, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_CREATEDBY,                          2, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_TARGET,                             2, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_PERSUADED,                          2, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_CHANNEL_OBJECT,                     2, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_HEALTH,                             1, UF_FLAG_DYNAMIC },
+    { UNIT_FIELD_POWER1,                             1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_POWER2,                             1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_POWER3,                             1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_POWER4,                             1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_POWER5,                             1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_MAXHEALTH,                          1, UF_FLAG_DYNAMIC },
+    { UNIT_FIELD_MAXPOWER1,                          1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_MAXPOWER2,                          1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_MAXPOWER3,                          1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_MAXPOWER4,                          1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_MAXPOWER5,                          1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_LEVEL,                              1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_FACTIONTEMPLATE,                    1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_BYTES_0,                            1, UF_FLAG_PUBLIC },
+    { UNIT_VIRTUAL_ITEM_SLOT_DISPLAY,                3, UF_FLAG_PUBLIC },
+    { UNIT_VIRTUAL_ITEM_INFO,                        6, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_FLAGS,                              1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_FLAGS_2,                            1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_AURA,                              56, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_AURAFLAGS,                         14, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_AURALEVELS,                        14, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_AURAAPPLICATIONS,                  14, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_AURASTATE,                          1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_BASEATTACKTIME,                     2, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_RANGEDATTACKTIME,                   1, UF_FLAG_PRIVATE },
+    { UNIT_FIELD_BOUNDINGRADIUS,                     1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_COMBATREACH,                        1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_DISPLAYID,                          1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_NATIVEDISPLAYID,                    1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_MOUNTDISPLAYID,                     1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_MINDAMAGE,                          1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY | UF_FLAG_UNK3 },
+    { UNIT_FIELD_MAXDAMAGE,                          1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY | UF_FLAG_UNK3 },
+    { UNIT_FIELD_MINOFFHANDDAMAGE,                   1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY | UF_FLAG_UNK3 },
+    { UNIT_FIELD_MAXOFFHANDDAMAGE,                   1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY | UF_FLAG_UNK3 },
+    { UNIT_FIELD_BYTES_1,                            1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_PETNUMBER,                          1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_PET_NAME_TIMESTAMP,                 1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_PETEXPERIENCE,                      1, UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_PETNEXTLEVELEXP,                    1, UF_FLAG_OWNER_ONLY },
+    { UNIT_DYNAMIC_FLAGS,                            1, UF_FLAG_DYNAMIC },
+    { UNIT_CHANNEL_SPELL,                            1, UF_FLAG_PUBLIC },
+    { UNIT_MOD_CAST_SPEED,                           1, UF_FLAG_PUBLIC },
+    { UNIT_CREATED_BY_SPELL,                         1, UF_FLAG_PUBLIC },
+    { UNIT_NPC_FLAGS,                                1, UF_FLAG_DYNAMIC },
+    { UNIT_NPC_EMOTESTATE,                           1, UF_FLAG_PUBLIC },
+    { UNIT_TRAINING_POINTS,                          1, UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_STAT0,                              1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_STAT1,                              1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_STAT2,                              1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_STAT3,                              1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_STAT4,                              1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_POSSTAT0,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_POSSTAT1,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_POSSTAT2,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_POSSTAT3,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_POSSTAT4,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_NEGSTAT0,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_NEGSTAT1,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_NEGSTAT2,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_NEGSTAT3,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_NEGSTAT4,                           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_RESISTANCES,                        7, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY | UF_FLAG_UNK3 },
+    { UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE,         7, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE,         7, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_BASE_MANA,                          1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_BASE_HEALTH,                        1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_BYTES_2,                            1, UF_FLAG_PUBLIC },
+    { UNIT_FIELD_ATTACK_POWER,                       1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_ATTACK_POWER_MODS,                  1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_ATTACK_POWER_MULTIPLIER,            1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_RANGED_ATTACK_POWER,                1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_RANGED_ATTACK_POWER_MODS,           1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_RANGED_ATTACK_POWER_MULTIPLIER,     1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_MINRANGEDDAMAGE,                    1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_MAXRANGEDDAMAGE,                    1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_POWER_COST_MODIFIER,                7, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_POWER_COST_MULTIPLIER,              7, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_MAXHEALTHMODIFIER,                  1, UF_FLAG_PRIVATE | UF_FLAG_OWNER_ONLY },
+    { UNIT_FIELD_PADDING,                            1, UF_FLAG_NONE },
+    { PLAYER_DUEL_ARBITER,                           2, UF_FLAG_PUBLIC },
+    { PLAYER_FLAGS,                                  1, UF_FLAG_PUBLIC },
+    { PLAYER_GUILDID,                                1, UF_FLAG_PUBLIC },
+    { PLAYER_GUILDRANK,                              1, UF_FLAG_PUBLIC },
+    { PLAYER_BYTES,                                  1, UF_FLAG_PUBLIC },
+    { PLAYER_BYTES_2,                                1, UF_FLAG_PUBLIC },
+    { PLAYER_BYTES_3,                                1, UF_FLAG_PUBLIC },
+    { PLAYER_DUEL_TEAM,                              1, UF_FLAG_PUBLIC },
+    { PLAYER_GUILD_TIMESTAMP,                        1, UF_FLAG_PUBLIC },
+    { PLAYER_QUEST_LOG_1_1,                          1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_1_2,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_1_3,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_1_4,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_2_1,                          1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_2_2,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_2_3,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_2_4,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_3_1,                          1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_3_2,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_3_3,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_3_4,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_4_1,                          1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_4_2,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_4_3,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_4_4,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_5_1,                          1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_5_2,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_5_3,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_5_4,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_6_1,                          1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_6_2,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_6_3,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_6_4,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_7_1,                          1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_7_2,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_7_3,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_7_4,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_8_1,                          1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_8_2,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_8_3,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_8_4,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_9_1,                          1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_9_2,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_9_3,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_9_4,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_10_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_10_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_10_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_10_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_11_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_11_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_11_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_11_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_12_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_12_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_12_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_12_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_13_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_13_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_13_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_13_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_14_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_14_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_14_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_14_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_15_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_15_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_15_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_15_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_16_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_16_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_16_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_16_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_17_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_17_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_17_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_17_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_18_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_18_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_18_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_18_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_19_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_19_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_19_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_19_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_20_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_20_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_20_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_20_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_21_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_21_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_21_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_21_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_22_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_22_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_22_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_22_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_23_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_23_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_23_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_23_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_24_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_24_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_24_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_24_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_25_1,                         1, UF_FLAG_GROUP_ONLY },
+    { PLAYER_QUEST_LOG_25_2,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_25_3,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_QUEST_LOG_25_4,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_VISIBLE_ITEM_1_CREATOR,                 2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_1_0,                      12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_1_PROPERTIES,              1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_1_PAD,                     1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_2_CREATOR,                 2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_2_0,                      12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_2_PROPERTIES,              1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_2_PAD,                     1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_3_CREATOR,                 2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_3_0,                      12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_3_PROPERTIES,              1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_3_PAD,                     1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_4_CREATOR,                 2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_4_0,                      12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_4_PROPERTIES,              1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_4_PAD,                     1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_5_CREATOR,                 2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_5_0,                      12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_5_PROPERTIES,              1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_5_PAD,                     1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_6_CREATOR,                 2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_6_0,                      12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_6_PROPERTIES,              1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_6_PAD,                     1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_7_CREATOR,                 2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_7_0,                      12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_7_PROPERTIES,              1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_7_PAD,                     1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_8_CREATOR,                 2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_8_0,                      12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_8_PROPERTIES,              1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_8_PAD,                     1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_9_CREATOR,                 2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_9_0,                      12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_9_PROPERTIES,              1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_9_PAD,                     1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_10_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_10_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_10_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_10_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_11_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_11_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_11_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_11_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_12_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_12_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_12_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_12_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_13_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_13_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_13_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_13_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_14_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_14_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_14_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_14_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_15_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_15_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_15_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_15_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_16_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_16_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_16_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_16_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_17_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_17_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_17_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_17_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_18_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_18_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_18_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_18_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_19_CREATOR,                2, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_19_0,                     12, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_19_PROPERTIES,             1, UF_FLAG_PUBLIC },
+    { PLAYER_VISIBLE_ITEM_19_PAD,                    1, UF_FLAG_PUBLIC },
+    { PLAYER_CHOSEN_TITLE,                           1, UF_FLAG_PUBLIC },
+    { PLAYER_FIELD_PAD_0,                            1, UF_FLAG_NONE },
+    { PLAYER_FIELD_INV_SLOT_HEAD,                   46, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_PACK_SLOT_1,                     32, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_BANK_SLOT_1,                     56, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_BANKBAG_SLOT_1,                  14, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_VENDORBUYBACK_SLOT_1,            24, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_KEYRING_SLOT_1,                  64, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_VANITYPET_SLOT_1,                36, UF_FLAG_PRIVATE },
+    { PLAYER_FARSIGHT,                               2, UF_FLAG_PRIVATE },
+    { PLAYER__FIELD_KNOWN_TITLES,                    2, UF_FLAG_PRIVATE },
+    { PLAYER_XP,                                     1, UF_FLAG_PRIVATE },
+    { PLAYER_NEXT_LEVEL_XP,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_SKILL_INFO_1_1,                       384, UF_FLAG_PRIVATE },
+    { PLAYER_CHARACTER_POINTS1,                      1, UF_FLAG_PRIVATE },
+    { PLAYER_CHARACTER_POINTS2,                      1, UF_FLAG_PRIVATE },
+    { PLAYER_TRACK_CREATURES,                        1, UF_FLAG_PRIVATE },
+    { PLAYER_TRACK_RESOURCES,                        1, UF_FLAG_PRIVATE },
+    { PLAYER_BLOCK_PERCENTAGE,                       1, UF_FLAG_PRIVATE },
+    { PLAYER_DODGE_PERCENTAGE,                       1, UF_FLAG_PRIVATE },
+    { PLAYER_PARRY_PERCENTAGE,                       1, UF_FLAG_PRIVATE },
+    { PLAYER_EXPERTISE,                              1, UF_FLAG_PRIVATE },
+    { PLAYER_OFFHAND_EXPERTISE,                      1, UF_FLAG_PRIVATE },
+    { PLAYER_CRIT_PERCENTAGE,                        1, UF_FLAG_PRIVATE },
+    { PLAYER_RANGED_CRIT_PERCENTAGE,                 1, UF_FLAG_PRIVATE },
+    { PLAYER_OFFHAND_CRIT_PERCENTAGE,                1, UF_FLAG_PRIVATE },
+    { PLAYER_SPELL_CRIT_PERCENTAGE1,                 7, UF_FLAG_PRIVATE },
+    { PLAYER_SHIELD_BLOCK,                           1, UF_FLAG_PRIVATE },
+    { PLAYER_EXPLORED_ZONES_1,                     128, UF_FLAG_PRIVATE },
+    { PLAYER_REST_STATE_EXPERIENCE,                  1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_COINAGE,                          1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_MOD_DAMAGE_DONE_POS,              7, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_MOD_DAMAGE_DONE_NEG,              7, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_MOD_DAMAGE_DONE_PCT,              7, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_MOD_HEALING_DONE_POS,             1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_MOD_TARGET_RESISTANCE,            1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_MOD_TARGET_PHYSICAL_RESISTANCE,   1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_BYTES,                            1, UF_FLAG_PRIVATE },
+    { PLAYER_AMMO_ID,                                1, UF_FLAG_PRIVATE },
+    { PLAYER_SELF_RES_SPELL,                         1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_PVP_MEDALS,                       1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_BUYBACK_PRICE_1,                 12, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_BUYBACK_TIMESTAMP_1,             12, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_KILLS,                            1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_TODAY_CONTRIBUTION,               1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_YESTERDAY_CONTRIBUTION,           1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_LIFETIME_HONORBALE_KILLS,         1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_BYTES2,                           1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_WATCHED_FACTION_INDEX,            1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_COMBAT_RATING_1,                 24, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_ARENA_TEAM_INFO_1_1,             18, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_HONOR_CURRENCY,                   1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_ARENA_CURRENCY,                   1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_MOD_MANA_REGEN,                   1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_MOD_MANA_REGEN_INTERRUPT,         1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_MAX_LEVEL,                        1, UF_FLAG_PRIVATE },
+    { PLAYER_FIELD_DAILY_QUESTS_1,                  25, UF_FLAG_PRIVATE },
+};
+
+void BuildPlayerUpdateFieldMask(UpdateMask& mask, uint32 flags)
+{
+    mask.SetCount(PLAYER_END);
+
+    uint32 index = 0;
+    for (UpdateFieldRange const& range : PlayerUpdateFieldRanges)
+    {
+        MANGOS_ASSERT(range.index == index);
+        index += range.size;
+
+        if (!(range.flags & flags))
+            continue;
+
+        for (uint32 i = range.index; i < index; ++i)
+            mask.SetBit(i);
+    }
+
+    MANGOS_ASSERT(index == PLAYER_END);
+}
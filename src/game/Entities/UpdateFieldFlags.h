@@ -0,0 +1,43 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_UPDATEFIELDFLAGS_H
+#define MANGOS_UPDATEFIELDFLAGS_H
+
+#include "Common.h"
+
+class UpdateMask;
+
+// client visibility of the update fields, as listed in UpdateFields.h
+enum UpdateFieldFlags
+{
+    UF_FLAG_NONE        = 0x000,
+    UF_FLAG_PUBLIC      = 0x001,
+    UF_FLAG_PRIVATE     = 0x002,
+    UF_FLAG_OWNER_ONLY  = 0x004,
+    UF_FLAG_UNK1        = 0x008,
+    UF_FLAG_UNK2        = 0x010,
+    UF_FLAG_UNK3        = 0x020,
+    UF_FLAG_GROUP_ONLY  = 0x040,
+    UF_FLAG_DYNAMIC     = 0x080,                            // public, the value is altered per viewer in BuildValuesUpdate
+};
+
+// sets the bits of all object, unit and player fields having one of the flags, the mask count is PLAYER_END
+void BuildPlayerUpdateFieldMask(UpdateMask& mask, uint32 flags);
+
+#endif
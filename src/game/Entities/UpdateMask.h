@@ -20,61 +20,86 @@
 #define __UPDATEMASK_H
 
 #include "Errors.h"
+#include "Platform/CompilerDefs.h"
+#include "Entities/UpdateFields.h"
 
+#if COMPILER == COMPILER_MICROSOFT
+#include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UPDATEMASK_SSE2
+#include <emmintrin.h>
+#endif
+
+#define UPDATE_MASK_MAX_BLOCKS ((PLAYER_END + 31) / 32)     // player has the most values of all object types
+
+// Values bit mask with inline storage, cheap enough to build one for every object and viewer pair
 class UpdateMask
 {
     public:
-        UpdateMask() : mCount(0), mBlocks(0), mUpdateMask(nullptr) { }
-        UpdateMask(const UpdateMask& mask) : mUpdateMask(nullptr) { *this = mask; }
-
-        ~UpdateMask()
-        {
-            delete[] mUpdateMask;
-        }
+        UpdateMask() : mCount(0), mBlocks(0) { }
 
         void SetBit(uint32 index)
         {
-            ((uint8*)mUpdateMask)[ index >> 3 ] |= 1 << (index & 0x7);
+            mUpdateMask[index >> 5] |= 1u << (index & 0x1F);
         }
 
         void UnsetBit(uint32 index)
         {
-            ((uint8*)mUpdateMask)[ index >> 3 ] &= (0xff ^ (1 << (index & 0x7)));
+            mUpdateMask[index >> 5] &= ~(1u << (index & 0x1F));
         }
 
         bool GetBit(uint32 index) const
         {
-            return (((uint8*)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7))) != 0;
+            return (mUpdateMask[index >> 5] & (1u << (index & 0x1F))) != 0;
         }
 
+        // set bits are walked by for (i = GetFirstSetBit(); i < GetCount(); i = GetNextSetBit(i))
+        uint32 GetFirstSetBit() const { return FindSetBit(0); }
+        uint32 GetNextSetBit(uint32 index) const { return FindSetBit(index + 1); }
+
         uint32 GetBlockCount() const { return mBlocks; }
-        uint32 GetLength() const { return mBlocks << 2; }
+        uint32 GetBlock(uint32 block) const { return mUpdateMask[block]; }
         uint32 GetCount() const { return mCount; }
-        uint8* GetMask() const { return (uint8*)mUpdateMask; }
 
         void SetCount(uint32 valuesCount)
         {
-            delete[] mUpdateMask;
+            MANGOS_ASSERT(valuesCount <= UPDATE_MASK_MAX_BLOCKS * 32);
 
             mCount = valuesCount;
             mBlocks = (valuesCount + 31) / 32;
 
-            mUpdateMask = new uint32[mBlocks];
             memset(mUpdateMask, 0, mBlocks << 2);
         }
 
         void Clear()
         {
-            if (mUpdateMask)
-                memset(mUpdateMask, 0, mBlocks << 2);
+            memset(mUpdateMask, 0, mBlocks << 2);
+        }
+
+        // adds a bitset in the same block layout, blocks has GetBlockCount() words
+        void SetBlocks(uint32 const* blocks)
+        {
+            for (uint32 i = 0; i < mBlocks; ++i)
+                mUpdateMask[i] |= blocks[i];
         }
 
-        UpdateMask& operator = (const UpdateMask& mask)
+        // sets the bit of every nonzero value, values has GetCount() entries
+        void SetNonZeroBits(uint32 const* values)
         {
-            SetCount(mask.mCount);
-            memcpy(mUpdateMask, mask.mUpdateMask, mBlocks << 2);
+            uint32 fullBlocks = mCount >> 5;
+            for (uint32 block = 0; block < fullBlocks; ++block)
+                mUpdateMask[block] |= NonZeroBits(values + (block << 5));
 
-            return *this;
+            for (uint32 index = fullBlocks << 5; index < mCount; ++index)
+                if (values[index])
+                    SetBit(index);
+        }
+
+        bool operator == (const UpdateMask& mask) const
+        {
+            return mCount == mask.mCount && memcmp(mUpdateMask, mask.mUpdateMask, mBlocks << 2) == 0;
         }
 
         void operator &= (const UpdateMask& mask)
@@ -112,8 +137,57 @@ class UpdateMask
         }
 
     private:
+        // first set bit at or after index, GetCount() if there is none
+        uint32 FindSetBit(uint32 index) const
+        {
+            uint32 block = index >> 5;
+            if (block >= mBlocks)
+                return mCount;
+
+            uint32 bits = mUpdateMask[block] & (~0u << (index & 0x1F));
+            while (!bits)
+            {
+                if (++block >= mBlocks)
+                    return mCount;
+                bits = mUpdateMask[block];
+            }
+
+            return (block << 5) + CountTrailingZeros(bits);
+        }
+
+        // bit i is set when values[i] is nonzero, for 32 values
+        static uint32 NonZeroBits(uint32 const* values)
+        {
+#ifdef UPDATEMASK_SSE2
+            __m128i const zero = _mm_setzero_si128();
+            uint32 zeroBits = 0;
+            for (uint32 i = 0; i < 32; i += 4)
+            {
+                __m128i isZero = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(values + i)), zero);
+                zeroBits |= uint32(_mm_movemask_ps(_mm_castsi128_ps(isZero))) << i;
+            }
+            return ~zeroBits;
+#else
+            uint32 bits = 0;
+            for (uint32 i = 0; i < 32; ++i)
+                bits |= uint32(values[i] != 0) << i;
+            return bits;
+#endif
+        }
+
+        static uint32 CountTrailingZeros(uint32 bits)
+        {
+#if COMPILER == COMPILER_MICROSOFT
+            unsigned long index;
+            _BitScanForward(&index, bits);
+            return uint32(index);
+#else
+            return uint32(__builtin_ctz(bits));
+#endif
+        }
+
         uint32 mCount;
         uint32 mBlocks;
-        uint32* mUpdateMask;
+        uint32 mUpdateMask[UPDATE_MASK_MAX_BLOCKS];
 };
 #endif
@@ -770,6 +770,53 @@ void GameEventMgr::ApplyNewEvent(uint16 event_id, bool resume)
     OnEventHappened(event_id, true, resume);
 }
 
+// with a batch size every map materializes the spawns of an event over its next updates, the spawn data is looked up
+// again when executed and the grid lists still change at once, so grids loading meanwhile already have the new state
+template<class D>
+static void QueueEventSpawnInMaps(uint32 db_guid, D const* data, D const* (ObjectMgr::*getData)(uint32) const, void (*execute)(uint32, D const*, Map*))
+{
+    sMapMgr.DoForAllMapsWithMapId(data->mapid, [=](Map* map)
+    {
+        map->QueueEventSpawn([=](Map* spawnMap)
+        {
+            if (D const* spawnData = (sObjectMgr.*getData)(db_guid))
+                execute(db_guid, spawnData, spawnMap);
+        });
+    });
+}
+
+static void EventSpawnCreature(uint32 db_guid, CreatureData const* data)
+{
+    if (sWorld.getConfig(CONFIG_UINT32_GAME_EVENT_SPAWN_BATCH_SIZE))
+        QueueEventSpawnInMaps(db_guid, data, &ObjectMgr::GetCreatureData, &Creature::SpawnInMap);
+    else
+        Creature::SpawnInMaps(db_guid, data);
+}
+
+static void EventUnspawnCreature(uint32 db_guid, CreatureData const* data)
+{
+    if (sWorld.getConfig(CONFIG_UINT32_GAME_EVENT_SPAWN_BATCH_SIZE))
+        QueueEventSpawnInMaps(db_guid, data, &ObjectMgr::GetCreatureData, &Creature::AddToRemoveListInMap);
+    else
+        Creature::AddToRemoveListInMaps(db_guid, data);
+}
+
+static void EventSpawnGameObject(uint32 db_guid, GameObjectData const* data)
+{
+    if (sWorld.getConfig(CONFIG_UINT32_GAME_EVENT_SPAWN_BATCH_SIZE))
+        QueueEventSpawnInMaps(db_guid, data, &ObjectMgr::GetGOData, &GameObject::SpawnInMap);
+    else
+        GameObject::SpawnInMaps(db_guid, data);
+}
+
+static void EventUnspawnGameObject(uint32 db_guid, GameObjectData const* data)
+{
+    if (sWorld.getConfig(CONFIG_UINT32_GAME_EVENT_SPAWN_BATCH_SIZE))
+        QueueEventSpawnInMaps(db_guid, data, &ObjectMgr::GetGOData, &GameObject::AddToRemoveListInMap);
+    else
+        GameObject::AddToRemoveListInMaps(db_guid, data);
+}
+
 void GameEventMgr::GameEventSpawn(int16 event_id)
 {
     int32 internal_event_id = m_gameEvents.size() + event_id - 1;
@@ -800,7 +847,7 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
 
             sObjectMgr.AddCreatureToGrid(itr, data);
 
-            Creature::SpawnInMaps(itr, data);
+            EventSpawnCreature(itr, data);
         }
     }
 
@@ -830,7 +877,7 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
 
             sObjectMgr.AddGameobjectToGrid(itr, data);
 
-            GameObject::SpawnInMaps(itr, data);
+            EventSpawnGameObject(itr, data);
         }
     }
 
@@ -877,7 +924,7 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
             sObjectMgr.RemoveCreatureFromGrid(itr, data);
 
             // Remove spawned cases
-            Creature::AddToRemoveListInMaps(itr, data);
+            EventUnspawnCreature(itr, data);
         }
     }
 
@@ -907,7 +954,7 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
             sObjectMgr.RemoveGameobjectFromGrid(itr, data);
 
             // Remove spawned cases
-            GameObject::AddToRemoveListInMaps(itr, data);
+            EventUnspawnGameObject(itr, data);
         }
     }
 
@@ -990,6 +1037,10 @@ void GameEventMgr::UpdateCreatureData(int16 event_id, bool activate)
 
 void GameEventMgr::UpdateEventQuests(uint16 event_id, bool Activate)
 {
+    // also drops the memoized game event conditions
+    Player::InvalidateAllQuestGiverStatusCaches();
+
+
     for (uint32& itr : m_gameEventQuests[event_id])
     {
         const Quest* pQuest = sObjectMgr.GetQuestTemplate(itr);
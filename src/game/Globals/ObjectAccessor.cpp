@@ -28,8 +28,14 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "Entities/ObjectGuid.h"
 #include "World/World.h"
+#include "TaskGraph.h"
+#include "Timer.h"
 
+#include <atomic>
+#include <map>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #define CLASS_LOCK MaNGOS::ClassLevelLockable<ObjectAccessor, std::mutex>
 INSTANTIATE_SINGLETON_2(ObjectAccessor, CLASS_LOCK);
@@ -40,6 +46,10 @@ void HashMapHolder<T>::Insert(T* o)
 {
     WriteGuard guard(i_lock);
     m_objectMap[o->GetObjectGuid()] = o;
+
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard shardGuard(shard.lock);
+    shard.objectMap[o->GetObjectGuid()] = o;
 }
 
 template<class T>
@@ -47,14 +57,19 @@ void HashMapHolder<T>::Remove(T* o)
 {
     WriteGuard guard(i_lock);
     m_objectMap.erase(o->GetObjectGuid());
+
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard shardGuard(shard.lock);
+    shard.objectMap.erase(o->GetObjectGuid());
 }
 
 template<class T>
 T* HashMapHolder<T>::Find(ObjectGuid guid)
 {
-    ReadGuard guard(i_lock);
-    typename MapType::iterator itr = m_objectMap.find(guid);
-    return (itr != m_objectMap.end()) ? itr->second : nullptr;
+    Shard& shard = GetShard(guid);
+    ReadGuard guard(shard.lock);
+    typename MapType::iterator itr = shard.objectMap.find(guid);
+    return (itr != shard.objectMap.end()) ? itr->second : nullptr;
 }
 
 template<class T>
@@ -66,10 +81,13 @@ typename HashMapHolder<T>::LockType& HashMapHolder<T>::GetLock() { return i_lock
 ObjectAccessor::ObjectAccessor() {}
 ObjectAccessor::~ObjectAccessor()
 {
-    for (Player2CorpsesMapType::const_iterator itr = i_player2corpse.begin(); itr != i_player2corpse.end(); ++itr)
+    for (auto& shard : m_corpseShards)
     {
-        itr->second->RemoveFromWorld();
-        delete itr->second;
+        for (auto& itr : shard.corpses)
+        {
+            itr.second->RemoveFromWorld();
+            delete itr.second;
+        }
     }
 }
 
@@ -124,10 +142,40 @@ Player* ObjectAccessor::FindPlayerByName(const char* name)
 
 void ObjectAccessor::SaveAllPlayers() const
 {
+    uint32 const startTime = WorldTimer::getMSTime();
+
     HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
     HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
+
+    // the players of one map are saved by one thread like the map threads do at autosave, the maps are idle meanwhile
+    std::map<Map*, std::vector<Player*>> playersByMap;
     for (auto& itr : m)
-        itr.second->SaveToDB();
+        playersByMap[itr.second->IsInWorld() ? itr.second->GetMap() : nullptr].push_back(itr.second);
+
+    sLog.outString("Saving " SIZEFMTD " players of " SIZEFMTD " maps...", m.size(), playersByMap.size());
+
+    std::atomic<uint32> savedCount(0);
+    MaNGOS::TaskGraph graph("Player saves");
+    for (auto const& mapPlayers : playersByMap)
+    {
+        std::vector<Player*> const& players = mapPlayers.second;
+        Map const* map = mapPlayers.first;
+        std::string const name = map ? std::to_string(map->GetId()) + "/" + std::to_string(map->GetInstanceId()) : "not in world";
+        graph.AddTask(name, [&players, &savedCount]()
+        {
+            for (Player* player : players)
+            {
+                player->SaveToDB();                 // queued on the async connection of the account
+
+                uint32 const saved = ++savedCount;
+                if (saved % 500 == 0)
+                    sLog.outString("Saved %u players...", saved);
+            }
+        });
+    }
+    graph.Run(sWorld.getConfig(CONFIG_UINT32_NUM_MAP_THREADS), []() { CharacterDatabase.ThreadStart(); }, []() { CharacterDatabase.ThreadEnd(); });
+
+    sLog.outString("Saved %u players in %u ms", savedCount.load(), WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
 }
 
 void ObjectAccessor::ExecuteOnAllPlayers(std::function<void(Player*)> executor)
@@ -150,10 +198,11 @@ void ObjectAccessor::KickPlayer(ObjectGuid guid)
 Corpse*
 ObjectAccessor::GetCorpseForPlayerGUID(ObjectGuid guid)
 {
-    Guard guard(i_corpseGuard);
+    CorpseShard& shard = GetCorpseShard(guid);
+    Guard guard(shard.lock);
 
-    Player2CorpsesMapType::iterator iter = i_player2corpse.find(guid);
-    if (iter == i_player2corpse.end())
+    Player2CorpsesMapType::iterator iter = shard.corpses.find(guid);
+    if (iter == shard.corpses.end())
         return nullptr;
 
     MANGOS_ASSERT(iter->second->GetType() != CORPSE_BONES);
@@ -166,19 +215,23 @@ ObjectAccessor::RemoveCorpse(Corpse* corpse)
 {
     MANGOS_ASSERT(corpse && corpse->GetType() != CORPSE_BONES);
 
-    Guard guard(i_corpseGuard);
-    Player2CorpsesMapType::iterator iter = i_player2corpse.find(corpse->GetOwnerGuid());
-    if (iter == i_player2corpse.end())
+    CorpseShard& shard = GetCorpseShard(corpse->GetOwnerGuid());
+    Guard guard(shard.lock);
+    Player2CorpsesMapType::iterator iter = shard.corpses.find(corpse->GetOwnerGuid());
+    if (iter == shard.corpses.end())
         return;
 
     // build mapid*cellid -> guid_set map
     CellPair cell_pair = MaNGOS::ComputeCellPair(corpse->GetPositionX(), corpse->GetPositionY());
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-    sObjectMgr.DeleteCorpseCellData(corpse->GetMapId(), cell_id, corpse->GetOwnerGuid().GetCounter());
+    {
+        Guard cellGuard(i_corpseCellGuard);
+        sObjectMgr.DeleteCorpseCellData(corpse->GetMapId(), cell_id, corpse->GetOwnerGuid().GetCounter());
+    }
     corpse->RemoveFromWorld();
 
-    i_player2corpse.erase(iter);
+    shard.corpses.erase(iter);
 }
 
 void
@@ -186,37 +239,42 @@ ObjectAccessor::AddCorpse(Corpse* corpse)
 {
     MANGOS_ASSERT(corpse && corpse->GetType() != CORPSE_BONES);
 
-    Guard guard(i_corpseGuard);
-    MANGOS_ASSERT(i_player2corpse.find(corpse->GetOwnerGuid()) == i_player2corpse.end());
-    i_player2corpse[corpse->GetOwnerGuid()] = corpse;
+    CorpseShard& shard = GetCorpseShard(corpse->GetOwnerGuid());
+    Guard guard(shard.lock);
+    MANGOS_ASSERT(shard.corpses.find(corpse->GetOwnerGuid()) == shard.corpses.end());
+    shard.corpses[corpse->GetOwnerGuid()] = corpse;
 
     // build mapid*cellid -> guid_set map
     CellPair cell_pair = MaNGOS::ComputeCellPair(corpse->GetPositionX(), corpse->GetPositionY());
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+    Guard cellGuard(i_corpseCellGuard);
     sObjectMgr.AddCorpseCellData(corpse->GetMapId(), cell_id, corpse->GetOwnerGuid().GetCounter(), corpse->GetInstanceId());
 }
 
 void
 ObjectAccessor::AddCorpsesToGrid(GridPair const& gridpair, GridType& grid, Map* map)
 {
-    Guard guard(i_corpseGuard);
-    for (auto& iter : i_player2corpse)
-        if (iter.second->GetGrid() == gridpair)
-        {
-            // verify, if the corpse in our instance (add only corpses which are)
-            if (map->Instanceable())
+    for (auto& shard : m_corpseShards)
+    {
+        Guard guard(shard.lock);
+        for (auto& iter : shard.corpses)
+            if (iter.second->GetGrid() == gridpair)
             {
-                if (iter.second->GetInstanceId() == map->GetInstanceId())
+                // verify, if the corpse in our instance (add only corpses which are)
+                if (map->Instanceable())
+                {
+                    if (iter.second->GetInstanceId() == map->GetInstanceId())
+                    {
+                        grid.AddWorldObject(iter.second);
+                    }
+                }
+                else
                 {
                     grid.AddWorldObject(iter.second);
                 }
             }
-            else
-            {
-                grid.AddWorldObject(iter.second);
-            }
-        }
+    }
 }
 
 Corpse*
@@ -287,23 +345,24 @@ ObjectAccessor::ConvertCorpseForPlayer(ObjectGuid player_guid, bool insignia)
 void ObjectAccessor::RemoveOldCorpses()
 {
     time_t now = time(nullptr);
-    Player2CorpsesMapType::iterator next;
-    for (Player2CorpsesMapType::iterator itr = i_player2corpse.begin(); itr != i_player2corpse.end(); itr = next)
+    std::vector<ObjectGuid> expired;
+    for (auto& shard : m_corpseShards)
     {
-        next = itr;
-        ++next;
-
-        if (!itr->second->IsExpired(now))
-            continue;
-
-        ConvertCorpseForPlayer(itr->first);
+        Guard guard(shard.lock);
+        for (auto& itr : shard.corpses)
+            if (!itr.second->IsInWorld() && itr.second->IsExpired(now))
+                expired.push_back(itr.first);
     }
+
+    for (ObjectGuid const& guid : expired)
+        ConvertCorpseForPlayer(guid);
 }
 
 /// Define the static member of HashMapHolder
 
 template <class T> typename HashMapHolder<T>::MapType HashMapHolder<T>::m_objectMap;
-template <class T> std::mutex HashMapHolder<T>::i_lock;
+template <class T> typename HashMapHolder<T>::LockType HashMapHolder<T>::i_lock("HashMapHolder::i_lock");
+template <class T> typename HashMapHolder<T>::Shard HashMapHolder<T>::m_shards[HashMapHolder<T>::SHARD_COUNT];
 
 /// Global definitions for the hashmap storage
 
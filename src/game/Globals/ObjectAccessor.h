@@ -23,6 +23,7 @@
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
 #include "Policies/ThreadingModel.h"
+#include "ProfiledMutex.h"
 
 #include "Entities/UpdateData.h"
 
@@ -43,9 +44,9 @@ class HashMapHolder
     public:
 
         typedef std::unordered_map<ObjectGuid, T*>   MapType;
-        typedef std::mutex LockType;
-        typedef std::lock_guard<std::mutex> ReadGuard;
-        typedef std::lock_guard<std::mutex> WriteGuard;
+        typedef ProfiledMutex LockType;
+        typedef std::lock_guard<LockType> ReadGuard;
+        typedef std::lock_guard<LockType> WriteGuard;
 
         static void Insert(T* o);
 
@@ -62,8 +63,23 @@ class HashMapHolder
         // Non instanceable only static
         HashMapHolder() {}
 
+        // Find is served by shards with their own locks, so lookups from many map threads do not meet on i_lock
+        // m_objectMap holds every object for the callers iterating GetContainer() under GetLock()
+        static uint32 const SHARD_COUNT = 16;
+
+        struct Shard
+        {
+            Shard() : lock("HashMapHolder::Shard::lock") {}
+
+            LockType lock;
+            MapType objectMap;
+        };
+
+        static Shard& GetShard(ObjectGuid guid) { return m_shards[guid.GetCounter() % SHARD_COUNT]; }
+
         static LockType i_lock;
         static MapType  m_objectMap;
+        static Shard    m_shards[SHARD_COUNT];
 };
 
 class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLevelLockable<ObjectAccessor, std::mutex> >
@@ -102,6 +118,7 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
         void AddCorpse(Corpse* corpse);
         void AddCorpsesToGrid(GridPair const& gridpair, GridType& grid, Map* map);
         Corpse* ConvertCorpseForPlayer(ObjectGuid player_guid, bool insignia = false);
+        // corpses in world expire on their map, see Map::UpdateCorpses, this only converts the ones of unloaded grids
         void RemoveOldCorpses();
 
         // For call from Player/Corpse AddToWorld/RemoveFromWorld only
@@ -112,13 +129,24 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
 
     private:
 
-        Player2CorpsesMapType   i_player2corpse;
-
         typedef std::mutex LockType;
         typedef MaNGOS::GeneralLock<LockType > Guard;
 
+        // player guid -> corpse index, sharded so the map threads adding and converting corpses rarely meet
+        static uint32 const CORPSE_SHARD_COUNT = 16;
+
+        struct CorpseShard
+        {
+            LockType lock;
+            Player2CorpsesMapType corpses;
+        };
+
+        CorpseShard& GetCorpseShard(ObjectGuid guid) { return m_corpseShards[guid.GetCounter() % CORPSE_SHARD_COUNT]; }
+
+        CorpseShard m_corpseShards[CORPSE_SHARD_COUNT];
+
         LockType i_playerGuard;
-        LockType i_corpseGuard;
+        LockType i_corpseCellGuard;                         // corpse cell data of ObjectMgr
 };
 
 #define sObjectAccessor ObjectAccessor::Instance()
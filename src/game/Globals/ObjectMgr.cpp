@@ -49,6 +49,7 @@
 #include "World/WorldState.h"
 
 #include "Entities/ItemEnchantmentMgr.h"
+#include "Entities/CharacterNameCache.h"
 #include "Loot/LootMgr.h"
 
 #include <limits>
@@ -116,12 +117,13 @@ LanguageDesc const* GetLanguageDescByID(uint32 lang)
 template<typename T>
 T IdGenerator<T>::Generate()
 {
-    if (m_nextGuid >= std::numeric_limits<T>::max() - 1)
+    T id = m_nextGuid.fetch_add(1);
+    if (id >= std::numeric_limits<T>::max() - 1)
     {
         sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", m_name);
         World::StopNow(ERROR_EXIT_CODE);
     }
-    return m_nextGuid++;
+    return id;
 }
 
 template uint32 IdGenerator<uint32>::Generate();
@@ -136,12 +138,16 @@ ObjectMgr::ObjectMgr() :
     m_PetNumbers("Pet numbers"),
     m_FirstTemporaryCreatureGuid(1),
     m_FirstTemporaryGameObjectGuid(1),
-    DBCLocaleIndex(LOCALE_enUS)
+    DBCLocaleIndex(LOCALE_enUS),
+    m_expiredMailsQueried(false)
 {
 }
 
 ObjectMgr::~ObjectMgr()
 {
+    for (Mail* mail : m_expiredMails)
+        delete mail;
+
     for (auto& mQuestTemplate : mQuestTemplates)
         delete mQuestTemplate.second;
 
@@ -717,8 +723,7 @@ void ObjectMgr::ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const*
         if (p != s)
             val.push_back(atoi(s));
 
-        // free char* loaded memory
-        delete[](char*)reinterpret_cast<char const*>(addon->auras);
+        // the loaded string stays in the string pool of the storage
     }
 
     // empty list
@@ -1327,7 +1332,7 @@ void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
     //                                                0                       1   2    3
-    QueryResult* result = WorldDatabase.Query("SELECT creature.guid, creature.id, map, modelid,"
+    QueryResult* result = WorldDatabase.QueryBinary("SELECT creature.guid, creature.id, map, modelid,"
                           //   4             5           6           7           8            9              10               11         12
                           "equipment_id, position_x, position_y, position_z, orientation, spawntimesecsmin, spawntimesecsmax, spawndist, currentwaypoint,"
                           //   13         14       15          16            17         18
@@ -1357,6 +1362,9 @@ void ObjectMgr::LoadCreatures()
 
     BarGoLink bar(result->GetRowCount());
 
+    std::vector<CellSpawnGuid> cellSpawns;
+    cellSpawns.reserve(result->GetRowCount());
+
     do
     {
         Field* fields = result->Fetch();
@@ -1516,7 +1524,7 @@ void ObjectMgr::LoadCreatures()
 
         if (data.IsNotPartOfPoolOrEvent()) // if not this is to be managed by GameEvent System or Pool system
         {
-            AddCreatureToGrid(guid, &data);
+            CollectCellSpawnGuids(cellSpawns, guid, data.mapid, data.spawnMask, data.posX, data.posY);
 
             if (cInfo->ExtraFlags & CREATURE_EXTRA_FLAG_ACTIVE)
                 m_activeCreatures.insert(ActiveCreatureGuidsOnMap::value_type(data.mapid, guid));
@@ -1532,10 +1540,53 @@ void ObjectMgr::LoadCreatures()
 
     delete result;
 
+    AddCellSpawnGuidsToGrid(cellSpawns, &CellObjectGuids::creatures);
+
     sLog.outString(">> Loaded " SIZEFMTD " creatures", mCreatureDataMap.size());
     sLog.outString();
 }
 
+void ObjectMgr::CollectCellSpawnGuids(std::vector<CellSpawnGuid>& spawns, uint32 guid, uint32 mapid, uint8 spawnMask, float x, float y)
+{
+    CellPair cell_pair = MaNGOS::ComputeCellPair(x, y);
+    uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
+
+    for (uint8 i = 0; spawnMask != 0; ++i, spawnMask >>= 1)
+    {
+        if (spawnMask & 1)
+        {
+            CellSpawnGuid spawn = { MAKE_PAIR32(mapid, i), cell_id, guid };
+            spawns.push_back(spawn);
+        }
+    }
+}
+
+// same result as AddCreatureToGrid / AddGameobjectToGrid per spawn, but each map and cell is looked up once and the sets are appended to in order
+void ObjectMgr::AddCellSpawnGuidsToGrid(std::vector<CellSpawnGuid>& spawns, CellGuidSet CellObjectGuids::* guids)
+{
+    std::sort(spawns.begin(), spawns.end());
+
+    CellObjectGuidsMap* cells = nullptr;
+    CellGuidSet* cellGuids = nullptr;
+    for (size_t i = 0; i < spawns.size(); ++i)
+    {
+        CellSpawnGuid const& spawn = spawns[i];
+        if (!i || spawn.mapKey != spawns[i - 1].mapKey)
+        {
+            cells = &mMapObjectGuids[spawn.mapKey];
+            cellGuids = nullptr;
+        }
+
+        if (!cellGuids || spawn.cellId != spawns[i - 1].cellId)
+            cellGuids = &((*cells)[spawn.cellId].*guids);
+
+        cellGuids->insert(cellGuids->end(), spawn.guid);
+    }
+
+    spawns.clear();
+    spawns.shrink_to_fit();
+}
+
 void ObjectMgr::AddCreatureToGrid(uint32 guid, CreatureData const* data)
 {
     uint8 mask = data->spawnMask;
@@ -1573,7 +1624,7 @@ void ObjectMgr::LoadGameObjects()
     uint32 count = 0;
 
     //                                                0                           1   2    3           4           5           6
-    QueryResult* result = WorldDatabase.Query("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
+    QueryResult* result = WorldDatabase.QueryBinary("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
                           //   7          8          9          10         11             12               13            14     15         16
                           "rotation0, rotation1, rotation2, rotation3, spawntimesecsmin, spawntimesecsmax, animprogress, state, spawnMask, event,"
                           //   17                          18
@@ -1594,6 +1645,9 @@ void ObjectMgr::LoadGameObjects()
 
     BarGoLink bar(result->GetRowCount());
 
+    std::vector<CellSpawnGuid> cellSpawns;
+    cellSpawns.reserve(result->GetRowCount());
+
     do
     {
         Field* fields = result->Fetch();
@@ -1718,7 +1772,7 @@ void ObjectMgr::LoadGameObjects()
             data.OriginalZoneId = 0;
 
         if (data.IsNotPartOfPoolOrEvent()) // if not this is to be managed by GameEvent System or Pool system
-            AddGameobjectToGrid(guid, &data);
+            CollectCellSpawnGuids(cellSpawns, guid, data.mapid, data.spawnMask, data.posX, data.posY);
 
         ++count;
     }
@@ -1726,6 +1780,8 @@ void ObjectMgr::LoadGameObjects()
 
     delete result;
 
+    AddCellSpawnGuidsToGrid(cellSpawns, &CellObjectGuids::gameobjects);
+
     sLog.outString(">> Loaded " SIZEFMTD " gameobjects", mGameObjectDataMap.size());
     sLog.outString();
 }
@@ -1811,6 +1867,9 @@ bool ObjectMgr::GetPlayerNameByGUID(ObjectGuid guid, std::string& name) const
 
     uint32 lowguid = guid.GetCounter();
 
+    if (sCharacterNameCache.GetName(lowguid, name))
+        return true;
+
     QueryResult* result = CharacterDatabase.PQuery("SELECT name FROM characters WHERE guid = '%u'", lowguid);
 
     if (result)
@@ -1831,6 +1890,10 @@ Team ObjectMgr::GetPlayerTeamByGUID(ObjectGuid guid) const
 
     uint32 lowguid = guid.GetCounter();
 
+    uint8 race;
+    if (sCharacterNameCache.GetRace(lowguid, race))
+        return Player::TeamForRace(race);
+
     QueryResult* result = CharacterDatabase.PQuery("SELECT race FROM characters WHERE guid = '%u'", lowguid);
 
     if (result)
@@ -3674,6 +3737,7 @@ void ObjectMgr::LoadQuests()
     mQuestTemplates.clear();
 
     m_ExclusiveQuestGroups.clear();
+    m_QuestKillCreditRelations.clear();
 
     //                                                0      1       2           3         4           5     6                7              8              9
     QueryResult* result = WorldDatabase.Query("SELECT entry, Method, ZoneOrSort, MinLevel, QuestLevel, Type, RequiredClasses, RequiredRaces, RequiredSkill, RequiredSkillValue,"
@@ -4302,6 +4366,22 @@ void ObjectMgr::LoadQuests()
         if (qinfo->ExclusiveGroup)
             m_ExclusiveQuestGroups.insert(ExclusiveQuestGroupsMap::value_type(qinfo->ExclusiveGroup, qinfo->GetQuestId()));
 
+        // kill credit looks up the quests by creature, cast objectives are credited by CastedCreatureOrGO
+        for (int j = 0; j < QUEST_OBJECTIVES_COUNT; ++j)
+        {
+            if (qinfo->ReqCreatureOrGOId[j] <= 0 || qinfo->ReqSpell[j] != 0)
+                continue;
+
+            uint32 entry = uint32(qinfo->ReqCreatureOrGOId[j]);
+            bool alreadyAdded = false;
+            for (int k = 0; k < j; ++k)
+                if (qinfo->ReqCreatureOrGOId[k] == qinfo->ReqCreatureOrGOId[j] && qinfo->ReqSpell[k] == 0)
+                    alreadyAdded = true;
+
+            if (!alreadyAdded)
+                m_QuestKillCreditRelations.insert(QuestRelationsMap::value_type(entry, qinfo->GetQuestId()));
+        }
+
         if (qinfo->LimitTime)
             qinfo->SetSpecialFlag(QUEST_SPECIAL_FLAG_TIMED);
     }
@@ -4621,7 +4701,7 @@ void ObjectMgr::LoadPetCreateSpells()
 
 void ObjectMgr::LoadItemTexts()
 {
-    QueryResult* result = CharacterDatabase.Query("SELECT id, text FROM item_text");
+    QueryResult* result = CharacterDatabase.QueryStream("SELECT id, text FROM item_text");
 
     uint32 count = 0;
 
@@ -4972,10 +5052,88 @@ void ObjectMgr::LoadConditions()
         }
     }
 
+    CompileConditions();
+
     sLog.outString(">> Loaded %u Condition definitions", sConditionStorage.GetRecordCount());
     sLog.outString();
 }
 
+// larger trees and the shared subtrees they duplicate stay with the recursive evaluation
+#define MAX_CONDITION_PROGRAM_STEPS 64
+#define MAX_CONDITION_PROGRAM_DEPTH 16
+
+// emits the steps of the tree backwards, the first step of it is returned, or false if the tree is too large
+static bool CompileConditionTree(PlayerCondition const* condition, int32 onTrue, int32 onFalse, uint32 depth, ConditionProgram& program, int32& start)
+{
+    if (!condition || depth > MAX_CONDITION_PROGRAM_DEPTH)
+        return false;
+
+    switch (condition->GetConditionType())
+    {
+        case CONDITION_NOT:
+            return CompileConditionTree(sConditionStorage.LookupEntry<PlayerCondition>(condition->GetValue1()), onFalse, onTrue, depth + 1, program, start);
+        case CONDITION_AND:
+        {
+            int32 second;
+            if (!CompileConditionTree(sConditionStorage.LookupEntry<PlayerCondition>(condition->GetValue2()), onTrue, onFalse, depth + 1, program, second))
+                return false;
+            return CompileConditionTree(sConditionStorage.LookupEntry<PlayerCondition>(condition->GetValue1()), second, onFalse, depth + 1, program, start);
+        }
+        case CONDITION_OR:
+        {
+            int32 second;
+            if (!CompileConditionTree(sConditionStorage.LookupEntry<PlayerCondition>(condition->GetValue2()), onTrue, onFalse, depth + 1, program, second))
+                return false;
+            return CompileConditionTree(sConditionStorage.LookupEntry<PlayerCondition>(condition->GetValue1()), onTrue, second, depth + 1, program, start);
+        }
+        default:
+            if (program.steps.size() >= MAX_CONDITION_PROGRAM_STEPS)
+                return false;
+
+            program.memoizable = program.memoizable && condition->IsMemoizable();
+            start = int32(program.steps.size());
+            program.steps.push_back({ condition, onTrue, onFalse });
+            return true;
+    }
+}
+
+void ObjectMgr::CompileConditions()
+{
+    m_conditionPrograms.clear();
+    m_conditionPrograms.resize(sConditionStorage.GetMaxEntry());
+
+    uint32 compiled = 0;
+    for (uint32 i = 0; i < sConditionStorage.GetMaxEntry(); ++i)
+    {
+        PlayerCondition const* condition = sConditionStorage.LookupEntry<PlayerCondition>(i);
+        if (!condition)
+            continue;
+
+        ConditionProgram& program = m_conditionPrograms[i];
+        program.memoizable = true;
+        if (CompileConditionTree(condition, CONDITION_PROGRAM_TRUE, CONDITION_PROGRAM_FALSE, 0, program, program.start))
+            ++compiled;
+        else
+        {
+            program = ConditionProgram();
+            sLog.outErrorDb("ObjectMgr::CompileConditions: condition_entry %u is too deep or too large to be flattened, it is evaluated recursively", i);
+        }
+    }
+
+    sLog.outString(">> Flattened %u condition trees", compiled);
+}
+
+bool ObjectMgr::RunConditionProgram(ConditionProgram const& program, Player const* pPlayer, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
+{
+    int32 step = program.start;
+    while (step >= 0)
+    {
+        ConditionProgramStep const& current = program.steps[step];
+        step = current.condition->Meets(pPlayer, map, source, conditionSourceType) ? current.onTrue : current.onFalse;
+    }
+    return step == CONDITION_PROGRAM_TRUE;
+}
+
 GossipText const* ObjectMgr::GetGossipText(uint32 Text_ID) const
 {
     GossipTextMap::const_iterator itr = mGossipText.find(Text_ID);
@@ -5496,15 +5654,31 @@ void ObjectMgr::LoadAreatriggerLocales()
 
 // not very fast function but it is called only once a day, or on starting-up
 /// @param serverUp true if the server is already running, false when the server is started
+// the items of every mail are read by the same query, rows of one mail follow each other
+#define EXPIRED_MAILS_QUERY \
+    "SELECT mail.id,messageType,sender,mail.receiver,itemTextId,has_items,expire_time,cod,checked,mailTemplateId,item_guid,item_template " \
+    "FROM mail LEFT JOIN mail_items ON mail_items.mail_id = mail.id WHERE expire_time < '" UI64FMTD "' ORDER BY mail.id"
+
 void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
 {
     time_t basetime = time(nullptr);
     DEBUG_LOG("Returning mails current time: hour: %d, minute: %d, second: %d ", localtime(&basetime)->tm_hour, localtime(&basetime)->tm_min, localtime(&basetime)->tm_sec);
+
+    if (serverUp)
+    {
+        // the mails of the last run are still handled
+        if (m_expiredMailsQueried || !m_expiredMails.empty())
+            return;
+
+        m_expiredMailsQueried = true;
+        CharacterDatabase.AsyncPQuery(this, &ObjectMgr::ReturnOrDeleteOldMailsCallback, EXPIRED_MAILS_QUERY, (uint64)basetime);
+        return;
+    }
+
     // delete all old mails without item and without body immediately, if starting server
-    if (!serverUp)
-        CharacterDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND itemTextId = 0", (uint64)basetime);
-    //                                                     0  1           2      3        4          5         6           7   8       9
-    QueryResult* result = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,itemTextId,has_items,expire_time,cod,checked,mailTemplateId FROM mail WHERE expire_time < '" UI64FMTD "'", (uint64)basetime);
+    CharacterDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND itemTextId = 0", (uint64)basetime);
+
+    QueryResult* result = CharacterDatabase.PQuery(EXPIRED_MAILS_QUERY, (uint64)basetime);
     if (!result)
     {
         BarGoLink bar(1);
@@ -5514,77 +5688,111 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
         return;                                             // any mails need to be returned or deleted
     }
 
-    // std::ostringstream delitems, delmails; // will be here for optimization
-    // bool deletemail = false, deleteitem = false;
-    // delitems << "DELETE FROM item_instance WHERE guid IN ( ";
-    // delmails << "DELETE FROM mail WHERE id IN ( "
+    BarGoLink bar(1);
+    LoadExpiredMails(result);
+    bar.step();
+
+    // same chunks as while running, so the IN lists of the batched deletes stay short
+    uint32 count = m_expiredMails.size();
+    while (!m_expiredMails.empty())
+        ProcessExpiredMails(sWorld.getConfig(CONFIG_UINT32_MAIL_EXPIRED_PER_TICK));
 
-    BarGoLink bar(result->GetRowCount());
-    uint32 count = 0;
+    sLog.outString(">> Loaded %u mails", count);
+    sLog.outString();
+}
+
+void ObjectMgr::ReturnOrDeleteOldMailsCallback(QueryResult* result)
+{
+    m_expiredMailsQueried = false;
+    if (result)
+        LoadExpiredMails(result);
+}
 
+void ObjectMgr::LoadExpiredMails(QueryResult* result)
+{
+    Mail* m = nullptr;
     do
     {
-        bar.step();
-
         Field* fields = result->Fetch();
-        Mail* m = new Mail;
-        m->messageID = fields[0].GetUInt32();
-        m->messageType = fields[1].GetUInt8();
-        m->sender = fields[2].GetUInt32();
-        m->receiverGuid = ObjectGuid(HIGHGUID_PLAYER, fields[3].GetUInt32());
-        bool has_items = fields[5].GetBool();
-        m->expire_time = (time_t)fields[6].GetUInt64();
-        m->deliver_time = 0;
-        m->COD = fields[7].GetUInt32();
-        m->checked = fields[8].GetUInt32();
-        m->mailTemplateId = fields[9].GetInt16();
-
-        Player* pl = nullptr;
-        if (serverUp)
-            pl = GetPlayer(m->receiverGuid);
-        if (pl)
+        uint32 messageID = fields[0].GetUInt32();
+        if (!m || m->messageID != messageID)
+        {
+            m = new Mail;
+            m->messageID = messageID;
+            m->messageType = fields[1].GetUInt8();
+            m->sender = fields[2].GetUInt32();
+            m->receiverGuid = ObjectGuid(HIGHGUID_PLAYER, fields[3].GetUInt32());
+            m->itemTextId = fields[4].GetUInt32();
+            m->has_items = fields[5].GetBool();
+            m->expire_time = (time_t)fields[6].GetUInt64();
+            m->deliver_time = 0;
+            m->COD = fields[7].GetUInt32();
+            m->checked = fields[8].GetUInt32();
+            m->mailTemplateId = fields[9].GetInt16();
+            m_expiredMails.push_back(m);
+        }
+
+        // no mail_items row for this mail
+        if (m->has_items && !fields[10].IsNULL())
+            m->AddItem(fields[10].GetUInt32(), fields[11].GetUInt32());
+    }
+    while (result->NextRow());
+    delete result;
+}
+
+void ObjectMgr::ProcessExpiredMails(uint32 limit)
+{
+    if (m_expiredMails.empty())
+        return;
+
+    time_t basetime = time(nullptr);
+
+    // deletes of the chunk are collected into one statement per table
+    std::ostringstream delItems, delTexts, delMails;
+    bool deleteItem = false, deleteText = false, deleteMail = false;
+
+    CharacterDatabase.BeginTransaction();
+
+    for (; limit && !m_expiredMails.empty(); --limit)
+    {
+        Mail* m = m_expiredMails.front();
+        m_expiredMails.pop_front();
+
+        // this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
+        // his in mailbox and he has already listed his mails )
+        if (GetPlayer(m->receiverGuid))
         {
-            // this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
-            // his in mailbox and he has already listed his mails )
             delete m;
             continue;
         }
+
         // delete or return mail:
-        if (has_items)
+        if (m->has_items)
         {
-            QueryResult* resultItems = CharacterDatabase.PQuery("SELECT item_guid,item_template FROM mail_items WHERE mail_id='%u'", m->messageID);
-            if (resultItems)
-            {
-                do
-                {
-                    Field* fields2 = resultItems->Fetch();
-
-                    uint32 item_guid_low = fields2[0].GetUInt32();
-                    uint32 item_template = fields2[1].GetUInt32();
-
-                    m->AddItem(item_guid_low, item_template);
-                }
-                while (resultItems->NextRow());
-
-                delete resultItems;
-            }
             // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
             if (m->messageType != MAIL_NORMAL || (m->checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
             {
                 // mail open and then not returned
                 for (auto& item : m->items)
-                    CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", item.item_guid);
+                {
+                    delItems << (deleteItem ? "," : "") << item.item_guid;
+                    deleteItem = true;
+                }
             }
             else
             {
                 // mail will be returned:
                 CharacterDatabase.PExecute("UPDATE mail SET sender = '%u', receiver = '%u', expire_time = '" UI64FMTD "', deliver_time = '" UI64FMTD "',cod = '0', checked = '%u' WHERE id = '%u'",
                                            m->receiverGuid.GetCounter(), m->sender, (uint64)basetime + 30 * DAY, (uint64)basetime, MAIL_CHECK_MASK_RETURNED, m->messageID);
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
+                if (!m->items.empty())
                 {
                     // update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
-                    CharacterDatabase.PExecute("UPDATE mail_items SET receiver = %u WHERE item_guid = '%u'", m->sender, itr2->item_guid);
-                    CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = %u WHERE guid = '%u'", m->sender, itr2->item_guid);
+                    std::ostringstream returnedItems;
+                    for (MailItemInfoVec::const_iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
+                        returnedItems << (itr2 == m->items.begin() ? "" : ",") << itr2->item_guid;
+
+                    CharacterDatabase.PExecute("UPDATE mail_items SET receiver = %u WHERE mail_id = '%u'", m->sender, m->messageID);
+                    CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = %u WHERE guid IN (%s)", m->sender, returnedItems.str().c_str());
                 }
                 delete m;
                 continue;
@@ -5592,19 +5800,24 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
         }
 
         if (m->itemTextId)
-            CharacterDatabase.PExecute("DELETE FROM item_text WHERE id = '%u'", m->itemTextId);
+        {
+            delTexts << (deleteText ? "," : "") << m->itemTextId;
+            deleteText = true;
+        }
 
-        // deletemail = true;
-        // delmails << m->messageID << ", ";
-        CharacterDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", m->messageID);
+        delMails << (deleteMail ? "," : "") << m->messageID;
+        deleteMail = true;
         delete m;
-        ++count;
     }
-    while (result->NextRow());
-    delete result;
 
-    sLog.outString(">> Loaded %u mails", count);
-    sLog.outString();
+    if (deleteItem)
+        CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid IN (%s)", delItems.str().c_str());
+    if (deleteText)
+        CharacterDatabase.PExecute("DELETE FROM item_text WHERE id IN (%s)", delTexts.str().c_str());
+    if (deleteMail)
+        CharacterDatabase.PExecute("DELETE FROM mail WHERE id IN (%s)", delMails.str().c_str());
+
+    CharacterDatabase.CommitTransaction();
 }
 
 void ObjectMgr::LoadQuestAreaTriggers()
@@ -6991,7 +7204,7 @@ void ObjectMgr::LoadCorpses()
 {
     uint32 count = 0;
     //                                                    0            1       2                  3                  4                  5                   6
-    QueryResult* result = CharacterDatabase.Query("SELECT corpse.guid, player, corpse.position_x, corpse.position_y, corpse.position_z, corpse.orientation, corpse.map, "
+    QueryResult* result = CharacterDatabase.QueryStream("SELECT corpse.guid, player, corpse.position_x, corpse.position_y, corpse.position_z, corpse.orientation, corpse.map, "
                           //   7     8            9         10      11    12     13           14            15              16       17
                           "time, corpse_type, instance, gender, race, class, playerBytes, playerBytes2, equipmentCache, guildId, playerFlags FROM corpse "
                           "JOIN characters ON player = characters.guid "
@@ -7350,7 +7563,7 @@ void ObjectMgr::LoadPointsOfInterest()
     sLog.outString();
 }
 
-static char SERVER_SIDE_SPELL[] = "CMaNGOS server-side spell";
+static char const SERVER_SIDE_SPELL[] = "CMaNGOS server-side spell";
 
 struct SQLSpellLoader : public SQLStorageLoaderBase<SQLSpellLoader, SQLHashStorage>
 {
@@ -7365,15 +7578,7 @@ struct SQLSpellLoader : public SQLStorageLoaderBase<SQLSpellLoader, SQLHashStora
 
     void default_fill_to_str(uint32 field_pos, char const* /*src*/, char*& dst)
     {
-        if (field_pos == LOADED_SPELLDBC_FIELD_POS_SPELLNAME_0)
-        {
-            dst = SERVER_SIDE_SPELL;
-        }
-        else
-        {
-            dst = new char[1];
-            *dst = 0;
-        }
+        dst = AddString(field_pos == LOADED_SPELLDBC_FIELD_POS_SPELLNAME_0 ? SERVER_SIDE_SPELL : "");
     }
 };
 
@@ -7407,6 +7612,8 @@ void ObjectMgr::LoadSpellTemplate()
     sLog.outString(">> Loaded %u spell_template records", sSpellTemplate.GetRecordCount());
     sLog.outString();
 
+    sSpellHotData.Load();
+
     sSpellCones.Load();
     sLog.outString(">> Loaded %u spell_cone records", sSpellCones.GetRecordCount());
     sLog.outString();
@@ -8251,6 +8458,23 @@ void ObjectMgr::LoadFishingBaseSkillLevel()
 // Check if a player meets condition conditionId
 bool ObjectMgr::IsPlayerMeetToCondition(uint16 conditionId, Player const* pPlayer, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
 {
+    if (conditionId < m_conditionPrograms.size() && !m_conditionPrograms[conditionId].steps.empty())
+    {
+        ConditionProgram const& program = m_conditionPrograms[conditionId];
+        if (!program.memoizable || !pPlayer)
+            return RunConditionProgram(program, pPlayer, map, source, conditionSourceType);
+
+        // the source type is part of the key, CONDITION_TEAM reads it
+        uint32 const memoKey = (uint32(conditionId) << 8) | uint32(conditionSourceType);
+        bool result;
+        if (pPlayer->GetConditionMemo(memoKey, result))
+            return result;
+
+        result = RunConditionProgram(program, pPlayer, map, source, conditionSourceType);
+        pPlayer->SetConditionMemo(memoKey, result);
+        return result;
+    }
+
     if (const PlayerCondition* condition = sConditionStorage.LookupEntry<PlayerCondition>(conditionId))
         return condition->Meets(pPlayer, map, source, conditionSourceType);
 
@@ -8597,6 +8821,32 @@ bool PlayerCondition::Meets(Player const* player, Map const* map, WorldObject co
     }
 }
 
+bool PlayerCondition::IsMemoizable() const
+{
+    switch (m_condition)
+    {
+        case CONDITION_NONE:
+        case CONDITION_TEAM:
+        case CONDITION_RACE_CLASS:
+        case CONDITION_GENDER:
+        case CONDITION_LEVEL:
+        case CONDITION_SKILL:
+        case CONDITION_SKILL_BELOW:
+        case CONDITION_REPUTATION_RANK_MIN:
+        case CONDITION_REPUTATION_RANK_MAX:
+        case CONDITION_QUESTREWARDED:
+        case CONDITION_QUESTTAKEN:
+        case CONDITION_QUEST_NONE:
+        case CONDITION_ACTIVE_GAME_EVENT:
+        case CONDITION_NOT_ACTIVE_GAME_EVENT:
+        case CONDITION_ACTIVE_HOLIDAY:
+        case CONDITION_NOT_ACTIVE_HOLIDAY:
+            return true;
+        default:
+            return false;
+    }
+}
+
 // Which params must be provided to a Condition
 bool PlayerCondition::CheckParamRequirements(Player const* pPlayer, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
 {
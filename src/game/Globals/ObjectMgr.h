@@ -34,7 +34,9 @@
 #include "Globals/ObjectAccessor.h"
 #include "Entities/ObjectGuid.h"
 
+#include <atomic>
 #include <map>
+#include <deque>
 #include <climits>
 
 class Group;
@@ -475,6 +477,13 @@ class PlayerCondition
         // Checks if the player meets the condition
         bool Meets(Player const* player, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const;
 
+        ConditionType GetConditionType() const { return m_condition; }
+        uint32 GetValue1() const { return m_value1; }
+        uint32 GetValue2() const { return m_value2; }
+        bool IsComposite() const { return m_condition == CONDITION_NOT || m_condition == CONDITION_OR || m_condition == CONDITION_AND; }
+        // result only depends on player state whose changes drop the condition memo of the player, or on game events
+        bool IsMemoizable() const;
+
     private:
         bool CheckParamRequirements(Player const* pPlayer, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const;
         uint16 m_entry;                                     // entry of the condition
@@ -483,6 +492,26 @@ class PlayerCondition
         uint32 m_value2;
 };
 
+// One leaf test of a condition tree flattened at load, the AND/OR/NOT nodes became the jump targets
+struct ConditionProgramStep
+{
+    PlayerCondition const* condition;
+    int32 onTrue;                                           // next step, or CONDITION_PROGRAM_TRUE / CONDITION_PROGRAM_FALSE
+    int32 onFalse;
+};
+
+#define CONDITION_PROGRAM_TRUE  -1
+#define CONDITION_PROGRAM_FALSE -2
+
+struct ConditionProgram
+{
+    ConditionProgram() : start(CONDITION_PROGRAM_FALSE), memoizable(false) {}
+
+    std::vector<ConditionProgramStep> steps;                // empty if the tree could not be flattened
+    int32 start;
+    bool memoizable;                                        // every leaf IsMemoizable
+};
+
 // NPC gossip text id
 typedef std::unordered_map<uint32, uint32> CacheNpcTextIdMap;
 
@@ -526,15 +555,15 @@ class IdGenerator
         explicit IdGenerator(char const* _name) : m_name(_name), m_nextGuid(1) {}
 
     public:                                                 // modifiers
-        void Set(T val) { m_nextGuid = val; }
+        void Set(T val) { m_nextGuid.store(val); }
         T Generate();
 
     public:                                                 // accessors
-        T GetNextAfterMaxUsed() const { return m_nextGuid; }
+        T GetNextAfterMaxUsed() const { return m_nextGuid.load(); }
 
     private:                                                // fields
         char const* m_name;
-        T m_nextGuid;
+        std::atomic<T> m_nextGuid;                          // map threads generate ids too
 };
 
 typedef std::list<uint32> SimpleFactionsList;
@@ -857,6 +886,8 @@ class ObjectMgr
         }
 
         void ReturnOrDeleteOldMails(bool serverUp);
+        // returns or deletes up to limit of the expired mails found by the last ReturnOrDeleteOldMails
+        void ProcessExpiredMails(uint32 limit);
 
         void SetHighestGuids();
 
@@ -869,7 +900,7 @@ class ObjectMgr
         uint32 GenerateStaticGameObjectLowGuid() { if (m_StaticGameObjectGuids.GetNextAfterMaxUsed() >= m_FirstTemporaryGameObjectGuid) return 0; return m_StaticGameObjectGuids.Generate(); }
 
         uint32 GeneratePlayerLowGuid()   { return m_CharGuids.Generate();     }
-        uint32 GenerateItemLowGuid()     { return m_ItemGuids.Generate();     }
+        uint32 GenerateItemLowGuid()     { return m_ItemGuids.GenerateFromBlock(); }
         uint32 GenerateCorpseLowGuid()   { return m_CorpseGuids.Generate();   }
         uint32 GenerateGroupLowGuid()    { return m_GroupGuids.Generate();    }
 
@@ -1202,6 +1233,12 @@ class ObjectMgr
             return m_ExclusiveQuestGroups.equal_range(groupId);
         }
 
+        // quests with a kill objective for the creature entry
+        QuestRelationsMapBounds GetQuestKillCreditMapBounds(uint32 entry) const
+        {
+            return m_QuestKillCreditRelations.equal_range(entry);
+        }
+
         QuestRelationsMapBounds GetCreatureQuestRelationsMapBounds(uint32 entry) const
         {
             return m_CreatureQuestRelations.equal_range(entry);
@@ -1251,6 +1288,10 @@ class ObjectMgr
         **/
         CreatureClassLvlStats const* GetCreatureClassLvlStats(uint32 level, uint32 unitClass, int32 expansion) const;
     protected:
+        void CompileConditions();
+        bool RunConditionProgram(ConditionProgram const& program, Player const* pPlayer, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const;
+
+        std::vector<ConditionProgram> m_conditionPrograms;  // by condition entry
 
         // first free id for selected id type
         IdGenerator<uint32> m_ArenaTeamIds;
@@ -1268,11 +1309,11 @@ class ObjectMgr
         ObjectGuidGenerator<HIGHGUID_UNIT>        m_StaticCreatureGuids;
         ObjectGuidGenerator<HIGHGUID_GAMEOBJECT>  m_StaticGameObjectGuids;
 
-        // first free low guid for selected guid type
-        ObjectGuidGenerator<HIGHGUID_PLAYER>     m_CharGuids;
-        ObjectGuidGenerator<HIGHGUID_ITEM>       m_ItemGuids;
-        ObjectGuidGenerator<HIGHGUID_CORPSE>     m_CorpseGuids;
-        ObjectGuidGenerator<HIGHGUID_GROUP>      m_GroupGuids;
+        // first free low guid for selected guid type, items are leased in blocks by the map threads
+        SharedObjectGuidGenerator<HIGHGUID_PLAYER>     m_CharGuids;
+        SharedObjectGuidGenerator<HIGHGUID_ITEM>       m_ItemGuids;
+        SharedObjectGuidGenerator<HIGHGUID_CORPSE>     m_CorpseGuids;
+        SharedObjectGuidGenerator<HIGHGUID_GROUP>      m_GroupGuids;
 
         QuestMap            mQuestTemplates;
 
@@ -1325,6 +1366,7 @@ class ObjectMgr
         LocalForIndex        m_LocalForIndex;
 
         ExclusiveQuestGroupsMap m_ExclusiveQuestGroups;
+        QuestRelationsMap       m_QuestKillCreditRelations;
 
         QuestRelationsMap       m_CreatureQuestRelations;
         QuestRelationsMap       m_CreatureQuestInvolvedRelations;
@@ -1334,6 +1376,31 @@ class ObjectMgr
         int DBCLocaleIndex;
 
     private:
+        void ReturnOrDeleteOldMailsCallback(QueryResult* result);
+        void LoadExpiredMails(QueryResult* result);
+
+        std::deque<Mail*> m_expiredMails;                   // read by ReturnOrDeleteOldMails, handled in chunks
+        bool m_expiredMailsQueried;                         // async query in flight
+
+        // spawn of the startup loads for the cell index, sorted before the insertion so each cell set is filled in order
+        struct CellSpawnGuid
+        {
+            uint32 mapKey;                                  // (mapid, spawnMode) pair
+            uint32 cellId;
+            uint32 guid;
+
+            bool operator<(CellSpawnGuid const& other) const
+            {
+                if (mapKey != other.mapKey)
+                    return mapKey < other.mapKey;
+                if (cellId != other.cellId)
+                    return cellId < other.cellId;
+                return guid < other.guid;
+            }
+        };
+        static void CollectCellSpawnGuids(std::vector<CellSpawnGuid>& spawns, uint32 guid, uint32 mapid, uint8 spawnMask, float x, float y);
+        void AddCellSpawnGuidsToGrid(std::vector<CellSpawnGuid>& spawns, CellGuidSet CellObjectGuids::* guids);
+
         void LoadCreatureAddons(SQLStorage& creatureaddons, char const* entryName, char const* comment);
         void ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const* table, char const* guidEntryStr);
         void LoadQuestRelationsHelper(QuestRelationsMap& map, char const* table);
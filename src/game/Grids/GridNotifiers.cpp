@@ -111,65 +111,103 @@ void VisibleNotifier::Notify()
 
 void MessageDeliverer::Visit(CameraMapType& m)
 {
-    for (auto& iter : m)
+    for (Camera* camera : m.getObjects())
     {
-        Player* owner = iter.getSource()->GetOwner();
+        Player* owner = camera->GetOwner();
 
         if (i_toSelf || owner != &i_player)
         {
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                session->SendPacket(i_payload);
         }
     }
 }
 
 void MessageDelivererExcept::Visit(CameraMapType& m)
 {
-    for (auto& iter : m)
+    for (Camera* camera : m.getObjects())
+    {
+        Player* owner = camera->GetOwner();
+
+        if (owner == i_skipped_receiver)
+            continue;
+
+        if (WorldSession* session = owner->GetSession())
+            session->SendPacket(i_payload);
+    }
+}
+
+void MovementHeartbeatDeliverer::Visit(CameraMapType& m)
+{
+    for (Camera* camera : m.getObjects())
     {
-        Player* owner = iter.getSource()->GetOwner();
+        Player* owner = camera->GetOwner();
 
         if (owner == i_skipped_receiver)
             continue;
 
+        if (!i_toDistant && !camera->GetBody()->IsWithinDist(&i_mover, i_fullRateDist))
+        {
+            ++i_suppressed;
+            continue;
+        }
+
         if (WorldSession* session = owner->GetSession())
-            session->SendPacket(i_message);
+        {
+            session->SendPacket(i_payload);
+            ++i_sent;
+        }
     }
 }
 
 void ObjectMessageDeliverer::Visit(CameraMapType& m)
 {
-    for (auto& iter : m)
+    for (Camera* camera : m.getObjects())
     {
-        if (WorldSession* session = iter.getSource()->GetOwner()->GetSession())
-            session->SendPacket(i_message);
+        if (WorldSession* session = camera->GetOwner()->GetSession())
+            session->SendPacket(i_payload);
+    }
+}
+
+void ObjectMessageBatchDeliverer::Visit(CameraMapType& m)
+{
+    for (Camera* camera : m.getObjects())
+    {
+        Player* owner = camera->GetOwner();
+
+        if (owner == i_skipped_receiver)
+            continue;
+
+        if (WorldSession* session = owner->GetSession())
+            for (SharedPacketPayload const& payload : i_payloads)
+                session->SendPacket(payload);
     }
 }
 
 void MessageDistDeliverer::Visit(CameraMapType& m)
 {
-    for (auto& iter : m)
+    for (Camera* camera : m.getObjects())
     {
-        Player* owner = iter.getSource()->GetOwner();
+        Player* owner = camera->GetOwner();
 
         if ((i_toSelf || owner != &i_player) &&
                 (!i_ownTeamOnly || owner->GetTeam() == i_player.GetTeam()) &&
-                (!i_dist || iter.getSource()->GetBody()->IsWithinDist(&i_player, i_dist)))
+                (!i_dist || camera->GetBody()->IsWithinDist(&i_player, i_dist)))
         {
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                session->SendPacket(i_payload);
         }
     }
 }
 
 void ObjectMessageDistDeliverer::Visit(CameraMapType& m)
 {
-    for (auto& iter : m)
+    for (Camera* camera : m.getObjects())
     {
-        if (!i_dist || iter.getSource()->GetBody()->IsWithinDist(&i_object, i_dist))
+        if (!i_dist || camera->GetBody()->IsWithinDist(&i_object, i_dist))
         {
-            if (WorldSession* session = iter.getSource()->GetOwner()->GetSession())
-                session->SendPacket(i_message);
+            if (WorldSession* session = camera->GetOwner()->GetSession())
+                session->SendPacket(i_payload);
         }
     }
 }
@@ -177,8 +215,16 @@ void ObjectMessageDistDeliverer::Visit(CameraMapType& m)
 template<class T>
 void ObjectUpdater::Visit(GridRefManager<T>& m)
 {
-    for (auto& iter : m)
-        m_objectToUpdateSet.emplace(iter.getSource());
+    for (T* object : m.getObjects())
+        m_objectToUpdateSet.emplace(object);
+}
+
+void ObjectUpdater::Visit(GameObjectMapType& m)
+{
+    // despawned gameobjects waiting for their respawn are woken by the map respawn queue
+    for (GameObject* object : m.getObjects())
+        if (!object->IsSleepingUntilRespawn())
+            m_objectToUpdateSet.emplace(object);
 }
 
 bool CannibalizeObjectCheck::operator()(Corpse* u)
@@ -276,5 +322,4 @@ bool MaNGOS::AnyAssistCreatureInRangeCheck::operator()(Creature* u)
     return true;
 }
 
-template void ObjectUpdater::Visit<GameObject>(GameObjectMapType&);
 template void ObjectUpdater::Visit<DynamicObject>(DynamicObjectMapType&);
@@ -58,8 +58,9 @@ namespace MaNGOS
     {
         Player const& i_player;
         WorldPacket const& i_message;
+        SharedPacketPayload i_payload;                      // serialized once, shared by all receivers
         bool i_toSelf;
-        MessageDeliverer(Player const& pl, WorldPacket const& msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
+        MessageDeliverer(Player const& pl, WorldPacket const& msg, bool to_self) : i_player(pl), i_message(msg), i_payload(msg), i_toSelf(to_self) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
@@ -67,19 +68,56 @@ namespace MaNGOS
     struct MessageDelivererExcept
     {
         WorldPacket const& i_message;
+        SharedPacketPayload i_payload;
         Player const* i_skipped_receiver;
 
         MessageDelivererExcept(WorldPacket const& msg, Player const* skipped)
-            : i_message(msg), i_skipped_receiver(skipped) {}
+            : i_message(msg), i_payload(msg), i_skipped_receiver(skipped) {}
 
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
 
+    // relays a movement heartbeat at full rate within i_fullRateDist of the mover, other viewers only get it if i_toDistant
+    struct MovementHeartbeatDeliverer
+    {
+        WorldObject const& i_mover;
+        WorldPacket const& i_message;
+        SharedPacketPayload i_payload;
+        Player const* i_skipped_receiver;
+        float i_fullRateDist;
+        bool i_toDistant;
+        uint32 i_sent;
+        uint32 i_suppressed;
+
+        MovementHeartbeatDeliverer(WorldObject const& mover, WorldPacket const& msg, Player const* skipped, float fullRateDist, bool toDistant)
+            : i_mover(mover), i_message(msg), i_payload(msg), i_skipped_receiver(skipped), i_fullRateDist(fullRateDist), i_toDistant(toDistant), i_sent(0), i_suppressed(0) {}
+
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
+    // sends all packets to each receiver in order, queued combat logs of one unit
+    struct ObjectMessageBatchDeliverer
+    {
+        std::vector<SharedPacketPayload> i_payloads;
+        Player const* i_skipped_receiver;
+
+        ObjectMessageBatchDeliverer(std::vector<WorldPacket> const& msgs, Player const* skipped) : i_skipped_receiver(skipped)
+        {
+            i_payloads.reserve(msgs.size());
+            for (WorldPacket const& msg : msgs)
+                i_payloads.emplace_back(msg);
+        }
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
     struct ObjectMessageDeliverer
     {
         WorldPacket const& i_message;
-        explicit ObjectMessageDeliverer(WorldPacket const& msg) : i_message(msg) {}
+        SharedPacketPayload i_payload;
+        explicit ObjectMessageDeliverer(WorldPacket const& msg) : i_message(msg), i_payload(msg) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
@@ -88,12 +126,13 @@ namespace MaNGOS
     {
         Player const& i_player;
         WorldPacket const& i_message;
+        SharedPacketPayload i_payload;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
 
         MessageDistDeliverer(Player const& pl, WorldPacket const& msg, float dist, bool to_self, bool ownTeamOnly)
-            : i_player(pl), i_message(msg), i_toSelf(to_self), i_ownTeamOnly(ownTeamOnly), i_dist(dist) {}
+            : i_player(pl), i_message(msg), i_payload(msg), i_toSelf(to_self), i_ownTeamOnly(ownTeamOnly), i_dist(dist) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
@@ -102,8 +141,9 @@ namespace MaNGOS
     {
         WorldObject const& i_object;
         WorldPacket const& i_message;
+        SharedPacketPayload i_payload;
         float i_dist;
-        ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket const& msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
+        ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket const& msg, float dist) : i_object(obj), i_message(msg), i_payload(msg), i_dist(dist) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
@@ -116,6 +156,7 @@ namespace MaNGOS
         void Visit(CorpseMapType&) {}
         void Visit(CameraMapType&) {}
         void Visit(CreatureMapType&);
+        void Visit(GameObjectMapType&);
 
         private:
             WorldObjectUnSet& m_objectToUpdateSet;
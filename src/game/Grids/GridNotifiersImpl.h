@@ -23,6 +23,7 @@
 #include "WorldPacket.h"
 #include "Entities/Player.h"
 #include "AI/BaseAI/UnitAI.h"
+#include "AI/ScriptDevAI/ScriptProfiler.h"
 #include "Spells/SpellAuras.h"
 #include "Server/DBCStores.h"
 #include "Server/DBCEnums.h"
@@ -42,17 +43,22 @@ inline void MaNGOS::VisibleNotifier::Visit(GridRefManager<T>& m)
 
 inline void MaNGOS::ObjectUpdater::Visit(CreatureMapType& m)
 {
+    // dead creatures waiting for their respawn are woken by the map respawn queue
     for (auto& iter : m)
-        m_objectToUpdateSet.emplace(iter.getSource());
+        if (!iter.getSource()->IsSleepingUntilRespawn())
+            m_objectToUpdateSet.emplace(iter.getSource());
 }
 
 inline void UnitVisitObjectsNotifierWorker(Unit* unitA, Unit* unitB)
 {
+    // out of reach is cheaper to find than the visibility
     if (unitA->hasUnitState(UNIT_STAT_LOST_CONTROL) ||
         unitA->GetCombatManager().IsInEvadeMode() ||
+        !unitA->AI()->CanReactInLineOfSight(unitB) ||
         !unitA->AI()->IsVisible(unitB))
         return;
 
+    ScriptProfiler::Scope profile(SCRIPT_PROFILE_MOVE_IN_LOS, unitA->AI()->GetScriptId());
     unitA->AI()->MoveInLineOfSight(unitB);
 }
 
@@ -61,7 +67,10 @@ inline void PlayerVisitCreatureWorker(Player* pl, Creature* c)
     if (!c->hasUnitState(UNIT_STAT_LOST_CONTROL))
     {
         if (c->AI() && c->AI()->IsVisible(pl) && !c->GetCombatManager().IsInEvadeMode())
+        {
+            ScriptProfiler::Scope profile(SCRIPT_PROFILE_MOVE_IN_LOS, c->AI()->GetScriptId());
             c->AI()->MoveInLineOfSight(pl);
+        }
     }
 
     if (!pl->hasUnitState(UNIT_STAT_LOST_CONTROL))
@@ -91,13 +100,19 @@ inline void CreatureVisitCreatureWorker(Creature* c1, Creature* c2)
     if (!c1->hasUnitState(UNIT_STAT_LOST_CONTROL))
     {
         if (c1->AI() && c1->AI()->IsVisible(c2) && !c1->GetCombatManager().IsInEvadeMode())
+        {
+            ScriptProfiler::Scope profile(SCRIPT_PROFILE_MOVE_IN_LOS, c1->AI()->GetScriptId());
             c1->AI()->MoveInLineOfSight(c2);
+        }
     }
 
     if (!c2->hasUnitState(UNIT_STAT_LOST_CONTROL))
     {
         if (c2->AI() && c2->AI()->IsVisible(c1) && !c2->GetCombatManager().IsInEvadeMode())
+        {
+            ScriptProfiler::Scope profile(SCRIPT_PROFILE_MOVE_IN_LOS, c2->AI()->GetScriptId());
             c2->AI()->MoveInLineOfSight(c1);
+        }
     }
 }
 
@@ -398,41 +413,41 @@ void MaNGOS::WorldObjectSearcher<Check>::Visit(DynamicObjectMapType& m)
 template<class Check>
 void MaNGOS::WorldObjectListSearcher<Check>::Visit(PlayerMapType& m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (Player* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 template<class Check>
 void MaNGOS::WorldObjectListSearcher<Check>::Visit(CreatureMapType& m)
 {
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (Creature* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 template<class Check>
 void MaNGOS::WorldObjectListSearcher<Check>::Visit(CorpseMapType& m)
 {
-    for (CorpseMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (Corpse* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 template<class Check>
 void MaNGOS::WorldObjectListSearcher<Check>::Visit(GameObjectMapType& m)
 {
-    for (GameObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (GameObject* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 template<class Check>
 void MaNGOS::WorldObjectListSearcher<Check>::Visit(DynamicObjectMapType& m)
 {
-    for (DynamicObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (DynamicObject* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 // Gameobject searchers
@@ -467,9 +482,9 @@ void MaNGOS::GameObjectLastSearcher<Check>::Visit(GameObjectMapType& m)
 template<class Check>
 void MaNGOS::GameObjectListSearcher<Check>::Visit(GameObjectMapType& m)
 {
-    for (GameObjectMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (GameObject* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 // Unit searchers
@@ -531,17 +546,17 @@ void MaNGOS::UnitLastSearcher<Check>::Visit(PlayerMapType& m)
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType& m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (Player* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(CreatureMapType& m)
 {
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (Creature* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 // Creature searchers
@@ -576,9 +591,9 @@ void MaNGOS::CreatureLastSearcher<Check>::Visit(CreatureMapType& m)
 template<class Check>
 void MaNGOS::CreatureListSearcher<Check>::Visit(CreatureMapType& m)
 {
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (Creature* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 template<class Check>
@@ -601,9 +616,9 @@ void MaNGOS::PlayerSearcher<Check>::Visit(PlayerMapType& m)
 template<class Check>
 void MaNGOS::PlayerListSearcher<Check>::Visit(PlayerMapType& m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    for (Player* object : m.getObjects())
+        if (i_check(object))
+            i_objects.push_back(object);
 }
 
 template<class Builder>
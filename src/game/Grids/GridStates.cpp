@@ -37,6 +37,7 @@ ActiveState::Update(Map& m, NGridType& grid, GridInfo& info, const uint32& x, co
             ObjectGridStoper stoper(grid);
             stoper.StopN();
             grid.SetGridState(GRID_STATE_IDLE);
+            m.ScheduleGridState(grid, 0);
         }
         else
         {
@@ -61,11 +62,19 @@ RemovalState::Update(Map& m, NGridType& grid, GridInfo& info, const uint32& x, c
         info.UpdateTimeTracker(t_diff);
         if (info.getTimeTracker().Passed())
         {
-            if (!m.UnloadGrid(x, y, false))
+            // budget of this update spent, keep the grid for the next one
+            if (!m.HasGridUnloadBudget())
+                m.ScheduleGridState(grid, 1);
+            else if (!m.UnloadGrid(x, y, false))
             {
                 DEBUG_LOG("Grid[%u,%u] for map %u differed unloading due to players or active objects nearby", x, y, m.GetId());
                 m.ResetGridExpiry(grid);
             }
         }
     }
+    else
+    {
+        // nothing tells when the lock is released, look again later
+        m.ResetGridExpiry(grid, 0.1f);
+    }
 }
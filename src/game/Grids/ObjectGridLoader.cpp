@@ -105,7 +105,7 @@ template<> void addUnitState(Creature* obj, CellPair const& cell_pair)
 }
 
 template <class T>
-void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>& /*m*/, uint32& count, Map* map, GridType& grid)
+void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>& /*m*/, uint32& count, Map* map, GridType& grid, bool updateVisibility)
 {
     BattleGround* bg = map->IsBattleGroundOrArena() ? ((BattleGroundMap*)map)->GetBG() : nullptr;
 
@@ -132,6 +132,9 @@ void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>&
         if (bg)
             bg->OnObjectDBLoad(obj);
 
+        if (updateVisibility)
+            obj->UpdateVisibilityAndView();
+
         ++count;
     }
 }
@@ -175,8 +178,8 @@ ObjectGridLoader::Visit(GameObjectMapType& m)
     CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
 
     GridType& grid = (*i_map->getNGrid(i_cell.GridX(), i_cell.GridY()))(i_cell.CellX(), i_cell.CellY());
-    LoadHelper(cell_guids.gameobjects, cell_pair, m, i_gameObjects, i_map, grid);
-    LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).gameobjects, cell_pair, m, i_gameObjects, i_map, grid);
+    LoadHelper(cell_guids.gameobjects, cell_pair, m, i_gameObjects, i_map, grid, i_lazyCell);
+    LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).gameobjects, cell_pair, m, i_gameObjects, i_map, grid, i_lazyCell);
 }
 
 void
@@ -190,8 +193,8 @@ ObjectGridLoader::Visit(CreatureMapType& m)
     CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
 
     GridType& grid = (*i_map->getNGrid(i_cell.GridX(), i_cell.GridY()))(i_cell.CellX(), i_cell.CellY());
-    LoadHelper(cell_guids.creatures, cell_pair, m, i_creatures, i_map, grid);
-    LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).creatures, cell_pair, m, i_creatures, i_map, grid);
+    LoadHelper(cell_guids.creatures, cell_pair, m, i_creatures, i_map, grid, i_lazyCell);
+    LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).creatures, cell_pair, m, i_creatures, i_map, grid, i_lazyCell);
 }
 
 void
@@ -211,6 +214,7 @@ ObjectWorldLoader::Visit(CorpseMapType& m)
 void
 ObjectGridLoader::Load(GridType& grid)
 {
+    if (i_gridObjects)
     {
         TypeContainerVisitor<ObjectGridLoader, GridTypeMapContainer > loader(*this);
         grid.Visit(loader);
@@ -226,6 +230,11 @@ ObjectGridLoader::Load(GridType& grid)
 
 void ObjectGridLoader::LoadN(void)
 {
+    // with lazy cells only the cell that caused the load gets its creatures and gameobjects now
+    bool const lazy = i_map->HasLazyCellObjects();
+    uint32 const loadX = i_cell.CellX();
+    uint32 const loadY = i_cell.CellY();
+
     i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
     i_cell.data.Part.cell_y = 0;
     for (unsigned int x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
@@ -234,6 +243,10 @@ void ObjectGridLoader::LoadN(void)
         for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
         {
             i_cell.data.Part.cell_y = y;
+            i_gridObjects = !lazy || (x == loadX && y == loadY);
+            if (i_gridObjects)
+                i_grid.setCellObjectDataLoaded(x, y);
+
             GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> loader;
             loader.Load(i_grid(x, y), *this);
         }
@@ -241,6 +254,15 @@ void ObjectGridLoader::LoadN(void)
     DETAIL_FILTER_LOG(LOG_FILTER_MAP_LOADING, "%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u", i_gameObjects, i_creatures, i_corpses, i_grid.GetGridId(), i_map->GetId());
 }
 
+void ObjectGridLoader::LoadCell()
+{
+    i_gameObjects = 0; i_creatures = 0;
+    i_lazyCell = true;
+    TypeContainerVisitor<ObjectGridLoader, GridTypeMapContainer > loader(*this);
+    i_grid(i_cell.CellX(), i_cell.CellY()).Visit(loader);
+    DETAIL_FILTER_LOG(LOG_FILTER_MAP_LOADING, "%u GameObjects and %u Creatures loaded for cell [%u,%u] of grid %u on map %u", i_gameObjects, i_creatures, i_cell.CellX(), i_cell.CellY(), i_grid.GetGridId(), i_map->GetId());
+}
+
 void ObjectGridUnloader::MoveToRespawnN()
 {
     for (unsigned int x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
@@ -33,7 +33,7 @@ class ObjectGridLoader
 
     public:
         ObjectGridLoader(NGridType& grid, Map* map, const Cell& cell)
-            : i_cell(cell), i_grid(grid), i_map(map), i_gameObjects(0), i_creatures(0), i_corpses(0)
+            : i_cell(cell), i_grid(grid), i_map(map), i_gameObjects(0), i_creatures(0), i_corpses(0), i_gridObjects(true), i_lazyCell(false)
         {}
 
         void Load(GridType& grid);
@@ -44,6 +44,8 @@ class ObjectGridLoader
         void Visit(DynamicObjectMapType&) { }
 
         void LoadN(void);
+        // grid objects of the constructor cell in an already loaded grid, see Map::EnsureCellObjectsLoaded
+        void LoadCell();
 
     private:
         Cell i_cell;
@@ -52,6 +54,8 @@ class ObjectGridLoader
         uint32 i_gameObjects;
         uint32 i_creatures;
         uint32 i_corpses;
+        bool i_gridObjects;                                 // load creatures and gameobjects of the visited cell
+        bool i_lazyCell;                                    // the cell is loaded into a grid players may already see
 };
 
 class ObjectGridUnloader
@@ -965,11 +965,17 @@ void Group::_updateMembersOnRosterChanged(Player* changed)
     // [XFACTION]: Prepare to alter fields if detected crossfaction group interaction
     const bool xfaction = sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP);
 
-    if (!fow && !xfaction)
-        return;
-
     auto update = [&fow, &xfaction] (Unit* pov, Unit* target)
     {
+        // group only fields are filtered by the group membership of the viewer, resend them
+        if (target->GetTypeId() == TYPEID_PLAYER)
+        {
+            Player* player = static_cast<Player*>(target);
+            for (uint16 slot = 0; slot < MAX_QUEST_LOG_SIZE; ++slot)
+                if (player->GetQuestSlotQuestId(slot))
+                    player->ForceValuesUpdateAtIndex(PLAYER_QUEST_LOG_1_1 + slot * MAX_QUEST_OFFSET + QUEST_ID_OFFSET);
+        }
+
         if (fow)
         {
             auto forcehp = [] (Unit* u) { u->ForceValuesUpdateAtIndex(UNIT_FIELD_HEALTH); u->ForceValuesUpdateAtIndex(UNIT_FIELD_MAXHEALTH); };
@@ -17,6 +17,7 @@
  */
 
 #include "Database/DatabaseEnv.h"
+#include "Database/DatabaseImpl.h"
 #include "WorldPacket.h"
 #include "Server/WorldSession.h"
 #include "Entities/Player.h"
@@ -29,6 +30,64 @@
 #include "Util.h"
 #include "Tools/Language.h"
 #include "World/World.h"
+#include "Entities/CharEnumCache.h"
+
+enum GuildBankDataQueryIndex
+{
+    GUILD_BANK_DATA_QUERY_TABS,
+    GUILD_BANK_DATA_QUERY_ITEMS,
+    GUILD_BANK_DATA_QUERY_EVENT_LOG,
+    GUILD_BANK_DATA_QUERY_BANK_EVENT_LOG,
+
+    MAX_GUILD_BANK_DATA_QUERY
+};
+
+// expands the limit before it is turned into a string
+#define GUILD_QUERY_LIMIT(limit) STRINGIZE(limit)
+
+// all take the guild id, the same statements are used for synchronous and async loads
+static char const* const guildBankDataQueries[MAX_GUILD_BANK_DATA_QUERY] =
+{
+    //      0      1        2        3
+    "SELECT TabId, TabName, TabIcon, TabText FROM guild_bank_tab WHERE guildid='%u' ORDER BY TabId",
+    // data needs to be at first place for Item::LoadFromDB
+    //      0     1      2       3          4
+    "SELECT data, TabId, SlotId, item_guid, item_entry FROM guild_bank_item JOIN item_instance ON item_guid = guid WHERE guildid='%u' ORDER BY TabId",
+    //      0        1          2            3            4        5
+    "SELECT LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp FROM guild_eventlog WHERE guildid='%u' ORDER BY TimeStamp DESC,LogGuid DESC LIMIT " GUILD_QUERY_LIMIT(GUILD_EVENTLOG_MAX_RECORDS),
+    // all item tabs and the money log at once, each keeps its newest GUILD_BANK_MAX_LOGS while loading
+    //      0        1          2           3            4               5          6          7
+    "SELECT LogGuid, EventType, PlayerGuid, ItemOrMoney, ItemStackCount, DestTabId, TimeStamp, TabId FROM guild_bank_eventlog WHERE guildid='%u' ORDER BY TimeStamp DESC,LogGuid DESC",
+};
+
+class GuildBankDataQueryHolder : public SqlQueryHolder
+{
+    public:
+        GuildBankDataQueryHolder(uint32 guildId, uint32 request) : m_guildId(guildId), m_request(request) {}
+
+        uint32 GetGuildId() const { return m_guildId; }
+        uint32 GetRequest() const { return m_request; }
+
+    private:
+        uint32 m_guildId;
+        uint32 m_request;
+};
+
+class GuildBankDataLoadHandler
+{
+    public:
+        void HandleLoadCallback(QueryResult* /*dummy*/, SqlQueryHolder* holder)
+        {
+            if (!holder)
+                return;
+
+            GuildBankDataQueryHolder* bankHolder = static_cast<GuildBankDataQueryHolder*>(holder);
+            if (Guild* guild = sGuildMgr.GetGuildById(bankHolder->GetGuildId()))
+                guild->HandleBankDataLoaded(holder, bankHolder->GetRequest());
+
+            delete holder;                                  // frees the results of a stale or disbanded load
+        }
+} guildBankDataLoadHandler;
 
 //// MemberSlot ////////////////////////////////////////////
 void MemberSlot::SetMemberStats(Player* player)
@@ -100,6 +159,11 @@ Guild::Guild()
     m_GuildBankEventLogNextGuid_Money = 0;
     for (unsigned int& i : m_GuildBankEventLogNextGuid_Item)
         i = 0;
+
+    m_bankDataLoaded = false;
+    m_bankDataLoading = false;
+    m_bankDataRequest = 0;
+    m_bankDataLastUse = 0;
 }
 
 Guild::~Guild()
@@ -123,6 +187,10 @@ bool Guild::Create(Player* leader, std::string gname)
     m_GuildBankMoney = 0;
     m_Id = sObjectMgr.GenerateGuildId();
 
+    // a new guild has no bank data in the database yet
+    m_bankDataLoaded = true;
+    m_bankDataLastUse = time(nullptr);
+
     // creating data
     time_t now = time(nullptr);
     tm local = *(localtime(&now));                          // dereference and assign
@@ -241,6 +309,7 @@ bool Guild::AddMember(ObjectGuid plGuid, uint32 plRank)
 
     CharacterDatabase.PExecute("INSERT INTO guild_member (guildid,guid,`rank`,pnote,offnote) VALUES ('%u', '%u', '%u','%s','%s')",
                                m_Id, lowguid, newmember.RankId, dbPnote.c_str(), dbOFFnote.c_str());
+    sCharEnumCache.InvalidateCharacter(lowguid);
 
     // If player not in game data in data field will be loaded from guild tables, no need to update it!!
     if (pl)
@@ -248,6 +317,7 @@ bool Guild::AddMember(ObjectGuid plGuid, uint32 plRank)
         pl->SetInGuild(m_Id);
         pl->SetRank(newmember.RankId);
         pl->SetGuildIdInvited(0);
+        m_onlineMembers.insert(lowguid);
     }
 
     UpdateAccountsNumber();
@@ -563,6 +633,7 @@ bool Guild::DelMember(ObjectGuid guid, bool isDisbanding)
     }
 
     members.erase(lowguid);
+    m_onlineMembers.erase(lowguid);
 
     Player* player = sObjectMgr.GetPlayer(guid);
     // If player not online data in data field will be loaded from guild tabs no need to update it !!
@@ -573,6 +644,7 @@ bool Guild::DelMember(ObjectGuid guid, bool isDisbanding)
     }
 
     CharacterDatabase.PExecute("DELETE FROM guild_member WHERE guid = '%u'", lowguid);
+    sCharEnumCache.InvalidateCharacter(lowguid);
 
     if (!isDisbanding)
         UpdateAccountsNumber();
@@ -592,9 +664,9 @@ void Guild::BroadcastToGuild(WorldSession* session, const std::string& msg, uint
     WorldPacket data;
     ChatHandler::BuildChatPacket(data, CHAT_MSG_GUILD, msg.c_str(), Language(language), player->GetChatTag(), player->GetObjectGuid(), player->GetName());
 
-    for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
+    for (uint32 memberLowGuid : m_onlineMembers)
     {
-        Player* pl = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
+        Player* pl = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, memberLowGuid));
 
         if (pl && pl->GetSession() && HasRankRight(pl->GetRank(), GR_RIGHT_GCHATLISTEN) && !pl->GetSocial()->HasIgnore(player->GetObjectGuid()))
             pl->GetSession()->SendPacket(data);
@@ -610,12 +682,12 @@ void Guild::BroadcastToOfficers(WorldSession* session, const std::string& msg, u
     if (!player || !HasRankRight(player->GetRank(), GR_RIGHT_OFFCHATSPEAK))
         return;
 
-    for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
-    {
-        WorldPacket data;
-        ChatHandler::BuildChatPacket(data, CHAT_MSG_OFFICER, msg.c_str(), Language(language), player->GetChatTag(), player->GetObjectGuid(), player->GetName());
+    WorldPacket data;
+    ChatHandler::BuildChatPacket(data, CHAT_MSG_OFFICER, msg.c_str(), Language(language), player->GetChatTag(), player->GetObjectGuid(), player->GetName());
 
-        Player* pl = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
+    for (uint32 memberLowGuid : m_onlineMembers)
+    {
+        Player* pl = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, memberLowGuid));
 
         if (pl && pl->GetSession() && HasRankRight(pl->GetRank(), GR_RIGHT_OFFCHATLISTEN) && !pl->GetSocial()->HasIgnore(player->GetObjectGuid()))
             pl->GetSession()->SendPacket(data);
@@ -624,9 +696,9 @@ void Guild::BroadcastToOfficers(WorldSession* session, const std::string& msg, u
 
 void Guild::BroadcastPacket(WorldPacket const& packet) const
 {
-    for (MemberList::const_iterator itr = members.cbegin(); itr != members.cend(); ++itr)
+    for (uint32 memberLowGuid : m_onlineMembers)
     {
-        Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
+        Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, memberLowGuid));
         if (player)
             player->GetSession()->SendPacket(packet);
     }
@@ -634,17 +706,29 @@ void Guild::BroadcastPacket(WorldPacket const& packet) const
 
 void Guild::BroadcastPacketToRank(WorldPacket const& packet, uint32 rankId) const
 {
-    for (MemberList::const_iterator itr = members.cbegin(); itr != members.cend(); ++itr)
+    for (uint32 memberLowGuid : m_onlineMembers)
     {
-        if (itr->second.RankId == rankId)
+        MemberList::const_iterator itr = members.find(memberLowGuid);
+        if (itr != members.end() && itr->second.RankId == rankId)
         {
-            Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
+            Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, memberLowGuid));
             if (player)
                 player->GetSession()->SendPacket(packet);
         }
     }
 }
 
+void Guild::SetMemberOnline(ObjectGuid guid, bool online)
+{
+    if (!online)
+        m_onlineMembers.erase(guid.GetCounter());
+    else if (members.find(guid.GetCounter()) != members.end())
+    {
+        m_onlineMembers.insert(guid.GetCounter());
+        PrefetchBankData();
+    }
+}
+
 void Guild::CreateRank(std::string name_, uint32 rights)
 {
     if (m_Ranks.size() >= GUILD_RANKS_MAX_COUNT)
@@ -745,6 +829,7 @@ void Guild::Disband()
     CharacterDatabase.PExecute("DELETE FROM guild_bank_tab WHERE guildid = '%u'", m_Id);
 
     // Free bank tab used memory and delete items stored in them
+    LoadBankDataIfNeeded();
     DeleteGuildBankItems(true);
 
     CharacterDatabase.PExecute("DELETE FROM guild_bank_item WHERE guildid = '%u'", m_Id);
@@ -873,6 +958,8 @@ uint32 Guild::GetAccountsNumber()
 // Display guild eventlog
 void Guild::DisplayGuildEventLog(WorldSession* session)
 {
+    LoadBankDataIfNeeded();
+
     // Sending result
     WorldPacket data(MSG_GUILD_EVENT_LOG_QUERY, 0);
     // count, max count == 100
@@ -896,11 +983,9 @@ void Guild::DisplayGuildEventLog(WorldSession* session)
     DEBUG_LOG("WORLD: Sent (MSG_GUILD_EVENT_LOG_QUERY)");
 }
 
-// Load guild eventlog from DB
-void Guild::LoadGuildEventLogFromDB()
+// Load guild eventlog from DB, takes ownership of the result
+void Guild::LoadGuildEventLogFromDB(QueryResult* result)
 {
-    //                                                     0        1          2            3            4        5
-    QueryResult* result = CharacterDatabase.PQuery("SELECT LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp FROM guild_eventlog WHERE guildid=%u ORDER BY TimeStamp DESC,LogGuid DESC LIMIT %u", m_Id, GUILD_EVENTLOG_MAX_RECORDS);
     if (!result)
         return;
     bool isNextLogGuidSet = false;
@@ -936,6 +1021,8 @@ void Guild::LoadGuildEventLogFromDB()
 // Add entry to guild eventlog
 void Guild::LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid playerGuid2, uint8 newRank)
 {
+    LoadBankDataIfNeeded();
+
     GuildEventLogEntry NewEvent;
     // Create event
     NewEvent.EventType = EventType;
@@ -962,6 +1049,8 @@ void Guild::LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid pl
 // Bank content related
 void Guild::DisplayGuildBankContent(WorldSession* session, uint8 TabId)
 {
+    LoadBankDataIfNeeded();
+
     GuildBankTab const* tab = m_TabListMap[TabId];
 
     if (!IsMemberHaveRights(session->GetPlayer()->GetGUIDLow(), TabId, GUILD_BANK_RIGHT_VIEW_TAB))
@@ -1029,13 +1118,13 @@ void Guild::DisplayGuildBankContentUpdate(uint8 TabId, int32 slot1, int32 slot2)
         AppendDisplayGuildBankSlot(data, tab, slot2);
     }
 
-    for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
+    for (uint32 memberLowGuid : m_onlineMembers)
     {
-        Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
+        Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, memberLowGuid));
         if (!player)
             continue;
 
-        if (!IsMemberHaveRights(itr->first, TabId, GUILD_BANK_RIGHT_VIEW_TAB))
+        if (!IsMemberHaveRights(memberLowGuid, TabId, GUILD_BANK_RIGHT_VIEW_TAB))
             continue;
 
         data.put<uint32>(rempos, uint32(GetMemberSlotWithdrawRem(player->GetGUIDLow(), TabId)));
@@ -1064,13 +1153,13 @@ void Guild::DisplayGuildBankContentUpdate(uint8 TabId, GuildItemPosCountVec cons
     for (auto slot : slots)
         AppendDisplayGuildBankSlot(data, tab, slot.Slot);
 
-    for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
+    for (uint32 memberLowGuid : m_onlineMembers)
     {
-        Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
+        Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, memberLowGuid));
         if (!player)
             continue;
 
-        if (!IsMemberHaveRights(itr->first, TabId, GUILD_BANK_RIGHT_VIEW_TAB))
+        if (!IsMemberHaveRights(memberLowGuid, TabId, GUILD_BANK_RIGHT_VIEW_TAB))
             continue;
 
         data.put<uint32>(rempos, uint32(GetMemberSlotWithdrawRem(player->GetGUIDLow(), TabId)));
@@ -1093,6 +1182,8 @@ Item* Guild::GetItem(uint8 TabId, uint8 SlotId)
 
 void Guild::DisplayGuildBankTabsInfo(WorldSession* session)
 {
+    LoadBankDataIfNeeded();
+
     WorldPacket data(SMSG_GUILD_BANK_LIST, 500);
 
     data << uint64(GetGuildBankMoney());
@@ -1115,6 +1206,8 @@ void Guild::DisplayGuildBankTabsInfo(WorldSession* session)
 
 void Guild::CreateNewBankTab()
 {
+    LoadBankDataIfNeeded();
+
     if (GetPurchasedTabs() >= GUILD_BANK_MAX_TABS)
         return;
 
@@ -1129,6 +1222,8 @@ void Guild::CreateNewBankTab()
 
 void Guild::SetGuildBankTabInfo(uint8 TabId, std::string Name, std::string Icon)
 {
+    LoadBankDataIfNeeded();
+
     if (m_TabListMap[TabId]->Name == Name && m_TabListMap[TabId]->Icon == Icon)
         return;
 
@@ -1151,42 +1246,33 @@ uint32 Guild::GetBankRights(uint32 rankId, uint8 TabId) const
 // *************************************************
 // Guild bank loading related
 
-// This load should be called on startup only
-void Guild::LoadGuildBankFromDB()
+// Fills the purchased tabs created in LoadGuildFromDB, takes ownership of the results
+void Guild::LoadGuildBankFromDB(QueryResult* tabResult, QueryResult* itemResult)
 {
-    //                                                     0      1        2        3
-    QueryResult* result = CharacterDatabase.PQuery("SELECT TabId, TabName, TabIcon, TabText FROM guild_bank_tab WHERE guildid='%u' ORDER BY TabId", m_Id);
-    if (!result)
-    {
-        m_TabListMap.clear();
-        return;
-    }
-
-    do
+    if (tabResult)
     {
-        Field* fields = result->Fetch();
-        uint8 tabId = fields[0].GetUInt8();
-        if (tabId >= GetPurchasedTabs())
+        do
         {
-            sLog.outError("Table `guild_bank_tab` have not purchased tab %u for guild %u, skipped", tabId, m_Id);
-            continue;
-        }
+            Field* fields = tabResult->Fetch();
+            uint8 tabId = fields[0].GetUInt8();
+            if (tabId >= GetPurchasedTabs())
+            {
+                sLog.outError("Table `guild_bank_tab` have not purchased tab %u for guild %u, skipped", tabId, m_Id);
+                continue;
+            }
 
-        GuildBankTab* NewTab = new GuildBankTab;
+            GuildBankTab* tab = m_TabListMap[tabId];
 
-        NewTab->Name = fields[1].GetCppString();
-        NewTab->Icon = fields[2].GetCppString();
-        NewTab->Text = fields[3].GetCppString();
+            tab->Name = fields[1].GetCppString();
+            tab->Icon = fields[2].GetCppString();
+            tab->Text = fields[3].GetCppString();
+        }
+        while (tabResult->NextRow());
 
-        m_TabListMap[tabId] = NewTab;
+        delete tabResult;
     }
-    while (result->NextRow());
 
-    delete result;
-
-    // data needs to be at first place for Item::LoadFromDB
-    //                                        0     1      2       3          4
-    result = CharacterDatabase.PQuery("SELECT data, TabId, SlotId, item_guid, item_entry FROM guild_bank_item JOIN item_instance ON item_guid = guid WHERE guildid='%u' ORDER BY TabId", m_Id);
+    QueryResult* result = itemResult;
     if (!result)
         return;
 
@@ -1235,6 +1321,85 @@ void Guild::LoadGuildBankFromDB()
     delete result;
 }
 
+void Guild::LoadBankDataIfNeeded()
+{
+    m_bankDataLastUse = time(nullptr);
+
+    if (m_bankDataLoaded)
+        return;
+
+    // an async load still running is stale from now on
+    ++m_bankDataRequest;
+    m_bankDataLoading = false;
+
+    QueryResult* results[MAX_GUILD_BANK_DATA_QUERY];
+    for (uint32 i = 0; i < MAX_GUILD_BANK_DATA_QUERY; ++i)
+        results[i] = CharacterDatabase.PQuery(guildBankDataQueries[i], m_Id);
+
+    m_bankDataLoaded = true;
+    LoadGuildBankFromDB(results[GUILD_BANK_DATA_QUERY_TABS], results[GUILD_BANK_DATA_QUERY_ITEMS]);
+    LoadGuildEventLogFromDB(results[GUILD_BANK_DATA_QUERY_EVENT_LOG]);
+    LoadGuildBankEventLogFromDB(results[GUILD_BANK_DATA_QUERY_BANK_EVENT_LOG]);
+}
+
+void Guild::PrefetchBankData()
+{
+    if (m_bankDataLoaded || m_bankDataLoading)
+        return;
+
+    GuildBankDataQueryHolder* holder = new GuildBankDataQueryHolder(m_Id, ++m_bankDataRequest);
+    holder->SetSize(MAX_GUILD_BANK_DATA_QUERY);
+    for (uint32 i = 0; i < MAX_GUILD_BANK_DATA_QUERY; ++i)
+        holder->SetPQuery(i, guildBankDataQueries[i], m_Id);
+
+    m_bankDataLoading = true;
+    CharacterDatabase.DelayQueryHolder(&guildBankDataLoadHandler, &GuildBankDataLoadHandler::HandleLoadCallback, holder);
+}
+
+void Guild::HandleBankDataLoaded(SqlQueryHolder* holder, uint32 request)
+{
+    // loaded synchronously in the meantime, the holder frees the results
+    if (m_bankDataLoaded || request != m_bankDataRequest)
+        return;
+
+    m_bankDataLoading = false;
+    m_bankDataLoaded = true;
+    m_bankDataLastUse = time(nullptr);
+
+    LoadGuildBankFromDB(holder->GetResult(GUILD_BANK_DATA_QUERY_TABS), holder->GetResult(GUILD_BANK_DATA_QUERY_ITEMS));
+    LoadGuildEventLogFromDB(holder->GetResult(GUILD_BANK_DATA_QUERY_EVENT_LOG));
+    LoadGuildBankEventLogFromDB(holder->GetResult(GUILD_BANK_DATA_QUERY_BANK_EVENT_LOG));
+}
+
+bool Guild::UnloadBankDataIfIdle(time_t now, uint32 delay)
+{
+    // members online may use the bank or get events logged any time
+    if (!m_bankDataLoaded || !m_onlineMembers.empty() || m_bankDataLastUse + time_t(delay) > now)
+        return false;
+
+    // every change is written at once, nothing to save here
+    DeleteGuildBankTabItems(false);
+    for (auto& tab : m_TabListMap)
+    {
+        tab->Name.clear();
+        tab->Icon.clear();
+        tab->Text.clear();
+    }
+
+    m_GuildEventLog.clear();
+    m_GuildBankEventLog_Money.clear();
+    for (auto& log : m_GuildBankEventLog_Item)
+        log.clear();
+
+    m_GuildEventLogNextGuid = 0;
+    m_GuildBankEventLogNextGuid_Money = 0;
+    for (unsigned int& i : m_GuildBankEventLogNextGuid_Item)
+        i = 0;
+
+    m_bankDataLoaded = false;
+    return true;
+}
+
 // *************************************************
 // Money deposit/withdraw related
 
@@ -1473,73 +1638,23 @@ bool Guild::LoadBankRightsFromDB(QueryResult* guildBankTabRightsResult)
 // *************************************************
 // Bank log related
 
-void Guild::LoadGuildBankEventLogFromDB()
+// Money log is in TabId = GUILD_BANK_MONEY_LOGS_TAB, takes ownership of the result
+void Guild::LoadGuildBankEventLogFromDB(QueryResult* result)
 {
-    // Money log is in TabId = GUILD_BANK_MONEY_LOGS_TAB
-
-    // uint32 configCount = sWorld.getConfig(CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT);
-    // cycle through all purchased guild bank item tabs
-    for (uint32 tabId = 0; tabId < uint32(GetPurchasedTabs()); ++tabId)
-    {
-        //                                                     0        1          2           3            4               5          6
-        QueryResult* result = CharacterDatabase.PQuery("SELECT LogGuid, EventType, PlayerGuid, ItemOrMoney, ItemStackCount, DestTabId, TimeStamp FROM guild_bank_eventlog WHERE guildid='%u' AND TabId='%u' ORDER BY TimeStamp DESC,LogGuid DESC LIMIT %u", m_Id, tabId, GUILD_BANK_MAX_LOGS);
-        if (!result)
-            continue;
-
-        bool isNextLogGuidSet = false;
-        do
-        {
-            Field* fields = result->Fetch();
-
-            GuildBankEventLogEntry NewEvent;
-            NewEvent.EventType = fields[1].GetUInt8();
-            NewEvent.PlayerGuid = fields[2].GetUInt32();
-            NewEvent.ItemOrMoney = fields[3].GetUInt32();
-            NewEvent.ItemStackCount = fields[4].GetUInt8();
-            NewEvent.DestTabId = fields[5].GetUInt8();
-            NewEvent.TimeStamp = fields[6].GetUInt64();
-
-            // if newEvent is moneyEvent, move it to moneyEventTab in DB and report error
-            if (NewEvent.isMoneyEvent())
-            {
-                uint32 logGuid = fields[0].GetUInt32();
-                CharacterDatabase.PExecute("UPDATE guild_bank_eventlog SET TabId='%u' WHERE guildid='%u' AND TabId='%u' AND LogGuid='%u'", GUILD_BANK_MONEY_LOGS_TAB, m_Id, tabId, logGuid);
-                sLog.outError("GuildBankEventLog ERROR: MoneyEvent LogGuid %u for Guild %u had incorrectly set its TabId to %u, correcting it to %u TabId", logGuid, m_Id, tabId, GUILD_BANK_MONEY_LOGS_TAB);
-                continue;
-            }
-                // add event to list
-                // events are ordered from oldest (in beginning) to latest (in the end)
-            m_GuildBankEventLog_Item[tabId].push_front(NewEvent);
-
-            if (!isNextLogGuidSet)
-            {
-                m_GuildBankEventLogNextGuid_Item[tabId] = fields[0].GetUInt32();
-                // we don't have to do m_GuildBankEventLogNextGuid_Item[tabId] %= configCount; - it will be done when creating new record
-                isNextLogGuidSet = true;
-            }
-        }
-        while (result->NextRow());
-        delete result;
-    }
-
-    // special handle for guild bank money log
-    //                                                     0        1          2           3            4               5          6
-    QueryResult* result = CharacterDatabase.PQuery("SELECT LogGuid, EventType, PlayerGuid, ItemOrMoney, ItemStackCount, DestTabId, TimeStamp FROM guild_bank_eventlog WHERE guildid='%u' AND TabId='%u' ORDER BY TimeStamp DESC,LogGuid DESC LIMIT %u", m_Id, GUILD_BANK_MONEY_LOGS_TAB, GUILD_BANK_MAX_LOGS);
     if (!result)
         return;
 
+    // uint32 configCount = sWorld.getConfig(CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT);
+    // rows are newest first, the first row of each tab gives its next guid
+    bool isNextLogGuidSet[GUILD_BANK_MAX_TABS] = {};
     bool isNextMoneyLogGuidSet = false;
     do
     {
         Field* fields = result->Fetch();
-        if (!isNextMoneyLogGuidSet)
-        {
-            m_GuildBankEventLogNextGuid_Money = fields[0].GetUInt32();
-            // we don't have to do m_GuildBankEventLogNextGuid_Money %= configCount; - it will be done when creating new record
-            isNextMoneyLogGuidSet = true;
-        }
-        GuildBankEventLogEntry NewEvent;
+        uint32 logGuid = fields[0].GetUInt32();
+        uint32 tabId = fields[7].GetUInt32();
 
+        GuildBankEventLogEntry NewEvent;
         NewEvent.EventType = fields[1].GetUInt8();
         NewEvent.PlayerGuid = fields[2].GetUInt32();
         NewEvent.ItemOrMoney = fields[3].GetUInt32();
@@ -1547,13 +1662,50 @@ void Guild::LoadGuildBankEventLogFromDB()
         NewEvent.DestTabId = fields[5].GetUInt8();
         NewEvent.TimeStamp = fields[6].GetUInt64();
 
-        // if newEvent is not moneyEvent, then report error
-        if (!NewEvent.isMoneyEvent())
-            sLog.outError("GuildBankEventLog ERROR: MoneyEvent LogGuid %u for Guild %u is not MoneyEvent - ignoring...", fields[0].GetUInt32(), m_Id);
-        else
-            // add event to list
-            // events are ordered from oldest (in beginning) to latest (in the end)
-            m_GuildBankEventLog_Money.push_front(NewEvent);
+        // special handle for guild bank money log
+        if (tabId == GUILD_BANK_MONEY_LOGS_TAB)
+        {
+            if (!isNextMoneyLogGuidSet)
+            {
+                m_GuildBankEventLogNextGuid_Money = logGuid;
+                // we don't have to do m_GuildBankEventLogNextGuid_Money %= configCount; - it will be done when creating new record
+                isNextMoneyLogGuidSet = true;
+            }
+
+            if (m_GuildBankEventLog_Money.size() >= GUILD_BANK_MAX_LOGS)
+                continue;
+
+            // if newEvent is not moneyEvent, then report error
+            if (!NewEvent.isMoneyEvent())
+                sLog.outError("GuildBankEventLog ERROR: MoneyEvent LogGuid %u for Guild %u is not MoneyEvent - ignoring...", logGuid, m_Id);
+            else
+                // add event to list
+                // events are ordered from oldest (in beginning) to latest (in the end)
+                m_GuildBankEventLog_Money.push_front(NewEvent);
+            continue;
+        }
+
+        // only purchased guild bank item tabs
+        if (tabId >= uint32(GetPurchasedTabs()) || m_GuildBankEventLog_Item[tabId].size() >= GUILD_BANK_MAX_LOGS)
+            continue;
+
+        // if newEvent is moneyEvent, move it to moneyEventTab in DB and report error
+        if (NewEvent.isMoneyEvent())
+        {
+            CharacterDatabase.PExecute("UPDATE guild_bank_eventlog SET TabId='%u' WHERE guildid='%u' AND TabId='%u' AND LogGuid='%u'", GUILD_BANK_MONEY_LOGS_TAB, m_Id, tabId, logGuid);
+            sLog.outError("GuildBankEventLog ERROR: MoneyEvent LogGuid %u for Guild %u had incorrectly set its TabId to %u, correcting it to %u TabId", logGuid, m_Id, tabId, GUILD_BANK_MONEY_LOGS_TAB);
+            continue;
+        }
+        // add event to list
+        // events are ordered from oldest (in beginning) to latest (in the end)
+        m_GuildBankEventLog_Item[tabId].push_front(NewEvent);
+
+        if (!isNextLogGuidSet[tabId])
+        {
+            m_GuildBankEventLogNextGuid_Item[tabId] = logGuid;
+            // we don't have to do m_GuildBankEventLogNextGuid_Item[tabId] %= configCount; - it will be done when creating new record
+            isNextLogGuidSet[tabId] = true;
+        }
     }
     while (result->NextRow());
     delete result;
@@ -1561,6 +1713,8 @@ void Guild::LoadGuildBankEventLogFromDB()
 
 void Guild::DisplayGuildBankLogs(WorldSession* session, uint8 TabId)
 {
+    LoadBankDataIfNeeded();
+
     if (TabId > GUILD_BANK_MAX_TABS)
         return;
 
@@ -1603,6 +1757,8 @@ void Guild::DisplayGuildBankLogs(WorldSession* session, uint8 TabId)
 
 void Guild::LogBankEvent(uint8 EventType, uint8 TabId, uint32 PlayerGuidLow, uint32 ItemOrMoney, uint8 ItemStackCount, uint8 DestTabId)
 {
+    LoadBankDataIfNeeded();
+
     // create Event
     GuildBankEventLogEntry NewEvent;
     NewEvent.EventType = EventType;
@@ -1910,6 +2066,8 @@ InventoryResult Guild::CanStoreItem(uint8 tab, uint8 slot, GuildItemPosCountVec&
 
 void Guild::SetGuildBankTabText(uint8 TabId, std::string text)
 {
+    LoadBankDataIfNeeded();
+
     if (TabId >= GetPurchasedTabs())
         return;
 
@@ -1932,6 +2090,8 @@ void Guild::SetGuildBankTabText(uint8 TabId, std::string text)
 
 void Guild::SendGuildBankTabText(WorldSession* session, uint8 TabId)
 {
+    LoadBankDataIfNeeded();
+
     GuildBankTab const* tab = m_TabListMap[TabId];
 
     WorldPacket data(MSG_QUERY_GUILD_BANK_TEXT, 1 + tab->Text.size() + 1);
@@ -1946,6 +2106,8 @@ void Guild::SendGuildBankTabText(WorldSession* session, uint8 TabId)
 
 void Guild::SwapItems(Player* pl, uint8 BankTab, uint8 BankTabSlot, uint8 BankTabDst, uint8 BankTabSlotDst, uint32 SplitedAmount)
 {
+    LoadBankDataIfNeeded();
+
     // empty operation
     if (BankTab == BankTabDst && BankTabSlot == BankTabSlotDst)
         return;
@@ -2072,6 +2234,8 @@ void Guild::SwapItems(Player* pl, uint8 BankTab, uint8 BankTabSlot, uint8 BankTa
 
 void Guild::MoveFromBankToChar(Player* pl, uint8 BankTab, uint8 BankTabSlot, uint8 PlayerBag, uint8 PlayerSlot, uint32 SplitedAmount)
 {
+    LoadBankDataIfNeeded();
+
     Item* pItemBank = GetItem(BankTab, BankTabSlot);
     Item* pItemChar = pl->GetItemByPos(PlayerBag, PlayerSlot);
 
@@ -2221,6 +2385,8 @@ void Guild::MoveFromBankToChar(Player* pl, uint8 BankTab, uint8 BankTabSlot, uin
 
 void Guild::MoveFromCharToBank(Player* pl, uint8 PlayerBag, uint8 PlayerSlot, uint8 BankTab, uint8 BankTabSlot, uint32 SplitedAmount)
 {
+    LoadBankDataIfNeeded();
+
     Item* pItemBank = GetItem(BankTab, BankTabSlot);
     Item* pItemChar = pl->GetItemByPos(PlayerBag, PlayerSlot);
 
@@ -2400,6 +2566,15 @@ void Guild::BroadcastEvent(GuildEvents event, ObjectGuid guid, char const* str1
 }
 
 void Guild::DeleteGuildBankItems(bool alsoInDB /*= false*/)
+{
+    DeleteGuildBankTabItems(alsoInDB);
+
+    for (auto& i : m_TabListMap)
+        delete i;
+    m_TabListMap.clear();
+}
+
+void Guild::DeleteGuildBankTabItems(bool alsoInDB)
 {
     for (auto& i : m_TabListMap)
     {
@@ -2413,11 +2588,10 @@ void Guild::DeleteGuildBankItems(bool alsoInDB /*= false*/)
                     pItem->DeleteFromDB();
 
                 delete pItem;
+                i->Slots[j] = nullptr;
             }
         }
-        delete i;
     }
-    m_TabListMap.clear();
 }
 
 bool GuildItemPosCount::isContainedIn(GuildItemPosCountVec const& vec) const
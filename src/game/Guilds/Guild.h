@@ -28,6 +28,8 @@
 #include "Globals/SharedDefines.h"
 
 class Item;
+class QueryResult;
+class SqlQueryHolder;
 
 #define GUILD_RANKS_MIN_COUNT   5
 #define GUILD_RANKS_MAX_COUNT   10
@@ -344,6 +346,9 @@ class Guild
         void BroadcastPacketToRank(WorldPacket const& packet, uint32 rankId) const;
         void BroadcastPacket(WorldPacket const& packet) const;
 
+        // members logged in, the broadcasts only look up these
+        void SetMemberOnline(ObjectGuid guid, bool online);
+
         void BroadcastEvent(GuildEvents event, ObjectGuid guid, char const* str1 = nullptr, char const* str2 = nullptr, char const* str3 = nullptr);
         void BroadcastEvent(GuildEvents event, char const* str1 = nullptr, char const* str2 = nullptr, char const* str3 = nullptr)
         {
@@ -396,8 +401,15 @@ class Guild
         void Roster(WorldSession* session = nullptr);          // nullptr = broadcast
         void Query(WorldSession* session);
 
+        // Bank tabs, bank items and both event logs are read on first use and dropped after Guild.BankUnloadDelay without use
+        void   LoadBankDataIfNeeded();
+        void   PrefetchBankData();                          // async, at member login
+        void   HandleBankDataLoaded(SqlQueryHolder* holder, uint32 request);
+        bool   UnloadBankDataIfIdle(time_t now, uint32 delay);
+        bool   IsBankDataLoaded() const { return m_bankDataLoaded; }
+
         // Guild EventLog
-        void   LoadGuildEventLogFromDB();
+        void   LoadGuildEventLogFromDB(QueryResult* result);
         void   DisplayGuildEventLog(WorldSession* session);
         void   LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid playerGuid2 = ObjectGuid(), uint8 newRank = 0);
 
@@ -420,7 +432,7 @@ class Guild
         uint32 GetBankRights(uint32 rankId, uint8 TabId) const;
         bool   IsMemberHaveRights(uint32 LowGuid, uint8 TabId, uint32 rights) const;
         // Load
-        void   LoadGuildBankFromDB();
+        void   LoadGuildBankFromDB(QueryResult* tabResult, QueryResult* itemResult);
         // Money deposit/withdraw
         void   SendMoneyInfo(WorldSession* session, uint32 LowGuid);
         bool   MemberMoneyWithdraw(uint32 amount, uint32 LowGuid);
@@ -437,7 +449,7 @@ class Guild
         // rights per day
         bool   LoadBankRightsFromDB(QueryResult* guildBankTabRightsResult);
         // Guild Bank Event Logs
-        void   LoadGuildBankEventLogFromDB();
+        void   LoadGuildBankEventLogFromDB(QueryResult* result);
         void   DisplayGuildBankLogs(WorldSession* session, uint8 TabId);
         void   LogBankEvent(uint8 EventType, uint8 TabId, uint32 PlayerGuidLow, uint32 ItemOrMoney, uint8 ItemStackCount = 0, uint8 DestTabId = 0);
         bool   AddGBankItemToDB(uint32 GuildId, uint32 BankTab, uint32 BankTabSlot, uint32 GUIDLow, uint32 Entry) const;
@@ -464,6 +476,7 @@ class Guild
         RankList m_Ranks;
 
         MemberList members;
+        std::unordered_set<uint32> m_onlineMembers;         // low guids of the members in the world, see SetMemberOnline
 
         typedef std::vector<GuildBankTab*> TabListMap;
         TabListMap m_TabListMap;
@@ -481,7 +494,14 @@ class Guild
 
         uint64 m_GuildBankMoney;
 
+        bool m_bankDataLoaded;
+        bool m_bankDataLoading;
+        uint32 m_bankDataRequest;                           // id of the last async load, results of older ones are stale
+        time_t m_bankDataLastUse;
+
     private:
+        void DeleteGuildBankTabItems(bool alsoInDB);
+
         void UpdateAccountsNumber() { m_accountsNumber = 0;}// mark for lazy calculation at request in GetAccountsNumber
 
         // used only from high level Swap/Move functions
@@ -83,6 +83,22 @@ std::string GuildMgr::GetGuildNameById(uint32 guildId) const
     return "";
 }
 
+void GuildMgr::UnloadIdleBankData()
+{
+    uint32 delay = sWorld.getConfig(CONFIG_UINT32_GUILD_BANK_UNLOAD_DELAY);
+    if (!delay)
+        return;
+
+    time_t now = time(nullptr);
+    uint32 count = 0;
+    for (auto& itr : m_GuildMap)
+        if (itr.second->UnloadBankDataIfIdle(now, delay))
+            ++count;
+
+    if (count)
+        DEBUG_LOG("GuildMgr: unloaded bank data of %u idle guilds", count);
+}
+
 void GuildMgr::LoadGuilds()
 {
     uint32 count = 0;
@@ -143,9 +159,7 @@ void GuildMgr::LoadGuilds()
             continue;
         }
 
-        newGuild->LoadGuildEventLogFromDB();
-        newGuild->LoadGuildBankEventLogFromDB();
-        newGuild->LoadGuildBankFromDB();
+        // bank tabs, bank items and the event logs are loaded on first use
         AddGuild(newGuild);
     }
     while (result->NextRow());
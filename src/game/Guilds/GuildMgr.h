@@ -42,6 +42,9 @@ class GuildMgr
         std::string GetGuildNameById(uint32 guildId) const;
 
         void LoadGuilds();
+
+        // drops bank tabs, bank items and event logs of guilds without online members unused for Guild.BankUnloadDelay
+        void UnloadIdleBankData();
 };
 
 #define sGuildMgr MaNGOS::Singleton<GuildMgr>::Instance()
@@ -72,7 +72,15 @@ class LootTemplate::LootGroup                               // A set of loot def
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
 
+        // running sum of the ExplicitlyChanced chances, without conditions and above 100% the order of the entries
+        // does not matter and one draw picks the entry directly
+        std::vector<float> ExplicitlyChancedSums;
+        bool HasExplicitlyChancedConditions = false;
+        bool HasEqualChancedConditions = false;
+
         LootStoreItem const* Roll(Loot const& loot, Player const* lootOwner) const; // Rolls an item from the group, returns nullptr if all miss their chances
+        LootStoreItem const* RollExplicitlyChanced(Loot const& loot, Player const* lootOwner) const;
+        LootStoreItem const* RollEqualChanced(Loot const& loot, Player const* lootOwner) const;
 };
 
 // Remove all data and free all memory
@@ -102,7 +110,7 @@ void LootStore::LoadLootTable()
     Clear();
 
     //                                                 0      1     2                    3        4              5         6
-    QueryResult* result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
+    QueryResult* result = WorldDatabase.PQueryBinary("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
 
     if (result)
     {
@@ -172,6 +180,7 @@ void LootStore::LoadLootTable()
         delete result;
 
         Verify();                                           // Checks validity of the loot store
+        ResolveReferences();
 
         sLog.outString(">> Loaded %u loot definitions (" SIZEFMTD " templates) from table %s", count, m_LootTemplates.size(), GetName());
         sLog.outString();
@@ -227,6 +236,12 @@ void LootStore::CheckLootRefs(LootIdSet* ref_set) const
         m_LootTemplate.second->CheckLootRefs(ref_set);
 }
 
+void LootStore::ResolveReferences()
+{
+    for (auto& m_LootTemplate : m_LootTemplates)
+        m_LootTemplate.second->ResolveReferences();
+}
+
 void LootStore::ReportUnusedIds(LootIdSet const& ids_set) const
 {
     // all still listed ids isn't referenced
@@ -954,6 +969,27 @@ bool Loot::FillLoot(uint32 loot_id, LootStore const& store, Player* lootOwner, b
     return true;
 }
 
+// Roll the items of a corpse loot created with only its money, the seed taken at death keeps the result independent of the opening time
+void Loot::GenerateDeferredItems(Player* looter)
+{
+    if (!m_deferredLootId)
+        return;
+
+    uint32 lootId = m_deferredLootId;
+    m_deferredLootId = 0;
+
+    // the killer may be gone, the quest and condition checks then use the first looter
+    Player* lootOwner = ObjectAccessor::FindPlayer(m_deferredOwnerGuid);
+    if (!lootOwner)
+        lootOwner = looter;
+
+    std::mt19937& generator = *GetRandomGenerator();
+    std::mt19937 savedState = generator;
+    generator.seed(m_deferredSeed);
+    FillLoot(lootId, LootTemplates_Creature, lootOwner, false);
+    generator = savedState;
+}
+
 // Get loot status for a specified player
 uint32 Loot::GetLootStatusFor(Player const* player) const
 {
@@ -1589,7 +1625,7 @@ void Loot::SetGroupLootRight(Player* player)
 Loot::Loot(Player* player, Creature* creature, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_deferredLootId(0), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1616,6 +1652,21 @@ Loot::Loot(Player* player, Creature* creature, LootType type) :
             SetGroupLootRight(player);
             m_clientLootType = CLIENT_LOOT_CORPSE;
 
+            // a corpse with money is lootable whatever items it holds, they are only rolled once someone opens it
+            if (creatureInfo->LootId && creatureInfo->MinLootGold > 0 && sWorld.getConfig(CONFIG_BOOL_CORPSE_DEFERRED_ITEM_LOOT))
+            {
+                GenerateMoneyLoot(creatureInfo->MinLootGold, creatureInfo->MaxLootGold);
+                if (m_gold)
+                {
+                    m_deferredLootId = creatureInfo->LootId;
+                    m_deferredSeed = urand();
+                    m_deferredOwnerGuid = player->GetObjectGuid();
+                    creature->SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
+                    ForceLootAnimationClientUpdate();
+                    break;
+                }
+            }
+
             if ((creatureInfo->LootId && FillLoot(creatureInfo->LootId, LootTemplates_Creature, player, false)) || creatureInfo->MaxLootGold > 0)
             {
                 GenerateMoneyLoot(creatureInfo->MinLootGold, creatureInfo->MaxLootGold);
@@ -1688,7 +1739,7 @@ Loot::Loot(Player* player, Creature* creature, LootType type) :
 Loot::Loot(Player* player, GameObject* gameObject, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_deferredLootId(0), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1786,7 +1837,7 @@ Loot::Loot(Player* player, GameObject* gameObject, LootType type) :
 Loot::Loot(Player* player, Corpse* corpse, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_deferredLootId(0), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1833,7 +1884,7 @@ Loot::Loot(Player* player, Corpse* corpse, LootType type) :
 Loot::Loot(Player* player, Item* item, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_deferredLootId(0), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1876,7 +1927,7 @@ Loot::Loot(Player* player, Item* item, LootType type) :
 Loot::Loot(Unit* unit, Item* item) :
     m_lootTarget(nullptr), m_itemTarget(item), m_gold(0), m_maxSlot(0),
     m_lootType(LOOT_SKINNING), m_clientLootType(CLIENT_LOOT_PICKPOCKETING), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0),
-    m_haveItemOverThreshold(false), m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_haveItemOverThreshold(false), m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_deferredLootId(0), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     m_ownerSet.insert(unit->GetObjectGuid());
     m_guidTarget = item->GetObjectGuid();
@@ -1885,7 +1936,7 @@ Loot::Loot(Unit* unit, Item* item) :
 Loot::Loot(Player* player, uint32 id, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_deferredLootId(0), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     m_ownerSet.insert(player->GetObjectGuid());
     switch (type)
@@ -1907,7 +1958,7 @@ Loot::Loot(Player* player, uint32 id, LootType type) :
 Loot::Loot(LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_deferredLootId(0), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
 
 }
@@ -2143,6 +2194,7 @@ void Loot::Clear()
     m_haveItemOverThreshold = false;
     m_isChecked = false;
     m_maxSlot = 0;
+    m_deferredLootId = 0;
 }
 
 // only used from explicitly loaded loot
@@ -2293,80 +2345,117 @@ ByteBuffer& operator<<(ByteBuffer& b, LootItem const& li)
 void LootTemplate::LootGroup::AddEntry(LootStoreItem& item)
 {
     if (item.chance != 0)
+    {
         ExplicitlyChanced.push_back(item);
+        ExplicitlyChancedSums.push_back((ExplicitlyChancedSums.empty() ? 0.0f : ExplicitlyChancedSums.back()) + item.chance);
+        HasExplicitlyChancedConditions = HasExplicitlyChancedConditions || item.conditionId;
+    }
     else
+    {
         EqualChanced.push_back(item);
+        HasEqualChancedConditions = HasEqualChancedConditions || item.conditionId;
+    }
 }
 
 // Rolls an item from the group, returns nullptr if all miss their chances
 LootStoreItem const* LootTemplate::LootGroup::Roll(Loot const& loot, Player const* lootOwner) const
 {
     if (!ExplicitlyChanced.empty())                         // First explicitly chanced entries are checked
-    {
-        std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
+        if (LootStoreItem const* lsi = RollExplicitlyChanced(loot, lootOwner))
+            return lsi;
 
-        // fill the new vector with correct pointer to our item list
-        for (auto& itr : ExplicitlyChanced)
-            lootStoreItemVector.push_back(&itr);
+    if (!EqualChanced.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
+        return RollEqualChanced(loot, lootOwner);
 
-        // randomize the new vector
-        random_shuffle(lootStoreItemVector.begin(), lootStoreItemVector.end());
+    return nullptr;                                            // Empty drop from the group
+}
 
-        float chance = rand_chance_f();
+LootStoreItem const* LootTemplate::LootGroup::RollExplicitlyChanced(Loot const& loot, Player const* lootOwner) const
+{
+    // every entry keeps its own chance whatever the shuffled order was, as long as the chances fit in 100%
+    if (!HasExplicitlyChancedConditions && ExplicitlyChancedSums.back() <= 100.0f)
+    {
+        auto itr = std::upper_bound(ExplicitlyChancedSums.begin(), ExplicitlyChancedSums.end(), rand_chance_f());
+        return itr != ExplicitlyChancedSums.end() ? &ExplicitlyChanced[itr - ExplicitlyChancedSums.begin()] : nullptr;
+    }
 
-        // as the new vector is randomized we can start from first element and stop at first one that meet the condition
-        for (std::vector <LootStoreItem const*>::const_iterator itr = lootStoreItemVector.begin(); itr != lootStoreItemVector.end(); ++itr)
-        {
-            LootStoreItem const* lsi = *itr;
+    std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
 
-            if (lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
-            {
-                sLog.outDebug("In explicit chance -> This item cannot be added! (%u)", lsi->itemid);
-                continue;
-            }
+    // fill the new vector with correct pointer to our item list
+    for (auto& itr : ExplicitlyChanced)
+        lootStoreItemVector.push_back(&itr);
+
+    // randomize the new vector
+    random_shuffle(lootStoreItemVector.begin(), lootStoreItemVector.end());
+
+    float chance = rand_chance_f();
 
-            if (lsi->chance >= 100.0f)
-                return lsi;
+    // as the new vector is randomized we can start from first element and stop at first one that meet the condition
+    for (std::vector <LootStoreItem const*>::const_iterator itr = lootStoreItemVector.begin(); itr != lootStoreItemVector.end(); ++itr)
+    {
+        LootStoreItem const* lsi = *itr;
 
-            chance -= lsi->chance;
-            if (chance < 0)
-                return lsi;
+        if (lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
+        {
+            sLog.outDebug("In explicit chance -> This item cannot be added! (%u)", lsi->itemid);
+            continue;
         }
+
+        if (lsi->chance >= 100.0f)
+            return lsi;
+
+        chance -= lsi->chance;
+        if (chance < 0)
+            return lsi;
     }
 
-    if (!EqualChanced.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
+    return nullptr;
+}
+
+LootStoreItem const* LootTemplate::LootGroup::RollEqualChanced(Loot const& loot, Player const* lootOwner) const
+{
+    // without conditions the first entry of the shuffled list is returned unless it is already in the loot
+    // so it is picked directly, the list is only built for the second chance of an item already looted
+    size_t picked = EqualChanced.size();
+    if (!HasEqualChancedConditions)
     {
-        std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
+        picked = urand(0, EqualChanced.size() - 1);
+        LootStoreItem const* lsi = &EqualChanced[picked];
+        if (!loot.IsItemAlreadyIn(lsi->itemid) || !urand(0, 1))
+            return lsi;
+    }
 
-        // fill the new vector with correct pointer to our item list
-        for (auto& itr : EqualChanced)
-            lootStoreItemVector.push_back(&itr);
+    std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
 
-        // randomize the new vector
-        random_shuffle(lootStoreItemVector.begin(), lootStoreItemVector.end());
+    // fill the new vector with correct pointer to our item list
+    for (size_t i = 0; i < EqualChanced.size(); ++i)
+        if (i != picked)
+            lootStoreItemVector.push_back(&EqualChanced[i]);
 
-        // as the new vector is randomized we can start from first element and stop at first one that meet the condition
-        for (std::vector <LootStoreItem const*>::const_iterator itr = lootStoreItemVector.begin(); itr != lootStoreItemVector.end(); ++itr)
-        {
-            LootStoreItem const* lsi = *itr;
+    // randomize the new vector
+    random_shuffle(lootStoreItemVector.begin(), lootStoreItemVector.end());
 
-            //check if we already have that item in the loot list
-            if (loot.IsItemAlreadyIn(lsi->itemid))
-            {
-                // the item is already looted, let's give a 50%  chance to pick another one
-                uint32 chance = urand(0, 1);
+    // as the new vector is randomized we can start from first element and stop at first one that meet the condition
+    for (std::vector <LootStoreItem const*>::const_iterator itr = lootStoreItemVector.begin(); itr != lootStoreItemVector.end(); ++itr)
+    {
+        LootStoreItem const* lsi = *itr;
 
-                if (chance)
-                    continue;                               // pass this item
-            }
+        //check if we already have that item in the loot list
+        if (loot.IsItemAlreadyIn(lsi->itemid))
+        {
+            // the item is already looted, let's give a 50%  chance to pick another one
+            uint32 chance = urand(0, 1);
 
-            if (lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
-            {
-                sLog.outDebug("In equal chance -> This item cannot be added! (%u)", lsi->itemid);
-                continue;
-            }
-            return lsi;
+            if (chance)
+                continue;                               // pass this item
+        }
+
+        if (lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
+        {
+            sLog.outDebug("In equal chance -> This item cannot be added! (%u)", lsi->itemid);
+            continue;
         }
+        return lsi;
     }
 
     return nullptr;                                            // Empty drop from the group
@@ -2496,7 +2585,7 @@ void LootTemplate::Process(Loot& loot, Player const* lootOwner, LootStore const&
     }
 
     // Rolling non-grouped items
-    for (auto Entrie : Entries)
+    for (auto const& Entrie : Entries)
     {
         // Check condition
         if (Entrie.conditionId && lootOwner && !PlayerOrGroupFulfilsCondition(loot, lootOwner, Entrie.conditionId))
@@ -2507,7 +2596,7 @@ void LootTemplate::Process(Loot& loot, Player const* lootOwner, LootStore const&
 
         if (Entrie.mincountOrRef < 0)                           // References processing
         {
-            LootTemplate const* Referenced = LootTemplates_Reference.GetLootFor(-Entrie.mincountOrRef);
+            LootTemplate const* Referenced = Entrie.reference ? Entrie.reference : LootTemplates_Reference.GetLootFor(-Entrie.mincountOrRef);
 
             if (!Referenced)
                 continue;                                   // Error message already printed at loading stage
@@ -2615,6 +2704,14 @@ void LootTemplate::Verify(LootStore const& lootstore, uint32 id) const
     // TODO: References validity checks
 }
 
+// references are the only entries outside of the groups
+void LootTemplate::ResolveReferences()
+{
+    for (auto& Entrie : Entries)
+        if (Entrie.mincountOrRef < 0)
+            Entrie.reference = LootTemplates_Reference.GetLootFor(-Entrie.mincountOrRef);
+}
+
 void LootTemplate::CheckLootRefs(LootIdSet* ref_set) const
 {
     for (auto Entrie : Entries)
@@ -2632,10 +2729,10 @@ void LootTemplate::CheckLootRefs(LootIdSet* ref_set) const
         Group.CheckLootRefs(ref_set);
 }
 
-void LoadLootTemplates_Creature()
+void LoadLootTemplates_Creature(LootStore& store)
 {
     LootIdSet ids_set, ids_setUsed;
-    LootTemplates_Creature.LoadAndCollectLootIds(ids_set);
+    store.LoadAndCollectLootIds(ids_set);
 
     // remove real entries and check existence loot
     for (uint32 i = 1; i < sCreatureStorage.GetMaxEntry(); ++i)
@@ -2645,7 +2742,7 @@ void LoadLootTemplates_Creature()
             if (uint32 lootid = cInfo->LootId)
             {
                 if (ids_set.find(lootid) == ids_set.end())
-                    LootTemplates_Creature.ReportNotExistedId(lootid);
+                    store.ReportNotExistedId(lootid);
                 else
                     ids_setUsed.insert(lootid);
             }
@@ -2659,13 +2756,13 @@ void LoadLootTemplates_Creature()
     ids_set.erase(0);
 
     // output error for any still listed (not referenced from appropriate table) ids
-    LootTemplates_Creature.ReportUnusedIds(ids_set);
+    store.ReportUnusedIds(ids_set);
 }
 
-void LoadLootTemplates_Disenchant()
+void LoadLootTemplates_Disenchant(LootStore& store)
 {
     LootIdSet ids_set, ids_setUsed;
-    LootTemplates_Disenchant.LoadAndCollectLootIds(ids_set);
+    store.LoadAndCollectLootIds(ids_set);
 
     // remove real entries and check existence loot
     for (uint32 i = 1; i < sItemStorage.GetMaxEntry(); ++i)
@@ -2675,7 +2772,7 @@ void LoadLootTemplates_Disenchant()
             if (uint32 lootid = proto->DisenchantID)
             {
                 if (ids_set.find(lootid) == ids_set.end())
-                    LootTemplates_Disenchant.ReportNotExistedId(lootid);
+                    store.ReportNotExistedId(lootid);
                 else
                     ids_setUsed.insert(lootid);
             }
@@ -2684,13 +2781,13 @@ void LoadLootTemplates_Disenchant()
     for (uint32 itr : ids_setUsed)
         ids_set.erase(itr);
     // output error for any still listed (not referenced from appropriate table) ids
-    LootTemplates_Disenchant.ReportUnusedIds(ids_set);
+    store.ReportUnusedIds(ids_set);
 }
 
-void LoadLootTemplates_Fishing()
+void LoadLootTemplates_Fishing(LootStore& store)
 {
     LootIdSet ids_set;
-    LootTemplates_Fishing.LoadAndCollectLootIds(ids_set);
+    store.LoadAndCollectLootIds(ids_set);
 
     // remove real entries and check existence loot
     for (uint32 i = 1; i < sAreaStore.GetNumRows(); ++i)
@@ -2704,13 +2801,13 @@ void LoadLootTemplates_Fishing()
     ids_set.erase(0);
 
     // output error for any still listed (not referenced from appropriate table) ids
-    LootTemplates_Fishing.ReportUnusedIds(ids_set);
+    store.ReportUnusedIds(ids_set);
 }
 
-void LoadLootTemplates_Gameobject()
+void LoadLootTemplates_Gameobject(LootStore& store)
 {
     LootIdSet ids_set, ids_setUsed;
-    LootTemplates_Gameobject.LoadAndCollectLootIds(ids_set);
+    store.LoadAndCollectLootIds(ids_set);
 
     // remove real entries and check existence loot
     for (SQLStorageBase::SQLSIterator<GameObjectInfo> itr = sGOStorage.getDataBegin<GameObjectInfo>(); itr < sGOStorage.getDataEnd<GameObjectInfo>(); ++itr)
@@ -2718,7 +2815,7 @@ void LoadLootTemplates_Gameobject()
         if (uint32 lootid = itr->GetLootId())
         {
             if (ids_set.find(lootid) == ids_set.end())
-                LootTemplates_Gameobject.ReportNotExistedId(lootid);
+                store.ReportNotExistedId(lootid);
             else
                 ids_setUsed.insert(lootid);
         }
@@ -2727,13 +2824,13 @@ void LoadLootTemplates_Gameobject()
         ids_set.erase(itr);
 
     // output error for any still listed (not referenced from appropriate table) ids
-    LootTemplates_Gameobject.ReportUnusedIds(ids_set);
+    store.ReportUnusedIds(ids_set);
 }
 
-void LoadLootTemplates_Item()
+void LoadLootTemplates_Item(LootStore& store)
 {
     LootIdSet ids_set;
-    LootTemplates_Item.LoadAndCollectLootIds(ids_set);
+    store.LoadAndCollectLootIds(ids_set);
 
     // remove real entries and check existence loot
     for (uint32 i = 1; i < sItemStorage.GetMaxEntry(); ++i)
@@ -2747,18 +2844,18 @@ void LoadLootTemplates_Item()
                 ids_set.erase(proto->ItemId);
             // wdb have wrong data cases, so skip by default
             else if (!sLog.HasLogFilter(LOG_FILTER_DB_STRICTED_CHECK))
-                LootTemplates_Item.ReportNotExistedId(proto->ItemId);
+                store.ReportNotExistedId(proto->ItemId);
         }
     }
 
     // output error for any still listed (not referenced from appropriate table) ids
-    LootTemplates_Item.ReportUnusedIds(ids_set);
+    store.ReportUnusedIds(ids_set);
 }
 
-void LoadLootTemplates_Pickpocketing()
+void LoadLootTemplates_Pickpocketing(LootStore& store)
 {
     LootIdSet ids_set, ids_setUsed;
-    LootTemplates_Pickpocketing.LoadAndCollectLootIds(ids_set);
+    store.LoadAndCollectLootIds(ids_set);
 
     // remove real entries and check existence loot
     for (uint32 i = 1; i < sCreatureStorage.GetMaxEntry(); ++i)
@@ -2768,7 +2865,7 @@ void LoadLootTemplates_Pickpocketing()
             if (uint32 lootid = cInfo->PickpocketLootId)
             {
                 if (ids_set.find(lootid) == ids_set.end())
-                    LootTemplates_Pickpocketing.ReportNotExistedId(lootid);
+                    store.ReportNotExistedId(lootid);
                 else
                     ids_setUsed.insert(lootid);
             }
@@ -2778,13 +2875,13 @@ void LoadLootTemplates_Pickpocketing()
         ids_set.erase(itr);
 
     // output error for any still listed (not referenced from appropriate table) ids
-    LootTemplates_Pickpocketing.ReportUnusedIds(ids_set);
+    store.ReportUnusedIds(ids_set);
 }
 
-void LoadLootTemplates_Prospecting()
+void LoadLootTemplates_Prospecting(LootStore& store)
 {
     LootIdSet ids_set;
-    LootTemplates_Prospecting.LoadAndCollectLootIds(ids_set);
+    store.LoadAndCollectLootIds(ids_set);
 
     // remove real entries and check existence loot
     for (uint32 i = 1; i < sItemStorage.GetMaxEntry(); ++i)
@@ -2799,17 +2896,17 @@ void LoadLootTemplates_Prospecting()
         if (ids_set.find(proto->ItemId) != ids_set.end())
             ids_set.erase(proto->ItemId);
         // else -- exist some cases that possible can be prospected but not expected have any result loot
-        //    LootTemplates_Prospecting.ReportNotExistedId(proto->ItemId);
+        //    store.ReportNotExistedId(proto->ItemId);
     }
 
     // output error for any still listed (not referenced from appropriate table) ids
-    LootTemplates_Prospecting.ReportUnusedIds(ids_set);
+    store.ReportUnusedIds(ids_set);
 }
 
-void LoadLootTemplates_Mail()
+void LoadLootTemplates_Mail(LootStore& store)
 {
     LootIdSet ids_set;
-    LootTemplates_Mail.LoadAndCollectLootIds(ids_set);
+    store.LoadAndCollectLootIds(ids_set);
 
     // remove real entries and check existence loot
     for (uint32 i = 1; i < sMailTemplateStore.GetNumRows(); ++i)
@@ -2818,13 +2915,13 @@ void LoadLootTemplates_Mail()
                 ids_set.erase(i);
 
     // output error for any still listed (not referenced from appropriate table) ids
-    LootTemplates_Mail.ReportUnusedIds(ids_set);
+    store.ReportUnusedIds(ids_set);
 }
 
-void LoadLootTemplates_Skinning()
+void LoadLootTemplates_Skinning(LootStore& store)
 {
     LootIdSet ids_set, ids_setUsed;
-    LootTemplates_Skinning.LoadAndCollectLootIds(ids_set);
+    store.LoadAndCollectLootIds(ids_set);
 
     // remove real entries and check existence loot
     for (uint32 i = 1; i < sCreatureStorage.GetMaxEntry(); ++i)
@@ -2834,7 +2931,7 @@ void LoadLootTemplates_Skinning()
             if (uint32 lootid = cInfo->SkinningLootId)
             {
                 if (ids_set.find(lootid) == ids_set.end())
-                    LootTemplates_Skinning.ReportNotExistedId(lootid);
+                    store.ReportNotExistedId(lootid);
                 else
                     ids_setUsed.insert(lootid);
             }
@@ -2844,7 +2941,7 @@ void LoadLootTemplates_Skinning()
         ids_set.erase(itr);
 
     // output error for any still listed (not referenced from appropriate table) ids
-    LootTemplates_Skinning.ReportUnusedIds(ids_set);
+    store.ReportUnusedIds(ids_set);
 }
 
 void LoadLootTemplates_Reference()
@@ -2866,6 +2963,45 @@ void LoadLootTemplates_Reference()
 
     // output error for any still listed ids (not referenced from any loot table)
     LootTemplates_Reference.ReportUnusedIds(ids_set);
+
+    // the templates of a reload replaced the ones the other stores point to
+    LootTemplates_Creature.ResolveReferences();
+    LootTemplates_Fishing.ResolveReferences();
+    LootTemplates_Gameobject.ResolveReferences();
+    LootTemplates_Item.ResolveReferences();
+    LootTemplates_Pickpocketing.ResolveReferences();
+    LootTemplates_Skinning.ResolveReferences();
+    LootTemplates_Disenchant.ResolveReferences();
+    LootTemplates_Prospecting.ResolveReferences();
+    LootTemplates_Mail.ResolveReferences();
+    LootTemplates_Reference.ResolveReferences();
+}
+
+// the copy only reads the other stores and the templates, none of them can be reloaded while it loads
+class LootStoreBackgroundReload : public BackgroundReload
+{
+    public:
+        LootStoreBackgroundReload(LootStore& store, void (*loader)(LootStore&), char const* publishedText) : BackgroundReload(publishedText),
+            m_store(store), m_copy(store.GetName(), store.GetEntryName(), store.IsRatesAllowed()), m_loader(loader) {}
+
+        void Load() override { m_loader(m_copy); }
+
+        void Publish() override
+        {
+            m_store.SwapTemplates(m_copy);                  // the old templates are freed with the copy
+            m_store.ResolveReferences();
+            m_store.CheckLootRefs();
+        }
+
+    private:
+        LootStore& m_store;
+        LootStore m_copy;
+        void (*m_loader)(LootStore&);
+};
+
+bool ReloadLootTemplatesInBackground(LootStore& store, void (*loader)(LootStore&), char const* publishedText)
+{
+    return sWorld.StartBackgroundReload(new LootStoreBackgroundReload(store, loader, publishedText));
 }
 
 // Vote for an ongoing roll
@@ -2941,8 +3077,11 @@ Loot* LootMgr::GetLoot(Player* player, ObjectGuid const& targetGuid) const
         {
             Creature* creature = player->GetMap()->GetCreature(lguid);
 
-            if (creature)
+            if (creature && creature->m_loot)
+            {
                 loot = creature->m_loot;
+                loot->GenerateDeferredItems(player);
+            }
 
             break;
         }
@@ -20,6 +20,7 @@
 #define MANGOS_LOOTMGR_H
 
 #include "ByteBuffer.h"
+#include "MemoryTracker.h"
 #include "Entities/ObjectGuid.h"
 #include "Globals/SharedDefines.h"
 
@@ -170,12 +171,13 @@ struct LootStoreItem
     bool    needs_quest : 1;                                // quest drop (negative ChanceOrQuestChance in DB)
     uint8   maxcount    : 8;                                // max drop count for the item (mincountOrRef positive) or Ref multiplicator (mincountOrRef negative)
     uint16  conditionId : 16;                               // additional loot condition Id
+    LootTemplate const* reference;                          // template of a negative mincountOrRef, set by LootStore::ResolveReferences
 
     // Constructor, converting ChanceOrQuestChance -> (chance, needs_quest)
     // displayid is filled in IsValid() which must be called after
     LootStoreItem(uint32 _itemid, float _chanceOrQuestChance, int8 _group, uint16 _conditionId, int32 _mincountOrRef, uint8 _maxcount)
         : itemid(_itemid), chance(fabs(_chanceOrQuestChance)), mincountOrRef(_mincountOrRef),
-          group(_group), needs_quest(_chanceOrQuestChance < 0), maxcount(_maxcount), conditionId(_conditionId)
+          group(_group), needs_quest(_chanceOrQuestChance < 0), maxcount(_maxcount), conditionId(_conditionId), reference(nullptr)
     {}
 
     bool Roll(bool rate) const;                             // Checks if the entry takes it's chance (at loot generation)
@@ -231,9 +233,13 @@ class LootStore
 
         void LoadAndCollectLootIds(LootIdSet& ids_set);
         void CheckLootRefs(LootIdSet* ref_set = nullptr) const; // check existence reference and remove it from ref_set
+        void ResolveReferences();                           // must follow every load of this store and of LootTemplates_Reference
         void ReportUnusedIds(LootIdSet const& ids_set) const;
         void ReportNotExistedId(uint32 id) const;
 
+        // exchanges the templates of two stores of the same table, used to publish a reload loaded into a copy
+        void SwapTemplates(LootStore& other) { m_LootTemplates.swap(other.m_LootTemplates); }
+
         bool HaveLootFor(uint32 loot_id) const { return m_LootTemplates.find(loot_id) != m_LootTemplates.end(); }
         bool HaveQuestLootFor(uint32 loot_id) const;
         bool HaveQuestLootForPlayer(uint32 loot_id, Player* player) const;
@@ -274,6 +280,7 @@ class LootTemplate
         // Checks integrity of the template
         void Verify(LootStore const& lootstore, uint32 id) const;
         void CheckLootRefs(LootIdSet* ref_set) const;
+        void ResolveReferences();
     private:
         LootStoreItemList Entries;                          // not grouped only
         LootGroups        Groups;                           // groups have own (optimized) processing, grouped entries go there
@@ -315,6 +322,7 @@ class Loot
         void SendReleaseFor(Player* plr);
         bool IsItemAlreadyIn(uint32 itemId) const;
         void PrintLootList(ChatHandler& chat, WorldSession* session) const;
+        void GenerateDeferredItems(Player* looter);
         bool HasLoot() const;
         uint32 GetGoldAmount() const { return m_gold; }
         LootType GetLootType() const { return m_lootType; }
@@ -331,7 +339,7 @@ class Loot
     private:
         Loot(): m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(),
             m_clientLootType(), m_lootMethod(), m_threshold(), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-            m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false)
+            m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_deferredLootId(0), m_deferredSeed(0)
         {}
         void Clear();
         bool IsLootedFor(Player const* player) const;
@@ -374,10 +382,14 @@ class Loot
         bool             m_isChest;                       // chest type object have special loot right
         bool             m_isChanged;                     // true if at least one item is looted
         bool             m_isFakeLoot;                    // nothing to loot but will sparkle for empty windows
+        uint32           m_deferredLootId;                // corpse loot template not rolled yet
+        uint32           m_deferredSeed;                  // random seed taken at death for the deferred roll
+        ObjectGuid       m_deferredOwnerGuid;             // killer the deferred loot is rolled for
         GroupLootRollMap m_roll;                          // used if an item is under rolling
         GuidSet          m_playersLooting;                // player who opened loot windows
         GuidSet          m_playersOpened;                 // players that have released the corpse
         TimePoint        m_createTime;                    // create time (used to refill loot if need)
+        TrackedMemory<MEMORY_TAG_LOOT, Loot> m_trackedMemory;
 };
 
 extern LootStore LootTemplates_Creature;
@@ -390,18 +402,21 @@ extern LootStore LootTemplates_Skinning;
 extern LootStore LootTemplates_Disenchant;
 extern LootStore LootTemplates_Prospecting;
 
-void LoadLootTemplates_Creature();
-void LoadLootTemplates_Fishing();
-void LoadLootTemplates_Gameobject();
-void LoadLootTemplates_Item();
-void LoadLootTemplates_Mail();
-void LoadLootTemplates_Pickpocketing();
-void LoadLootTemplates_Skinning();
-void LoadLootTemplates_Disenchant();
-void LoadLootTemplates_Prospecting();
+void LoadLootTemplates_Creature(LootStore& store = LootTemplates_Creature);
+void LoadLootTemplates_Fishing(LootStore& store = LootTemplates_Fishing);
+void LoadLootTemplates_Gameobject(LootStore& store = LootTemplates_Gameobject);
+void LoadLootTemplates_Item(LootStore& store = LootTemplates_Item);
+void LoadLootTemplates_Mail(LootStore& store = LootTemplates_Mail);
+void LoadLootTemplates_Pickpocketing(LootStore& store = LootTemplates_Pickpocketing);
+void LoadLootTemplates_Skinning(LootStore& store = LootTemplates_Skinning);
+void LoadLootTemplates_Disenchant(LootStore& store = LootTemplates_Disenchant);
+void LoadLootTemplates_Prospecting(LootStore& store = LootTemplates_Prospecting);
 
 void LoadLootTemplates_Reference();
 
+// loads the table into a copy of the store on a worker thread, false while another background reload runs
+bool ReloadLootTemplatesInBackground(LootStore& store, void (*loader)(LootStore&), char const* publishedText);
+
 inline void LoadLootTables()
 {
     LoadLootTemplates_Creature();
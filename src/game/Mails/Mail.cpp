@@ -172,7 +172,11 @@ void MailDraft::deleteIncludedItems(bool inDB /**= false*/)
         Item* item = m_item.second;
 
         if (inDB)
-            CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid='%u'", item->GetGUIDLow());
+        {
+            static SqlStatementID delItem;
+            SqlStatement stmt = CharacterDatabase.CreateStatement(delItem, "DELETE FROM item_instance WHERE guid = ?");
+            stmt.PExecute(item->GetGUIDLow());
+        }
 
         delete item;
     }
@@ -242,13 +246,15 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, Ob
         needItemDelay = sender_acc != rc_account;
 
         // set owner to new receiver (to prevent delete item with sender char deleting)
+        static SqlStatementID updItemOwner;
         CharacterDatabase.BeginTransaction();
         for (auto& m_item : m_items)
         {
             Item* item = m_item.second;
             item->SaveToDB();                               // item not in inventory and can be save standalone
             // owner in data will set at mail receive and item extracting
-            CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = '%u' WHERE guid='%u'", receiver_guid.GetCounter(), item->GetGUIDLow());
+            SqlStatement stmt = CharacterDatabase.CreateStatement(updItemOwner, "UPDATE item_instance SET owner_guid = ? WHERE guid = ?");
+            stmt.PExecute(receiver_guid.GetCounter(), item->GetGUIDLow());
         }
         CharacterDatabase.CommitTransaction();
     }
@@ -259,6 +265,52 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, Ob
     // will delete item or place to receiver mail list
     SendMailTo(MailReceiver(receiver, receiver_guid), MailSender(MAIL_NORMAL, sender_guid.GetCounter()), MAIL_CHECK_MASK_RETURNED, deliver_delay);
 }
+// statements are kept well below MAX_QUERY_LEN, a row is at most a few hundred bytes
+#define MAIL_INSERT_BATCH_FLUSH_SIZE (MAX_QUERY_LEN / 2)
+
+void MailInsertBatch::AddMail(uint32 mailId, MailSender const& sender, uint32 mailTemplateId, uint32 receiverLowGuid, std::string const& safeSubject,
+                              uint32 itemTextId, bool hasItems, time_t expireTime, time_t deliverTime, uint32 money, uint32 COD, uint32 checked)
+{
+    std::ostringstream ss;
+    ss << (m_mailRows.empty() ? "" : ",") << "(" << mailId << "," << uint32(sender.GetMailMessageType()) << "," << uint32(sender.GetStationery()) << ","
+       << mailTemplateId << "," << sender.GetSenderId() << "," << receiverLowGuid << ",'" << safeSubject << "'," << itemTextId << ","
+       << (hasItems ? 1 : 0) << "," << uint64(expireTime) << "," << uint64(deliverTime) << "," << money << "," << COD << "," << checked << ")";
+    m_mailRows += ss.str();
+
+    if (m_mailRows.size() > MAIL_INSERT_BATCH_FLUSH_SIZE)
+        Flush();
+}
+
+void MailInsertBatch::AddItem(uint32 mailId, uint32 itemGuid, uint32 itemTemplate, uint32 receiverLowGuid)
+{
+    std::ostringstream ss;
+    ss << (m_itemRows.empty() ? "" : ",") << "(" << mailId << "," << itemGuid << "," << itemTemplate << "," << receiverLowGuid << ")";
+    m_itemRows += ss.str();
+
+    if (m_itemRows.size() > MAIL_INSERT_BATCH_FLUSH_SIZE)
+        Flush();
+}
+
+void MailInsertBatch::Flush()
+{
+    // mails first, so flushed items always belong to written mails
+    if (!m_mailRows.empty())
+    {
+        std::string sql = "INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,itemTextId,has_items,expire_time,deliver_time,money,cod,checked) VALUES ";
+        sql += m_mailRows;
+        CharacterDatabase.Execute(sql.c_str());
+        m_mailRows.clear();
+    }
+
+    if (!m_itemRows.empty())
+    {
+        std::string sql = "INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES ";
+        sql += m_itemRows;
+        CharacterDatabase.Execute(sql.c_str());
+        m_itemRows.clear();
+    }
+}
+
 /**
  * Sends a mail.
  *
@@ -266,8 +318,9 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, Ob
  * @param sender               The MailSender from which this mail is originated.
  * @param checked              The mask used to specify the mail.
  * @param deliver_delay        The delay after which the mail is delivered in seconds
+ * @param batch                The batch collecting the inserted rows, the mail is written at once if none is given.
  */
-void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sender, MailCheckMask checked, uint32 deliver_delay)
+void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sender, MailCheckMask checked, uint32 deliver_delay, MailInsertBatch* batch)
 {
     Player* pReceiver = receiver.GetPlayer();               // can be nullptr
 
@@ -310,20 +363,25 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
 
     // Add to DB
     std::string safe_subject = GetSubject();
-
-    CharacterDatabase.BeginTransaction();
     CharacterDatabase.escape_string(safe_subject);
-    CharacterDatabase.PExecute("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,itemTextId,has_items,expire_time,deliver_time,money,cod,checked) "
-                               "VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '%s', '%u', '%u', '" UI64FMTD "','" UI64FMTD "', '%u', '%u', '%u')",
-                               mailId, sender.GetMailMessageType(), sender.GetStationery(), GetMailTemplateId(), sender.GetSenderId(), receiver.GetPlayerGuid().GetCounter(), safe_subject.c_str(), GetBodyId(), (has_items ? 1 : 0), (uint64)expire_time, (uint64)deliver_time, m_money, m_COD, checked);
 
+    MailInsertBatch ownBatch;
+    MailInsertBatch& rows = batch ? *batch : ownBatch;
+
+    rows.AddMail(mailId, sender, GetMailTemplateId(), receiver.GetPlayerGuid().GetCounter(), safe_subject, GetBodyId(), has_items, expire_time, deliver_time, m_money, m_COD, checked);
     for (MailItemMap::const_iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
     {
         Item* item = mailItemIter->second;
-        CharacterDatabase.PExecute("INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES ('%u', '%u', '%u','%u')",
-                                   mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
+        rows.AddItem(mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
+    }
+
+    // rows of a caller batch are written with the caller's chunk
+    if (!batch)
+    {
+        CharacterDatabase.BeginTransaction();
+        ownBatch.Flush();
+        CharacterDatabase.CommitTransaction();
     }
-    CharacterDatabase.CommitTransaction();
 
     // For online receiver update in game mail status and data
     if (pReceiver)
@@ -378,8 +436,12 @@ void Mail::prepareTemplateItems(Player* receiver)
 
     has_items = true;
 
+    static SqlStatementID updMailHasItems;
+    static SqlStatementID insMailItem;
+
     CharacterDatabase.BeginTransaction();
-    CharacterDatabase.PExecute("UPDATE mail SET has_items = 1 WHERE id = %u", messageID);
+    SqlStatement stmt = CharacterDatabase.CreateStatement(updMailHasItems, "UPDATE mail SET has_items = 1 WHERE id = ?");
+    stmt.PExecute(messageID);
 
     // mailLoot can be empty
     Loot mailLoot(receiver, mailTemplateId, LOOT_MAIL);
@@ -396,8 +458,8 @@ void Mail::prepareTemplateItems(Player* receiver)
                 item->SaveToDB();
                 AddItem(item->GetGUIDLow(), item->GetEntry());
                 receiver->AddMItem(item);
-                CharacterDatabase.PExecute("INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES ('%u', '%u', '%u','%u')",
-                                           messageID, item->GetGUIDLow(), item->GetEntry(), receiver->GetGUIDLow());
+                stmt = CharacterDatabase.CreateStatement(insMailItem, "INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES (?, ?, ?, ?)");
+                stmt.PExecute(messageID, item->GetGUIDLow(), item->GetEntry(), receiver->GetGUIDLow());
             }
         }
     }
@@ -36,6 +36,7 @@
 
 #include "Common.h"
 #include "Entities/ObjectGuid.h"
+#include "MemoryTracker.h"
 #include <map>
 #include <utility>
 
@@ -174,6 +175,27 @@ class MailReceiver
         Player* m_receiver;
         ObjectGuid m_receiver_guid;
 };
+/**
+ * Collects the mail and mail_items rows of several mails for multi-row inserts.
+ *
+ * The rows are written by Flush, or while adding when a statement grows near MAX_QUERY_LEN,
+ * into the transaction of the caller if one is open.
+ */
+class MailInsertBatch
+{
+    public:
+        ~MailInsertBatch() { Flush(); }
+
+        void AddMail(uint32 mailId, MailSender const& sender, uint32 mailTemplateId, uint32 receiverLowGuid, std::string const& safeSubject,
+                     uint32 itemTextId, bool hasItems, time_t expireTime, time_t deliverTime, uint32 money, uint32 COD, uint32 checked);
+        void AddItem(uint32 mailId, uint32 itemGuid, uint32 itemTemplate, uint32 receiverLowGuid);
+
+        void Flush();
+
+    private:
+        std::string m_mailRows;
+        std::string m_itemRows;
+};
 /**
  * The class to represent the draft of a mail.
  */
@@ -251,7 +273,7 @@ class MailDraft
         void CloneFrom(MailDraft const& draft);
     public:                                                 // finishers
         void SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, ObjectGuid receiver_guid);
-        void SendMailTo(MailReceiver const& receiver, MailSender const& sender, MailCheckMask checked = MAIL_CHECK_MASK_NONE, uint32 deliver_delay = 0);
+        void SendMailTo(MailReceiver const& receiver, MailSender const& sender, MailCheckMask checked = MAIL_CHECK_MASK_NONE, uint32 deliver_delay = 0, MailInsertBatch* batch = nullptr);
     private:
         MailDraft(MailDraft const&);                        // trap decl, no body, mail draft must cloned only explicitly...
         MailDraft& operator=(MailDraft const&);             // trap decl, no body, ...because items clone is high price operation
@@ -324,6 +346,8 @@ struct Mail
     uint32 checked;
     /// The state of this mail.
     MailState state;
+    /// Counts the mail as MEMORY_TAG_MAIL.
+    TrackedMemory<MEMORY_TAG_MAIL, Mail> trackedMemory;
 
     /**
      * Adds an item to the mail.
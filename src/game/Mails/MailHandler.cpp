@@ -264,7 +264,9 @@ void WorldSession::HandleSendMail(WorldPacket& recv_data)
                 item->DeleteFromInventoryDB();              // deletes item from character's inventory
                 item->SaveToDB();                           // recursive and not have transaction guard into self, item not in inventory and can be save standalone
                 // owner in data will set at mail receive and item extracting
-                CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = '%u' WHERE guid='%u'", rc.GetCounter(), item->GetGUIDLow());
+                static SqlStatementID updItemOwner;
+                SqlStatement stmt = CharacterDatabase.CreateStatement(updItemOwner, "UPDATE item_instance SET owner_guid = ? WHERE guid = ?");
+                stmt.PExecute(rc.GetCounter(), item->GetGUIDLow());
                 CharacterDatabase.CommitTransaction();
 
                 draft.AddItem(item);
@@ -391,12 +393,21 @@ void WorldSession::HandleMailReturnToSender(WorldPacket& recv_data)
         return;
     }
 
+    // the items are read while the mail still exists
+    if (m->HasItems())
+        pl->LoadMailedItemsIfNeeded();
+
     // we can return mail now
     // so firstly delete the old one
+    static SqlStatementID delMail;
+    static SqlStatementID delMailItems;
+
     CharacterDatabase.BeginTransaction();
-    CharacterDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", mailId);
+    SqlStatement stmt = CharacterDatabase.CreateStatement(delMail, "DELETE FROM mail WHERE id = ?");
+    stmt.PExecute(mailId);
     // needed?
-    CharacterDatabase.PExecute("DELETE FROM mail_items WHERE mail_id = '%u'", mailId);
+    stmt = CharacterDatabase.CreateStatement(delMailItems, "DELETE FROM mail_items WHERE mail_id = ?");
+    stmt.PExecute(mailId);
     CharacterDatabase.CommitTransaction();
     pl->RemoveMail(mailId);
 
@@ -458,6 +469,7 @@ void WorldSession::HandleMailTakeItem(WorldPacket& recv_data)
         return;
     }
 
+    pl->LoadMailedItemsIfNeeded();
     Item* it = pl->GetMItem(itemId);
 
     ItemPosCountVec dest;
@@ -573,6 +585,36 @@ void WorldSession::HandleGetMailList(WorldPacket& recv_data)
     if (!CheckMailBox(mailboxGuid))
         return;
 
+    // the mailed items are created on the first look into the mailbox, the list is sent once they are read
+    if (!_player->IsMailedItemsLoaded())
+    {
+        _player->PrefetchMailedItems();
+        return;
+    }
+
+    SendMailList();
+}
+
+void WorldSession::HandleMailedItemsLoadCallBack(QueryResult* result, uint32 accountId, uint32 playerGuidLow)
+{
+    WorldSession* session = sWorld.FindSession(accountId);
+    Player* player = session ? session->GetPlayer() : nullptr;
+    if (!player || player->GetGUIDLow() != playerGuidLow)
+    {
+        delete result;
+        return;
+    }
+
+    player->HandleMailedItemsLoaded(result);
+    if (player->IsMailedItemsLoaded())
+        session->SendMailList();
+}
+
+/**
+ * Sends the list of all available mails in the players mailbox, the mailed items must be loaded.
+ */
+void WorldSession::SendMailList()
+{
     // client can't work with packets > max int16 value
     const uint32 maxPacketSize = 32767;
 
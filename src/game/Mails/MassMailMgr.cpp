@@ -78,11 +78,35 @@ void MassMailMgr::Update(bool sendall /*= false*/)
 
     uint32 maxcount = sWorld.getConfig(CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK);
 
+    // the chunk shrinks while the async DB queue fills up, so mass mails never starve the writes of the players
+    if (!sendall)
+    {
+        if (uint32 maxQueue = sWorld.getConfig(CONFIG_UINT32_MASS_MAILER_MAX_DB_QUEUE))
+        {
+            size_t queued = CharacterDatabase.GetDelayQueueSize();
+            if (queued >= maxQueue)
+                return;
+
+            maxcount = std::max(uint32(1), uint32(maxcount * (maxQueue - queued) / maxQueue));
+        }
+    }
+
+    do
+        SendChunk(maxcount);
+    while (sendall && !m_massMails.empty());
+}
+
+void MassMailMgr::SendChunk(uint32 maxcount)
+{
+    // the rows of the whole chunk are written with multi-row inserts in one transaction
+    CharacterDatabase.BeginTransaction();
+    MailInsertBatch batch;
+
     do
     {
         MassMail& task = m_massMails.front();
 
-        while (!task.m_receivers.empty() && (sendall || maxcount > 0))
+        while (!task.m_receivers.empty() && maxcount > 0)
         {
             uint32 receiver_lowguid = *task.m_receivers.begin();
             task.m_receivers.erase(task.m_receivers.begin());
@@ -90,14 +114,14 @@ void MassMailMgr::Update(bool sendall /*= false*/)
             ObjectGuid receiver_guid = ObjectGuid(HIGHGUID_PLAYER, receiver_lowguid);
             Player* receiver = sObjectMgr.GetPlayer(receiver_guid);
 
+            ++task.m_sent;
+            --maxcount;
+
             // last case. can be just send
             if (task.m_receivers.empty())
             {
                 // prevent mail return
-                task.m_protoMail->SendMailTo(MailReceiver(receiver, receiver_guid), task.m_sender, MAIL_CHECK_MASK_RETURNED);
-
-                if (!sendall)
-                    --maxcount;
+                task.m_protoMail->SendMailTo(MailReceiver(receiver, receiver_guid), task.m_sender, MAIL_CHECK_MASK_RETURNED, 0, &batch);
                 break;
             }
 
@@ -106,16 +130,36 @@ void MassMailMgr::Update(bool sendall /*= false*/)
             draft.CloneFrom(*task.m_protoMail);
 
             // prevent mail return
-            draft.SendMailTo(MailReceiver(receiver, receiver_guid), task.m_sender, MAIL_CHECK_MASK_RETURNED);
-
-            if (!sendall)
-                --maxcount;
+            draft.SendMailTo(MailReceiver(receiver, receiver_guid), task.m_sender, MAIL_CHECK_MASK_RETURNED, 0, &batch);
         }
 
+        ReportProgress(task);
+
         if (task.m_receivers.empty())
             m_massMails.pop_front();
     }
-    while (!m_massMails.empty() && (sendall || maxcount > 0));
+    while (!m_massMails.empty() && maxcount > 0);
+
+    batch.Flush();
+    CharacterDatabase.CommitTransaction();
+}
+
+void MassMailMgr::ReportProgress(MassMail& task)
+{
+    uint32 total = task.m_sent + task.m_receivers.size();
+    if (task.m_receivers.empty())
+    {
+        sLog.outString("MassMailMgr: mass mail task finished, %u mails sent", task.m_sent);
+        return;
+    }
+
+    // every 10 percent
+    uint32 step = task.m_sent * 10 / total;
+    if (step <= task.m_reportedStep)
+        return;
+
+    task.m_reportedStep = step;
+    sLog.outString("MassMailMgr: mass mail task at %u%%, %u of %u mails sent", step * 10, task.m_sent, total);
 }
 
 void MassMailMgr::GetStatistic(uint32& tasks, uint32& mails, uint32& needTime) const
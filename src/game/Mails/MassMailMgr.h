@@ -98,7 +98,7 @@ class MassMailMgr
         struct MassMail
         {
             explicit MassMail(MailDraft* mailProto, MailSender sender)
-                : m_protoMail(mailProto), m_sender(sender)
+                : m_protoMail(mailProto), m_sender(sender), m_sent(0), m_reportedStep(0)
             {
                 MANGOS_ASSERT(mailProto);
             }
@@ -108,8 +108,15 @@ class MassMailMgr
 
             MailSender m_sender;
             ReceiversList m_receivers;
+
+            uint32 m_sent;                                  ///< mails sent so far, for the progress report
+            uint32 m_reportedStep;                          ///< last reported tenth of the task
         };
 
+        /// Sends up to maxcount mails of the queued tasks in one transaction
+        void SendChunk(uint32 maxcount);
+        void ReportProgress(MassMail& task);
+
         typedef std::list<MassMail> MassMailList;
 
         /// List of current queued mass mail tasks
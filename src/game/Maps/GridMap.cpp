@@ -17,6 +17,7 @@
  */
 
 #include "Log.h"
+#include "MemoryTracker.h"
 #include "Grids/CellImpl.h"
 #include "Maps/Map.h"
 #include "Server/DBCEnums.h"
@@ -27,9 +28,20 @@
 #include "World/World.h"
 #include "Policies/Singleton.h"
 #include "Util.h"
+#include "vmap/MapTree.h"
 
+#include <algorithm>
 #include <mutex>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 char const* MAP_MAGIC         = "MAPS";
 char const* MAP_VERSION_MAGIC = "s1.4";
 char const* MAP_AREA_MAGIC    = "AREA";
@@ -39,6 +51,64 @@ char const* MAP_LIQUID_MAGIC  = "MLIQ";
 static uint16 holetab_h[4] = { 0x1111, 0x2222, 0x4444, 0x8888 };
 static uint16 holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
 
+namespace
+{
+    void* MapFile(char const* filename, size_t& size)
+    {
+        void* mapping = nullptr;
+#ifdef _WIN32
+        HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return nullptr;
+
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            if (HANDLE handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+            {
+                mapping = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+                size = size_t(fileSize.QuadPart);
+                CloseHandle(handle);
+            }
+        }
+        CloseHandle(file);
+#else
+        int file = open(filename, O_RDONLY);
+        if (file < 0)
+            return nullptr;
+
+        struct stat fileStat;
+        if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            size = size_t(fileStat.st_size);
+            mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+            if (mapping == MAP_FAILED)
+                mapping = nullptr;
+        }
+        close(file);
+#endif
+        return mapping;
+    }
+
+    void UnmapFile(void* mapping, size_t size)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        munmap(mapping, size);
+#endif
+    }
+
+    // pointer to count elements at offset of the mapping, null when the file is too short or the data misaligned
+    template<class T>
+    T* GetMapped(void* mapping, size_t mappingSize, size_t offset, size_t count = 1)
+    {
+        if (offset + sizeof(T) * count > mappingSize || (offset % alignof(T)) != 0)
+            return nullptr;
+        return reinterpret_cast<T*>(static_cast<char*>(mapping) + offset);
+    }
+}
+
 GridMap::GridMap(): m_gridIntHeightMultiplier(0)
 {
     m_flags = 0;
@@ -66,6 +136,10 @@ GridMap::GridMap(): m_gridIntHeightMultiplier(0)
     m_liquidEntry = nullptr;
     m_liquid_map  = nullptr;
     m_fullyLoaded = false;
+
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_memoryUsage = 0;
 }
 
 GridMap::~GridMap()
@@ -78,6 +152,13 @@ bool GridMap::loadData(char const* filename)
     // Unload old data if exist
     unloadData();
 
+    if (sWorld.getConfig(CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED) && loadMappedData(filename))
+    {
+        m_memoryUsage = m_mappingSize;
+        MemoryTracker::Add(MEMORY_TAG_TERRAIN, m_memoryUsage);
+        return true;
+    }
+
     GridMapFileHeader header;
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
@@ -125,6 +206,9 @@ bool GridMap::loadData(char const* filename)
         }
 
         fclose(in);
+
+        m_memoryUsage = header.areaMapSize + header.holesSize + header.heightMapSize + header.liquidMapSize;
+        MemoryTracker::Add(MEMORY_TAG_TERRAIN, m_memoryUsage);
         return true;
     }
 
@@ -135,12 +219,27 @@ bool GridMap::loadData(char const* filename)
 
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    if (m_memoryUsage)
+    {
+        MemoryTracker::Remove(MEMORY_TAG_TERRAIN, m_memoryUsage);
+        m_memoryUsage = 0;
+    }
+
+    if (m_mapping)
+    {
+        UnmapFile(m_mapping, m_mappingSize);
+        m_mapping = nullptr;
+        m_mappingSize = 0;
+    }
+    else
+    {
+        delete[] m_area_map;
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] m_liquidEntry;
+        delete[] m_liquidFlags;
+        delete[] m_liquid_map;
+    }
 
     m_area_map = nullptr;
     m_V9 = nullptr;
@@ -149,6 +248,145 @@ void GridMap::unloadData()
     m_liquidFlags = nullptr;
     m_liquid_map  = nullptr;
     m_gridGetHeight = &GridMap::getHeightFromFlat;
+
+    std::lock_guard<std::mutex> guard(m_areaCacheLock);
+    m_areaCache.clear();
+}
+
+uint64 GridMap::GetAreaCacheKey(float x, float y, float z)
+{
+    // 20 bits for each horizontal coordinate cover the whole map, 24 bits for the height
+    uint64 qx = uint32(int32(floor(x * AREA_CACHE_PRECISION))) & 0xFFFFF;
+    uint64 qy = uint32(int32(floor(y * AREA_CACHE_PRECISION))) & 0xFFFFF;
+    uint64 qz = uint32(int32(floor(z * AREA_CACHE_PRECISION))) & 0xFFFFFF;
+    return (qx << 44) | (qy << 24) | qz;
+}
+
+bool GridMap::GetCachedArea(uint64 key, uint16& areaFlag, bool& isOutdoors)
+{
+    std::lock_guard<std::mutex> guard(m_areaCacheLock);
+    auto itr = m_areaCache.find(key);
+    if (itr == m_areaCache.end())
+        return false;
+
+    areaFlag = itr->second.areaFlag;
+    isOutdoors = itr->second.isOutdoors;
+    return true;
+}
+
+void GridMap::AddCachedArea(uint64 key, uint16 areaFlag, bool isOutdoors)
+{
+    std::lock_guard<std::mutex> guard(m_areaCacheLock);
+    if (m_areaCache.size() >= AREA_CACHE_MAX_ENTRIES)
+        m_areaCache.clear();
+
+    AreaCacheEntry& entry = m_areaCache[key];
+    entry.areaFlag = areaFlag;
+    entry.isOutdoors = isOutdoors;
+}
+
+// any file the mapped view can not point into is left to the copying load, which also reports the errors
+bool GridMap::loadMappedData(char const* filename)
+{
+    m_mapping = MapFile(filename, m_mappingSize);
+    if (!m_mapping)
+        return false;
+
+    GridMapFileHeader const* header = GetMapped<GridMapFileHeader>(m_mapping, m_mappingSize, 0);
+    if (header && header->mapMagic == *((uint32 const*)(MAP_MAGIC)) && header->versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC)) &&
+            setMappedData(*header))
+        return true;
+
+    unloadData();
+    return false;
+}
+
+bool GridMap::setMappedData(GridMapFileHeader const& header)
+{
+    if (header.areaMapOffset)
+    {
+        GridMapAreaHeader const* area = GetMapped<GridMapAreaHeader>(m_mapping, m_mappingSize, header.areaMapOffset);
+        if (!area || area->fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+            return false;
+
+        m_gridArea = area->gridArea;
+        if (!(area->flags & MAP_AREA_NO_AREA) && !(m_area_map = GetMapped<uint16>(m_mapping, m_mappingSize, header.areaMapOffset + sizeof(GridMapAreaHeader), 16 * 16)))
+            return false;
+    }
+
+    if (header.holesOffset)
+    {
+        uint16 const* holes = GetMapped<uint16>(m_mapping, m_mappingSize, header.holesOffset, 16 * 16);
+        if (!holes)
+            return false;
+        memcpy(m_holes, holes, sizeof(m_holes));
+    }
+
+    if (header.heightMapOffset)
+    {
+        GridMapHeightHeader const* height = GetMapped<GridMapHeightHeader>(m_mapping, m_mappingSize, header.heightMapOffset);
+        if (!height || height->fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+            return false;
+
+        size_t const offset = header.heightMapOffset + sizeof(GridMapHeightHeader);
+        m_gridHeight = height->gridHeight;
+        if (!(height->flags & MAP_HEIGHT_NO_HEIGHT))
+        {
+            if ((height->flags & MAP_HEIGHT_AS_INT16))
+            {
+                m_uint16_V9 = GetMapped<uint16>(m_mapping, m_mappingSize, offset, 129 * 129);
+                m_uint16_V8 = GetMapped<uint16>(m_mapping, m_mappingSize, offset + sizeof(uint16) * 129 * 129, 128 * 128);
+                m_gridIntHeightMultiplier = (height->gridMaxHeight - height->gridHeight) / 65535;
+                m_gridGetHeight = &GridMap::getHeightFromUint16;
+            }
+            else if ((height->flags & MAP_HEIGHT_AS_INT8))
+            {
+                m_uint8_V9 = GetMapped<uint8>(m_mapping, m_mappingSize, offset, 129 * 129);
+                m_uint8_V8 = GetMapped<uint8>(m_mapping, m_mappingSize, offset + sizeof(uint8) * 129 * 129, 128 * 128);
+                m_gridIntHeightMultiplier = (height->gridMaxHeight - height->gridHeight) / 255;
+                m_gridGetHeight = &GridMap::getHeightFromUint8;
+            }
+            else
+            {
+                m_V9 = GetMapped<float>(m_mapping, m_mappingSize, offset, 129 * 129);
+                m_V8 = GetMapped<float>(m_mapping, m_mappingSize, offset + sizeof(float) * 129 * 129, 128 * 128);
+                m_gridGetHeight = &GridMap::getHeightFromFloat;
+            }
+
+            if (!m_V9 || !m_V8)
+                return false;
+        }
+    }
+
+    if (header.liquidMapOffset)
+    {
+        GridMapLiquidHeader const* liquid = GetMapped<GridMapLiquidHeader>(m_mapping, m_mappingSize, header.liquidMapOffset);
+        if (!liquid || liquid->fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+            return false;
+
+        m_liquidGlobalEntry = liquid->liquidType;
+        m_liquidGlobalFlags = liquid->liquidFlags;
+        m_liquid_offX   = liquid->offsetX;
+        m_liquid_offY   = liquid->offsetY;
+        m_liquid_width  = liquid->width;
+        m_liquid_height = liquid->height;
+        m_liquidLevel   = liquid->liquidLevel;
+
+        size_t offset = header.liquidMapOffset + sizeof(GridMapLiquidHeader);
+        if (!(liquid->flags & MAP_LIQUID_NO_TYPE))
+        {
+            m_liquidEntry = GetMapped<uint16>(m_mapping, m_mappingSize, offset, 16 * 16);
+            m_liquidFlags = GetMapped<uint8>(m_mapping, m_mappingSize, offset + sizeof(uint16) * 16 * 16, 16 * 16);
+            if (!m_liquidEntry || !m_liquidFlags)
+                return false;
+            offset += (sizeof(uint16) + sizeof(uint8)) * 16 * 16;
+        }
+
+        if (!(liquid->flags & MAP_LIQUID_NO_HEIGHT) && !(m_liquid_map = GetMapped<float>(m_mapping, m_mappingSize, offset, m_liquid_width * m_liquid_height)))
+            return false;
+    }
+
+    return true;
 }
 
 bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
@@ -689,7 +927,7 @@ bool GridMap::ExistVMap(uint32 mapid, int gx, int gy)
 }
 
 //////////////////////////////////////////////////////////////////////////
-TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
+TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid), m_mutex("TerrainInfo::m_mutex"), m_refMutex("TerrainInfo::m_refMutex")
 {
     for (int k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
     {
@@ -697,6 +935,7 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
         {
             m_GridMaps[i][k] = nullptr;
             m_GridRef[i][k] = 0;
+            m_GridUnusedSince[i][k] = 0;
         }
     }
 
@@ -767,22 +1006,97 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
 
             // delete those GridMap objects which have refcount = 0
             if (pMap && iRef == 0)
-            {
-                m_GridMaps[x][y] = nullptr;
-                // delete grid data if reference count == 0
-                pMap->unloadData();
-                delete pMap;
+                UnloadGrid(x, y);
+        }
+    }
 
-                // unload VMAPS...
-                VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
+    i_timer.Reset();
+}
 
-                // unload mmap...
-                MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
-            }
+bool TerrainInfo::HasLoadedGrids() const
+{
+    for (int y = 0; y < MAX_NUMBER_OF_GRIDS; ++y)
+        for (int x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
+            if (m_GridMaps[x][y])
+                return true;
+
+    return false;
+}
+
+void TerrainInfo::UnloadGrid(const uint32 x, const uint32 y)
+{
+    {
+        // the prefetch thread may publish a GridMap meanwhile
+        LOCK_GUARD lock(m_mutex);
+        GridMap* pMap = m_GridMaps[x][y];
+        m_GridMaps[x][y] = nullptr;
+        if (!pMap)
+            return;
+
+        pMap->unloadData();
+        delete pMap;
+    }
+
+    // unload VMAPS...
+    VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
+
+    // unload mmap...
+    MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
+}
+
+namespace
+{
+    // only brings the file into the OS cache, so the map thread does not wait for the disk when it loads the tile
+    void ReadIntoFileCache(std::string const& fileName)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (!file)
+            return;
+
+        char buffer[64 * 1024];
+        while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer)) {}
+        fclose(file);
+    }
+}
+
+void TerrainInfo::Prefetch(const uint32 x, const uint32 y)
+{
+    MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
+    MANGOS_ASSERT(y < MAX_NUMBER_OF_GRIDS);
+
+    {
+        LOCK_GUARD _lock(m_refMutex);
+        // dropped by the requester before the thread came to it
+        if (m_GridRef[x][y] == 0)
+            return;
+    }
+
+    if (!m_GridMaps[x][y])
+    {
+        int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+        char* tmp = new char[len];
+        snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
+
+        // a missing file is reported by the map thread when the grid is entered
+        GridMap* map = new GridMap();
+        if (map->loadData(tmp))
+        {
+            LOCK_GUARD lock(m_mutex);
+            if (!m_GridMaps[x][y])
+                std::swap(m_GridMaps[x][y], map);
         }
+
+        delete map;
+        delete[] tmp;
     }
 
-    i_timer.Reset();
+    ReadIntoFileCache(sWorld.GetDataPath() + "vmaps/" + VMAP::StaticMapTree::getTileFileName(m_mapId, x, y));
+
+    int len = sWorld.GetDataPath().length() + strlen("mmaps/%03i%02i%02i.mmtile") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (sWorld.GetDataPath() + "mmaps/%03i%02i%02i.mmtile").c_str(), m_mapId, x, y);
+    ReadIntoFileCache(tmp);
+    delete[] tmp;
 }
 
 int TerrainInfo::RefGrid(const uint32& x, const uint32& y)
@@ -802,9 +1116,10 @@ int TerrainInfo::UnrefGrid(const uint32& x, const uint32& y)
     int16& iRef = m_GridRef[x][y];
 
     LOCK_GUARD _lock(m_refMutex);
-    if (iRef > 0)
-        return (iRef -= 1);
+    if (iRef > 0 && (iRef -= 1) > 0)
+        return iRef;
 
+    m_GridUnusedSince[x][y] = uint32(time(nullptr));
     return 0;
 }
 
@@ -875,14 +1190,10 @@ inline bool IsOutdoorWMO(uint32 mogpFlags, uint32 mapId)
 
 bool TerrainInfo::IsOutdoors(float x, float y, float z) const
 {
-    uint32 mogpFlags;
-    int32 adtId, rootId, groupId;
-
-    // no wmo found? -> outside by default
-    if (!GetAreaInfo(x, y, z, mogpFlags, adtId, rootId, groupId))
-        return true;
-
-    return IsOutdoorWMO(mogpFlags, GetMapId());
+    // same result as the wmo check, no wmo found -> outside by default, but cached with the area
+    bool isOutdoors;
+    GetAreaFlag(x, y, z, &isOutdoors);
+    return isOutdoors;
 }
 
 bool TerrainInfo::GetAreaInfo(float x, float y, float z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
@@ -906,6 +1217,21 @@ bool TerrainInfo::GetAreaInfo(float x, float y, float z, uint32& flags, int32& a
 
 uint16 TerrainInfo::GetAreaFlag(float x, float y, float z, bool* isOutdoors) const
 {
+    // the player updates and relocations repeat the vmap query for the same spots, a grid with its vmap tile keeps the results
+    GridMap* cacheMap = const_cast<TerrainInfo*>(this)->GetGrid(x, y, true);
+    if (cacheMap && !cacheMap->IsFullyLoaded())
+        cacheMap = nullptr;
+
+    uint64 cacheKey = GridMap::GetAreaCacheKey(x, y, z);
+    uint16 cachedFlag;
+    bool cachedOutdoors;
+    if (cacheMap && cacheMap->GetCachedArea(cacheKey, cachedFlag, cachedOutdoors))
+    {
+        if (isOutdoors)
+            *isOutdoors = cachedOutdoors;
+        return cachedFlag;
+    }
+
     uint32 mogpFlags;
     int32 adtId, rootId, groupId;
     WMOAreaTableEntry const* wmoEntry = nullptr;
@@ -932,13 +1258,13 @@ uint16 TerrainInfo::GetAreaFlag(float x, float y, float z, bool* isOutdoors) con
             areaflag = GetAreaFlagByMapId(GetMapId());
     }
 
+    bool outdoors = haveAreaInfo ? IsOutdoorWMO(mogpFlags, GetMapId()) : true;
     if (isOutdoors)
-    {
-        if (haveAreaInfo)
-            *isOutdoors = IsOutdoorWMO(mogpFlags, GetMapId());
-        else
-            *isOutdoors = true;
-    }
+        *isOutdoors = outdoors;
+
+    if (cacheMap)
+        cacheMap->AddCachedArea(cacheKey, areaflag, outdoors);
+
     return areaflag;
 }
 
@@ -1158,6 +1484,8 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnl
 
             delete[] tmp;
             m_GridMaps[x][y] = map;
+            // looked up without a reference, counts as used now for the terrain cache
+            m_GridUnusedSince[x][y] = uint32(time(nullptr));
         }
     }
 
@@ -1225,12 +1553,15 @@ float TerrainInfo::GetWaterLevel(float x, float y, float z, float* pGround /*= n
 INSTANTIATE_SINGLETON_2(TerrainManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(TerrainManager, std::mutex);
 
-TerrainManager::TerrainManager()
+TerrainManager::TerrainManager() : m_prefetchStop(false), m_cacheSize(0)
 {
+    m_cacheTimer.SetInterval(10 * IN_MILLISECONDS);
 }
 
 TerrainManager::~TerrainManager()
 {
+    StopPrefetch();
+
     for (auto& it : i_TerrainMap)
         delete it.second;
 }
@@ -1260,8 +1591,8 @@ void TerrainManager::UnloadTerrain(const uint32 mapId)
     if (iter != i_TerrainMap.end())
     {
         TerrainInfo* ptr = (*iter).second;
-        // lets check if this object can be actually freed
-        if (!ptr->IsReferenced())
+        // lets check if this object can be actually freed, with a cache EvictUnusedGrids frees it once its grids are gone
+        if (!ptr->IsReferenced() && !m_cacheSize)
         {
             i_TerrainMap.erase(iter);
             delete ptr;
@@ -1271,19 +1602,212 @@ void TerrainManager::UnloadTerrain(const uint32 mapId)
 
 void TerrainManager::Update(const uint32 diff)
 {
+    UpdatePrewarmedGrids(diff);
+
+    if (m_cacheSize)
+    {
+        m_cacheTimer.Update(diff);
+        if (m_cacheTimer.Passed())
+        {
+            m_cacheTimer.Reset();
+            EvictUnusedGrids();
+        }
+        return;
+    }
+
     // global garbage collection for GridMap objects and VMaps
     for (auto& iter : i_TerrainMap)
         iter.second->CleanUpGrids(diff);
 }
 
+uint64 TerrainManager::GetTerrainMemory()
+{
+    int64 const bytes = MemoryTracker::GetBytes(MEMORY_TAG_TERRAIN) + MemoryTracker::GetBytes(MEMORY_TAG_VMAP) + MemoryTracker::GetBytes(MEMORY_TAG_MMAP);
+    return bytes > 0 ? uint64(bytes) : 0;
+}
+
+// Grids no map references anymore stay loaded for the next instance or visitor of their map, which finds the
+// height map, vmap and navmesh tile of its map id ready. Once the terrain memory exceeds the cache size the
+// grids unused for the longest time are dropped, grids in use are never touched.
+void TerrainManager::EvictUnusedGrids()
+{
+    Guard _guard(*this);
+
+    uint64 memory = GetTerrainMemory();
+    if (memory > m_cacheSize)
+    {
+        struct UnusedGrid
+        {
+            TerrainInfo* terrain;
+            uint32 x;
+            uint32 y;
+            uint32 unusedSince;
+        };
+
+        std::vector<UnusedGrid> grids;
+        for (auto& iter : i_TerrainMap)
+            for (uint32 x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
+                for (uint32 y = 0; y < MAX_NUMBER_OF_GRIDS; ++y)
+                    if (iter.second->IsGridUnused(x, y))
+                        grids.push_back({ iter.second, x, y, iter.second->GetGridUnusedSince(x, y) });
+
+        std::sort(grids.begin(), grids.end(), [](UnusedGrid const & a, UnusedGrid const & b) { return a.unusedSince < b.unusedSince; });
+
+        uint32 evicted = 0;
+        for (UnusedGrid const& grid : grids)
+        {
+            if (memory <= m_cacheSize)
+                break;
+
+            grid.terrain->UnloadGrid(grid.x, grid.y);
+            memory = GetTerrainMemory();
+            ++evicted;
+        }
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "TerrainManager: evicted %u of " SIZEFMTD " unused grids, terrain memory " UI64FMTD " KB of " UI64FMTD " KB",
+                         evicted, grids.size(), memory / 1024, m_cacheSize / 1024);
+    }
+
+    // terrains of unloaded maps are kept while their grids are cached
+    for (TerrainDataMap::iterator iter = i_TerrainMap.begin(); iter != i_TerrainMap.end();)
+    {
+        if (!iter->second->IsReferenced() && !iter->second->HasLoadedGrids())
+        {
+            delete iter->second;
+            iter = i_TerrainMap.erase(iter);
+        }
+        else
+            ++iter;
+    }
+}
+
 void TerrainManager::UnloadAll()
 {
+    StopPrefetch();
+
+    {
+        std::lock_guard<std::mutex> guard(m_prewarmLock);
+        m_prewarmedGrids.clear();
+    }
+
     for (auto& it : i_TerrainMap)
         delete it.second;
 
     i_TerrainMap.clear();
 }
 
+void TerrainManager::QueuePrefetch(TerrainInfo* terrain, uint32 x, uint32 y)
+{
+    std::lock_guard<std::mutex> guard(m_prefetchLock);
+    if (m_prefetchStop)
+        return;
+
+    if (!m_prefetchThread.joinable())
+        m_prefetchThread = std::thread(&TerrainManager::PrefetchThread, this);
+
+    // kept referenced while queued, it is the requester's map which may be unloaded meanwhile
+    terrain->AddRef();
+    m_prefetchQueue.push_back({ terrain, x, y });
+    m_prefetchCondition.notify_one();
+}
+
+void TerrainManager::PrewarmGrid(uint32 mapId, float x, float y)
+{
+    if (!sWorld.getConfig(CONFIG_UINT32_GRID_PREFETCH_LOOKAHEAD) || !MaNGOS::IsValidMapCoord(x, y))
+        return;
+
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+    uint32 const gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    uint32 const gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+    uint32 const holdTime = MINUTE * IN_MILLISECONDS;
+
+    TerrainInfo* terrain = LoadTerrain(mapId);
+
+    {
+        std::lock_guard<std::mutex> guard(m_prewarmLock);
+        for (PrewarmedGrid& grid : m_prewarmedGrids)
+        {
+            if (grid.terrain == terrain && grid.x == gx && grid.y == gy)
+            {
+                grid.holdTime = holdTime;
+                return;
+            }
+        }
+
+        // the terrain reference keeps a terrain without any map alive, the grid reference lets the prefetch run
+        terrain->AddRef();
+        terrain->RefGrid(gx, gy);
+        m_prewarmedGrids.push_back({ terrain, gx, gy, holdTime });
+    }
+
+    QueuePrefetch(terrain, gx, gy);
+}
+
+void TerrainManager::UpdatePrewarmedGrids(const uint32 diff)
+{
+    std::vector<PrewarmedGrid> expired;
+    {
+        std::lock_guard<std::mutex> guard(m_prewarmLock);
+        for (std::vector<PrewarmedGrid>::iterator itr = m_prewarmedGrids.begin(); itr != m_prewarmedGrids.end();)
+        {
+            if (itr->holdTime <= diff)
+            {
+                expired.push_back(*itr);
+                itr = m_prewarmedGrids.erase(itr);
+            }
+            else
+            {
+                itr->holdTime -= diff;
+                ++itr;
+            }
+        }
+    }
+
+    // a map created meanwhile holds its own references
+    for (PrewarmedGrid const& grid : expired)
+    {
+        grid.terrain->UnrefGrid(grid.x, grid.y);
+        if (grid.terrain->Release())
+            UnloadTerrain(grid.terrain->GetMapId());
+    }
+}
+
+void TerrainManager::PrefetchThread()
+{
+    std::unique_lock<std::mutex> guard(m_prefetchLock);
+    while (true)
+    {
+        m_prefetchCondition.wait(guard, [this] { return m_prefetchStop || !m_prefetchQueue.empty(); });
+        if (m_prefetchStop)
+            return;
+
+        PrefetchRequest request = m_prefetchQueue.front();
+        m_prefetchQueue.pop_front();
+        guard.unlock();
+
+        request.terrain->Prefetch(request.x, request.y);
+        // an unreferenced terrain stays known to the manager and is reused or freed with the others
+        request.terrain->Release();
+
+        guard.lock();
+    }
+}
+
+void TerrainManager::StopPrefetch()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_prefetchLock);
+        m_prefetchStop = true;
+        for (PrefetchRequest const& request : m_prefetchQueue)
+            request.terrain->Release();
+        m_prefetchQueue.clear();
+    }
+
+    m_prefetchCondition.notify_all();
+    if (m_prefetchThread.joinable())
+        m_prefetchThread.join();
+}
+
 uint32 TerrainManager::GetAreaIdByAreaFlag(uint16 areaflag, uint32 map_id)
 {
     AreaTableEntry const* entry = GetAreaEntryByAreaFlagAndMap(areaflag, map_id);
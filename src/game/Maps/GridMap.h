@@ -21,12 +21,17 @@
 
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
+#include "ProfiledMutex.h"
 #include "Maps/GridDefines.h"
 
 #include "Maps/GridMapDefines.h"
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 
 class Creature;
 class Unit;
@@ -36,6 +41,9 @@ class Group;
 class BattleGround;
 class Map;
 
+#define AREA_CACHE_PRECISION    2.0f                        // positions are quantized to half a yard
+#define AREA_CACHE_MAX_ENTRIES  4096                        // per grid, the cache starts over when full
+
 class GridMap
 {
     private:
@@ -78,10 +86,26 @@ class GridMap
         // For fast check
         bool m_fullyLoaded;
 
+        // results of TerrainInfo::GetAreaFlag once the vmap tile is loaded, by quantized position
+        struct AreaCacheEntry
+        {
+            uint16 areaFlag;
+            bool isOutdoors;
+        };
+        std::mutex m_areaCacheLock;                         // the grid is shared by all maps of the terrain
+        std::unordered_map<uint64, AreaCacheEntry> m_areaCache;
+
+        // read only view of the whole file when the arrays point into it, shared by all processes through the page cache
+        void* m_mapping;
+        size_t m_mappingSize;
+        size_t m_memoryUsage;                               // accounted as MEMORY_TAG_TERRAIN while loaded
+
         bool loadAreaData(FILE* in, uint32 offset, uint32 size);
         bool loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
         bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+        bool loadMappedData(char const* filename);
+        bool setMappedData(GridMapFileHeader const& header);
         bool isHole(int row, int col) const;
 
         // Get height functions and pointers
@@ -107,6 +131,10 @@ class GridMap
 
         uint16 getArea(float x, float y) const;
 
+        static uint64 GetAreaCacheKey(float x, float y, float z);
+        bool GetCachedArea(uint64 key, uint16& areaFlag, bool& isOutdoors);
+        void AddCachedArea(uint64 key, uint16 areaFlag, bool isOutdoors);
+
         inline float getHeight(float x, float y) const { return (this->*m_gridGetHeight)(x, y); }
         float getLiquidLevel(float x, float y) const;
         uint8 getTerrainType(float x, float y) const;
@@ -174,9 +202,21 @@ class TerrainInfo : public Referencable<std::atomic_long>
         // THIS METHOD IS NOT THREAD-SAFE!!!! AND IT SHOULDN'T BE THREAD-SAFE!!!!
         void CleanUpGrids(const uint32 diff);
 
+        // called by the terrain prefetch thread for a grid referenced by its requester
+        // loads the height map and reads the vmap and mmap tiles into the file cache, their trees are only changed by map threads
+        void Prefetch(const uint32 x, const uint32 y);
+
+        // used by the TerrainManager cache, a grid is unused while loaded and not referenced by any map
+        bool IsGridUnused(const uint32 x, const uint32 y) const { return m_GridMaps[x][y] && m_GridRef[x][y] == 0; }
+        uint32 GetGridUnusedSince(const uint32 x, const uint32 y) const { return m_GridUnusedSince[x][y]; }
+        bool HasLoadedGrids() const;
+        // drops the height map, vmap and mmap tile of the grid, same thread restrictions as CleanUpGrids
+        void UnloadGrid(const uint32 x, const uint32 y);
+
     protected:
         friend class Map;
         friend class ObjectMgr;
+        friend class TerrainManager;
         // load/unload terrain data
         GridMap* Load(const uint32 x, const uint32 y, bool mapOnly = false);
         void Unload(const uint32 x, const uint32 y);
@@ -195,11 +235,12 @@ class TerrainInfo : public Referencable<std::atomic_long>
 
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        uint32 m_GridUnusedSince[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];    // unix time of the last release or unreferenced load
 
         // global garbage collection timer
         ShortIntervalTimer i_timer;
 
-        typedef std::mutex LOCK_TYPE;
+        typedef ProfiledMutex LOCK_TYPE;
         typedef std::lock_guard<LOCK_TYPE> LOCK_GUARD;
         LOCK_TYPE m_mutex;
         LOCK_TYPE m_refMutex;
@@ -218,6 +259,17 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
         void Update(const uint32 diff);
         void UnloadAll();
 
+        // keep unused grids and terrains loaded until the terrain memory exceeds the size, 0 frees them at the next clean up
+        void SetCacheSize(uint64 bytes) { m_cacheSize = bytes; }
+        // memory of the loaded height maps, vmap models and navmesh tiles of all maps
+        static uint64 GetTerrainMemory();
+
+        // prepare terrain of a grid on the prefetch thread, the caller references the grid until the grid is loaded or dropped
+        void QueuePrefetch(TerrainInfo* terrain, uint32 x, uint32 y);
+        // prefetch the destination grid of a far teleport while the client shows the loading screen, the grid is kept
+        // referenced for a minute so the destination map, usually a new instance, finds the grid prepared when it is created
+        void PrewarmGrid(uint32 mapId, float x, float y);
+
         uint16 GetAreaFlag(uint32 mapid, float x, float y, float z) const
         {
             TerrainInfo* pData = const_cast<TerrainManager*>(this)->LoadTerrain(mapid);
@@ -249,6 +301,39 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
 
         typedef MaNGOS::ClassLevelLockable<TerrainManager, std::mutex>::Lock Guard;
         TerrainDataMap i_TerrainMap;
+
+        struct PrefetchRequest
+        {
+            TerrainInfo* terrain;
+            uint32 x;
+            uint32 y;
+        };
+
+        void EvictUnusedGrids();
+        void UpdatePrewarmedGrids(const uint32 diff);
+
+        void PrefetchThread();
+        void StopPrefetch();
+
+        std::thread m_prefetchThread;
+        std::mutex m_prefetchLock;
+        std::condition_variable m_prefetchCondition;
+        std::deque<PrefetchRequest> m_prefetchQueue;
+        bool m_prefetchStop;
+
+        uint64 m_cacheSize;
+        ShortIntervalTimer m_cacheTimer;
+
+        struct PrewarmedGrid
+        {
+            TerrainInfo* terrain;
+            uint32 x;
+            uint32 y;
+            uint32 holdTime;                                // ms until the reference is dropped
+        };
+
+        std::mutex m_prewarmLock;                           // teleports happen in map threads
+        std::vector<PrewarmedGrid> m_prewarmedGrids;
 };
 
 #define sTerrainMgr TerrainManager::Instance()
@@ -18,6 +18,7 @@
 
 #include "Maps/Map.h"
 #include "Maps/MapManager.h"
+#include "Maps/MapWorkers.h"
 #include "Entities/Player.h"
 #include "Grids/GridNotifiers.h"
 #include "Log.h"
@@ -34,6 +35,7 @@
 #include "Maps/MapPersistentStateMgr.h"
 #include "VMapFactory.h"
 #include "MotionGenerators/MoveMap.h"
+#include "MotionGenerators/PathMovementGenerator.h"
 #include "Chat/Chat.h"
 #include "Weather/Weather.h"
 #include "Grids/ObjectGridLoader.h"
@@ -55,6 +57,9 @@ Map::~Map()
     // unload instance specific navigation data
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
 
+    while (!m_prefetchedTerrain.empty())
+        ReleasePrefetchedTerrain(m_prefetchedTerrain.begin()->first);
+
     // release reference count
     if (m_TerrainData->Release())
         sTerrainMgr.UnloadTerrain(m_TerrainData->GetMapId());
@@ -87,14 +92,82 @@ void Map::LoadMapAndVMap(int gx, int gy)
         m_bLoadedGrids[gx][gy] = true;
 }
 
+void Map::PrefetchTerrainAhead(Player* player)
+{
+    uint32 const lookahead = sWorld.getConfig(CONFIG_UINT32_GRID_PREFETCH_LOOKAHEAD);
+    if (!lookahead || !(player->IsTaxiFlying() || player->IsMovingForward()))
+        return;
+
+    float const speed = player->IsTaxiFlying() ? TAXI_FLIGHT_SPEED : player->GetSpeed(MovementInfo::GetSpeedType(player->m_movementInfo.GetMovementFlags()));
+    float const distance = speed * lookahead;
+    float const dx = cos(player->GetOrientation());
+    float const dy = sin(player->GetOrientation());
+
+    std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+    if (m_parallelCellUpdate)
+        guard.lock();
+
+    // half grid steps, no grid crossed by the path is skipped
+    for (float step = std::min(distance, SIZE_OF_GRIDS / 2);; step = std::min(step + SIZE_OF_GRIDS / 2, distance))
+    {
+        float x = player->GetPositionX() + dx * step;
+        float y = player->GetPositionY() + dy * step;
+        if (!MaNGOS::IsValidMapCoord(x, y))
+            break;
+
+        GridPair p = MaNGOS::ComputeGridPair(x, y);
+        uint32 const gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+        uint32 const gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+        uint32 const index = gx * MAX_NUMBER_OF_GRIDS + gy;
+
+        std::map<uint32, uint32>::iterator itr = m_prefetchedTerrain.find(index);
+        if (itr != m_prefetchedTerrain.end())
+            itr->second = lookahead * 2 * IN_MILLISECONDS;
+        else if (!m_bLoadedGrids[gx][gy])
+        {
+            m_TerrainData->RefGrid(gx, gy);
+            m_prefetchedTerrain[index] = lookahead * 2 * IN_MILLISECONDS;
+            sTerrainMgr.QueuePrefetch(m_TerrainData, gx, gy);
+        }
+
+        if (step >= distance)
+            break;
+    }
+}
+
+void Map::UpdatePrefetchedTerrain(uint32 diff)
+{
+    for (std::map<uint32, uint32>::iterator itr = m_prefetchedTerrain.begin(); itr != m_prefetchedTerrain.end();)
+    {
+        uint32 const index = itr->first;
+        // the grid holds its own reference once it is loaded, otherwise the player turned away
+        bool const done = m_bLoadedGrids[index / MAX_NUMBER_OF_GRIDS][index % MAX_NUMBER_OF_GRIDS] || itr->second <= diff;
+        if (!done)
+            itr->second -= diff;
+        ++itr;
+
+        if (done)
+            ReleasePrefetchedTerrain(index);
+    }
+}
+
+void Map::ReleasePrefetchedTerrain(uint32 index)
+{
+    m_TerrainData->UnrefGrid(index / MAX_NUMBER_OF_GRIDS, index % MAX_NUMBER_OF_GRIDS);
+    m_prefetchedTerrain.erase(index);
+}
+
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
     : i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(nullptr),
-      m_activeNonPlayersIter(m_activeNonPlayers.end()), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
-      i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-      i_data(nullptr), i_script_id(0),
-      m_cycleCounter(0), m_updateTimeMin(INT_MAX), m_updateTimeMax(0), m_updateTimeTotal(0)
+      m_activeNonPlayersIter(m_activeNonPlayers.end()), m_messageMutex("Map::m_messageMutex"), m_messageOverflowing(false), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
+      i_gridExpiry(expiry), m_gridStateClock(0), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
+      i_data(nullptr), i_script_id(0), m_parallelCellUpdate(false), m_pathsThisTick(0), m_gridUnloadsThisTick(0),
+      m_lazyCellObjects(sWorld.getConfig(CONFIG_BOOL_GRID_LAZY_CELLS) && i_mapEntry && i_mapEntry->IsContinent()), m_heartbeatsSent(0), m_heartbeatsSuppressed(0),
+      m_updateBudgetSet(false), m_deferredUpdatesThisTick(0), m_deferredUpdatesLastTick(0), m_deferredUpdatesTotal(0),
+      m_cycleCounter(0), m_updateTimeMin(INT_MAX), m_updateTimeMax(0), m_updateTimeTotal(0), m_updateTimeLast(0),
+      m_pendingUpdateDiff(0)
 {
     m_weatherSystem = new WeatherSystem(this);
 }
@@ -239,6 +312,7 @@ void Map::EnsureGridCreated(const GridPair& p)
         buildNGridLinkage(getNGrid(p.x_coord, p.y_coord));
 
         getNGrid(p.x_coord, p.y_coord)->SetGridState(GRID_STATE_IDLE);
+        ScheduleGridState(*getNGrid(p.x_coord, p.y_coord), 0);
 
         // z coord
         int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
@@ -301,6 +375,25 @@ bool Map::EnsureGridLoaded(const Cell& cell)
     return false;
 }
 
+void Map::EnsureCellObjectsLoaded(Cell const& cell)
+{
+    // cells are loaded in the serial part of the update, see CollectActiveCells
+    if (!m_lazyCellObjects || m_parallelCellUpdate)
+        return;
+
+    if (!loaded(GridPair(cell.GridX(), cell.GridY())))
+        return;
+
+    NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
+    if (grid->isCellObjectDataLoaded(cell.CellX(), cell.CellY()))
+        return;
+
+    // set before loading like the grid state, objects added by the load may visit the cell again
+    grid->setCellObjectDataLoaded(cell.CellX(), cell.CellY());
+    ObjectGridLoader loader(*grid, this, cell);
+    loader.LoadCell();
+}
+
 uint32 Map::GetLoadedGridsCount()
 {
     uint32 count = 0;
@@ -318,6 +411,21 @@ void Map::ForceLoadGrid(float x, float y)
         CellPair p = MaNGOS::ComputeCellPair(x, y);
         Cell cell(p);
         EnsureGridLoadedAtEnter(cell);
+
+        // callers look for the spawns of the whole grid
+        if (m_lazyCellObjects)
+        {
+            for (uint32 cellX = 0; cellX < MAX_NUMBER_OF_CELLS; ++cellX)
+            {
+                for (uint32 cellY = 0; cellY < MAX_NUMBER_OF_CELLS; ++cellY)
+                {
+                    Cell gridCell(cell);
+                    gridCell.data.Part.cell_x = cellX;
+                    gridCell.data.Part.cell_y = cellY;
+                    EnsureCellObjectsLoaded(gridCell);
+                }
+            }
+        }
         getNGrid(cell.GridX(), cell.GridY())->setUnloadExplicitLock(true);
     }
 }
@@ -346,6 +454,7 @@ bool Map::Add(Player* player)
     Cell cell(p);
     EnsureGridLoadedAtEnter(cell, player);
     player->AddToWorld();
+    UpdatePlayerTriggers(player, true);
 
     SendInitSelf(player);
     SendInitTransports(player);
@@ -366,6 +475,12 @@ Map::Add(T* obj)
 {
     MANGOS_ASSERT(obj);
 
+    if (m_parallelCellUpdate)
+    {
+        DeferToSerialPhase([obj](Map* map) { map->Add(obj); });
+        return;
+    }
+
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
     {
@@ -442,6 +557,27 @@ void Map::MessageBroadcast(WorldObject const* obj, WorldPacket const& msg)
     cell.Visit(p, message, *this, *obj, obj->GetVisibilityData().GetVisibilityDistance());
 }
 
+void Map::MessageBroadcast(WorldObject const* obj, std::vector<WorldPacket> const& msgs, Player const* skipped_receiver)
+{
+    CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
+
+    if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+    {
+        sLog.outError("Map::MessageBroadcast: Object (GUID: %u TypeId: %u) have invalid coordinates X:%f Y:%f grid cell [%u:%u]", obj->GetGUIDLow(), obj->GetTypeId(), obj->GetPositionX(), obj->GetPositionY(), p.x_coord, p.y_coord);
+        return;
+    }
+
+    Cell cell(p);
+    cell.SetNoCreate();
+
+    if (!loaded(GridPair(cell.data.Part.grid_x, cell.data.Part.grid_y)))
+        return;
+
+    MaNGOS::ObjectMessageBatchDeliverer post_man(msgs, skipped_receiver);
+    TypeContainerVisitor<MaNGOS::ObjectMessageBatchDeliverer, WorldTypeMapContainer > message(post_man);
+    cell.Visit(p, message, *this, *obj, obj->GetVisibilityData().GetVisibilityDistance());
+}
+
 void Map::MessageDistBroadcast(Player const* player, WorldPacket const& msg, float dist, bool to_self, bool own_team_only)
 {
     CellPair p = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
@@ -574,6 +710,7 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
                 CellPair pair(x, y);
                 Cell cell(pair);
                 cell.SetNoCreate();
+                EnsureCellObjectsLoaded(cell);
                 Visit(cell, gridVisitor);
                 Visit(cell, worldVisitor);
             }
@@ -583,104 +720,172 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
 
 void Map::Update(const uint32& t_diff)
 {
+    MapTickProfiler::Scope profile(MAP_TICK_MAP_UPDATE, GetId());
+    m_tickTrace.Start();
     std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 
     m_dyn_tree.update(t_diff);
+    m_pathsThisTick = 0;
+    m_gridUnloadsThisTick = 0;
+    m_queryCache.Clear();
+
+    if (!m_prefetchedTerrain.empty())
+        UpdatePrefetchedTerrain(t_diff);
+
+    if (m_persistentState)
+        m_persistentState->UpdateRespawnTimes(t_diff);
 
     /// update worldsessions for existing players
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
-        Player* plr = m_mapRefIter->getSource();
-        if (plr && plr->IsInWorld())
+        MapTickProfiler::Scope phase(MAP_TICK_SESSIONS, GetId(), &m_tickTrace);
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
         {
-            WorldSession* pSession = plr->GetSession();
-            MapSessionFilter updater(pSession);
+            Player* plr = m_mapRefIter->getSource();
+            if (plr && plr->IsInWorld())
+            {
+                WorldSession* pSession = plr->GetSession();
+                MapSessionFilter updater(pSession);
 
-            pSession->Update(t_diff, updater);
+                pSession->Update(t_diff, updater);
+            }
         }
     }
 
     /// update players at tick
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
-        Player* plr = m_mapRefIter->getSource();
-        if (plr && plr->IsInWorld())
-            plr->Update(t_diff);
+        MapTickProfiler::Scope phase(MAP_TICK_PLAYERS, GetId(), &m_tickTrace);
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* plr = m_mapRefIter->getSource();
+            if (plr && plr->IsInWorld())
+            {
+                MapTickTrace::ObjectScope cost(m_tickTrace, plr->GetObjectGuid());
+                plr->Update(t_diff);
+            }
+        }
     }
 
     /// update active cells around players and active objects
     resetMarkedCells();
 
+    // messages are executed unlocked, so they may post further messages
     {
-        std::lock_guard<std::mutex> guard(m_messageMutex);
-        for (auto& message : m_messageVector)
+        std::function<void(Map*)> message;
+        while (m_messageQueue.Pop(message))
             message(this);
-
-        m_messageVector.clear();
     }
 
-    WorldObjectUnSet objToUpdate;
-    MaNGOS::ObjectUpdater obj_updater(objToUpdate, t_diff);
-    TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
-    TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
-
-    // the player iterator is stored in the map object
-    // to make sure calls to Map::Remove don't invalidate it
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    if (m_messageOverflowing.load(std::memory_order_acquire))
     {
-        Player* player = m_mapRefIter->getSource();
-        if (!player->IsInWorld() || !player->IsPositionValid())
-            continue;
+        std::vector<std::function<void(Map*)>> messages;
+        {
+            std::lock_guard<ProfiledMutex> guard(m_messageMutex);
+            messages.swap(m_messageVector);
+            m_messageOverflowing.store(false, std::memory_order_release);
+        }
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+        for (auto& message : messages)
+            message(this);
+    }
 
-        // If player is using far sight, visit that object too
-        if (WorldObject* viewPoint = GetWorldObject(player->GetFarSightGuid()))
-            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+    UpdateEventSpawns();
+    UpdateCorpses();
+    UpdateRespawns();
+
+    m_deferredUpdatesThisTick = 0;
+    if (uint32 budget = sWorld.getConfig(CONFIG_UINT32_MAP_AI_BUDGET))
+    {
+        m_updateBudgetSet = true;
+        m_updateBudgetEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget);
     }
 
-    // non-player active objects
-    if (!m_activeNonPlayers.empty())
+    if (CanUpdateCellsInParallel())
+    {
+        MapTickProfiler::Scope phase(MAP_TICK_CELLS, GetId(), &m_tickTrace);
+        UpdateCellsInParallel(t_diff);
+    }
+    else
     {
-        for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+        WorldObjectUnSet objToUpdate;
+        MaNGOS::ObjectUpdater obj_updater(objToUpdate, t_diff);
+        TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
+        TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
+
         {
-            // skip not in world
-            WorldObject* obj = *m_activeNonPlayersIter;
+            MapTickProfiler::Scope phase(MAP_TICK_CELLS, GetId(), &m_tickTrace);
 
-            // step before processing, in this case if Map::Remove remove next object we correctly
-            // step to next-next, and if we step to end() then newly added objects can wait next update.
-            ++m_activeNonPlayersIter;
+            // the player iterator is stored in the map object
+            // to make sure calls to Map::Remove don't invalidate it
+            for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+            {
+                Player* player = m_mapRefIter->getSource();
+                if (!player->IsInWorld() || !player->IsPositionValid())
+                    continue;
 
-            if (!obj->IsInWorld() || !obj->IsPositionValid())
-                continue;
+                VisitNearbyCellsOf(player, grid_object_update, world_object_update);
 
-            // lets update mobs/objects in ALL visible cells around player!
-            CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+                // If player is using far sight, visit that object too
+                if (WorldObject* viewPoint = GetWorldObject(player->GetFarSightGuid()))
+                    VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+            }
 
-            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+            // non-player active objects
+            if (!m_activeNonPlayers.empty())
             {
-                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+                for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
                 {
-                    // marked cells are those that have been visited
-                    // don't visit the same cell twice
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
+                    // skip not in world
+                    WorldObject* obj = *m_activeNonPlayersIter;
+
+                    // step before processing, in this case if Map::Remove remove next object we correctly
+                    // step to next-next, and if we step to end() then newly added objects can wait next update.
+                    ++m_activeNonPlayersIter;
+
+                    if (!obj->IsInWorld() || !obj->IsPositionValid())
+                        continue;
+
+                    // lets update mobs/objects in ALL visible cells around player!
+                    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+
+                    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
                     {
-                        markCell(cell_id);
-                        CellPair pair(x, y);
-                        Cell cell(pair);
-                        cell.SetNoCreate();
-                        Visit(cell, grid_object_update);
-                        Visit(cell, world_object_update);
+                        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+                        {
+                            // marked cells are those that have been visited
+                            // don't visit the same cell twice
+                            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+                            if (!isCellMarked(cell_id))
+                            {
+                                markCell(cell_id);
+                                CellPair pair(x, y);
+                                Cell cell(pair);
+                                cell.SetNoCreate();
+                                EnsureCellObjectsLoaded(cell);
+                                Visit(cell, grid_object_update);
+                                Visit(cell, world_object_update);
+                            }
+                        }
                     }
                 }
             }
         }
+
+        MapTickProfiler::Scope phase(MAP_TICK_OBJECTS, GetId(), &m_tickTrace);
+
+        // update all objects, starting at another one every tick so that a spent budget defers different creatures
+        WorldObjectUnSet::iterator itr = objToUpdate.begin();
+        std::advance(itr, GetUpdateRotation(objToUpdate.size()));
+        for (size_t i = 0; i < objToUpdate.size(); ++i)
+        {
+            UpdateActiveObject(*itr, t_diff);
+            if (++itr == objToUpdate.end())
+                itr = objToUpdate.begin();
+        }
     }
 
-    // update all objects
-    for (auto wObj : objToUpdate)
-        wObj->Update(t_diff);
+    m_updateBudgetSet = false;
+    m_deferredUpdatesLastTick = m_deferredUpdatesThisTick;
+    m_deferredUpdatesTotal += m_deferredUpdatesLastTick;
 
     // Send world objects and item update field changes
     SendObjectUpdates();
@@ -689,22 +894,22 @@ void Map::Update(const uint32& t_diff)
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (!IsBattleGroundOrArena())
     {
-        for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
-        {
-            NGridType* grid = i->getSource();
-            GridInfo* info = i->getSource()->getGridInfoRef();
-            ++i;                                            // The update might delete the map and we need the next map before the iterator gets invalid
-            MANGOS_ASSERT(grid->GetGridState() >= 0 && grid->GetGridState() < MAX_GRID_STATE);
-            sMapMgr.UpdateGridState(grid->GetGridState(), *this, *grid, *info, grid->getX(), grid->getY(), t_diff);
-        }
+        MapTickProfiler::Scope phase(MAP_TICK_GRID_STATES, GetId(), &m_tickTrace);
+        UpdateGridStates(t_diff);
     }
 
     ///- Process necessary scripts
     if (!m_scriptSchedule.empty())
+    {
+        MapTickProfiler::Scope phase(MAP_TICK_SCRIPTS, GetId(), &m_tickTrace);
         ScriptsProcess();
+    }
 
     if (i_data)
+    {
+        MapTickProfiler::Scope phase(MAP_TICK_INSTANCE_DATA, GetId(), &m_tickTrace);
         i_data->Update(t_diff);
+    }
 
     std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
     long long duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
@@ -716,9 +921,213 @@ void Map::Update(const uint32& t_diff)
         m_updateTimeMax = duration;
 
     m_updateTimeTotal += duration;
+    m_updateTimeLast = uint32(duration);
     ++m_cycleCounter;
 
-    m_weatherSystem->UpdateWeathers(t_diff);
+    {
+        MapTickProfiler::Scope phase(MAP_TICK_WEATHER, GetId(), &m_tickTrace);
+        m_weatherSystem->UpdateWeathers(t_diff);
+    }
+
+    m_tickTrace.Finish(GetId(), GetInstanceId());
+}
+
+void Map::UpdateActiveObject(WorldObject* obj, uint32 diff)
+{
+    if (m_updateBudgetSet && obj->GetTypeId() == TYPEID_UNIT && std::chrono::steady_clock::now() >= m_updateBudgetEnd)
+    {
+        if (static_cast<Creature*>(obj)->DeferUpdate(diff))
+        {
+            ++m_deferredUpdatesThisTick;
+            return;
+        }
+    }
+
+    MapTickTrace::ObjectScope cost(m_tickTrace, obj->GetObjectGuid());
+    obj->Update(diff);
+}
+
+bool Map::CanUpdateCellsInParallel() const
+{
+    // instances and battlegrounds are already updated in parallel to each other
+    uint32 minPlayers = sWorld.getConfig(CONFIG_UINT32_MAP_PARALLEL_CELLS_MIN_PLAYERS);
+    if (!minPlayers || !IsContinent() || m_mapRefManager.getSize() < minPlayers)
+        return false;
+
+    MapUpdater& updater = sMapMgr.GetMapUpdater();
+    return updater.activated() && updater.thread_count() > 1;
+}
+
+void Map::CollectActiveCells(WorldObject const* obj, std::map<uint32, CellRegion>& regions)
+{
+    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            // marked cells are those that have been visited
+            // don't visit the same cell twice
+            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+            if (isCellMarked(cell_id))
+                continue;
+
+            markCell(cell_id);
+            Cell cell(CellPair(x, y));
+            cell.SetNoCreate();
+            if (!loaded(GridPair(cell.GridX(), cell.GridY())))
+                continue;
+
+            EnsureCellObjectsLoaded(cell);
+
+            uint32 gridId = cell.GridX() * MAX_NUMBER_OF_GRIDS + cell.GridY();
+            std::map<uint32, CellRegion>::iterator itr = regions.find(gridId);
+            if (itr == regions.end())
+                itr = regions.emplace(gridId, CellRegion(cell.GridX(), cell.GridY())).first;
+            itr->second.cells.push_back(cell);
+        }
+    }
+}
+
+void Map::RunCellRegionBatch(std::shared_ptr<CellRegionBatch> const& batch)
+{
+    if (!batch->GetRegionCount())
+        return;
+
+    MapUpdater& updater = sMapMgr.GetMapUpdater();
+    size_t helpers = std::min(updater.thread_count(), batch->GetRegionCount()) - 1;
+    for (size_t i = 0; i < helpers; ++i)
+        updater.schedule_update(new GridCrawler(*this, batch, updater));
+
+    // this thread takes regions too, helpers still queued behind other maps find nothing left
+    while (batch->ProcessNext(*this)) {}
+
+    batch->Wait();
+}
+
+/**
+ * Update active cells of a crowded map on several MapUpdater threads.
+ *
+ * Every loaded grid with active cells forms one region. Objects of all regions are collected
+ * first, so an object moving into another region is still updated once per tick. Regions are
+ * then updated in nine passes, each pass only containing grids that are 3 grids apart, so the
+ * neighbourhoods (grid +-1) touched by searchers and short relocations never overlap.
+ * Everything else changing map wide containers is deferred with DeferToSerialPhase.
+ */
+void Map::UpdateCellsInParallel(uint32 t_diff)
+{
+    std::map<uint32, CellRegion> regions;
+
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    {
+        Player* player = m_mapRefIter->getSource();
+        if (!player->IsInWorld() || !player->IsPositionValid())
+            continue;
+
+        CollectActiveCells(player, regions);
+
+        // If player is using far sight, visit that object too
+        if (WorldObject* viewPoint = GetWorldObject(player->GetFarSightGuid()))
+            CollectActiveCells(viewPoint, regions);
+    }
+
+    for (auto obj : m_activeNonPlayers)
+        if (obj->IsInWorld() && obj->IsPositionValid())
+            CollectActiveCells(obj, regions);
+
+    std::vector<CellRegion*> crawlRegions;
+    std::vector<CellRegion*> passRegions[3 * 3];
+    crawlRegions.reserve(regions.size());
+    for (auto& region : regions)
+    {
+        crawlRegions.push_back(&region.second);
+        passRegions[(region.second.gridX % 3) * 3 + region.second.gridY % 3].push_back(&region.second);
+    }
+
+    // collecting only reads grid containers, no pass separation required
+    RunCellRegionBatch(std::make_shared<CellRegionBatch>(std::move(crawlRegions), CellRegionBatch::STAGE_CRAWL, t_diff));
+
+    m_parallelCellUpdate = true;
+    for (auto& pass : passRegions)
+        RunCellRegionBatch(std::make_shared<CellRegionBatch>(std::move(pass), CellRegionBatch::STAGE_UPDATE, t_diff));
+    m_parallelCellUpdate = false;
+
+    // deferred actions are applied in queue order, they may queue nothing new now
+    std::vector<std::function<void(Map*)>> deferredActions;
+    std::swap(deferredActions, m_deferredActions);
+    for (auto& action : deferredActions)
+        action(this);
+}
+
+void Map::ScheduleGridState(NGridType& grid, time_t delay)
+{
+    std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+    if (m_parallelCellUpdate)
+        guard.lock();
+
+    grid.ResetTimeTracker(delay);
+    grid.getGridInfoRef()->setTimerUpdateTime(m_gridStateClock);
+    m_gridStateQueue.push(GridStateEntry(m_gridStateClock + delay, grid.GetGridId()));
+}
+
+bool Map::ConsumePathBudget()
+{
+    uint32 const budget = sWorld.getConfig(CONFIG_UINT32_MMAP_MAX_CHASE_PATHS_PER_TICK);
+    if (!budget)
+        return true;
+
+    return ++m_pathsThisTick <= budget;
+}
+
+bool Map::HasGridUnloadBudget() const
+{
+    uint32 const budget = sWorld.getConfig(CONFIG_UINT32_GRID_UNLOADS_PER_UPDATE);
+    return !budget || m_gridUnloadsThisTick < budget;
+}
+
+void Map::UpdateGridStates(uint32 diff)
+{
+    m_gridStateClock += diff;
+
+    while (!m_gridStateQueue.empty() && m_gridStateQueue.top().first <= m_gridStateClock)
+    {
+        uint32 const gridId = m_gridStateQueue.top().second;
+        m_gridStateQueue.pop();
+
+        // unloaded grid, or one loaded again with its own entries
+        NGridType* grid = getNGrid(gridId / MAX_NUMBER_OF_GRIDS, gridId % MAX_NUMBER_OF_GRIDS);
+        if (!grid)
+            continue;
+
+        GridInfo* info = grid->getGridInfoRef();
+        info->UpdateTimeTracker(time_t(m_gridStateClock - info->getTimerUpdateTime()));
+        info->setTimerUpdateTime(m_gridStateClock);
+
+        // entry of a timer reset since, the grid is queued again for the new timer
+        if (grid->GetGridState() != GRID_STATE_IDLE && !info->getTimeTracker().Passed())
+            continue;
+
+        MANGOS_ASSERT(grid->GetGridState() >= 0 && grid->GetGridState() < MAX_GRID_STATE);
+        sMapMgr.UpdateGridState(grid->GetGridState(), *this, *grid, *info, grid->getX(), grid->getY(), 0);
+    }
+}
+
+void Map::DeferToSerialPhase(std::function<void(Map*)> const& action)
+{
+    std::lock_guard<std::mutex> guard(m_parallelLock);
+    m_deferredActions.push_back(action);
+}
+
+bool Map::IsDeferredRelocation(Cell const& old_cell, Cell const& new_cell) const
+{
+    if (!m_parallelCellUpdate)
+        return false;
+
+    // leaving the neighbourhood of the updated grid or loading a grid touches other regions
+    if (std::abs(int32(old_cell.GridX()) - int32(new_cell.GridX())) > 1 || std::abs(int32(old_cell.GridY()) - int32(new_cell.GridY())) > 1)
+        return true;
+
+    return !loaded(new_cell.gridPair());
 }
 
 void Map::Remove(Player* player, bool remove)
@@ -726,6 +1135,8 @@ void Map::Remove(Player* player, bool remove)
     if (i_data)
         i_data->OnPlayerLeave(player);
 
+    UpdatePlayerTriggers(player, false);
+
     if (remove)
         player->CleanupsBeforeDelete();
     else
@@ -777,6 +1188,12 @@ template<class T>
 void
 Map::Remove(T* obj, bool remove)
 {
+    if (m_parallelCellUpdate)
+    {
+        DeferToSerialPhase([obj, remove](Map* map) { map->Remove(obj, remove); });
+        return;
+    }
+
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
     {
@@ -827,7 +1244,14 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
     Cell new_cell(new_val);
     bool same_cell = (new_cell == old_cell);
 
+    if (IsDeferredRelocation(old_cell, new_cell))
+    {
+        DeferToSerialPhase([player, x, y, z, orientation](Map* map) { map->PlayerRelocation(player, x, y, z, orientation); });
+        return;
+    }
+
     player->Relocate(x, y, z, orientation);
+    UpdatePlayerTriggers(player, true);
 
     if (old_cell.DiffGrid(new_cell) || old_cell.DiffCell(new_cell))
     {
@@ -845,6 +1269,7 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
     }
 
     player->OnRelocated();
+    PrefetchTerrainAhead(player);
 
     NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
     if (!same_cell && newGrid->GetGridState() != GRID_STATE_ACTIVE)
@@ -854,10 +1279,73 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
     }
 }
 
+void Map::AddPlayerTrigger(ObjectGuid const& owner, float x, float y, float z, float radius)
+{
+    std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+    if (m_parallelCellUpdate)
+        guard.lock();
+
+    PlayerTrigger& trigger = m_playerTriggers[owner];
+    trigger.x = x;
+    trigger.y = y;
+    trigger.z = z;
+    trigger.radiusSq = radius * radius;
+    trigger.players.clear();
+
+    for (auto& ref : m_mapRefManager)
+    {
+        Player* player = ref.getSource();
+        if (player->IsInWorld() && player->GetDistance(x, y, z, DIST_CALC_NONE) <= trigger.radiusSq)
+            trigger.players.insert(player->GetObjectGuid());
+    }
+}
+
+void Map::RemovePlayerTrigger(ObjectGuid const& owner)
+{
+    std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+    if (m_parallelCellUpdate)
+        guard.lock();
+
+    m_playerTriggers.erase(owner);
+}
+
+void Map::GetPlayerTriggerPlayers(ObjectGuid const& owner, GuidVector& players)
+{
+    std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+    if (m_parallelCellUpdate)
+        guard.lock();
+
+    auto itr = m_playerTriggers.find(owner);
+    if (itr != m_playerTriggers.end())
+        players.assign(itr->second.players.begin(), itr->second.players.end());
+}
+
+void Map::UpdatePlayerTriggers(Player* player, bool inMap)
+{
+    std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+    if (m_parallelCellUpdate)
+        guard.lock();
+
+    for (auto& itr : m_playerTriggers)
+    {
+        PlayerTrigger& trigger = itr.second;
+        if (inMap && player->GetDistance(trigger.x, trigger.y, trigger.z, DIST_CALC_NONE) <= trigger.radiusSq)
+            trigger.players.insert(player->GetObjectGuid());
+        else
+            trigger.players.erase(player->GetObjectGuid());
+    }
+}
+
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang)
 {
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
 
+    if (IsDeferredRelocation(creature->GetCurrentCell(), new_cell))
+    {
+        DeferToSerialPhase([creature, x, y, z, ang](Map* map) { map->CreatureRelocation(creature, x, y, z, ang); });
+        return;
+    }
+
     // do move or do move to respawn or remove creature if previous all fail
     if (CreatureCellRelocation(creature, new_cell))
     {
@@ -907,6 +1395,10 @@ bool Map::CreatureRespawnRelocation(Creature* c)
     CellPair resp_val = MaNGOS::ComputeCellPair(resp_x, resp_y);
     Cell resp_cell(resp_val);
 
+    // the cell loads the creature again once it is seen
+    if (m_lazyCellObjects && !IsLoaded(resp_x, resp_y))
+        return false;
+
     c->CombatStopWithPets();
     c->GetMotionMaster()->Clear();
 
@@ -948,6 +1440,7 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
         unloader.UnloadN();
         delete getNGrid(x, y);
         setNGrid(nullptr, x, y);
+        ++m_gridUnloadsThisTick;
     }
 
     int gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
@@ -1104,6 +1597,12 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 {
     MANGOS_ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
+    if (m_parallelCellUpdate)
+    {
+        DeferToSerialPhase([obj](Map* map) { map->AddObjectToRemoveList(obj); });
+        return;
+    }
+
     obj->CleanupsBeforeDelete();                            // remove or simplify at least cross referenced links
 
     i_objectsToRemove.insert(obj);
@@ -1219,9 +1718,16 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    if (m_parallelCellUpdate)
+    {
+        DeferToSerialPhase([obj](Map* map) { map->AddToActive(obj); });
+        return;
+    }
+
     m_activeNonPlayers.insert(obj);
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
+    EnsureCellObjectsLoaded(cell);
 
     // also not allow unloading spawn grid to prevent creating creature clone at load
     if (obj->GetTypeId() == TYPEID_UNIT)
@@ -1247,6 +1753,12 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    if (m_parallelCellUpdate)
+    {
+        DeferToSerialPhase([obj](Map* map) { map->RemoveFromActive(obj); });
+        return;
+    }
+
     // Map::Update for active object in proccess
     if (m_activeNonPlayersIter != m_activeNonPlayers.end())
     {
@@ -1781,9 +2293,14 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
     ObjectGuid targetGuid = target ? target->GetObjectGuid() : ObjectGuid();
     ObjectGuid ownerGuid  = source->isType(TYPEMASK_ITEM) ? ((Item*)source)->GetOwnerGuid() : ObjectGuid();
 
-    if (execParams)                                         // Check if the execution should be uniquely
+    std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+    if (m_parallelCellUpdate)
+        guard.lock();
+
+    ScriptScheduleIndex::const_iterator indexItr = m_scriptScheduleIndex.find(ScriptScheduleKey(scripts.first, id));
+    if (execParams && indexItr != m_scriptScheduleIndex.end()) // Check if the execution should be uniquely
     {
-        for (ScriptScheduleMap::const_iterator searchItr = m_scriptSchedule.begin(); searchItr != m_scriptSchedule.end(); ++searchItr)
+        for (ScriptScheduleMap::iterator searchItr : indexItr->second)
         {
             if (searchItr->second.IsSameScript(scripts.first, id,
                                                execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE ? sourceGuid : ObjectGuid(),
@@ -1800,12 +2317,11 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
     for (const auto& iter : *s2)
     {
         ScriptAction sa(scripts.first, this, sourceGuid, targetGuid, ownerGuid, &iter.second);
-
-        m_scriptSchedule.insert(ScriptScheduleMap::value_type(time_t(sWorld.GetGameTime() + iter.first), sa));
-
-        sScriptMgr.IncreaseScheduledScriptsCount();
+        ScheduleScriptStep(time_t(sWorld.GetGameTime() + iter.first), sa);
     }
 
+    sScriptMgr.CountScriptStart(scripts.first);
+
     return true;
 }
 
@@ -1820,11 +2336,42 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
 
     ScriptAction sa("Internal Activate Command used for spell", this, sourceGuid, targetGuid, ownerGuid, &script);
 
-    m_scriptSchedule.insert(ScriptScheduleMap::value_type(time_t(sWorld.GetGameTime() + delay), sa));
+    std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+    if (m_parallelCellUpdate)
+        guard.lock();
+
+    ScheduleScriptStep(time_t(sWorld.GetGameTime() + delay), sa);
+}
+
+void Map::ScheduleScriptStep(time_t time, ScriptAction const& action)
+{
+    ScriptScheduleMap::iterator itr = m_scriptSchedule.insert(ScriptScheduleMap::value_type(time, action));
+    m_scriptScheduleIndex[ScriptScheduleKey(action.GetTableName(), action.GetId())].push_back(itr);
 
     sScriptMgr.IncreaseScheduledScriptsCount();
 }
 
+void Map::EraseScriptStep(ScriptScheduleMap::iterator itr)
+{
+    ScriptScheduleIndex::iterator indexItr = m_scriptScheduleIndex.find(ScriptScheduleKey(itr->second.GetTableName(), itr->second.GetId()));
+    std::vector<ScriptScheduleMap::iterator>& steps = indexItr->second;
+    for (size_t i = 0; i < steps.size(); ++i)
+    {
+        if (steps[i] == itr)
+        {
+            steps[i] = steps.back();
+            steps.pop_back();
+            break;
+        }
+    }
+    if (steps.empty())
+        m_scriptScheduleIndex.erase(indexItr);
+
+    m_scriptSchedule.erase(itr);
+
+    sScriptMgr.DecreaseScheduledScriptCount();
+}
+
 /// Process queued scripts
 void Map::ScriptsProcess()
 {
@@ -1836,32 +2383,29 @@ void Map::ScriptsProcess()
     // ok as multimap is a *sorted* associative container
     while (!m_scriptSchedule.empty() && (iter->first <= sWorld.GetGameTime()))
     {
-        if (iter->second.HandleScriptStep())
+        bool terminated = iter->second.HandleScriptStep();
+        sScriptMgr.CountScriptStep(iter->second.GetTableName(), terminated);
+
+        if (terminated)
         {
-            // Terminate following script steps of this script
+            // Terminate following script steps of this script, the executed step is one of them
             const char* tableName = iter->second.GetTableName();
             uint32 id = iter->second.GetId();
             ObjectGuid sourceGuid = iter->second.GetSourceGuid();
             ObjectGuid targetGuid = iter->second.GetTargetGuid();
             ObjectGuid ownerGuid = iter->second.GetOwnerGuid();
 
-            for (ScriptScheduleMap::iterator rmItr = m_scriptSchedule.begin(); rmItr != m_scriptSchedule.end();)
-            {
+            std::vector<ScriptScheduleMap::iterator> removed;
+            for (ScriptScheduleMap::iterator rmItr : m_scriptScheduleIndex[ScriptScheduleKey(tableName, id)])
                 if (rmItr->second.IsSameScript(tableName, id, sourceGuid, targetGuid, ownerGuid))
-                {
-                    m_scriptSchedule.erase(rmItr++);
-                    sScriptMgr.DecreaseScheduledScriptCount();
-                }
-                else
-                    ++rmItr;
-            }
+                    removed.push_back(rmItr);
+
+            for (ScriptScheduleMap::iterator rmItr : removed)
+                EraseScriptStep(rmItr);
         }
         else
-        {
-            m_scriptSchedule.erase(iter);
+            EraseScriptStep(iter);
 
-            sScriptMgr.DecreaseScheduledScriptCount();
-        }
         iter = m_scriptSchedule.begin();
     }
 }
@@ -1994,27 +2538,57 @@ WorldObject* Map::GetWorldObject(ObjectGuid guid)
 
 void Map::SendObjectUpdates()
 {
-    UpdateDataMapType update_players;
+    MapTickProfiler::Scope profile(MAP_TICK_SEND_OBJECT_UPDATES, GetId(), &m_tickTrace);
+
+    // objects changed while building are appended and handled by the same loop
+    for (size_t i = 0; i < i_objectsToClientUpdate.size(); ++i)
+        if (Object* obj = i_objectsToClientUpdate[i])
+            obj->BuildUpdateData(i_clientUpdateDatas);
+    i_objectsToClientUpdate.clear();
 
-    while (!i_objectsToClientUpdate.empty())
+    std::vector<UpdateDataMapType::value_type*> receivers;
+    receivers.reserve(i_clientUpdateDatas.size());
+    for (UpdateDataMapType::iterator itr = i_clientUpdateDatas.begin(); itr != i_clientUpdateDatas.end();)
     {
-        Object* obj = *i_objectsToClientUpdate.begin();
-        i_objectsToClientUpdate.erase(i_objectsToClientUpdate.begin());
-        obj->BuildUpdateData(update_players);
+        // no data this tick, the player may not exist anymore, so the entry is dropped without touching the key
+        if (!itr->second.HasData())
+        {
+            itr = i_clientUpdateDatas.erase(itr);
+            continue;
+        }
+
+        receivers.push_back(&*itr);
+        ++itr;
     }
 
-    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
-    for (auto& update_player : update_players)
+    auto batch = std::make_shared<UpdatePacketBatch>(std::move(receivers));
+
+    // packet building and compression only touch the receiver's own update data
+    size_t helpers = 0;
+#ifndef BUILD_PLAYERBOT                                     // bot AI reacts to sent packets in game state
+    if (batch->GetReceiverCount() > UpdatePacketBatch::CHUNK_SIZE && CanUpdateCellsInParallel())
     {
-        update_player.second.BuildPacket(packet);
-        update_player.first->GetSession()->SendPacket(packet);
-        packet.clear();                                     // clean the string
+        MapUpdater& updater = sMapMgr.GetMapUpdater();
+        size_t chunks = (batch->GetReceiverCount() + UpdatePacketBatch::CHUNK_SIZE - 1) / UpdatePacketBatch::CHUNK_SIZE;
+        helpers = std::min(updater.thread_count(), chunks) - 1;
+        for (size_t i = 0; i < helpers; ++i)
+            updater.schedule_update(new UpdatePacketSender(batch, updater));
     }
+#endif
+
+    while (batch->ProcessNext()) {}
+
+    if (helpers)
+        batch->Wait();
 }
 
 uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
 {
     // TODO: for map local guid counters possible force reload map instead shutdown server at guid counter overflow
+    std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+    if (m_parallelCellUpdate)
+        guard.lock();
+
     switch (guidhigh)
     {
         case HIGHGUID_UNIT:
@@ -2135,8 +2709,23 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, bool ignoreM2Model) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+    bool const useCache = sWorld.getConfig(CONFIG_BOOL_VMAP_QUERY_CACHE);
+    bool result;
+    if (useCache && m_queryCache.GetLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model, result))
+        return result;
+
+    result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model)
+             && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+
+    if (useCache)
+        m_queryCache.AddLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model, result);
+    return result;
+}
+
+void Map::IsInLineOfSight(float srcX, float srcY, float srcZ, std::vector<G3D::Vector3> const& targets, std::vector<bool>& results, bool ignoreM2Model) const
+{
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, targets, results, ignoreM2Model);
+    m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, targets, results);
 }
 
 /**
@@ -2225,21 +2814,32 @@ bool Map::GetHeightInRange(float x, float y, float& z, float maxSearchDist /*= 4
 
 float Map::GetHeight(float x, float y, float z) const
 {
+    bool const useCache = sWorld.getConfig(CONFIG_BOOL_VMAP_QUERY_CACHE);
+    float height;
+    if (useCache && m_queryCache.GetHeight(x, y, z, height))
+        return height;
+
     float staticHeight = m_TerrainData->GetHeightStatic(x, y, z);
 
     // Get Dynamic Height around static Height (if valid)
     float dynSearchHeight = 2.0f + (z < staticHeight ? staticHeight : z);
-    return std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight));
+    height = std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight));
+
+    if (useCache)
+        m_queryCache.AddHeight(x, y, z, height);
+    return height;
 }
 
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.insert(mdl);
+    m_queryCache.Clear();
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.remove(mdl);
+    m_queryCache.Clear();
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
@@ -2419,8 +3019,134 @@ bool Map::GetReachableRandomPosition(Unit* unit, float& x, float& y, float& z, f
 
 void Map::AddMessage(const std::function<void(Map*)>& message)
 {
-    std::lock_guard<std::mutex> guard(m_messageMutex);
+    // once the ring has been full everything goes to the overflow list until it is drained
+    if (!m_messageOverflowing.load(std::memory_order_acquire))
+    {
+        std::function<void(Map*)> copy(message);
+        if (m_messageQueue.Push(std::move(copy)))
+            return;
+    }
+
+    std::lock_guard<ProfiledMutex> guard(m_messageMutex);
     m_messageVector.push_back(message);
+    m_messageOverflowing.store(true, std::memory_order_release);
+}
+
+bool Map::HasMessages()
+{
+    if (!m_messageQueue.Empty() || m_messageOverflowing.load(std::memory_order_acquire))
+        return true;
+
+    std::lock_guard<ProfiledMutex> guard(m_messageMutex);
+    return !m_eventSpawnQueue.empty();
+}
+
+void Map::QueueEventSpawn(const std::function<void(Map*)>& spawn)
+{
+    std::lock_guard<ProfiledMutex> guard(m_messageMutex);
+    m_eventSpawnQueue.push_back(spawn);
+}
+
+size_t Map::GetQueuedEventSpawns()
+{
+    std::lock_guard<ProfiledMutex> guard(m_messageMutex);
+    return m_eventSpawnQueue.size();
+}
+
+void Map::UpdateEventSpawns()
+{
+    std::vector<std::function<void(Map*)>> spawns;
+    bool finished;
+    {
+        std::lock_guard<ProfiledMutex> guard(m_messageMutex);
+        if (m_eventSpawnQueue.empty())
+            return;
+
+        size_t count = std::min<size_t>(m_eventSpawnQueue.size(), std::max(sWorld.getConfig(CONFIG_UINT32_GAME_EVENT_SPAWN_BATCH_SIZE), 1u));
+        spawns.assign(m_eventSpawnQueue.begin(), m_eventSpawnQueue.begin() + count);
+        m_eventSpawnQueue.erase(m_eventSpawnQueue.begin(), m_eventSpawnQueue.begin() + count);
+        finished = m_eventSpawnQueue.empty();
+    }
+
+    // executed unlocked, loading an object may queue messages for this map
+    for (auto& spawn : spawns)
+        spawn(this);
+
+    if (finished)
+        DETAIL_LOG("Map %u (instance %u) finished its game event spawns", GetId(), GetInstanceId());
+}
+
+void Map::ScheduleCorpseExpiry(Corpse* corpse)
+{
+    m_corpseExpiry.push(CorpseExpiry(corpse->GetExpiryTime(), corpse->GetOwnerGuid()));
+}
+
+void Map::UpdateCorpses()
+{
+    time_t now = sWorld.GetGameTime();
+    while (!m_corpseExpiry.empty() && m_corpseExpiry.top().first < now)
+    {
+        ObjectGuid ownerGuid = m_corpseExpiry.top().second;
+        m_corpseExpiry.pop();
+
+        // the corpse may have been converted or left the map meanwhile
+        Corpse* corpse = sObjectAccessor.GetCorpseForPlayerGUID(ownerGuid);
+        if (!corpse || !corpse->IsInWorld() || corpse->GetMap() != this)
+            continue;
+
+        // the ghost time can be reset after the entry was scheduled
+        if (corpse->IsExpired(now))
+            sObjectAccessor.ConvertCorpseForPlayer(ownerGuid);
+        else
+            ScheduleCorpseExpiry(corpse);
+    }
+}
+
+void Map::ScheduleRespawn(ObjectGuid guid, time_t respawnTime)
+{
+    std::lock_guard<std::mutex> guard(m_respawnQueueLock);
+    m_respawnQueue.push(ScheduledRespawn(respawnTime, guid));
+}
+
+size_t Map::GetScheduledRespawns()
+{
+    std::lock_guard<std::mutex> guard(m_respawnQueueLock);
+    return m_respawnQueue.size();
+}
+
+void Map::UpdateRespawns()
+{
+    time_t now = time(nullptr);
+
+    // called before the cells are updated, nothing schedules concurrently but the lock is cheap when uncontended
+    std::lock_guard<std::mutex> guard(m_respawnQueueLock);
+    while (!m_respawnQueue.empty() && m_respawnQueue.top().first <= now)
+    {
+        ScheduledRespawn respawn = m_respawnQueue.top();
+        m_respawnQueue.pop();
+
+        // the object may have been removed, or rescheduled for another time
+        if (respawn.second.IsGameObject())
+        {
+            if (GameObject* go = GetGameObject(respawn.second))
+                go->WakeUpForRespawn(respawn.first);
+        }
+        else if (Creature* creature = GetCreature(respawn.second))
+            creature->WakeUpForRespawn(respawn.first);
+    }
+}
+
+void Map::RemoveTransport(Transport* transport)
+{
+    m_transports.erase(std::remove(m_transports.begin(), m_transports.end(), transport), m_transports.end());
+}
+
+void Map::UpdateTransports(uint32 diff)
+{
+    // a transport reaching the end of the map's part of its path removes itself
+    std::vector<Transport*> transports(m_transports);
+    for (Transport* transport : transports)
+        transport->Update(diff);
 }
 
 bool Map::IsMountAllowed() const
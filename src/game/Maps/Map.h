@@ -22,6 +22,8 @@
 #include "Common.h"
 #include "Platform/Define.h"
 #include "Policies/ThreadingModel.h"
+#include "ProfiledMutex.h"
+#include "LockFreeQueue.h"
 
 #include "Server/DBCStructure.h"
 #include "Maps/GridDefines.h"
@@ -29,15 +31,24 @@
 #include "Entities/Object.h"
 #include "Globals/SharedDefines.h"
 #include "Maps/GridMap.h"
+#include "Maps/MapQueryCache.h"
+#include "Maps/MapTickProfiler.h"
+#include "Maps/UnitSpatialHash.h"
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
 #include "DBScripts/ScriptMgr.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "vmap/DynamicTree.h"
 
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <deque>
 #include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <queue>
 
 struct CreatureInfo;
 class Creature;
@@ -53,7 +64,10 @@ struct ScriptInfo;
 class BattleGround;
 class GridMap;
 class GameObjectModel;
+class Transport;
 class WeatherSystem;
+class CellRegionBatch;
+struct CellRegion;
 namespace MaNGOS { struct ObjectUpdater; }
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
@@ -116,6 +130,21 @@ class Map : public GridRefManager<NGridType>
             return false;
         }
 
+        // adds the tick time, false while a map without players and active objects waits for its idle interval
+        bool AddPendingUpdateDiff(uint32 diff, uint32 idleInterval)
+        {
+            m_pendingUpdateDiff += diff;
+            return !idleInterval || HavePlayers() || !m_activeNonPlayers.empty() || !m_transports.empty() || HasMessages() || m_pendingUpdateDiff >= idleInterval;
+        }
+
+        // time since the last update, the next update starts counting from zero
+        uint32 TakePendingUpdateDiff()
+        {
+            uint32 diff = m_pendingUpdateDiff;
+            m_pendingUpdateDiff = 0;
+            return diff;
+        }
+
         virtual void Initialize(bool loadInstanceData = true);
 
         virtual bool Add(Player*);
@@ -130,6 +159,7 @@ class Map : public GridRefManager<NGridType>
 
         void MessageBroadcast(Player const*, WorldPacket const&, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket const&);
+        void MessageBroadcast(WorldObject const*, std::vector<WorldPacket> const&, Player const* skipped_receiver);
         void MessageDistBroadcast(Player const*, WorldPacket const&, float dist, bool to_self, bool own_team_only = false);
         void MessageDistBroadcast(WorldObject const*, WorldPacket const&, float dist);
         void MessageMapBroadcast(WorldObject const* obj, WorldPacket const& msg);
@@ -159,19 +189,31 @@ class Map : public GridRefManager<NGridType>
         bool IsLoaded(float x, float y) const
         {
             GridPair p = MaNGOS::ComputeGridPair(x, y);
-            return loaded(p);
+            if (!loaded(p))
+                return false;
+            if (!m_lazyCellObjects)
+                return true;
+
+            Cell cell(MaNGOS::ComputeCellPair(x, y));
+            return getNGrid(p.x_coord, p.y_coord)->isCellObjectDataLoaded(cell.CellX(), cell.CellY());
         }
 
+        // creatures and gameobjects of a continent cell are only loaded once a camera or active object gets near, see GridLoad.LazyCells
+        bool HasLazyCellObjects() const { return m_lazyCellObjects; }
+        void EnsureCellObjectsLoaded(Cell const& cell);
+
         bool GetUnloadLock(const GridPair& p) const { return getNGrid(p.x_coord, p.y_coord)->getUnloadLock(); }
         void SetUnloadLock(const GridPair& p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadExplicitLock(on); }
         void ForceLoadGrid(float x, float y);
         bool UnloadGrid(const uint32& x, const uint32& y, bool pForce);
         virtual void UnloadAll(bool pForce);
 
-        void ResetGridExpiry(NGridType& grid, float factor = 1) const
+        void ResetGridExpiry(NGridType& grid, float factor = 1)
         {
-            grid.ResetTimeTracker((time_t)((float)i_gridExpiry * factor));
+            ScheduleGridState(grid, (time_t)((float)i_gridExpiry * factor));
         }
+        // reset the grid timer, the state of the grid is updated once the timer passed
+        void ScheduleGridState(NGridType& grid, time_t delay);
 
         time_t GetGridExpiry(void) const { return i_gridExpiry; }
         uint32 GetId(void) const { return i_id; }
@@ -251,6 +293,15 @@ class Map : public GridRefManager<NGridType>
         void RemoveFromOnEventNotified(WorldObject* obj);
         void OnEventHappened(uint16 event_id, bool activate, bool resume);
 
+        // sub-cell index of the in world units, for small radius unit searches
+        UnitSpatialHash& GetUnitSpatialHash() { return m_unitSpatialHash; }
+
+        // players around a position of an owner object, the membership changes when players enter, move or leave the map
+        // so the owner reads its players instead of searching the grids, the radius must cover the owner's own range check
+        void AddPlayerTrigger(ObjectGuid const& owner, float x, float y, float z, float radius);
+        void RemovePlayerTrigger(ObjectGuid const& owner);
+        void GetPlayerTriggerPlayers(ObjectGuid const& owner, GuidVector& players);
+
         Player* GetPlayer(ObjectGuid guid);
         Creature* GetCreature(ObjectGuid guid);
         Creature* GetCreatureByEntry(uint32 entry);
@@ -269,14 +320,35 @@ class Map : public GridRefManager<NGridType>
 
         void AddUpdateObject(Object* obj)
         {
-            i_objectsToClientUpdate.insert(obj);
+            std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+            if (m_parallelCellUpdate)
+                guard.lock();
+            // callers only add objects on their first change since the last send, no duplicate check needed
+            obj->SetClientUpdateIndex(i_objectsToClientUpdate.size());
+            i_objectsToClientUpdate.push_back(obj);
         }
 
         void RemoveUpdateObject(Object* obj)
         {
-            i_objectsToClientUpdate.erase(obj);
+            std::unique_lock<std::mutex> guard(m_parallelLock, std::defer_lock);
+            if (m_parallelCellUpdate)
+                guard.lock();
+            // the slot is left empty, SendObjectUpdates skips it
+            size_t const index = obj->GetClientUpdateIndex();
+            if (index < i_objectsToClientUpdate.size() && i_objectsToClientUpdate[index] == obj)
+                i_objectsToClientUpdate[index] = nullptr;
         }
 
+        // true while cell regions of this map are updated by several threads
+        bool IsParallelCellUpdate() const { return m_parallelCellUpdate; }
+        // queue action touching map wide containers until all cell regions are updated
+        void DeferToSerialPhase(std::function<void(Map*)> const& action);
+
+        // false once this update built as many chase paths as mmap.maxChasePathsPerTick allows
+        bool ConsumePathBudget();
+        // false once this update unloaded as many grids as GridUnload.MaxPerUpdate allows
+        bool HasGridUnloadBudget() const;
+
         // DynObjects currently
         uint32 GenerateLocalLowGuid(HighGuid guidhigh);
 
@@ -295,12 +367,31 @@ class Map : public GridRefManager<NGridType>
         float GetHeight(float x, float y, float z) const;
         bool GetHeightInRange(float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model) const;
+        // one query for many targets of the same origin, results[i] is set for targets[i]
+        void IsInLineOfSight(float x1, float y1, float z1, std::vector<G3D::Vector3> const& targets, std::vector<bool>& results, bool ignoreM2Model) const;
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        // must be called when a model of the dynamic tree changes without being inserted or removed
+        void OnGameObjectModelChanged() { m_queryCache.Clear(); }
+        MapQueryCache const& GetQueryCache() const { return m_queryCache; }
+
+        // client movement heartbeats relayed on this map and left out for distant viewers
+        void AddMovementHeartbeatStats(uint32 sent, uint32 suppressed) { m_heartbeatsSent += sent; m_heartbeatsSuppressed += suppressed; }
+        uint64 GetMovementHeartbeatsSent() const { return m_heartbeatsSent; }
+        uint64 GetMovementHeartbeatsSuppressed() const { return m_heartbeatsSuppressed; }
+
+        // updates an object found in the active cells, out of combat creatures are deferred once MapUpdate.AIBudget is spent
+        void UpdateActiveObject(WorldObject* obj, uint32 diff);
+        uint32 GetDeferredUpdatesLastTick() const { return m_deferredUpdatesLastTick; }
+        uint64 GetDeferredUpdatesTotal() const { return m_deferredUpdatesTotal; }
+        // first of count active objects to update this tick, spread over the objects by a multiplicative hash of the tick
+        size_t GetUpdateRotation(size_t count) const { return count ? size_t(m_cycleCounter * 2654435761u) % count : 0; }
+        // number of the current map update
+        uint32 GetUpdateCycle() const { return m_cycleCounter; }
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
@@ -325,6 +416,24 @@ class Map : public GridRefManager<NGridType>
         bool GetRandomPointUnderWater(float& x, float& y, float& z, float radius, GridMapLiquidData& liquid_status, bool randomRange = true) const;
 
         void AddMessage(const std::function<void(Map*)>& message);
+        bool HasMessages();
+
+        // resurrectable corpses of the map are converted to bones once expired, without the world thread
+        void ScheduleCorpseExpiry(Corpse* corpse);
+
+        // dead creatures and despawned gameobjects sleep until their respawn time, the cell updates skip them meanwhile
+        void ScheduleRespawn(ObjectGuid guid, time_t respawnTime);
+        size_t GetScheduledRespawns();
+
+        // game event spawns and despawns, the map executes Event.SpawnBatchSize of them per update in queue order
+        void QueueEventSpawn(const std::function<void(Map*)>& spawn);
+        size_t GetQueuedEventSpawns();
+
+        // transports currently at the map, updated by its update job after the map itself
+        // a transport moving to another map is handed over through the message queue of that map
+        void AddTransport(Transport* transport) { m_transports.push_back(transport); }
+        void RemoveTransport(Transport* transport);
+        void UpdateTransports(uint32 diff);
 
         uint32 SpawnedCountForEntry(uint32 entry);
         void AddToSpawnCount(const ObjectGuid& guid);
@@ -333,6 +442,7 @@ class Map : public GridRefManager<NGridType>
         uint32 GetUpdateTimeMin() { return m_updateTimeMin; }
         uint32 GetUpdateTimeMax() { return m_updateTimeMax; }
         uint32 GetUpdateTimeAvg() { return uint32(m_updateTimeTotal / m_cycleCounter); }
+        uint32 GetUpdateTimeLast() const { return m_updateTimeLast; }
 
         uint32 GetCurrentMSTime() const;
         TimePoint GetCurrentClockTime() const;
@@ -344,6 +454,11 @@ class Map : public GridRefManager<NGridType>
 
     private:
         void LoadMapAndVMap(int gx, int gy);
+        // queue terrain of the grids the player reaches within the configured lookahead
+        void PrefetchTerrainAhead(Player* player);
+        void UpdatePrefetchedTerrain(uint32 diff);
+        void ReleasePrefetchedTerrain(uint32 index);
+        void UpdateGridStates(uint32 diff);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -375,7 +490,17 @@ class Map : public GridRefManager<NGridType>
         void ScriptsProcess();
 
         void SendObjectUpdates();
-        std::set<Object*> i_objectsToClientUpdate;
+        void UpdateEventSpawns();
+        void UpdateCorpses();
+        void UpdateRespawns();
+        std::vector<Object*> i_objectsToClientUpdate;
+        UpdateDataMapType i_clientUpdateDatas;              // kept between ticks to reuse the update buffers
+
+        bool CanUpdateCellsInParallel() const;
+        void UpdateCellsInParallel(uint32 t_diff);
+        void CollectActiveCells(WorldObject const* obj, std::map<uint32, CellRegion>& regions);
+        void RunCellRegionBatch(std::shared_ptr<CellRegionBatch> const& batch);
+        bool IsDeferredRelocation(Cell const& old_cell, Cell const& new_cell) const;
 
     protected:
         MapEntry const* i_mapEntry;
@@ -396,8 +521,21 @@ class Map : public GridRefManager<NGridType>
         std::map<uint32, uint32> m_tempCreatures;
         std::map<uint32, uint32> m_tempPets;
 
-        std::vector<std::function<void(Map*)>> m_messageVector;
-        std::mutex m_messageMutex;
+        // messages of other threads use the ring until it is full, then the overflow list until it is drained, to keep their order
+        LockFreeQueue<std::function<void(Map*)>, 256> m_messageQueue;
+        std::vector<std::function<void(Map*)>> m_messageVector;     // overflow, guarded by m_messageMutex
+        std::atomic<bool> m_messageOverflowing;
+
+        // expiry time -> corpse owner, entries of converted or moved corpses are skipped when due
+        typedef std::pair<time_t, ObjectGuid> CorpseExpiry;
+        std::priority_queue<CorpseExpiry, std::vector<CorpseExpiry>, std::greater<CorpseExpiry>> m_corpseExpiry;
+        // respawn time -> sleeping object, entries of objects whose respawn time changed meanwhile wake nothing
+        typedef std::pair<time_t, ObjectGuid> ScheduledRespawn;
+        std::priority_queue<ScheduledRespawn, std::vector<ScheduledRespawn>, std::greater<ScheduledRespawn>> m_respawnQueue;
+        std::mutex m_respawnQueueLock;                      // objects of parallel updated cell regions schedule themselves
+        std::deque<std::function<void(Map*)>> m_eventSpawnQueue;   // guarded by m_messageMutex
+        std::vector<Transport*> m_transports;
+        ProfiledMutex m_messageMutex;
 
         WorldObjectSet m_onEventNotifiedObjects;
         WorldObjectSet::iterator m_onEventNotifiedIter;
@@ -406,10 +544,27 @@ class Map : public GridRefManager<NGridType>
         time_t i_gridExpiry;
 
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        UnitSpatialHash m_unitSpatialHash;
+
+        struct PlayerTrigger
+        {
+            float x, y, z;
+            float radiusSq;
+            GuidSet players;
+        };
+
+        void UpdatePlayerTriggers(Player* player, bool inMap);
+        std::map<ObjectGuid, PlayerTrigger> m_playerTriggers;   // guarded by m_parallelLock while m_parallelCellUpdate
+
+        // grids by the map clock their timer passes at, entries of older timer resets stay queued until they are due
+        typedef std::pair<uint64, uint32> GridStateEntry;   // due time, grid id
+        std::priority_queue<GridStateEntry, std::vector<GridStateEntry>, std::greater<GridStateEntry>> m_gridStateQueue;
+        uint64 m_gridStateClock;
 
         // Shared geodata object with map coord info...
         TerrainInfo* const m_TerrainData;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        std::map<uint32, uint32> m_prefetchedTerrain;       // terrain grid x * MAX_NUMBER_OF_GRIDS + y, ms until the prefetch reference is dropped
 
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
 
@@ -418,6 +573,18 @@ class Map : public GridRefManager<NGridType>
         typedef std::multimap<time_t, ScriptAction> ScriptScheduleMap;
         ScriptScheduleMap m_scriptSchedule;
 
+        // scheduled steps by table and script id, termination and unique starts only look at the steps of one script
+        typedef std::pair<const char*, uint32> ScriptScheduleKey;
+        struct ScriptScheduleKeyHash
+        {
+            size_t operator()(ScriptScheduleKey const& key) const { return std::hash<const char*>()(key.first) ^ (size_t(key.second) * 0x9E3779B9); }
+        };
+        typedef std::unordered_map<ScriptScheduleKey, std::vector<ScriptScheduleMap::iterator>, ScriptScheduleKeyHash> ScriptScheduleIndex;
+        ScriptScheduleIndex m_scriptScheduleIndex;
+
+        void ScheduleScriptStep(time_t time, ScriptAction const& action);
+        void EraseScriptStep(ScriptScheduleMap::iterator itr);
+
         InstanceData* i_data;
         uint32 i_script_id;
 
@@ -444,11 +611,37 @@ class Map : public GridRefManager<NGridType>
 
         std::unordered_map<uint32, std::set<ObjectGuid>> m_spawnedCount;
 
+        // Parallel cell update
+        bool m_parallelCellUpdate;
+        std::mutex m_parallelLock;                          // guards shared containers while m_parallelCellUpdate
+        std::vector<std::function<void(Map*)>> m_deferredActions;
+
+        std::atomic<uint32> m_pathsThisTick;                // chase paths built in the current update
+        uint32 m_gridUnloadsThisTick;                       // grids unloaded in the current update
+
+        bool m_lazyCellObjects;
+
+        mutable MapQueryCache m_queryCache;                 // line of sight and height results of the current update
+        MapTickTrace m_tickTrace;                           // phases and object costs of the current update, for the slow tick dump
+
+        std::atomic<uint64> m_heartbeatsSent;
+        std::atomic<uint64> m_heartbeatsSuppressed;
+
+        // AI update budget of the active cells
+        bool m_updateBudgetSet;
+        std::chrono::steady_clock::time_point m_updateBudgetEnd;
+        std::atomic<uint32> m_deferredUpdatesThisTick;
+        uint32 m_deferredUpdatesLastTick;
+        std::atomic<uint64> m_deferredUpdatesTotal;
+
         // Map update performance logging
         std::atomic<uint32> m_cycleCounter;
         std::atomic<uint32> m_updateTimeMin;
         std::atomic<uint32> m_updateTimeMax;
         std::atomic<uint64> m_updateTimeTotal;
+        std::atomic<uint32> m_updateTimeLast;
+
+        uint32 m_pendingUpdateDiff;                         // tick time collected since the last update
 };
 
 class WorldMap : public Map
@@ -530,6 +723,8 @@ Map::Visit(const Cell& cell, TypeContainerVisitor<T, CONTAINER>& visitor)
     if (!cell.NoCreate() || loaded(GridPair(x, y)))
     {
         EnsureGridLoaded(cell);
+        if (!cell.NoCreate())
+            EnsureCellObjectsLoaded(cell);
         getNGrid(x, y)->Visit(cell_x, cell_y, visitor);
     }
 }
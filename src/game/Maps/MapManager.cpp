@@ -27,6 +27,8 @@
 #include "Grids/CellImpl.h"
 #include "Globals/ObjectMgr.h"
 #include "Maps/MapWorkers.h"
+#include "Maps/MapTickProfiler.h"
+#include "Metrics/Metrics.h"
 #include <future>
 
 #define CLASS_LOCK MaNGOS::ClassLevelLockable<MapManager, std::recursive_mutex>
@@ -113,14 +115,19 @@ void MapManager::CreateContinents()
 /// @param id - MapId of the to be created map. @param obj WorldObject for which the map is to be created. Must be player for Instancable maps.
 Map* MapManager::CreateMap(uint32 id, const WorldObject* obj)
 {
-    Guard _guard(*this);
-
-    Map* m = nullptr;
-
     const MapEntry* entry = sMapStore.LookupEntry(id);
     if (!entry)
         return nullptr;
 
+    // bound instance can be still unloading from the last visit, wait outside of the registry lock
+    if (entry->Instanceable() && !entry->IsBattleGroundOrArena() && obj && obj->GetTypeId() == TYPEID_PLAYER)
+        if (DungeonPersistentState* pSave = ((Player*)obj)->GetBoundInstanceSaveForSelfOrGroup(id))
+            WaitForReclaim(MapID(id, pSave->GetInstanceId()));
+
+    Guard _guard(*this);
+
+    Map* m = nullptr;
+
     if (entry->Instanceable())
     {
         MANGOS_ASSERT(obj && obj->GetTypeId() == TYPEID_PLAYER);
@@ -174,6 +181,8 @@ Map* MapManager::FindMap(uint32 mapid, uint32 instanceId) const
 
 void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
 {
+    WaitForReclaim(MapID(mapid, instanceId));
+
     Guard _guard(*this);
 
     MapMapType::iterator iter = i_maps.find(MapID(mapid, instanceId));
@@ -196,21 +205,55 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
+    // start expensive continents first so small instances fill the gaps at the end of the tick
+    // idle maps only join the tick once their idle interval passed, maps with transports or messages are never idle
+    uint32 const idleInterval = sWorld.getConfig(CONFIG_UINT32_MAP_IDLE_UPDATE_INTERVAL);
+
+    m_updateOrder.clear();
     for (auto& map : i_maps)
+        if (map.second->AddPendingUpdateDiff((uint32)i_timer.GetCurrent(), idleInterval))
+            m_updateOrder.push_back(map.second);
+
+    std::stable_sort(m_updateOrder.begin(), m_updateOrder.end(), [](Map const* a, Map const* b)
+    {
+        return a->GetUpdateTimeLast() > b->GetUpdateTimeLast();
+    });
+
+    while (m_updateWorkers.size() < m_updateOrder.size())
+        m_updateWorkers.push_back(std::unique_ptr<MapUpdateWorker>(new MapUpdateWorker(m_updater)));
+
+    for (size_t i = 0; i < m_updateOrder.size(); ++i)
+        m_updateWorkers[i]->Reset(*m_updateOrder[i], m_updateOrder[i]->TakePendingUpdateDiff());
+
     {
+        MapTickProfiler::Scope profile(MAP_TICK_MAP_UPDATER, MAP_TICK_ALL_MAPS);
+
         if (m_updater.activated())
-            m_updater.schedule_update(new MapUpdateWorker(*map.second, (uint32)i_timer.GetCurrent(), m_updater));
+        {
+            for (size_t i = 0; i < m_updateOrder.size(); ++i)
+                m_updater.schedule_update(m_updateWorkers[i].get());
+
+            m_updater.wait();
+        }
         else
-            map.second->Update((uint32)i_timer.GetCurrent());
+        {
+            for (size_t i = 0; i < m_updateOrder.size(); ++i)
+                m_updateWorkers[i]->UpdateMap();
+        }
+    }
+    if (Metrics::IsEnabled())
+    {
+        static Metrics::Gauge& maps = Metrics::GetGauge("mangos_maps", "Loaded maps including instances");
+        static Metrics::Gauge& updatedMaps = Metrics::GetGauge("mangos_maps_updated", "Maps updated in the last map tick");
+        static Metrics::Histogram& mapUpdate = Metrics::GetHistogram("mangos_map_update_duration_ms", "Update time of each map per map tick", Metrics::DurationBoundsMs());
+
+        maps.Set(int64(i_maps.size()));
+        updatedMaps.Set(int64(m_updateOrder.size()));
+        for (Map const* map : m_updateOrder)
+            mapUpdate.Observe(map->GetUpdateTimeLast());
     }
 
-    if (m_updater.activated())
-        m_updater.wait();
-
-    for (Transport* m_Transport : m_Transports)
-        m_Transport->Update((uint32)i_timer.GetCurrent());
-
-    // remove all maps which can be unloaded
+    // remove all maps which can be unloaded, the unloading itself runs in the reclaim stage
     MapMapType::iterator iter = i_maps.begin();
     while (iter != i_maps.end())
     {
@@ -218,10 +261,21 @@ void MapManager::Update(uint32 diff)
         // check if map can be unloaded
         if (pMap->CanUnload((uint32)i_timer.GetCurrent()))
         {
-            pMap->UnloadAll(true);
-            delete pMap;
-
             i_maps.erase(iter++);
+
+            if (m_updater.activated())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_reclaimLock);
+                    m_reclaimingMaps.insert(MapID(pMap->GetId(), pMap->GetInstanceId()));
+                }
+                m_updater.schedule_update(new MapReclaimWorker(pMap, m_updater));
+            }
+            else
+            {
+                pMap->UnloadAll(true);
+                delete pMap;
+            }
         }
         else
             ++iter;
@@ -230,6 +284,25 @@ void MapManager::Update(uint32 diff)
     i_timer.SetCurrent(0);
 }
 
+void MapManager::ReclaimMap(Map* map)
+{
+    MapID id(map->GetId(), map->GetInstanceId());
+
+    map->UnloadAll(true);
+    delete map;
+
+    std::lock_guard<std::mutex> lock(m_reclaimLock);
+    m_reclaimingMaps.erase(id);
+    m_reclaimCondition.notify_all();
+}
+
+void MapManager::WaitForReclaim(MapID const& id)
+{
+    std::unique_lock<std::mutex> lock(m_reclaimLock);
+    while (m_reclaimingMaps.find(id) != m_reclaimingMaps.end())
+        m_reclaimCondition.wait(lock);
+}
+
 void MapManager::RemoveAllObjectsInRemoveList()
 {
     for (auto& i_map : i_maps)
@@ -255,6 +328,10 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    // finish reclaim stage of maps unloaded in the last tick
+    if (m_updater.activated())
+        m_updater.wait();
+
     for (auto& i_map : i_maps)
         i_map.second->UnloadAll(true);
 
@@ -29,6 +29,7 @@
 
 class Transport;
 class BattleGround;
+class MapUpdateWorker;
 
 struct MapID
 {
@@ -159,6 +160,12 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         void DoForAllMaps(const std::function<void(Map*)>& worker);
         void DoForAllMapsWithMapId(uint32 mapId, std::function<void(Map*)> worker);
 
+        // worker pool shared by map updates and parallel cell updates of a single map
+        MapUpdater& GetMapUpdater() { return m_updater; }
+
+        // unload and delete map already removed from the registry, called from the reclaim stage
+        void ReclaimMap(Map* map);
+
     private:
 
         // debugging code, should be deleted some day
@@ -187,6 +194,18 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         uint32 i_MaxInstanceId;
         MapUpdater m_updater;
+
+        // block until a map with the same id left the reclaim stage
+        void WaitForReclaim(MapID const& id);
+
+        // reused every tick, maps sorted by last update time, most expensive first
+        std::vector<Map*> m_updateOrder;
+        std::vector<std::unique_ptr<MapUpdateWorker>> m_updateWorkers;
+
+        // maps removed from i_maps but still unloading on a MapUpdater thread
+        std::set<MapID> m_reclaimingMaps;
+        std::mutex m_reclaimLock;
+        std::condition_variable m_reclaimCondition;
 };
 
 template<typename Do>
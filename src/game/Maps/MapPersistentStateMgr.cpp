@@ -46,7 +46,7 @@ static uint32 resetEventTypeDelay[MAX_RESET_EVENT_TYPE] = { 0,
 //== MapPersistentState functions ==========================
 MapPersistentState::MapPersistentState(uint16 MapId, uint32 InstanceId, Difficulty difficulty)
     : m_instanceid(InstanceId), m_mapid(MapId),
-      m_difficulty(difficulty), m_usedByMap(nullptr)
+      m_difficulty(difficulty), m_usedByMap(nullptr), m_respawnFlushTimer(0)
 {
 }
 
@@ -70,6 +70,23 @@ bool MapPersistentState::UnloadIfEmpty()
     return true;
 }
 
+void MapPersistentState::SetUsedByMapState(Map* map)
+{
+    m_usedByMap = map;
+    if (!map)
+    {
+        // the buffered times may be dropped at shutdown, the spawns are then ready again after the restart
+        FlushRespawnTimes(!World::IsStopped() || sWorld.getConfig(CONFIG_BOOL_SAVE_RESPAWN_TIME_FLUSH_ON_SHUTDOWN));
+        UnloadIfEmpty();
+    }
+}
+
+// a state without map is changed outside of map updates, nothing would flush it
+bool MapPersistentState::DelayRespawnTimeSave() const
+{
+    return m_usedByMap && sWorld.getConfig(CONFIG_UINT32_SAVE_RESPAWN_TIME_FLUSH_INTERVAL);
+}
+
 void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
 {
     SetCreatureRespawnTime(loguid, t);
@@ -78,6 +95,12 @@ void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
     if (GetMapEntry()->IsBattleGroundOrArena())
         return;
 
+    if (DelayRespawnTimeSave())
+    {
+        m_pendingCreatureRespawns.insert(loguid);
+        return;
+    }
+
     CharacterDatabase.BeginTransaction();
 
     static SqlStatementID delSpawnTime ;
@@ -103,6 +126,12 @@ void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
     if (GetMapEntry()->IsBattleGroundOrArena())
         return;
 
+    if (DelayRespawnTimeSave())
+    {
+        m_pendingGORespawns.insert(loguid);
+        return;
+    }
+
     CharacterDatabase.BeginTransaction();
 
     static SqlStatementID delSpawnTime ;
@@ -120,6 +149,71 @@ void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
     CharacterDatabase.CommitTransaction();
 }
 
+void MapPersistentState::UpdateRespawnTimes(uint32 diff)
+{
+    if (m_pendingCreatureRespawns.empty() && m_pendingGORespawns.empty())
+        return;
+
+    m_respawnFlushTimer += diff;
+    if (m_respawnFlushTimer < sWorld.getConfig(CONFIG_UINT32_SAVE_RESPAWN_TIME_FLUSH_INTERVAL) * IN_MILLISECONDS)
+        return;
+
+    FlushRespawnTimes();
+}
+
+void MapPersistentState::FlushRespawnTimes(bool write /*= true*/)
+{
+    m_respawnFlushTimer = 0;
+
+    if (!write)
+    {
+        m_pendingCreatureRespawns.clear();
+        m_pendingGORespawns.clear();
+        return;
+    }
+
+    FlushRespawnTimes("creature_respawn", m_pendingCreatureRespawns, m_creatureRespawnTimes);
+    FlushRespawnTimes("gameobject_respawn", m_pendingGORespawns, m_goRespawnTimes);
+}
+
+void MapPersistentState::FlushRespawnTimes(char const* table, std::unordered_set<uint32>& guids, RespawnTimes const& times)
+{
+    // both statements of a chunk stay below MAX_QUERY_LEN
+    uint32 const FLUSH_CHUNK_SIZE = 500;
+
+    time_t const now = sWorld.GetGameTime();
+
+    // a spawn changed several times since the last flush is written once with its last time
+    auto itr = guids.begin();
+    while (itr != guids.end())
+    {
+        std::ostringstream deleted;
+        std::ostringstream rows;
+        for (uint32 count = 0; itr != guids.end() && count < FLUSH_CHUNK_SIZE; ++itr, ++count)
+        {
+            if (count)
+                deleted << ",";
+            deleted << *itr;
+
+            auto timeItr = times.find(*itr);
+            if (timeItr == times.end() || timeItr->second <= now)
+                continue;
+
+            if (rows.tellp() > 0)
+                rows << ",";
+            rows << "(" << *itr << "," << uint64(timeItr->second) << "," << m_instanceid << ")";
+        }
+
+        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.PExecute("DELETE FROM %s WHERE instance = '%u' AND guid IN (%s)", table, m_instanceid, deleted.str().c_str());
+        if (rows.tellp() > 0)
+            CharacterDatabase.PExecute("INSERT INTO %s VALUES %s", table, rows.str().c_str());
+        CharacterDatabase.CommitTransaction();
+    }
+
+    guids.clear();
+}
+
 void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
 {
     if (t > sWorld.GetGameTime())
@@ -146,6 +240,8 @@ void MapPersistentState::ClearRespawnTimes()
 {
     m_goRespawnTimes.clear();
     m_creatureRespawnTimes.clear();
+    m_pendingGORespawns.clear();
+    m_pendingCreatureRespawns.clear();
 
     UnloadIfEmpty();
 }
@@ -269,7 +365,7 @@ void DungeonPersistentState::DeleteRespawnTimes()
 
 void DungeonPersistentState::DeleteFromDB() const
 {
-    MapPersistentStateManager::DeleteInstanceFromDB(GetInstanceId());
+    sMapPersistentStateMgr.DeleteInstanceFromDB(GetInstanceId());
 }
 
 // to cache or not to cache, that is the question
@@ -666,7 +762,10 @@ MapPersistentState* MapPersistentStateManager::AddPersistentState(MapEntry const
 
 
     if (instanceId)
+    {
         m_instanceSaveByInstanceId[instanceId] = state;
+        m_instanceIdsByMapId[mapEntry->MapID].insert(instanceId);
+    }
     else
         m_instanceSaveByMapId[mapEntry->MapID] = state;
 
@@ -684,18 +783,50 @@ MapPersistentState* MapPersistentStateManager::GetPersistentState(uint32 mapId,
     return itr != m_instanceSaveByMapId.end() ? itr->second : nullptr;
 }
 
+// instances whose rows are deleted with one statement per table
+#define INSTANCE_DELETE_BATCH_SIZE 256
+
 void MapPersistentStateManager::DeleteInstanceFromDB(uint32 instanceid)
 {
     if (instanceid)
-    {
-        CharacterDatabase.BeginTransaction();
-        CharacterDatabase.PExecute("DELETE FROM instance WHERE id = '%u'", instanceid);
-        CharacterDatabase.PExecute("DELETE FROM character_instance WHERE instance = '%u'", instanceid);
-        CharacterDatabase.PExecute("DELETE FROM group_instance WHERE instance = '%u'", instanceid);
-        CharacterDatabase.PExecute("DELETE FROM creature_respawn WHERE instance = '%u'", instanceid);
-        CharacterDatabase.PExecute("DELETE FROM gameobject_respawn WHERE instance = '%u'", instanceid);
-        CharacterDatabase.CommitTransaction();
-    }
+        m_instancesToDelete.push_back(instanceid);
+}
+
+void MapPersistentStateManager::DeleteQueuedInstancesFromDB()
+{
+    while (!m_instancesToDelete.empty())
+        _DeleteInstanceBatchFromDB();
+}
+
+void MapPersistentStateManager::Update()
+{
+    m_Scheduler.Update();
+
+    // a global reset queues every instance of the map, one batch a tick keeps the database queue short
+    if (!m_instancesToDelete.empty())
+        _DeleteInstanceBatchFromDB();
+}
+
+void MapPersistentStateManager::_DeleteInstanceBatchFromDB()
+{
+    size_t count = std::min(m_instancesToDelete.size(), size_t(INSTANCE_DELETE_BATCH_SIZE));
+    std::vector<uint32>::iterator batchEnd = m_instancesToDelete.begin() + count;
+
+    std::ostringstream ids;
+    for (std::vector<uint32>::const_iterator itr = m_instancesToDelete.begin(); itr != batchEnd; ++itr)
+        ids << (itr != m_instancesToDelete.begin() ? "," : "") << *itr;
+
+    m_instancesToDelete.erase(m_instancesToDelete.begin(), batchEnd);
+
+    std::string const idList = ids.str();
+
+    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.PExecute("DELETE FROM instance WHERE id IN (%s)", idList.c_str());
+    CharacterDatabase.PExecute("DELETE FROM character_instance WHERE instance IN (%s)", idList.c_str());
+    CharacterDatabase.PExecute("DELETE FROM group_instance WHERE instance IN (%s)", idList.c_str());
+    CharacterDatabase.PExecute("DELETE FROM creature_respawn WHERE instance IN (%s)", idList.c_str());
+    CharacterDatabase.PExecute("DELETE FROM gameobject_respawn WHERE instance IN (%s)", idList.c_str());
+    CharacterDatabase.CommitTransaction();
 }
 
 void MapPersistentStateManager::RemovePersistentState(uint32 mapId, uint32 instanceId)
@@ -738,20 +869,33 @@ void MapPersistentStateManager::_DelHelper(DatabaseType& db, const char* fields,
     QueryResult* result = db.PQuery("SELECT %s FROM %s %s", fields, table, szQueryTail);
     if (result)
     {
+        // rows are deleted INSTANCE_DELETE_BATCH_SIZE at a time, matched by all the selected fields
+        std::ostringstream ss;
+        uint32 count = 0;
         do
         {
             Field* resultFields = result->Fetch();
-            std::ostringstream ss;
+            ss << (count != 0 ? " OR (" : "(");
             for (size_t i = 0; i < fieldTokens.size(); ++i)
             {
                 std::string fieldValue = resultFields[i].GetCppString();
                 db.escape_string(fieldValue);
                 ss << (i != 0 ? " AND " : "") << fieldTokens[i] << " = '" << fieldValue << "'";
             }
-            db.PExecute("DELETE FROM %s WHERE %s", table, ss.str().c_str());
+            ss << ")";
+
+            if (++count == INSTANCE_DELETE_BATCH_SIZE)
+            {
+                db.PExecute("DELETE FROM %s WHERE %s", table, ss.str().c_str());
+                ss.str("");
+                count = 0;
+            }
         }
         while (result->NextRow());
         delete result;
+
+        if (count)
+            db.PExecute("DELETE FROM %s WHERE %s", table, ss.str().c_str());
     }
 }
 
@@ -762,6 +906,7 @@ void MapPersistentStateManager::CleanupInstances()
 
     // load reset times and clean expired instances
     m_Scheduler.LoadResetTimes();
+    DeleteQueuedInstancesFromDB();
 
     CharacterDatabase.BeginTransaction();
     // clean character/group - instance binds with invalid group/characters
@@ -844,6 +989,16 @@ void MapPersistentStateManager::_ResetSave(PersistentStateMap& holder, Persisten
     // unbind all players bound to the instance
     // do not allow UnbindInstance to automatically unload the InstanceSaves
     lock_instLists = true;
+    if (uint32 instanceId = itr->second->GetInstanceId())
+    {
+        InstanceIdsByMapId::iterator ids = m_instanceIdsByMapId.find(itr->second->GetMapId());
+        if (ids != m_instanceIdsByMapId.end())
+        {
+            ids->second.erase(instanceId);
+            if (ids->second.empty())
+                m_instanceIdsByMapId.erase(ids);
+        }
+    }
     delete itr->second;
     holder.erase(itr++);
     lock_instLists = false;
@@ -919,9 +1074,10 @@ void MapPersistentStateManager::_ResetOrWarnAll(uint32 mapid, bool warn, uint32
 
         // note that we must build a list of states to unbind and then unbind them in two steps.  this is because the unbinding may
         // trigger the modification of the collection, which would invalidate the iterator and cause a crash.
-        for (auto& itr : m_instanceSaveByInstanceId)
-            if (itr.second->GetMapId() == mapid)
-                unbindList.push_back((DungeonPersistentState*)itr.second);
+        InstanceIdsByMapId::const_iterator ids = m_instanceIdsByMapId.find(mapid);
+        if (ids != m_instanceIdsByMapId.end())
+            for (uint32 instanceId : ids->second)
+                unbindList.push_back((DungeonPersistentState*)m_instanceSaveByInstanceId[instanceId]);
 
         for (auto itr : unbindList)
             itr->UnbindThisState();
@@ -932,6 +1088,8 @@ void MapPersistentStateManager::_ResetOrWarnAll(uint32 mapid, bool warn, uint32
 
         // delete them from the DB, even if not loaded
         CharacterDatabase.BeginTransaction();
+        CharacterDatabase.PExecute("DELETE FROM creature_respawn USING creature_respawn JOIN instance ON creature_respawn.instance = id WHERE map = '%u'", mapid);
+        CharacterDatabase.PExecute("DELETE FROM gameobject_respawn USING gameobject_respawn JOIN instance ON gameobject_respawn.instance = id WHERE map = '%u'", mapid);
         CharacterDatabase.PExecute("DELETE FROM character_instance USING character_instance LEFT JOIN instance ON character_instance.instance = id WHERE map = '%u'", mapid);
         CharacterDatabase.PExecute("DELETE FROM group_instance USING group_instance LEFT JOIN instance ON group_instance.instance = id WHERE map = '%u'", mapid);
         CharacterDatabase.PExecute("DELETE FROM instance WHERE map = '%u'", mapid);
@@ -30,6 +30,8 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <unordered_set>
+#include <vector>
 
 struct InstanceTemplate;
 struct MapEntry;
@@ -80,12 +82,7 @@ class MapPersistentState
 
         bool IsUsedByMap() const { return m_usedByMap != nullptr; }
         Map* GetMap() const { return m_usedByMap; }         // Can be nullptr if map not loaded for persistent state
-        void SetUsedByMapState(Map* map)
-        {
-            m_usedByMap = map;
-            if (!map)
-                UnloadIfEmpty();
-        }
+        void SetUsedByMapState(Map* map);
 
         time_t GetCreatureRespawnTime(uint32 loguid) const
         {
@@ -100,6 +97,10 @@ class MapPersistentState
         }
         void SaveGORespawnTime(uint32 loguid, time_t t);
 
+        // respawn times saved while a map uses the state are written in batches from its update
+        void UpdateRespawnTimes(uint32 diff);
+        void FlushRespawnTimes(bool write = true);
+
         // pool system
         void InitPools();
         SpawnedPoolData& GetSpawnedPoolData() { return m_spawnedPoolData; };
@@ -121,12 +122,15 @@ class MapPersistentState
         bool HasRespawnTimes() const { return !m_creatureRespawnTimes.empty() || !m_goRespawnTimes.empty(); }
 
     private:
+        typedef std::unordered_map<uint32, time_t> RespawnTimes;
+
         void SetCreatureRespawnTime(uint32 loguid, time_t t);
         void SetGORespawnTime(uint32 loguid, time_t t);
 
-    private:
-        typedef std::unordered_map<uint32, time_t> RespawnTimes;
+        bool DelayRespawnTimeSave() const;
+        void FlushRespawnTimes(char const* table, std::unordered_set<uint32>& guids, RespawnTimes const& times);
 
+    private:
         uint32 m_instanceid;
         uint32 m_mapid;
         Difficulty m_difficulty;
@@ -135,6 +139,9 @@ class MapPersistentState
         // persistent data
         RespawnTimes m_creatureRespawnTimes;                // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
         RespawnTimes m_goRespawnTimes;                      // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
+        std::unordered_set<uint32> m_pendingCreatureRespawns;   // changed since the last flush, written from m_creatureRespawnTimes
+        std::unordered_set<uint32> m_pendingGORespawns;
+        uint32 m_respawnFlushTimer;
         MapCellObjectGuidsMap m_gridObjectGuids;            // Single map copy specific grid spawn data, like pool spawns
 
         SpawnedPoolData m_spawnedPoolData;                  // Pools spawns state for map copy
@@ -349,13 +356,16 @@ class MapPersistentStateManager : public MaNGOS::Singleton<MapPersistentStateMan
 
         DungeonResetScheduler& GetScheduler() { return m_Scheduler; }
 
-        static void DeleteInstanceFromDB(uint32 instanceid);
+        // the rows are deleted in batches by Update, instance ids are never reused so a delay is harmless
+        void DeleteInstanceFromDB(uint32 instanceid);
+        void DeleteQueuedInstancesFromDB();                 // all at once, at startup and shutdown
 
         void GetStatistics(uint32& numStates, uint32& numBoundPlayers, uint32& numBoundGroups);
 
-        void Update() { m_Scheduler.Update(); }
+        void Update();
     private:
         typedef std::unordered_map < uint32 /*InstanceId or MapId*/, MapPersistentState* > PersistentStateMap;
+        typedef std::unordered_map < uint32 /*MapId*/, std::unordered_set<uint32> /*InstanceIds*/ > InstanceIdsByMapId;
 
         //  called by scheduler for DungeonPersistentStates
         void _ResetOrWarnAll(uint32 mapid, bool warn, uint32 timeLeft);
@@ -363,6 +373,7 @@ class MapPersistentStateManager : public MaNGOS::Singleton<MapPersistentStateMan
         void _CleanupExpiredInstancesAtTime(time_t t);
 
         void _ResetSave(PersistentStateMap& holder, PersistentStateMap::iterator& itr);
+        void _DeleteInstanceBatchFromDB();
         void _DelHelper(DatabaseType& db, const char* fields, const char* table, const char* queryTail, ...) const;
 
         // used during global instance resets
@@ -371,6 +382,10 @@ class MapPersistentStateManager : public MaNGOS::Singleton<MapPersistentStateMan
         PersistentStateMap m_instanceSaveByInstanceId;
         // fast lookup by map id for non-instanceable maps
         PersistentStateMap m_instanceSaveByMapId;
+        // instance ids of m_instanceSaveByInstanceId by map, map wide resets and workers visit only their own map
+        InstanceIdsByMapId m_instanceIdsByMapId;
+
+        std::vector<uint32> m_instancesToDelete;
 
         DungeonResetScheduler m_Scheduler;
 };
@@ -384,12 +399,15 @@ inline void MapPersistentStateManager::DoForAllStatesWithMapId(uint32 mapId, Do&
 
     if (mapEntry->Instanceable())
     {
-        for (PersistentStateMap::iterator itr = m_instanceSaveByInstanceId.begin(); itr != m_instanceSaveByInstanceId.end();)
+        InstanceIdsByMapId::iterator ids = m_instanceIdsByMapId.find(mapId);
+        if (ids == m_instanceIdsByMapId.end())
+            return;
+
+        for (std::unordered_set<uint32>::iterator itr = ids->second.begin(); itr != ids->second.end();)
         {
-            if (itr->second->GetMapId() == mapId)
-                _do((itr++)->second);
-            else
-                ++itr;
+            PersistentStateMap::iterator state = m_instanceSaveByInstanceId.find(*(itr++));
+            if (state != m_instanceSaveByInstanceId.end())
+                _do(state->second);
         }
     }
     else
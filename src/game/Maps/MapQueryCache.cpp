@@ -0,0 +1,96 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/MapQueryCache.h"
+
+#include <cmath>
+
+bool MapQueryCache::Key::operator==(Key const& other) const
+{
+    for (int i = 0; i < 6; ++i)
+        if (coords[i] != other.coords[i])
+            return false;
+    return flag == other.flag;
+}
+
+size_t MapQueryCache::KeyHash::operator()(Key const& key) const
+{
+    size_t hash = key.flag ? 1 : 0;
+    for (int i = 0; i < 6; ++i)
+        hash = hash * 31 + std::hash<int32>()(key.coords[i]);
+    return hash;
+}
+
+MapQueryCache::Key MapQueryCache::MakeKey(float x1, float y1, float z1, float x2, float y2, float z2, bool flag)
+{
+    Key key;
+    float const coords[6] = { x1, y1, z1, x2, y2, z2 };
+    for (int i = 0; i < 6; ++i)
+        key.coords[i] = int32(std::floor(coords[i] * MAP_QUERY_CACHE_PRECISION));
+    key.flag = flag;
+    return key;
+}
+
+void MapQueryCache::Clear()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_lineOfSight.clear();
+    m_heights.clear();
+}
+
+bool MapQueryCache::GetLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model, bool& result)
+{
+    ++m_losLookups;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_lineOfSight.find(MakeKey(x1, y1, z1, x2, y2, z2, ignoreM2Model));
+    if (itr == m_lineOfSight.end())
+        return false;
+
+    ++m_losHits;
+    result = itr->second;
+    return true;
+}
+
+void MapQueryCache::AddLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model, bool result)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_lineOfSight.size() < MAP_QUERY_CACHE_MAX_ENTRIES)
+        m_lineOfSight[MakeKey(x1, y1, z1, x2, y2, z2, ignoreM2Model)] = result;
+}
+
+bool MapQueryCache::GetHeight(float x, float y, float z, float& result)
+{
+    ++m_heightLookups;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_heights.find(MakeKey(x, y, z, 0.0f, 0.0f, 0.0f, false));
+    if (itr == m_heights.end())
+        return false;
+
+    ++m_heightHits;
+    result = itr->second;
+    return true;
+}
+
+void MapQueryCache::AddHeight(float x, float y, float z, float result)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_heights.size() < MAP_QUERY_CACHE_MAX_ENTRIES)
+        m_heights[MakeKey(x, y, z, 0.0f, 0.0f, 0.0f, false)] = result;
+}
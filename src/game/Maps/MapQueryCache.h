@@ -0,0 +1,82 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPQUERYCACHE_H
+#define MANGOS_MAPQUERYCACHE_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#define MAP_QUERY_CACHE_PRECISION   10.0f                   // coordinates are quantized to 0.1 yard
+#define MAP_QUERY_CACHE_MAX_ENTRIES 8192                    // per query kind and update, later queries are not stored
+
+/**
+ * Results of line of sight and height queries of one map during one update, by quantized coordinates.
+ * Many casters targeting one boss or many mobs checking one tank repeat the same vmap queries within an update.
+ *
+ * The cache is cleared at the start of each map update and whenever the dynamic tree of the map changes,
+ * so it only has to stay valid while the static terrain and the game object models are unchanged.
+ */
+class MapQueryCache
+{
+    public:
+        MapQueryCache() : m_losHits(0), m_losLookups(0), m_heightHits(0), m_heightLookups(0) {}
+
+        void Clear();
+
+        bool GetLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model, bool& result);
+        void AddLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model, bool result);
+
+        bool GetHeight(float x, float y, float z, float& result);
+        void AddHeight(float x, float y, float z, float result);
+
+        uint64 GetLineOfSightHits() const { return m_losHits; }
+        uint64 GetLineOfSightLookups() const { return m_losLookups; }
+        uint64 GetHeightHits() const { return m_heightHits; }
+        uint64 GetHeightLookups() const { return m_heightLookups; }
+
+    private:
+        struct Key
+        {
+            int32 coords[6];
+            bool flag;
+
+            bool operator==(Key const& other) const;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(Key const& key) const;
+        };
+
+        static Key MakeKey(float x1, float y1, float z1, float x2, float y2, float z2, bool flag);
+
+        std::mutex m_lock;
+        std::unordered_map<Key, bool, KeyHash> m_lineOfSight;
+        std::unordered_map<Key, float, KeyHash> m_heights;
+
+        std::atomic<uint64> m_losHits;
+        std::atomic<uint64> m_losLookups;
+        std::atomic<uint64> m_heightHits;
+        std::atomic<uint64> m_heightLookups;
+};
+
+#endif
@@ -0,0 +1,236 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/MapTickProfiler.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+std::atomic<bool> MapTickProfiler::m_enabled(false);
+std::atomic<uint32> MapTickProfiler::m_slowTickThreshold(0);
+
+namespace
+{
+    // four buckets per power of two, fine enough to tell a 40ms tick from a 50ms one
+    uint32 const MAX_TICK_BUCKET = 112;
+
+    struct TickEntry
+    {
+        TickEntry() : count(0), totalUs(0), maxUs(0), buckets() {}
+
+        uint64 count;
+        uint64 totalUs;
+        uint64 maxUs;
+        uint64 buckets[MAX_TICK_BUCKET];
+    };
+
+    // a few records per map and tick, a single table is enough
+    std::mutex profileLock;
+    std::unordered_map<uint64, TickEntry> entries;          // by phase and map id
+
+    uint64 MakeKey(MapTickPhase phase, uint32 mapId) { return (uint64(phase) << 32) | mapId; }
+
+    uint32 GetBucket(uint64 us)
+    {
+        if (us < 4)
+            return uint32(us);
+
+        uint32 highBit = 0;
+        while (us >> (highBit + 1))
+            ++highBit;
+
+        uint32 const bucket = (highBit - 1) * 4 + uint32((us >> (highBit - 2)) & 3);
+        return std::min(bucket, MAX_TICK_BUCKET - 1);
+    }
+
+    uint64 GetBucketUpperBound(uint32 bucket)
+    {
+        if (bucket < 4)
+            return bucket + 1;
+
+        uint32 const shift = bucket / 4 - 1;
+        return (uint64(4 + bucket % 4) << shift) + (uint64(1) << shift);
+    }
+
+    uint64 GetPercentile(TickEntry const& entry, uint32 percent)
+    {
+        uint64 const rank = (entry.count * percent + 99) / 100;
+        uint64 seen = 0;
+        for (uint32 i = 0; i < MAX_TICK_BUCKET; ++i)
+        {
+            seen += entry.buckets[i];
+            if (seen >= rank)
+                return std::min(GetBucketUpperBound(i), entry.maxUs);
+        }
+        return entry.maxUs;
+    }
+
+    char const* const phaseNames[MAX_MAP_TICK_PHASE] =
+    {
+        "MapUpdater", "Map::Update", "sessions", "players", "cells", "objects",
+        "SendObjectUpdates", "grid states", "scripts", "instance data", "weather"
+    };
+
+    MapTickProfiler::Summary MakeSummary(uint64 key, TickEntry const& entry)
+    {
+        return { MapTickPhase(key >> 32), uint32(key & 0xFFFFFFFF), entry.count, entry.totalUs, entry.maxUs,
+                 GetPercentile(entry, 50), GetPercentile(entry, 95), GetPercentile(entry, 99) };
+    }
+}
+
+void MapTickTrace::Start()
+{
+    m_active = MapTickProfiler::IsEnabled() && MapTickProfiler::GetSlowTickThreshold();
+    if (!m_active)
+        return;
+
+    m_start = std::chrono::steady_clock::now();
+    for (uint64& us : m_phaseUs)
+        us = 0;
+    m_objects.clear();
+}
+
+void MapTickTrace::AddObject(ObjectGuid const& guid, uint64 us)
+{
+    std::lock_guard<std::mutex> guard(m_objectsLock);
+
+    if (m_objects.size() == MAP_TICK_TRACE_OBJECTS)
+    {
+        if (us <= m_objects.back().first)
+            return;
+        m_objects.pop_back();
+    }
+
+    auto itr = m_objects.begin();
+    while (itr != m_objects.end() && itr->first >= us)
+        ++itr;
+    m_objects.insert(itr, std::make_pair(us, guid));
+}
+
+void MapTickTrace::Finish(uint32 mapId, uint32 instanceId)
+{
+    if (!m_active)
+        return;
+
+    m_active = false;
+
+    uint64 const tickUs = uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+    if (tickUs < uint64(MapTickProfiler::GetSlowTickThreshold()) * 1000)
+        return;
+
+    std::string phases;
+    for (uint32 i = MAP_TICK_SESSIONS; i < MAX_MAP_TICK_PHASE; ++i)
+    {
+        if (!phases.empty())
+            phases += ", ";
+        phases += phaseNames[i];
+        phases += ' ';
+        phases += std::to_string(m_phaseUs[i] / 1000);
+    }
+
+    sLog.outString("Slow tick of map %u (instance %u): " UI64FMTD " ms, phases in ms: %s", mapId, instanceId, tickUs / 1000, phases.c_str());
+    for (auto const& object : m_objects)
+        sLog.outString("    " UI64FMTD " us: %s", object.first, object.second.GetString().c_str());
+}
+
+void MapTickProfiler::Record(MapTickPhase phase, uint32 mapId, uint64 us)
+{
+    std::lock_guard<std::mutex> guard(profileLock);
+
+    TickEntry& entry = entries[MakeKey(phase, mapId)];
+    ++entry.count;
+    entry.totalUs += us;
+    entry.maxUs = std::max(entry.maxUs, us);
+    ++entry.buckets[GetBucket(us)];
+}
+
+void MapTickProfiler::Reset()
+{
+    std::lock_guard<std::mutex> guard(profileLock);
+    entries.clear();
+}
+
+std::vector<MapTickProfiler::Summary> MapTickProfiler::GetEntries(size_t countPerPhase)
+{
+    std::vector<Summary> summaries;
+    {
+        std::lock_guard<std::mutex> guard(profileLock);
+        summaries.reserve(entries.size());
+        for (auto const& itr : entries)
+            summaries.push_back(MakeSummary(itr.first, itr.second));
+    }
+
+    std::sort(summaries.begin(), summaries.end(), [](Summary const& a, Summary const& b)
+    {
+        if (a.phase != b.phase)
+            return a.phase < b.phase;
+        return a.totalUs > b.totalUs;
+    });
+
+    std::vector<Summary> result;
+    size_t inPhase = 0;
+    for (size_t i = 0; i < summaries.size(); ++i)
+    {
+        inPhase = (i && summaries[i].phase == summaries[i - 1].phase) ? inPhase + 1 : 0;
+        if (inPhase < countPerPhase)
+            result.push_back(summaries[i]);
+    }
+
+    return result;
+}
+
+std::vector<MapTickProfiler::Summary> MapTickProfiler::GetMapEntries(uint32 mapId)
+{
+    std::vector<Summary> summaries;
+
+    std::lock_guard<std::mutex> guard(profileLock);
+    for (uint32 phase = MAP_TICK_MAP_UPDATE; phase < MAX_MAP_TICK_PHASE; ++phase)
+    {
+        auto itr = entries.find(MakeKey(MapTickPhase(phase), mapId));
+        if (itr != entries.end())
+            summaries.push_back(MakeSummary(itr->first, itr->second));
+    }
+
+    return summaries;
+}
+
+char const* MapTickProfiler::GetPhaseName(MapTickPhase phase)
+{
+    return phase < MAX_MAP_TICK_PHASE ? phaseNames[phase] : "unknown";
+}
+
+void MapTickProfiler::LogReport(size_t countPerPhase)
+{
+    std::vector<Summary> summaries = GetEntries(countPerPhase);
+    if (summaries.empty())
+        return;
+
+    sLog.outString("Map tick profile, per phase the " SIZEFMTD " maps with the highest total time:", countPerPhase);
+    for (Summary const& summary : summaries)
+    {
+        if (summary.mapId == MAP_TICK_ALL_MAPS)
+            sLog.outString("%-17s all maps: %8" PRIu64 " ticks avg " UI64FMTD " us p50 " UI64FMTD " us p95 " UI64FMTD " us p99 " UI64FMTD " us max " UI64FMTD " us",
+                           GetPhaseName(summary.phase), summary.count, summary.totalUs / summary.count, summary.p50Us, summary.p95Us, summary.p99Us, summary.maxUs);
+        else
+            sLog.outString("%-17s map %4u: %8" PRIu64 " ticks avg " UI64FMTD " us p50 " UI64FMTD " us p95 " UI64FMTD " us p99 " UI64FMTD " us max " UI64FMTD " us",
+                           GetPhaseName(summary.phase), summary.mapId, summary.count, summary.totalUs / summary.count, summary.p50Us, summary.p95Us, summary.p99Us, summary.maxUs);
+    }
+}
@@ -0,0 +1,179 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPTICKPROFILER_H
+#define MANGOS_MAPTICKPROFILER_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+enum MapTickPhase
+{
+    MAP_TICK_MAP_UPDATER            = 0,                    // MapManager::Update, all maps of a world tick until the MapUpdater is done
+    MAP_TICK_MAP_UPDATE             = 1,                    // Map::Update of one map, the phases below are parts of it
+    MAP_TICK_SESSIONS               = 2,                    // packets of the players on the map
+    MAP_TICK_PLAYERS                = 3,                    // Player::Update
+    MAP_TICK_CELLS                  = 4,                    // active cell visits, with the object updates when cells are updated in parallel
+    MAP_TICK_OBJECTS                = 5,                    // updates of the objects found in the active cells
+    MAP_TICK_SEND_OBJECT_UPDATES    = 6,                    // Map::SendObjectUpdates
+    MAP_TICK_GRID_STATES            = 7,
+    MAP_TICK_SCRIPTS                = 8,                    // Map::ScriptsProcess
+    MAP_TICK_INSTANCE_DATA          = 9,                    // InstanceData::Update
+    MAP_TICK_WEATHER                = 10,
+    MAX_MAP_TICK_PHASE
+};
+
+// objects listed by the slow tick dump
+#define MAP_TICK_TRACE_OBJECTS 10
+
+// Phase times and the most expensive object updates of one tick of a map, written to the log when the tick was slow.
+// Only collected while the profiler is enabled with a slow tick threshold.
+class MapTickTrace
+{
+    public:
+        class ObjectScope
+        {
+            public:
+                ObjectScope(MapTickTrace& trace, ObjectGuid const& guid) : m_trace(trace.IsActive() ? &trace : nullptr)
+                {
+                    if (m_trace)
+                    {
+                        m_guid = guid;
+                        m_start = std::chrono::steady_clock::now();
+                    }
+                }
+                ~ObjectScope()
+                {
+                    if (m_trace)
+                        m_trace->AddObject(m_guid, uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count()));
+                }
+
+                ObjectScope(ObjectScope const&) = delete;
+                ObjectScope& operator=(ObjectScope const&) = delete;
+
+            private:
+                MapTickTrace* m_trace;
+                ObjectGuid m_guid;
+                std::chrono::steady_clock::time_point m_start;
+        };
+
+        MapTickTrace() : m_active(false), m_phaseUs() {}
+
+        void Start();
+        // writes the trace when the tick since Start took longer than the threshold
+        void Finish(uint32 mapId, uint32 instanceId);
+
+        bool IsActive() const { return m_active; }
+        void AddPhase(MapTickPhase phase, uint64 us) { m_phaseUs[phase] += us; }
+        // objects of parallel cell updates are added from several threads
+        void AddObject(ObjectGuid const& guid, uint64 us);
+
+    private:
+        bool m_active;
+        std::chrono::steady_clock::time_point m_start;
+        uint64 m_phaseUs[MAX_MAP_TICK_PHASE];
+        std::mutex m_objectsLock;
+        std::vector<std::pair<uint64, ObjectGuid>> m_objects;      // most expensive first
+};
+
+// map id of the entries without a map, the MapUpdater phase covers all of them
+#define MAP_TICK_ALL_MAPS uint32(-1)
+
+// Per tick duration percentiles of the map update phases, by map id with the instances of a map merged, collected while enabled.
+// Load can be driven by playerbots or a client crowd, the report gives comparable numbers for every change of the update loop.
+class MapTickProfiler
+{
+    public:
+        struct Summary
+        {
+            MapTickPhase phase;
+            uint32 mapId;
+            uint64 count;
+            uint64 totalUs;
+            uint64 maxUs;
+            uint64 p50Us;
+            uint64 p95Us;
+            uint64 p99Us;
+        };
+
+        class Scope
+        {
+            public:
+                Scope(MapTickPhase phase, uint32 mapId, MapTickTrace* trace = nullptr) : m_enabled(IsEnabled())
+                {
+                    if (m_enabled)
+                    {
+                        m_phase = phase;
+                        m_mapId = mapId;
+                        m_trace = trace && trace->IsActive() ? trace : nullptr;
+                        m_start = std::chrono::steady_clock::now();
+                    }
+                }
+                ~Scope()
+                {
+                    if (m_enabled)
+                    {
+                        uint64 const us = uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+                        Record(m_phase, m_mapId, us);
+                        if (m_trace)
+                            m_trace->AddPhase(m_phase, us);
+                    }
+                }
+
+                Scope(Scope const&) = delete;
+                Scope& operator=(Scope const&) = delete;
+
+            private:
+                bool m_enabled;
+                MapTickPhase m_phase;
+                uint32 m_mapId;
+                MapTickTrace* m_trace;
+                std::chrono::steady_clock::time_point m_start;
+        };
+
+        static void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+        // map ticks longer than this many milliseconds are traced, 0 disables the dumps
+        static void SetSlowTickThreshold(uint32 ms) { m_slowTickThreshold.store(ms, std::memory_order_relaxed); }
+        static uint32 GetSlowTickThreshold() { return m_slowTickThreshold.load(std::memory_order_relaxed); }
+
+        static void Reset();
+
+        // entries ordered by phase, then by total time
+        static std::vector<Summary> GetEntries(size_t countPerPhase);
+        // all phases of one map id
+        static std::vector<Summary> GetMapEntries(uint32 mapId);
+        static void LogReport(size_t countPerPhase);
+
+        static char const* GetPhaseName(MapTickPhase phase);
+
+    private:
+        static void Record(MapTickPhase phase, uint32 mapId, uint64 us);
+
+        static std::atomic<bool> m_enabled;
+        static std::atomic<uint32> m_slowTickThreshold;
+};
+
+#endif
@@ -18,11 +18,15 @@
 
 #include "MapUpdater.h"
 #include "MapWorkers.h"
+#include "Threading.h"
 
-MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0)
+// deque owned by current thread, only set for pool threads
+static thread_local MapUpdater* t_updater = nullptr;
+static thread_local size_t t_queueIndex = 0;
+
+MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), _nextQueue(0), _queuedRequests(0), _lock("MapUpdater::_lock"), pending_requests(0)
 {
-    for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+    activate(num_threads);
 }
 
 void MapUpdater::activate(size_t num_threads)
@@ -30,23 +34,37 @@ void MapUpdater::activate(size_t num_threads)
     if (activated())
         return;
 
+    // all deques must exist before the first thread may try to steal
     for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue));
+
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
 }
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
-
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_idleLock);
+        _cancelationToken = true;
+    }
+    _idleCondition.notify_all();
 
     for (auto& thread : _workerThreads)
         thread.join();
+
+    // release requests that never got executed
+    for (auto& queue : _queues)
+    {
+        for (Worker* request : queue->requests)
+            request->release();
+        queue->requests.clear();
+    }
 }
 
 void MapUpdater::wait()
 {
-    std::unique_lock<std::mutex> lock(_lock);
+    std::unique_lock<ProfiledMutex> lock(_lock);
 
     while (pending_requests > 0)
         _condition.wait(lock);
@@ -65,7 +83,7 @@ bool MapUpdater::activated()
 
 void MapUpdater::update_finished()
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    std::lock_guard<ProfiledMutex> lock(_lock);
 
     --pending_requests;
     _condition.notify_all();
@@ -73,28 +91,80 @@ void MapUpdater::update_finished()
 
 void MapUpdater::schedule_update(Worker* worker)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    {
+        std::lock_guard<ProfiledMutex> lock(_lock);
+        ++pending_requests;
+    }
+
+    size_t index = t_updater == this ? t_queueIndex : _nextQueue++ % _queues.size();
+    {
+        std::lock_guard<std::mutex> lock(_queues[index]->lock);
+        _queues[index]->requests.push_back(worker);
+    }
 
-    ++pending_requests;
-    _queue.Push(std::move(worker));
+    {
+        std::lock_guard<std::mutex> lock(_idleLock);
+        ++_queuedRequests;
+    }
+    _idleCondition.notify_one();
 }
 
-void MapUpdater::WorkerThread()
+Worker* MapUpdater::pop_request(size_t index)
 {
-    while (true)
+    // own deque in schedule order
     {
-        Worker* request = nullptr;
+        WorkerQueue& queue = *_queues[index];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        if (!queue.requests.empty())
+        {
+            Worker* request = queue.requests.front();
+            queue.requests.pop_front();
+            --_queuedRequests;
+            return request;
+        }
+    }
 
-        _queue.WaitAndPop(request);
+    // steal the most recently scheduled request of another thread
+    for (size_t i = 1; i < _queues.size(); ++i)
+    {
+        WorkerQueue& queue = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        if (!queue.requests.empty())
+        {
+            Worker* request = queue.requests.back();
+            queue.requests.pop_back();
+            --_queuedRequests;
+            return request;
+        }
+    }
+
+    return nullptr;
+}
 
-        if (_cancelationToken)
+void MapUpdater::WorkerThread(size_t index)
+{
+    MaNGOS::Thread::SetupCurrentThread("map");
+
+    t_updater = this;
+    t_queueIndex = index;
+
+    while (!_cancelationToken)
+    {
+        Worker* request = pop_request(index);
+
+        if (!request)
         {
-            delete request;
-            return;
+            std::unique_lock<std::mutex> lock(_idleLock);
+            _idleCondition.wait(lock, [this] { return _cancelationToken || _queuedRequests > 0; });
+
+            if (_cancelationToken)
+                return;
+
+            continue;
         }
 
         request->execute();
 
-        delete request;
+        request->release();
     }
-}
\ No newline at end of file
+}
@@ -20,42 +20,64 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Platform/Define.h"
-#include "ProducerConsumerQueue.h"
+#include "ProfiledMutex.h"
 
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <condition_variable>
 
 class Worker;
 
+/**
+ * Thread pool for map updates.
+ *
+ * Every thread owns a deque of workers. Workers are taken from the front of the own deque
+ * first, an idle thread steals from the back of the other deques. Workers scheduled from a
+ * pool thread go to that thread's deque, others are distributed round robin.
+ */
 class MapUpdater
 {
     public:
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        MapUpdater() : _cancelationToken(false), _nextQueue(0), _queuedRequests(0), _lock("MapUpdater::_lock"), pending_requests(0) {}
         MapUpdater(size_t num_threads);
         MapUpdater(const MapUpdater&) = delete;
-        
+
         void activate(size_t num_threads);
         void deactivate();
         void wait();
         void join();
         bool activated();
+        size_t thread_count() const { return _workerThreads.size(); }
         void update_finished();
         void schedule_update(Worker* worker);
 
     private:
-        ProducerConsumerQueue<Worker *> _queue;
+        struct WorkerQueue
+        {
+            std::mutex lock;
+            std::deque<Worker*> requests;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
 
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
+        std::atomic<size_t> _nextQueue;
+
+        std::mutex _idleLock;
+        std::condition_variable _idleCondition;
+        std::atomic<size_t> _queuedRequests;
 
-        std::mutex _lock;
-        std::condition_variable _condition;
+        ProfiledMutex _lock;
+        std::condition_variable_any _condition;
         size_t pending_requests;
 
-        void WorkerThread();
+        Worker* pop_request(size_t index);
+        void WorkerThread(size_t index);
 };
 
-#endif //_MAP_UPDATER_H_INCLUDED
\ No newline at end of file
+#endif //_MAP_UPDATER_H_INCLUDED
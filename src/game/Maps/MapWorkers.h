@@ -22,15 +22,23 @@
 #include "Grids/Cell.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "MapUpdater.h"
+#include "Maps/MapManager.h"
+#include "Entities/Transports.h"
 #include "MotionGenerators/MovementGenerator.h"
 #include "Entities/Object.h"
 #include "Platform/Define.h"
+#include "Server/WorldSession.h"
+
+#include <memory>
 
 class Worker
 {
     public:
         Worker(MapUpdater& updater) : m_updater(updater) {}
+        virtual ~Worker() {}
         virtual void execute() {};
+        // called by MapUpdater after execute or at deactivate for never executed workers
+        virtual void release() { delete this; }
 
     protected:
         MapUpdater& GetWorker() { return m_updater; }
@@ -39,51 +47,293 @@ class Worker
         MapUpdater& m_updater;
 };
 
+// Owned and reused by MapManager, one per map updated in the tick
 class MapUpdateWorker : public Worker
 {
     public:
-        MapUpdateWorker(Map& map, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_map(map), m_diff(diff)
+        MapUpdateWorker(MapUpdater& updater) :
+            Worker(updater), m_map(nullptr), m_diff(0)
         {}
 
+        void Reset(Map& map, uint32 diff)
+        {
+            m_map = &map;
+            m_diff = diff;
+        }
+
+        void UpdateMap()
+        {
+            m_map->Update(m_diff);
+            m_map->UpdateTransports(m_diff);
+        }
+
         void execute() override
         {
-            m_map.Update(m_diff);
+            UpdateMap();
             GetWorker().update_finished();
         }
 
+        void release() override {}
+
     private:
-        Map& m_map;
+        Map* m_map;
         uint32 m_diff;
 };
 
-class GridCrawler : public Worker
+// Unloads and deletes a map already removed from MapManager
+class MapReclaimWorker : public Worker
 {
     public:
-        GridCrawler(Map& map, std::vector<Cell> &cells, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_map(map), m_cells(cells), m_diff(diff)
+        MapReclaimWorker(Map* map, MapUpdater& updater) :
+            Worker(updater), m_map(map)
         {}
 
         void execute() override
         {
-            WorldObjectUnSet objToUpdate;
-            MaNGOS::ObjectUpdater obj_updater(objToUpdate, m_diff);
-            TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
-            TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
+            sMapMgr.ReclaimMap(m_map);
+            GetWorker().update_finished();
+        }
+
+    private:
+        Map* m_map;
+};
 
-            for (auto &cell : m_cells)
+// Active cells of one grid and the objects found in them during a parallel cell update
+struct CellRegion
+{
+    CellRegion(uint32 x, uint32 y) : gridX(x), gridY(y) {}
+
+    uint32 gridX;
+    uint32 gridY;
+    std::vector<Cell> cells;
+    std::vector<WorldObject*> objects;
+};
+
+// One stage of a parallel cell update. Regions are claimed one by one by the owning map
+// thread and by any GridCrawler that gets scheduled, so the owner never waits on work
+// that is still queued behind other maps.
+class CellRegionBatch
+{
+    public:
+        enum Stage
+        {
+            STAGE_CRAWL,                                    // collect objects from region cells
+            STAGE_UPDATE,                                   // update collected objects
+        };
+
+        CellRegionBatch(std::vector<CellRegion*>&& regions, Stage stage, uint32 diff) :
+            m_regions(std::move(regions)), m_stage(stage), m_diff(diff), m_next(0), m_done(0)
+        {}
+
+        size_t GetRegionCount() const { return m_regions.size(); }
+
+        // claim and process the next free region, false if none left
+        bool ProcessNext(Map& map)
+        {
+            size_t index = m_next.fetch_add(1);
+            if (index >= m_regions.size())
+                return false;
+
+            CellRegion& region = *m_regions[index];
+            if (m_stage == STAGE_CRAWL)
             {
-                m_map.Visit(cell, grid_object_update);
-                m_map.Visit(cell, world_object_update);
+                WorldObjectUnSet objToUpdate;
+                MaNGOS::ObjectUpdater obj_updater(objToUpdate, m_diff);
+                TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
+                TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
+
+                for (auto& cell : region.cells)
+                {
+                    map.Visit(cell, grid_object_update);
+                    map.Visit(cell, world_object_update);
+                }
+
+                region.objects.assign(objToUpdate.begin(), objToUpdate.end());
+            }
+            else
+            {
+                // see Map::GetUpdateRotation
+                size_t const count = region.objects.size();
+                size_t const first = map.GetUpdateRotation(count);
+                for (size_t i = 0; i < count; ++i)
+                    map.UpdateActiveObject(region.objects[(first + i) % count], m_diff);
+            }
+
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (++m_done == m_regions.size())
+                m_condition.notify_all();
+            return true;
+        }
+
+        // wait for regions claimed by other threads
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            while (m_done < m_regions.size())
+                m_condition.wait(lock);
+        }
+
+    private:
+        std::vector<CellRegion*> m_regions;
+        Stage m_stage;
+        uint32 m_diff;
+        std::atomic<size_t> m_next;
+        size_t m_done;
+
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+};
+
+// Builds, compresses and sends the update packets of one map, every receiver's packet is independent.
+// Receivers are claimed in small chunks by the owning map thread and any UpdatePacketSender.
+class UpdatePacketBatch
+{
+    public:
+        enum { CHUNK_SIZE = 8 };
+
+        UpdatePacketBatch(std::vector<UpdateDataMapType::value_type*>&& receivers) :
+            m_receivers(std::move(receivers)), m_next(0), m_done(0)
+        {}
+
+        size_t GetReceiverCount() const { return m_receivers.size(); }
+
+        // claim and send the next chunk of receivers, false if none left
+        bool ProcessNext()
+        {
+            size_t first = m_next.fetch_add(CHUNK_SIZE);
+            if (first >= m_receivers.size())
+                return false;
+
+            size_t last = std::min(first + CHUNK_SIZE, m_receivers.size());
+
+            WorldPacket packet;
+            for (size_t i = first; i < last; ++i)
+            {
+                UpdateDataMapType::value_type& receiver = *m_receivers[i];
+                receiver.second.BuildPacket(packet);
+                receiver.first->GetSession()->SendPacket(packet);
+                packet.clear();
+                receiver.second.Clear();
             }
 
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_done += last - first;
+            if (m_done == m_receivers.size())
+                m_condition.notify_all();
+            return true;
+        }
+
+        // wait for chunks claimed by other threads
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            while (m_done < m_receivers.size())
+                m_condition.wait(lock);
+        }
+
+    private:
+        std::vector<UpdateDataMapType::value_type*> m_receivers;
+        std::atomic<size_t> m_next;
+        size_t m_done;
+
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+};
+
+class UpdatePacketSender : public Worker
+{
+    public:
+        UpdatePacketSender(std::shared_ptr<UpdatePacketBatch> const& batch, MapUpdater& updater) :
+            Worker(updater), m_batch(batch)
+        {}
+
+        void execute() override
+        {
+            while (m_batch->ProcessNext()) {}
+
+            GetWorker().update_finished();
+        }
+
+    private:
+        std::shared_ptr<UpdatePacketBatch> m_batch;         // keep batch alive if owner already finished it
+};
+
+class GridCrawler : public Worker
+{
+    public:
+        GridCrawler(Map& map, std::shared_ptr<CellRegionBatch> const& batch, MapUpdater& updater) :
+            Worker(updater), m_map(map), m_batch(batch)
+        {}
+
+        void execute() override
+        {
+            while (m_batch->ProcessNext(m_map)) {}
+
             GetWorker().update_finished();
         }
 
     private:
         Map& m_map;
-        std::vector<Cell> &m_cells;
-        uint32 m_diff;
+        std::shared_ptr<CellRegionBatch> m_batch;           // keep stage alive if owner already finished it
+};
+
+// Sessions whose session local packets are handled in the parallel part of World::UpdateSessions.
+// Sessions are claimed one by one by the world thread and any SessionLocalWorker.
+class SessionLocalBatch
+{
+    public:
+        explicit SessionLocalBatch(std::vector<WorldSession*>&& sessions) :
+            m_sessions(std::move(sessions)), m_next(0), m_done(0)
+        {}
+
+        // claim and update the next free session, false if none left
+        bool ProcessNext()
+        {
+            size_t index = m_next.fetch_add(1);
+            if (index >= m_sessions.size())
+                return false;
+
+            m_sessions[index]->UpdateSessionLocal();
+
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (++m_done == m_sessions.size())
+                m_condition.notify_all();
+            return true;
+        }
+
+        // wait for sessions claimed by other threads
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            while (m_done < m_sessions.size())
+                m_condition.wait(lock);
+        }
+
+    private:
+        std::vector<WorldSession*> m_sessions;
+        std::atomic<size_t> m_next;
+        size_t m_done;
+
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+};
+
+class SessionLocalWorker : public Worker
+{
+    public:
+        SessionLocalWorker(std::shared_ptr<SessionLocalBatch> const& batch, MapUpdater& updater) :
+            Worker(updater), m_batch(batch)
+        {}
+
+        void execute() override
+        {
+            while (m_batch->ProcessNext()) {}
+
+            GetWorker().update_finished();
+        }
+
+    private:
+        std::shared_ptr<SessionLocalBatch> m_batch;         // keep the batch alive if the world thread already finished it
 };
 
 
@@ -0,0 +1,99 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/UnitSpatialHash.h"
+#include "Entities/Unit.h"
+
+UnitSpatialHash::UnitSpatialHash() : m_maxBoundingRadius(0.0f)
+{
+    for (auto& row : m_grids)
+        for (auto& grid : row)
+            grid = nullptr;
+}
+
+UnitSpatialHash::~UnitSpatialHash()
+{
+    for (auto& row : m_grids)
+        for (auto& grid : row)
+            delete grid;
+}
+
+void UnitSpatialHash::Insert(Unit* unit)
+{
+    if (unit->m_spatialHash)
+        return;
+
+    unit->m_spatialHash = this;
+    m_maxBoundingRadius = std::max(m_maxBoundingRadius, std::max(unit->GetObjectBoundingRadius(), unit->GetCombatReach()));
+    AddToBucket(unit, ComputeBucketCoord(unit->GetPositionX()), ComputeBucketCoord(unit->GetPositionY()));
+}
+
+void UnitSpatialHash::Remove(Unit* unit)
+{
+    if (unit->m_spatialHash != this)
+        return;
+
+    RemoveFromBucket(unit);
+    unit->m_spatialHash = nullptr;
+}
+
+void UnitSpatialHash::Relocate(Unit* unit)
+{
+    uint32 const bucketX = ComputeBucketCoord(unit->GetPositionX());
+    uint32 const bucketY = ComputeBucketCoord(unit->GetPositionY());
+    if (bucketX == unit->m_spatialBucketX && bucketY == unit->m_spatialBucketY)
+        return;
+
+    RemoveFromBucket(unit);
+    AddToBucket(unit, bucketX, bucketY);
+}
+
+void UnitSpatialHash::AddToBucket(Unit* unit, uint32 bucketX, uint32 bucketY)
+{
+    GridBuckets*& grid = m_grids[bucketX / SPATIAL_BUCKETS_PER_GRID][bucketY / SPATIAL_BUCKETS_PER_GRID];
+    if (!grid)
+        grid = new GridBuckets;
+
+    std::vector<Unit*>& bucket = grid->buckets[GetBucketIndex(bucketX, bucketY)];
+    unit->m_spatialBucketX = bucketX;
+    unit->m_spatialBucketY = bucketY;
+    unit->m_spatialIndex = uint32(bucket.size());
+    bucket.push_back(unit);
+    ++grid->count;
+}
+
+void UnitSpatialHash::RemoveFromBucket(Unit* unit)
+{
+    uint32 const bucketX = unit->m_spatialBucketX;
+    uint32 const bucketY = unit->m_spatialBucketY;
+    GridBuckets*& grid = m_grids[bucketX / SPATIAL_BUCKETS_PER_GRID][bucketY / SPATIAL_BUCKETS_PER_GRID];
+    std::vector<Unit*>& bucket = grid->buckets[GetBucketIndex(bucketX, bucketY)];
+
+    // swap with the last unit of the bucket, the order of a bucket does not matter
+    Unit* last = bucket.back();
+    bucket[unit->m_spatialIndex] = last;
+    last->m_spatialIndex = unit->m_spatialIndex;
+    bucket.pop_back();
+
+    // release the buckets of grids left by all units, players crossing a continent would keep them all otherwise
+    if (--grid->count == 0)
+    {
+        delete grid;
+        grid = nullptr;
+    }
+}
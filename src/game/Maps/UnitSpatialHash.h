@@ -0,0 +1,139 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_UNITSPATIALHASH_H
+#define MANGOS_UNITSPATIALHASH_H
+
+#include "Common.h"
+#include "Maps/GridDefines.h"
+
+#include <algorithm>
+#include <list>
+#include <vector>
+
+class Unit;
+
+#define SPATIAL_BUCKETS_PER_CELL    2
+#define SPATIAL_BUCKETS_PER_GRID    (MAX_NUMBER_OF_CELLS * SPATIAL_BUCKETS_PER_CELL)
+#define SPATIAL_BUCKETS_PER_MAP     (MAX_NUMBER_OF_GRIDS * SPATIAL_BUCKETS_PER_GRID)
+#define SIZE_OF_SPATIAL_BUCKET      (SIZE_OF_GRID_CELL / SPATIAL_BUCKETS_PER_CELL)
+
+/**
+ * Buckets of the in world units of a map, a quarter of a cell each, for radius searches much smaller than a cell.
+ * The buckets are allocated per grid while the grid holds units, so whatever the parallel cell update allows
+ * for the objects of a grid neighbourhood also holds for their buckets.
+ *
+ * The searches select by bucket only, the check still has to test the distance like with a cell visit.
+ */
+class UnitSpatialHash
+{
+    public:
+        UnitSpatialHash();
+        ~UnitSpatialHash();
+
+        // must be called with AddToWorld and RemoveFromWorld of the unit
+        void Insert(Unit* unit);
+        void Remove(Unit* unit);
+        // must be called after each position change of an inserted unit
+        void Relocate(Unit* unit);
+
+        // all units passing the check in the buckets touched by the radius, like UnitListSearcher over the same area
+        template<class Container, class Check>
+        void SearchUnits(float x, float y, float radius, Container& units, Check& check) const
+        {
+            radius += m_maxBoundingRadius;
+
+            uint32 const lowX = ComputeBucketCoord(x - radius);
+            uint32 const lowY = ComputeBucketCoord(y - radius);
+            uint32 const highX = ComputeBucketCoord(x + radius);
+            uint32 const highY = ComputeBucketCoord(y + radius);
+
+            for (uint32 bucketX = lowX; bucketX <= highX; ++bucketX)
+            {
+                for (uint32 bucketY = lowY; bucketY <= highY; ++bucketY)
+                {
+                    GridBuckets const* grid = m_grids[bucketX / SPATIAL_BUCKETS_PER_GRID][bucketY / SPATIAL_BUCKETS_PER_GRID];
+                    if (!grid)
+                        continue;
+
+                    for (Unit* unit : grid->buckets[GetBucketIndex(bucketX, bucketY)])
+                        if (check(unit))
+                            units.push_back(unit);
+                }
+            }
+        }
+
+        // first unit passing the check, like UnitSearcher over the same area
+        template<class Check>
+        Unit* SearchUnit(float x, float y, float radius, Check& check) const
+        {
+            radius += m_maxBoundingRadius;
+
+            uint32 const lowX = ComputeBucketCoord(x - radius);
+            uint32 const lowY = ComputeBucketCoord(y - radius);
+            uint32 const highX = ComputeBucketCoord(x + radius);
+            uint32 const highY = ComputeBucketCoord(y + radius);
+
+            for (uint32 bucketX = lowX; bucketX <= highX; ++bucketX)
+            {
+                for (uint32 bucketY = lowY; bucketY <= highY; ++bucketY)
+                {
+                    GridBuckets const* grid = m_grids[bucketX / SPATIAL_BUCKETS_PER_GRID][bucketY / SPATIAL_BUCKETS_PER_GRID];
+                    if (!grid)
+                        continue;
+
+                    for (Unit* unit : grid->buckets[GetBucketIndex(bucketX, bucketY)])
+                        if (check(unit))
+                            return unit;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        struct GridBuckets
+        {
+            GridBuckets() : count(0) {}
+
+            std::vector<Unit*> buckets[SPATIAL_BUCKETS_PER_GRID * SPATIAL_BUCKETS_PER_GRID];
+            uint32 count;
+        };
+
+        static uint32 ComputeBucketCoord(float c)
+        {
+            // same rounding as MaNGOS::Compute for the cells, so a bucket never overlaps two cells
+            double offset = (double(c) - SIZE_OF_SPATIAL_BUCKET / 2) / SIZE_OF_SPATIAL_BUCKET;
+            int val = int(offset + SPATIAL_BUCKETS_PER_MAP / 2 + 0.5);
+            if (val < 0)
+                return 0;
+            return std::min(uint32(val), uint32(SPATIAL_BUCKETS_PER_MAP - 1));
+        }
+
+        static uint32 GetBucketIndex(uint32 bucketX, uint32 bucketY)
+        {
+            return (bucketX % SPATIAL_BUCKETS_PER_GRID) * SPATIAL_BUCKETS_PER_GRID + bucketY % SPATIAL_BUCKETS_PER_GRID;
+        }
+
+        void AddToBucket(Unit* unit, uint32 bucketX, uint32 bucketY);
+        void RemoveFromBucket(Unit* unit);
+
+        GridBuckets* m_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        float m_maxBoundingRadius;                          // largest bounding radius or combat reach of inserted units, widens the searches
+};
+
+#endif
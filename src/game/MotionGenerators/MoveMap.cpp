@@ -17,11 +17,72 @@
  */
 
 #include "Log.h"
+#include "MemoryTracker.h"
 #include "World/World.h"
 #include "Entities/Creature.h"
 #include "MotionGenerators/MoveMap.h"
 #include "MoveMapSharedDefines.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // copy on write mapping, detour links the polys of neighbour tiles inside the tile data
+    // so only the pages holding the links get private copies, the rest is shared through the file cache
+    void* MapTileFile(char const* filename, size_t& size)
+    {
+        void* mapping = nullptr;
+#ifdef _WIN32
+        HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return nullptr;
+
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            if (HANDLE handle = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr))
+            {
+                mapping = MapViewOfFile(handle, FILE_MAP_COPY, 0, 0, 0);
+                size = size_t(fileSize.QuadPart);
+                CloseHandle(handle);
+            }
+        }
+        CloseHandle(file);
+#else
+        int file = open(filename, O_RDONLY);
+        if (file < 0)
+            return nullptr;
+
+        struct stat fileStat;
+        if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            size = size_t(fileStat.st_size);
+            mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+            if (mapping == MAP_FAILED)
+                mapping = nullptr;
+        }
+        close(file);
+#endif
+        return mapping;
+    }
+
+    void UnmapTileFile(void* mapping, size_t size)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        munmap(mapping, size);
+#endif
+    }
+}
+
 namespace MMAP
 {
     // ######################## MMapFactory ########################
@@ -206,10 +267,11 @@ namespace MMAP
 
         // check if we already have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
-        if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
+        MMapTileSet::iterator loaded = mmap->mmapLoadedTiles.find(packedGridPos);
+        if (loaded != mmap->mmapLoadedTiles.end())
         {
-            sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %03u%02i%02i.mmtile", mapId, x, y);
-            return false;
+            ++loaded->second.refCount;
+            return true;
         }
 
         // load this tile :: mmaps/MMMXXYY.mmtile
@@ -217,60 +279,109 @@ namespace MMAP
         char* fileName = new char[pathLen];
         snprintf(fileName, pathLen, (sWorld.GetDataPath() + "mmaps/%03i%02i%02i.mmtile").c_str(), mapId, x, y);
 
-        FILE* file = fopen(fileName, "rb");
-        if (!file)
+        void* mapping = nullptr;
+        size_t mappingSize = 0;
+        unsigned char* data = nullptr;
+        MmapTileHeader fileHeader;
+
+        if (sWorld.getConfig(CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED) && (mapping = MapTileFile(fileName, mappingSize)))
         {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "ERROR: MMAP:loadMap: Could not open mmtile file '%s'", fileName);
-            delete[] fileName;
-            return false;
+            if (mappingSize < sizeof(MmapTileHeader))
+            {
+                sLog.outError("MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
+                UnmapTileFile(mapping, mappingSize);
+                delete[] fileName;
+                return false;
+            }
+
+            memcpy(&fileHeader, mapping, sizeof(MmapTileHeader));
+            data = (unsigned char*)mapping + sizeof(MmapTileHeader);
         }
-        delete[] fileName;
+        else
+        {
+            FILE* file = fopen(fileName, "rb");
+            if (!file)
+            {
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "ERROR: MMAP:loadMap: Could not open mmtile file '%s'", fileName);
+                delete[] fileName;
+                return false;
+            }
 
-        // read header
-        MmapTileHeader fileHeader;
-        fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
+            // read header
+            if (fread(&fileHeader, sizeof(MmapTileHeader), 1, file) != 1)
+            {
+                sLog.outError("MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
+                fclose(file);
+                delete[] fileName;
+                return false;
+            }
+
+            // the header is checked below
+            if (fileHeader.mmapMagic != MMAP_MAGIC || fileHeader.mmapVersion != MMAP_VERSION)
+                fclose(file);
+            else
+            {
+                data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+                MANGOS_ASSERT(data);
+
+                size_t result = fread(data, fileHeader.size, 1, file);
+                fclose(file);
+                if (!result)
+                {
+                    sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+                    dtFree(data);
+                    delete[] fileName;
+                    return false;
+                }
+            }
+        }
+        delete[] fileName;
 
+        bool valid = true;
         if (fileHeader.mmapMagic != MMAP_MAGIC)
         {
             sLog.outError("MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
-            fclose(file);
-            return false;
+            valid = false;
         }
-
-        if (fileHeader.mmapVersion != MMAP_VERSION)
+        else if (fileHeader.mmapVersion != MMAP_VERSION)
         {
             sLog.outError("MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
                           mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
-            fclose(file);
-            return false;
+            valid = false;
         }
-
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        MANGOS_ASSERT(data);
-
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
+        else if (mapping && sizeof(MmapTileHeader) + fileHeader.size > mappingSize)
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
-            fclose(file);
-            return false;
+            valid = false;
         }
 
-        fclose(file);
+        if (!valid)
+        {
+            if (mapping)
+                UnmapTileFile(mapping, mappingSize);
+            else if (data)
+                dtFree(data);
+            return false;
+        }
 
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
-        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        // heap data is managed by detour and deallocated when the tile is removed, mapped data is unmapped by us
+        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, mapping ? 0 : DT_TILE_FREE_DATA, 0, &tileRef);
         if (dtStatusFailed(dtResult))
         {
             sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
+            if (mapping)
+                UnmapTileFile(mapping, mappingSize);
+            else
+                dtFree(data);
             return false;
         }
 
-        mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        mmap->mmapLoadedTiles.insert(MMapTileSet::value_type(packedGridPos, MMapTile(tileRef, mapping, mappingSize, fileHeader.size)));
+        MemoryTracker::Add(MEMORY_TAG_MMAP, fileHeader.size);
+        mmap->pathCache.Clear();
         ++loadedTiles;
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
         return true;
@@ -297,27 +408,39 @@ namespace MMAP
             return false;
         }
 
-        dtTileRef tileRef = mmap->mmapLoadedTiles[packedGridPos];
+        MMapTile& tile = mmap->mmapLoadedTiles.find(packedGridPos)->second;
+        // still used by another load
+        if (--tile.refCount)
+            return true;
 
         // unload, and mark as non loaded
-        dtStatus dtResult = mmap->navMesh->removeTile(tileRef, nullptr, nullptr);
-        if (dtStatusFailed(dtResult))
+        if (!removeTile(mmap, tile))
         {
             // this is technically a memory leak
             // if the grid is later reloaded, dtNavMesh::addTile will return error but no extra memory is used
             // we cannot recover from this error - assert out
             sLog.outError("MMAP:unloadMap: Could not unload %03u%02i%02i.mmtile from navmesh", mapId, x, y);
             MANGOS_ASSERT(false);
-        }
-        else
-        {
-            mmap->mmapLoadedTiles.erase(packedGridPos);
-            --loadedTiles;
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
-            return true;
+            return false;
         }
 
-        return false;
+        mmap->mmapLoadedTiles.erase(packedGridPos);
+        mmap->pathCache.Clear();
+        --loadedTiles;
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
+        return true;
+    }
+
+    bool MMapManager::removeTile(MMapData* mmap, MMapTile const& tile)
+    {
+        if (dtStatusFailed(mmap->navMesh->removeTile(tile.ref, nullptr, nullptr)))
+            return false;
+
+        if (tile.mapping)
+            UnmapTileFile(tile.mapping, tile.mappingSize);
+
+        MemoryTracker::Remove(MEMORY_TAG_MMAP, tile.dataSize);
+        return true;
     }
 
     bool MMapManager::unloadMap(uint32 mapId)
@@ -335,8 +458,7 @@ namespace MMAP
         {
             uint32 x = (i->first >> 16);
             uint32 y = (i->first & 0x0000FFFF);
-            dtStatus dtResult = mmap->navMesh->removeTile(i->second, nullptr, nullptr);
-            if (dtStatusFailed(dtResult))
+            if (!removeTile(mmap, i->second))
                 sLog.outError("MMAP:unloadMap: Could not unload %03u%02i%02i.mmtile from navmesh", mapId, x, y);
             else
             {
@@ -362,17 +484,9 @@ namespace MMAP
             return false;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-        {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-            return false;
-        }
-
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
+        // the queries are not bound to instances, drop the ones the remaining instances do not use right now
+        loadedMMaps[mapId]->queryPool.Trim();
 
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
 
         return true;
@@ -386,29 +500,112 @@ namespace MMAP
         return loadedMMaps[mapId]->navMesh;
     }
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
+    PathCache* MMapManager::GetPathCache(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
             return nullptr;
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        return &itr->second->pathCache;
+    }
+
+    bool PathCache::Get(Key const& key, dtPolyRef* path, uint32& length, uint32 maxLength)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        std::map<Key, EntryList::iterator>::const_iterator itr = m_index.find(key);
+        if (itr == m_index.end() || itr->second->second.size() > maxLength)
+            return false;
+
+        m_entries.splice(m_entries.begin(), m_entries, itr->second);
+
+        std::vector<dtPolyRef> const& cached = itr->second->second;
+        std::copy(cached.begin(), cached.end(), path);
+        length = uint32(cached.size());
+        return true;
+    }
+
+    void PathCache::Add(Key const& key, dtPolyRef const* path, uint32 length)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        std::map<Key, EntryList::iterator>::iterator itr = m_index.find(key);
+        if (itr != m_index.end())
         {
-            // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            MANGOS_ASSERT(query);
-            dtStatus dtResult = query->init(mmap->navMesh, 1024);
-            if (dtStatusFailed(dtResult))
+            itr->second->second.assign(path, path + length);
+            m_entries.splice(m_entries.begin(), m_entries, itr->second);
+            return;
+        }
+
+        if (m_index.size() >= MMAP_PATH_CACHE_SIZE)
+        {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+
+        m_entries.emplace_front(key, std::vector<dtPolyRef>(path, path + length));
+        m_index[key] = m_entries.begin();
+    }
+
+    void PathCache::Clear()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_index.clear();
+        m_entries.clear();
+    }
+
+    NavMeshQueryPool* MMapManager::GetNavMeshQueryPool(uint32 mapId)
+    {
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        return &itr->second->queryPool;
+    }
+
+    NavMeshQueryPool::~NavMeshQueryPool()
+    {
+        Trim();
+    }
+
+    dtNavMeshQuery* NavMeshQueryPool::Acquire()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            if (!m_idle.empty())
             {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-                return nullptr;
+                dtNavMeshQuery* query = m_idle.back();
+                m_idle.pop_back();
+                return query;
             }
+        }
 
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        dtStatus dtResult = query->init(m_navMesh, 1024);
+        if (dtStatusFailed(dtResult))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:NavMeshQueryPool: Failed to initialize dtNavMeshQuery");
+            return nullptr;
         }
 
-        return mmap->navMeshQueries[instanceId];
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:NavMeshQueryPool: created dtNavMeshQuery");
+        return query;
+    }
+
+    void NavMeshQueryPool::Release(dtNavMeshQuery* query)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_idle.push_back(query);
+    }
+
+    void NavMeshQueryPool::Trim()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        for (dtNavMeshQuery* query : m_idle)
+            dtFreeNavMeshQuery(query);
+        m_idle.clear();
     }
 }
@@ -24,6 +24,14 @@
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
 
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#define MMAP_PATH_CACHE_SIZE 512                            // poly paths kept per map
+
 class Unit;
 
 //  memory management
@@ -40,27 +48,91 @@ inline void dtCustomFree(void* ptr)
 //  move map related classes
 namespace MMAP
 {
-    typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    struct MMapTile
+    {
+        MMapTile(dtTileRef tileRef, void* tileMapping, size_t tileMappingSize, size_t tileDataSize) :
+            ref(tileRef), mapping(tileMapping), mappingSize(tileMappingSize), dataSize(tileDataSize), refCount(1) {}
+
+        dtTileRef ref;
+        void* mapping;                      // private mapping of the .mmtile holding the tile data, null when detour owns a heap copy
+        size_t mappingSize;
+        size_t dataSize;                    // tile data accounted as MEMORY_TAG_MMAP
+        uint32 refCount;                    // loads of the tile not yet unloaded
+    };
+
+    typedef std::unordered_map<uint32, MMapTile> MMapTileSet;
+
+    // dtNavMeshQuery objects of one navmesh, each with its own node pool, handed out to one user at a time
+    class NavMeshQueryPool
+    {
+        public:
+            explicit NavMeshQueryPool(dtNavMesh const* navMesh) : m_navMesh(navMesh) {}
+            ~NavMeshQueryPool();
+
+            // nullptr if a new query could not be initialized
+            dtNavMeshQuery* Acquire();
+            void Release(dtNavMeshQuery* query);
+            // frees the idle queries, checked out ones are kept
+            void Trim();
+
+        private:
+            std::mutex m_lock;
+            dtNavMesh const* m_navMesh;
+            std::vector<dtNavMeshQuery*> m_idle;
+    };
+
+    // checks out a query of the pool for its lifetime
+    class PooledNavMeshQuery
+    {
+        public:
+            explicit PooledNavMeshQuery(NavMeshQueryPool* pool) : m_pool(pool), m_query(pool ? pool->Acquire() : nullptr) {}
+            ~PooledNavMeshQuery() { if (m_query) m_pool->Release(m_query); }
+
+            PooledNavMeshQuery(PooledNavMeshQuery const&) = delete;
+            PooledNavMeshQuery& operator=(PooledNavMeshQuery const&) = delete;
+
+            dtNavMeshQuery const* get() const { return m_query; }
+
+        private:
+            NavMeshQueryPool* m_pool;
+            dtNavMeshQuery* m_query;
+    };
+
+    // least recently used complete poly paths of a navmesh, by start poly, end poly and filter flags
+    class PathCache
+    {
+        public:
+            typedef std::tuple<dtPolyRef, dtPolyRef, uint16, uint16> Key;
+
+            bool Get(Key const& key, dtPolyRef* path, uint32& length, uint32 maxLength);
+            void Add(Key const& key, dtPolyRef const* path, uint32 length);
+            // poly refs of changed tiles may be reused by other polys
+            void Clear();
+
+        private:
+            typedef std::list<std::pair<Key, std::vector<dtPolyRef>>> EntryList;
+
+            std::mutex m_lock;
+            EntryList m_entries;                            // most recently used first
+            std::map<Key, EntryList::iterator> m_index;
+    };
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), queryPool(mesh) {}
         ~MMapData()
         {
-            for (auto& navMeshQuerie : navMeshQueries)
-                dtFreeNavMeshQuery(navMeshQuerie.second);
-
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
 
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
-        MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+        // dtNavMeshQuery is not thread safe, the queries are shared by all instances through the pool
+        NavMeshQueryPool queryPool;
+        MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile] and its data
+        PathCache pathCache;
     };
 
 
@@ -80,14 +152,18 @@ namespace MMAP
             bool unloadMapInstance(uint32 mapId, uint32 instanceId);
             bool IsMMapIsLoaded(uint32 mapId, uint32 x, uint32 y) const;
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // check out with PooledNavMeshQuery, nullptr if the navmesh of the map is not loaded
+            NavMeshQueryPool* GetNavMeshQueryPool(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
+            // nullptr if the navmesh of the map is not loaded
+            PathCache* GetPathCache(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
         private:
             bool loadMapData(uint32 mapId);
+            // removes the tile from the navmesh and releases its data
+            bool removeTile(MMapData* mmap, MMapTile const& tile);
             uint32 packTileID(int32 x, int32 y) const;
 
             MMapDataSet loadedMMaps;
@@ -283,7 +283,11 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
     WorldPacket data(opcode, recv_data.size());
     data << mover->GetPackGUID();                           // write guid
     movementInfo.Write(data);                               // write data
-    mover->SendMessageToSetExcept(data, _player);
+
+    if (opcode == MSG_MOVE_HEARTBEAT)
+        mover->SendMovementHeartbeatToSet(data, _player);
+    else
+        mover->SendMessageToSetExcept(data, _player);
 }
 
 void WorldSession::HandleForceSpeedChangeAckOpcodes(WorldPacket& recv_data)
@@ -39,7 +39,6 @@ PathFinder::PathFinder(const Unit* owner) :
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
     }
 
     createFilter();
@@ -74,6 +73,10 @@ bool PathFinder::calculate(const Vector3& start, const Vector3& dest, bool force
 
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
 
+    // the query is checked out for this calculation only, so paths can be built from any thread
+    MMAP::PooledNavMeshQuery query(m_navMesh ? MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQueryPool(m_sourceUnit->GetMapId()) : nullptr);
+    m_navMeshQuery = query.get();
+
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
     if (!m_navMesh || !m_navMeshQuery || m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING) ||
@@ -81,12 +84,14 @@ bool PathFinder::calculate(const Vector3& start, const Vector3& dest, bool force
     {
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        m_navMeshQuery = nullptr;
         return true;
     }
 
     updateFilter();
 
     BuildPolyPath(start, dest);
+    m_navMeshQuery = nullptr;
     return true;
 }
 
@@ -372,15 +377,22 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // free and invalidate old path data
         clear();
 
-        dtResult = m_navMeshQuery->findPath(
-                       startPoly,          // start polygon
-                       endPoly,            // end polygon
-                       startPoint,         // start position
-                       endPoint,           // end position
-                       &m_filter,           // polygon search filter
-                       m_pathPolyRefs,     // [out] path
-                       (int*)&m_polyLength,
-                       MAX_PATH_LENGTH);   // max number of polygons in output path
+        // crowds of patrols and returning creatures walk the same routes, reuse complete paths of earlier searches
+        MMAP::PathCache* pathCache = MMAP::MMapFactory::createOrGetMMapManager()->GetPathCache(m_sourceUnit->GetMapId());
+        MMAP::PathCache::Key const cacheKey(startPoly, endPoly, m_filter.getIncludeFlags(), m_filter.getExcludeFlags());
+        bool const cached = pathCache && pathCache->Get(cacheKey, m_pathPolyRefs, m_polyLength, MAX_PATH_LENGTH);
+        if (cached)
+            dtResult = DT_SUCCESS;
+        else
+            dtResult = m_navMeshQuery->findPath(
+                           startPoly,          // start polygon
+                           endPoly,            // end polygon
+                           startPoint,         // start position
+                           endPoint,           // end position
+                           &m_filter,           // polygon search filter
+                           m_pathPolyRefs,     // [out] path
+                           (int*)&m_polyLength,
+                           MAX_PATH_LENGTH);   // max number of polygons in output path
 
         if (!m_polyLength || dtStatusFailed(dtResult))
         {
@@ -390,6 +402,9 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
             m_type = PATHFIND_NOPATH;
             return;
         }
+
+        if (pathCache && !cached && m_pathPolyRefs[m_polyLength - 1] == endPoly && !dtStatusDetail(dtResult, DT_PARTIAL_RESULT))
+            pathCache->Add(cacheKey, m_pathPolyRefs, m_polyLength);
     }
 
     // by now we know what type of path we can get
@@ -100,7 +100,7 @@ class PathFinder
 
         const Unit* const       m_sourceUnit;       // the unit that is moving
         const dtNavMesh*        m_navMesh;          // the nav mesh
-        const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
+        const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path, set during calculate() only
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
@@ -265,8 +265,6 @@ bool TaxiMovementGenerator::Update(Unit& unit, const uint32& diff)
     return (movement || Resume(player));
 }
 
-#define TAXI_FLIGHT_SPEED        32.0f
-
 bool TaxiMovementGenerator::Move(Unit& unit)
 {
     Movement::MoveSplineInit init(unit);
@@ -292,17 +290,13 @@ bool TaxiMovementGenerator::Resume(Unit& unit)
 
         // Load and execute the spline (transitional populating the parent movegen: to be reworked in the future)
 
-        auto nodes = player.GetTaxiPathSpline();
+        // Spline points are resolved once per itinerary and shared between all rides of it
+        m_spline = player.GetTaxiPathSplinePoints();
         m_path.clear();
-        m_spline.clear();
-        m_path.reserve(nodes.size());
-        m_spline.reserve(nodes.size());
+        m_path.reserve(m_spline.size());
 
-        for (auto itr = nodes.begin(); itr != nodes.end(); ++itr)
-        {
-            m_path.push_back({ (*itr)->x, (*itr)->y, (*itr)->z , 0, 0, 0});
-            m_spline.push_back({ (*itr)->x, (*itr)->y, (*itr)->z });
-        }
+        for (auto itr = m_spline.begin(); itr != m_spline.end(); ++itr)
+            m_path.push_back({ itr->x, itr->y, itr->z , 0, 0, 0});
 
         m_pathIndex = player.GetTaxiPathSplineOffset();
     }
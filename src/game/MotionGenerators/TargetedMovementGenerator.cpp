@@ -192,6 +192,13 @@ void ChaseMovementGenerator::HandleTargetedMovement(Unit& owner, const uint32& t
 
         if (this->i_speedChanged || targetMoved)
         {
+            // keep the current spline, the path is built in one of the next updates
+            if (!owner.GetMap()->ConsumePathBudget())
+            {
+                this->i_recheckDistance.Reset(0);
+                return;
+            }
+
             float x, y, z;
 
             // i_path can be nullptr in case this is the first call for this MMGen (via Update)
@@ -282,6 +282,29 @@ void WaypointManager::Load()
     }
 }
 
+bool WaypointManager::GetSegmentPath(uint32 mapId, WaypointPath const* path, uint32 pointId, Movement::PointsArray& points) const
+{
+    std::lock_guard<std::mutex> guard(m_segmentLock);
+    auto itr = m_segmentPaths.find(SegmentKey{ mapId, path, pointId });
+    if (itr == m_segmentPaths.end())
+        return false;
+
+    points = itr->second;
+    return true;
+}
+
+void WaypointManager::SetSegmentPath(uint32 mapId, WaypointPath const* path, uint32 pointId, Movement::PointsArray const& points)
+{
+    std::lock_guard<std::mutex> guard(m_segmentLock);
+    m_segmentPaths[SegmentKey{ mapId, path, pointId }] = points;
+}
+
+void WaypointManager::ClearSegmentPaths()
+{
+    std::lock_guard<std::mutex> guard(m_segmentLock);
+    m_segmentPaths.clear();
+}
+
 /// Insert a node into the storage for external access
 bool WaypointManager::AddExternalNode(uint32 entry, int32 pathId, uint32 pointId, float x, float y, float z, float o, uint32 waittime, uint32 scriptId)
 {
@@ -298,6 +321,7 @@ bool WaypointManager::AddExternalNode(uint32 entry, int32 pathId, uint32 pointId
     }
 
     m_externalPathTemplateMap[(entry << 8) + pathId][pointId] = WaypointNode(x, y, z, o, waittime, scriptId);
+    ClearSegmentPaths();
     return true;
 }
 
@@ -338,6 +362,7 @@ WaypointNode const* WaypointManager::AddNode(uint32 entry, uint32 dbGuid, uint32
 
     // Insert new or remaining
     path[nextPoint] = temp;
+    ClearSegmentPaths();
 
     uint32 key = wpDest == PATH_FROM_GUID ? dbGuid : entry;
 
@@ -380,6 +405,7 @@ void WaypointManager::DeleteNode(uint32 entry, uint32 dbGuid, uint32 point, uint
         WorldDatabase.PExecuteLog("DELETE FROM %s WHERE %s=%u AND point=%u", table, key_field, key, point);
 
     path->erase(point);
+    ClearSegmentPaths();
 }
 
 void WaypointManager::DeletePath(uint32 id)
@@ -388,6 +414,7 @@ void WaypointManager::DeletePath(uint32 id)
     WaypointPathMap::iterator itr = m_pathMap.find(id);
     if (itr != m_pathMap.end())
         itr->second.clear();
+    ClearSegmentPaths();
     // the path is not removed from the map, just cleared
     // WMGs have pointers to the path, so deleting them would crash
     // this wastes some memory, but these functions are
@@ -418,6 +445,7 @@ void WaypointManager::SetNodePosition(uint32 entry, uint32 dbGuid, uint32 point,
         find->second.x = x;
         find->second.y = y;
         find->second.z = z;
+        ClearSegmentPaths();
     }
 }
 
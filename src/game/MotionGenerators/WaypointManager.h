@@ -20,6 +20,10 @@
 #define MANGOS_WAYPOINTMANAGER_H
 
 #include "Common.h"
+#include "Movement/MoveSplineInitArgs.h"
+
+#include <map>
+#include <mutex>
 
 enum WaypointPathOrigin
 {
@@ -114,6 +118,12 @@ class WaypointManager
 
         void DeletePath(uint32 id);
 
+        // Navmesh paths of the segments between two nodes, built by the first creature that walks a segment from its start node
+        // and reused by every later walk of any creature on the path. Changing a path clears them.
+        bool GetSegmentPath(uint32 mapId, WaypointPath const* path, uint32 pointId, Movement::PointsArray& points) const;
+        void SetSegmentPath(uint32 mapId, WaypointPath const* path, uint32 pointId, Movement::PointsArray const& points);
+        void ClearSegmentPaths();
+
         /// Set external source table
         void SetExternalWPTable(char const* tableName) { m_externalTable = std::string(tableName); }
         std::string GetExternalWPTable() const { return m_externalTable; }
@@ -175,6 +185,26 @@ class WaypointManager
         WaypointPathMap m_pathTemplateMap;
         WaypointPathMap m_externalPathTemplateMap;
         std::string m_externalTable;
+
+        struct SegmentKey
+        {
+            uint32 mapId;
+            WaypointPath const* path;
+            uint32 pointId;                                 // end node of the segment
+
+            bool operator<(SegmentKey const& other) const
+            {
+                if (path != other.path)
+                    return path < other.path;
+                if (pointId != other.pointId)
+                    return pointId < other.pointId;
+                return mapId < other.mapId;
+            }
+        };
+
+        // maps update in parallel, so the segments are shared under a lock
+        mutable std::mutex m_segmentLock;
+        std::map<SegmentKey, Movement::PointsArray> m_segmentPaths;
 };
 
 #define sWaypointMgr MaNGOS::Singleton<WaypointManager>::Instance()
@@ -28,6 +28,9 @@
 
 #include <cassert>
 
+// distance to the reached node within which a walk to the next node still starts at the segment start
+static float const SEGMENT_START_DISTANCE = 1.0f;
+
 //-----------------------------------------------//
 void WaypointMovementGenerator<Creature>::LoadPath(Creature& creature, int32 pathId, WaypointPathOrigin wpOrigin, uint32 overwriteEntry)
 {
@@ -145,8 +148,14 @@ void WaypointMovementGenerator<Creature>::StartMove(Creature& creature)
     WaypointPath::const_iterator currPoint = i_path->find(i_currentNode);
     MANGOS_ASSERT(currPoint != i_path->end());
 
+    // a walk from the node just reached can use the shared path of the segment
+    bool fromNode = false;
+
     if (m_isArrivalDone)
     {
+        WaypointNode const& reachedNode = currPoint->second;
+        fromNode = !creature.GetTransportInfo() && creature.IsWithinDist3d(reachedNode.x, reachedNode.y, reachedNode.z, SEGMENT_START_DISTANCE);
+
         bool reachedLast = false;
         ++currPoint;
         if (currPoint == i_path->end())
@@ -179,7 +188,20 @@ void WaypointMovementGenerator<Creature>::StartMove(Creature& creature)
 
     WaypointNode const& nextNode = currPoint->second;
     Movement::MoveSplineInit init(creature);
-    init.MoveTo(nextNode.x, nextNode.y, nextNode.z, true);
+
+    Movement::PointsArray segment;
+    if (fromNode && sWaypointMgr.GetSegmentPath(creature.GetMapId(), i_path, i_currentNode, segment))
+        init.MovebyPath(segment);
+    else
+    {
+        PathFinder path(&creature);
+        path.calculate(nextNode.x, nextNode.y, nextNode.z);
+        init.MovebyPath(path.getPath());
+
+        // incomplete or shortcut paths depend on where the creature stands, only full navmesh paths are shared
+        if (fromNode && path.getPathType() == PATHFIND_NORMAL)
+            sWaypointMgr.SetSegmentPath(creature.GetMapId(), i_path, i_currentNode, path.getPath());
+    }
 
     if (nextNode.orientation != 100 && nextNode.delay != 0)
         init.SetFacing(nextNode.orientation);
@@ -19,6 +19,7 @@
 #include "MoveSpline.h"
 #include <sstream>
 #include "Log.h"
+#include "packet_builder.h"
 #include "Entities/Unit.h"
 
 namespace Movement
@@ -36,13 +37,10 @@ namespace Movement
         if (seg_time > 0)
             u = (time_passed - spline.length(point_Idx)) / (float)seg_time;
         Location c;
-        spline.evaluate_percent(point_Idx, u, c);
-
-        if (splineflags.falling)
-            computeFallElevation(c.z);
-
         if (splineflags.done && splineflags.isFacing())
         {
+            spline.evaluate_percent(point_Idx, u, c);
+
             if (splineflags.final_angle)
                 c.orientation = facing.angle;
             else if (splineflags.final_point)
@@ -52,9 +50,13 @@ namespace Movement
         else
         {
             Vector3 hermite;
-            spline.evaluate_derivative(point_Idx, u, hermite);
+            spline.evaluate_percent_and_derivative(point_Idx, u, c, hermite);
             c.orientation = atan2(hermite.y, hermite.x);
         }
+
+        if (splineflags.falling)
+            computeFallElevation(c.z);
+
         return c;
     }
 
@@ -145,6 +147,7 @@ namespace Movement
         m_Id = args.splineId;
         point_Idx_offset = args.path_Idx_offset;
         time_passed = 0;
+        createData.clear();
 
         // detect Stop command
         if (splineflags.done)
@@ -154,9 +157,12 @@ namespace Movement
         }
 
         init_spline(args);
+
+        // every player that sees this unit later on gets the same path, serialize it only once
+        createDataTimePos = PacketBuilder::WriteCreateData(*this, createData);
     }
 
-    MoveSpline::MoveSpline() : m_Id(0), speed(0), time_passed(0), point_Idx(0), point_Idx_offset(0)
+    MoveSpline::MoveSpline() : m_Id(0), speed(0), time_passed(0), point_Idx(0), point_Idx_offset(0), createData(0), createDataTimePos(0)
     {
         splineflags.done = true;
     }
@@ -21,6 +21,7 @@
 
 #include "spline.h"
 #include "Movement/MoveSplineInitArgs.h"
+#include "ByteBuffer.h"
 
 namespace Movement
 {
@@ -75,6 +76,11 @@ namespace Movement
             int32           point_Idx;
             int32           point_Idx_offset;
 
+            // movement block of the create packets for this launch, built once in Initialize
+            // only the flags and the passed time change afterwards and are patched in PacketBuilder::WriteCreate
+            ByteBuffer      createData;
+            uint32          createDataTimePos;
+
             void init_spline(const MoveSplineInitArgs& args);
         protected:
 
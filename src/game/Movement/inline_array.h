@@ -0,0 +1,105 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_INLINE_ARRAY_H
+#define MANGOSSERVER_INLINE_ARRAY_H
+
+#include "typedefs.h"
+
+#include <algorithm>
+
+namespace Movement
+{
+    /** Array with room for N elements inside the object, only larger sizes allocate.
+        Most splines have a handful of points, so every unit keeps its spline without a heap block.
+        Like std::vector, clear() and shrinking resize() keep the capacity and growing resize() value-initializes new elements. */
+    template<class T, int N>
+    class inline_array
+    {
+        public:
+            typedef T value_type;
+            typedef T* iterator;
+            typedef const T* const_iterator;
+
+            inline_array() : m_data(m_inline), m_size(0), m_capacity(N) {}
+
+            inline_array(const inline_array& other) : m_data(m_inline), m_size(0), m_capacity(N)
+            {
+                *this = other;
+            }
+
+            ~inline_array()
+            {
+                if (m_data != m_inline)
+                    delete[] m_data;
+            }
+
+            inline_array& operator=(const inline_array& other)
+            {
+                if (this != &other)
+                {
+                    clear();
+                    resize(other.m_size);
+                    std::copy(other.begin(), other.end(), m_data);
+                }
+                return *this;
+            }
+
+            void resize(size_t size)
+            {
+                if (size > m_capacity)
+                {
+                    T* data = new T[size];
+                    std::copy(m_data, m_data + m_size, data);
+                    if (m_data != m_inline)
+                        delete[] m_data;
+                    m_data = data;
+                    m_capacity = size;
+                }
+
+                for (size_t i = m_size; i < size; ++i)
+                    m_data[i] = T();
+                m_size = size;
+            }
+
+            void clear() { m_size = 0; }
+
+            size_t size() const { return m_size; }
+            size_t capacity() const { return m_capacity; }
+            bool empty() const { return m_size == 0; }
+
+            T& operator[](size_t i) { return m_data[i]; }
+            const T& operator[](size_t i) const { return m_data[i]; }
+
+            T* data() { return m_data; }
+            const T* data() const { return m_data; }
+
+            iterator begin() { return m_data; }
+            iterator end() { return m_data + m_size; }
+            const_iterator begin() const { return m_data; }
+            const_iterator end() const { return m_data + m_size; }
+
+        private:
+            T* m_data;
+            size_t m_size;
+            size_t m_capacity;
+            T m_inline[N];
+    };
+}
+
+#endif // MANGOSSERVER_INLINE_ARRAY_H
@@ -122,37 +122,56 @@ namespace Movement
             WriteLinearPath(spline, data);
     }
 
+    uint32 PacketBuilder::WriteCreateData(const MoveSpline& move_spline, ByteBuffer& data)
+    {
+        size_t startPos = data.wpos();
+        MoveSplineFlag splineFlags = move_spline.splineflags;
+
+        data << splineFlags.raw();
+
+        if (splineFlags.final_angle)
+        {
+            data << move_spline.facing.angle;
+        }
+        else if (splineFlags.final_target)
+        {
+            data << move_spline.facing.target;
+        }
+        else if (splineFlags.final_point)
+        {
+            data << move_spline.facing.f.x << move_spline.facing.f.y << move_spline.facing.f.z;
+        }
+
+        uint32 timePos = data.wpos() - startPos;
+        data << move_spline.timePassed();
+        data << move_spline.Duration();
+        data << move_spline.GetId();
+
+        uint32 nodes = move_spline.getPath().size();
+        data << nodes;
+        data.append<Vector3>(move_spline.getPath().data(), nodes);
+        data << (move_spline.isCyclic() ? Vector3::zero() : move_spline.FinalDestination());
+
+        return timePos;
+    }
+
     void PacketBuilder::WriteCreate(const MoveSpline& move_spline, ByteBuffer& data)
     {
         // WriteClientStatus(mov,data);
         // data.append<float>(&mov.m_float_values[SpeedWalk], SpeedMaxCount);
         // if (mov.SplineEnabled())
         {
-            MoveSplineFlag splineFlags = move_spline.splineflags;
-
-            data << splineFlags.raw();
-
-            if (splineFlags.final_angle)
+            if (move_spline.createData.empty())
             {
-                data << move_spline.facing.angle;
+                WriteCreateData(move_spline, data);
+                return;
             }
-            else if (splineFlags.final_target)
-            {
-                data << move_spline.facing.target;
-            }
-            else if (splineFlags.final_point)
-            {
-                data << move_spline.facing.f.x << move_spline.facing.f.y << move_spline.facing.f.z;
-            }
-
-            data << move_spline.timePassed();
-            data << move_spline.Duration();
-            data << move_spline.GetId();
 
-            uint32 nodes = move_spline.getPath().size();
-            data << nodes;
-            data.append<Vector3>(&move_spline.getPath()[0], nodes);
-            data << (move_spline.isCyclic() ? Vector3::zero() : move_spline.FinalDestination());
+            // the block was serialized on launch, only bring the flags and the passed time up to date
+            size_t startPos = data.wpos();
+            data.append(move_spline.createData);
+            data.put<uint32>(startPos, move_spline.splineflags.raw());
+            data.put<uint32>(startPos + move_spline.createDataTimePos, move_spline.timePassed());
         }
     }
 }
@@ -19,6 +19,8 @@
 #ifndef MANGOSSERVER_PACKET_BUILDER_H
 #define MANGOSSERVER_PACKET_BUILDER_H
 
+#include "typedefs.h"
+
 class ByteBuffer;
 class WorldPacket;
 
@@ -32,6 +34,8 @@ namespace Movement
 
             static void WriteMonsterMove(const MoveSpline& move_spline, WorldPacket& data);
             static void WriteCreate(const MoveSpline& move_spline, ByteBuffer& data);
+            /** Writes the whole movement block of create packets, returns the offset of the passed time within it. */
+            static uint32 WriteCreateData(const MoveSpline& move_spline, ByteBuffer& data);
     };
 }
 #endif // MANGOSSERVER_PACKET_BUILDER_H
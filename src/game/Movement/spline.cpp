@@ -38,6 +38,14 @@ namespace Movement
         (EvaluationMethtod)& SplineBase::UninitializedSpline,
     };
 
+    SplineBase::EvaluationWithDerivativeMethtod SplineBase::with_derivative_evaluators[SplineBase::ModesEnd] =
+    {
+        &SplineBase::EvaluateWithDerivativeLinear,
+        &SplineBase::EvaluateWithDerivativeCatmullRom,
+        &SplineBase::EvaluateWithDerivativeBezier3,
+        (EvaluationWithDerivativeMethtod)& SplineBase::UninitializedSpline,
+    };
+
     SplineBase::SegLenghtMethtod SplineBase::seglengths[SplineBase::ModesEnd] =
     {
         &SplineBase::SegLengthLinear,
@@ -113,6 +121,24 @@ namespace Movement
                  + vertice[2] * weights[2] + vertice[3] * weights[3];
     }
 
+    // both weight sets from one pass over the matrix, inline instead of two out of line Vector4 * Matrix4 products
+    inline void C_Evaluate_With_Derivative(const Vector3* vertice, float t, const Matrix4& matr, Vector3& result, Vector3& derivative)
+    {
+        float t2 = t * t;
+        float t3 = t2 * t;
+
+        result = Vector3::zero();
+        derivative = Vector3::zero();
+        for (int i = 0; i < 4; ++i)
+        {
+            float weight = t3 * matr[0][i] + t2 * matr[1][i] + t * matr[2][i] + matr[3][i];
+            float derivativeWeight = 3.f * t2 * matr[0][i] + 2.f * t * matr[1][i] + matr[2][i];
+
+            result += vertice[i] * weight;
+            derivative += vertice[i] * derivativeWeight;
+        }
+    }
+
     void SplineBase::EvaluateLinear(index_type index, float u, Vector3& result) const
     {
         MANGOS_ASSERT(index >= index_lo && index < index_hi);
@@ -151,6 +177,26 @@ namespace Movement
         C_Evaluate_Derivative(&points[index], t, s_Bezier3Coeffs, result);
     }
 
+    void SplineBase::EvaluateWithDerivativeLinear(index_type index, float u, Vector3& result, Vector3& derivative) const
+    {
+        MANGOS_ASSERT(index >= index_lo && index < index_hi);
+        derivative = points[index + 1] - points[index];
+        result = points[index] + derivative * u;
+    }
+
+    void SplineBase::EvaluateWithDerivativeCatmullRom(index_type index, float t, Vector3& result, Vector3& derivative) const
+    {
+        MANGOS_ASSERT(index >= index_lo && index < index_hi);
+        C_Evaluate_With_Derivative(&points[index - 1], t, s_catmullRomCoeffs, result, derivative);
+    }
+
+    void SplineBase::EvaluateWithDerivativeBezier3(index_type index, float t, Vector3& result, Vector3& derivative) const
+    {
+        index *= 3u;
+        MANGOS_ASSERT(index >= index_lo && index < index_hi);
+        C_Evaluate_With_Derivative(&points[index], t, s_Bezier3Coeffs, result, derivative);
+    }
+
     float SplineBase::SegLengthLinear(index_type index) const
     {
         MANGOS_ASSERT(index >= index_lo && index < index_hi);
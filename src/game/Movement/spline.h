@@ -20,6 +20,7 @@
 #define MANGOSSERVER_SPLINE_H
 
 #include "typedefs.h"
+#include "inline_array.h"
 #include <G3D/Vector3.h>
 
 namespace Movement
@@ -28,7 +29,13 @@ namespace Movement
     {
         public:
             typedef int index_type;
-            typedef std::vector<Vector3> ControlArray;
+
+            enum
+            {
+                // points held without heap allocation, covers paths of up to 8 nodes with the virtual points of a cyclic catmullrom spline
+                INLINE_POINTS = 12,
+            };
+            typedef inline_array<Vector3, INLINE_POINTS> ControlArray;
 
             enum EvaluationMode
             {
@@ -70,6 +77,12 @@ namespace Movement
             void EvaluateDerivativeBezier3(index_type, float, Vector3&) const;
             static EvaluationMethtod derivative_evaluators[ModesEnd];
 
+            void EvaluateWithDerivativeLinear(index_type, float, Vector3&, Vector3&) const;
+            void EvaluateWithDerivativeCatmullRom(index_type, float, Vector3&, Vector3&) const;
+            void EvaluateWithDerivativeBezier3(index_type, float, Vector3&, Vector3&) const;
+            typedef void (SplineBase::*EvaluationWithDerivativeMethtod)(index_type, float, Vector3&, Vector3&) const;
+            static EvaluationWithDerivativeMethtod with_derivative_evaluators[ModesEnd];
+
             float SegLengthLinear(index_type) const;
             float SegLengthCatmullRom(index_type) const;
             float SegLengthBezier3(index_type) const;
@@ -100,6 +113,12 @@ namespace Movement
              */
             void evaluate_derivative(index_type Idx, float u, Vector3& hermite) const {(this->*derivative_evaluators[m_mode])(Idx, u, hermite);}
 
+            /** Same as evaluate_percent and evaluate_derivative, sharing the powers of u and the control points between both
+                @param Idx - spline segment index, should be in range [first, last)
+                @param u  - percent of spline segment length, assumes that u in range [0, 1]
+             */
+            void evaluate_percent_and_derivative(index_type Idx, float u, Vector3& c, Vector3& hermite) const {(this->*with_derivative_evaluators[m_mode])(Idx, u, c, hermite);}
+
             /**  Bounds for spline indexes. All indexes should be in range [first, last). */
             index_type first() const { return index_lo;}
             index_type last()  const { return index_hi;}
@@ -136,7 +155,7 @@ namespace Movement
     {
         public:
             typedef length_type LengthType;
-            typedef std::vector<length_type> LengthArray;
+            typedef inline_array<length_type, INLINE_POINTS> LengthArray;
         protected:
 
             LengthArray lengths;
@@ -164,6 +183,8 @@ namespace Movement
                 @param t  - percent of spline segment length, assumes that t in range [0, 1]. */
             void evaluate_derivative(index_type Idx, float u, Vector3& c) const { SplineBase::evaluate_derivative(Idx, u, c);}
 
+            void evaluate_percent_and_derivative(index_type Idx, float u, Vector3& c, Vector3& hermite) const { SplineBase::evaluate_percent_and_derivative(Idx, u, c, hermite);}
+
             // Assumes that t in range [0, 1]
             index_type computeIndexInBounds(float t) const;
             void computeIndex(float t, index_type& out_idx, float& out_u) const;
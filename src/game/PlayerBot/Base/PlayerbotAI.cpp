@@ -98,6 +98,9 @@ PlayerbotAI::PlayerbotAI(PlayerbotMgr* const mgr, Player* const bot) :
     // set bot state
     m_botState = BOTSTATE_LOADING;
 
+    m_updatePhase = urand(0, IN_MILLISECONDS - 1);
+    m_idleUpdate = false;
+
     // reset some pointers
     m_targetChanged = false;
     m_targetType = TARGET_NORMAL;
@@ -4458,7 +4461,7 @@ void PlayerbotAI::UpdateAttackerInfo()
             continue;
         Unit* a = itr->second.attacker;
         float t = 0.00;
-        std::list<HostileReference*>::const_iterator i = a->getThreatManager().getThreatList().begin();
+        ThreatList::const_iterator i = a->getThreatManager().getThreatList().begin();
         for (; i != a->getThreatManager().getThreatList().end(); ++i)
         {
             if ((*i)->getThreat() > t && (*i)->getTarget() != m_bot)
@@ -5062,11 +5065,28 @@ void PlayerbotAI::UpdateAI(const uint32 /*p_time*/)
     if (GetClassAI()->GetWaitUntil() <= CurrentTime())
         GetClassAI()->ClearWait();
 
-    if (CurrentTime() < m_ignoreAIUpdatesUntilTime)
+    // the bots decide at their own point of the second their wait ends in, so they do not all run in the same update
+    bool wakeUp = m_idleUpdate && (m_bot->isInCombat() || (GetMaster() && GetMaster()->isInCombat()));
+    if (!wakeUp && World::GetCurrentClockTime().time_since_epoch().count() < int64(m_ignoreAIUpdatesUntilTime) * IN_MILLISECONDS + m_updatePhase)
+        return;
+
+    if (!PlayerbotMgr::CanStartDecision(m_bot->GetMap()))
         return;
 
-    // default updates occur every two seconds
-    SetIgnoreUpdateTime(2);
+    struct DecisionTimer
+    {
+        DecisionTimer(Map const* map) : map(map), start(std::chrono::steady_clock::now()) {}
+        ~DecisionTimer() { PlayerbotMgr::FinishDecision(map, std::chrono::steady_clock::now() - start); }
+
+        Map const* map;
+        std::chrono::steady_clock::time_point start;
+    } decisionTimer(m_bot->GetMap());
+
+    // default updates occur every two seconds, bots with nothing to do wait the idle interval
+    bool idle = m_botState == BOTSTATE_NORMAL && !m_bot->isInCombat() && !(GetMaster() && GetMaster()->isInCombat()) &&
+                m_lootTargets.empty() && m_findNPC.empty();
+    SetIgnoreUpdateTime(idle ? PlayerbotMgr::GetIdleUpdateInterval() : 2);
+    m_idleUpdate = idle && PlayerbotMgr::GetIdleUpdateInterval() > 2;
 
     if (m_botState == BOTSTATE_LOADING)
     {
@@ -9197,6 +9217,7 @@ void PlayerbotAI::_HandleCommandMail(std::string& text, Player& fromPlayer)
             uint8 item_count = (*itr)->items.size(); // max count is MAX_MAIL_ITEMS (12)
             if (item_count > 0)
             {
+                m_bot->LoadMailedItemsIfNeeded();
                 msg << "Items: ";
                 for (uint8 i = 0; i < item_count; ++i)
                 {
@@ -9281,6 +9302,7 @@ void PlayerbotAI::_HandleCommandMail(std::string& text, Player& fromPlayer)
 
             if (m->HasItems())
             {
+                m_bot->LoadMailedItemsIfNeeded();
                 bool has_items = true;
                 std::ostringstream msg;
 
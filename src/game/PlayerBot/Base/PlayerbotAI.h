@@ -575,7 +575,7 @@ class PlayerbotAI
         Unit* GetCurrentTarget() { return m_targetCombat; };
         void DoNextCombatManeuver();
         void DoCombatMovement();
-        void SetIgnoreUpdateTime(uint8 t = 0) { m_ignoreAIUpdatesUntilTime = time(nullptr) + t; };
+        void SetIgnoreUpdateTime(uint8 t = 0) { m_ignoreAIUpdatesUntilTime = time(nullptr) + t; m_idleUpdate = false; };
         time_t CurrentTime() { return time(nullptr); };
 
         Player* GetPlayerBot() const { return m_bot; }
@@ -728,6 +728,8 @@ class PlayerbotAI
         // ignores AI updates until time specified
         // no need to waste CPU cycles during casting etc
         time_t m_ignoreAIUpdatesUntilTime;
+        uint32 m_updatePhase;                               // ms into the second the decisions of this bot happen, spreads the bots
+        bool m_idleUpdate;                                  // waiting the idle interval, combat ends the wait
 
         CombatStyle m_combatStyle;
         CombatOrderType m_combatOrder;
@@ -48,36 +48,138 @@ void PlayerbotMgr::SetInitialWorldSettings()
     //Check playerbot config file version
     if (botConfig.GetIntDefault("ConfVersion", 0) != PLAYERBOT_CONF_VERSION)
         sLog.outError("Playerbot: Configuration file version doesn't match expected version. Some config variables may be wrong or missing.");
-}
 
-PlayerbotMgr::PlayerbotMgr(Player* const master) : m_master(master)
-{
-    // load config variables
-    m_confMaxNumBots = botConfig.GetIntDefault("PlayerbotAI.MaxNumBots", 9);
-    m_confDebugWhisper = botConfig.GetBoolDefault("PlayerbotAI.DebugWhisper", false);
-    m_confFollowDistance[0] = botConfig.GetFloatDefault("PlayerbotAI.FollowDistanceMin", 0.5f);
-    m_confFollowDistance[1] = botConfig.GetFloatDefault("PlayerbotAI.FollowDistanceMax", 1.0f);
-    m_confCollectCombat = botConfig.GetBoolDefault("PlayerbotAI.Collect.Combat", true);
-    m_confCollectQuest = botConfig.GetBoolDefault("PlayerbotAI.Collect.Quest", true);
-    m_confCollectProfession = botConfig.GetBoolDefault("PlayerbotAI.Collect.Profession", true);
-    m_confCollectLoot = botConfig.GetBoolDefault("PlayerbotAI.Collect.Loot", true);
-    m_confCollectSkin = botConfig.GetBoolDefault("PlayerbotAI.Collect.Skin", true);
-    m_confCollectObjects = botConfig.GetBoolDefault("PlayerbotAI.Collect.Objects", true);
-    m_confCollectDistanceMax = botConfig.GetIntDefault("PlayerbotAI.Collect.DistanceMax", 50);
-    gConfigSellLevelDiff = botConfig.GetIntDefault("PlayerbotAI.SellAll.LevelDiff", 10);
-    if (m_confCollectDistanceMax > 100)
+    Settings& settings = s_settings;
+    settings.disableBots = botConfig.GetBoolDefault("PlayerbotAI.DisableBots", false);
+    settings.debugWhisper = botConfig.GetBoolDefault("PlayerbotAI.DebugWhisper", false);
+    settings.sellGarbage = botConfig.GetBoolDefault("PlayerbotAI.SellGarbage", true);
+    settings.maxNumBots = botConfig.GetIntDefault("PlayerbotAI.MaxNumBots", 9);
+    settings.restrictBotLevel = botConfig.GetIntDefault("PlayerbotAI.RestrictBotLevel", 80);
+    settings.botguyCost = botConfig.GetIntDefault("PlayerbotAI.BotguyCost", 0);
+
+    settings.botguyQuests.clear();
+    for (std::string const& token : StrSplit(botConfig.GetStringDefault("PlayerbotAI.BotguyQuests", ""), ","))
+        if (uint32 questId = atoi(token.c_str()))
+            settings.botguyQuests.push_back(questId);
+
+    settings.followDistance[0] = botConfig.GetFloatDefault("PlayerbotAI.FollowDistanceMin", 0.5f);
+    settings.followDistance[1] = botConfig.GetFloatDefault("PlayerbotAI.FollowDistanceMax", 1.0f);
+    settings.sellLevelDiff = botConfig.GetIntDefault("PlayerbotAI.SellAll.LevelDiff", 10);
+    settings.collectCombat = botConfig.GetBoolDefault("PlayerbotAI.Collect.Combat", true);
+    settings.collectQuest = botConfig.GetBoolDefault("PlayerbotAI.Collect.Quest", true);
+    settings.collectProfession = botConfig.GetBoolDefault("PlayerbotAI.Collect.Profession", true);
+    settings.collectLoot = botConfig.GetBoolDefault("PlayerbotAI.Collect.Loot", true);
+    settings.collectSkin = botConfig.GetBoolDefault("PlayerbotAI.Collect.Skin", true);
+    settings.collectObjects = botConfig.GetBoolDefault("PlayerbotAI.Collect.Objects", true);
+    settings.collectDistanceMax = botConfig.GetIntDefault("PlayerbotAI.Collect.DistanceMax", 50);
+    if (settings.collectDistanceMax > 100)
     {
         sLog.outError("Playerbot: PlayerbotAI.Collect.DistanceMax higher than allowed. Using 100");
-        m_confCollectDistanceMax = 100;
+        settings.collectDistanceMax = 100;
     }
-    m_confCollectDistance = botConfig.GetIntDefault("PlayerbotAI.Collect.Distance", 25);
-    if (m_confCollectDistance > m_confCollectDistanceMax)
+    settings.collectDistance = botConfig.GetIntDefault("PlayerbotAI.Collect.Distance", 25);
+    if (settings.collectDistance > settings.collectDistanceMax)
     {
         sLog.outError("Playerbot: PlayerbotAI.Collect.Distance higher than PlayerbotAI.Collect.DistanceMax. Using DistanceMax value");
-        m_confCollectDistance = m_confCollectDistanceMax;
+        settings.collectDistance = settings.collectDistanceMax;
+    }
+
+    settings.idleUpdateInterval = std::min(std::max(botConfig.GetIntDefault("PlayerbotAI.IdleUpdateInterval", 2), 2), 255);
+    settings.mapUpdateBudget = botConfig.GetIntDefault("PlayerbotAI.MapUpdateBudget", 0);
+}
+
+PlayerbotMgr::Settings PlayerbotMgr::s_settings = PlayerbotMgr::Settings();
+std::atomic<uint64> PlayerbotMgr::s_decisions(0);
+std::atomic<uint64> PlayerbotMgr::s_deferred(0);
+std::atomic<uint64> PlayerbotMgr::s_decisionTotalUs(0);
+std::atomic<uint64> PlayerbotMgr::s_decisionMaxUs(0);
+
+namespace
+{
+    // bot time of the map the thread updates, the bots are updated with their map so one map is counted at a time
+    struct MapDecisionBudget
+    {
+        Map const* map;
+        TimePoint worldTick;
+        std::chrono::steady_clock::duration used;
+    };
+
+    thread_local MapDecisionBudget t_mapBudget = { nullptr, TimePoint(), std::chrono::steady_clock::duration::zero() };
+
+    MapDecisionBudget& GetMapBudget(Map const* map)
+    {
+        // a new world tick or another map starts counting from zero
+        if (t_mapBudget.map != map || t_mapBudget.worldTick != World::GetCurrentClockTime())
+        {
+            t_mapBudget.map = map;
+            t_mapBudget.worldTick = World::GetCurrentClockTime();
+            t_mapBudget.used = std::chrono::steady_clock::duration::zero();
+        }
+        return t_mapBudget;
     }
 }
 
+bool PlayerbotMgr::CanStartDecision(Map const* map)
+{
+    if (!s_settings.mapUpdateBudget)
+        return true;
+
+    if (GetMapBudget(map).used < std::chrono::milliseconds(s_settings.mapUpdateBudget))
+        return true;
+
+    ++s_deferred;
+    return false;
+}
+
+void PlayerbotMgr::FinishDecision(Map const* map, std::chrono::steady_clock::duration duration)
+{
+    if (s_settings.mapUpdateBudget)
+        GetMapBudget(map).used += duration;
+
+    uint64 us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    ++s_decisions;
+    s_decisionTotalUs += us;
+
+    uint64 maxUs = s_decisionMaxUs.load();
+    while (us > maxUs && !s_decisionMaxUs.compare_exchange_weak(maxUs, us)) {}
+}
+
+PlayerbotMgr::DecisionStats PlayerbotMgr::GetDecisionStats()
+{
+    DecisionStats stats;
+    stats.decisions = s_decisions.load();
+    stats.deferred = s_deferred.load();
+    stats.totalUs = s_decisionTotalUs.load();
+    stats.maxUs = s_decisionMaxUs.load();
+    return stats;
+}
+
+void PlayerbotMgr::ResetDecisionStats()
+{
+    s_decisions = 0;
+    s_deferred = 0;
+    s_decisionTotalUs = 0;
+    s_decisionMaxUs = 0;
+}
+
+PlayerbotMgr::PlayerbotMgr(Player* const master) : m_master(master)
+{
+    // config variables, the master can change the collect options of its bots
+    m_confMaxNumBots = s_settings.maxNumBots;
+    m_confDebugWhisper = s_settings.debugWhisper;
+    m_confFollowDistance[0] = s_settings.followDistance[0];
+    m_confFollowDistance[1] = s_settings.followDistance[1];
+    m_confCollectCombat = s_settings.collectCombat;
+    m_confCollectQuest = s_settings.collectQuest;
+    m_confCollectProfession = s_settings.collectProfession;
+    m_confCollectLoot = s_settings.collectLoot;
+    m_confCollectSkin = s_settings.collectSkin;
+    m_confCollectObjects = s_settings.collectObjects;
+    m_confCollectDistanceMax = s_settings.collectDistanceMax;
+    gConfigSellLevelDiff = s_settings.sellLevelDiff;
+    m_confCollectDistance = s_settings.collectDistance;
+}
+
 PlayerbotMgr::~PlayerbotMgr()
 {
     LogoutAllBots();
@@ -619,7 +721,7 @@ void PlayerbotMgr::HandleMasterIncomingPacket(const WorldPacket& packet)
                         case GOSSIP_OPTION_VENDOR:
                         {
                             // bot->GetPlayerbotAI()->TellMaster("PlayerbotMgr:GOSSIP_OPTION_VENDOR");
-                            if (!botConfig.GetBoolDefault("PlayerbotAI.SellGarbage", true))
+                            if (!s_settings.sellGarbage)
                                 continue;
 
                             // changed the SellGarbage() function to support ch.SendSysMessaage()
@@ -667,7 +769,7 @@ void PlayerbotMgr::HandleMasterIncomingPacket(const WorldPacket& packet)
 
         case CMSG_LIST_INVENTORY:
         {
-            if (!botConfig.GetBoolDefault("PlayerbotAI.SellGarbage", true))
+            if (!s_settings.sellGarbage)
                 return;
 
             WorldPacket p(packet);
@@ -954,21 +1056,11 @@ bool Player::getNextQuestId(const std::string& pString, unsigned int& pStartPos,
     return (result);
 }
 
-bool Player::requiredQuests(const char* pQuestIdString)
+bool Player::requiredQuests(std::vector<uint32> const& questIds) const
 {
-    if (pQuestIdString != nullptr)
-    {
-        unsigned int pos = 0;
-        unsigned int id;
-        std::string confString(pQuestIdString);
-        chompAndTrim(confString);
-        while (getNextQuestId(confString, pos, id))
-        {
-            QuestStatus status = GetQuestStatus(id);
-            if (status == QUEST_STATUS_COMPLETE)
-                return true;
-        }
-    }
+    for (uint32 questId : questIds)
+        if (GetQuestStatus(questId) == QUEST_STATUS_COMPLETE)
+            return true;
     return false;
 }
 
@@ -1029,7 +1121,7 @@ bool ChatHandler::HandlePlayerbotCommand(char* args)
 {
     if (!(m_session->GetSecurity() > SEC_PLAYER))
     {
-        if (botConfig.GetBoolDefault("PlayerbotAI.DisableBots", false))
+        if (PlayerbotMgr::GetSettings().disableBots)
         {
             PSendSysMessage("|cffff0000Playerbot system is currently disabled!");
             SetSentErrorMessage(true);
@@ -1037,6 +1129,17 @@ bool ChatHandler::HandlePlayerbotCommand(char* args)
         }
     }
 
+    // decision statistics of all bots, for tuning PlayerbotAI.IdleUpdateInterval and PlayerbotAI.MapUpdateBudget
+    if (m_session && m_session->GetSecurity() > SEC_PLAYER && *args && strcmp(args, "stats") == 0)
+    {
+        PlayerbotMgr::DecisionStats stats = PlayerbotMgr::GetDecisionStats();
+        PSendSysMessage("Bot decisions: " UI64FMTD ", deferred by the map budget: " UI64FMTD, stats.decisions, stats.deferred);
+        PSendSysMessage("Decision time: total " UI64FMTD " ms, average " UI64FMTD " us, max " UI64FMTD " us",
+                        stats.totalUs / 1000, stats.decisions ? stats.totalUs / stats.decisions : 0, stats.maxUs);
+        PlayerbotMgr::ResetDecisionStats();
+        return true;
+    }
+
     if (!m_session)
     {
         PSendSysMessage("|cffff0000You may only add bots from an active session");
@@ -1095,7 +1198,7 @@ bool ChatHandler::HandlePlayerbotCommand(char* args)
     {
         Field* fields = resultchar->Fetch();
         int acctcharcount = fields[0].GetUInt32();
-        int maxnum = botConfig.GetIntDefault("PlayerbotAI.MaxNumBots", 9);
+        int maxnum = PlayerbotMgr::GetSettings().maxNumBots;
         if (!(m_session->GetSecurity() > SEC_PLAYER))
             if (acctcharcount > maxnum && (cmdStr == "add" || cmdStr == "login"))
             {
@@ -1112,7 +1215,7 @@ bool ChatHandler::HandlePlayerbotCommand(char* args)
     {
         Field* fields = resultlvl->Fetch();
         int charlvl = fields[0].GetUInt32();
-        int maxlvl = botConfig.GetIntDefault("PlayerbotAI.RestrictBotLevel", 80);
+        int maxlvl = PlayerbotMgr::GetSettings().restrictBotLevel;
         uint8 race = fields[2].GetUInt8();
         uint32 team = 0;
 
@@ -21,12 +21,17 @@
 
 #include "Common.h"
 
+#include <atomic>
+#include <chrono>
+#include <vector>
+
 class WorldPacket;
 class Player;
 class Unit;
 class Object;
 class Item;
 class PlayerbotClassAI;
+class Map;
 
 typedef std::unordered_map<ObjectGuid, Player*> PlayerBotMap;
 
@@ -36,6 +41,47 @@ class PlayerbotMgr
     public:
         static void SetInitialWorldSettings();
 
+        // decision scheduling shared by all bots, a map update runs bot decisions until PlayerbotAI.MapUpdateBudget is used
+        // bots over the budget retry in the next map update
+        static bool CanStartDecision(Map const* map);
+        static void FinishDecision(Map const* map, std::chrono::steady_clock::duration duration);
+        static uint32 GetIdleUpdateInterval() { return s_settings.idleUpdateInterval; }
+
+        // playerbot.conf values, read once by SetInitialWorldSettings, nothing looks up botConfig keys later
+        struct Settings
+        {
+            bool disableBots;
+            bool debugWhisper;
+            bool sellGarbage;
+            uint32 maxNumBots;
+            uint32 restrictBotLevel;
+            int32 botguyCost;
+            std::vector<uint32> botguyQuests;               // one of them completed unlocks the bot menu, empty for no requirement
+            float followDistance[2];
+            uint32 sellLevelDiff;
+            bool collectCombat;
+            bool collectQuest;
+            bool collectProfession;
+            bool collectLoot;
+            bool collectSkin;
+            bool collectObjects;
+            uint32 collectDistance;
+            uint32 collectDistanceMax;
+            uint32 idleUpdateInterval;                      // seconds between decisions of bots out of combat with nothing to do
+            uint32 mapUpdateBudget;                         // ms of bot decisions per map update, 0 for unlimited
+        };
+        static Settings const& GetSettings() { return s_settings; }
+
+        struct DecisionStats
+        {
+            uint64 decisions;
+            uint64 deferred;
+            uint64 totalUs;
+            uint64 maxUs;
+        };
+        static DecisionStats GetDecisionStats();
+        static void ResetDecisionStats();
+
     public:
         PlayerbotMgr(Player* const master);
         virtual ~PlayerbotMgr();
@@ -85,6 +131,13 @@ class PlayerbotMgr
     private:
         Player* const m_master;
         PlayerBotMap m_playerBots;
+
+        static Settings s_settings;
+
+        static std::atomic<uint64> s_decisions;
+        static std::atomic<uint64> s_deferred;
+        static std::atomic<uint64> s_decisionTotalUs;
+        static std::atomic<uint64> s_decisionMaxUs;
 };
 
 #endif
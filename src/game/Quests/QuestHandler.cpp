@@ -60,7 +60,7 @@ void WorldSession::HandleQuestgiverStatusQueryOpcode(WorldPacket& recv_data)
                 dialogStatus = sScriptDevAIMgr.GetDialogStatus(_player, cr_questgiver);
 
                 if (dialogStatus == DIALOG_STATUS_UNDEFINED)
-                    dialogStatus = getDialogStatus(_player, cr_questgiver, DIALOG_STATUS_NONE);
+                    dialogStatus = _player->GetQuestGiverDialogStatus(cr_questgiver);
             }
             break;
         }
@@ -73,7 +73,7 @@ void WorldSession::HandleQuestgiverStatusQueryOpcode(WorldPacket& recv_data)
                 dialogStatus = sScriptDevAIMgr.GetDialogStatus(_player, go_questgiver);
 
                 if (dialogStatus == DIALOG_STATUS_UNDEFINED)
-                    dialogStatus = getDialogStatus(_player, go_questgiver, DIALOG_STATUS_NONE);
+                    dialogStatus = _player->GetQuestGiverDialogStatus(go_questgiver);
             }
             break;
         }
@@ -163,9 +163,14 @@ void ReputationMgr::SendForceReactions()
     m_player->SendDirectMessage(data);
 }
 
-void ReputationMgr::SendState(FactionState const* faction)
+void ReputationMgr::SendPendingStates()
 {
-    uint32 count = 1;
+    if (!m_statesSendPending)
+        return;
+
+    m_statesSendPending = false;
+
+    uint32 count = 0;
 
     WorldPacket data(SMSG_SET_FACTION_STANDING, (16));      // last check 2.4.0
     data << (float) 0;                                      // refer-a-friend bonus reputation
@@ -173,60 +178,48 @@ void ReputationMgr::SendState(FactionState const* faction)
     size_t p_count = data.wpos();
     data << (uint32) count;                                 // placeholder
 
-    data << (uint32) faction->ReputationListID;
-    data << (uint32) faction->Standing;
-
     for (auto& m_faction : m_factions)
     {
         FactionState& subFaction = m_faction.second;
         if (subFaction.needSend)
         {
             subFaction.needSend = false;
-            if (subFaction.ReputationListID != faction->ReputationListID)
-            {
-                data << uint32(subFaction.ReputationListID);
-                data << uint32(subFaction.Standing);
+            data << uint32(subFaction.ReputationListID);
+            data << uint32(subFaction.Standing);
 
-                ++count;
-            }
+            ++count;
         }
     }
 
+    if (!count)
+        return;
+
     data.put<uint32>(p_count, count);
     m_player->SendDirectMessage(data);
 }
 
 void ReputationMgr::SendInitialReputations()
 {
-    WorldPacket data(SMSG_INITIALIZE_FACTIONS, (4 + 128 * 5));
-    data << uint32(0x00000080);
-
-    RepListID a = 0;
-
+    // 128 records of flags (uint8) and standing (uint32), absent factions stay zero
+    uint8 records[128 * 5] = {};
     for (auto& m_faction : m_factions)
     {
-        // fill in absent fields
-        for (; a != m_faction.first; ++a)
-        {
-            data << uint8(0x00);
-            data << uint32(0x00000000);
-        }
+        if (m_faction.first >= 128)
+            break;
 
-        // fill in encountered data
-        data << uint8(m_faction.second.Flags);
-        data << uint32(m_faction.second.Standing);
+        uint8* record = &records[m_faction.first * 5];
+        uint32 standing = uint32(m_faction.second.Standing);
+        EndianConvert(standing);
 
-        m_faction.second.needSend = false;
+        record[0] = uint8(m_faction.second.Flags);
+        memcpy(record + 1, &standing, sizeof(standing));
 
-        ++a;
+        m_faction.second.needSend = false;
     }
 
-    // fill in absent fields
-    for (; a != 128; ++a)
-    {
-        data << uint8(0x00);
-        data << uint32(0x00000000);
-    }
+    WorldPacket data(SMSG_INITIALIZE_FACTIONS, (4 + sizeof(records)));
+    data << uint32(0x00000080);
+    data.append(records, sizeof(records));
 
     m_player->SendDirectMessage(data);
 }
@@ -338,7 +331,9 @@ void ReputationMgr::SetReputation(FactionEntry const* factionEntry, int32 standi
             anyRankIncreased = true;
 
         // only this faction gets reported to client, even if it has no own visible standing
-        SendState(&faction->second);
+        // the packet is sent at next player update together with the other gains of the tick
+        faction->second.needSend = true;
+        m_statesSendPending = true;
     }
 }
 
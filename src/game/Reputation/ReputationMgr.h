@@ -58,7 +58,7 @@ class QueryResult;
 class ReputationMgr
 {
     public:                                                 // constructors and global modifiers
-        explicit ReputationMgr(Player* owner) : m_player(owner) {}
+        explicit ReputationMgr(Player* owner) : m_player(owner), m_statesSendPending(false) {}
         ~ReputationMgr() {}
 
         void SaveToDB();
@@ -107,7 +107,8 @@ class ReputationMgr
     public:                                                 // senders
         void SendInitialReputations();
         void SendForceReactions();
-        void SendState(FactionState const* faction);
+        // gains of the tick are reported together in one standing packet
+        void SendPendingStates();
 
     private:                                                // internal helper functions
         void Initialize();
@@ -122,6 +123,7 @@ class ReputationMgr
         Player* m_player;
         FactionStateList m_factions;
         ForcedReactions m_forcedReactions;
+        bool m_statesSendPending;
 };
 
 #endif
@@ -0,0 +1,240 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/OpcodeProfiler.h"
+#include "Server/Opcodes.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+std::atomic<bool> OpcodeProfiler::m_enabled(false);
+
+namespace
+{
+    struct ProfileEntry
+    {
+        ProfileEntry() : count(0), bytes(0), totalUs(0), maxUs(0), buckets() {}
+
+        uint64 count;
+        uint64 bytes;
+        uint64 totalUs;
+        uint64 maxUs;
+        uint64 buckets[MAX_OPCODE_PROFILE_BUCKET];
+    };
+
+    struct SessionEntry
+    {
+        SessionEntry() : count(0), bytes(0), totalUs(0), maxUs(0), maxOpcode(0) {}
+
+        uint64 count;
+        uint64 bytes;
+        uint64 totalUs;
+        uint64 maxUs;
+        uint16 maxOpcode;
+    };
+
+    // every thread records into its own table, the lock is only contended while a report is built
+    struct ProfileTable
+    {
+        std::mutex lock;
+        std::unordered_map<uint32, ProfileEntry> entries;   // by path and opcode
+        std::unordered_map<uint32, SessionEntry> sessions;  // by account id
+    };
+
+    std::mutex tablesLock;
+    std::vector<std::shared_ptr<ProfileTable>> tables;      // kept after their thread is gone
+    std::atomic<time_t> resetTime(time(nullptr));
+
+    ProfileTable& GetThreadTable()
+    {
+        static thread_local std::shared_ptr<ProfileTable> table;
+        if (!table)
+        {
+            table = std::make_shared<ProfileTable>();
+            std::lock_guard<std::mutex> guard(tablesLock);
+            tables.push_back(table);
+        }
+        return *table;
+    }
+
+    uint32 MakeKey(OpcodeProfilePath path, uint16 opcode) { return (uint32(path) << 16) | opcode; }
+
+    uint32 GetBucket(uint64 us)
+    {
+        uint32 bucket = 0;
+        for (uint64 limit = 16; bucket < MAX_OPCODE_PROFILE_BUCKET - 1 && us >= limit; limit *= 4)
+            ++bucket;
+        return bucket;
+    }
+
+    char const* const pathNames[MAX_OPCODE_PROFILE_PATH] = { "world", "map", "local" };
+}
+
+void OpcodeProfiler::Record(OpcodeProfilePath path, uint16 opcode, uint32 accountId, size_t bytes, uint64 us)
+{
+    ProfileTable& table = GetThreadTable();
+    std::lock_guard<std::mutex> guard(table.lock);
+
+    ProfileEntry& entry = table.entries[MakeKey(path, opcode)];
+    ++entry.count;
+    entry.bytes += bytes;
+    entry.totalUs += us;
+    entry.maxUs = std::max(entry.maxUs, us);
+    ++entry.buckets[GetBucket(us)];
+
+    SessionEntry& session = table.sessions[accountId];
+    ++session.count;
+    session.bytes += bytes;
+    session.totalUs += us;
+    if (us >= session.maxUs)
+    {
+        session.maxUs = us;
+        session.maxOpcode = opcode;
+    }
+}
+
+void OpcodeProfiler::Reset()
+{
+    std::lock_guard<std::mutex> guard(tablesLock);
+    for (auto const& table : tables)
+    {
+        std::lock_guard<std::mutex> tableGuard(table->lock);
+        table->entries.clear();
+        table->sessions.clear();
+    }
+    resetTime = time(nullptr);
+}
+
+uint32 OpcodeProfiler::GetCollectTime()
+{
+    return uint32(std::max(time_t(1), time(nullptr) - resetTime.load()));
+}
+
+std::vector<OpcodeProfiler::Summary> OpcodeProfiler::GetTopEntries(size_t count)
+{
+    std::unordered_map<uint32, Summary> merged;
+    {
+        std::lock_guard<std::mutex> guard(tablesLock);
+        for (auto const& table : tables)
+        {
+            std::lock_guard<std::mutex> tableGuard(table->lock);
+            for (auto const& itr : table->entries)
+            {
+                Summary& summary = merged[itr.first];
+                if (!summary.count)
+                {
+                    summary.opcode = uint16(itr.first & 0xFFFF);
+                    summary.path = OpcodeProfilePath(itr.first >> 16);
+                }
+                summary.count += itr.second.count;
+                summary.bytes += itr.second.bytes;
+                summary.totalUs += itr.second.totalUs;
+                summary.maxUs = std::max(summary.maxUs, itr.second.maxUs);
+                for (uint32 i = 0; i < MAX_OPCODE_PROFILE_BUCKET; ++i)
+                    summary.buckets[i] += itr.second.buckets[i];
+            }
+        }
+    }
+
+    std::vector<Summary> summaries;
+    summaries.reserve(merged.size());
+    for (auto const& itr : merged)
+        summaries.push_back(itr.second);
+
+    std::sort(summaries.begin(), summaries.end(), [](Summary const& a, Summary const& b) { return a.totalUs > b.totalUs; });
+    if (summaries.size() > count)
+        summaries.resize(count);
+
+    return summaries;
+}
+
+std::vector<OpcodeProfiler::SessionSummary> OpcodeProfiler::GetTopSessions(size_t count)
+{
+    std::unordered_map<uint32, SessionSummary> merged;
+    {
+        std::lock_guard<std::mutex> guard(tablesLock);
+        for (auto const& table : tables)
+        {
+            std::lock_guard<std::mutex> tableGuard(table->lock);
+            for (auto const& itr : table->sessions)
+            {
+                SessionSummary& summary = merged[itr.first];
+                summary.accountId = itr.first;
+                summary.count += itr.second.count;
+                summary.bytes += itr.second.bytes;
+                summary.totalUs += itr.second.totalUs;
+                if (itr.second.maxUs >= summary.maxUs)
+                {
+                    summary.maxUs = itr.second.maxUs;
+                    summary.maxOpcode = itr.second.maxOpcode;
+                }
+            }
+        }
+    }
+
+    std::vector<SessionSummary> summaries;
+    summaries.reserve(merged.size());
+    for (auto const& itr : merged)
+        summaries.push_back(itr.second);
+
+    std::sort(summaries.begin(), summaries.end(), [](SessionSummary const& a, SessionSummary const& b) { return a.totalUs > b.totalUs; });
+    if (summaries.size() > count)
+        summaries.resize(count);
+
+    return summaries;
+}
+
+char const* OpcodeProfiler::GetPathName(OpcodeProfilePath path)
+{
+    return path < MAX_OPCODE_PROFILE_PATH ? pathNames[path] : "unknown";
+}
+
+std::string OpcodeProfiler::GetBucketString(Summary const& summary)
+{
+    std::string buckets;
+    for (uint32 i = 0; i < MAX_OPCODE_PROFILE_BUCKET; ++i)
+    {
+        if (i)
+            buckets += '/';
+        buckets += std::to_string(summary.buckets[i]);
+    }
+    return buckets;
+}
+
+void OpcodeProfiler::LogReport(size_t count)
+{
+    std::vector<Summary> summaries = GetTopEntries(count);
+    if (summaries.empty())
+        return;
+
+    uint32 const seconds = GetCollectTime();
+
+    sLog.outString("Opcode profile of the last %u seconds, top " SIZEFMTD " opcodes by total handler time, calls per 16us/64us/256us/1ms/4ms/16ms/longer:", seconds, summaries.size());
+    for (Summary const& summary : summaries)
+        sLog.outString("%8" PRIu64 " packets %8.1f/s %10" PRIu64 " bytes %8" PRIu64 " ms total avg " UI64FMTD " us max " UI64FMTD " us [%s]: %s (%s)",
+                       summary.count, double(summary.count) / seconds, summary.bytes, summary.totalUs / 1000, summary.totalUs / summary.count, summary.maxUs,
+                       GetBucketString(summary).c_str(), LookupOpcodeName(summary.opcode), GetPathName(summary.path));
+
+    sLog.outString("Top sessions by total handler time:");
+    for (SessionSummary const& session : GetTopSessions(count))
+        sLog.outString("account %u: %8" PRIu64 " packets %8.1f/s %10" PRIu64 " bytes %8" PRIu64 " ms total max " UI64FMTD " us (%s)",
+                       session.accountId, session.count, double(session.count) / seconds, session.bytes, session.totalUs / 1000, session.maxUs, LookupOpcodeName(session.maxOpcode));
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODEPROFILER_H
+#define MANGOS_OPCODEPROFILER_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+enum OpcodeProfilePath
+{
+    OPCODE_PATH_WORLD               = 0,                    // World::UpdateSessions, WorldSessionFilter
+    OPCODE_PATH_MAP                 = 1,                    // Map::Update, MapSessionFilter
+    OPCODE_PATH_SESSION_LOCAL       = 2,                    // parallel part of World::UpdateSessions, SessionLocalFilter
+    MAX_OPCODE_PROFILE_PATH
+};
+
+// handler time buckets, each one four times the previous: <16us, <64us, <256us, <1ms, <4ms, <16ms, longer
+#define MAX_OPCODE_PROFILE_BUCKET 7
+
+// Per opcode rate, size and handler time of the received packets, collected while enabled.
+// Every handler is timed, unlike the spell profiler sampling would hide single expensive packets of abusive clients.
+class OpcodeProfiler
+{
+    public:
+        struct Summary
+        {
+            uint16 opcode;
+            OpcodeProfilePath path;
+            uint64 count;
+            uint64 bytes;
+            uint64 totalUs;
+            uint64 maxUs;
+            uint64 buckets[MAX_OPCODE_PROFILE_BUCKET];
+        };
+
+        struct SessionSummary
+        {
+            uint32 accountId;
+            uint64 count;
+            uint64 bytes;
+            uint64 totalUs;
+            uint64 maxUs;
+            uint16 maxOpcode;                               // opcode of the slowest handler call
+        };
+
+        class Scope
+        {
+            public:
+                Scope(OpcodeProfilePath path, uint16 opcode, uint32 accountId, size_t bytes) : m_enabled(IsEnabled())
+                {
+                    if (m_enabled)
+                    {
+                        m_path = path;
+                        m_opcode = opcode;
+                        m_accountId = accountId;
+                        m_bytes = bytes;
+                        m_start = std::chrono::steady_clock::now();
+                    }
+                }
+                ~Scope()
+                {
+                    if (m_enabled)
+                        Record(m_path, m_opcode, m_accountId, m_bytes, uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count()));
+                }
+
+                Scope(Scope const&) = delete;
+                Scope& operator=(Scope const&) = delete;
+
+            private:
+                bool m_enabled;
+                OpcodeProfilePath m_path;
+                uint16 m_opcode;
+                uint32 m_accountId;
+                size_t m_bytes;
+                std::chrono::steady_clock::time_point m_start;
+        };
+
+        static void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+        static void Reset();
+        // seconds since the last reset, the rates of the reports are based on it
+        static uint32 GetCollectTime();
+
+        // entries ordered by total handler time
+        static std::vector<Summary> GetTopEntries(size_t count);
+        static std::vector<SessionSummary> GetTopSessions(size_t count);
+        static void LogReport(size_t count);
+
+        static char const* GetPathName(OpcodeProfilePath path);
+        static std::string GetBucketString(Summary const& summary);
+
+    private:
+        static void Record(OpcodeProfilePath path, uint16 opcode, uint32 accountId, size_t bytes, uint64 us);
+
+        static std::atomic<bool> m_enabled;
+};
+
+#endif
@@ -23,6 +23,8 @@
 #include "Server/Opcodes.h"
 #include "Server/WorldSession.h"
 
+std::atomic<uint32> opcodeAllocCount[NUM_MSG_TYPES];
+
 /// Correspondence between opcodes and their names
 OpcodeHandler opcodeTable[NUM_MSG_TYPES] =
 {
@@ -24,6 +24,9 @@
 #define _OPCODES_H
 
 #include "Common.h"
+#include "ByteBuffer.h"
+
+#include <atomic>
 
 // Note: this include need for be sure have full definition of class WorldSession
 //       if this class definition not complite then VS for x64 release use different size for
@@ -1136,5 +1139,14 @@ inline const char* LookupOpcodeName(uint16 id)
         return "Received unknown opcode, it's more than max!";
     return opcodeTable[id].name;
 }
+
+/// Number of WorldPackets built per opcode while ByteBuffer allocation tracking is enabled
+extern std::atomic<uint32> opcodeAllocCount[NUM_MSG_TYPES];
+
+inline void CountOpcodeAllocation(uint16 id)
+{
+    if (id < NUM_MSG_TYPES && ByteBuffer::IsTrackingAllocations())
+        opcodeAllocCount[id].fetch_add(1, std::memory_order_relaxed);
+}
 #endif
 /// @}
@@ -0,0 +1,246 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Server/PacketCapture.h"
+#include "Server/Opcodes.h"
+#include "Server/WorldSession.h"
+#include "Entities/Player.h"
+#include "World/World.h"
+#include "Config/Config.h"
+#include "Log.h"
+#include "Policies/Singleton.h"
+
+#include <ctime>
+
+INSTANTIATE_SINGLETON_1(PacketReplayMgr);
+
+std::atomic<bool> PacketCapture::m_enabled(false);
+
+namespace
+{
+    std::mutex s_directoryLock;
+    std::string s_directory;
+
+    // login and logout of the captured character belong to its own session, the replay target is in the world already
+    bool IsReplayed(uint16 opcode)
+    {
+        if (opcode >= NUM_MSG_TYPES)
+            return false;
+
+        switch (opcode)
+        {
+            case CMSG_PLAYER_LOGOUT:
+            case CMSG_LOGOUT_REQUEST:
+            case CMSG_LOGOUT_CANCEL:
+                return false;
+            default:
+                break;
+        }
+
+        SessionStatus status = opcodeTable[opcode].status;
+        return status == STATUS_LOGGEDIN || status == STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT;
+    }
+}
+
+PacketCapture::PacketCapture(FILE* file) : m_file(file), m_start(std::chrono::steady_clock::now())
+{
+}
+
+PacketCapture::~PacketCapture()
+{
+    fclose(m_file);
+}
+
+void PacketCapture::SetDirectory(std::string const& directory)
+{
+    std::lock_guard<std::mutex> guard(s_directoryLock);
+    s_directory = directory;
+    if (!s_directory.empty() && s_directory.back() != '/' && s_directory.back() != '\\')
+        s_directory.append("/");
+}
+
+std::string PacketCapture::GetDirectory()
+{
+    std::lock_guard<std::mutex> guard(s_directoryLock);
+    return s_directory;
+}
+
+std::unique_ptr<PacketCapture> PacketCapture::Create(uint32 accountId)
+{
+    time_t const now = time(nullptr);
+
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "%u_" UI64FMTD ".pkt", accountId, uint64(now));
+    std::string const path = GetDirectory() + fileName;
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outError("PacketCapture: can not create %s, the packets of account %u are not captured", path.c_str(), accountId);
+        return nullptr;
+    }
+
+    ByteBuffer header(20);
+    header << uint32(PACKET_CAPTURE_MAGIC) << uint32(PACKET_CAPTURE_VERSION) << uint32(accountId) << uint64(now);
+    fwrite(header.contents(), 1, header.size(), file);
+
+    DETAIL_LOG("PacketCapture: capturing the packets of account %u to %s", accountId, path.c_str());
+    return std::unique_ptr<PacketCapture>(new PacketCapture(file));
+}
+
+void PacketCapture::Record(WorldPacket const& packet)
+{
+    uint32 const time = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start).count());
+
+    ByteBuffer header(12);
+    header << time << uint32(packet.GetOpcode()) << uint32(packet.size());
+    fwrite(header.contents(), 1, header.size(), m_file);
+    if (!packet.empty())
+        fwrite(packet.contents(), 1, packet.size(), m_file);
+}
+
+bool PacketReplayMgr::Load(std::string const& path, std::vector<CapturedPacket>& packets, std::string& error)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        error = "can not open " + path;
+        return false;
+    }
+
+    uint32 header[5];
+    if (fread(header, sizeof(uint32), 5, file) != 5 || header[0] != PACKET_CAPTURE_MAGIC || header[1] != PACKET_CAPTURE_VERSION)
+    {
+        fclose(file);
+        error = path + " is no packet capture of this version";
+        return false;
+    }
+
+    uint32 firstTime = 0;
+    uint32 record[3];                                       // time, opcode, size
+    while (fread(record, sizeof(uint32), 3, file) == 3)
+    {
+        CapturedPacket packet;
+        packet.opcode = uint16(record[1]);
+        packet.data.resize(record[2]);
+        if (record[2] && fread(&packet.data[0], 1, record[2], file) != record[2])
+            break;                                          // capture cut off by a crash, the complete packets are kept
+
+        if (!IsReplayed(packet.opcode))
+            continue;
+
+        if (packets.empty())
+            firstTime = record[0];
+        packet.time = record[0] - firstTime;
+        packets.push_back(std::move(packet));
+    }
+
+    fclose(file);
+
+    if (packets.empty())
+    {
+        error = path + " holds no packet of a character in the world";
+        return false;
+    }
+
+    return true;
+}
+
+bool PacketReplayMgr::Start(std::string const& fileName, uint32 accountId, float speed, std::string& error)
+{
+    // only names inside the capture directory
+    if (fileName.empty() || fileName.find_first_of("/\\") != std::string::npos || fileName.find("..") != std::string::npos)
+    {
+        error = "invalid capture file name";
+        return false;
+    }
+
+    Replay replay;
+    if (!Load(PacketCapture::GetDirectory() + fileName, replay.packets, error))
+        return false;
+
+    replay.fileName = fileName;
+    replay.next = 0;
+    replay.elapsed = 0.0;
+    replay.speed = speed;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_replays[accountId] = std::move(replay);
+    return true;
+}
+
+bool PacketReplayMgr::Stop(uint32 accountId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_replays.erase(accountId) != 0;
+}
+
+std::vector<PacketReplayMgr::Status> PacketReplayMgr::GetStatus() const
+{
+    std::vector<Status> result;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (auto const& itr : m_replays)
+        result.push_back({ itr.first, itr.second.fileName, itr.second.next, itr.second.packets.size(), itr.second.speed });
+
+    return result;
+}
+
+void PacketReplayMgr::Update(uint32 diff)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    for (auto itr = m_replays.begin(); itr != m_replays.end();)
+    {
+        Replay& replay = itr->second;
+        WorldSession* session = sWorld.FindSession(itr->first);
+        Player* player = session ? session->GetPlayer() : nullptr;
+        if (!player)
+        {
+            sLog.outString("PacketReplay: account %u left the world, replay of %s stopped after " SIZEFMTD " of " SIZEFMTD " packets",
+                           itr->first, replay.fileName.c_str(), replay.next, replay.packets.size());
+            itr = m_replays.erase(itr);
+            continue;
+        }
+
+        // the recorded pace is kept relative to the target, a teleport pauses the replay until it is back in the world
+        if (player->IsInWorld())
+        {
+            replay.elapsed += diff * replay.speed;
+
+            for (; replay.next < replay.packets.size() && replay.packets[replay.next].time <= replay.elapsed; ++replay.next)
+            {
+                CapturedPacket const& captured = replay.packets[replay.next];
+                std::unique_ptr<WorldPacket> packet = session->AllocatePacket(captured.opcode, captured.data.size());
+                if (!captured.data.empty())
+                    packet->append(&captured.data[0], captured.data.size());
+                session->QueuePacket(std::move(packet));
+            }
+        }
+
+        if (replay.next == replay.packets.size())
+        {
+            sLog.outString("PacketReplay: replay of %s to account %u finished, " SIZEFMTD " packets", replay.fileName.c_str(), itr->first, replay.packets.size());
+            itr = m_replays.erase(itr);
+            continue;
+        }
+
+        ++itr;
+    }
+}
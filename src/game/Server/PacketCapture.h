@@ -0,0 +1,115 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_PACKETCAPTURE_H
+#define MANGOS_PACKETCAPTURE_H
+
+#include "Common.h"
+#include "WorldPacket.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define PACKET_CAPTURE_MAGIC   0x544B504D                   // "MPKT"
+#define PACKET_CAPTURE_VERSION 1
+
+// Binary record of the packets a client sent to its session, replayed by PacketReplayMgr for load tests.
+// The file starts with the magic, uint32 version, uint32 account id and uint64 unix start time, followed
+// by uint32 ms since the start, uint32 opcode, uint32 size and the payload of every packet, little endian.
+class PacketCapture
+{
+    public:
+        ~PacketCapture();
+
+        static void SetEnabled(bool enabled) { m_enabled = enabled; }
+        static bool IsEnabled() { return m_enabled; }
+
+        // empty uses the LogsDir
+        static void SetDirectory(std::string const& directory);
+        static std::string GetDirectory();
+
+        // opens <directory>/<account>_<unix time>.pkt, nullptr after logging why it could not be created
+        static std::unique_ptr<PacketCapture> Create(uint32 accountId);
+
+        // called by the network thread of the socket only
+        void Record(WorldPacket const& packet);
+
+    private:
+        explicit PacketCapture(FILE* file);
+
+        FILE* m_file;
+        std::chrono::steady_clock::time_point m_start;
+
+        static std::atomic<bool> m_enabled;
+};
+
+// Queues the logged in packets of a capture to a live session at the recorded pace, scaled by a speed factor.
+// The target session must be in the world, packets that would log it out or need another session state are skipped.
+class PacketReplayMgr
+{
+    public:
+        struct Status
+        {
+            uint32 accountId;
+            std::string fileName;
+            size_t queued;
+            size_t total;
+            float speed;
+        };
+
+        // fileName is looked up in the capture directory, the error is set when it can not be replayed
+        bool Start(std::string const& fileName, uint32 accountId, float speed, std::string& error);
+        bool Stop(uint32 accountId);
+        std::vector<Status> GetStatus() const;
+
+        // world thread, a replay ends once all its packets are queued or its session is gone
+        void Update(uint32 diff);
+
+    private:
+        struct CapturedPacket
+        {
+            uint32 time;                                    // ms since the first replayed packet
+            uint16 opcode;
+            std::vector<uint8> data;
+        };
+
+        struct Replay
+        {
+            std::string fileName;
+            std::vector<CapturedPacket> packets;
+            size_t next;
+            double elapsed;
+            float speed;
+        };
+
+        static bool Load(std::string const& path, std::vector<CapturedPacket>& packets, std::string& error);
+
+        mutable std::mutex m_lock;                          // commands run in map threads too
+        std::map<uint32, Replay> m_replays;                 // by account id
+};
+
+#define sPacketReplayMgr MaNGOS::Singleton<PacketReplayMgr>::Instance()
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/QueryResponseCache.h"
+
+#include <mutex>
+#include <unordered_map>
+
+struct QueryResponseTable
+{
+    std::mutex lock;
+    std::unordered_map<uint64, QueryResponseCache::Response> responses;
+};
+
+static QueryResponseTable s_tables[MAX_QUERY_RESPONSE_TYPES];
+
+// the default locale is -1
+static uint64 MakeKey(uint32 entry, int locale) { return (uint64(entry) << 8) | uint8(locale + 1); }
+
+QueryResponseCache::Response QueryResponseCache::Find(QueryResponseType type, uint32 entry, int locale)
+{
+    QueryResponseTable& table = s_tables[type];
+    std::lock_guard<std::mutex> guard(table.lock);
+
+    auto itr = table.responses.find(MakeKey(entry, locale));
+    return itr != table.responses.end() ? itr->second : Response();
+}
+
+QueryResponseCache::Response QueryResponseCache::Add(QueryResponseType type, uint32 entry, int locale, WorldPacket const& packet)
+{
+    Response response = std::make_shared<CachedQueryResponse const>(packet);
+
+    QueryResponseTable& table = s_tables[type];
+    std::lock_guard<std::mutex> guard(table.lock);
+    return table.responses.emplace(MakeKey(entry, locale), response).first->second;
+}
+
+void QueryResponseCache::Clear(QueryResponseType type)
+{
+    QueryResponseTable& table = s_tables[type];
+    std::lock_guard<std::mutex> guard(table.lock);
+    table.responses.clear();
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_QUERYRESPONSECACHE_H
+#define MANGOS_QUERYRESPONSECACHE_H
+
+#include "Common.h"
+#include "WorldPacket.h"
+
+#include <memory>
+
+enum QueryResponseType
+{
+    QUERY_RESPONSE_ITEM         = 0,
+    QUERY_RESPONSE_CREATURE     = 1,
+    QUERY_RESPONSE_GAMEOBJECT   = 2,
+    QUERY_RESPONSE_QUEST        = 3,
+    MAX_QUERY_RESPONSE_TYPES
+};
+
+// Serialized response of a template query, built once per entry and locale and sent to every client asking for it
+class CachedQueryResponse
+{
+    public:
+        explicit CachedQueryResponse(WorldPacket const& packet) : m_packet(packet), m_payload(m_packet)
+        {
+            m_payload.GetPayload();                         // created before the response is shared between threads
+        }
+
+        CachedQueryResponse(CachedQueryResponse const&) = delete;
+        CachedQueryResponse& operator=(CachedQueryResponse const&) = delete;
+
+        WorldPacket const& GetPacket() const { return m_packet; }
+        SharedPacketPayload const& GetPayload() const { return m_payload; }
+
+    private:
+        WorldPacket m_packet;
+        SharedPacketPayload m_payload;
+};
+
+// Responses of the item, creature, gameobject and quest queries by (entry, db locale index), filled lazily
+// by the query handlers of all map threads and dropped by the reload commands of their templates or locales.
+class QueryResponseCache
+{
+    public:
+        typedef std::shared_ptr<CachedQueryResponse const> Response;
+
+        static Response Find(QueryResponseType type, uint32 entry, int locale);
+        // returns the cached response, the one added first if another thread was faster
+        static Response Add(QueryResponseType type, uint32 entry, int locale, WorldPacket const& packet);
+        static void Clear(QueryResponseType type);
+};
+
+#endif
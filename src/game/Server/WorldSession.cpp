@@ -36,6 +36,7 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include "Social/SocialMgr.h"
 #include "Loot/LootMgr.h"
+#include "Accounts/RealmCharacterCounter.h"
 
 #include <mutex>
 #include <deque>
@@ -87,16 +88,47 @@ bool WorldSessionFilter::Process(WorldPacket const& packet) const
     return !MapSessionFilterHelper(m_pSession, opHandle);
 }
 
+bool SessionLocalFilter::Process(WorldPacket const& packet) const
+{
+    return IsSessionLocalOpcode(packet.GetOpcode());
+}
+
+// handlers that only read static templates and locales, or change data of their session alone
+// none of them may touch another session, a map, a group, a guild or any manager with mutable state
+bool SessionLocalFilter::IsSessionLocalOpcode(uint16 opcode)
+{
+    switch (opcode)
+    {
+        case CMSG_CREATURE_QUERY:
+        case CMSG_GAMEOBJECT_QUERY:
+        case CMSG_ITEM_QUERY_SINGLE:
+        case CMSG_ITEM_NAME_QUERY:
+        case CMSG_QUEST_QUERY:
+        case CMSG_PAGE_TEXT_QUERY:
+        case CMSG_NPC_TEXT_QUERY:
+        case CMSG_QUERY_TIME:
+        case CMSG_REALM_SPLIT:
+        case CMSG_TUTORIAL_FLAG:
+        case CMSG_TUTORIAL_CLEAR:
+        case CMSG_TUTORIAL_RESET:
+        case CMSG_WHO:                                      // reads the published WhoListCache snapshot
+            return true;
+        default:
+            return false;
+    }
+}
+
 /// WorldSession constructor
 WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8 expansion, time_t mute_time, LocaleConstant locale) :
     LookingForGroup_auto_join(false), LookingForGroup_auto_add(false), m_muteTime(mute_time),
     _player(nullptr), m_Socket(sock ? sock->shared<WorldSocket>() : nullptr),
     m_requestSocket(nullptr), m_sessionState(WORLD_SESSION_STATE_CREATED),
     _security(sec), _accountId(id), m_expansion(expansion), _logoutTime(0),
-    m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
+    m_botSession(sock == nullptr), m_inQueue(false), m_lingerProtected(false), m_charEnumPrefetching(false), m_charEnumPrefetchTime(0), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
     m_latency(0), m_tutorialState(TUTORIALDATA_UNCHANGED),
-    m_timeSyncClockDeltaQueue(6), m_timeSyncClockDelta(0), m_pendingTimeSyncRequests(), m_timeSyncNextCounter(0), m_timeSyncTimer(0) {}
+    m_timeSyncClockDeltaQueue(6), m_timeSyncClockDelta(0), m_pendingTimeSyncRequests(), m_timeSyncNextCounter(0), m_timeSyncTimer(0),
+    m_recvQueueLock("WorldSession::m_recvQueueLock"), m_recvOverflowing(false) {}
 
 /// WorldSession destructor
 WorldSession::~WorldSession()
@@ -105,6 +137,8 @@ WorldSession::~WorldSession()
     if (_player)
         LogoutPlayer(true);
 
+    sRealmCharacterCounter.Forget(_accountId);
+
     // marks this session as finalized in the socket which references (BUT DOES NOT OWN) it.
     // this lets the socket handling code know that the socket can be safely deleted
     if (m_Socket)
@@ -124,6 +158,15 @@ void WorldSession::SetOffline()
         sSocialMgr.SendFriendStatus(_player, FRIEND_OFFLINE, _player->GetObjectGuid(), true);
         _player->CleanupChannels();
         LogoutRequest(time(nullptr));
+
+        // the idle character can not be farmed while its owner reconnects, a fight keeps going to prevent escapes
+        if (sWorld.getConfig(CONFIG_BOOL_PLAYER_LINGER_PROTECT) && !m_lingerProtected && !_player->isInCombat() &&
+                !_player->IsImmuneToPlayer() && !_player->IsImmuneToNPC())
+        {
+            _player->SetImmuneToPlayer(true);
+            _player->SetImmuneToNPC(true);
+            m_lingerProtected = true;
+        }
     }
 
     // be sure its closed (may occur when second session is opened)
@@ -140,6 +183,24 @@ void WorldSession::SetOffline()
     m_sessionState = WORLD_SESSION_STATE_OFFLINE;
 }
 
+bool WorldSession::ShouldDisconnect(time_t currTime) const
+{
+    return _logoutTime > 0 && currTime >= _logoutTime + time_t(sWorld.getConfig(CONFIG_UINT32_PLAYER_LINGER_TIME));
+}
+
+void WorldSession::RemoveLingerProtection()
+{
+    if (!m_lingerProtected)
+        return;
+
+    m_lingerProtected = false;
+    if (_player)
+    {
+        _player->SetImmuneToPlayer(false);
+        _player->SetImmuneToNPC(false);
+    }
+}
+
 void WorldSession::SetOnline()
 {
     if (_player && m_Socket && !m_Socket->IsClosed())
@@ -148,7 +209,7 @@ void WorldSession::SetOnline()
 
 bool WorldSession::RequestNewSocket(WorldSocket* socket)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
+    std::lock_guard<ProfiledMutex> guard(m_recvQueueLock);
     if (m_requestSocket)
         return false;
 
@@ -179,6 +240,23 @@ void WorldSession::SetExpansion(uint8 expansion)
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const& packet, bool forcedSend /*= false*/) const
+{
+    if (!CanSendPacket(packet, forcedSend))
+        return;
+
+    m_Socket->SendPacket(packet);
+}
+
+/// Send a broadcast packet, the payload is shared with the other receivers instead of being copied
+void WorldSession::SendPacket(SharedPacketPayload const& payload) const
+{
+    if (!CanSendPacket(payload.GetPacket(), false))
+        return;
+
+    m_Socket->SendPacket(payload);
+}
+
+bool WorldSession::CanSendPacket(WorldPacket const& packet, bool forcedSend) const
 {
 #ifdef BUILD_PLAYERBOT
     // Send packet to bot AI
@@ -194,7 +272,7 @@ void WorldSession::SendPacket(WorldPacket const& packet, bool forcedSend /*= fal
     if (!m_Socket || (m_sessionState != WORLD_SESSION_STATE_READY && !forcedSend))
     {
         //sLog.outDebug("Refused to send %s to %s", packet.GetOpcodeName(), _player ? _player->GetName() : "UKNOWN");
-        return;
+        return false;
     }
 
 #ifdef MANGOS_DEBUG
@@ -233,14 +311,68 @@ void WorldSession::SendPacket(WorldPacket const& packet, bool forcedSend /*= fal
 
 #endif                                                  // !MANGOS_DEBUG
 
-    m_Socket->SendPacket(packet);
+    return true;
 }
 
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
-    m_recvQueue.push_back(std::move(new_packet));
+    // once the ring has been full everything goes to the overflow list until it is drained, to keep the packet order
+    if (!m_recvOverflowing.load(std::memory_order_acquire) && m_recvQueue.Push(std::move(new_packet)))
+        return;
+
+    std::lock_guard<std::mutex> guard(m_recvOverflowLock);
+    m_recvOverflow.push_back(std::move(new_packet));
+    m_recvOverflowing.store(true, std::memory_order_release);
+}
+
+/// Take the next incoming packet, the ring holds the older packets when both are in use
+bool WorldSession::PopPacket(std::unique_ptr<WorldPacket>& packet)
+{
+    if (m_deferredPacket)
+    {
+        packet = std::move(m_deferredPacket);
+        return true;
+    }
+
+    if (m_recvQueue.Pop(packet))
+        return true;
+
+    if (!m_recvOverflowing.load(std::memory_order_acquire))
+        return false;
+
+    std::lock_guard<std::mutex> guard(m_recvOverflowLock);
+    if (m_recvOverflow.empty())
+    {
+        m_recvOverflowing.store(false, std::memory_order_release);
+        return m_recvQueue.Pop(packet);
+    }
+
+    packet = std::move(m_recvOverflow.front());
+    m_recvOverflow.pop_front();
+
+    if (m_recvOverflow.empty())
+        m_recvOverflowing.store(false, std::memory_order_release);
+
+    return true;
+}
+
+/// Get a packet for incoming data, reusing the storage of an already processed one when possible
+std::unique_ptr<WorldPacket> WorldSession::AllocatePacket(uint16 opcode, size_t size)
+{
+    std::unique_ptr<WorldPacket> packet;
+    if (!m_packetPool.Pop(packet))
+        return std::unique_ptr<WorldPacket>(new WorldPacket(Opcodes(opcode), size));
+
+    packet->Initialize(Opcodes(opcode), size);
+    packet->SetReceivedTime(std::chrono::steady_clock::time_point());
+    return packet;
+}
+
+/// Hand a processed packet back to the pool, it is simply freed when the pool is full
+void WorldSession::RecyclePacket(std::unique_ptr<WorldPacket> packet)
+{
+    m_packetPool.Push(std::move(packet));
 }
 /// Logging helper for unexpected opcodes
 void WorldSession::LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const
@@ -263,111 +395,12 @@ void WorldSession::LogUnprocessedTail(WorldPacket const& packet) const
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
-
-    ///- Retrieve packets from the receive queue and call the appropriate handlers
-    /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !m_recvQueue.empty())
-    {
-        auto const packet = std::move(m_recvQueue.front());
-        m_recvQueue.pop_front();
-
-        /*#if 1
-        sLog.outError( "MOEP: %s (0x%.4X)",
-                        packet->GetOpcodeName(),
-                        packet->GetOpcode());
-        #endif*/
-
-        OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
-        try
-        {
-            switch (opHandle.status)
-            {
-                case STATUS_LOGGEDIN:
-                    if (!_player)
-                    {
-                        // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
-                        if (!m_playerRecentlyLogout)
-                            LogUnexpectedOpcode(*packet, "the player has not logged in yet");
-                    }
-                    else if (_player->IsInWorld())
-                        ExecuteOpcode(opHandle, *packet);
-
-                    // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
-
-#ifdef BUILD_PLAYERBOT
-                    if (_player && _player->GetPlayerbotMgr())
-                        _player->GetPlayerbotMgr()->HandleMasterIncomingPacket(*packet);
-#endif
-                    break;
-                case STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT:
-                    if (!_player && !m_playerRecentlyLogout)
-                    {
-                        LogUnexpectedOpcode(*packet, "the player has not logged in yet and not recently logout");
-                    }
-                    else
-                        // not expected _player or must checked in packet hanlder
-                        ExecuteOpcode(opHandle, *packet);
-                    break;
-                case STATUS_TRANSFER:
-                    if (!_player)
-                        LogUnexpectedOpcode(*packet, "the player has not logged in yet");
-                    else if (_player->IsInWorld())
-                        LogUnexpectedOpcode(*packet, "the player is still in world");
-                    else
-                        ExecuteOpcode(opHandle, *packet);
-                    break;
-                case STATUS_AUTHED:
-                    // prevent cheating with skip queue wait
-                    if (m_inQueue)
-                    {
-                        LogUnexpectedOpcode(*packet, "the player not pass queue yet");
-                        break;
-                    }
-
-                    // single from authed time opcodes send in to after logout time
-                    // and before other STATUS_LOGGEDIN_OR_RECENTLY_LOGGOUT opcodes.
-                    if (packet->GetOpcode() != CMSG_SET_ACTIVE_VOICE_CHANNEL)
-                        m_playerRecentlyLogout = false;
-
-                    ExecuteOpcode(opHandle, *packet);
-                    break;
-                case STATUS_NEVER:
-                    sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
-                                  packet->GetOpcodeName(),
-                                  packet->GetOpcode());
-                    break;
-                case STATUS_UNHANDLED:
-                    DEBUG_LOG("SESSION: received not handled opcode %s (0x%.4X)",
-                              packet->GetOpcodeName(),
-                              packet->GetOpcode());
-                    break;
-                default:
-                    sLog.outError("SESSION: received wrong-status-req opcode %s (0x%.4X)",
-                                  packet->GetOpcodeName(),
-                                  packet->GetOpcode());
-                    break;
-            }
-        }
-        catch (ByteBufferException&)
-        {
-            sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i.",
-                          packet->GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
-            if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
-            {
-                DEBUG_LOG("Dumping error causing packet:");
-                packet->hexlike();
-            }
+    std::lock_guard<ProfiledMutex> guard(m_recvQueueLock);
 
-            if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
-            {
-                DETAIL_LOG("Disconnecting session [account id %u / address %s] for badly formatted packet.",
-                           GetAccountId(), GetRemoteAddress().c_str());
+    // queries issued by the handlers of this session stay ordered on one async connection
+    SqlAsyncKeyScope asyncKey(GetAccountId());
 
-                KickPlayer();
-            }
-        }
-    }
+    ProcessPackets(updater);
 
 #ifdef BUILD_PLAYERBOT
     // Process player bot packets
@@ -381,15 +414,12 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         {
             Player* const botPlayer = itr->second;
             WorldSession* const pBotWorldSession = botPlayer->GetSession();
-            while(!pBotWorldSession->m_recvQueue.empty())
+            std::unique_ptr<WorldPacket> botpacket;
+            while (pBotWorldSession->PopPacket(botpacket))
             {
-                auto const botpacket = std::move(pBotWorldSession->m_recvQueue.front());
-                pBotWorldSession->m_recvQueue.pop_front();
-
                 OpcodeHandler const& opHandle = opcodeTable[botpacket->GetOpcode()];
                 pBotWorldSession->ExecuteOpcode(opHandle, *botpacket);
             }
-            pBotWorldSession->m_recvQueue.clear();
         }
     }
 #endif
@@ -433,7 +463,8 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                     return false;
                 }
 
-                if (ShouldLogOut(time(nullptr)) && !m_playerLoading)   // check if delayed logout is fired
+                // a reconnected character lingers until the grace period is over
+                if (ShouldDisconnect(time(nullptr)) && !m_playerLoading)
                     LogoutPlayer(true);
 
                 return true;
@@ -445,7 +476,13 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                     if (!_player)
                         return false;
 
-                    // give the opportunity for this player to reconnect within 20 sec
+                    if (!sWorld.getConfig(CONFIG_UINT32_PLAYER_LINGER_TIME))
+                    {
+                        LogoutPlayer(true);
+                        return false;
+                    }
+
+                    // give the opportunity for this player to reconnect within the linger time
                     SetOffline();
                 }
                 else if (ShouldLogOut(time(nullptr)) && !m_playerLoading)   // check if delayed logout is fired
@@ -484,6 +521,130 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     return true;
 }
 
+/// Handle the session local packets at the queue front, the others are left for Update()
+void WorldSession::UpdateSessionLocal()
+{
+    std::lock_guard<ProfiledMutex> guard(m_recvQueueLock);
+
+    SqlAsyncKeyScope asyncKey(GetAccountId());
+
+    SessionLocalFilter updater(this);
+    ProcessPackets(updater);
+}
+
+/// Retrieve packets from the receive queue and call the appropriate handlers, a deferred packet stops the processing
+void WorldSession::ProcessPackets(PacketFilter& updater)
+{
+    /// not process packets if socket already closed
+    std::unique_ptr<WorldPacket> packet;
+    while (m_Socket && !m_Socket->IsClosed() && PopPacket(packet))
+    {
+        if (updater.Defer(*packet))
+        {
+            m_deferredPacket = std::move(packet);
+            return;
+        }
+
+        /*#if 1
+        sLog.outError( "MOEP: %s (0x%.4X)",
+                        packet->GetOpcodeName(),
+                        packet->GetOpcode());
+        #endif*/
+
+        OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
+        try
+        {
+            switch (opHandle.status)
+            {
+                case STATUS_LOGGEDIN:
+                    if (!_player)
+                    {
+                        // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
+                        if (!m_playerRecentlyLogout)
+                            LogUnexpectedOpcode(*packet, "the player has not logged in yet");
+                    }
+                    else if (_player->IsInWorld())
+                        ExecuteOpcode(opHandle, *packet, updater.GetProfilePath());
+
+                    // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
+
+#ifdef BUILD_PLAYERBOT
+                    if (_player && _player->GetPlayerbotMgr())
+                        _player->GetPlayerbotMgr()->HandleMasterIncomingPacket(*packet);
+#endif
+                    break;
+                case STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT:
+                    if (!_player && !m_playerRecentlyLogout)
+                    {
+                        LogUnexpectedOpcode(*packet, "the player has not logged in yet and not recently logout");
+                    }
+                    else
+                        // not expected _player or must checked in packet hanlder
+                        ExecuteOpcode(opHandle, *packet, updater.GetProfilePath());
+                    break;
+                case STATUS_TRANSFER:
+                    if (!_player)
+                        LogUnexpectedOpcode(*packet, "the player has not logged in yet");
+                    else if (_player->IsInWorld())
+                        LogUnexpectedOpcode(*packet, "the player is still in world");
+                    else
+                        ExecuteOpcode(opHandle, *packet, updater.GetProfilePath());
+                    break;
+                case STATUS_AUTHED:
+                    // prevent cheating with skip queue wait
+                    if (m_inQueue)
+                    {
+                        LogUnexpectedOpcode(*packet, "the player not pass queue yet");
+                        break;
+                    }
+
+                    // single from authed time opcodes send in to after logout time
+                    // and before other STATUS_LOGGEDIN_OR_RECENTLY_LOGGOUT opcodes.
+                    if (packet->GetOpcode() != CMSG_SET_ACTIVE_VOICE_CHANNEL)
+                        m_playerRecentlyLogout = false;
+
+                    ExecuteOpcode(opHandle, *packet, updater.GetProfilePath());
+                    break;
+                case STATUS_NEVER:
+                    sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
+                                  packet->GetOpcodeName(),
+                                  packet->GetOpcode());
+                    break;
+                case STATUS_UNHANDLED:
+                    DEBUG_LOG("SESSION: received not handled opcode %s (0x%.4X)",
+                              packet->GetOpcodeName(),
+                              packet->GetOpcode());
+                    break;
+                default:
+                    sLog.outError("SESSION: received wrong-status-req opcode %s (0x%.4X)",
+                                  packet->GetOpcodeName(),
+                                  packet->GetOpcode());
+                    break;
+            }
+        }
+        catch (ByteBufferException&)
+        {
+            sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i.",
+                          packet->GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
+            if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
+            {
+                DEBUG_LOG("Dumping error causing packet:");
+                packet->hexlike();
+            }
+
+            if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
+            {
+                DETAIL_LOG("Disconnecting session [account id %u / address %s] for badly formatted packet.",
+                           GetAccountId(), GetRemoteAddress().c_str());
+
+                KickPlayer();
+            }
+        }
+
+        RecyclePacket(std::move(packet));
+    }
+}
+
 /// %Log the player out
 void WorldSession::LogoutPlayer(bool Save)
 {
@@ -494,6 +655,8 @@ void WorldSession::LogoutPlayer(bool Save)
     m_playerLogout = true;
     m_playerSave = Save;
 
+    RemoveLingerProtection();
+
     if (_player)
     {
 #ifdef BUILD_PLAYERBOT
@@ -578,6 +741,7 @@ void WorldSession::LogoutPlayer(bool Save)
             }
 
             guild->BroadcastEvent(GE_SIGNED_OFF, _player->GetObjectGuid(), _player->GetName());
+            guild->SetMemberOnline(_player->GetObjectGuid(), false);
         }
 
         ///- Remove pet
@@ -904,8 +1068,11 @@ void WorldSession::SendTransferAborted(uint32 mapid, uint8 reason, uint8 arg) co
     SendPacket(data);
 }
 
-void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet)
+void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet, OpcodeProfilePath path)
 {
+    OpcodeProfiler::Scope profile(path, packet.GetOpcode(), GetAccountId(), packet.size());
+
+
     // need prevent do internal far teleports in handlers because some handlers do lot steps
     // or call code that can do far teleports in some conditions unexpectedly for generic way work code
     if (_player)
@@ -29,7 +29,11 @@
 #include "AuctionHouse/AuctionHouseMgr.h"
 #include "Entities/Item.h"
 #include "WorldSocket.h"
+#include "LockFreeQueue.h"
+#include "ProfiledMutex.h"
+#include "Server/OpcodeProfiler.h"
 
+#include <atomic>
 #include <map>
 #include <deque>
 #include <mutex>
@@ -147,6 +151,10 @@ class PacketFilter
 
         virtual bool Process(WorldPacket const& /*packet*/) const { return true; }
         virtual bool ProcessLogout() const { return true; }
+        // a deferred packet ends the processing and stays first in the queue for the next update
+        virtual bool Defer(WorldPacket const& /*packet*/) const { return false; }
+        // update the handlers of this filter are accounted to by the opcode profiler
+        virtual OpcodeProfilePath GetProfilePath() const { return OPCODE_PATH_WORLD; }
 
     protected:
         WorldSession* const m_pSession;
@@ -162,6 +170,7 @@ class MapSessionFilter : public PacketFilter
         virtual bool Process(WorldPacket const& packet) const override;
         // in Map::Update() we do not process player logout!
         virtual bool ProcessLogout() const override { return false; }
+        virtual OpcodeProfilePath GetProfilePath() const override { return OPCODE_PATH_MAP; }
 };
 
 // class used to filer only thread-unsafe packets from queue
@@ -175,6 +184,22 @@ class WorldSessionFilter : public PacketFilter
         virtual bool Process(WorldPacket const& packet) const override;
 };
 
+// process only packets whose handlers touch nothing but their own session and static data
+// used by the parallel part of World::UpdateSessions(), the first other packet is left for WorldSessionFilter
+class SessionLocalFilter : public PacketFilter
+{
+    public:
+        explicit SessionLocalFilter(WorldSession* pSession) : PacketFilter(pSession) {}
+        ~SessionLocalFilter() {}
+
+        virtual bool Process(WorldPacket const& packet) const override;
+        virtual bool ProcessLogout() const override { return false; }
+        virtual bool Defer(WorldPacket const& packet) const override { return !Process(packet); }
+        virtual OpcodeProfilePath GetProfilePath() const override { return OPCODE_PATH_SESSION_LOCAL; }
+
+        static bool IsSessionLocalOpcode(uint16 opcode);
+};
+
 /// Player session in the World
 class WorldSession
 {
@@ -200,6 +225,7 @@ class WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const& packet, bool forcedSend = false) const;
+        void SendPacket(SharedPacketPayload const& payload) const;
         void SendExpectedSpamRecords();
         void SendMotd();
         void SendOfflineNameQueryResponses();
@@ -224,6 +250,9 @@ class WorldSession
         const std::string GetRemoteAddress() const { return m_Socket ? m_Socket->GetRemoteAddress() : "disconnected"; }
 #endif
         void SetPlayer(Player* plr) { _player = plr; }
+
+        /// Session created without socket for a playerbot, nothing reads the update packets of its player
+        bool IsBotSession() const { return m_botSession; }
         uint8 GetExpansion() const { return m_expansion; }
         void SetExpansion(uint8 expansion);
 
@@ -245,17 +274,20 @@ class WorldSession
             return (_logoutTime > 0 && currTime >= _logoutTime + 20);
         }
 
-        bool ShouldDisconnect(time_t currTime)
-        {
-            return (_logoutTime > 0 && currTime >= _logoutTime + 60);
-        }
+        /// The character of a lost connection lingers in the world until then
+        bool ShouldDisconnect(time_t currTime) const;
+        void RemoveLingerProtection();
 
         void LogoutPlayer(bool Save);
         void KickPlayer();
 
         void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
+        std::unique_ptr<WorldPacket> AllocatePacket(uint16 opcode, size_t size);
+        void RecyclePacket(std::unique_ptr<WorldPacket> packet);
 
         bool Update(uint32 diff, PacketFilter& updater);
+        // handles the queued packets up to the first one not session local, can run concurrently for different sessions
+        void UpdateSessionLocal();
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position) const;
@@ -317,7 +349,7 @@ class WorldSession
         void SendAuctionRemovedNotification(AuctionEntry* auction) const;
         static void SendAuctionOutbiddedMail(AuctionEntry* auction);
         static void SendAuctionCancelledToBidderMail(AuctionEntry* auction);
-        void BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
+        void BuildListAuctionItems(std::vector<AuctionEntry*>& auctions, AuctionSorter const& sorter, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
                                    uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull) const;
 
         AuctionHouseEntry const* GetCheckedAuctionHouseForAuctioneer(ObjectGuid guid) const;
@@ -381,6 +413,9 @@ class WorldSession
         void HandleCharCreateOpcode(WorldPacket& recvPacket);
         void HandlePlayerLoginOpcode(WorldPacket& recvPacket);
         void HandleCharEnum(QueryResult* result);
+        /// Reads the character list while the session waits in the login queue, CMSG_CHAR_ENUM then answers from it
+        void PrefetchCharEnum();
+        void HandlePrefetchedCharEnum(QueryResult* result);
         void HandlePlayerLogin(LoginQueryHolder* holder);
         void HandlePlayerReconnect();
 
@@ -588,6 +623,8 @@ class WorldSession
         void HandleAuctionPlaceBid(WorldPacket& recv_data);
 
         void HandleGetMailList(WorldPacket& recv_data);
+        static void HandleMailedItemsLoadCallBack(QueryResult* result, uint32 accountId, uint32 playerGuidLow);
+        void SendMailList();
         void HandleSendMail(WorldPacket& recv_data);
         void HandleMailTakeMoney(WorldPacket& recv_data);
         void HandleMailTakeItem(WorldPacket& recv_data);
@@ -807,7 +844,13 @@ class WorldSession
         bool VerifyMovementInfo(MovementInfo const& movementInfo) const;
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
-        void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet);
+        void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet, OpcodeProfilePath path = OPCODE_PATH_WORLD);
+
+        void ProcessPackets(PacketFilter& updater);
+        bool PopPacket(std::unique_ptr<WorldPacket>& packet);
+
+        // checks shared by both SendPacket variants
+        bool CanSendPacket(WorldPacket const& packet, bool forcedSend) const;
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const;
@@ -823,7 +866,12 @@ class WorldSession
         uint8 m_expansion;
 
         time_t _logoutTime;
+        bool m_botSession;                                  // no client will ever be attached
         bool m_inQueue;                                     // session wait in auth.queue
+        bool m_lingerProtected;                             // immunities set on the lingering character, removed at reconnect
+        bool m_charEnumPrefetching;                         // character list query of the login queue running
+        time_t m_charEnumPrefetchTime;
+        std::unique_ptr<QueryResult> m_prefetchedCharEnum;
         bool m_playerLoading;                               // code processed in LoginPlayer
         bool m_playerLogout;                                // code processed in LogoutPlayer
         bool m_playerRecentlyLogout;
@@ -845,8 +893,17 @@ class WorldSession
         std::set<ObjectGuid> m_offlineNameQueries; // for name queires made when not logged in (character selection screen)
         std::deque<CharacterNameQueryResponse> m_offlineNameResponses; // for responses to name queries made when not logged in
 
-        std::mutex m_recvQueueLock;
-        std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
+        ProfiledMutex m_recvQueueLock;                      // guards the socket swap in RequestNewSocket against Update
+
+        // packets queued by the socket are taken without locking, the overflow list is only used while the ring is full
+        LockFreeQueue<std::unique_ptr<WorldPacket>, 256> m_recvQueue;
+        std::mutex m_recvOverflowLock;
+        std::deque<std::unique_ptr<WorldPacket>> m_recvOverflow;
+        std::atomic<bool> m_recvOverflowing;
+        std::unique_ptr<WorldPacket> m_deferredPacket;      // left by a filter, taken before the queued packets
+
+        // processed packets handed back to the socket so their storage is reused, also the ones the socket handles itself
+        LockFreeQueue<std::unique_ptr<WorldPacket>, 64> m_packetPool;
 };
 #endif
 /// @}
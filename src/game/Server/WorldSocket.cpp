@@ -31,6 +31,7 @@
 #include "Server/WorldSession.h"
 #include "Log.h"
 #include "Server/DBCStores.h"
+#include "Server/PacketCapture.h"
 
 #include <chrono>
 #include <functional>
@@ -57,35 +58,60 @@ struct ServerPktHeader
 #endif
 
 WorldSocket::WorldSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler) : Socket(service, std::move(closeHandler)), m_lastPingTime(std::chrono::system_clock::time_point::min()), m_overSpeedPings(0), m_existingHeader(),
-    m_useExistingHeader(false), m_session(nullptr), m_seed(urand())
+    m_useExistingHeader(false), m_session(nullptr), m_seed(urand()), m_captureFailed(false), m_authPending(false)
 {
 }
 
-void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
+WorldSocket::~WorldSocket()
 {
-    if (IsClosed())
-        return;
+}
 
+void WorldSocket::BuildHeader(const WorldPacket& pct, ServerPktHeader& header)
+{
     // Dump outgoing packet.
     sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
 
-    ServerPktHeader header;
-
     header.cmd = pct.GetOpcode();
     EndianConvert(header.cmd);
 
     header.size = static_cast<uint16>(pct.size() + 2);
     EndianConvertReverse(header.size);
+}
+
+void WorldSocket::EncryptHeaders(uint8* buffer, std::vector<size_t> const& headerPositions)
+{
+    m_crypt.EncryptSendHeaders(buffer, headerPositions);
+}
+
+void WorldSocket::SendPacket(const WorldPacket& pct)
+{
+    if (IsClosed())
+        return;
 
-    m_crypt.EncryptSend(reinterpret_cast<uint8*>(&header), sizeof(header));
+    ServerPktHeader header;
+    BuildHeader(pct, header);
 
+    // the header is encrypted with the other headers of the flush, packets sent before the session key is known stay plain
     if (pct.size() > 0)
-        Write(reinterpret_cast<const char*>(&header), sizeof(header), reinterpret_cast<const char*>(pct.contents()), pct.size());
+        Write(reinterpret_cast<const char*>(&header), sizeof(header), reinterpret_cast<const char*>(pct.contents()), pct.size(), m_crypt.IsInitialized());
     else
-        Write(reinterpret_cast<const char*>(&header), sizeof(header));
+        Write(reinterpret_cast<const char*>(&header), sizeof(header), nullptr, 0, m_crypt.IsInitialized());
+}
+
+void WorldSocket::SendPacket(const SharedPacketPayload& payload)
+{
+    if (IsClosed())
+        return;
+
+    const WorldPacket& pct = payload.GetPacket();
+
+    ServerPktHeader header;
+    BuildHeader(pct, header);
 
-    if (immediate)
-        ForceFlushOut();
+    if (pct.size() > 0)
+        Write(reinterpret_cast<const char*>(&header), sizeof(header), payload.GetPayload(), m_crypt.IsInitialized());
+    else
+        Write(reinterpret_cast<const char*>(&header), sizeof(header), nullptr, 0, m_crypt.IsInitialized());
 }
 
 bool WorldSocket::Open()
@@ -114,6 +140,14 @@ bool WorldSocket::ProcessIncomingData()
 {
     ClientPktHeader header;
 
+    // the client waits for the auth response, the crypto state may change until it is sent
+    if (m_authPending)
+    {
+        sLog.outError("WorldSocket::ProcessIncomingData: client %s sent data during authentication", GetRemoteAddress().c_str());
+        errno = EINVAL;
+        return false;
+    }
+
     if (m_useExistingHeader)
     {
         m_useExistingHeader = false;
@@ -168,7 +202,8 @@ bool WorldSocket::ProcessIncomingData()
     if (IsClosed())
         return false;
 
-    std::unique_ptr<WorldPacket> pct(new WorldPacket(opcode, validBytesRemaining));
+    std::unique_ptr<WorldPacket> pct = m_session ? m_session->AllocatePacket(opcode, validBytesRemaining)
+                                       : std::unique_ptr<WorldPacket>(new WorldPacket(opcode, validBytesRemaining));
 
     if (validBytesRemaining)
     {
@@ -192,10 +227,18 @@ bool WorldSocket::ProcessIncomingData()
                 return HandleAuthSession(*pct);
 
             case CMSG_PING:
-                return HandlePing(*pct);
+            {
+                bool const result = HandlePing(*pct);
+                // pings come every half minute from every client, keep their storage in the pool too
+                if (m_session)
+                    m_session->RecyclePacket(std::move(pct));
+                return result;
+            }
 
             case CMSG_KEEP_ALIVE:
                 DEBUG_LOG("CMSG_KEEP_ALIVE, size: " SIZEFMTD " ", pct->size());
+                if (m_session)
+                    m_session->RecyclePacket(std::move(pct));
                 return true;
 
             case CMSG_TIME_SYNC_RESP:
@@ -208,6 +251,20 @@ bool WorldSocket::ProcessIncomingData()
                     return false;
                 }
 
+                if (PacketCapture::IsEnabled())
+                {
+                    if (!m_capture && !m_captureFailed)
+                    {
+                        m_capture = PacketCapture::Create(m_session->GetAccountId());
+                        m_captureFailed = !m_capture;
+                    }
+
+                    if (m_capture)
+                        m_capture->Record(*pct);
+                }
+                else if (m_capture)
+                    m_capture.reset();
+
                 m_session->QueuePacket(std::move(pct));
 
                 return true;
@@ -236,29 +293,51 @@ bool WorldSocket::ProcessIncomingData()
     return true;
 }
 
+/// Data of a CMSG_AUTH_SESSION kept while its account query runs
+struct AuthSessionRequest
+{
+    std::shared_ptr<WorldSocket> socket;
+    std::string account;
+    uint32 clientSeed;
+    uint8 digest[20];
+    WorldPacket addonPacket;
+    bool hasAddonPacket;
+    std::chrono::steady_clock::time_point queuedTime;
+};
+
+std::atomic<uint32> WorldSocket::s_pendingAuths(0);
+std::atomic<uint32> WorldSocket::s_peakPendingAuths(0);
+std::atomic<uint32> WorldSocket::s_refusedAuths(0);
+std::atomic<uint64> WorldSocket::s_finishedAuths(0);
+std::atomic<uint64> WorldSocket::s_authWaitMs(0);
+
+void WorldSocket::GetAuthStatistics(uint32& pending, uint32& peak, uint32& refused, uint32& averageWaitMs)
+{
+    pending = s_pendingAuths;
+    peak = s_peakPendingAuths;
+    refused = s_refusedAuths;
+    uint64 finished = s_finishedAuths;
+    averageWaitMs = finished ? uint32(s_authWaitMs / finished) : 0;
+}
+
 bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 {
     // NOTE: ATM the socket is singlethread, have this in mind ...
-    uint8 digest[20];
-    uint32 clientSeed;
     uint32 ClientBuild;
-    LocaleConstant locale;
-    std::string account;
-    Sha1Hash sha1;
-    BigNumber v, s, g, N, K;
-    WorldPacket packet, SendAddonPacked;
+    WorldPacket packet;
+    std::unique_ptr<AuthSessionRequest> request(new AuthSessionRequest);
 
     // Read the content of the packet
     recvPacket >> ClientBuild;
     recvPacket.read_skip<uint32>();
-    recvPacket >> account;
-    recvPacket >> clientSeed;
-    recvPacket.read(digest, 20);
+    recvPacket >> request->account;
+    recvPacket >> request->clientSeed;
+    recvPacket.read(request->digest, 20);
 
     DEBUG_LOG("WorldSocket::HandleAuthSession: client build %u, account %s, clientseed %X",
               ClientBuild,
-              account.c_str(),
-              clientSeed);
+              request->account.c_str(),
+              request->clientSeed);
 
     // Check the version of client trying to connect
     if (!IsAcceptableClientBuild(ClientBuild))
@@ -272,26 +351,100 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
         return false;
     }
 
-    // Get the account information from the realmd database
-    std::string safe_account = account; // Duplicate, else will screw the SHA hash verification below
+    // refuse logins while too many wait for the login database, the client may retry
+    uint32 maxPending = sWorld.getConfig(CONFIG_UINT32_NETWORK_MAX_PENDING_AUTH);
+    if (maxPending && s_pendingAuths >= maxPending)
+    {
+        packet.Initialize(SMSG_AUTH_RESPONSE, 1);
+        packet << uint8(AUTH_UNAVAILABLE);
+
+        SendPacket(packet);
+
+        ++s_refusedAuths;
+        BASIC_LOG("WorldSocket::HandleAuthSession: Sent Auth Response (too many pending authentications).");
+        return false;
+    }
+
+    // the addon data is the rest of the packet, the answer is sent once the account is authenticated
+    request->hasAddonPacket = sAddOnHandler.BuildAddonPacket(recvPacket, request->addonPacket);
+    request->socket = shared<WorldSocket>();
+    request->queuedTime = std::chrono::steady_clock::now();
+
+    // Get the account information and its bans from the realmd database
+    std::string safe_account = request->account; // Duplicate, else will screw the SHA hash verification below
     LoginDatabase.escape_string(safe_account);
     // No SQL injection, username escaped.
 
-    QueryResult* result =
-        LoginDatabase.PQuery("SELECT "
-                             "id, "                      //0
-                             "gmlevel, "                 //1
-                             "sessionkey, "              //2
-                             "last_ip, "                 //3
-                             "locked, "                  //4
-                             "v, "                       //5
-                             "s, "                       //6
-                             "expansion, "               //7
-                             "mutetime, "                //8
-                             "locale "                   //9
-                             "FROM account "
-                             "WHERE username = '%s'",
-                             safe_account.c_str());
+    m_authPending = true;
+    uint32 pending = ++s_pendingAuths;
+    uint32 peak = s_peakPendingAuths;
+    while (pending > peak && !s_peakPendingAuths.compare_exchange_weak(peak, pending)) {}
+
+    if (!LoginDatabase.AsyncPQuery(&WorldSocket::HandleAuthQueryResult, request.get(),
+                                   "SELECT "
+                                   "id, "                      //0
+                                   "gmlevel, "                 //1
+                                   "sessionkey, "              //2
+                                   "last_ip, "                 //3
+                                   "locked, "                  //4
+                                   "v, "                       //5
+                                   "s, "                       //6
+                                   "expansion, "               //7
+                                   "mutetime, "                //8
+                                   "locale, "                  //9
+                                   // Re-check account ban (same check as in realmd)
+                                   "EXISTS (SELECT 1 FROM account_banned WHERE account_id = account.id AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)) "
+                                   "OR EXISTS (SELECT 1 FROM ip_banned WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s') " //10
+                                   "FROM account "
+                                   "WHERE username = '%s'",
+                                   GetRemoteAddress().c_str(), safe_account.c_str()))
+    {
+        --s_pendingAuths;
+        m_authPending = false;
+
+        packet.Initialize(SMSG_AUTH_RESPONSE, 1);
+        packet << uint8(AUTH_SYSTEM_ERROR);
+
+        SendPacket(packet);
+
+        sLog.outError("WorldSocket::HandleAuthSession: Sent Auth Response (account query failed).");
+        return false;
+    }
+
+    // owned by the query callback now
+    request.release();
+    return true;
+}
+
+void WorldSocket::HandleAuthQueryResult(QueryResult* result, AuthSessionRequest* request)
+{
+    // the checks use the crypto state of the socket, so they run on its network thread
+    request->socket->GetService().post([result, request]()
+    {
+        std::unique_ptr<QueryResult> resultGuard(result);
+        std::unique_ptr<AuthSessionRequest> requestGuard(request);
+        WorldSocket& socket = *request->socket;
+
+        --s_pendingAuths;
+        ++s_finishedAuths;
+        s_authWaitMs += std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - request->queuedTime).count();
+
+        if (socket.IsClosed())
+            return;
+
+        bool authed = socket.FinishAuthSession(*request, result);
+        socket.m_authPending = false;
+
+        if (!authed)
+            socket.Close();
+    });
+}
+
+bool WorldSocket::FinishAuthSession(AuthSessionRequest& request, QueryResult* result)
+{
+    LocaleConstant locale;
+    BigNumber v, s, g, N, K;
+    WorldPacket packet;
 
     // Stop if the account is not found
     if (!result)
@@ -333,7 +486,6 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
             packet << uint8(AUTH_FAILED);
             SendPacket(packet);
 
-            delete result;
             BASIC_LOG("WorldSocket::HandleAuthSession: Sent Auth Response (Account IP differs).");
             return false;
         }
@@ -363,23 +515,12 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     else
         locale = LocaleConstant(tempLoc);
 
-    delete result;
-
-    // Re-check account ban (same check as in realmd)
-    QueryResult* banresult =
-        LoginDatabase.PQuery("SELECT 1 FROM account_banned WHERE account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)"
-                             "UNION "
-                             "SELECT 1 FROM ip_banned WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'",
-                             id, GetRemoteAddress().c_str());
-
-    if (banresult) // if account banned
+    if (fields[10].GetBool()) // if account banned
     {
         packet.Initialize(SMSG_AUTH_RESPONSE, 1);
         packet << uint8(AUTH_BANNED);
         SendPacket(packet);
 
-        delete banresult;
-
         sLog.outError("WorldSocket::HandleAuthSession: Sent Auth Response (Account banned).");
         return false;
     }
@@ -404,14 +545,14 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     uint32 t = 0;
     uint32 seed = m_seed;
 
-    sha.UpdateData(account);
+    sha.UpdateData(request.account);
     sha.UpdateData((uint8*) & t, 4);
-    sha.UpdateData((uint8*) & clientSeed, 4);
+    sha.UpdateData((uint8*) & request.clientSeed, 4);
     sha.UpdateData((uint8*) & seed, 4);
     sha.UpdateBigNumbers(&K, nullptr);
     sha.Finalize();
 
-    if (memcmp(sha.GetDigest(), digest, 20))
+    if (memcmp(sha.GetDigest(), request.digest, 20))
     {
         packet.Initialize(SMSG_AUTH_RESPONSE, 1);
         packet << uint8(AUTH_FAILED);
@@ -425,7 +566,7 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     const std::string& address = GetRemoteAddress();
 
     DEBUG_LOG("WorldSocket::HandleAuthSession: Client '%s' authenticated successfully from %s.",
-              account.c_str(),
+              request.account.c_str(),
               address.c_str());
 
     // Update the last_ip in the database
@@ -433,13 +574,13 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     static SqlStatementID updAccount;
 
     SqlStatement stmt = LoginDatabase.CreateStatement(updAccount, "UPDATE account SET last_ip = ? WHERE username = ?");
-    stmt.PExecute(address.c_str(), account.c_str());
+    stmt.PExecute(address.c_str(), request.account.c_str());
 
     m_crypt.Init(&K);
 
-    // Create and send the Addon packet
-    if (sAddOnHandler.BuildAddonPacket(recvPacket, SendAddonPacked))
-        SendPacket(SendAddonPacked);
+    // Send the Addon packet
+    if (request.hasAddonPacket)
+        SendPacket(request.addonPacket);
 
     m_session = sWorld.FindSession(id);
     if (m_session)
@@ -527,7 +668,7 @@ bool WorldSocket::HandlePing(WorldPacket& recvPacket)
 
     WorldPacket packet(SMSG_PONG, 4);
     packet << ping;
-    SendPacket(packet, true);
+    SendPacket(packet);
 
     return true;
 }
@@ -30,11 +30,17 @@
 #include "Auth/BigNumber.h"
 #include "Network/Socket.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 
 class WorldPacket;
 class WorldSession;
+class PacketCapture;
+class SharedPacketPayload;
+class QueryResult;
+struct ServerPktHeader;
+struct AuthSessionRequest;
 
 /**
  * WorldSocket.
@@ -110,22 +116,41 @@ class WorldSocket : public MaNGOS::Socket
 
         const uint32 m_seed;
 
+        /// Inbound packets of the session while capturing is enabled, m_captureFailed stops retrying a file that can not be created
+        std::unique_ptr<PacketCapture> m_capture;
+        bool m_captureFailed;
+
         BigNumber m_s;
 
         /// process one incoming packet.
         virtual bool ProcessIncomingData() override;
 
-        /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
+        /// Set while the account query of CMSG_AUTH_SESSION is running, the client must not send anything meanwhile
+        bool m_authPending;
+
+        /// Called by ProcessIncoming() on CMSG_AUTH_SESSION, queries the account asynchronously.
         bool HandleAuthSession(WorldPacket& recvPacket);
+        /// Called by the world thread with the account row, resumes the authentication on the network thread.
+        static void HandleAuthQueryResult(QueryResult* result, AuthSessionRequest* request);
+        /// Checks the account row and creates or reconnects the session.
+        bool FinishAuthSession(AuthSessionRequest& request, QueryResult* result);
 
         /// Called by ProcessIncoming() on CMSG_PING.
         bool HandlePing(WorldPacket& recvPacket);
 
+        /// Dump an outgoing packet and fill its header, it is encrypted when the socket flushes.
+        void BuildHeader(const WorldPacket& pct, ServerPktHeader& header);
+
+        virtual void EncryptHeaders(uint8* buffer, std::vector<size_t> const& headerPositions) override;
+
     public:
         WorldSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
+        ~WorldSocket();
 
         // send a packet \o/
-        void SendPacket(const WorldPacket& pct, bool immediate = false);
+        void SendPacket(const WorldPacket& pct);
+        // send a packet whose payload is shared with other sockets
+        void SendPacket(const SharedPacketPayload& payload);
 
         void FinalizeSession() { m_session = nullptr; }
 
@@ -134,6 +159,16 @@ class WorldSocket : public MaNGOS::Socket
         /// Return the session key
         BigNumber& GetSessionKey() { return m_s; }
 
+        /// Authentications waiting for their account query, the most seen at once, the refused ones and the average wait
+        static void GetAuthStatistics(uint32& pending, uint32& peak, uint32& refused, uint32& averageWaitMs);
+
+    private:
+        static std::atomic<uint32> s_pendingAuths;
+        static std::atomic<uint32> s_peakPendingAuths;
+        static std::atomic<uint32> s_refusedAuths;
+        static std::atomic<uint64> s_finishedAuths;
+        static std::atomic<uint64> s_authWaitMs;
+
 };
 
 #endif  /* _WORLDSOCKET_H */
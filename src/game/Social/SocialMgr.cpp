@@ -79,6 +79,9 @@ bool PlayerSocial::AddToSocialList(ObjectGuid friend_guid, bool ignore)
         fi.Flags |= flag;
         m_playerSocialMap[friend_guid.GetCounter()] = fi;
     }
+
+    if (!ignore)
+        sSocialMgr.AddFriendLister(friend_guid.GetCounter(), m_playerLowGuid);
     return true;
 }
 
@@ -92,6 +95,9 @@ void PlayerSocial::RemoveFromSocialList(ObjectGuid friend_guid, bool ignore)
     if (ignore)
         flag = SOCIAL_FLAG_IGNORED;
 
+    if (!ignore)
+        sSocialMgr.RemoveFriendLister(friend_guid.GetCounter(), m_playerLowGuid);
+
     itr->second.Flags &= ~flag;
     if (itr->second.Flags == 0)
     {
@@ -176,6 +182,35 @@ SocialMgr::~SocialMgr()
 {
 }
 
+void SocialMgr::RemovePlayerSocial(uint32 guid)
+{
+    SocialMap::iterator itr = m_socialMap.find(guid);
+    if (itr == m_socialMap.end())
+        return;
+
+    for (PlayerSocialMap::const_iterator itr2 = itr->second.m_playerSocialMap.begin(); itr2 != itr->second.m_playerSocialMap.end(); ++itr2)
+        if (itr2->second.Flags & SOCIAL_FLAG_FRIEND)
+            RemoveFriendLister(itr2->first, guid);
+
+    m_socialMap.erase(itr);
+}
+
+void SocialMgr::AddFriendLister(uint32 friendGuid, uint32 listerGuid)
+{
+    m_friendListers[friendGuid].insert(listerGuid);
+}
+
+void SocialMgr::RemoveFriendLister(uint32 friendGuid, uint32 listerGuid)
+{
+    auto itr = m_friendListers.find(friendGuid);
+    if (itr == m_friendListers.end())
+        return;
+
+    itr->second.erase(listerGuid);
+    if (itr->second.empty())
+        m_friendListers.erase(itr);
+}
+
 void SocialMgr::GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo& friendInfo) const
 {
     if (!player)
@@ -273,22 +308,22 @@ void SocialMgr::BroadcastToFriendListers(Player* player, WorldPacket const& pack
     AccountTypes gmLevelInWhoList = AccountTypes(sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_WHO_LIST));
     bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST);
 
-    for (SocialMap::const_iterator itr = m_socialMap.begin(); itr != m_socialMap.end(); ++itr)
+    auto listers = m_friendListers.find(guid);
+    if (listers == m_friendListers.end())
+        return;
+
+    for (uint32 listerGuid : listers->second)
     {
-        PlayerSocialMap::const_iterator itr2 = itr->second.m_playerSocialMap.find(guid);
-        if (itr2 != itr->second.m_playerSocialMap.end() && (itr2->second.Flags & SOCIAL_FLAG_FRIEND))
+        Player* pFriend = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, listerGuid));
+
+        // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
+        // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
+        if (pFriend && pFriend->IsInWorld() &&
+                (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
+                 ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
+                player->IsVisibleGloballyFor(pFriend))
         {
-            Player* pFriend = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
-
-            // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
-            // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
-            if (pFriend && pFriend->IsInWorld() &&
-                    (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
-                     ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
-                    player->IsVisibleGloballyFor(pFriend))
-            {
-                pFriend->GetSession()->SendPacket(packet);
-            }
+            pFriend->GetSession()->SendPacket(packet);
         }
     }
 }
@@ -298,6 +333,12 @@ PlayerSocial* SocialMgr::LoadFromDB(QueryResult* result, ObjectGuid guid)
     PlayerSocial* social = &m_socialMap[guid.GetCounter()];
     social->SetPlayerGuid(guid);
 
+    // a list kept from an earlier login is read again, every change was saved to the DB
+    for (PlayerSocialMap::const_iterator itr = social->m_playerSocialMap.begin(); itr != social->m_playerSocialMap.end(); ++itr)
+        if (itr->second.Flags & SOCIAL_FLAG_FRIEND)
+            RemoveFriendLister(itr->first, guid.GetCounter());
+    social->m_playerSocialMap.clear();
+
     if (!result)
         return social;
 
@@ -319,6 +360,9 @@ PlayerSocial* SocialMgr::LoadFromDB(QueryResult* result, ObjectGuid guid)
 
         social->m_playerSocialMap[friend_guid] = FriendInfo(flags, note);
 
+        if (flags & SOCIAL_FLAG_FRIEND)
+            AddFriendLister(friend_guid, guid.GetCounter());
+
         if (flags & SOCIAL_FLAG_IGNORED)
             ++ignoreCounter;
         else
@@ -22,6 +22,9 @@
 #include "Database/DatabaseEnv.h"
 #include "Entities/ObjectGuid.h"
 
+#include <unordered_map>
+#include <unordered_set>
+
 class SocialMgr;
 class PlayerSocial;
 class Player;
@@ -136,7 +139,7 @@ class SocialMgr
         SocialMgr();
         ~SocialMgr();
         // Misc
-        void RemovePlayerSocial(uint32 guid) { m_socialMap.erase(guid); }
+        void RemovePlayerSocial(uint32 guid);
 
         void GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo& friendInfo) const;
         // Packet management
@@ -146,7 +149,14 @@ class SocialMgr
         // Loading
         PlayerSocial* LoadFromDB(QueryResult* result, ObjectGuid guid);
     private:
+        friend class PlayerSocial;
+
+        void AddFriendLister(uint32 friendGuid, uint32 listerGuid);
+        void RemoveFriendLister(uint32 friendGuid, uint32 listerGuid);
+
         SocialMap m_socialMap;
+        // loaded social lists having the player as friend, by player guid, so status broadcasts do not walk every list
+        std::unordered_map<uint32, std::unordered_set<uint32>> m_friendListers;
 };
 
 #define sSocialMgr MaNGOS::Singleton<SocialMgr>::Instance()
@@ -0,0 +1,82 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Social/WhoListCache.h"
+#include "Entities/Player.h"
+#include "Globals/ObjectAccessor.h"
+#include "Guilds/GuildMgr.h"
+#include "Server/WorldSession.h"
+
+#include <algorithm>
+
+INSTANTIATE_SINGLETON_1(WhoListCache);
+
+std::pair<uint32, uint32> WhoListSnapshot::GetLevelRange(uint32 levelMin, uint32 levelMax) const
+{
+    auto first = std::lower_bound(m_entries.begin(), m_entries.end(), levelMin, [](WhoListEntry const& entry, uint32 level) { return entry.level < level; });
+    auto last = std::upper_bound(first, m_entries.end(), levelMax, [](uint32 level, WhoListEntry const& entry) { return level < entry.level; });
+    return std::make_pair(uint32(first - m_entries.begin()), uint32(last - m_entries.begin()));
+}
+
+void WhoListCache::Rebuild()
+{
+    std::shared_ptr<WhoListSnapshot> snapshot = std::make_shared<WhoListSnapshot>();
+
+    {
+        HashMapHolder<Player>::ReadGuard guard(HashMapHolder<Player>::GetLock());
+        HashMapHolder<Player>::MapType const& players = sObjectAccessor.GetPlayers();
+        snapshot->m_entries.reserve(players.size());
+
+        for (auto const& itr : players)
+        {
+            Player* player = itr.second;
+            if (!player->IsInWorld())
+                continue;
+
+            snapshot->m_entries.emplace_back();
+            WhoListEntry& entry = snapshot->m_entries.back();
+            entry.guid = player->GetObjectGuid();
+            entry.name = player->GetName();
+            entry.guildName = sGuildMgr.GetGuildNameById(player->GetGuildId());
+            entry.level = player->getLevel();
+            entry.zoneId = player->GetZoneId();
+            entry.team = player->GetTeam();
+            entry.security = player->GetSession()->GetSecurity();
+            entry.class_ = player->getClass();
+            entry.race = player->getRace();
+            entry.gender = player->getGender();
+            entry.visibility = player->GetVisibility();
+
+            // entries with names not convertible are never listed, like the search did before
+            if (!Utf8toWStr(entry.name, entry.wname) || !Utf8toWStr(entry.guildName, entry.wguildName))
+            {
+                snapshot->m_entries.pop_back();
+                continue;
+            }
+            wstrToLower(entry.wname);
+            wstrToLower(entry.wguildName);
+        }
+    }
+
+    std::stable_sort(snapshot->m_entries.begin(), snapshot->m_entries.end(), [](WhoListEntry const& a, WhoListEntry const& b) { return a.level < b.level; });
+
+    for (uint32 i = 0; i < snapshot->m_entries.size(); ++i)
+        snapshot->m_byZone[snapshot->m_entries[i].zoneId].push_back(i);
+
+    std::atomic_store(&m_snapshot, std::shared_ptr<WhoListSnapshot const>(std::move(snapshot)));
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WHOLISTCACHE_H
+#define MANGOS_WHOLISTCACHE_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+#include "Policies/Singleton.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/// Online player as the who list sees it, names are kept lower case for the searches
+struct WhoListEntry
+{
+    ObjectGuid guid;
+    std::string name;
+    std::string guildName;
+    std::wstring wname;
+    std::wstring wguildName;
+    uint32 level;
+    uint32 zoneId;
+    uint32 team;
+    uint32 security;                                        // AccountTypes of the player's session
+    uint8 class_;
+    uint8 race;
+    uint8 gender;
+    uint8 visibility;                                       // UnitVisibility
+};
+
+/// Immutable list of the players in world, ordered by level and indexed by zone
+class WhoListSnapshot
+{
+    public:
+        typedef std::vector<WhoListEntry> EntryList;
+        typedef std::vector<uint32> IndexList;              // positions in the entry list, in level order
+
+        EntryList const& GetEntries() const { return m_entries; }
+        // nullptr if nobody is in the zone
+        IndexList const* GetZoneEntries(uint32 zoneId) const
+        {
+            auto itr = m_byZone.find(zoneId);
+            return itr != m_byZone.end() ? &itr->second : nullptr;
+        }
+
+        // first and past the last position of the entries in the level range
+        std::pair<uint32, uint32> GetLevelRange(uint32 levelMin, uint32 levelMax) const;
+
+    private:
+        friend class WhoListCache;
+
+        EntryList m_entries;
+        std::unordered_map<uint32, IndexList> m_byZone;
+};
+
+/**
+ * Snapshot of the online players for CMSG_WHO, rebuilt by the world update at WhoList.SnapshotInterval.
+ * The handler reads a published snapshot without touching the player map or the guilds, so it runs
+ * in the parallel session phase and /who spam does not cost any player map lock.
+ */
+class WhoListCache
+{
+    public:
+        WhoListCache() : m_snapshot(std::make_shared<WhoListSnapshot>()) {}
+
+        // called by the world thread between the session and the map updates
+        void Rebuild();
+
+        std::shared_ptr<WhoListSnapshot const> GetSnapshot() const { return std::atomic_load(&m_snapshot); }
+
+    private:
+        std::shared_ptr<WhoListSnapshot const> m_snapshot;
+};
+
+#define sWhoListCache MaNGOS::Singleton<WhoListCache>::Instance()
+
+#endif
@@ -58,6 +58,7 @@ struct HuntersMark : public AuraScript
             aura->GetModifier()->m_amount += basevalue / 10;
             if (aura->GetModifier()->m_amount > basevalue * 4)
                 aura->GetModifier()->m_amount = basevalue * 4;
+            aura->GetTarget()->InvalidateAuraModifierCache(aura->GetModifier()->m_auraname);
         }
         return SPELL_AURA_PROC_OK;
     }
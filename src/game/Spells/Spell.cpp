@@ -46,6 +46,7 @@
 #include "MotionGenerators/PathFinder.h"
 #include "Spells/Scripts/SpellScript.h"
 #include "Entities/ObjectGuid.h"
+#include "Spells/SpellProfiler.h"
 
 extern pEffect SpellEffects[MAX_SPELL_EFFECTS];
 
@@ -408,6 +409,8 @@ Spell::Spell(Unit* caster, SpellEntry const* info, uint32 triggeredFlags, Object
     m_needSpellLog = (m_spellInfo->Attributes & (SPELL_ATTR_HIDE_IN_COMBAT_LOG | SPELL_ATTR_HIDDEN_CLIENTSIDE)) == 0;
 
     m_targetlessMask = 0;
+    m_areaTargetQueries = nullptr;
+    m_areaTargetQueryCount = 0;
 }
 
 Spell::~Spell()
@@ -434,10 +437,55 @@ WorldObject* Spell::FindCorpseUsing()
     return result;
 }
 
+struct SpellAreaTargetQuery
+{
+    float radius;
+    float cone;
+    SpellNotifyPushType pushType;
+    SpellTargets spellTargets;
+    WorldObject* originalCaster;
+    float centerX;
+    float centerY;
+    float centerZ;
+    std::vector<Unit*> units;
+};
+
+// Spells cast while targets are filled fill their own targets, so every nesting level has its own query list.
+// The lists keep their buffers for the next spells of the thread and a deque does not move the ones in use when it grows.
+static thread_local std::deque<std::vector<SpellAreaTargetQuery>> s_areaTargetQueryLists;
+static thread_local uint32 s_areaTargetQueryDepth = 0;
+
+class AreaTargetQueryGuard
+{
+    public:
+        AreaTargetQueryGuard(std::vector<SpellAreaTargetQuery>*& queries, uint32& count) :
+            m_queries(queries), m_count(count), m_prevQueries(queries), m_prevCount(count)
+        {
+            if (s_areaTargetQueryLists.size() <= s_areaTargetQueryDepth)
+                s_areaTargetQueryLists.emplace_back();
+            m_queries = &s_areaTargetQueryLists[s_areaTargetQueryDepth++];
+            m_count = 0;
+        }
+        ~AreaTargetQueryGuard()
+        {
+            m_queries = m_prevQueries;
+            m_count = m_prevCount;
+            --s_areaTargetQueryDepth;
+        }
+
+    private:
+        std::vector<SpellAreaTargetQuery>*& m_queries;
+        uint32& m_count;
+        std::vector<SpellAreaTargetQuery>* m_prevQueries;
+        uint32 m_prevCount;
+};
+
 void Spell::FillTargetMap()
 {
     // TODO: ADD the correct target FILLS!!!!!!
     TempTargetingData targetingData;
+    // effects asking for the same area get the units of one grid visit, nothing moves until all effects are filled
+    AreaTargetQueryGuard areaTargetQueryGuard(m_areaTargetQueries, m_areaTargetQueryCount);
     uint8 effToIndex[MAX_EFFECT_INDEX] = {0, 1, 2};         // Helper array, to link to another tmpUnitList, if the targets for both effects match
     for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
     {
@@ -524,6 +572,7 @@ void Spell::FillTargetMap()
                     SpellTargetFilterScheme scheme = filterScheme[rightTarget];
                     if (!unitTargetList.empty()) // Unit case
                     {
+                        FillTargetsLineOfSight(unitTargetList, SpellEffectIndex(i));
                         for (auto itr = unitTargetList.begin(); itr != unitTargetList.end();)
                         {
                             if (!CheckTarget(*itr, SpellEffectIndex(i), bool(rightTarget), CheckException(targetingData.magnet)))
@@ -531,6 +580,7 @@ void Spell::FillTargetMap()
                             else
                                 ++itr;
                         }
+                        m_targetsLineOfSight.clear();
 
                         // Special target filter before adding targets to list
                         FilterTargetMap(unitTargetList, SpellEffectIndex(i), scheme, targetingData.chainTargetCount[i]);
@@ -2734,6 +2784,8 @@ SpellCastResult Spell::PreCastCheck(Aura* triggeredByAura /*= nullptr*/)
 
 SpellCastResult Spell::SpellStart(SpellCastTargets const* targets, Aura* triggeredByAura)
 {
+    SpellProfiler::Scope profile(SPELL_PROFILE_START, m_spellInfo->Id);
+
     m_spellState = SPELL_STATE_TARGETING;
     m_targets = *targets;
 
@@ -2881,6 +2933,8 @@ void Spell::cancel()
 
 void Spell::cast(bool skipCheck)
 {
+    SpellProfiler::Scope profile(SPELL_PROFILE_CAST, m_spellInfo->Id);
+
     SetExecutedCurrently(true);
 
     if (!m_caster->CheckAndIncreaseCastCounter())
@@ -4174,6 +4228,8 @@ void Spell::HandleThreatSpells()
 
 void Spell::HandleEffects(Unit* pUnitTarget, Item* pItemTarget, GameObject* pGOTarget, SpellEffectIndex i, float DamageMultiplier)
 {
+    SpellProfiler::Scope profile(SPELL_PROFILE_EFFECT, m_spellInfo->Id, i, m_spellInfo->Effect[i]);
+
     unitTarget = pUnitTarget;
     itemTarget = pItemTarget;
     gameObjTarget = pGOTarget;
@@ -4198,6 +4254,8 @@ void Spell::HandleEffects(Unit* pUnitTarget, Item* pItemTarget, GameObject* pGOT
     if (eff < MAX_SPELL_EFFECTS)
     {
         OnEffectExecute(i);
+
+        SpellProfiler::Scope handlerProfile(SPELL_PROFILE_EFFECT_HANDLER, m_spellInfo->Id, i, eff);
         (*this.*SpellEffects[eff])(i);
     }
     else
@@ -6363,6 +6421,48 @@ CurrentSpellTypes Spell::GetCurrentContainer() const
     return (CURRENT_GENERIC_SPELL);
 }
 
+void Spell::FillTargetsLineOfSight(UnitList const& targets, SpellEffectIndex effIndex)
+{
+    // only the normal case of CheckTarget tests from the casting object
+    if (targets.size() < 2 || IsIgnoreLosSpellEffect(m_spellInfo, effIndex) || m_spellInfo->EffectImplicitTargetA[effIndex] == TARGET_LOCATION_DYNOBJ_POSITION)
+        return;
+
+    switch (m_spellInfo->Effect[effIndex])
+    {
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return;
+        default:
+            break;
+    }
+
+    WorldObject* caster = GetCastingObject();
+    if (!caster)
+        return;
+
+    std::vector<Unit const*> units;
+    std::vector<G3D::Vector3> positions;
+    units.reserve(targets.size());
+    positions.reserve(targets.size());
+    for (Unit* target : targets)
+    {
+        if (target == m_caster || !target->IsInMap(caster))
+            continue;
+
+        units.push_back(target);
+        positions.emplace_back(target->GetPositionX(), target->GetPositionY(), target->GetPositionZ() + target->GetCollisionHeight());
+    }
+
+    if (units.size() < 2)
+        return;
+
+    // same segment as IsWithinLOSInMap of the target, traced from the caster so the origin is shared
+    std::vector<bool> results;
+    caster->GetMap()->IsInLineOfSight(caster->GetPositionX(), caster->GetPositionY(), caster->GetPositionZ() + caster->GetCollisionHeight(), positions, results, true);
+    for (size_t i = 0; i < units.size(); ++i)
+        m_targetsLineOfSight[units[i]] = results[i];
+}
+
 bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckException exception) const
 {
     // Check targets for creature type mask and remove not appropriate (skip explicit self target case, maybe need other explicit targets)
@@ -6457,8 +6557,11 @@ bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckE
                                     return false;
                         }
                         else if (WorldObject* caster = GetCastingObject())
-                            if (!target->IsWithinLOSInMap(caster, true))
+                        {
+                            auto los = m_targetsLineOfSight.find(target);
+                            if (los != m_targetsLineOfSight.end() ? !los->second : !target->IsWithinLOSInMap(caster, true))
                                 return false;
+                        }
                     }
                 }
                 break;
@@ -6712,7 +6815,41 @@ SpellCastResult Spell::CanOpenLock(SpellEffectIndex effIndex, uint32 lockId, Ski
 void Spell::FillAreaTargets(UnitList& targetUnitMap, float radius, float cone, SpellNotifyPushType pushType, SpellTargets spellTargets, WorldObject* originalCaster /*=nullptr*/)
 {
     MaNGOS::SpellNotifierCreatureAndPlayer notifier(*this, targetUnitMap, radius, cone, pushType, spellTargets, originalCaster);
+    if (!m_areaTargetQueries)
+    {
+        Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_caster->GetMap(), notifier, radius);
+        return;
+    }
+
+    for (uint32 i = 0; i < m_areaTargetQueryCount; ++i)
+    {
+        SpellAreaTargetQuery const& query = (*m_areaTargetQueries)[i];
+        if (query.radius == radius && query.cone == cone && query.pushType == pushType && query.spellTargets == spellTargets &&
+            query.originalCaster == notifier.i_originalCaster && query.centerX == notifier.GetCenterX() &&
+            query.centerY == notifier.GetCenterY() && query.centerZ == notifier.GetCenterZ())
+        {
+            targetUnitMap.insert(targetUnitMap.end(), query.units.begin(), query.units.end());
+            return;
+        }
+    }
+
+    // callers may pass a list that already holds units, only the ones found here belong to the query
+    UnitList::iterator last = targetUnitMap.empty() ? targetUnitMap.end() : std::prev(targetUnitMap.end());
     Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_caster->GetMap(), notifier, radius);
+    UnitList::iterator first = last == targetUnitMap.end() ? targetUnitMap.begin() : std::next(last);
+
+    if (m_areaTargetQueries->size() <= m_areaTargetQueryCount)
+        m_areaTargetQueries->emplace_back();
+    SpellAreaTargetQuery& query = (*m_areaTargetQueries)[m_areaTargetQueryCount++];
+    query.radius = radius;
+    query.cone = cone;
+    query.pushType = pushType;
+    query.spellTargets = spellTargets;
+    query.originalCaster = notifier.i_originalCaster;
+    query.centerX = notifier.GetCenterX();
+    query.centerY = notifier.GetCenterY();
+    query.centerZ = notifier.GetCenterZ();
+    query.units.assign(first, targetUnitMap.end());
 }
 
 void Spell::FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, float radius, bool raid, bool withPets, bool withcaster) const
@@ -38,6 +38,7 @@ class Group;
 class Aura;
 struct SpellTargetEntry;
 struct SpellScript;
+struct SpellAreaTargetQuery;
 
 enum SpellCastFlags
 {
@@ -693,6 +694,8 @@ class Spell
         bool CheckAndAddMagnetTarget(Unit* unitTarget, SpellEffectIndex effIndex, bool targetB, TempTargetingData& data);
         static void CheckSpellScriptTargets(SQLMultiStorage::SQLMSIteratorBounds<SpellTargetEntry>& bounds, UnitList& tempTargetUnitMap, UnitList& targetUnitMap, SpellEffectIndex effIndex);
         void FilterTargetMap(UnitList& filterUnitList, SpellEffectIndex effIndex, SpellTargetFilterScheme scheme, uint32 chainTargetCount);
+        // line of sight of the casting object to all targets in one map query, used by CheckTarget
+        void FillTargetsLineOfSight(UnitList const& targets, SpellEffectIndex effIndex);
         void FillFromTargetFlags(TempTargetingData& targetingData, SpellEffectIndex effIndex);
 
         void FillAreaTargets(UnitList& targetUnitMap, float radius, float cone, SpellNotifyPushType pushType, SpellTargets spellTargets, WorldObject* originalCaster = nullptr);
@@ -756,6 +759,9 @@ class Spell
         ItemTargetList m_UniqueItemInfo;
         uint32         m_targetlessMask;
         DestTargetInfo m_destTargetInfo;
+        std::unordered_map<Unit const*, bool> m_targetsLineOfSight;
+        std::vector<SpellAreaTargetQuery>* m_areaTargetQueries; // area searches of the running FillTargetMap, shared by its effects
+        uint32 m_areaTargetQueryCount;
 
         void AddUnitTarget(Unit* target, uint8 effectMask, CheckException exception = EXCEPTION_NONE);
         void AddGOTarget(GameObject* target, uint8 effectMask);
@@ -868,11 +874,12 @@ namespace MaNGOS
 
         float GetCenterX() const { return i_centerX; }
         float GetCenterY() const { return i_centerY; }
+        float GetCenterZ() const { return i_centerZ; }
 
         SpellNotifierCreatureAndPlayer(Spell& spell, UnitList& data, float radius, float cone, SpellNotifyPushType type,
                                        SpellTargets TargetType = SPELL_TARGETS_AOE_ATTACKABLE, WorldObject* originalCaster = nullptr)
             : i_data(data), i_spell(spell), i_push_type(type), i_radius(radius), i_cone(cone), i_TargetType(TargetType),
-              i_originalCaster(originalCaster), i_castingObject(i_spell.GetCastingObject())
+              i_originalCaster(originalCaster), i_castingObject(i_spell.GetCastingObject()), i_centerX(0.f), i_centerY(0.f), i_centerZ(0.f)
         {
             if (!i_originalCaster)
                 i_originalCaster = i_spell.GetAffectiveCasterObject();
@@ -49,6 +49,7 @@
 #include "Entities/TemporarySpawn.h"
 #include "Maps/InstanceData.h"
 #include "AI/ScriptDevAI/include/sc_grid_searchers.h"
+#include "Spells/SpellProfiler.h"
 
 #define NULL_AURA_SLOT 0xFF
 
@@ -590,15 +591,14 @@ void AreaAura::Update(uint32 diff)
                     else    // handle aura party for creatures
                     {
                         // Get all creatures in spell radius
-                        std::list<Creature*> nearbyTargets;
+                        std::list<Unit*> nearbyTargets;
                         MaNGOS::AnyUnitInObjectRangeCheck u_check(owner, m_radius);
-                        MaNGOS::CreatureListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(nearbyTargets, u_check);
-                        Cell::VisitGridObjects(owner, searcher, m_radius);
+                        owner->GetMap()->GetUnitSpatialHash().SearchUnits(owner->GetPositionX(), owner->GetPositionY(), m_radius + owner->GetObjectBoundingRadius(), nearbyTargets, u_check);
 
                         for (auto target : nearbyTargets)
                         {
                             // Due to the lack of support for NPC groups or formations, are considered of the same party NPCs with same faction than caster
-                            if (target != owner && target->isAlive() && target->getFaction() == ((Creature*)owner)->getFaction())
+                            if (target->GetTypeId() == TYPEID_UNIT && target != owner && target->isAlive() && target->getFaction() == ((Creature*)owner)->getFaction())
                                 targets.push_back(target);
                         }
                     }
@@ -616,15 +616,13 @@ void AreaAura::Update(uint32 diff)
                 case AREA_AURA_FRIEND:
                 {
                     MaNGOS::AnyFriendlyUnitInObjectRangeCheck u_check(caster, nullptr, m_radius);
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-                    Cell::VisitAllObjects(caster, searcher, m_radius);
+                    caster->GetMap()->GetUnitSpatialHash().SearchUnits(caster->GetPositionX(), caster->GetPositionY(), m_radius + caster->GetObjectBoundingRadius(), targets, u_check);
                     break;
                 }
                 case AREA_AURA_ENEMY:
                 {
                     MaNGOS::AnyAoETargetUnitInObjectRangeCheck u_check(caster, nullptr, m_radius); // No GetCharmer in searcher
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyAoETargetUnitInObjectRangeCheck> searcher(targets, u_check);
-                    Cell::VisitAllObjects(caster, searcher, m_radius);
+                    caster->GetMap()->GetUnitSpatialHash().SearchUnits(caster->GetPositionX(), caster->GetPositionY(), m_radius + caster->GetObjectBoundingRadius(), targets, u_check);
                     break;
                 }
                 case AREA_AURA_OWNER:
@@ -816,10 +814,17 @@ void Aura::ApplyModifier(bool apply, bool Real)
 {
     AuraType aura = m_modifier.m_auraname;
 
+    // handlers may start or change periodic timers
+    GetTarget()->ResyncAuraUpdates();
+
     if (apply)
         OnApply(apply);
     if (aura < TOTAL_AURAS)
+    {
         (*this.*AuraHandler [aura])(apply, Real);
+        // handlers may adjust the amount, drop aggregates computed from the old one
+        GetTarget()->InvalidateAuraModifierCache(aura);
+    }
     if (!apply)
         OnApply(apply);
 }
@@ -1717,6 +1722,7 @@ void Aura::TriggerSpell()
                                 UnitMods unitMod = UnitMods(UNIT_MOD_POWER_START + m_modifier.m_miscvalue);
                                 GetTarget()->HandleStatModifier(unitMod, TOTAL_PCT, float(aura->m_modifier.m_amount), false);
                                 aura->m_modifier.m_amount -= 5;
+                                GetTarget()->InvalidateAuraModifierCache(aura->m_modifier.m_auraname);
                                 GetTarget()->HandleStatModifier(unitMod, TOTAL_PCT, float(aura->m_modifier.m_amount), true);
                             }
                         }
@@ -5752,6 +5758,7 @@ void Aura::HandleAuraModStat(bool apply, bool /*Real*/)
             target->RemoveAurasTriggeredBySpell(GetId(), GetCasterGuid()); // just do it every time, lookup is too time consuming
     }
 
+    StatUpdateBatch statBatch(target);
     for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
         // -1 or -2 is all stats ( misc < -2 checked in function beginning )
@@ -5777,6 +5784,7 @@ void Aura::HandleModPercentStat(bool apply, bool /*Real*/)
     if (GetTarget()->GetTypeId() != TYPEID_PLAYER)
         return;
 
+    StatUpdateBatch statBatch(GetTarget());
     for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
         if (m_modifier.m_miscvalue == i || m_modifier.m_miscvalue == -1)
@@ -5856,13 +5864,17 @@ void Aura::HandleModTotalPercentStat(bool apply, bool /*Real*/)
     uint32 curHPValue = target->GetHealth();
     uint32 maxHPValue = target->GetMaxHealth();
 
-    for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
-        if (m_modifier.m_miscvalue == i || m_modifier.m_miscvalue == -1)
+        // the new max health is read below, the batch has to end first
+        StatUpdateBatch statBatch(target);
+        for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
         {
-            target->HandleStatModifier(UnitMods(UNIT_MOD_STAT_START + i), TOTAL_PCT, float(m_modifier.m_amount), apply);
-            if (target->GetTypeId() == TYPEID_PLAYER || ((Creature*)target)->IsPet())
-                target->ApplyStatPercentBuffMod(Stats(i), float(m_modifier.m_amount), apply);
+            if (m_modifier.m_miscvalue == i || m_modifier.m_miscvalue == -1)
+            {
+                target->HandleStatModifier(UnitMods(UNIT_MOD_STAT_START + i), TOTAL_PCT, float(m_modifier.m_amount), apply);
+                if (target->GetTypeId() == TYPEID_PLAYER || ((Creature*)target)->IsPet())
+                    target->ApplyStatPercentBuffMod(Stats(i), float(m_modifier.m_amount), apply);
+            }
         }
     }
 
@@ -6961,6 +6973,8 @@ void Aura::HandleSchoolAbsorb(bool apply, bool Real)
 
 void Aura::PeriodicTick()
 {
+    SpellProfiler::Scope profile(SPELL_PROFILE_PERIODIC_TICK, GetId(), GetEffIndex(), m_modifier.m_auraname);
+
     Unit* target = GetTarget();
     // passive periodic trigger spells should not be updated when dead, only death persistent should
     if (!target->isAlive() && GetHolder()->IsPassive())
@@ -7027,7 +7041,10 @@ void Aura::PeriodicTick()
                 case 40932: // Agonizing Flames - Illidan
                 {
                     if (GetAuraTicks() % 3 == 0) // increased damage after every 3rd tick
+                    {
                         m_modifier.m_amount += m_modifier.m_baseAmount;
+                        target->InvalidateAuraModifierCache(m_modifier.m_auraname);
+                    }
                     break;
                 }
                 case 41337: // Aura of Anger
@@ -7814,6 +7831,7 @@ void Aura::PeriodicDummyTick()
                 if (Aura* aura = GetHolder()->GetAuraByEffectIndex(SpellEffectIndex(GetEffIndex() - 1)))
                 {
                     aura->GetModifier()->m_amount = m_modifier.m_amount;
+                    target->InvalidateAuraModifierCache(aura->GetModifier()->m_auraname);
                     ((Player*)target)->UpdateManaRegen();
                     // Disable continue
                     m_isPeriodic = false;
@@ -8068,6 +8086,8 @@ SpellAuraHolder::SpellAuraHolder(SpellEntry const* spellproto, Unit* target, Wor
     m_auraScript(SpellScriptMgr::GetAuraScript(spellproto->Id))
 {
     MANGOS_ASSERT(target);
+    // the new duration counts from now, not from the last aura update of the target
+    target->ResyncAuraUpdates();
     MANGOS_ASSERT(spellproto && spellproto == sSpellTemplate.LookupEntry<SpellEntry>(spellproto->Id) && "`info` must be pointer to sSpellTemplate element");
 
     if (!caster)
@@ -8689,6 +8709,41 @@ void SpellAuraHolder::Update(uint32 diff)
     }
 }
 
+uint32 SpellAuraHolder::GetUpdateDelay() const
+{
+    if (m_skipUpdate)
+        return 0;
+
+    uint32 delay = UINT32_MAX;
+    for (auto aura : m_auras)
+        if (aura)
+            delay = std::min(delay, aura->GetUpdateDelay());
+
+    if (m_duration > 0)
+    {
+        delay = std::min(delay, uint32(m_duration));
+        // the power timer only matters for spells draining power
+        if (GetSpellProto()->manaPerSecond || GetSpellProto()->manaPerSecondPerLevel)
+            delay = std::min(delay, uint32(std::max(m_timeCla, 0)));
+    }
+
+    return delay;
+}
+
+int32 SpellAuraHolder::GetAuraDuration() const
+{
+    // time the target did not pass to its holders yet, see Unit::_UpdateSpells
+    if (m_duration > 0)
+        return std::max(m_duration - int32(m_target->GetPendingAuraUpdateTime()), 0);
+    return m_duration;
+}
+
+void SpellAuraHolder::SetAuraDuration(int32 duration)
+{
+    m_target->ResyncAuraUpdates();
+    m_duration = duration;
+}
+
 void SpellAuraHolder::RefreshHolder()
 {
     SetAuraDuration(GetAuraMaxDuration());
@@ -144,6 +144,7 @@ class SpellAuraHolder
 
         void UpdateHolder(uint32 diff) { Update(diff); }
         void Update(uint32 diff);
+        uint32 GetUpdateDelay() const;                      // time until a timer of the holder runs out
         void RefreshHolder();
 
         TrackedAuraType GetTrackedAuraType() const { return m_trackedAuraType; }
@@ -152,8 +153,8 @@ class SpellAuraHolder
 
         int32 GetAuraMaxDuration() const { return m_maxDuration; }
         void SetAuraMaxDuration(int32 duration);
-        int32 GetAuraDuration() const { return m_duration; }
-        void SetAuraDuration(int32 duration) { m_duration = duration; }
+        int32 GetAuraDuration() const;
+        void SetAuraDuration(int32 duration);
 
         uint8 GetAuraSlot() const { return m_auraSlot; }
         void SetAuraSlot(uint8 slot) { m_auraSlot = slot; }
@@ -459,6 +460,8 @@ class Aura
         void ApplyModifier(bool apply, bool Real = false);
 
         void UpdateAura(uint32 diff) { Update(diff); }
+        // time until the aura has to be updated, auras doing work on every update return 0
+        virtual uint32 GetUpdateDelay() const { return m_isPeriodic ? uint32(std::max(m_periodicTimer, 0)) : UINT32_MAX; }
 
         void SetRemoveMode(AuraRemoveMode mode) { m_removeMode = mode; }
         AuraRemoveMode GetRemoveMode() { return m_removeMode; }
@@ -551,6 +554,7 @@ class AreaAura : public Aura
         ~AreaAura();
     protected:
         void Update(uint32 diff) override;
+        uint32 GetUpdateDelay() const override { return 0; }
     private:
         float m_radius;
         AreaAuraType m_areaAuraType;
@@ -564,6 +568,7 @@ class PersistentAreaAura : public Aura
         ~PersistentAreaAura();
     protected:
         void Update(uint32 diff) override;
+        uint32 GetUpdateDelay() const override { return 0; }
 };
 
 class SingleEnemyTargetAura : public Aura
@@ -588,6 +593,7 @@ class GameObjectAura : public Aura
 
     protected:
         void Update(uint32 diff) override;
+        uint32 GetUpdateDelay() const override { return 0; }
 };
 
 Aura* CreateAura(SpellEntry const* spellproto, SpellEffectIndex eff, int32 const* currentDamage, int32 const* currentBasePoints, SpellAuraHolder* holder, Unit* target, Unit* caster = nullptr, Item* castItem = nullptr);
@@ -0,0 +1,64 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Spells/SpellHotData.h"
+#include "Spells/SpellMgr.h"
+#include "Log.h"
+
+SpellHotDataStore sSpellHotData;
+
+void SpellHotDataStore::Load()
+{
+    // built aside, the predicates used here read the spell entries until the table is published
+    std::vector<SpellHotData> data(sSpellTemplate.GetMaxEntry());
+    uint32 count = 0;
+
+    for (uint32 i = 1; i < sSpellTemplate.GetMaxEntry(); ++i)
+    {
+        SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(i);
+        if (!spellInfo)
+            continue;
+
+        SpellHotData& hot = data[i];
+        hot.valid = true;
+        for (uint32 effIdx = EFFECT_INDEX_0; effIdx < MAX_EFFECT_INDEX; ++effIdx)
+        {
+            // rows with values out of range stay invalid and are read from the spell entry
+            if (spellInfo->Effect[effIdx] > 0xFF || spellInfo->EffectApplyAuraName[effIdx] > 0xFFFF)
+                hot.valid = false;
+
+            hot.effect[effIdx] = uint8(spellInfo->Effect[effIdx]);
+            hot.effectApplyAuraName[effIdx] = uint16(spellInfo->EffectApplyAuraName[effIdx]);
+
+            if (spellInfo->Effect[effIdx])
+                hot.effectMask |= (1 << effIdx);
+            if (IsAuraApplyEffect(spellInfo, SpellEffectIndex(effIdx)))
+                hot.auraApplyEffectMask |= (1 << effIdx);
+            if (IsPositiveEffect(spellInfo, SpellEffectIndex(effIdx)))
+                hot.positiveEffectMask |= (1 << effIdx);
+        }
+
+        if (hot.valid)
+            ++count;
+    }
+
+    m_data.swap(data);
+
+    sLog.outString(">> Built spell effect data for %u spells", count);
+    sLog.outString();
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SPELLHOTDATA_H
+#define MANGOS_SPELLHOTDATA_H
+
+#include "Common.h"
+#include "Server/DBCEnums.h"
+
+#include <vector>
+
+/**
+ * Effect data of one spell_template row packed into 16 bytes, so it never spans two cache lines.
+ * The effect and aura columns of SpellEntry lie hundreds of bytes behind Id and Attributes,
+ * the effect predicates of SpellMgr.h read them from here instead.
+ */
+struct alignas(16) SpellHotData
+{
+    uint16 effectApplyAuraName[MAX_EFFECT_INDEX];
+    uint8 effect[MAX_EFFECT_INDEX];
+    uint8 effectMask;                                       // effects that are set
+    uint8 auraApplyEffectMask;                              // effects applying an aura, see IsAuraApplyEffect
+    uint8 positiveEffectMask;                               // effects positive without a known target, see IsPositiveEffect
+    bool valid;                                             // row values fit the fields above
+};
+
+static_assert(sizeof(SpellHotData) == 16, "SpellHotData must fit 4 records into a cache line");
+
+class SpellHotDataStore
+{
+    public:
+        // must be called after spell_template is loaded
+        void Load();
+
+        SpellHotData const* LookupEntry(uint32 spellId) const
+        {
+            if (spellId >= m_data.size() || !m_data[spellId].valid)
+                return nullptr;
+            return &m_data[spellId];
+        }
+
+    private:
+        std::vector<SpellHotData> m_data;                   // by spell id
+};
+
+extern SpellHotDataStore sSpellHotData;
+
+#endif
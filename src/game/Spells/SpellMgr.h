@@ -36,6 +36,7 @@
 #include "Spells/SpellAuras.h"
 #include "Server/SQLStorages.h"
 #include "Spells/SpellEffectDefines.h"
+#include "Spells/SpellHotData.h"
 
 #include <map>
 
@@ -98,6 +99,14 @@ WeaponAttackType GetWeaponAttackType(SpellEntry const* spellInfo);
 
 inline bool IsSpellHaveEffect(SpellEntry const* spellInfo, SpellEffects effect)
 {
+    if (SpellHotData const* hot = sSpellHotData.LookupEntry(spellInfo->Id))
+    {
+        for (uint8 i : hot->effect)
+            if (SpellEffects(i) == effect)
+                return true;
+        return false;
+    }
+
     for (unsigned int i : spellInfo->Effect)
         if (SpellEffects(i) == effect)
             return true;
@@ -106,6 +115,9 @@ inline bool IsSpellHaveEffect(SpellEntry const* spellInfo, SpellEffects effect)
 
 inline bool IsAuraApplyEffect(SpellEntry const* spellInfo, SpellEffectIndex effecIdx)
 {
+    if (SpellHotData const* hot = sSpellHotData.LookupEntry(spellInfo->Id))
+        return (hot->auraApplyEffectMask & (1 << effecIdx)) != 0;
+
     switch (spellInfo->Effect[effecIdx])
     {
         case SPELL_EFFECT_APPLY_AURA:
@@ -124,6 +136,12 @@ inline bool IsAuraApplyEffects(SpellEntry const* entry, SpellEffectIndexMask mas
 {
     if (!entry)
         return false;
+    if (SpellHotData const* hot = sSpellHotData.LookupEntry(entry->Id))
+    {
+        if (mask & hot->effectMask & ~hot->auraApplyEffectMask)
+            return false;
+        return (mask & hot->effectMask) != 0;
+    }
     uint32 emptyMask = 0;
     for (uint32 i = EFFECT_INDEX_0; i < MAX_EFFECT_INDEX; ++i)
     {
@@ -143,6 +161,9 @@ inline bool IsAuraApplyEffects(SpellEntry const* entry, SpellEffectIndexMask mas
 
 inline bool IsSpellAppliesAura(SpellEntry const* spellInfo, uint32 effectMask = ((1 << EFFECT_INDEX_0) | (1 << EFFECT_INDEX_1) | (1 << EFFECT_INDEX_2)))
 {
+    if (SpellHotData const* hot = sSpellHotData.LookupEntry(spellInfo->Id))
+        return (hot->auraApplyEffectMask & effectMask) != 0;
+
     for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (effectMask & (1 << i))
             if (IsAuraApplyEffect(spellInfo, SpellEffectIndex(i)))
@@ -183,6 +204,15 @@ inline bool IsPeriodicRegenerateEffect(SpellEntry const* spellInfo, SpellEffectI
 
 inline bool IsSpellHaveAura(SpellEntry const* spellInfo, AuraType aura, uint32 effectMask = (1 << EFFECT_INDEX_0) | (1 << EFFECT_INDEX_1) | (1 << EFFECT_INDEX_2))
 {
+    if (SpellHotData const* hot = sSpellHotData.LookupEntry(spellInfo->Id))
+    {
+        for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
+            if (effectMask & (1 << i))
+                if (AuraType(hot->effectApplyAuraName[i]) == aura)
+                    return true;
+        return false;
+    }
+
     for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (effectMask & (1 << i))
             if (AuraType(spellInfo->EffectApplyAuraName[i]) == aura)
@@ -1012,6 +1042,11 @@ inline bool IsPositiveEffect(const SpellEntry* spellproto, SpellEffectIndex effI
     if (!spellproto)
         return false;
 
+    // without a target the result only depends on the spell data
+    if (!target)
+        if (SpellHotData const* hot = sSpellHotData.LookupEntry(spellproto->Id))
+            return (hot->positiveEffectMask & (1 << effIndex)) != 0;
+
     switch (spellproto->Id) // Spells whose effects are always positive
     {
         case 24742: // Magic Wings
@@ -1211,6 +1246,9 @@ inline bool IsPositiveSpell(const SpellEntry* entry, const WorldObject* caster =
 {
     if (!entry)
         return false;
+    if (!target)
+        if (SpellHotData const* hot = sSpellHotData.LookupEntry(entry->Id))
+            return !(hot->effectMask & ~hot->positiveEffectMask);
     // spells with at least one negative effect are considered negative
     // some self-applied spells have negative effects but in self casting case negative check ignored.
     for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
@@ -1224,6 +1262,9 @@ inline bool IsPositiveEffectMask(const SpellEntry* entry, uint8 effectMask, cons
 {
     if (!entry)
         return false;
+    if (!target)
+        if (SpellHotData const* hot = sSpellHotData.LookupEntry(entry->Id))
+            return !(hot->effectMask & effectMask & ~hot->positiveEffectMask);
     // spells with at least one negative effect are considered negative
     // some self-applied spells have negative effects but in self casting case negative check ignored.
     for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
@@ -0,0 +1,173 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Spells/SpellProfiler.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+std::atomic<bool> SpellProfiler::m_enabled(false);
+std::atomic<uint32> SpellProfiler::m_sampleRate(16);
+
+namespace
+{
+    struct ProfileEntry
+    {
+        ProfileEntry() : count(0), totalUs(0), maxUs(0) {}
+
+        uint64 count;                                       // sampled calls
+        uint64 totalUs;
+        uint64 maxUs;
+    };
+
+    // every thread records into its own table, the lock is only contended while a report is built
+    struct ProfileTable
+    {
+        std::mutex lock;
+        std::unordered_map<uint64, ProfileEntry> entries;
+        uint32 sampleRate;                                  // rate the entries were sampled with
+    };
+
+    std::mutex tablesLock;
+    std::vector<std::shared_ptr<ProfileTable>> tables;      // kept after their thread is gone
+
+    ProfileTable& GetThreadTable()
+    {
+        static thread_local std::shared_ptr<ProfileTable> table;
+        if (!table)
+        {
+            table = std::make_shared<ProfileTable>();
+            table->sampleRate = SpellProfiler::GetSampleRate();
+            std::lock_guard<std::mutex> guard(tablesLock);
+            tables.push_back(table);
+        }
+        return *table;
+    }
+
+    char const* const stageNames[MAX_SPELL_PROFILE_STAGE] = { "start", "cast", "effect", "handler", "tick" };
+}
+
+bool SpellProfiler::Sample()
+{
+    static thread_local uint32 counter = 0;
+    if (++counter < GetSampleRate())
+        return false;
+
+    counter = 0;
+    return true;
+}
+
+void SpellProfiler::Record(uint64 key, uint64 us)
+{
+    ProfileTable& table = GetThreadTable();
+    std::lock_guard<std::mutex> guard(table.lock);
+
+    // a changed rate restarts the table, scaling mixed samples would be wrong
+    uint32 const rate = GetSampleRate();
+    if (table.sampleRate != rate)
+    {
+        table.entries.clear();
+        table.sampleRate = rate;
+    }
+
+    ProfileEntry& entry = table.entries[key];
+    ++entry.count;
+    entry.totalUs += us;
+    entry.maxUs = std::max(entry.maxUs, us);
+}
+
+void SpellProfiler::Reset()
+{
+    std::lock_guard<std::mutex> guard(tablesLock);
+    for (auto const& table : tables)
+    {
+        std::lock_guard<std::mutex> tableGuard(table->lock);
+        table->entries.clear();
+    }
+}
+
+std::vector<SpellProfiler::Summary> SpellProfiler::GetTopEntries(size_t count)
+{
+    std::unordered_map<uint64, Summary> merged;
+    {
+        std::lock_guard<std::mutex> guard(tablesLock);
+        for (auto const& table : tables)
+        {
+            std::lock_guard<std::mutex> tableGuard(table->lock);
+            for (auto const& itr : table->entries)
+            {
+                Summary& summary = merged[itr.first];
+                if (!summary.count)
+                {
+                    summary.spellId = uint32(itr.first >> 32);
+                    summary.stage = SpellProfileStage((itr.first >> 24) & 0xFF);
+                    summary.effIndex = uint32((itr.first >> 16) & 0xFF);
+                    summary.detail = uint32(itr.first & 0xFFFF);
+                }
+                summary.count += itr.second.count * table->sampleRate;
+                summary.totalUs += itr.second.totalUs * table->sampleRate;
+                summary.maxUs = std::max(summary.maxUs, itr.second.maxUs);
+            }
+        }
+    }
+
+    std::vector<Summary> summaries;
+    summaries.reserve(merged.size());
+    for (auto const& itr : merged)
+        summaries.push_back(itr.second);
+
+    std::sort(summaries.begin(), summaries.end(), [](Summary const& a, Summary const& b) { return a.totalUs > b.totalUs; });
+    if (summaries.size() > count)
+        summaries.resize(count);
+
+    return summaries;
+}
+
+std::string SpellProfiler::GetEntryName(Summary const& summary)
+{
+    char buf[64];
+    switch (summary.stage)
+    {
+        case SPELL_PROFILE_EFFECT:
+        case SPELL_PROFILE_EFFECT_HANDLER:
+            snprintf(buf, sizeof(buf), "spell %u %s %u (effect %u)", summary.spellId, stageNames[summary.stage], summary.effIndex, summary.detail);
+            break;
+        case SPELL_PROFILE_PERIODIC_TICK:
+            snprintf(buf, sizeof(buf), "spell %u %s %u (aura %u)", summary.spellId, stageNames[summary.stage], summary.effIndex, summary.detail);
+            break;
+        default:
+            snprintf(buf, sizeof(buf), "spell %u %s", summary.spellId, stageNames[summary.stage]);
+            break;
+    }
+    return buf;
+}
+
+void SpellProfiler::LogReport(size_t count)
+{
+    std::vector<Summary> summaries = GetTopEntries(count);
+    if (summaries.empty())
+        return;
+
+    sLog.outString("Spell profile, top " SIZEFMTD " entries by total time, 1 of %u calls sampled:", summaries.size(), GetSampleRate());
+    for (Summary const& summary : summaries)
+        sLog.outString("%8" PRIu64 " calls %8" PRIu64 " ms total avg " UI64FMTD " us max " UI64FMTD " us: %s",
+                       summary.count, summary.totalUs / 1000, summary.totalUs / summary.count, summary.maxUs, GetEntryName(summary).c_str());
+}
@@ -0,0 +1,108 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SPELLPROFILER_H
+#define MANGOS_SPELLPROFILER_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+enum SpellProfileStage
+{
+    SPELL_PROFILE_START             = 0,                    // Spell::SpellStart, the prepare step
+    SPELL_PROFILE_CAST              = 1,                    // Spell::cast
+    SPELL_PROFILE_EFFECT            = 2,                    // Spell::HandleEffects, detail is the effect
+    SPELL_PROFILE_EFFECT_HANDLER    = 3,                    // the SpellEffects.cpp handler alone, detail is the effect
+    SPELL_PROFILE_PERIODIC_TICK     = 4,                    // Aura::PeriodicTick, detail is the aura type
+    MAX_SPELL_PROFILE_STAGE
+};
+
+// Sampled per spell cost of the cast pipeline, collected while enabled.
+// Only every SampleRate-th scope of a thread is timed, its count and time are scaled back in the report.
+// Times are inclusive, a cast started from an effect handler is part of the time of that handler too.
+class SpellProfiler
+{
+    public:
+        struct Summary
+        {
+            uint32 spellId;
+            SpellProfileStage stage;
+            uint32 effIndex;
+            uint32 detail;
+            uint64 count;                                   // estimated calls
+            uint64 totalUs;                                 // estimated total time
+            uint64 maxUs;                                   // of the sampled calls
+        };
+
+        class Scope
+        {
+            public:
+                Scope(SpellProfileStage stage, uint32 spellId, uint32 effIndex = 0, uint32 detail = 0) : m_sampled(IsEnabled() && Sample())
+                {
+                    if (m_sampled)
+                    {
+                        m_key = MakeKey(stage, spellId, effIndex, detail);
+                        m_start = std::chrono::steady_clock::now();
+                    }
+                }
+                ~Scope()
+                {
+                    if (m_sampled)
+                        Record(m_key, uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count()));
+                }
+
+                Scope(Scope const&) = delete;
+                Scope& operator=(Scope const&) = delete;
+
+            private:
+                bool m_sampled;
+                uint64 m_key;
+                std::chrono::steady_clock::time_point m_start;
+        };
+
+        static void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+        static void SetSampleRate(uint32 rate) { m_sampleRate.store(rate ? rate : 1, std::memory_order_relaxed); }
+        static uint32 GetSampleRate() { return m_sampleRate.load(std::memory_order_relaxed); }
+
+        static void Reset();
+
+        // entries ordered by estimated total time
+        static std::vector<Summary> GetTopEntries(size_t count);
+        static void LogReport(size_t count);
+
+        static std::string GetEntryName(Summary const& summary);
+
+    private:
+        static uint64 MakeKey(SpellProfileStage stage, uint32 spellId, uint32 effIndex, uint32 detail)
+        {
+            return (uint64(spellId) << 32) | (uint64(stage) << 24) | (uint64(effIndex) << 16) | uint64(detail & 0xFFFF);
+        }
+
+        static bool Sample();
+        static void Record(uint64 key, uint64 us);
+
+        static std::atomic<bool> m_enabled;
+        static std::atomic<uint32> m_sampleRate;
+};
+
+#endif
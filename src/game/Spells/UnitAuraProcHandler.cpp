@@ -304,8 +304,41 @@ struct ProcTriggeredData
     SpellAuraHolder* triggeredByHolder;
 };
 
-typedef std::list< ProcTriggeredData > ProcTriggeredList;
-typedef std::list< uint32> RemoveSpellList;
+typedef std::vector< ProcTriggeredData > ProcTriggeredList;
+typedef std::vector< uint32> RemoveSpellList;
+
+// Procs trigger spells that proc again, so every nesting level of ProcDamageAndSpellFor keeps its own list.
+// The lists are kept for the next events of the thread and a deque does not move the ones still in use when it grows.
+static thread_local std::deque<ProcTriggeredList> s_procTriggeredLists;
+static thread_local uint32 s_procTriggeredDepth = 0;
+
+class ProcTriggeredListGuard
+{
+    public:
+        ProcTriggeredListGuard()
+        {
+            if (s_procTriggeredLists.size() <= s_procTriggeredDepth)
+                s_procTriggeredLists.emplace_back();
+            m_list = &s_procTriggeredLists[s_procTriggeredDepth++];
+        }
+        ~ProcTriggeredListGuard()
+        {
+            m_list->clear();
+            --s_procTriggeredDepth;
+        }
+
+        ProcTriggeredList& List() { return *m_list; }
+
+    private:
+        ProcTriggeredList* m_list;
+};
+
+static uint32 GetHolderProcFlags(SpellEntry const* spellProto, SpellProcEventEntry const* spellProcEvent)
+{
+    if (spellProcEvent && spellProcEvent->procFlags)        // if exist get custom spellProcEvent->procFlags
+        return spellProcEvent->procFlags;
+    return spellProto->procFlags;                           // else get from spell proto
+}
 
 uint32 createProcExtendMask(SpellNonMeleeDamage* spellDamageInfo, SpellMissInfo missCondition)
 {
@@ -486,20 +519,29 @@ void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
 {
     ProcExecutionData execData(argData, isVictim);
 
+    // No holder can trigger at these flags
+    if (!(m_procHoldersMask & execData.procFlags))
+        return;
+
     RemoveSpellList removedSpells;
-    ProcTriggeredList procTriggered;
+    ProcTriggeredListGuard procTriggeredGuard;
+    ProcTriggeredList& procTriggered = procTriggeredGuard.List();
     // Fill procTriggered list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    for (size_t i = 0; i < m_procHolders.size(); ++i)
     {
+        if (!(m_procHolders[i].procFlags & execData.procFlags))
+            continue;
+
+        SpellAuraHolder* holder = m_procHolders[i].holder;
         // skip deleted auras (possible at recursive triggered call
-        if (itr->second->GetState() != SPELLAURAHOLDER_STATE_READY || itr->second->IsDeleted())
+        if (holder->GetState() != SPELLAURAHOLDER_STATE_READY || holder->IsDeleted())
             continue;
 
         SpellProcEventEntry const* spellProcEvent = nullptr;
-        if (!IsTriggeredAtSpellProcEvent(execData, itr->second, spellProcEvent))
+        if (!IsTriggeredAtSpellProcEvent(execData, holder, spellProcEvent))
             continue;
 
-        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second));
+        procTriggered.push_back(ProcTriggeredData(spellProcEvent, holder));
     }
 
     // Nothing found
@@ -578,14 +620,41 @@ void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
     if (!removedSpells.empty())
     {
         // Sort spells and remove duplicates
-        removedSpells.sort();
-        removedSpells.unique();
+        std::sort(removedSpells.begin(), removedSpells.end());
+        removedSpells.erase(std::unique(removedSpells.begin(), removedSpells.end()), removedSpells.end());
         // Remove auras from removedAuras
         for (RemoveSpellList::const_iterator i = removedSpells.begin(); i != removedSpells.end(); ++i)
             RemoveAurasDueToSpell(*i);
     }
 }
 
+void Unit::AddProcHolder(SpellAuraHolder* holder)
+{
+    SpellEntry const* spellProto = holder->GetSpellProto();
+    uint32 procFlags = GetHolderProcFlags(spellProto, sSpellMgr.GetSpellProcEvent(spellProto->Id));
+    if (!procFlags)
+        return;
+
+    // keep the order of m_spellAuraHolders, new holders go behind the ones of the same spell
+    uint32 spellId = holder->GetId();
+    auto itr = std::upper_bound(m_procHolders.begin(), m_procHolders.end(), spellId,
+        [](uint32 id, ProcHolderEntry const& entry) { return id < entry.holder->GetId(); });
+    m_procHolders.insert(itr, ProcHolderEntry(holder, procFlags));
+    m_procHoldersMask |= procFlags;
+}
+
+void Unit::RemoveProcHolder(SpellAuraHolder* holder)
+{
+    auto itr = std::find_if(m_procHolders.begin(), m_procHolders.end(), [holder](ProcHolderEntry const& entry) { return entry.holder == holder; });
+    if (itr == m_procHolders.end())
+        return;
+
+    m_procHolders.erase(itr);
+    m_procHoldersMask = 0;
+    for (ProcHolderEntry const& entry : m_procHolders)
+        m_procHoldersMask |= entry.procFlags;
+}
+
 bool Unit::IsTriggeredAtSpellProcEvent(ProcExecutionData& data, SpellAuraHolder* holder, SpellProcEventEntry const*& spellProcEvent)
 {
     SpellEntry const* spellProto = holder->GetSpellProto();
@@ -594,11 +663,7 @@ bool Unit::IsTriggeredAtSpellProcEvent(ProcExecutionData& data, SpellAuraHolder*
     spellProcEvent = sSpellMgr.GetSpellProcEvent(spellProto->Id);
 
     // Get EventProcFlag
-    uint32 EventProcFlag;
-    if (spellProcEvent && spellProcEvent->procFlags) // if exist get custom spellProcEvent->procFlags
-        EventProcFlag = spellProcEvent->procFlags;
-    else
-        EventProcFlag = spellProto->procFlags;       // else get from spell proto
+    uint32 EventProcFlag = GetHolderProcFlags(spellProto, spellProcEvent);
     // Continue if no trigger exist
     if (!EventProcFlag)
         return false;
@@ -1307,6 +1372,7 @@ SpellAuraProcResult Unit::HandleDummyAuraProc(ProcExecutionData& data)
 
                 // Damage counting
                 mod->m_amount -= damage;
+                InvalidateAuraModifierCache(mod->m_auraname);
                 return SPELL_AURA_PROC_OK;
             }
             // Seed of Corruption (Mobs cast) - no die req
@@ -1328,6 +1394,7 @@ SpellAuraProcResult Unit::HandleDummyAuraProc(ProcExecutionData& data)
                 }
                 // Damage counting
                 mod->m_amount -= damage;
+                InvalidateAuraModifierCache(mod->m_auraname);
                 return SPELL_AURA_PROC_OK;
             }
             switch (dummySpell->Id)
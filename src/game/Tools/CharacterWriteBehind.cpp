@@ -0,0 +1,128 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Tools/CharacterWriteBehind.h"
+#include "Database/DatabaseEnv.h"
+
+#include <vector>
+
+INSTANTIATE_SINGLETON_1(CharacterWriteBehind);
+
+void CharacterWriteBehind::SetColumn(char const* table, uint32 guid, uint32 accountId, char const* column, uint32 value)
+{
+    SetColumnValue(table, guid, accountId, column, std::to_string(value));
+}
+
+void CharacterWriteBehind::SetColumn(char const* table, uint32 guid, uint32 accountId, char const* column, std::string value)
+{
+    CharacterDatabase.escape_string(value);
+    SetColumnValue(table, guid, accountId, column, "'" + value + "'");
+}
+
+void CharacterWriteBehind::SetColumnValue(char const* table, uint32 guid, uint32 accountId, char const* column, std::string const& value)
+{
+    RowKey key(guid, table);
+
+    if (m_enabled && !CharacterDatabase.IsInTransaction())
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        PendingRow& row = m_rows[key];
+        row.accountId = accountId;
+        row.columns[column] = value;
+        return;
+    }
+
+    // an older buffered value must not overwrite this one at the next flush
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        PendingRowMap::iterator itr = m_rows.find(key);
+        if (itr != m_rows.end())
+        {
+            itr->second.columns.erase(column);
+            if (itr->second.columns.empty())
+                m_rows.erase(itr);
+        }
+    }
+
+    ColumnMap columns;
+    columns[column] = value;
+
+    SqlAsyncKeyScope asyncKey(accountId);
+    WriteRow(key, columns);
+}
+
+void CharacterWriteBehind::Flush(uint32 guid)
+{
+    std::vector<std::pair<RowKey, PendingRow>> rows;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        PendingRowMap::iterator itr = m_rows.lower_bound(RowKey(guid, std::string()));
+        while (itr != m_rows.end() && itr->first.first == guid)
+        {
+            rows.emplace_back(itr->first, std::move(itr->second));
+            itr = m_rows.erase(itr);
+        }
+    }
+
+    for (auto const& row : rows)
+    {
+        SqlAsyncKeyScope asyncKey(row.second.accountId);
+        WriteRow(row.first, row.second.columns);
+    }
+}
+
+void CharacterWriteBehind::FlushAll()
+{
+    PendingRowMap rows;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        rows.swap(m_rows);
+    }
+
+    if (rows.empty())
+        return;
+
+    // one transaction per async connection, rows of an account must stay on the connection of its saves
+    std::map<uint32, std::vector<PendingRowMap::const_iterator>> accountRows;
+    for (PendingRowMap::const_iterator itr = rows.begin(); itr != rows.end(); ++itr)
+        accountRows[itr->second.accountId].push_back(itr);
+
+    for (auto const& account : accountRows)
+    {
+        SqlAsyncKeyScope asyncKey(account.first);
+
+        CharacterDatabase.BeginTransaction();
+        for (auto const& itr : account.second)
+            WriteRow(itr->first, itr->second.columns);
+        CharacterDatabase.CommitTransaction();
+    }
+}
+
+void CharacterWriteBehind::WriteRow(RowKey const& key, ColumnMap const& columns)
+{
+    std::string sql = "UPDATE " + key.second + " SET ";
+    for (ColumnMap::const_iterator itr = columns.begin(); itr != columns.end(); ++itr)
+    {
+        if (itr != columns.begin())
+            sql += ", ";
+        sql += itr->first + " = " + itr->second;
+    }
+    sql += " WHERE guid = " + std::to_string(key.first);
+
+    CharacterDatabase.Execute(sql.c_str());
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHARACTERWRITEBEHIND_H
+#define CHARACTERWRITEBEHIND_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * Buffer of single column character updates, keeping only the latest value of each column.
+ * The columns of one row are written with one UPDATE when the buffer is flushed by the world timer or the owner is saved.
+ *
+ * Writes done while the calling thread collects a transaction bypass the buffer, so they stay atomic with the
+ * rest of the transaction (money moved together with items in trade, mail and auction paths).
+ * Rows are flushed on the async connection of their owner's account to keep the order with the owner's saves.
+ */
+class CharacterWriteBehind
+{
+    public:
+        CharacterWriteBehind() : m_enabled(false) {}
+
+        // disabled buffer writes every update immediately
+        void SetEnabled(bool enabled) { m_enabled = enabled; }
+
+        void SetColumn(char const* table, uint32 guid, uint32 accountId, char const* column, uint32 value);
+        void SetColumn(char const* table, uint32 guid, uint32 accountId, char const* column, std::string value);
+
+        // writes the pending columns of all tables of the character, in the caller's transaction if any
+        void Flush(uint32 guid);
+        void FlushAll();
+
+    private:
+        typedef std::map<std::string, std::string> ColumnMap;
+
+        struct PendingRow
+        {
+            uint32 accountId;
+            ColumnMap columns;
+        };
+
+        typedef std::pair<uint32, std::string> RowKey;     // guid, table
+        typedef std::map<RowKey, PendingRow> PendingRowMap;
+
+        void SetColumnValue(char const* table, uint32 guid, uint32 accountId, char const* column, std::string const& value);
+        static void WriteRow(RowKey const& key, ColumnMap const& columns);
+
+        std::mutex m_lock;
+        PendingRowMap m_rows;
+        bool m_enabled;
+};
+
+#define sCharacterWriteBehind MaNGOS::Singleton<CharacterWriteBehind>::Instance()
+
+#endif
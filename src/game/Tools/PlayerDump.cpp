@@ -23,6 +23,8 @@
 #include "Entities/UpdateFields.h"
 #include "Globals/ObjectMgr.h"
 #include "Accounts/AccountMgr.h"
+#include "Entities/CharEnumCache.h"
+#include "Entities/CharacterNameCache.h"
 
 // Character Dump tables
 struct DumpTable
@@ -730,6 +732,10 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
 
     CharacterDatabase.CommitTransaction();
 
+    sCharEnumCache.InvalidateAccount(account);
+    // the guid may have belonged to a deleted character
+    sCharacterNameCache.Remove(guid);
+
     // FIXME: current code with post-updating guids not safe for future per-map threads
     sObjectMgr.m_ItemGuids.Set(sObjectMgr.m_ItemGuids.GetNextAfterMaxUsed() + items.size());
     sObjectMgr.m_MailIds.Set(sObjectMgr.m_MailIds.GetNextAfterMaxUsed() +  mails.size());
@@ -336,7 +336,7 @@ void Weather::LogWeatherState(WeatherState state) const
 //                  Weather System
 // ---------------------------------------------------------
 
-WeatherSystem::WeatherSystem(Map const* _map) : m_map(_map)
+WeatherSystem::WeatherSystem(Map const* _map) : m_map(_map), m_pendingDiff(0), m_nextUpdateIn(std::numeric_limits<uint32>::max())
 {}
 
 WeatherSystem::~WeatherSystem()
@@ -355,15 +355,31 @@ Weather* WeatherSystem::FindOrCreateWeather(uint32 zoneId)
     // Return if found
     if (itr != m_weathers.end())
         return itr->second;
-    // Create
+    // Create, the existing weathers get their time first as the new one starts from zero
+    ApplyPendingDiff();
     Weather* w = new Weather(zoneId, sWeatherMgr.GetWeatherChances(zoneId));
     m_weathers[zoneId] = w;
+    m_nextUpdateIn = std::min(m_nextUpdateIn, w->GetTimeUntilUpdate());
     return w;
 }
 
 /// Update Weathers for the different zones
 void WeatherSystem::UpdateWeathers(uint32 diff)
 {
+    ///- Weathers only change when their timer expires, the map skips them until the first one does
+    m_pendingDiff += diff;
+    if (m_pendingDiff < m_nextUpdateIn)
+        return;
+
+    ApplyPendingDiff();
+}
+
+void WeatherSystem::ApplyPendingDiff()
+{
+    uint32 diff = m_pendingDiff;
+    m_pendingDiff = 0;
+    m_nextUpdateIn = std::numeric_limits<uint32>::max();
+
     ///- Send an update signal to Weather objects
     for (WeatherMap::iterator itr = m_weathers.begin(); itr != m_weathers.end();)
     {
@@ -375,7 +391,10 @@ void WeatherSystem::UpdateWeathers(uint32 diff)
             m_weathers.erase(itr++);
         }
         else
+        {
+            m_nextUpdateIn = std::min(m_nextUpdateIn, itr->second->GetTimeUntilUpdate());
             ++itr;
+        }
     }
 }
 
@@ -65,6 +65,8 @@ class Weather
         void SetWeather(WeatherType type, float grade, Map const* _map, bool isPermanent);
         /// Update the weather in this zone, when the timer is expired the weather will be rolled again
         bool Update(uint32 diff, Map const* _map);
+        /// Time until the next roll of the weather
+        uint32 GetTimeUntilUpdate() const { return m_timer.Passed() ? 0 : m_timer.GetInterval() - m_timer.GetCurrent(); }
         /// Check if a type is valid
         static bool IsValidWeatherType(uint32 type)
         {
@@ -117,7 +119,11 @@ class WeatherSystem
         void UpdateWeathers(uint32 diff);
 
     private:
+        void ApplyPendingDiff();
+
         Map const* const m_map;
+        uint32 m_pendingDiff;                               // map time not yet passed to the weathers
+        uint32 m_nextUpdateIn;                              // time until the first weather rolls again
 
         typedef std::unordered_map<uint32 /*zoneId*/, Weather*> WeatherMap;
         WeatherMap m_weathers;
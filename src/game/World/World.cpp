@@ -22,6 +22,7 @@
 
 #include "World/World.h"
 #include "Database/DatabaseEnv.h"
+#include "Database/SQLStorageSnapshot.h"
 #include "Config/Config.h"
 #include "Platform/Define.h"
 #include "SystemConfig.h"
@@ -44,6 +45,7 @@
 #include "Loot/LootMgr.h"
 #include "Entities/ItemEnchantmentMgr.h"
 #include "Maps/MapManager.h"
+#include "Maps/MapWorkers.h"
 #include "DBScripts/ScriptMgr.h"
 #include "AI/CreatureAIRegistry.h"
 #include "Policies/Singleton.h"
@@ -54,6 +56,14 @@
 #include "GameEvents/GameEventMgr.h"
 #include "Pools/PoolManager.h"
 #include "Database/DatabaseImpl.h"
+#include "Database/SqlStatistics.h"
+#include "Spells/SpellProfiler.h"
+#include "AI/ScriptDevAI/ScriptProfiler.h"
+#include "Server/OpcodeProfiler.h"
+#include "Maps/MapTickProfiler.h"
+#include "ProfiledMutex.h"
+#include "Server/PacketCapture.h"
+#include "MemoryTracker.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "Grids/CellImpl.h"
 #include "Maps/MapPersistentStateMgr.h"
@@ -62,15 +72,23 @@
 #include "Util.h"
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "Tools/CharacterDatabaseCleaner.h"
+#include "Tools/CharacterWriteBehind.h"
+#include "Entities/CharEnumCache.h"
+#include "Entities/CharacterNameCache.h"
+#include "Accounts/RealmCharacterCounter.h"
+#include "Social/WhoListCache.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "Weather/Weather.h"
 #include "World/WorldState.h"
 #include "Cinematics/CinematicMgr.h"
+#include "TaskGraph.h"
+#include "ProgressBar.h"
 
 #include <algorithm>
 #include <mutex>
 #include <cstdarg>
 #include <memory>
+#include <thread>
 
 INSTANTIATE_SINGLETON_1(World);
 
@@ -86,6 +104,7 @@ float World::m_MaxVisibleDistanceInBGArenas   = DEFAULT_VISIBILITY_BGARENAS;
 
 float  World::m_relocation_lower_limit_sq = 10.f * 10.f;
 uint32 World::m_relocation_ai_notify_delay = 1000u;
+uint32 World::m_relocation_visibility_notify_delay = 100u;
 
 uint32 World::m_currentMSTime = 0;
 TimePoint World::m_currentTime = TimePoint();
@@ -102,6 +121,7 @@ World::World() : mail_timer(0), mail_timer_expires(0), m_NextDailyQuestReset(0),
     m_startTime = m_gameTime;
     m_maxActiveSessionCount = 0;
     m_maxQueuedSessionCount = 0;
+    m_backgroundReloadLoaded = false;
 
     m_defaultDbcLocale = LOCALE_enUS;
     m_availableDbcLocaleMask = 0;
@@ -141,10 +161,18 @@ World::~World()
 /// Cleanups before world stop
 void World::CleanupsBeforeStop()
 {
-    KickAll();                                       // save and kick all players
+    StopBackgroundReload();                          // the world database stays open until its worker is done
+    sObjectAccessor.SaveAllPlayers();                // save and kick all players
+    KickAll();
+    uint32 const saveWriteStart = WorldTimer::getMSTime();
+    CharacterDatabase.WaitForDelayThreads();
+    sLog.outString("Player saves written in %u ms", WorldTimer::getMSTimeDiff(saveWriteStart, WorldTimer::getMSTime()));
     UpdateSessions(1);                               // real players unload required UpdateSessions call
     sBattleGroundMgr.DeleteAllBattleGrounds();       // unload battleground templates before different singletons destroyed
     sMapMgr.UnloadAll();                             // unload all grids (including locked in memory)
+    sMapPersistentStateMgr.DeleteQueuedInstancesFromDB(); // instance resets still waiting for their batch
+    sCharacterWriteBehind.FlushAll();                // write columns of offline characters still buffered
+    sRealmCharacterCounter.Flush();                  // write the character counts changed since the last timer
 }
 
 /// Find a session by its id
@@ -272,6 +300,63 @@ void World::AddQueuedSession(WorldSession* sess)
 {
     sess->SetInQueue(true);
     m_QueuedSessions.push_back(sess);
+
+    PrefetchQueuedSessions();
+}
+
+void World::PrefetchQueuedSessions()
+{
+    // the character lists of the next sessions to leave the queue are read while they still wait
+    uint32 count = getConfig(CONFIG_UINT32_LOGIN_QUEUE_PREFETCH);
+    for (Queue::const_iterator iter = m_QueuedSessions.begin(); iter != m_QueuedSessions.end() && count; ++iter, --count)
+        (*iter)->PrefetchCharEnum();
+}
+
+bool World::StartBackgroundReload(BackgroundReload* reload)
+{
+    if (m_backgroundReload)
+    {
+        delete reload;
+        return false;
+    }
+
+    m_backgroundReload.reset(reload);
+    m_backgroundReloadLoaded = false;
+    m_backgroundReloadThread = std::thread([this, reload]()
+    {
+        WorldDatabase.ThreadStart();
+        reload->Load();
+        WorldDatabase.ThreadEnd();
+        m_backgroundReloadLoaded = true;
+    });
+    return true;
+}
+
+void World::UpdateBackgroundReload()
+{
+    if (!m_backgroundReload || !m_backgroundReloadLoaded)
+        return;
+
+    m_backgroundReloadThread.join();
+
+    // the replaced data is freed with the reload, nothing still points into it once the maps are idle
+    m_backgroundReload->Publish();
+
+    WorldPacket data;
+    ChatHandler::BuildChatPacket(data, CHAT_MSG_SYSTEM, m_backgroundReload->GetPublishedText());
+    SendGlobalMessage(data);
+
+    m_backgroundReload.reset();
+}
+
+void World::StopBackgroundReload()
+{
+    if (!m_backgroundReload)
+        return;
+
+    // loaded data is dropped, the server goes down anyway
+    m_backgroundReloadThread.join();
+    m_backgroundReload.reset();
 }
 
 bool World::RemoveQueuedSession(WorldSession* sess)
@@ -321,6 +406,8 @@ bool World::RemoveQueuedSession(WorldSession* sess)
     for (; iter != m_QueuedSessions.end(); ++iter, ++position)
         (*iter)->SendAuthWaitQue(position);
 
+    PrefetchQueuedSessions();
+
     return found;
 }
 
@@ -413,6 +500,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_FLOAT_RATE_AUCTION_DEPOSIT, "Rate.Auction.Deposit", 1.0f);
     setConfig(CONFIG_FLOAT_RATE_AUCTION_CUT,     "Rate.Auction.Cut", 1.0f);
     setConfig(CONFIG_UINT32_AUCTION_DEPOSIT_MIN, "Auction.Deposit.Min", 0);
+    setConfigMin(CONFIG_UINT32_AUCTION_EXPIRED_PER_UPDATE, "Auction.ExpiredPerUpdate", 1000, 1);
     setConfig(CONFIG_FLOAT_RATE_HONOR, "Rate.Honor", 1.0f);
     setConfigPos(CONFIG_FLOAT_RATE_MINING_AMOUNT, "Rate.Mining.Amount", 1.0f);
     setConfigPos(CONFIG_FLOAT_RATE_MINING_NEXT,   "Rate.Mining.Next", 1.0f);
@@ -441,7 +529,15 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
+    setConfig(CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED, "MapFiles.MemoryMapped", true);
+    setConfig(CONFIG_UINT32_TERRAIN_CACHE_SIZE, "GridUnload.TerrainCacheSize", 0);
+    setConfig(CONFIG_UINT32_GRID_UNLOADS_PER_UPDATE, "GridUnload.MaxPerUpdate", 2);
+    sTerrainMgr.SetCacheSize(uint64(getConfig(CONFIG_UINT32_TERRAIN_CACHE_SIZE)) * 1024 * 1024);
+    setConfig(CONFIG_BOOL_GRID_LAZY_CELLS, "GridLoad.LazyCells", false);
     setConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS, "MaxWhoListReturns", 49);
+    setConfigMinMax(CONFIG_UINT32_WHOLIST_SNAPSHOT_INTERVAL, "WhoList.SnapshotInterval", 1000, 100, 10000);
+    m_timers[WUPDATE_WHO_LIST].SetInterval(getConfig(CONFIG_UINT32_WHOLIST_SNAPSHOT_INTERVAL));
+    m_timers[WUPDATE_WHO_LIST].Reset();
 
     std::string forceLoadGridOnMaps = sConfig.GetStringDefault("LoadAllGridsOnMaps");
     if (!forceLoadGridOnMaps.empty())
@@ -454,6 +550,10 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_INTERVAL_SAVE, "PlayerSave.Interval", 15 * MINUTE * IN_MILLISECONDS);
+    setConfig(CONFIG_UINT32_INTERVAL_WRITE_BEHIND, "PlayerSave.WriteBehindInterval", 10 * IN_MILLISECONDS);
+    sCharacterWriteBehind.SetEnabled(getConfig(CONFIG_UINT32_INTERVAL_WRITE_BEHIND) != 0);
+    m_timers[WUPDATE_WRITE_BEHIND].SetInterval(getConfig(CONFIG_UINT32_INTERVAL_WRITE_BEHIND));
+    m_timers[WUPDATE_WRITE_BEHIND].Reset();
     setConfigMinMax(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE, "PlayerSave.Stats.MinLevel", 0, 0, MAX_LEVEL);
     setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, "PlayerSave.Stats.SaveOnlyOnLogout", true);
 
@@ -461,6 +561,8 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetGridCleanUpDelay(getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN));
 
+    setConfig(CONFIG_UINT32_GRID_PREFETCH_LOOKAHEAD, "GridPrefetch.Lookahead", 10);
+
     setConfigMin(CONFIG_UINT32_INTERVAL_MAPUPDATE, "MapUpdateInterval", 100, MIN_MAP_UPDATE_DELAY);
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
@@ -561,6 +663,8 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_MAIL_DELIVERY_DELAY, "MailDeliveryDelay", HOUR);
 
     setConfigMin(CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK, "MassMailer.SendPerTick", 10, 1);
+    setConfig(CONFIG_UINT32_MASS_MAILER_MAX_DB_QUEUE, "MassMailer.MaxDBQueue", 50);
+    setConfigMinMax(CONFIG_UINT32_MAIL_EXPIRED_PER_TICK, "Mail.ExpiredPerTick", 100, 1, 200);
 
     setConfig(CONFIG_UINT32_UPTIME_UPDATE, "UpdateUptimeInterval", 10);
     if (reload)
@@ -570,6 +674,12 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUM_MAP_THREADS, "MapUpdate.Threads", 3);
+    setConfig(CONFIG_UINT32_STARTUP_LOAD_THREADS, "StartupLoad.Threads", 0);
+    setConfig(CONFIG_UINT32_MAP_PARALLEL_CELLS_MIN_PLAYERS, "MapUpdate.ParallelCells.MinPlayers", 0);
+    setConfig(CONFIG_UINT32_MAP_IDLE_UPDATE_INTERVAL, "MapUpdate.IdleInterval", 0);
+    setConfig(CONFIG_UINT32_SESSION_PARALLEL_MIN_SESSIONS, "SessionUpdate.Parallel.MinSessions", 0);
+    setConfig(CONFIG_UINT32_MAP_AI_BUDGET, "MapUpdate.AIBudget", 0);
+    setConfig(CONFIG_UINT32_MAP_AI_BUDGET_MAX_DELAY, "MapUpdate.AIBudget.MaxDelay", 1000);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -597,6 +707,13 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY, "SaveRespawnTimeImmediately", true);
+    setConfig(CONFIG_UINT32_SAVE_RESPAWN_TIME_FLUSH_INTERVAL, "SaveRespawnTime.FlushInterval", 10);
+    setConfig(CONFIG_BOOL_SAVE_RESPAWN_TIME_FLUSH_ON_SHUTDOWN, "SaveRespawnTime.FlushOnShutdown", true);
+    setConfig(CONFIG_UINT32_PLAYER_LINGER_TIME, "PlayerLinger.Time", MINUTE);
+    setConfig(CONFIG_BOOL_PLAYER_LINGER_PROTECT, "PlayerLinger.Protect", true);
+    setConfig(CONFIG_UINT32_LOGIN_QUEUE_PREFETCH, "LoginQueue.PrefetchCount", 5);
+    setConfig(CONFIG_UINT32_CHAR_ENUM_CACHE_TIME, "CharacterEnumCache.Lifetime", 5 * MINUTE);
+    sCharEnumCache.SetLifetime(getConfig(CONFIG_UINT32_CHAR_ENUM_CACHE_TIME));
     setConfig(CONFIG_BOOL_WEATHER, "ActivateWeather", true);
 
     setConfig(CONFIG_BOOL_ALWAYS_MAX_SKILL_FOR_LEVEL, "AlwaysMaxSkillForLevel", false);
@@ -609,6 +726,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_CHATFLOOD_MUTE_TIME,     "ChatFlood.MuteTime", 10);
 
     setConfig(CONFIG_BOOL_EVENT_ANNOUNCE, "Event.Announce", false);
+    setConfig(CONFIG_UINT32_GAME_EVENT_SPAWN_BATCH_SIZE, "Event.SpawnBatchSize", 200);
 
     setConfig(CONFIG_UINT32_CREATURE_FAMILY_ASSISTANCE_DELAY, "CreatureFamilyAssistanceDelay", 1500);
     setConfig(CONFIG_UINT32_CREATURE_FAMILY_FLEE_DELAY,       "CreatureFamilyFleeDelay",       10000);
@@ -617,6 +735,7 @@ void World::LoadConfigSettings(bool reload)
 
     setConfigMinMax(CONFIG_INT32_QUEST_LOW_LEVEL_HIDE_DIFF, "Quests.LowLevelHideDiff", 4, -1, MAX_LEVEL);
     setConfigMinMax(CONFIG_INT32_QUEST_HIGH_LEVEL_HIDE_DIFF, "Quests.HighLevelHideDiff", 7, -1, MAX_LEVEL);
+    setConfig(CONFIG_UINT32_QUEST_GIVER_STATUS_CACHE_LIFETIME, "Quests.StatusCacheLifetime", 30);
 
     setConfigMinMax(CONFIG_UINT32_QUEST_DAILY_RESET_HOUR, "Quests.Daily.ResetHour", 6, 0, 23);
     setConfigMinMax(CONFIG_UINT32_QUEST_WEEKLY_RESET_WEEK_DAY, "Quests.Weekly.ResetWeekDay", 3, 0, 6);
@@ -636,6 +755,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_CHAT_STRICT_LINK_CHECKING_KICK,     "ChatStrictLinkChecking.Kick", 0);
 
     setConfig(CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW,                     "Corpse.EmptyLootShow",                  true);
+    setConfig(CONFIG_BOOL_CORPSE_DEFERRED_ITEM_LOOT,                  "Corpse.DeferredItemLoot",               true);
     setConfig(CONFIG_BOOL_CORPSE_ALLOW_ALL_ITEMS_SHOW_IN_MASTER_LOOT, "Corpse.AllowAllItemsShowInMasterLoot", false);
     setConfig(CONFIG_UINT32_CORPSE_DECAY_NORMAL,                      "Corpse.Decay.NORMAL",                    300);
     setConfig(CONFIG_UINT32_CORPSE_DECAY_RARE,                        "Corpse.Decay.RARE",                      900);
@@ -655,6 +775,9 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_FLOAT_THREAT_RADIUS, "ThreatRadius", 100.0f);
     setConfigMin(CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY, "CreatureRespawnAggroDelay", 5000, 0);
     setConfig(CONFIG_UINT32_CREATURE_PICKPOCKET_RESTOCK_DELAY, "CreaturePickpocketRestockDelay", 600);
+    setConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL, "CreatureIdleUpdateInterval", 0);
+    setConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_MOVEMENT_TYPES, "CreatureIdleUpdateMovementTypes", 0x01);
+    setConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_AI_TYPES, "CreatureIdleUpdateAITypes", 0x01);
 
     // always use declined names in the russian client
     if (getConfig(CONFIG_UINT32_REALM_ZONE) == REALM_ZONE_RUSSIAN)
@@ -669,6 +792,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_BATTLEGROUND_INVITATION_TYPE,              "Battleground.InvitationType", 0);
     setConfig(CONFIG_UINT32_BATTLEGROUND_PREMATURE_FINISH_TIMER,       "BattleGround.PrematureFinishTimer", 5 * MINUTE * IN_MILLISECONDS);
     setConfig(CONFIG_UINT32_BATTLEGROUND_PREMADE_GROUP_WAIT_FOR_MATCH, "BattleGround.PremadeGroupWaitForMatch", 30 * MINUTE * IN_MILLISECONDS);
+    setConfig(CONFIG_UINT32_BATTLEGROUND_SCOREBOARD_INTERVAL,          "Battleground.ScoreboardInterval", 1000);
     setConfig(CONFIG_UINT32_ARENA_MAX_RATING_DIFFERENCE,               "Arena.MaxRatingDifference", 150);
     setConfig(CONFIG_UINT32_ARENA_RATING_DISCARD_TIMER,                "Arena.RatingDiscardTimer", 10 * MINUTE * IN_MILLISECONDS);
     setConfig(CONFIG_BOOL_ARENA_AUTO_DISTRIBUTE_POINTS,                "Arena.AutoDistributePoints", false);
@@ -689,15 +813,18 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET, "OffhandCheckAtTalentsReset", false);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfig(CONFIG_UINT32_NETWORK_MAX_PENDING_AUTH, "Network.MaxPendingAuth", 1000);
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
     setConfig(CONFIG_UINT32_INSTANT_LOGOUT, "InstantLogout", SEC_MODERATOR);
 
     setConfigMin(CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY, "Group.OfflineLeaderDelay", 300, 0);
+    setConfig(CONFIG_UINT32_GROUP_UPDATE_INTERVAL, "Group.UpdateInterval", 1000);
 
     setConfigMin(CONFIG_UINT32_GUILD_EVENT_LOG_COUNT, "Guild.EventLogRecordsCount", GUILD_EVENTLOG_MAX_RECORDS, GUILD_EVENTLOG_MAX_RECORDS);
     setConfigMin(CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT, "Guild.BankEventLogRecordsCount", GUILD_BANK_MAX_LOGS, GUILD_BANK_MAX_LOGS);
+    setConfig(CONFIG_UINT32_GUILD_BANK_UNLOAD_DELAY, "Guild.BankUnloadDelay", 30 * MINUTE);
 
     setConfig(CONFIG_UINT32_MIRRORTIMER_FATIGUE_MAX,       "MirrorTimer.Fatigue.Max", 60);
     setConfig(CONFIG_UINT32_MIRRORTIMER_BREATH_MAX,        "MirrorTimer.Breath.Max", 60);
@@ -709,8 +836,14 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_AUTO_DOWNRANK,              "AutoDownrank", true);
 
     m_relocation_ai_notify_delay = sConfig.GetIntDefault("Visibility.AIRelocationNotifyDelay", 1000u);
+    m_relocation_visibility_notify_delay = sConfig.GetIntDefault("Visibility.RelocationNotifyDelay", 100u);
     m_relocation_lower_limit_sq = pow(sConfig.GetFloatDefault("Visibility.RelocationLowerLimit", 10), 2);
 
+    setConfigMin(CONFIG_FLOAT_MOVEMENT_LOD_RADIUS, "Visibility.MovementLOD.Radius", 50.0f, 0.0f);
+    setConfigMin(CONFIG_UINT32_MOVEMENT_LOD_HEARTBEAT_INTERVAL, "Visibility.MovementLOD.HeartbeatInterval", 3, 1);
+    setConfig(CONFIG_BOOL_COMBAT_LOG_COALESCE, "Visibility.CombatLogCoalesce", false);
+    setConfig(CONFIG_UINT32_COMBAT_LOG_COALESCE_MAX_DELAY, "Visibility.CombatLogCoalesce.MaxDelay", 0);
+
     // Visibility on Continents
     m_MaxVisibleDistanceOnContinents      = sConfig.GetFloatDefault("Visibility.Distance.Continents",     DEFAULT_VISIBILITY_DISTANCE);
     if (m_MaxVisibleDistanceOnContinents < 45 * getConfig(CONFIG_FLOAT_RATE_CREATURE_AGGRO))
@@ -782,6 +915,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
+    setConfig(CONFIG_BOOL_VMAP_QUERY_CACHE, "vmap.queryCache", true);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
     std::string ignoreSpellIds = sConfig.GetStringDefault("vmap.ignoreSpellIds");
@@ -800,10 +934,57 @@ void World::LoadConfigSettings(bool reload)
     std::string ignoreMapIds = sConfig.GetStringDefault("mmap.ignoreMapIds");
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMapIds.c_str());
     sLog.outString("WORLD: MMap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
+    setConfig(CONFIG_UINT32_MMAP_MAX_CHASE_PATHS_PER_TICK, "mmap.maxChasePathsPerTick", 25);
 
     setConfig(CONFIG_BOOL_PATH_FIND_OPTIMIZE, "PathFinder.OptimizePath", true);
     setConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z, "PathFinder.NormalizeZ", false);
 
+    setConfig(CONFIG_BOOL_SQL_STATISTICS, "SqlStatistics.Enable", false);
+    SqlStatistics::SetEnabled(getConfig(CONFIG_BOOL_SQL_STATISTICS));
+    setConfig(CONFIG_UINT32_SQL_STATISTICS_LOG_INTERVAL, "SqlStatistics.LogInterval", 0);
+    m_timers[WUPDATE_SQL_STATS].SetInterval(getConfig(CONFIG_UINT32_SQL_STATISTICS_LOG_INTERVAL) * MINUTE * IN_MILLISECONDS);
+    m_timers[WUPDATE_SQL_STATS].Reset();
+
+    setConfig(CONFIG_BOOL_SPELL_PROFILER, "SpellProfiler.Enable", false);
+    setConfigMinMax(CONFIG_UINT32_SPELL_PROFILER_SAMPLE_RATE, "SpellProfiler.SampleRate", 16, 1, 1000);
+    SpellProfiler::SetSampleRate(getConfig(CONFIG_UINT32_SPELL_PROFILER_SAMPLE_RATE));
+    SpellProfiler::SetEnabled(getConfig(CONFIG_BOOL_SPELL_PROFILER));
+    setConfig(CONFIG_UINT32_SPELL_PROFILER_LOG_INTERVAL, "SpellProfiler.LogInterval", 0);
+    m_timers[WUPDATE_SPELL_STATS].SetInterval(getConfig(CONFIG_UINT32_SPELL_PROFILER_LOG_INTERVAL) * MINUTE * IN_MILLISECONDS);
+    m_timers[WUPDATE_SPELL_STATS].Reset();
+
+    setConfig(CONFIG_BOOL_SCRIPT_PROFILER, "ScriptProfiler.Enable", false);
+    setConfigMinMax(CONFIG_UINT32_SCRIPT_PROFILER_SAMPLE_RATE, "ScriptProfiler.SampleRate", 16, 1, 1000);
+    ScriptProfiler::SetSampleRate(getConfig(CONFIG_UINT32_SCRIPT_PROFILER_SAMPLE_RATE));
+    ScriptProfiler::SetEnabled(getConfig(CONFIG_BOOL_SCRIPT_PROFILER));
+    setConfig(CONFIG_UINT32_SCRIPT_PROFILER_LOG_INTERVAL, "ScriptProfiler.LogInterval", 0);
+    m_timers[WUPDATE_SCRIPT_STATS].SetInterval(getConfig(CONFIG_UINT32_SCRIPT_PROFILER_LOG_INTERVAL) * MINUTE * IN_MILLISECONDS);
+    m_timers[WUPDATE_SCRIPT_STATS].Reset();
+
+    setConfig(CONFIG_BOOL_OPCODE_PROFILER, "OpcodeProfiler.Enable", false);
+    OpcodeProfiler::SetEnabled(getConfig(CONFIG_BOOL_OPCODE_PROFILER));
+    setConfig(CONFIG_UINT32_OPCODE_PROFILER_LOG_INTERVAL, "OpcodeProfiler.LogInterval", 0);
+    m_timers[WUPDATE_OPCODE_STATS].SetInterval(getConfig(CONFIG_UINT32_OPCODE_PROFILER_LOG_INTERVAL) * MINUTE * IN_MILLISECONDS);
+    m_timers[WUPDATE_OPCODE_STATS].Reset();
+
+    setConfig(CONFIG_BOOL_MAP_TICK_PROFILER, "MapTickProfiler.Enable", false);
+    MapTickProfiler::SetEnabled(getConfig(CONFIG_BOOL_MAP_TICK_PROFILER));
+    setConfig(CONFIG_UINT32_MAP_TICK_PROFILER_LOG_INTERVAL, "MapTickProfiler.LogInterval", 0);
+    setConfig(CONFIG_UINT32_MAP_TICK_PROFILER_SLOW_TICK, "MapTickProfiler.SlowTickThreshold", 0);
+    MapTickProfiler::SetSlowTickThreshold(getConfig(CONFIG_UINT32_MAP_TICK_PROFILER_SLOW_TICK));
+    m_timers[WUPDATE_MAP_TICK_STATS].SetInterval(getConfig(CONFIG_UINT32_MAP_TICK_PROFILER_LOG_INTERVAL) * MINUTE * IN_MILLISECONDS);
+
+    setConfig(CONFIG_BOOL_LOCK_PROFILER, "LockProfiler.Enable", false);
+    LockProfiler::SetEnabled(getConfig(CONFIG_BOOL_LOCK_PROFILER));
+    setConfig(CONFIG_UINT32_LOCK_PROFILER_LOG_INTERVAL, "LockProfiler.LogInterval", 0);
+    m_timers[WUPDATE_LOCK_STATS].SetInterval(getConfig(CONFIG_UINT32_LOCK_PROFILER_LOG_INTERVAL) * MINUTE * IN_MILLISECONDS);
+    m_timers[WUPDATE_MAP_TICK_STATS].Reset();
+
+    setConfig(CONFIG_BOOL_PACKET_CAPTURE, "PacketCapture.Enable", false);
+    PacketCapture::SetEnabled(getConfig(CONFIG_BOOL_PACKET_CAPTURE));
+    std::string captureDir = sConfig.GetStringDefault("PacketCapture.Directory");
+    PacketCapture::SetDirectory(captureDir.empty() ? sConfig.GetStringDefault("LogsDir") : captureDir);
+
     sLog.outString();
 }
 
@@ -822,6 +1003,9 @@ void World::SetInitialWorldSettings()
     ///- Initialize config settings
     LoadConfigSettings();
 
+    ///- Template tables are read from their snapshot files while unchanged
+    SQLStorageSnapshot::SetDirectory(sConfig.GetStringDefault("SnapshotDir", ""));
+
     ///- Check the existence of the map files for all races start areas.
     if (!MapManager::ExistMapAndVMap(0, -6240.32f, 331.033f) ||                     // Dwarf/ Gnome
             !MapManager::ExistMapAndVMap(0, -8949.95f, -132.493f) ||                // Human
@@ -1081,6 +1265,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading taxi flight shortcuts...");
     sObjectMgr.LoadTaxiShortcuts();
 
+    sLog.outString("Resolving taxi flight path splines...");
+    Taxi::LoadItineraries();
+
     sLog.outString("Loading spell target destination coordinates...");
     sSpellMgr.LoadSpellTargetPositions();
 
@@ -1110,32 +1297,41 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading pet level stats...");
     sObjectMgr.LoadPetLevelInfo();
 
+    sLog.outString("Loading Character Names...");
+    sCharacterNameCache.Load();
+
     sLog.outString("Loading Player Corpses...");
     sObjectMgr.LoadCorpses();
 
     sLog.outString("Loading Player level dependent mail rewards...");
     sObjectMgr.LoadMailLevelRewards();
 
-    sLog.outString("Loading Loot Tables...");
-    LoadLootTables();
+    // these tables only read the templates loaded above and each fills its own store, so they can be loaded concurrently
+    MaNGOS::TaskGraph lootStage("Loot, skill and encounter tables");
+    std::vector<std::string> const lootTables = { "creature_loot_template", "fishing_loot_template", "gameobject_loot_template",
+        "item_loot_template", "mail_loot_template", "pickpocketing_loot_template", "skinning_loot_template",
+        "disenchant_loot_template", "prospecting_loot_template" };
+    lootStage.AddTask(lootTables[0], []() { LoadLootTemplates_Creature(); });
+    lootStage.AddTask(lootTables[1], []() { LoadLootTemplates_Fishing(); });
+    lootStage.AddTask(lootTables[2], []() { LoadLootTemplates_Gameobject(); });
+    lootStage.AddTask(lootTables[3], []() { LoadLootTemplates_Item(); });
+    lootStage.AddTask(lootTables[4], []() { LoadLootTemplates_Mail(); });
+    lootStage.AddTask(lootTables[5], []() { LoadLootTemplates_Pickpocketing(); });
+    lootStage.AddTask(lootTables[6], []() { LoadLootTemplates_Skinning(); });
+    lootStage.AddTask(lootTables[7], []() { LoadLootTemplates_Disenchant(); });
+    lootStage.AddTask(lootTables[8], []() { LoadLootTemplates_Prospecting(); });
+    lootStage.AddTask("reference_loot_template", &LoadLootTemplates_Reference, lootTables); // checks references of all other loot tables
+    lootStage.AddTask("skill_discovery_template", &LoadSkillDiscoveryTable);
+    lootStage.AddTask("skill_extra_item_template", &LoadSkillExtraItemTable);
+    lootStage.AddTask("skill_fishing_base_level", []() { sObjectMgr.LoadFishingBaseSkillLevel(); });
+    lootStage.AddTask("instance_encounters", []() { sObjectMgr.LoadInstanceEncounters(); });    // must be after Creature loading
+    lootStage.AddTask("npc_gossip", []() { sObjectMgr.LoadNpcGossips(); });                     // must be after load Creature and LoadGossipText
+
+    sLog.outString("Loading Loot Tables, Skill Discovery, Skill Extra Item, Fishing Skill, Instance encounters and Npc Text Id data...");
+    RunStartupTaskGraph(lootStage);
     sLog.outString(">>> Loot Tables loaded");
     sLog.outString();
 
-    sLog.outString("Loading Skill Discovery Table...");
-    LoadSkillDiscoveryTable();
-
-    sLog.outString("Loading Skill Extra Item Table...");
-    LoadSkillExtraItemTable();
-
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
-
-    sLog.outString("Loading Instance encounters data...");  // must be after Creature loading
-    sObjectMgr.LoadInstanceEncounters();
-
-    sLog.outString("Loading Npc Text Id...");
-    sObjectMgr.LoadNpcGossips();                            // must be after load Creature and LoadGossipText
-
     sLog.outString("Loading Scripts random templates...");  // must be before String calls
     sScriptMgr.LoadDbScriptRandomTemplates();
     ///- Load and initialize DBScripts Engine
@@ -1271,6 +1467,7 @@ void World::SetInitialWorldSettings()
     // Update "uptime" table based on configuration entry in minutes.
     m_timers[WUPDATE_CORPSES].SetInterval(20 * MINUTE * IN_MILLISECONDS);
     m_timers[WUPDATE_DELETECHARS].SetInterval(DAY * IN_MILLISECONDS); // check for chars to delete every day
+    m_timers[WUPDATE_REALM_CHAR_COUNTS].SetInterval(10 * IN_MILLISECONDS);
 
     // for AhBot
     m_timers[WUPDATE_AHBOT].SetInterval(20 * IN_MILLISECONDS); // every 20 sec
@@ -1278,6 +1475,9 @@ void World::SetInitialWorldSettings()
     // Update groups with offline leader after delay in seconds
     m_timers[WUPDATE_GROUPS].SetInterval(IN_MILLISECONDS);
 
+    // unload the bank data of idle guilds
+    m_timers[WUPDATE_GUILD_BANKS].SetInterval(MINUTE * IN_MILLISECONDS);
+
     // to set mailtimer to return mails every day between 4 and 5 am
     // mailtimer is increased when updating auctions
     // one second is 1000 -(tested on win system)
@@ -1356,11 +1556,35 @@ void World::SetInitialWorldSettings()
     sLog.outString("---------------------------------------");
     sLog.outString();
 
+    sLog.outString("Concurrent loading stages:");
+    lootStage.LogTimings();
+    sLog.outString();
+
+    sLog.outString("Memory after loading:");
+    MemoryTracker::LogReport();
+    sLog.outString();
+
     uint32 uStartInterval = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
     sLog.outString("SERVER STARTUP TIME: %i minutes %i seconds", uStartInterval / 60000, (uStartInterval % 60000) / 1000);
     sLog.outString();
 }
 
+void World::RunStartupTaskGraph(MaNGOS::TaskGraph& graph) const
+{
+    uint32 threads = getConfig(CONFIG_UINT32_STARTUP_LOAD_THREADS);
+    if (!threads)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // progress bars of concurrent loaders would overwrite each other
+    bool const showProgress = BarGoLink::GetOutputState();
+    if (threads > 1)
+        BarGoLink::SetOutputState(false);
+
+    graph.Run(threads, []() { WorldDatabase.ThreadStart(); }, []() { WorldDatabase.ThreadEnd(); });
+
+    BarGoLink::SetOutputState(showProgress);
+}
+
 void World::DetectDBCLang()
 {
     uint32 m_lang_confid = sConfig.GetIntDefault("DBC.Locale", 255);
@@ -1429,6 +1653,9 @@ void World::Update(uint32 diff)
     ///-Update mass mailer tasks if any
     sMassMailMgr.Update();
 
+    ///- Return or delete a chunk of the expired mails found by the last mail check
+    sObjectMgr.ProcessExpiredMails(getConfig(CONFIG_UINT32_MAIL_EXPIRED_PER_TICK));
+
     /// Handle daily quests reset time
     if (m_gameTime > m_NextDailyQuestReset)
         ResetDailyQuests();
@@ -1465,6 +1692,19 @@ void World::Update(uint32 diff)
         m_timers[WUPDATE_AHBOT].Reset();
     }
 
+    ///- Publish the players for the who list, before the sessions asking for it
+    if (m_timers[WUPDATE_WHO_LIST].Passed())
+    {
+        m_timers[WUPDATE_WHO_LIST].Reset();
+        sWhoListCache.Rebuild();
+    }
+
+    ///- Queue the due packets of the running replays, they are handled by this tick already
+    sPacketReplayMgr.Update(diff);
+
+    ///- Publish a finished background reload, no map is updated now and the sessions see the new data already
+    UpdateBackgroundReload();
+
     /// <li> Handle session updates
     UpdateSessions(diff);
 
@@ -1496,6 +1736,78 @@ void World::Update(uint32 diff)
         }
     }
 
+    ///- Unload the bank data of guilds that are not used anymore
+    if (m_timers[WUPDATE_GUILD_BANKS].Passed())
+    {
+        m_timers[WUPDATE_GUILD_BANKS].Reset();
+        sGuildMgr.UnloadIdleBankData();
+    }
+
+    ///- Write buffered character columns, also drains the buffer once it got disabled
+    if (m_timers[WUPDATE_WRITE_BEHIND].Passed())
+    {
+        m_timers[WUPDATE_WRITE_BEHIND].Reset();
+        sCharacterWriteBehind.FlushAll();
+    }
+
+    ///- Write the character counts of the accounts changed since the last time
+    if (m_timers[WUPDATE_REALM_CHAR_COUNTS].Passed())
+    {
+        m_timers[WUPDATE_REALM_CHAR_COUNTS].Reset();
+        sRealmCharacterCounter.Flush();
+    }
+
+    ///- Write the periodic database statement report
+    if (getConfig(CONFIG_UINT32_SQL_STATISTICS_LOG_INTERVAL) && m_timers[WUPDATE_SQL_STATS].Passed())
+    {
+        m_timers[WUPDATE_SQL_STATS].Reset();
+        if (SqlStatistics::IsEnabled())
+            SqlStatistics::LogReport(20);
+    }
+
+    ///- Write the periodic spell cost report
+    if (getConfig(CONFIG_UINT32_SPELL_PROFILER_LOG_INTERVAL) && m_timers[WUPDATE_SPELL_STATS].Passed())
+    {
+        m_timers[WUPDATE_SPELL_STATS].Reset();
+        if (SpellProfiler::IsEnabled())
+            SpellProfiler::LogReport(20);
+    }
+
+    ///- Write the periodic script cost report
+    if (getConfig(CONFIG_UINT32_SCRIPT_PROFILER_LOG_INTERVAL) && m_timers[WUPDATE_SCRIPT_STATS].Passed())
+    {
+        m_timers[WUPDATE_SCRIPT_STATS].Reset();
+        if (ScriptProfiler::IsEnabled())
+            ScriptProfiler::LogReport(20);
+    }
+
+    ///- Write the periodic opcode handler report, every report covers one interval for meaningful rates
+    if (getConfig(CONFIG_UINT32_OPCODE_PROFILER_LOG_INTERVAL) && m_timers[WUPDATE_OPCODE_STATS].Passed())
+    {
+        m_timers[WUPDATE_OPCODE_STATS].Reset();
+        if (OpcodeProfiler::IsEnabled())
+            OpcodeProfiler::LogReport(20);
+        OpcodeProfiler::Reset();
+    }
+
+    ///- Write the periodic map tick report, every report covers one interval so changes of the load show up
+    if (getConfig(CONFIG_UINT32_MAP_TICK_PROFILER_LOG_INTERVAL) && m_timers[WUPDATE_MAP_TICK_STATS].Passed())
+    {
+        m_timers[WUPDATE_MAP_TICK_STATS].Reset();
+        if (MapTickProfiler::IsEnabled())
+            MapTickProfiler::LogReport(10);
+        MapTickProfiler::Reset();
+    }
+
+    ///- Write the periodic lock contention report, the counters restart after every report
+    if (getConfig(CONFIG_UINT32_LOCK_PROFILER_LOG_INTERVAL) && m_timers[WUPDATE_LOCK_STATS].Passed())
+    {
+        m_timers[WUPDATE_LOCK_STATS].Reset();
+        if (LockProfiler::IsEnabled())
+            LockProfiler::LogReport();
+        LockProfiler::Reset();
+    }
+
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
     {
@@ -1506,7 +1818,7 @@ void World::Update(uint32 diff)
     // execute callbacks from sql queries that were queued recently
     UpdateResultQueue();
 
-    ///- Erase corpses once every 20 minutes
+    ///- Erase expired corpses outside of the world once every 20 minutes, maps expire their own
     if (m_timers[WUPDATE_CORPSES].Passed())
     {
         m_timers[WUPDATE_CORPSES].Reset();
@@ -1954,6 +2266,24 @@ void World::UpdateSessions(uint32 diff)
         m_sessionAddQueue.clear();
     }
 
+    ///- Handle the session local packets of all sessions on the map threads, see SessionLocalFilter
+    MapUpdater& mapUpdater = sMapMgr.GetMapUpdater();
+    uint32 minSessions = getConfig(CONFIG_UINT32_SESSION_PARALLEL_MIN_SESSIONS);
+    if (minSessions && m_sessions.size() >= minSessions && mapUpdater.activated())
+    {
+        std::vector<WorldSession*> sessions;
+        sessions.reserve(m_sessions.size());
+        for (auto const& itr : m_sessions)
+            sessions.push_back(itr.second);
+
+        std::shared_ptr<SessionLocalBatch> batch = std::make_shared<SessionLocalBatch>(std::move(sessions));
+        for (size_t i = 0; i < mapUpdater.thread_count(); ++i)
+            mapUpdater.schedule_update(new SessionLocalWorker(batch, mapUpdater));
+
+        while (batch->ProcessNext()) {}
+        batch->Wait();
+    }
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(); itr != m_sessions.end();)
     {
@@ -2021,10 +2351,7 @@ void World::_UpdateRealmCharCount(QueryResult* resultCharCount, uint32 accountId
         uint32 charCount = fields[0].GetUInt32();
         delete resultCharCount;
 
-        LoginDatabase.BeginTransaction();
-        LoginDatabase.PExecute("DELETE FROM realmcharacters WHERE acctid= '%u' AND realmid = '%u'", accountId, realmID);
-        LoginDatabase.PExecute("INSERT INTO realmcharacters (numchars, acctid, realmid) VALUES (%u, %u, %u)", charCount, accountId, realmID);
-        LoginDatabase.CommitTransaction();
+        sRealmCharacterCounter.SetRealmCount(accountId, charCount);
     }
 }
 
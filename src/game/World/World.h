@@ -32,7 +32,9 @@
 #include <set>
 #include <list>
 #include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <functional>
 #include <utility>
 #include <vector>
@@ -45,6 +47,11 @@ class Player;
 class QueryResult;
 class WorldSocket;
 
+namespace MaNGOS
+{
+    class TaskGraph;
+}
+
 // ServerMessages.dbc
 enum ServerMessageType
 {
@@ -78,7 +85,17 @@ enum WorldTimers
     WUPDATE_DELETECHARS = 4,
     WUPDATE_AHBOT       = 5,
     WUPDATE_GROUPS      = 6,
-    WUPDATE_COUNT       = 7
+    WUPDATE_SQL_STATS   = 7,
+    WUPDATE_WRITE_BEHIND = 8,
+    WUPDATE_SPELL_STATS = 9,
+    WUPDATE_SCRIPT_STATS = 10,
+    WUPDATE_WHO_LIST    = 11,
+    WUPDATE_REALM_CHAR_COUNTS = 12,
+    WUPDATE_OPCODE_STATS = 13,
+    WUPDATE_MAP_TICK_STATS = 14,
+    WUPDATE_LOCK_STATS  = 15,
+    WUPDATE_GUILD_BANKS = 16,
+    WUPDATE_COUNT       = 17
 };
 
 /// Configuration elements
@@ -86,7 +103,11 @@ enum eConfigUInt32Values
 {
     CONFIG_UINT32_COMPRESSION = 0,
     CONFIG_UINT32_INTERVAL_SAVE,
+    CONFIG_UINT32_INTERVAL_WRITE_BEHIND,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
+    CONFIG_UINT32_GRID_PREFETCH_LOOKAHEAD,
+    CONFIG_UINT32_TERRAIN_CACHE_SIZE,
+    CONFIG_UINT32_GRID_UNLOADS_PER_UPDATE,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
@@ -129,9 +150,29 @@ enum eConfigUInt32Values
     CONFIG_UINT32_GM_INVISIBLE_AURA,
     CONFIG_UINT32_MAIL_DELIVERY_DELAY,
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
+    CONFIG_UINT32_MASS_MAILER_MAX_DB_QUEUE,
+    CONFIG_UINT32_MAIL_EXPIRED_PER_TICK,
     CONFIG_UINT32_UPTIME_UPDATE,
     CONFIG_UINT32_NUM_MAP_THREADS,
+    CONFIG_UINT32_STARTUP_LOAD_THREADS,
+    CONFIG_UINT32_SQL_STATISTICS_LOG_INTERVAL,
+    CONFIG_UINT32_SPELL_PROFILER_SAMPLE_RATE,
+    CONFIG_UINT32_SPELL_PROFILER_LOG_INTERVAL,
+    CONFIG_UINT32_SCRIPT_PROFILER_SAMPLE_RATE,
+    CONFIG_UINT32_SCRIPT_PROFILER_LOG_INTERVAL,
+    CONFIG_UINT32_OPCODE_PROFILER_LOG_INTERVAL,
+    CONFIG_UINT32_MAP_TICK_PROFILER_LOG_INTERVAL,
+    CONFIG_UINT32_MAP_TICK_PROFILER_SLOW_TICK,
+    CONFIG_UINT32_LOCK_PROFILER_LOG_INTERVAL,
+    CONFIG_UINT32_SAVE_RESPAWN_TIME_FLUSH_INTERVAL,
+    CONFIG_UINT32_QUEST_GIVER_STATUS_CACHE_LIFETIME,
+    CONFIG_UINT32_MAP_PARALLEL_CELLS_MIN_PLAYERS,
+    CONFIG_UINT32_MAP_IDLE_UPDATE_INTERVAL,
+    CONFIG_UINT32_SESSION_PARALLEL_MIN_SESSIONS,
+    CONFIG_UINT32_MAP_AI_BUDGET,
+    CONFIG_UINT32_MAP_AI_BUDGET_MAX_DELAY,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
+    CONFIG_UINT32_AUCTION_EXPIRED_PER_UPDATE,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
     CONFIG_UINT32_SKILL_CHANCE_YELLOW,
     CONFIG_UINT32_SKILL_CHANCE_GREEN,
@@ -165,14 +206,18 @@ enum eConfigUInt32Values
     CONFIG_UINT32_BATTLEGROUND_PREMATURE_FINISH_TIMER,
     CONFIG_UINT32_BATTLEGROUND_PREMADE_GROUP_WAIT_FOR_MATCH,
     CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN,
+    CONFIG_UINT32_BATTLEGROUND_SCOREBOARD_INTERVAL,
     CONFIG_UINT32_ARENA_MAX_RATING_DIFFERENCE,
     CONFIG_UINT32_ARENA_RATING_DISCARD_TIMER,
     CONFIG_UINT32_ARENA_AUTO_DISTRIBUTE_INTERVAL_DAYS,
     CONFIG_UINT32_ARENA_SEASON_ID,
     CONFIG_UINT32_ARENA_FIRST_RESET_DAY,
     CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY,
+    CONFIG_UINT32_GROUP_UPDATE_INTERVAL,
     CONFIG_UINT32_GUILD_EVENT_LOG_COUNT,
     CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT,
+    CONFIG_UINT32_GUILD_BANK_UNLOAD_DELAY,
+    CONFIG_UINT32_GAME_EVENT_SPAWN_BATCH_SIZE,
     CONFIG_UINT32_MIRRORTIMER_FATIGUE_MAX,
     CONFIG_UINT32_MIRRORTIMER_BREATH_MAX,
     CONFIG_UINT32_MIRRORTIMER_ENVIRONMENTAL_MAX,
@@ -184,10 +229,21 @@ enum eConfigUInt32Values
     CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT,
     CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY,
     CONFIG_UINT32_MAX_WHOLIST_RETURNS,
+    CONFIG_UINT32_WHOLIST_SNAPSHOT_INTERVAL,
+    CONFIG_UINT32_NETWORK_MAX_PENDING_AUTH,
+    CONFIG_UINT32_LOGIN_QUEUE_PREFETCH,
+    CONFIG_UINT32_CHAR_ENUM_CACHE_TIME,
+    CONFIG_UINT32_PLAYER_LINGER_TIME,
     CONFIG_UINT32_FOGOFWAR_STEALTH,
     CONFIG_UINT32_FOGOFWAR_HEALTH,
     CONFIG_UINT32_FOGOFWAR_STATS,
     CONFIG_UINT32_CREATURE_PICKPOCKET_RESTOCK_DELAY,
+    CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL,
+    CONFIG_UINT32_CREATURE_IDLE_UPDATE_MOVEMENT_TYPES,
+    CONFIG_UINT32_CREATURE_IDLE_UPDATE_AI_TYPES,
+    CONFIG_UINT32_MMAP_MAX_CHASE_PATHS_PER_TICK,
+    CONFIG_UINT32_MOVEMENT_LOD_HEARTBEAT_INTERVAL,
+    CONFIG_UINT32_COMBAT_LOG_COALESCE_MAX_DELAY,
     CONFIG_UINT32_VALUE_COUNT
 };
 
@@ -274,6 +330,7 @@ enum eConfigFloatValues
     CONFIG_FLOAT_THREAT_RADIUS,
     CONFIG_FLOAT_GHOST_RUN_SPEED_WORLD,
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
+    CONFIG_FLOAT_MOVEMENT_LOD_RADIUS,
     CONFIG_FLOAT_VALUE_COUNT
 };
 
@@ -281,7 +338,11 @@ enum eConfigFloatValues
 enum eConfigBoolValues
 {
     CONFIG_BOOL_GRID_UNLOAD = 0,
+    CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED,
+    CONFIG_BOOL_GRID_LAZY_CELLS,
     CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY,
+    CONFIG_BOOL_SAVE_RESPAWN_TIME_FLUSH_ON_SHUTDOWN,
+    CONFIG_BOOL_PLAYER_LINGER_PROTECT,
     CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET,
     CONFIG_BOOL_ALLOW_TWO_SIDE_ACCOUNTS,
     CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_CHAT,
@@ -312,6 +373,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_CHAT_STRICT_LINK_CHECKING_KICK,
     CONFIG_BOOL_ADDON_CHANNEL,
     CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW,
+    CONFIG_BOOL_CORPSE_DEFERRED_ITEM_LOOT,
     CONFIG_BOOL_CORPSE_ALLOW_ALL_ITEMS_SHOW_IN_MASTER_LOOT,
     CONFIG_BOOL_DEATH_CORPSE_RECLAIM_DELAY_PVP,
     CONFIG_BOOL_DEATH_CORPSE_RECLAIM_DELAY_PVE,
@@ -339,6 +401,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
+    CONFIG_BOOL_VMAP_QUERY_CACHE,
     CONFIG_BOOL_PET_UNSUMMON_AT_MOUNT,
     CONFIG_BOOL_PET_ATTACK_FROM_BEHIND,
     CONFIG_BOOL_AUTO_DOWNRANK,
@@ -346,6 +409,14 @@ enum eConfigBoolValues
     CONFIG_BOOL_PLAYER_COMMANDS,
     CONFIG_BOOL_PATH_FIND_OPTIMIZE,
     CONFIG_BOOL_PATH_FIND_NORMALIZE_Z,
+    CONFIG_BOOL_SQL_STATISTICS,
+    CONFIG_BOOL_SPELL_PROFILER,
+    CONFIG_BOOL_SCRIPT_PROFILER,
+    CONFIG_BOOL_OPCODE_PROFILER,
+    CONFIG_BOOL_MAP_TICK_PROFILER,
+    CONFIG_BOOL_LOCK_PROFILER,
+    CONFIG_BOOL_PACKET_CAPTURE,
+    CONFIG_BOOL_COMBAT_LOG_COALESCE,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -438,6 +509,24 @@ struct CliCommandHolder
     }
 };
 
+/// A world table reload read by a worker thread, the world thread publishes it between two map updates
+class BackgroundReload
+{
+    public:
+        explicit BackgroundReload(char const* publishedText) : m_publishedText(publishedText) {}
+        virtual ~BackgroundReload() {}
+
+        /// Worker thread, builds the new data without touching the data in use
+        virtual void Load() = 0;
+        /// World thread while no map is updated, replaces the data in use by the loaded one
+        virtual void Publish() = 0;
+
+        char const* GetPublishedText() const { return m_publishedText; }
+
+    private:
+        char const* m_publishedText;                        // announced to all players once published
+};
+
 /// The World
 class World
 {
@@ -461,6 +550,10 @@ class World
         uint32 GetMaxQueuedSessionCount() const { return m_maxQueuedSessionCount; }
         uint32 GetMaxActiveSessionCount() const { return m_maxActiveSessionCount; }
 
+        /// Takes ownership of the reload and starts it, false (and the reload deleted) while another one still runs
+        bool StartBackgroundReload(BackgroundReload* reload);
+        bool IsBackgroundReloadRunning() const { return m_backgroundReload != nullptr; }
+
         /// Get the active session server limit (or security level limitations)
         uint32 GetPlayerAmountLimit() const { return m_playerLimit >= 0 ? m_playerLimit : 0; }
         AccountTypes GetPlayerSecurityLimit() const { return m_playerLimit <= 0 ? AccountTypes(-m_playerLimit) : SEC_PLAYER; }
@@ -572,6 +665,7 @@ class World
 
         static float GetRelocationLowerLimitSq() { return m_relocation_lower_limit_sq; }
         static uint32 GetRelocationAINotifyDelay() { return m_relocation_ai_notify_delay; }
+        static uint32 GetRelocationVisibilityNotifyDelay() { return m_relocation_visibility_notify_delay; }
 
         void ProcessCliCommands();
         void QueueCliCommand(const CliCommandHolder* commandHolder) { std::lock_guard<std::mutex> guard(m_cliCommandQueueLock); m_cliCommandQueue.push_back(commandHolder); }
@@ -627,6 +721,9 @@ class World
         void ResetWeeklyQuests();
         void ResetMonthlyQuests();
 
+        /// Starts reading the character lists of the sessions at the front of the login queue
+        void PrefetchQueuedSessions();
+
     private:
         void setConfig(eConfigUInt32Values index, char const* fieldname, uint32 defvalue);
         void setConfig(eConfigInt32Values index, char const* fieldname, int32 defvalue);
@@ -669,6 +766,7 @@ class World
         LocaleConstant m_defaultDbcLocale;                  // from config for one from loaded DBC locales
         uint32 m_availableDbcLocaleMask;                    // by loaded DBC
         void DetectDBCLang();
+        void RunStartupTaskGraph(MaNGOS::TaskGraph& graph) const;
         bool m_allowMovement;
         std::string m_motd;
         std::string m_dataPath;
@@ -680,6 +778,14 @@ class World
 
         static float  m_relocation_lower_limit_sq;
         static uint32 m_relocation_ai_notify_delay;
+        static uint32 m_relocation_visibility_notify_delay;
+
+        void UpdateBackgroundReload();
+        void StopBackgroundReload();
+
+        std::unique_ptr<BackgroundReload> m_backgroundReload;
+        std::thread m_backgroundReloadThread;
+        std::atomic<bool> m_backgroundReloadLoaded;
 
         // CLI command holder to be thread safe
         std::mutex m_cliCommandQueueLock;
@@ -42,7 +42,7 @@ enum
     GROMGOLOG_EVENT_4   = 15325,
 };
 
-WorldState::WorldState() : m_emeraldDragonsState(0xF), m_emeraldDragonsTimer(0), m_emeraldDragonsChosenPositions(4, 0), m_isMagtheridonHeadSpawnedHorde(false), m_isMagtheridonHeadSpawnedAlliance(false), m_adalSongOfBattleTimer(0), m_expansion(EXPANSION_TBC)
+WorldState::WorldState() : m_emeraldDragonsState(0xF), m_emeraldDragonsRespawnTime(), m_emeraldDragonsChosenPositions(4, 0), m_isMagtheridonHeadSpawnedHorde(false), m_isMagtheridonHeadSpawnedAlliance(false), m_adalSongOfBattleEndTime(), m_expansion(EXPANSION_TBC), m_nextTimerExpire(TimePoint::max())
 {
     m_transportStates[GROMGOL_UNDERCITY]    = GROMGOLUC_EVENT_1;
     m_transportStates[GROMGOL_ORGRIMMAR]    = OGUC_EVENT_1;
@@ -71,24 +71,21 @@ void WorldState::Load()
             {
                 case SAVE_ID_EMERALD_DRAGONS:
                 {
-                    auto curTime = World::GetCurrentClockTime();
                     uint64 respawnTime;
                     if (data.size())
                     {
                         loadStream >> m_emeraldDragonsState >> respawnTime;
                         for (uint32 i = 0; i < 4; ++i)
                             loadStream >> m_emeraldDragonsChosenPositions[i];
-                        if (respawnTime)
-                        {
-                            TimePoint respawnTimePoint = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::from_time_t(respawnTime));
-                            m_emeraldDragonsTimer = std::chrono::duration_cast<std::chrono::milliseconds>(respawnTimePoint - curTime).count();
-                        }
-                        else m_emeraldDragonsTimer = 0;
+                        // a respawn time passed while the server was down is handled by the respawn below
+                        if (respawnTime && Clock::from_time_t(respawnTime) > World::GetCurrentClockTime())
+                            m_emeraldDragonsRespawnTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::from_time_t(respawnTime));
+                        else m_emeraldDragonsRespawnTime = TimePoint();
                     }
                     else
                     {
                         m_emeraldDragonsState = 0xF;
-                        m_emeraldDragonsTimer = 0;
+                        m_emeraldDragonsRespawnTime = TimePoint();
                     }
                     break;
                 }
@@ -112,6 +109,7 @@ void WorldState::Load()
     }
     RespawnEmeraldDragons();
     StartExpansionEvent();
+    UpdateNextTimerExpire();
 }
 
 void WorldState::Save(SaveIds saveId)
@@ -121,12 +119,8 @@ void WorldState::Save(SaveIds saveId)
         case SAVE_ID_EMERALD_DRAGONS:
         {
             uint64 time;
-            if (m_emeraldDragonsTimer)
-            {
-                auto curTime = World::GetCurrentClockTime();
-                auto respawnTime = std::chrono::milliseconds(m_emeraldDragonsTimer) + curTime;
-                time = uint64(Clock::to_time_t(respawnTime));
-            }
+            if (m_emeraldDragonsRespawnTime != TimePoint())
+                time = uint64(Clock::to_time_t(m_emeraldDragonsRespawnTime));
             else time = 0;
             std::string dragonsData = std::to_string(m_emeraldDragonsState) + " " + std::to_string(time);
             for (uint32 i = 0; i < 4; ++i)
@@ -223,7 +217,7 @@ void WorldState::HandlePlayerEnterZone(Player* player, uint32 zoneId)
         case ZONEID_ARCATRAZ:
         {
             std::lock_guard<std::mutex> guard(m_mutex);
-            if (m_adalSongOfBattleTimer)
+            if (m_adalSongOfBattleEndTime != TimePoint())
                 player->CastSpell(player, SPELL_ADAL_SONG_OF_BATTLE, TRIGGERED_OLD_TRIGGERED);
             m_adalSongOfBattlePlayers.push_back(player->GetObjectGuid());
         }
@@ -387,40 +381,51 @@ void WorldState::HandleExternalEvent(uint32 eventId)
             }
             m_emeraldDragonsState |= 1 << bossId;
             if (m_emeraldDragonsState == 0xF)
-                m_emeraldDragonsTimer = 30 * HOUR * IN_MILLISECONDS;
+                m_emeraldDragonsRespawnTime = World::GetCurrentClockTime() + std::chrono::hours(30);
             Save(SAVE_ID_EMERALD_DRAGONS); // save to DB right away
             break;
         }
         case CUSTOM_EVENT_ADALS_SONG_OF_BATTLE:
-            m_adalSongOfBattleTimer = 120 * MINUTE * IN_MILLISECONDS; // Two hours duration
+            m_adalSongOfBattleEndTime = World::GetCurrentClockTime() + std::chrono::hours(2); // Two hours duration
             BuffAdalsSongOfBattle();
             break;
     }
+
+    UpdateNextTimerExpire();
 }
 
-void WorldState::Update(const uint32 diff)
+void WorldState::Update(const uint32 /*diff*/)
 {
+    // the timers are deadlines, the world thread only takes the lock once the earliest of them expired
+    TimePoint now = World::GetCurrentClockTime();
+    if (now < m_nextTimerExpire.load())
+        return;
+
     std::lock_guard<std::mutex> guard(m_mutex);
 
-    if (m_adalSongOfBattleTimer)
+    if (m_adalSongOfBattleEndTime != TimePoint() && m_adalSongOfBattleEndTime <= now)
     {
-        if (m_adalSongOfBattleTimer <= diff)
-        {
-            m_adalSongOfBattleTimer = 0;
-            DispelAdalsSongOfBattle();
-        }
-        else m_adalSongOfBattleTimer -= diff;
+        m_adalSongOfBattleEndTime = TimePoint();
+        DispelAdalsSongOfBattle();
     }
 
-    if (m_emeraldDragonsTimer)
+    if (m_emeraldDragonsRespawnTime != TimePoint() && m_emeraldDragonsRespawnTime <= now)
     {
-        if (m_emeraldDragonsTimer <= diff)
-        {
-            m_emeraldDragonsTimer = 0;
-            RespawnEmeraldDragons();
-        }
-        else m_emeraldDragonsTimer -= diff;
+        m_emeraldDragonsRespawnTime = TimePoint();
+        RespawnEmeraldDragons();
     }
+
+    UpdateNextTimerExpire();
+}
+
+void WorldState::UpdateNextTimerExpire()
+{
+    TimePoint next = TimePoint::max();
+    if (m_adalSongOfBattleEndTime != TimePoint())
+        next = std::min(next, m_adalSongOfBattleEndTime);
+    if (m_emeraldDragonsRespawnTime != TimePoint())
+        next = std::min(next, m_emeraldDragonsRespawnTime);
+    m_nextTimerExpire.store(next);
 }
 
 void WorldState::BuffAdalsSongOfBattle()
@@ -150,12 +150,15 @@ class WorldState
         std::mutex m_mutex; // all World State operations are thread unsafe
         uint32 m_saveTimer;
 
+        // earliest deadline of the timers below, read without the lock by Update
+        void UpdateNextTimerExpire();
+
         // vanilla section
         bool IsDragonSpawned(uint32 entry);
         void RespawnEmeraldDragons();
 
         uint8 m_emeraldDragonsState;
-        uint32 m_emeraldDragonsTimer;
+        TimePoint m_emeraldDragonsRespawnTime;              // TimePoint() while the dragons are up
         std::vector<uint32> m_emeraldDragonsChosenPositions;
         AhnQirajData m_aqData;
 
@@ -167,7 +170,7 @@ class WorldState
         GuidVector m_magtheridonHeadPlayers;
 
         GuidVector m_adalSongOfBattlePlayers;
-        uint32 m_adalSongOfBattleTimer;
+        TimePoint m_adalSongOfBattleEndTime;                // TimePoint() while the buff is not active
 
         QuelDanasData m_quelDanasData;
 
@@ -175,6 +178,8 @@ class WorldState
         void StartExpansionEvent();
 
         std::atomic<uint8> m_expansion;
+
+        std::atomic<TimePoint> m_nextTimerExpire;
 };
 
 #define sWorldState MaNGOS::Singleton<WorldState>::Instance()
@@ -120,6 +120,18 @@ class BIH
 
         template<typename RayCallback>
         void intersectRay(const Ray& r, RayCallback& intersectCallback, float& maxDist, bool stopAtFirst = false, bool ignoreM2Model = false) const
+        {
+            ObjectLeafCallback<RayCallback> leafCallback(intersectCallback, ignoreM2Model);
+            intersectRayLeaves(r, leafCallback, maxDist, stopAtFirst);
+        }
+
+        /**
+        Like intersectRay, but the callback gets all objects of a leaf at once, so it can test them together:
+        bool operator()(const Ray& r, const uint32* objects, int count, float& maxDist, bool stopAtFirst)
+        returning true to end the traversal.
+        */
+        template<typename LeafCallback>
+        void intersectRayLeaves(const Ray& r, LeafCallback& leafCallback, float& maxDist, bool stopAtFirst = false) const
         {
             float intervalMin = -1.f;
             float intervalMax = -1.f;
@@ -219,13 +231,8 @@ class BIH
                         {
                             // leaf - test some objects
                             int n = tree[node + 1];
-                            while (n > 0)
-                            {
-                                bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst, ignoreM2Model);
-                                if (stopAtFirst && hit) return;
-                                --n;
-                                ++offset;
-                            }
+                            if (n > 0 && leafCallback(r, objects.data() + offset, n, maxDist, stopAtFirst))
+                                return;
                             break;
                         }
                     }
@@ -343,6 +350,26 @@ class BIH
         bool readFromFile(FILE* rf);
 
     protected:
+        template<typename RayCallback>
+        struct ObjectLeafCallback
+        {
+            ObjectLeafCallback(RayCallback& callback, bool ignoreM2Model) : intersectCallback(callback), ignoreM2(ignoreM2Model) {}
+
+            bool operator()(const Ray& r, const uint32* leafObjects, int count, float& maxDist, bool stopAtFirst)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    bool hit = intersectCallback(r, leafObjects[i], maxDist, stopAtFirst, ignoreM2);
+                    if (stopAtFirst && hit)
+                        return true;
+                }
+                return false;
+            }
+
+            RayCallback& intersectCallback;
+            bool ignoreM2;
+        };
+
         std::vector<uint32> tree;
         std::vector<uint32> objects;
         AABox bounds;
@@ -20,9 +20,19 @@
 
 #include <G3D/Table.h>
 #include <G3D/Array.h>
-#include <G3D/Set.h>
 #include "BIH.h"
 
+#include <vector>
+
+// objects inserted since the last build are tested linearly until there are this many of them
+#define BIHWRAP_MAX_PENDING 16
+
+/**
+    BIH over object pointers which is not rebuilt for every change.
+    Removed objects leave an empty slot in the tree, inserted ones are kept in a short pending list
+    and tested linearly, the tree is only rebuilt once either grows too large.
+    Queries never rebuild, so they stay read only for the threads updating the cells of a map.
+*/
 template<class T, class BoundsFunc = BoundsTrait<T> >
 class BIHWrap
 {
@@ -32,8 +42,9 @@ class BIHWrap
             const T* const* objects;
             RayCallback& cb;
             uint32 objectsSize;
+            bool hit;
 
-            MDLCallback(RayCallback& callback, const T* const* objects_array, uint32 objSize) : objects(objects_array), cb(callback), objectsSize(objSize) {}
+            MDLCallback(RayCallback& callback, const T* const* objects_array, uint32 objSize) : objects(objects_array), cb(callback), objectsSize(objSize), hit(false) {}
 
             bool operator()(const Ray& r, uint32 Idx, float& MaxDist, bool /*stopAtFirst*/, bool /*ignoreM2Model*/)
             {
@@ -41,8 +52,9 @@ class BIHWrap
                     return false;
 
                 if (const T* obj = objects[Idx])
-                    return cb(r, *obj, MaxDist/*, stopAtFirst, ignoreM2Model*/);
-                return false;
+                    if (cb(r, *obj, MaxDist/*, stopAtFirst, ignoreM2Model*/))
+                        hit = true;
+                return hit;
             }
 
             void operator()(const Vector3& p, uint32 Idx)
@@ -58,41 +70,64 @@ class BIHWrap
         typedef G3D::Array<const T*> ObjArray;
 
         BIH m_tree;
-        ObjArray m_objects;
-        G3D::Table<const T*, uint32> m_obj2Idx;
-        G3D::Set<const T*> m_objects_to_push;
-        int unbalanced_times;
+        ObjArray m_objects;                                 // by tree index, null for removed objects
+        G3D::Table<const T*, uint32> m_obj2Idx;             // objects in the tree
+        std::vector<const T*> m_pending;                    // objects inserted after the last build
+        uint32 m_removed;                                   // empty slots of m_objects
+
+        bool needsRebuild() const
+        {
+            return m_pending.size() > BIHWRAP_MAX_PENDING || m_removed > std::max<uint32>(BIHWRAP_MAX_PENDING, m_objects.size() / 2);
+        }
 
     public:
 
-        BIHWrap() : unbalanced_times(0) {}
+        BIHWrap() : m_removed(0) {}
 
         void insert(const T& obj)
         {
-            ++unbalanced_times;
-            m_objects_to_push.insert(&obj);
+            m_pending.push_back(&obj);
         }
 
         void remove(const T& obj)
         {
-            ++unbalanced_times;
             uint32 Idx = 0;
             const T* temp;
             if (m_obj2Idx.getRemove(&obj, temp, Idx))
+            {
                 m_objects[Idx] = nullptr;
+                ++m_removed;
+            }
             else
-                m_objects_to_push.remove(&obj);
+            {
+                typename std::vector<const T*>::iterator itr = std::find(m_pending.begin(), m_pending.end(), &obj);
+                if (itr != m_pending.end())
+                {
+                    *itr = m_pending.back();
+                    m_pending.pop_back();
+                }
+            }
         }
 
+        // rebuilds the tree if the pending or removed objects make the queries too slow, called by the map update
         void balance()
         {
-            if (unbalanced_times == 0)
+            if (!needsRebuild())
                 return;
 
-            unbalanced_times = 0;
-            m_objects.fastClear();
-            m_obj2Idx.getKeys(m_objects);
-            m_objects_to_push.getMembers(m_objects);
+            ObjArray objects;
+            for (int i = 0; i < m_objects.size(); ++i)
+                if (m_objects[i])
+                    objects.append(m_objects[i]);
+            for (const T* obj : m_pending)
+                objects.append(obj);
+
+            m_pending.clear();
+            m_removed = 0;
+            m_objects = objects;
+            m_obj2Idx.clear();
+            for (int i = 0; i < m_objects.size(); ++i)
+                m_obj2Idx.set(m_objects[i], uint32(i));
 
             m_tree.build(m_objects, BoundsFunc::getBounds2);
         }
@@ -100,16 +135,23 @@ class BIHWrap
         template<typename RayCallback>
         void intersectRay(const Ray& r, RayCallback& intersectCallback, float& maxDist)
         {
-            balance();
             MDLCallback<RayCallback> temp_cb(intersectCallback, m_objects.getCArray(), m_objects.size());
             m_tree.intersectRay(r, temp_cb, maxDist, true);
+            if (temp_cb.hit)
+                return;
+
+            for (const T* obj : m_pending)
+                if (intersectCallback(r, *obj, maxDist))
+                    return;
         }
 
         template<typename IsectCallback>
         void intersectPoint(const Vector3& p, IsectCallback& intersectCallback)
         {
-            balance();
             MDLCallback<IsectCallback> temp_cb(intersectCallback, m_objects.getCArray(), m_objects.size());
             m_tree.intersectPoint(p, temp_cb);
+
+            for (const T* obj : m_pending)
+                intersectCallback(p, *obj);
         }
 };
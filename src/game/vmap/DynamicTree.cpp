@@ -264,6 +264,26 @@ bool DynamicMapTree::isInLineOfSight(float x1, float y1, float z1, float x2, flo
     return !callback.did_hit;
 }
 
+void DynamicMapTree::isInLineOfSight(float x1, float y1, float z1, const std::vector<Vector3>& targets, std::vector<bool>& results) const
+{
+    Vector3 v1(x1, y1, z1);
+
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        if (!results[i])
+            continue;
+
+        float maxDist = (targets[i] - v1).magnitude();
+        if (!G3D::fuzzyGt(maxDist, 0))
+            continue;
+
+        G3D::Ray r(v1, (targets[i] - v1) / maxDist);
+        DynamicTreeIntersectionCallback callback;
+        impl.intersectRay(r, callback, maxDist, targets[i]);
+        results[i] = !callback.did_hit;
+    }
+}
+
 float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist) const
 {
     Vector3 v(x, y, z);
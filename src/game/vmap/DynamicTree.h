@@ -19,6 +19,8 @@
 #ifndef DYNAMICMAP_TREE_H
 #define DYNAMICMAP_TREE_H
 #include "Platform/Define.h"
+
+#include <vector>
 namespace G3D
 {
     class Vector3;
@@ -35,6 +37,8 @@ class DynamicMapTree
         ~DynamicMapTree();
 
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const;
+        // tests only the targets whose results are still true, so it can run after the static tree
+        void isInLineOfSight(float x1, float y1, float z1, const std::vector<G3D::Vector3>& targets, std::vector<bool>& results) const;
         bool getIntersectionTime(const G3D::Ray& ray, const G3D::Vector3& endPos, float& maxDist) const;
         bool getObjectHitPos(const G3D::Vector3& pPos1, const G3D::Vector3& pPos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
         bool getObjectHitPos(float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float pModifyDist) const;
@@ -20,8 +20,14 @@
 #define _IVMAPMANAGER_H
 
 #include <string>
+#include <vector>
 #include <Platform/Define.h>
 
+namespace G3D
+{
+    class Vector3;
+}
+
 //===========================================================
 
 /**
@@ -60,6 +66,10 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model) = 0;
+            /**
+            line of sight from one origin to each of the targets, results[i] is set for targets[i]
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const std::vector<G3D::Vector3>& targets, std::vector<bool>& results, bool ignoreM2Model) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
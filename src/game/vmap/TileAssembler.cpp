@@ -24,6 +24,9 @@
 #include <set>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 using G3D::Vector3;
 using G3D::AABox;
@@ -52,12 +55,13 @@ namespace VMAP
 
     //=================================================================
 
-    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName)
+    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 pThreads)
     {
         iCurrentUniqueNameId = 0;
         iFilterMethod = nullptr;
         iSrcDir = pSrcDirName;
         iDestDir = pDestDirName;
+        iThreads = pThreads ? pThreads : 1;
         // mkdir(iDestDir);
         // init();
     }
@@ -180,16 +184,8 @@ namespace VMAP
 
         // export objects
         std::cout << "\nConverting Model Files" << std::endl;
-        for (const auto& spawnedModelFile : spawnedModelFiles)
-        {
-            std::cout << "Converting " << spawnedModelFile << std::endl;
-            if (!convertRawFile(spawnedModelFile))
-            {
-                std::cout << "error converting " << spawnedModelFile << std::endl;
-                success = false;
-                break;
-            }
-        }
+        if (!convertRawFiles())
+            success = false;
 
         // cleanup:
         for (auto& map_iter : mapData)
@@ -281,6 +277,48 @@ namespace VMAP
         return true;
     }
 
+    // every model goes to its own file, so the output does not depend on the conversion order
+    bool TileAssembler::convertRawFiles()
+    {
+        std::vector<std::string> modelFiles(spawnedModelFiles.begin(), spawnedModelFiles.end());
+        std::atomic<uint32> nextModel(0);
+        std::atomic<bool> failed(false);
+        std::mutex outputLock;
+
+        auto convertModels = [&]()
+        {
+            for (uint32 i = nextModel++; i < modelFiles.size() && !failed; i = nextModel++)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(outputLock);
+                    std::cout << "Converting " << modelFiles[i] << std::endl;
+                }
+
+                if (!convertRawFile(modelFiles[i]))
+                {
+                    std::lock_guard<std::mutex> guard(outputLock);
+                    std::cout << "error converting " << modelFiles[i] << std::endl;
+                    failed = true;
+                }
+            }
+        };
+
+        uint32 threadCount = std::min(iThreads, uint32(modelFiles.size()));
+        if (threadCount > 1)
+        {
+            std::vector<std::thread> workers;
+            for (uint32 i = 0; i < threadCount; ++i)
+                workers.push_back(std::thread(convertModels));
+
+            for (std::thread& worker : workers)
+                worker.join();
+        }
+        else
+            convertModels();
+
+        return !failed;
+    }
+
     struct WMOLiquidHeader
     {
         int xverts, yverts, xtiles, ytiles;
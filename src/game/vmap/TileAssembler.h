@@ -98,9 +98,12 @@ namespace VMAP
             unsigned int iCurrentUniqueNameId;
             MapData mapData;
             std::set<std::string> spawnedModelFiles;
+            uint32 iThreads;                                // model files are converted by this many threads
+
+            bool convertRawFiles();
 
         public:
-            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
+            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 pThreads = 1);
             virtual ~TileAssembler();
 
             bool convertWorld2();
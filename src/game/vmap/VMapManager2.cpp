@@ -25,6 +25,10 @@
 #include "WorldModel.h"
 #include "VMapDefinitions.h"
 
+#ifndef NO_CORE_FUNCS
+#include "MemoryTracker.h"
+#endif
+
 using G3D::Vector3;
 
 namespace VMAP
@@ -171,6 +175,26 @@ namespace VMAP
         }
         return result;
     }
+
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const std::vector<Vector3>& targets, std::vector<bool>& results, bool ignoreM2Model)
+    {
+        results.assign(targets.size(), true);
+        if (!isLineOfSightCalcEnabled())
+            return;
+
+        // one tree lookup and origin conversion for the whole batch
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        Vector3 pos1 = convertPositionToInternalRep(x1, y1, z1);
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            Vector3 pos2 = convertPositionToInternalRep(targets[i].x, targets[i].y, targets[i].z);
+            if (pos1 != pos2)
+                results[i] = instanceTree->second->isInLineOfSight(pos1, pos2, ignoreM2Model);
+        }
+    }
     //=========================================================
     /**
     get the hit position and return true if we hit something
@@ -262,42 +286,96 @@ namespace VMAP
 
     //=========================================================
 
+    // the loaded model is about as large as its file
+    static size_t GetFileSize(std::string const& path)
+    {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file)
+            return 0;
+
+        fseek(file, 0, SEEK_END);
+        long const size = ftell(file);
+        fclose(file);
+        return size > 0 ? size_t(size) : 0;
+    }
+
     WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename)
     {
-        std::lock_guard<std::mutex> lock(m_vmModelMutex);
-        ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
+        std::promise<WorldModel*> loader;
+        std::shared_future<WorldModel*> future;
+        bool load = false;
+
+        // the lock only covers the lookup, a thread acquiring a model another one is still reading waits on its future
+        {
+            std::lock_guard<std::mutex> lock(m_vmModelMutex);
+            ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
+            if (model == iLoadedModelFiles.end())
+            {
+                model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel(loader.get_future().share()))).first;
+                load = true;
+            }
+            model->second.incRefCount();
+            future = model->second.getFuture();
+        }
+
+        if (load)
         {
+            std::string const path = basepath + filename + ".vmo";
             WorldModel* worldmodel = new WorldModel();
-            if (!worldmodel->readFile(basepath + filename + ".vmo"))
+            if (worldmodel->readFile(path))
+            {
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMapManager2: loading file '%s%s'.", basepath.c_str(), filename.c_str());
+                size_t const fileSize = GetFileSize(path);
+                {
+                    std::lock_guard<std::mutex> lock(m_vmModelMutex);
+                    iLoadedModelFiles.find(filename)->second.setFileSize(fileSize);
+                }
+#ifndef NO_CORE_FUNCS
+                MemoryTracker::Add(MEMORY_TAG_VMAP, fileSize);
+#endif
+            }
+            else
             {
-                ERROR_LOG("VMapManager2: could not load '%s%s.vmo'!", basepath.c_str(), filename.c_str());
+                ERROR_LOG("VMapManager2: could not load '%s'!", path.c_str());
                 delete worldmodel;
-                return nullptr;
+                worldmodel = nullptr;
             }
-
-            // insert new data
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMapManager2: loading file '%s%s'.", basepath.c_str(), filename.c_str());
-            model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
-            model->second.setModel(worldmodel);
+            loader.set_value(worldmodel);
         }
-        model->second.incRefCount();
-        return model->second.getModel();
+
+        // every waiter of a failed load drops its reference, the last one removes the entry so the file is tried again later
+        WorldModel* worldmodel = future.get();
+        if (!worldmodel)
+            releaseModelInstance(filename);
+        return worldmodel;
     }
 
     void VMapManager2::releaseModelInstance(const std::string& filename)
     {
-        ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
+        WorldModel* worldmodel;
         {
-            ERROR_LOG("VMapManager2: trying to unload non-loaded file '%s'!", filename.c_str());
-            return;
+            std::lock_guard<std::mutex> lock(m_vmModelMutex);
+            ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
+            if (model == iLoadedModelFiles.end())
+            {
+                ERROR_LOG("VMapManager2: trying to unload non-loaded file '%s'!", filename.c_str());
+                return;
+            }
+            if (model->second.decRefCount() != 0)
+                return;
+
+            worldmodel = model->second.getModel();
+#ifndef NO_CORE_FUNCS
+            if (worldmodel)
+                MemoryTracker::Remove(MEMORY_TAG_VMAP, model->second.getFileSize());
+#endif
+            iLoadedModelFiles.erase(model);
         }
-        if (model->second.decRefCount() == 0)
+
+        if (worldmodel)
         {
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMapManager2: unloading file '%s'", filename.c_str());
-            delete model->second.getModel();
-            iLoadedModelFiles.erase(model);
+            delete worldmodel;
         }
     }
     //=========================================================
@@ -23,6 +23,7 @@
 
 #include <G3D/Vector3.h>
 
+#include <future>
 #include <unordered_map>
 #include <mutex>
 
@@ -47,17 +48,22 @@ namespace VMAP
     class StaticMapTree;
     class WorldModel;
 
+    // Model file shared by all instances, the first acquirer reads it outside the model lock and the others wait on the future
     class ManagedModel
     {
         public:
-            ManagedModel() : iModel(nullptr), iRefCount(0) {}
-            void setModel(WorldModel* model) { iModel = model; }
-            WorldModel* getModel() const { return iModel; }
+            explicit ManagedModel(std::shared_future<WorldModel*> const& model) : iModel(model), iRefCount(0), iFileSize(0) {}
+            std::shared_future<WorldModel*> const& getFuture() const { return iModel; }
+            // only valid once the load finished, which every holder of a reference waited for
+            WorldModel* getModel() const { return iModel.get(); }
+            void setFileSize(size_t fileSize) { iFileSize = fileSize; }
+            size_t getFileSize() const { return iFileSize; }
             void incRefCount() { ++iRefCount; }
             int decRefCount() { return --iRefCount; }
         protected:
-            WorldModel* iModel;
+            std::shared_future<WorldModel*> iModel;         // nullptr if the file could not be read
             int iRefCount;
+            size_t iFileSize;                               // accounted as the memory of the model
     };
 
     typedef std::unordered_map<uint32, StaticMapTree*> InstanceTreeMap;
@@ -67,7 +73,7 @@ namespace VMAP
     {
         private:
             std::mutex m_vmStaticMapMutex;
-            std::mutex m_vmModelMutex;
+            std::mutex m_vmModelMutex;                      // only held for lookups and reference counts, never while reading a file
 
         protected:
             // Tree to check collision
@@ -92,6 +98,7 @@ namespace VMAP
             void unloadMap(unsigned int pMapId) override;
 
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model) override;
+            void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const std::vector<G3D::Vector3>& targets, std::vector<bool>& results, bool ignoreM2Model) override;
             /**
             fill the hit pos and return true, if an object was hit
             */
@@ -22,6 +22,14 @@
 #include "ModelInstance.h"
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VMAP_TRIANGLE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define VMAP_TRIANGLE_NEON
+#include <arm_neon.h>
+#endif
+
 using G3D::Vector3;
 using G3D::Ray;
 
@@ -85,6 +93,115 @@ namespace VMAP
         return false;
     }
 
+#if defined(VMAP_TRIANGLE_SSE2) || defined(VMAP_TRIANGLE_NEON)
+#ifdef VMAP_TRIANGLE_SSE2
+    typedef __m128 Float4;
+    inline Float4 Load4(const float* f) { return _mm_loadu_ps(f); }
+    inline Float4 Set4(float f) { return _mm_set1_ps(f); }
+    inline Float4 Add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+    inline Float4 Sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+    inline Float4 Mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+    inline Float4 Div4(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+    inline Float4 Abs4(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    inline Float4 And4(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+    inline Float4 GreaterEqual4(Float4 a, Float4 b) { return _mm_cmpge_ps(a, b); }
+    inline Float4 Greater4(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+    inline Float4 LessEqual4(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+    inline Float4 Less4(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+    inline int Mask4(Float4 a) { return _mm_movemask_ps(a); }
+    inline void Store4(float* f, Float4 a) { _mm_storeu_ps(f, a); }
+#else
+    typedef float32x4_t Float4;
+    inline Float4 Load4(const float* f) { return vld1q_f32(f); }
+    inline Float4 Set4(float f) { return vdupq_n_f32(f); }
+    inline Float4 Add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+    inline Float4 Sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+    inline Float4 Mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+    inline Float4 Div4(Float4 a, Float4 b)
+    {
+        // one reciprocal estimate and two newton steps are not exact, divide lane wise like the scalar test
+        float fa[4], fb[4];
+        vst1q_f32(fa, a);
+        vst1q_f32(fb, b);
+        for (int i = 0; i < 4; ++i)
+            fa[i] /= fb[i];
+        return vld1q_f32(fa);
+    }
+    inline Float4 Abs4(Float4 a) { return vabsq_f32(a); }
+    inline Float4 And4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    inline Float4 GreaterEqual4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+    inline Float4 Greater4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+    inline Float4 LessEqual4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+    inline Float4 Less4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+    inline int Mask4(Float4 a)
+    {
+        uint32 lanes[4];
+        vst1q_u32(lanes, vreinterpretq_u32_f32(a));
+        return (lanes[0] >> 31) | ((lanes[1] >> 31) << 1) | ((lanes[2] >> 31) << 2) | ((lanes[3] >> 31) << 3);
+    }
+    inline void Store4(float* f, Float4 a) { vst1q_f32(f, a); }
+#endif
+
+    // IntersectTriangle for up to 4 triangles at once, same tests lane wise
+    bool IntersectTriangles4(const MeshTriangle* const* tris, int count, std::vector<Vector3>::const_iterator points, const G3D::Ray& ray, float& distance)
+    {
+        static const float EPS = 1e-5f;
+
+        // gather the corners, unused lanes repeat the first triangle and are masked out
+        float c[9][4];
+        for (int i = 0; i < 4; ++i)
+        {
+            const MeshTriangle& tri = *tris[i < count ? i : 0];
+            const Vector3& p0 = points[tri.idx0];
+            const Vector3& p1 = points[tri.idx1];
+            const Vector3& p2 = points[tri.idx2];
+            c[0][i] = p0.x; c[1][i] = p0.y; c[2][i] = p0.z;
+            c[3][i] = p1.x - p0.x; c[4][i] = p1.y - p0.y; c[5][i] = p1.z - p0.z;
+            c[6][i] = p2.x - p0.x; c[7][i] = p2.y - p0.y; c[8][i] = p2.z - p0.z;
+        }
+
+        const Float4 e1x = Load4(c[3]), e1y = Load4(c[4]), e1z = Load4(c[5]);
+        const Float4 e2x = Load4(c[6]), e2y = Load4(c[7]), e2z = Load4(c[8]);
+        const Float4 dx = Set4(ray.direction().x), dy = Set4(ray.direction().y), dz = Set4(ray.direction().z);
+
+        // p = dir x e2
+        const Float4 px = Sub4(Mul4(dy, e2z), Mul4(dz, e2y));
+        const Float4 py = Sub4(Mul4(dz, e2x), Mul4(dx, e2z));
+        const Float4 pz = Sub4(Mul4(dx, e2y), Mul4(dy, e2x));
+        const Float4 a = Add4(Add4(Mul4(e1x, px), Mul4(e1y, py)), Mul4(e1z, pz));
+        Float4 valid = GreaterEqual4(Abs4(a), Set4(EPS));
+
+        const Float4 f = Div4(Set4(1.0f), a);
+        const Float4 sx = Sub4(Set4(ray.origin().x), Load4(c[0]));
+        const Float4 sy = Sub4(Set4(ray.origin().y), Load4(c[1]));
+        const Float4 sz = Sub4(Set4(ray.origin().z), Load4(c[2]));
+        const Float4 u = Mul4(f, Add4(Add4(Mul4(sx, px), Mul4(sy, py)), Mul4(sz, pz)));
+        valid = And4(valid, And4(GreaterEqual4(u, Set4(0.0f)), LessEqual4(u, Set4(1.0f))));
+
+        // q = s x e1
+        const Float4 qx = Sub4(Mul4(sy, e1z), Mul4(sz, e1y));
+        const Float4 qy = Sub4(Mul4(sz, e1x), Mul4(sx, e1z));
+        const Float4 qz = Sub4(Mul4(sx, e1y), Mul4(sy, e1x));
+        const Float4 v = Mul4(f, Add4(Add4(Mul4(dx, qx), Mul4(dy, qy)), Mul4(dz, qz)));
+        valid = And4(valid, And4(GreaterEqual4(v, Set4(0.0f)), LessEqual4(Add4(u, v), Set4(1.0f))));
+
+        const Float4 t = Mul4(f, Add4(Add4(Mul4(e2x, qx), Mul4(e2y, qy)), Mul4(e2z, qz)));
+        valid = And4(valid, And4(Greater4(t, Set4(0.0f)), Less4(t, Set4(distance))));
+
+        int mask = Mask4(valid) & ((1 << count) - 1);
+        if (!mask)
+            return false;
+
+        // the closest hit, as the sequential test would have left it
+        float times[4];
+        Store4(times, t);
+        for (int i = 0; i < count; ++i)
+            if ((mask & (1 << i)) && times[i] < distance)
+                distance = times[i];
+        return true;
+    }
+#endif
+
     class TriBoundFunc
     {
         public:
@@ -359,6 +476,33 @@ namespace VMAP
             if (result)  hit = true;
             return hit;
         }
+        // all triangles of a mesh tree leaf
+        bool operator()(const G3D::Ray& ray, const uint32* entries, int count, float& distance, bool pStopAtFirstHit)
+        {
+#if defined(VMAP_TRIANGLE_SSE2) || defined(VMAP_TRIANGLE_NEON)
+            for (int i = 0; i < count; i += 4)
+            {
+                const MeshTriangle* tris[4];
+                int const lanes = std::min(count - i, 4);
+                for (int lane = 0; lane < lanes; ++lane)
+                    tris[lane] = &triangles[entries[i + lane]];
+
+                if (IntersectTriangles4(tris, lanes, vertices, ray, distance))
+                    hit = true;
+                if (pStopAtFirstHit && hit)
+                    return true;
+            }
+#else
+            for (int i = 0; i < count; ++i)
+            {
+                if (IntersectTriangle(triangles[entries[i]], vertices, ray, distance))
+                    hit = true;
+                if (pStopAtFirstHit && hit)
+                    return true;
+            }
+#endif
+            return false;
+        }
         std::vector<Vector3>::const_iterator vertices;
         std::vector<MeshTriangle>::const_iterator triangles;
         bool hit;
@@ -369,7 +513,7 @@ namespace VMAP
         if (triangles.empty())
             return false;
         GModelRayCallback callback(triangles, vertices);
-        meshTree.intersectRay(ray, callback, distance, stopAtFirstHit, ignoreM2Model);
+        meshTree.intersectRayLeaves(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
     }
 
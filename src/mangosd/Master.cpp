@@ -45,6 +45,9 @@
 #include "Policies/Singleton.h"
 #include "Network/Listener.hpp"
 #include "Network/Socket.hpp"
+#include "Metrics/Metrics.h"
+#include "Metrics/MetricsSocket.h"
+#include "MemoryTracker.h"
 
 #include <memory>
 
@@ -115,6 +118,28 @@ int Master::Run()
         sLog.outString("Daemon PID: %u\n", pid);
     }
 
+    ///- Thread affinity of the pools, applied by each thread when it starts
+    {
+        struct { char const* pool; char const* option; } const pools[] =
+        {
+            { "world", "ThreadAffinity.World" },
+            { "map",   "ThreadAffinity.MapUpdate" },
+            { "net",   "ThreadAffinity.Network" },
+            { "sql",   "ThreadAffinity.Database" },
+        };
+
+        for (auto const& pool : pools)
+        {
+            uint32 affinity = sConfig.GetIntDefault(pool.option, 0);
+            if (affinity >= MaNGOS::Affinity_Max)
+            {
+                sLog.outError("%s = %u is not a valid thread affinity, using 0 (none)", pool.option, affinity);
+                affinity = MaNGOS::Affinity_None;
+            }
+            MaNGOS::Thread::SetPoolAffinity(pool.pool, MaNGOS::Affinity(affinity));
+        }
+    }
+
     ///- Start the databases
     if (!_StartDB())
     {
@@ -221,12 +246,24 @@ int Master::Run()
             sLog.outError("Invalid network tread workers setting in mangosd.conf. (%d) should be > 0", networkThreadWorker);
             networkThreadWorker = 1;
         }
-        MaNGOS::Listener<WorldSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), int32(sWorld.getConfig(CONFIG_UINT32_PORT_WORLD)), networkThreadWorker);
+        MaNGOS::Listener<WorldSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), int32(sWorld.getConfig(CONFIG_UINT32_PORT_WORLD)), networkThreadWorker,
+                                                sConfig.GetBoolDefault("Network.ReusePort", false));
 
         std::unique_ptr<MaNGOS::Listener<RASocket>> raListener;
         if (sConfig.GetBoolDefault("Ra.Enable", false))
             raListener.reset(new MaNGOS::Listener<RASocket>(sConfig.GetStringDefault("Ra.IP", "0.0.0.0"), sConfig.GetIntDefault("Ra.Port", 3443), 1));
 
+        std::unique_ptr<MaNGOS::Listener<MetricsSocket>> metricsListener;
+        if (sConfig.GetBoolDefault("Metrics.Enable", false))
+        {
+            Metrics::SetEnabled(true);
+            WorldDatabase.AddQueueMetrics("world");
+            CharacterDatabase.AddQueueMetrics("characters");
+            LoginDatabase.AddQueueMetrics("realmd");
+            MemoryTracker::AddMetrics();
+            metricsListener.reset(new MaNGOS::Listener<MetricsSocket>(sConfig.GetStringDefault("Metrics.IP", "127.0.0.1"), sConfig.GetIntDefault("Metrics.Port", 9110), 1));
+        }
+
         std::unique_ptr<SOAPThread> soapThread;
         if (sConfig.GetBoolDefault("SOAP.Enabled", false))
             soapThread.reset(new SOAPThread(sConfig.GetStringDefault("SOAP.IP", "127.0.0.1"), sConfig.GetIntDefault("SOAP.Port", 7878)));
@@ -329,15 +366,16 @@ bool Master::_StartDB()
     ///- Get world database info from configuration file
     std::string dbstring = sConfig.GetStringDefault("WorldDatabaseInfo");
     int nConnections = sConfig.GetIntDefault("WorldDatabaseConnections", 1);
+    int nAsyncConnections = sConfig.GetIntDefault("WorldDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Database not specified in configuration file");
         return false;
     }
-    sLog.outString("World Database total connections: %i", nConnections + 1);
+    sLog.outString("World Database total connections: %i", nConnections + std::max(nAsyncConnections, 1));
 
     ///- Initialise the world database
-    if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to world database %s", dbstring.c_str());
         return false;
@@ -352,6 +390,7 @@ bool Master::_StartDB()
 
     dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo");
     nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
+    nAsyncConnections = sConfig.GetIntDefault("CharacterDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Character Database not specified in configuration file");
@@ -360,10 +399,10 @@ bool Master::_StartDB()
         WorldDatabase.HaltDelayThread();
         return false;
     }
-    sLog.outString("Character Database total connections: %i", nConnections + 1);
+    sLog.outString("Character Database total connections: %i", nConnections + std::max(nAsyncConnections, 1));
 
     ///- Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to Character database %s", dbstring.c_str());
 
@@ -383,6 +422,7 @@ bool Master::_StartDB()
     ///- Get login database info from configuration file
     dbstring = sConfig.GetStringDefault("LoginDatabaseInfo");
     nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 1);
+    nAsyncConnections = sConfig.GetIntDefault("LoginDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Login database not specified in configuration file");
@@ -395,7 +435,7 @@ bool Master::_StartDB()
 
     ///- Initialise the login database
     sLog.outString("Login Database total connections: %i", nConnections + 1);
-    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to login database %s", dbstring.c_str());
 
@@ -27,6 +27,7 @@
 #include "Maps/MapManager.h"
 
 #include "Database/DatabaseEnv.h"
+#include "Metrics/Metrics.h"
 
 #define WORLD_SLEEP_CONST 50
 
@@ -38,6 +39,8 @@ extern int m_ServiceStatus;
 /// Heartbeat for the World
 void WorldRunnable::run()
 {
+    MaNGOS::Thread::SetupCurrentThread("world");
+
     ///- Init new SQL thread for the world database
     WorldDatabase.ThreadStart();                            // let thread do safe mySQL requests (one connection call enough)
     sWorld.InitResultQueue();
@@ -58,6 +61,17 @@ void WorldRunnable::run()
         sWorld.Update(diff);
         realPrevTime = realCurrTime;
 
+        if (Metrics::IsEnabled())
+        {
+            static Metrics::Histogram& tickTime = Metrics::GetHistogram("mangos_world_tick_duration_ms", "Time of World::Update without the sleep", Metrics::DurationBoundsMs());
+            static Metrics::Gauge& sessions = Metrics::GetGauge("mangos_sessions", "Sessions in the world", "state=\"active\"");
+            static Metrics::Gauge& queuedSessions = Metrics::GetGauge("mangos_sessions", "Sessions in the world", "state=\"queued\"");
+
+            tickTime.Observe(WorldTimer::getMSTimeDiff(realCurrTime, WorldTimer::getMSTime()));
+            sessions.Set(sWorld.GetActiveSessionCount());
+            queuedSessions.Set(sWorld.GetQueuedSessionCount());
+        }
+
         // diff (D0) include time of previous sleep (d0) + tick time (t0)
         // we want that next d1 + t1 == WORLD_SLEEP_CONST
         // we can't know next t1 and then can use (t0 + d1) == WORLD_SLEEP_CONST requirement
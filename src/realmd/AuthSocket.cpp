@@ -29,10 +29,13 @@
 #include "RealmList.h"
 #include "AuthSocket.h"
 #include "AuthCodes.h"
+#include "AuthWorkerPool.h"
 #include "SRP6/SRP6.h"
 
 #include <openssl/md5.h>
 #include <ctime>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
 //#include "Util.h" -- for commented utf8ToUpperOnlyLatin
@@ -181,12 +184,145 @@ typedef struct AuthHandler
 
 std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B, 0x21, 0x57, 0xFC, 0x37, 0x3F, 0xB3, 0x69, 0xCD, 0xD2, 0xF1 } };
 
+/// Counts the challenges of each address in fixed windows, so a flood of logons can not keep the SRP6 workers and the login database busy
+class ChallengeRateLimiter
+{
+    public:
+        ChallengeRateLimiter() : m_lastCleanup(0) {}
+
+        bool IsAllowed(std::string const& address)
+        {
+            uint32 maxChallenges = AuthSocket::GetSettings().logonRateLimitMaxChallenges;
+            if (!maxChallenges)
+                return true;
+
+            time_t interval = AuthSocket::GetSettings().logonRateLimitInterval;
+            time_t now = time(nullptr);
+
+            std::lock_guard<std::mutex> guard(m_lock);
+
+            // drop the windows that are over, the map only keeps the addresses seen recently
+            if (now - m_lastCleanup >= interval)
+            {
+                for (auto itr = m_windows.begin(); itr != m_windows.end();)
+                {
+                    if (now - itr->second.start >= interval)
+                        itr = m_windows.erase(itr);
+                    else
+                        ++itr;
+                }
+                m_lastCleanup = now;
+            }
+
+            Window& window = m_windows[address];
+            if (now - window.start >= interval)
+            {
+                window.start = now;
+                window.count = 0;
+            }
+
+            return ++window.count <= maxChallenges;
+        }
+
+    private:
+        struct Window
+        {
+            Window() : start(0), count(0) {}
+
+            time_t start;
+            uint32 count;
+        };
+
+        std::mutex m_lock;
+        std::unordered_map<std::string, Window> m_windows;
+        time_t m_lastCleanup;
+};
+
+static ChallengeRateLimiter s_challengeRateLimiter;
+
 /// Constructor - set the N and g values for SRP6
+AuthSocket::Settings AuthSocket::s_settings = AuthSocket::Settings();
+
+void AuthSocket::LoadSettings()
+{
+    s_settings.strictVersionCheck = sConfig.GetBoolDefault("StrictVersionCheck", false);
+    s_settings.wrongPassMaxCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
+    s_settings.wrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+    s_settings.wrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+    s_settings.logonRateLimitMaxChallenges = sConfig.GetIntDefault("LogonRateLimit.MaxChallenges", 30);
+    s_settings.logonRateLimitInterval = sConfig.GetIntDefault("LogonRateLimit.Interval", 60);
+}
+
 AuthSocket::AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
-    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER)
+    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER), _accountId(0), m_asyncPending(false)
 {
 }
 
+bool AuthSocket::AsyncQuery(QueryContinuation continuation, const char* format, ...)
+{
+    va_list ap;
+    char szQuery[MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return false;
+    }
+
+    if (!LoginDatabase.AsyncQuery(&AuthSocket::HandleQueryResult, shared<AuthSocket>(), continuation, szQuery))
+        return false;
+
+    m_asyncPending = true;
+    return true;
+}
+
+void AuthSocket::HandleQueryResult(QueryResult* result, std::shared_ptr<AuthSocket> socket, QueryContinuation continuation)
+{
+    // called by the main thread of realmd, the handlers run on the network thread of the socket
+    socket->GetService().post([result, socket, continuation]()
+    {
+        std::unique_ptr<QueryResult> resultGuard(result);
+        socket->m_asyncPending = false;
+
+        if (socket->IsClosed())
+            return;
+
+        if (!((*socket).*continuation)(result))
+            socket->Close();
+    });
+}
+
+bool AuthSocket::Offload(std::function<void()> work, std::function<bool()> then)
+{
+    if (!sAuthWorkerPool.IsRunning())
+    {
+        work();
+        return then();
+    }
+
+    m_asyncPending = true;
+    std::shared_ptr<AuthSocket> socket = shared<AuthSocket>();
+    sAuthWorkerPool.Enqueue([socket, work, then]()
+    {
+        work();
+
+        socket->GetService().post([socket, then]()
+        {
+            socket->m_asyncPending = false;
+
+            if (socket->IsClosed())
+                return;
+
+            if (!then())
+                socket->Close();
+        });
+    });
+    return true;
+}
+
 /// Read the packet from the client
 bool AuthSocket::ProcessIncomingData()
 {
@@ -205,9 +341,16 @@ bool AuthSocket::ProcessIncomingData()
 
     const int tableLength = sizeof(table) / sizeof(AuthHandler);
 
+    // the client waits for the answer of the command whose query is running
+    if (m_asyncPending)
+    {
+        DEBUG_LOG("[Auth] Received data while a query is running, length %u", ReadLengthRemaining());
+        return false;
+    }
+
     // the purpose of this loop is to handle multiple opcodes in the same tcp packet,
     // which presumably the client will never do, but lets support it anyway! \o/
-    while (ReadLengthRemaining() > 0)
+    while (ReadLengthRemaining() > 0 && !m_asyncPending)
     {
         const eAuthCmd cmd = static_cast<eAuthCmd>(*InPeak());
         int i;
@@ -334,8 +477,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -356,143 +497,213 @@ bool AuthSocket::_HandleLogonChallenge()
     _safelogin = _login;
     LoginDatabase.escape_string(_safelogin);
 
+    _localizationName.resize(4);
+    for (int i = 0; i < 4; ++i)
+        _localizationName[i] = ch->country[4 - i - 1];
+
+    if (!s_challengeRateLimiter.IsAllowed(m_address))
+    {
+        BASIC_LOG("[AuthChallenge] Too many logon challenges from %s, refused", m_address.c_str());
+        ByteBuffer pkt;
+        pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+        pkt << (uint8) 0x00;
+        pkt << (uint8) WOW_FAIL_DB_BUSY;
+        Write((const char*)pkt.contents(), pkt.size());
+        return true;
+    }
+
+    ///- Verify that this IP is not in the ip_banned table and get the account details with its active ban in one round trip
+    // No SQL injection possible (paste the IP address as passed by the socket, escaped user name)
+    return AsyncQuery(&AuthSocket::_ContinueLogonChallenge,
+                      "SELECT "
+                      "(SELECT COUNT(*) FROM ip_banned WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'), " //0
+                      "a.id, a.locked, a.last_ip, a.gmlevel, a.v, a.s, a.token, "  //1-7
+                      "b.banned_at, b.expires_at "                                  //8-9
+                      "FROM (SELECT 1) AS d "
+                      "LEFT JOIN account AS a ON a.username = '%s' "
+                      "LEFT JOIN account_banned AS b ON b.account_id = a.id AND b.active = 1 AND (b.expires_at > UNIX_TIMESTAMP() OR b.expires_at = b.banned_at)",
+                      m_address.c_str(), _safelogin.c_str());
+}
+
+bool AuthSocket::_ContinueLogonChallenge(QueryResult* result)
+{
+    ByteBuffer pkt;
+
     pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
     pkt << (uint8) 0x00;
 
-    ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
-            "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
+    Field* fields = result ? result->Fetch() : nullptr;
 
-    if (ip_banned_result)
+    if (!fields)
+    {
+        sLog.outError("[AuthChallenge] account query for %s failed", _login.c_str());
+        return false;
+    }
+
+    if (fields[0].GetUInt32())
     {
         pkt << (uint8)WOW_FAIL_FAIL_NOACCESS;
         BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
     }
-    else
+    else if (!fields[1].IsNULL())
     {
-        ///- Get the account details from the account table
-        // No SQL injection (escaped user name)
-        QueryResult* result = LoginDatabase.PQuery("SELECT id,locked,last_ip,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
-        if (result)
+        ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
+        bool locked = false;
+        if (fields[2].GetUInt8() == 1)                   // if ip is locked
         {
-            Field* fields = result->Fetch();
-
-            ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
-            bool locked = false;
-            if (fields[1].GetUInt8() == 1)               // if ip is locked
+            DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[3].GetString());
+            DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
+            if (strcmp(fields[3].GetString(), m_address.c_str()))
             {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[2].GetString());
-                DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
-                if (strcmp(fields[2].GetString(), m_address.c_str()))
-                {
-                    DEBUG_LOG("[AuthChallenge] Account IP differs");
-                    pkt << (uint8) WOW_FAIL_SUSPENDED;
-                    locked = true;
-                }
-                else
-                    DEBUG_LOG("[AuthChallenge] Account IP matches");
+                DEBUG_LOG("[AuthChallenge] Account IP differs");
+                pkt << (uint8) WOW_FAIL_SUSPENDED;
+                locked = true;
             }
             else
-                DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+                DEBUG_LOG("[AuthChallenge] Account IP matches");
+        }
+        else
+            DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
 
-            std::string databaseV = fields[4].GetCppString();
-            std::string databaseS = fields[5].GetCppString();
-            bool broken = false;
+        std::string databaseV = fields[5].GetCppString();
+        std::string databaseS = fields[6].GetCppString();
+        bool broken = false;
 
-            if (!srp.SetVerifier(databaseV.c_str()) || !srp.SetSalt(databaseS.c_str()))
-            {
-                pkt << (uint8)WOW_FAIL_FAIL_NOACCESS;
-                DEBUG_LOG("[AuthChallenge] Broken v/s values in database for account %s!", _login.c_str());
-                broken = true;
-            }
+        if (!srp.SetVerifier(databaseV.c_str()) || !srp.SetSalt(databaseS.c_str()))
+        {
+            pkt << (uint8)WOW_FAIL_FAIL_NOACCESS;
+            DEBUG_LOG("[AuthChallenge] Broken v/s values in database for account %s!", _login.c_str());
+            broken = true;
+        }
 
-            if (!locked && !broken)
+        if (!locked && !broken)
+        {
+            ///- If the account is banned, reject the logon attempt
+            if (!fields[8].IsNULL())
             {
-                ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
-                                         "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[1].GetUInt32());
-                if (banresult)
+                if (fields[8].GetUInt64() == fields[9].GetUInt64())
                 {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-                    {
-                        pkt << (uint8) WOW_FAIL_BANNED;
-                        BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
-                    }
-                    else
-                    {
-                        pkt << (uint8) WOW_FAIL_SUSPENDED;
-                        BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
-                    }
-
-                    delete banresult;
+                    pkt << (uint8) WOW_FAIL_BANNED;
+                    BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
                 }
                 else
                 {
-                    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
-
-                    BigNumber s;
-                    s.SetHexStr(databaseS.c_str());
-
-                    srp.CalculateHostPublicEphemeral();
-
-                    ///- Fill the response packet with the result
-                    pkt << uint8(WOW_SUCCESS);
-
-                    // B may be calculated < 32B so we force minimal length to 32B
-                    pkt.append(srp.GetHostPublicEphemeral().AsByteArray(32), 32);      // 32 bytes
-                    pkt << uint8(1);
-                    pkt.append(srp.GetGeneratorModulo().AsByteArray(), 1);
-                    pkt << uint8(32);
-                    pkt.append(srp.GetPrime().AsByteArray(32), 32);
-                    pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
-                    pkt.append(VersionChallenge.data(), VersionChallenge.size());
-                    uint8 securityFlags = 0;
-
-                    _token = fields[6].GetCppString();
-                    if (!_token.empty() && _build >= 8606) // authenticator was added in 2.4.3
-                        securityFlags = SECURITY_FLAG_AUTHENTICATOR;
-
-                    pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
-
-                    if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
-                    {
-                        pkt << uint32(0);
-                        pkt << uint64(0);
-                        pkt << uint64(0);
-                    }
-
-                    if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
-                    {
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint64(0);
-                    }
-
-                    if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
-                        pkt << uint8(1);
-
-                    uint8 secLevel = fields[3].GetUInt8();
-                    _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
-
-                    _localizationName.resize(4);
-                    for (int i = 0; i < 4; ++i)
-                        _localizationName[i] = ch->country[4 - i - 1];
-
-                    BASIC_LOG("[AuthChallenge] account %s is using '%c%c%c%c' locale (%u)", _login.c_str(), ch->country[3], ch->country[2], ch->country[1], ch->country[0], GetLocaleByName(_localizationName));
-
-                    ///- All good, await client's proof
-                    _status = STATUS_LOGON_PROOF;
+                    pkt << (uint8) WOW_FAIL_SUSPENDED;
+                    BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
                 }
             }
-            delete result;
+            else
+            {
+                DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
+
+                _token = fields[7].GetCppString();
+                _accountId = fields[1].GetUInt32();
+
+                uint8 secLevel = fields[4].GetUInt8();
+                _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+
+                BASIC_LOG("[AuthChallenge] account %s is using '%s' locale (%u)", _login.c_str(), _localizationName.c_str(), GetLocaleByName(_localizationName));
+
+                return Offload([this]() { srp.CalculateHostPublicEphemeral(); },
+                               [this, databaseS]() { return _SendLogonChallengeSuccess(databaseS); });
+            }
         }
-        else                                                // no account
-            pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
+    }
+    else                                                    // no account
+        pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
+
+    Write((const char*)pkt.contents(), pkt.size());
+    return true;
+}
+
+/// Bans the account or the IP of a failed login once its account reached WrongPass.MaxCount
+static void HandleFailedLoginResult(QueryResult* result, std::string login, std::string address)
+{
+    if (!result)
+        return;
+
+    std::unique_ptr<QueryResult> resultGuard(result);
+    Field* fields = result->Fetch();
+    uint32 failed_logins = fields[1].GetUInt32();
+
+    AuthSocket::Settings const& settings = AuthSocket::GetSettings();
+    uint32 MaxWrongPassCount = settings.wrongPassMaxCount;
+    if (failed_logins < MaxWrongPassCount)
+        return;
+
+    uint32 WrongPassBanTime = settings.wrongPassBanTime;
+    bool WrongPassBanType = settings.wrongPassBanType;
+
+    if (WrongPassBanType)
+    {
+        uint32 acc_id = fields[0].GetUInt32();
+        static SqlStatementID insAccountBan;
+        SqlStatement stmt = LoginDatabase.CreateStatement(insAccountBan, "INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active) "
+                            "VALUES (?,UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+?,'MaNGOS realmd','Failed login autoban',1)");
+        stmt.PExecute(acc_id, WrongPassBanTime);
+        BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+                  login.c_str(), WrongPassBanTime, failed_logins);
+    }
+    else
+    {
+        static SqlStatementID insIpBan;
+        SqlStatement stmt = LoginDatabase.CreateStatement(insIpBan, "INSERT INTO ip_banned VALUES (?,UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+?,'MaNGOS realmd','Failed login autoban')");
+        stmt.PExecute(address.c_str(), WrongPassBanTime);
+        BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+                  address.c_str(), WrongPassBanTime, login.c_str(), failed_logins);
+    }
+}
+
+bool AuthSocket::_SendLogonChallengeSuccess(std::string const& databaseS)
+{
+    ByteBuffer pkt;
+
+    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+    pkt << (uint8) 0x00;
+
+    BigNumber s;
+    s.SetHexStr(databaseS.c_str());
+
+    ///- Fill the response packet with the result
+    pkt << uint8(WOW_SUCCESS);
+
+    // B may be calculated < 32B so we force minimal length to 32B
+    pkt.append(srp.GetHostPublicEphemeral().AsByteArray(32), 32);      // 32 bytes
+    pkt << uint8(1);
+    pkt.append(srp.GetGeneratorModulo().AsByteArray(), 1);
+    pkt << uint8(32);
+    pkt.append(srp.GetPrime().AsByteArray(32), 32);
+    pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
+    pkt.append(VersionChallenge.data(), VersionChallenge.size());
+    uint8 securityFlags = 0;
+
+    if (!_token.empty() && _build >= 8606) // authenticator was added in 2.4.3
+        securityFlags = SECURITY_FLAG_AUTHENTICATOR;
+
+    pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
+
+    if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
+    {
+        pkt << uint32(0);
+        pkt << uint64(0);
+        pkt << uint64(0);
     }
 
+    if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
+    {
+        pkt << uint8(0);
+        pkt << uint8(0);
+        pkt << uint8(0);
+        pkt << uint8(0);
+        pkt << uint64(0);
+    }
+
+    if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
+        pkt << uint8(1);
+
+    ///- All good, await client's proof
+    _status = STATUS_LOGON_PROOF;
+
     Write((const char*)pkt.contents(), pkt.size());
     return true;
 }
@@ -524,14 +735,27 @@ bool AuthSocket::_HandleLogonProof()
     /// </ul>
 
     ///- Continue the SRP6 calculation based on data received from the client
-    if(!srp.CalculateSessionKey(lp.A, 32))
-        return false;
+    std::shared_ptr<uint8> proofState = std::make_shared<uint8>(PROOF_KEY_INVALID);
+    return Offload([this, lp, proofState]() mutable
+    {
+        if (!srp.CalculateSessionKey(lp.A, 32))
+            return;
+
+        srp.HashSessionKey();
+        srp.CalculateProof(_login);
+
+        *proofState = srp.Proof(lp.M1, 20) ? PROOF_MISMATCH : PROOF_MATCH;
+    },
+    [this, lp, proofState]() { return _FinishLogonProof(lp, *proofState); });
+}
 
-    srp.HashSessionKey();
-    srp.CalculateProof(_login);
+bool AuthSocket::_FinishLogonProof(sAuthLogonProof_C const& lp, uint8 proofState)
+{
+    if (proofState == PROOF_KEY_INVALID)
+        return false;
 
     ///- Check if SRP6 results match (password is correct), else send an error
-    if (!srp.Proof(lp.M1, 20))
+    if (proofState == PROOF_MATCH)
     {
         if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
         {
@@ -569,9 +793,14 @@ bool AuthSocket::_HandleLogonProof()
         ///- Update the sessionkey, last_ip, last login time and reset number of failed logins in the account table for this account
         // No SQL injection (escaped user name) and IP address as received by socket
         const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
-        LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', last_ip = '%s', last_login = NOW(), locale = '%u', failed_logins = 0 WHERE username = '%s'", K_hex, m_address.c_str(), GetLocaleByName(_localizationName), _safelogin.c_str());
+        static SqlStatementID updAccountLogin;
+        SqlStatement stmt = LoginDatabase.CreateStatement(updAccountLogin, "UPDATE account SET sessionkey = ?, last_ip = ?, last_login = NOW(), locale = ?, failed_logins = 0 WHERE username = ?");
+        stmt.PExecute(K_hex, m_address.c_str(), uint32(GetLocaleByName(_localizationName)), _login.c_str());
         OPENSSL_free((void*)K_hex);
 
+        // the characters may have changed since the last login
+        sRealmList.ForgetCharacterCounts(_accountId);
+
         ///- Finish SRP6 and send the final result to the client
         Sha1Hash sha;
         srp.Finalize(sha);
@@ -596,43 +825,16 @@ bool AuthSocket::_HandleLogonProof()
         }
         BASIC_LOG("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str());
 
-        uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
+        uint32 MaxWrongPassCount = s_settings.wrongPassMaxCount;
         if (MaxWrongPassCount > 0)
         {
             // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
-            LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
-
-            if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
-            {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
+            static SqlStatementID updFailedLogins;
+            SqlStatement stmt = LoginDatabase.CreateStatement(updFailedLogins, "UPDATE account SET failed_logins = failed_logins + 1 WHERE username = ?");
+            stmt.PExecute(_login.c_str());
 
-                if (failed_logins >= MaxWrongPassCount)
-                {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
-
-                    if (WrongPassBanType)
-                    {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
-                                               "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
-                                               acc_id, WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                                  _login.c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
-                    {
-                        std::string current_ip = m_address;
-                        LoginDatabase.escape_string(current_ip);
-                        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
-                                               current_ip.c_str(), WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                                  current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
-                    }
-                }
-                delete loginfail;
-            }
+            // the answer is sent already, the ban is decided without holding the socket
+            LoginDatabase.AsyncPQuery(&HandleFailedLoginResult, _login, m_address, "SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str());
         }
     }
     return true;
@@ -681,19 +883,27 @@ bool AuthSocket::_HandleReconnectChallenge()
     EndianConvert(ch->build);
     _build = ch->build;
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str());
+    if (!s_challengeRateLimiter.IsAllowed(m_address))
+    {
+        BASIC_LOG("[ReconnectChallenge] Too many logon challenges from %s, refused", m_address.c_str());
+        return false;
+    }
 
+    return AsyncQuery(&AuthSocket::_ContinueReconnectChallenge, "SELECT sessionkey, id FROM account WHERE username = '%s'", _safelogin.c_str());
+}
+
+bool AuthSocket::_ContinueReconnectChallenge(QueryResult* result)
+{
     // Stop if the account is not found
     if (!result)
     {
         sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
-        Close();
         return false;
     }
 
     Field* fields = result->Fetch();
     srp.SetStrongSessionKey(fields[0].GetString());
-    delete result;
+    _accountId = fields[1].GetUInt32();
 
     ///- All good, await client's proof
     _status = STATUS_RECON_PROOF;
@@ -754,6 +964,9 @@ bool AuthSocket::_HandleReconnectProof()
         ///- Set _status to authed!
         _status = STATUS_AUTHED;
 
+        // the characters may have changed since the last login
+        sRealmList.ForgetCharacterCounts(_accountId);
+
         return true;
     }
     sLog.outError("[ERROR] user %s tried to login, but session invalid.", _login.c_str());
@@ -770,38 +983,70 @@ bool AuthSocket::_HandleRealmList()
 
     ReadSkip(5);
 
-    ///- Get the user id (else close the connection)
-    // No SQL injection (escaped user name)
+    ///- Update realm list if need
+    sRealmList.UpdateIfNeed();
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str());
-    if (!result)
+    ///- The client refreshes the list every few seconds, the character counts of the account are cached
+    RealmList::CharacterCounts characterCounts;
+    if (sRealmList.GetCharacterCounts(_accountId, characterCounts))
     {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", _login.c_str());
-        Close();
-        return false;
+        SendRealmList(characterCounts);
+        return true;
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    delete result;
+    // No SQL injection. id of the account is read from the database.
+    return AsyncQuery(&AuthSocket::_ContinueRealmList, "SELECT realmid, numchars FROM realmcharacters WHERE acctid = '%u'", _accountId);
+}
 
-    ///- Update realm list if need
-    sRealmList.UpdateIfNeed();
+bool AuthSocket::_ContinueRealmList(QueryResult* result)
+{
+    RealmList::CharacterCounts characterCounts;
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            characterCounts[fields[0].GetUInt32()] = fields[1].GetUInt8();
+        }
+        while (result->NextRow());
+    }
 
-    ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
-    ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
+    sRealmList.SetCharacterCounts(_accountId, characterCounts);
+    SendRealmList(characterCounts);
+    return true;
+}
 
-    ByteBuffer hdr;
-    hdr << (uint8) CMD_REALM_LIST;
-    hdr << (uint16)pkt.size();
-    hdr.append(pkt);
+void AuthSocket::SendRealmList(RealmList::CharacterCounts const& characterCounts)
+{
+    std::lock_guard<std::mutex> guard(sRealmList.GetRealmsLock());
 
-    Write((const char*)hdr.contents(), hdr.size());
-    return true;
+    ///- The packet is built once per client build and security level until the realms change
+    RealmListPacket* packet = sRealmList.FindRealmListPacket(_build, _accountSecurityLevel);
+    if (!packet)
+    {
+        packet = &sRealmList.AddRealmListPacket(_build, _accountSecurityLevel);
+        LoadRealmlist(*packet);
+    }
+
+    ///- Only the character counts of the account are filled into the copy
+    ByteBuffer pkt(packet->data);
+    for (auto const& position : packet->characterCountPositions)
+    {
+        auto countItr = characterCounts.find(position.first);
+        if (countItr != characterCounts.end())
+            pkt.put<uint8>(position.second, countItr->second);
+    }
+
+    Write((const char*)pkt.contents(), pkt.size());
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
+/// Builds the realm list packet of the client build and security level with zero character counts, the realms lock must be held
+void AuthSocket::LoadRealmlist(RealmListPacket& packet)
 {
+    ByteBuffer& pkt = packet.data;
+    pkt << (uint8) CMD_REALM_LIST;
+    pkt << (uint16) 0;                                      // size, set below
+
     switch (_build)
     {
         case 5875:                                          // 1.12.1
@@ -813,18 +1058,6 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -852,7 +1085,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
                 pkt << name;                                // name
                 pkt << i.second.address;                   // address
                 pkt << float(i.second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
+                packet.characterCountPositions.push_back(std::make_pair(i.second.m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // characters of the account
                 pkt << uint8(i.second.timezone);           // realm category
                 pkt << uint8(0x00);                         // unk, may be realm number/id?
             }
@@ -874,18 +1108,6 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -910,7 +1132,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
                 pkt << i.first;                            // name
                 pkt << i.second.address;                   // address
                 pkt << float(i.second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
+                packet.characterCountPositions.push_back(std::make_pair(i.second.m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // characters of the account
                 pkt << uint8(i.second.timezone);           // realm category (Cfg_Categories.dbc)
                 pkt << uint8(0x2C);                         // unk, may be realm number/id?
 
@@ -927,6 +1150,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
             break;
         }
     }
+
+    pkt.put<uint16>(1, uint16(pkt.size() - 3));
 }
 
 /// Resume patch transfer
@@ -990,7 +1215,7 @@ int32 AuthSocket::generateToken(char const* b32key)
 
 bool AuthSocket::VerifyVersion(uint8 const* a, int32 aLength, uint8 const* versionProof, bool isReconnect)
 {
-    if (!sConfig.GetBoolDefault("StrictVersionCheck", false))
+    if (!s_settings.strictVersionCheck)
         return true;
 
     std::array<uint8, 20> zeros = { {} };
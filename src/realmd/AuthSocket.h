@@ -28,15 +28,20 @@
 #include "Auth/Sha1.h"
 #include "SRP6/SRP6.h"
 #include "ByteBuffer.h"
+#include "RealmList.h"
 
 #include "Network/Socket.hpp"
 
 #include <boost/asio.hpp>
 
 #include <functional>
+#include <memory>
 
 #define HMAC_RES_SIZE 20
 
+class QueryResult;
+struct AUTH_LOGON_PROOF_C;
+
 class AuthSocket : public MaNGOS::Socket
 {
     public:
@@ -44,8 +49,21 @@ class AuthSocket : public MaNGOS::Socket
 
         AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
 
+        /// realmd.conf values used by the logon handling, read once at startup
+        struct Settings
+        {
+            bool strictVersionCheck;
+            uint32 wrongPassMaxCount;
+            uint32 wrongPassBanTime;
+            bool wrongPassBanType;                          // ban the IP instead of the account
+            uint32 logonRateLimitMaxChallenges;
+            uint32 logonRateLimitInterval;
+        };
+        static void LoadSettings();
+        static Settings const& GetSettings() { return s_settings; }
+
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer& pkt, uint32 acctid);
+        void LoadRealmlist(RealmListPacket& packet);
         int32 generateToken(char const* b32key);
 
         bool VerifyVersion(uint8 const* a, int32 aLength, uint8 const* versionProof, bool isReconnect);
@@ -61,6 +79,31 @@ class AuthSocket : public MaNGOS::Socket
         bool _HandleXferAccept();
 
     private:
+        typedef bool (AuthSocket::*QueryContinuation)(QueryResult* result);
+
+        /// Queues the query on the async login database connection, the continuation gets the result on the network thread of the socket.
+        /// No data of the client is handled meanwhile.
+        bool AsyncQuery(QueryContinuation continuation, const char* format, ...) ATTR_PRINTF(3, 4);
+        static void HandleQueryResult(QueryResult* result, std::shared_ptr<AuthSocket> socket, QueryContinuation continuation);
+
+        /// Runs the work on the SRP6 worker pool, then the continuation on the network thread of the socket.
+        /// Without worker threads both run directly.
+        bool Offload(std::function<void()> work, std::function<bool()> then);
+
+        enum ProofState
+        {
+            PROOF_KEY_INVALID,
+            PROOF_MISMATCH,
+            PROOF_MATCH
+        };
+
+        bool _ContinueLogonChallenge(QueryResult* result);
+        bool _SendLogonChallengeSuccess(std::string const& databaseS);
+        bool _FinishLogonProof(AUTH_LOGON_PROOF_C const& lp, uint8 proofState);
+        bool _ContinueReconnectChallenge(QueryResult* result);
+        bool _ContinueRealmList(QueryResult* result);
+        void SendRealmList(RealmList::CharacterCounts const& characterCounts);
+
         enum eStatus
         {
             STATUS_CHALLENGE,
@@ -86,6 +129,11 @@ class AuthSocket : public MaNGOS::Socket
         std::string _localizationName;
         uint16 _build;
         AccountTypes _accountSecurityLevel;
+        uint32 _accountId;
+
+        bool m_asyncPending;
+
+        static Settings s_settings;
 
         virtual bool ProcessIncomingData() override;
 };
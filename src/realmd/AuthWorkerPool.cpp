@@ -0,0 +1,79 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "AuthWorkerPool.h"
+
+AuthWorkerPool& AuthWorkerPool::Instance()
+{
+    static AuthWorkerPool pool;
+    return pool;
+}
+
+void AuthWorkerPool::Start(uint32 threads)
+{
+    for (uint32 i = 0; i < threads; ++i)
+        m_threads.emplace_back(&AuthWorkerPool::Run, this);
+}
+
+void AuthWorkerPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        m_stopping = true;
+    }
+    m_queueCondition.notify_all();
+
+    for (std::thread& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+}
+
+void AuthWorkerPool::Enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        m_jobs.push(std::move(job));
+    }
+    m_queueCondition.notify_one();
+}
+
+void AuthWorkerPool::Run()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_queueLock);
+            while (m_jobs.empty() && !m_stopping)
+                m_queueCondition.wait(lock);
+
+            // stopping drains the queue first
+            if (m_jobs.empty())
+                return;
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop();
+        }
+
+        job();
+    }
+}
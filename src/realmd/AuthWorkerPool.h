@@ -0,0 +1,65 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _AUTHWORKERPOOL_H
+#define _AUTHWORKERPOOL_H
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/// Threads running the SRP6 big number math of the logons, so the network threads keep serving the other sockets
+class AuthWorkerPool
+{
+    public:
+        static AuthWorkerPool& Instance();
+
+        AuthWorkerPool() : m_stopping(false) {}
+
+        void Start(uint32 threads);
+        /// Runs the queued jobs and joins the threads
+        void Stop();
+
+        /// Without threads the jobs run in the caller
+        bool IsRunning() const { return !m_threads.empty(); }
+
+        void Enqueue(std::function<void()> job);
+
+    private:
+        void Run();
+
+        std::mutex m_queueLock;
+        std::condition_variable m_queueCondition;
+        std::queue<std::function<void()>> m_jobs;
+        std::vector<std::thread> m_threads;
+        bool m_stopping;
+};
+
+#define sAuthWorkerPool AuthWorkerPool::Instance()
+
+#endif
+/// @}
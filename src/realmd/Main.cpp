@@ -27,11 +27,14 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "AuthSocket.h"
+#include "AuthWorkerPool.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "revision_sql.h"
 #include "Util.h"
 #include "Network/Listener.hpp"
+#include "Metrics/Metrics.h"
+#include "Metrics/MetricsSocket.h"
 
 #include <openssl/opensslv.h>
 #include <openssl/crypto.h>
@@ -40,6 +43,7 @@
 #include <boost/version.hpp>
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <chrono>
 #include <thread>
@@ -208,6 +212,7 @@ int main(int argc, char* argv[])
 
     ///- Get the list of realms for the server
     sRealmList.Initialize(sConfig.GetIntDefault("RealmsStateUpdateDelay", 20));
+    sRealmList.SetCharacterCountCacheTime(sConfig.GetIntDefault("RealmCharacterCountCacheTime", 60));
     if (sRealmList.size() == 0)
     {
         sLog.outError("No valid realms specified.");
@@ -222,8 +227,25 @@ int main(int argc, char* argv[])
     LoginDatabase.Execute("DELETE FROM ip_banned WHERE expires_at<=UNIX_TIMESTAMP() AND expires_at<>banned_at");
     LoginDatabase.CommitTransaction();
 
-    // FIXME - more intelligent selection of thread count is needed here.  config option?
-    MaNGOS::Listener<AuthSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), sConfig.GetIntDefault("RealmServerPort", DEFAULT_REALMSERVER_PORT), 1);
+    AuthSocket::LoadSettings();
+    sAuthWorkerPool.Start(sConfig.GetIntDefault("SRP6.WorkerThreads", 2));
+
+    int networkThreads = sConfig.GetIntDefault("Network.Threads", 1);
+    if (networkThreads <= 0)
+    {
+        sLog.outError("Network.Threads must be greater than 0, using 1");
+        networkThreads = 1;
+    }
+
+    MaNGOS::Listener<AuthSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), sConfig.GetIntDefault("RealmServerPort", DEFAULT_REALMSERVER_PORT), networkThreads);
+
+    std::unique_ptr<MaNGOS::Listener<MetricsSocket>> metricsListener;
+    if (sConfig.GetBoolDefault("Metrics.Enable", false))
+    {
+        Metrics::SetEnabled(true);
+        LoginDatabase.AddQueueMetrics("realmd");
+        metricsListener.reset(new MaNGOS::Listener<MetricsSocket>(sConfig.GetStringDefault("Metrics.IP", "127.0.0.1"), sConfig.GetIntDefault("Metrics.Port", 9111), 1));
+    }
 
     ///- Catch termination signals
     HookSignals();
@@ -274,8 +296,8 @@ int main(int argc, char* argv[])
     // server has started up successfully => enable async DB requests
     LoginDatabase.AllowAsyncTransactions();
 
-    // maximum counter for next ping
-    auto const numLoops = sConfig.GetIntDefault("MaxPingTime", 30) * MINUTE * 10;
+    // maximum counter for next ping, the loop runs every 10 ms to hand the async query results back to the sockets
+    auto const numLoops = sConfig.GetIntDefault("MaxPingTime", 30) * MINUTE * 100;
     uint32 loopCounter = 0;
 
 #ifndef _WIN32
@@ -290,13 +312,19 @@ int main(int argc, char* argv[])
             DETAIL_LOG("Ping MySQL to keep connection alive");
             LoginDatabase.Ping();
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        LoginDatabase.ProcessResultQueue();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
 #ifdef _WIN32
         if (m_ServiceStatus == 0) stopEvent = true;
         while (m_ServiceStatus == 2) Sleep(1000);
 #endif
     }
 
+    ///- Finish the running SRP6 jobs while the network threads still take their results
+    sAuthWorkerPool.Stop();
+
+    ///- The metrics collector reads the delay queues
+    metricsListener.reset();
 
     ///- Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
@@ -75,7 +75,7 @@ RealmBuildInfo const* FindBuildInfo(uint16 _build)
     return nullptr;
 }
 
-RealmList::RealmList() : m_UpdateInterval(0), m_NextUpdateTime(time(nullptr))
+RealmList::RealmList() : m_UpdateInterval(0), m_NextUpdateTime(time(nullptr)), m_characterCountsCleanupSize(1024), m_characterCountCacheTime(0)
 {
 }
 
@@ -94,10 +94,10 @@ void RealmList::Initialize(uint32 updateInterval)
     UpdateRealms(true);
 }
 
-void RealmList::UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds)
+void RealmList::UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds)
 {
     ///- Create new if not exist or update existed
-    Realm& realm = m_realms[name];
+    Realm& realm = realms[name];
 
     realm.m_ID       = ID;
     realm.icon       = icon;
@@ -133,21 +133,101 @@ void RealmList::UpdateRealm(uint32 ID, const std::string& name, const std::strin
     realm.address   = ss.str();
 }
 
-void RealmList::UpdateIfNeed()
+bool RealmList::GetCharacterCounts(uint32 accountId, CharacterCounts& counts)
+{
+    std::lock_guard<std::mutex> guard(m_characterCountsLock);
+
+    auto itr = m_characterCounts.find(accountId);
+    if (itr == m_characterCounts.end() || itr->second.expireTime <= time(nullptr))
+        return false;
+
+    counts = itr->second.counts;
+    return true;
+}
+
+void RealmList::SetCharacterCounts(uint32 accountId, CharacterCounts const& counts)
 {
-    // maybe disabled or updated recently
-    if (!m_UpdateInterval || m_NextUpdateTime > time(nullptr))
+    if (!m_characterCountCacheTime)
         return;
 
-    m_NextUpdateTime = time(nullptr) + m_UpdateInterval;
+    time_t now = time(nullptr);
 
-    // Clears Realm list
-    m_realms.clear();
+    std::lock_guard<std::mutex> guard(m_characterCountsLock);
+
+    // drop the expired accounts once the cache doubled since the last cleanup
+    if (m_characterCounts.size() >= m_characterCountsCleanupSize)
+    {
+        for (auto itr = m_characterCounts.begin(); itr != m_characterCounts.end();)
+        {
+            if (itr->second.expireTime <= now)
+                itr = m_characterCounts.erase(itr);
+            else
+                ++itr;
+        }
+        m_characterCountsCleanupSize = std::max(size_t(1024), m_characterCounts.size() * 2);
+    }
+
+    CachedCharacterCounts& cached = m_characterCounts[accountId];
+    cached.expireTime = now + m_characterCountCacheTime;
+    cached.counts = counts;
+}
+
+void RealmList::ForgetCharacterCounts(uint32 accountId)
+{
+    std::lock_guard<std::mutex> guard(m_characterCountsLock);
+    m_characterCounts.erase(accountId);
+}
+
+RealmListPacket* RealmList::FindRealmListPacket(uint16 build, AccountTypes security)
+{
+    auto itr = m_realmListPackets.find(std::make_pair(build, security));
+    return itr != m_realmListPackets.end() ? &itr->second : nullptr;
+}
+
+RealmListPacket& RealmList::AddRealmListPacket(uint16 build, AccountTypes security)
+{
+    RealmListPacket& packet = m_realmListPackets[std::make_pair(build, security)];
+    packet.data.clear();
+    packet.characterCountPositions.clear();
+    return packet;
+}
+
+void RealmList::UpdateIfNeed()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_realmsLock);
+
+        // maybe disabled or updated recently
+        if (!m_UpdateInterval || m_NextUpdateTime > time(nullptr))
+            return;
+
+        m_NextUpdateTime = time(nullptr) + m_UpdateInterval;
+    }
 
     // Get the content of the realmlist table in the database
     UpdateRealms(false);
 }
 
+static bool IsSameRealm(Realm const& realm, Realm const& other)
+{
+    return realm.m_ID == other.m_ID && realm.address == other.address && realm.icon == other.icon &&
+           realm.realmflags == other.realmflags && realm.timezone == other.timezone &&
+           realm.allowedSecurityLevel == other.allowedSecurityLevel && realm.populationLevel == other.populationLevel &&
+           realm.realmbuilds == other.realmbuilds;
+}
+
+static bool IsSameRealmMap(RealmList::RealmMap const& realms, RealmList::RealmMap const& other)
+{
+    if (realms.size() != other.size())
+        return false;
+
+    for (auto itr = realms.begin(), otherItr = other.begin(); itr != realms.end(); ++itr, ++otherItr)
+        if (itr->first != otherItr->first || !IsSameRealm(itr->second, otherItr->second))
+            return false;
+
+    return true;
+}
+
 void RealmList::UpdateRealms(bool init)
 {
     DETAIL_LOG("Updating Realm List...");
@@ -155,6 +235,8 @@ void RealmList::UpdateRealms(bool init)
     ////                                               0   1     2        3     4     5           6         7                     8           9
     QueryResult* result = LoginDatabase.Query("SELECT id, name, address, port, icon, realmflags, timezone, allowedSecurityLevel, population, realmbuilds FROM realmlist WHERE (realmflags & 1) = 0 ORDER BY name");
 
+    RealmMap realms;
+
     ///- Circle through results and add them to the realm map
     if (result)
     {
@@ -173,7 +255,7 @@ void RealmList::UpdateRealms(bool init)
                 realmflags &= (REALM_FLAG_OFFLINE | REALM_FLAG_NEW_PLAYERS | REALM_FLAG_RECOMMENDED | REALM_FLAG_SPECIFYBUILD);
             }
 
-            UpdateRealm(
+            UpdateRealm(realms,
                 Id, name, fields[2].GetCppString(), fields[3].GetUInt32(),
                 fields[4].GetUInt8(), RealmFlags(realmflags), fields[6].GetUInt8(),
                 (allowedSecurityLevel <= SEC_ADMINISTRATOR ? AccountTypes(allowedSecurityLevel) : SEC_ADMINISTRATOR),
@@ -185,4 +267,12 @@ void RealmList::UpdateRealms(bool init)
         while (result->NextRow());
         delete result;
     }
+
+    ///- The realms are read aside, the cached packets stay valid as long as mangosd did not change any realm
+    std::lock_guard<std::mutex> guard(m_realmsLock);
+    if (IsSameRealmMap(realms, m_realms))
+        return;
+
+    m_realms.swap(realms);
+    m_realmListPackets.clear();
 }
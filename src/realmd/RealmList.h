@@ -24,7 +24,13 @@
 #define _REALMLIST_H
 
 #include "Common.h"
+#include "ByteBuffer.h"
 #include <array>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 struct RealmBuildInfo
 {
@@ -55,6 +61,13 @@ struct Realm
     RealmBuildInfo realmBuildInfo;                          // build info for show version in list
 };
 
+/// Realm list packet of one client build and security level, only the character counts of the account differ between clients
+struct RealmListPacket
+{
+    ByteBuffer data;                                        // complete CMD_REALM_LIST packet with zero character counts
+    std::vector<std::pair<uint32, size_t>> characterCountPositions;     // realm id, position of its character count in data
+};
+
 /// Storage object for the list of realms on the server
 class RealmList
 {
@@ -70,16 +83,44 @@ class RealmList
 
         void UpdateIfNeed();
 
+        typedef std::unordered_map<uint32, uint8> CharacterCounts;     // by realm id
+
+        /// Character counts of the account cached for cacheTime seconds, logins and reconnects drop them
+        void SetCharacterCountCacheTime(uint32 cacheTime) { m_characterCountCacheTime = cacheTime; }
+        bool GetCharacterCounts(uint32 accountId, CharacterCounts& counts);
+        void SetCharacterCounts(uint32 accountId, CharacterCounts const& counts);
+        void ForgetCharacterCounts(uint32 accountId);
+
+        /// Held while iterating the realms or using the packet cache, UpdateIfNeed may replace the map from another network thread
+        std::mutex& GetRealmsLock() { return m_realmsLock; }
+
+        /// Cached packets are dropped when the realms change, the realms lock must be held
+        RealmListPacket* FindRealmListPacket(uint16 build, AccountTypes security);
+        RealmListPacket& AddRealmListPacket(uint16 build, AccountTypes security);
+
         RealmMap::const_iterator begin() const { return m_realms.begin(); }
         RealmMap::const_iterator end() const { return m_realms.end(); }
         uint32 size() const { return m_realms.size(); }
     private:
         void UpdateRealms(bool init);
-        void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
+        static void UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
     private:
         RealmMap m_realms;                                  ///< Internal map of realms
+        std::mutex m_realmsLock;
+        std::map<std::pair<uint16, AccountTypes>, RealmListPacket> m_realmListPackets;
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
+
+        struct CachedCharacterCounts
+        {
+            time_t expireTime;
+            CharacterCounts counts;
+        };
+
+        std::mutex m_characterCountsLock;                   ///< the network threads share the cache
+        std::unordered_map<uint32, CachedCharacterCounts> m_characterCounts;
+        size_t m_characterCountsCleanupSize;                ///< size at which expired accounts are dropped
+        uint32 m_characterCountCacheTime;
 };
 
 #define sRealmList RealmList::Instance()
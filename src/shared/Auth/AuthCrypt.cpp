@@ -55,6 +55,32 @@ void AuthCrypt::EncryptSend(uint8* data, size_t len)
     }
 }
 
+void AuthCrypt::EncryptSendHeaders(uint8* buffer, std::vector<size_t> const& positions)
+{
+    if (!_initialized) return;
+
+    // the cipher state stays in locals for the whole batch
+    uint8 const* key = _key.data();
+    size_t const keySize = _key.size();
+    size_t i = _send_i % keySize;
+    uint8 j = _send_j;
+
+    for (size_t position : positions)
+    {
+        uint8* data = buffer + position;
+        for (size_t t = 0; t < CRYPTED_SEND_LEN; ++t)
+        {
+            j = (data[t] ^ key[i]) + j;
+            data[t] = j;
+            if (++i == keySize)
+                i = 0;
+        }
+    }
+
+    _send_i = uint8(i);
+    _send_j = j;
+}
+
 void AuthCrypt::Init(BigNumber* K)
 {
     uint8* key = new uint8[SHA_DIGEST_LENGTH];
@@ -33,6 +33,10 @@ class AuthCrypt
 
         void DecryptRecv(uint8*, size_t);
         void EncryptSend(uint8*, size_t);
+        /// Encrypts the server headers at the positions in buffer in one pass, in the order they are sent
+        void EncryptSendHeaders(uint8* buffer, std::vector<size_t> const& positions);
+
+        bool IsInitialized() const { return _initialized; }
 
     private:
         std::vector<uint8> _key;
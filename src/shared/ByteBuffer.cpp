@@ -19,6 +19,97 @@
 #include "ByteBuffer.h"
 #include "Log.h"
 
+std::atomic<bool> ByteBuffer::s_trackAllocations(false);
+ByteBuffer::PoolStats ByteBuffer::s_poolStats = {};
+
+namespace
+{
+    // storage capacities kept by the pool, and how many buffers of each class a thread holds at most
+    const size_t PoolClassSize[]  = { 0x100, 0x400, 0x1000, 0x4000, 0x10000 };
+    const size_t PoolClassLimit[] = { 64,    64,    32,     16,     8       };
+    const size_t PoolClassCount = sizeof(PoolClassSize) / sizeof(PoolClassSize[0]);
+
+    // stays valid after the pool of this thread is destroyed, buffers freed during thread exit bypass it
+    thread_local bool t_poolDestroyed = false;
+
+    struct ByteBufferPool
+    {
+        std::vector<std::vector<uint8>> free[PoolClassCount];
+
+        ByteBufferPool()
+        {
+            for (size_t i = 0; i < PoolClassCount; ++i)
+                free[i].reserve(PoolClassLimit[i]);
+        }
+
+        ~ByteBufferPool() { t_poolDestroyed = true; }
+    };
+
+    ByteBufferPool* GetPool()
+    {
+        if (t_poolDestroyed)
+            return nullptr;
+
+        thread_local ByteBufferPool pool;
+        return &pool;
+    }
+}
+
+void ByteBuffer::AcquireStorage(size_t res)
+{
+    if (!res)
+        return;
+
+    size_t idx = 0;
+    while (idx < PoolClassCount && PoolClassSize[idx] < res)
+        ++idx;
+
+    // larger than any class, not pooled
+    if (idx == PoolClassCount)
+    {
+        _storage.reserve(res);
+        return;
+    }
+
+    ByteBufferPool* pool = GetPool();
+    if (pool && !pool->free[idx].empty())
+    {
+        _storage.swap(pool->free[idx].back());
+        pool->free[idx].pop_back();
+
+        if (IsTrackingAllocations())
+            s_poolStats.hits.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // round up so the buffer can go back to this class when released
+    _storage.reserve(PoolClassSize[idx]);
+
+    if (IsTrackingAllocations())
+        s_poolStats.misses.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ByteBuffer::ReleaseStorage()
+{
+    const size_t capacity = _storage.capacity();
+    if (capacity < PoolClassSize[0] || capacity > PoolClassSize[PoolClassCount - 1] * 4)
+        return;
+
+    ByteBufferPool* pool = GetPool();
+    if (!pool)
+        return;
+
+    size_t idx = PoolClassCount - 1;
+    while (PoolClassSize[idx] > capacity)
+        --idx;
+
+    if (pool->free[idx].size() >= PoolClassLimit[idx])
+        return;
+
+    _storage.clear();
+    pool->free[idx].push_back(std::move(_storage));
+}
+
 void ByteBufferException::PrintPosError() const
 {
     sLog.outError("Attempted to %s in ByteBuffer (pos: " SIZEFMTD " size: " SIZEFMTD ") value with size: " SIZEFMTD,
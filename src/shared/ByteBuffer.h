@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "Utilities/ByteConverter.h"
 #include <utf8.h>
+#include <atomic>
 
 class ByteBufferException
 {
@@ -51,20 +52,39 @@ class ByteBuffer
     public:
         const static size_t DEFAULT_SIZE = 0x1000;
 
+        // storage pool usage, only counted while allocation tracking is enabled
+        struct PoolStats
+        {
+            std::atomic<uint64> hits;                       // storage taken from the thread pool
+            std::atomic<uint64> misses;                     // storage allocated from the heap
+        };
+
         // constructor
         ByteBuffer(): _rpos(0), _wpos(0)
         {
-            _storage.reserve(DEFAULT_SIZE);
+            AcquireStorage(DEFAULT_SIZE);
         }
 
         // constructor
         ByteBuffer(size_t res): _rpos(0), _wpos(0)
         {
-            _storage.reserve(res);
+            AcquireStorage(res);
         }
 
         // copy constructor
-        ByteBuffer(const ByteBuffer& buf): _rpos(buf._rpos), _wpos(buf._wpos), _storage(buf._storage) { }
+        ByteBuffer(const ByteBuffer& buf): _rpos(buf._rpos), _wpos(buf._wpos)
+        {
+            AcquireStorage(buf._storage.size());
+            _storage = buf._storage;
+        }
+
+        ByteBuffer& operator=(const ByteBuffer& buf) = default;
+
+        ~ByteBuffer() { ReleaseStorage(); }
+
+        static void SetAllocationTracking(bool enable) { s_trackAllocations.store(enable, std::memory_order_relaxed); }
+        static bool IsTrackingAllocations() { return s_trackAllocations.load(std::memory_order_relaxed); }
+        static PoolStats& GetPoolStats() { return s_poolStats; }
 
         void clear()
         {
@@ -429,6 +449,14 @@ class ByteBuffer
     protected:
         size_t _rpos, _wpos;
         std::vector<uint8> _storage;
+
+    private:
+        // storage comes from a size classed thread local pool and goes back to the pool of the destroying thread
+        void AcquireStorage(size_t res);
+        void ReleaseStorage();
+
+        static std::atomic<bool> s_trackAllocations;
+        static PoolStats s_poolStats;
 };
 
 template <typename T>
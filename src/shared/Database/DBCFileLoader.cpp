@@ -25,6 +25,7 @@
 DBCFileLoader::DBCFileLoader()
 {
     data = nullptr;
+    stringTable = nullptr;
     fieldsOffset = nullptr;
 }
 
@@ -32,6 +33,9 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
 {
     uint32 header;
     delete[] data;
+    delete[] stringTable;
+    data = nullptr;
+    stringTable = nullptr;
 
     FILE* f = fopen(filename, "rb");
     if (!f)
@@ -95,10 +99,12 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
             fieldsOffset[i] += 4;
     }
 
-    data = new unsigned char[recordSize * recordCount + stringSize];
-    stringTable = data + recordSize * recordCount;
+    // the string block is read into its own buffer, so AutoProduceStrings can hand it over without a copy
+    data = new unsigned char[recordSize * recordCount];
+    stringTable = new unsigned char[stringSize];
 
-    if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
+    if ((recordSize * recordCount && fread(data, recordSize * recordCount, 1, f) != 1) ||
+        (stringSize && fread(stringTable, stringSize, 1, f) != 1))
     {
         fclose(f);
         return false;
@@ -111,6 +117,7 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
 DBCFileLoader::~DBCFileLoader()
 {
     delete[] data;
+    delete[] stringTable;
     delete[] fieldsOffset;
 }
 
@@ -261,13 +268,12 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
 
 char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
 {
-    if (strlen(format) != fieldCount)
+    if (strlen(format) != fieldCount || !stringTable)
         return nullptr;
 
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
-
+    char* stringPool = reinterpret_cast<char*>(stringTable);
     uint32 offset = 0;
+    uint32 filledSlots = 0;
 
     for (uint32 y = 0; y < recordCount; ++y)
     {
@@ -291,8 +297,8 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
                     char** slot = (char**)(&dataTable[offset]);
                     if (!*slot || !** slot)
                     {
-                        const char* st = getRecord(y).getString(x);
-                        *slot = stringPool + (st - (const char*)stringTable);
+                        *slot = const_cast<char*>(getRecord(y).getString(x));
+                        ++filledSlots;
                     }
                     offset += sizeof(char*);
                     break;
@@ -311,5 +317,11 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
         }
     }
 
+    // a locale file that filled no empty string keeps its block here, freed with the loader
+    if (!filledSlots)
+        return nullptr;
+
+    // the caller owns the string block from now on
+    stringTable = nullptr;
     return stringPool;
 }
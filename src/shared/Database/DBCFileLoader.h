@@ -91,9 +91,12 @@ class DBCFileLoader
 
         uint32 GetNumRows() const { return recordCount;}
         uint32 GetCols() const { return fieldCount; }
+        uint32 GetStringSize() const { return stringSize; }
         uint32 GetOffset(size_t id) const { return (fieldsOffset != nullptr && id < fieldCount) ? fieldsOffset[id] : 0; }
         bool IsLoaded() const { return data != nullptr; }
         char* AutoProduceData(const char* format, uint32& records, char**& indexTable);
+        // points the empty string fields of dataTable into the string block of the file and passes its ownership,
+        // returns nullptr and keeps the block when no field was filled
         char* AutoProduceStrings(const char* format, char* dataTable);
         static uint32 GetFormatRecordSize(const char* format, int32* index_pos = nullptr);
     private:
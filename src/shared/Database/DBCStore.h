@@ -20,13 +20,14 @@
 #define DBCSTORE_H
 
 #include "DBCFileLoader.h"
+#include "MemoryTracker.h"
 
 template<class T>
 class DBCStorage
 {
         typedef std::list<char*> StringPoolList;
     public:
-        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_dataTable(nullptr) { }
+        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_dataTable(nullptr), m_memoryUsage(0) { }
         ~DBCStorage() { Clear(); }
 
         T const* LookupEntry(uint32 id) const { return (id >= nCount) ? nullptr : indexTable[id]; }
@@ -46,11 +47,19 @@ class DBCStorage
             // load raw non-string data
             m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
 
-            // load strings from dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
-
             // error in dbc file at loading if nullptr
-            return indexTable != nullptr;
+            if (!indexTable)
+                return false;
+
+            // records point into the string block of the file, the storage keeps it
+            m_memoryUsage = nCount * sizeof(T*) + dbc.GetNumRows() * DBCFileLoader::GetFormatRecordSize(fmt);
+            if (char* stringPool = dbc.AutoProduceStrings(fmt, (char*)m_dataTable))
+            {
+                m_stringPoolList.push_back(stringPool);
+                m_memoryUsage += dbc.GetStringSize();
+            }
+            MemoryTracker::Add(MEMORY_TAG_DBC, m_memoryUsage);
+            return true;
         }
 
         bool LoadStringsFrom(char const* fn)
@@ -64,8 +73,13 @@ class DBCStorage
             if (!dbc.Load(fn, fmt))
                 return false;
 
-            // load strings from another locale dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            // load strings from another locale dbc data, its block is only kept when it filled an empty string
+            if (char* stringPool = dbc.AutoProduceStrings(fmt, (char*)m_dataTable))
+            {
+                m_stringPoolList.push_back(stringPool);
+                m_memoryUsage += dbc.GetStringSize();
+                MemoryTracker::Grow(MEMORY_TAG_DBC, dbc.GetStringSize());
+            }
 
             return true;
         }
@@ -86,6 +100,9 @@ class DBCStorage
                 m_stringPoolList.pop_front();
             }
             nCount = 0;
+
+            MemoryTracker::Remove(MEMORY_TAG_DBC, m_memoryUsage);
+            m_memoryUsage = 0;
         }
 
         void EraseEntry(uint32 id) { assert(id < nCount && "To be erased entry must be in bounds!") ; indexTable[id] = nullptr; }
@@ -98,6 +115,7 @@ class DBCStorage
         T** indexTable;
         T* m_dataTable;
         StringPoolList m_stringPoolList;
+        size_t m_memoryUsage;                               // accounted as MEMORY_TAG_DBC
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include "DatabaseEnv.h"
 #include "Config/Config.h"
 #include "Database/SqlOperations.h"
+#include "Metrics/Metrics.h"
 
 #include <ctime>
 #include <iostream>
@@ -65,6 +66,13 @@ SqlPreparedStatement* SqlConnection::GetStmt(uint32 nIndex)
         // prepare statement
         if (!pStmt->prepare())
         {
+            // the connection was lost meanwhile, the statement gets prepared again after the reconnect
+            if (!IsHealthy())
+            {
+                delete pStmt;
+                return nullptr;
+            }
+
             MANGOS_ASSERT(false && "Unable to prepare SQL statement");
             return nullptr;
         }
@@ -83,21 +91,40 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
     if (nIndex == -1)
         return false;
 
+    // a lost connection can't prepare the statement
+    if (!IsHealthy())
+        return false;
+
     // get prepared statement object
     SqlPreparedStatement* pStmt = GetStmt(nIndex);
+    if (!pStmt)
+        return false;
     // bind parameters
     pStmt->bind(id);
     // execute statement
     return pStmt->execute();
 }
 
+void SqlConnection::QueryBatch(std::vector<const char*> const& queries, std::vector<QueryResult*>& results)
+{
+    results.assign(queries.size(), nullptr);
+    for (size_t i = 0; i < queries.size(); ++i)
+        if (queries[i])
+            results[i] = Query(queries[i]);
+}
+
 //////////////////////////////////////////////////////////////////////////
 Database::~Database()
 {
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+namespace
+{
+    thread_local uint32 t_asyncKey = 0;
+}
+
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -139,6 +166,26 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     if (!m_pAsyncConn->Initialize(infoString))
         return false;
 
+    // setup async connection pool size, each extra connection gets its own executer thread
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
+        m_nAsyncConnPoolSize = MIN_CONNECTION_POOL_SIZE;
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+        m_nAsyncConnPoolSize = MAX_CONNECTION_POOL_SIZE;
+    else
+        m_nAsyncConnPoolSize = nAsyncConns;
+
+    for (int i = 1; i < m_nAsyncConnPoolSize; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pExtraAsyncConnections.push_back(pConn);
+    }
+
     m_pResultQueue = new SqlResultQueue;
 
     InitDelayThread();
@@ -155,36 +202,109 @@ void Database::StopServer()
     m_pResultQueue = nullptr;
     m_pAsyncConn = nullptr;
 
+    for (auto& m_pExtraAsyncConnection : m_pExtraAsyncConnections)
+        delete m_pExtraAsyncConnection;
+
+    m_pExtraAsyncConnections.clear();
+
     for (auto& m_pQueryConnection : m_pQueryConnections)
         delete m_pQueryConnection;
 
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    return new SqlDelayThread(this, conn);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new MaNGOS::Thread(m_threadBody);
+    // New delay threads for delay execute, one per async connection
+    m_threadBodies.push_back(CreateDelayThread(m_pAsyncConn));
+    for (auto& m_pExtraAsyncConnection : m_pExtraAsyncConnections)
+        m_threadBodies.push_back(CreateDelayThread(m_pExtraAsyncConnection));
+
+    for (auto& threadBody : m_threadBodies)
+        m_delayThreads.push_back(new MaNGOS::Thread(threadBody));  // will delete the body at thread delete
+
+    m_healthMonitor = new SqlHealthMonitor(this);
+    m_healthMonitorThread = new MaNGOS::Thread(m_healthMonitor);
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (m_threadBodies.empty() || m_delayThreads.empty()) return;
+
+    // no reconnects while the connections get flushed and destroyed
+    if (m_healthMonitorThread)
+    {
+        m_healthMonitor->Stop();
+        m_healthMonitorThread->wait();
+        delete m_healthMonitorThread;
+        m_healthMonitorThread = nullptr;
+        m_healthMonitor = nullptr;
+    }
+
+    for (auto& threadBody : m_threadBodies)
+        threadBody->Stop();                                 // Stop event
+
+    for (auto& delayThread : m_delayThreads)
+    {
+        delayThread->wait();                                // Wait for flush to DB
+        delete delayThread;                                 // This also deletes the thread body
+    }
+
+    m_delayThreads.clear();
+    m_threadBodies.clear();
+}
+
+uint32 Database::SetAsyncKey(uint32 key)
+{
+    uint32 const previous = t_asyncKey;
+    t_asyncKey = key;
+    return previous;
+}
+
+uint32 Database::GetAsyncKey()
+{
+    return t_asyncKey;
+}
+
+SqlDelayThread* Database::GetDelayThread() const
+{
+    return m_threadBodies[t_asyncKey % m_threadBodies.size()];
+}
+
+size_t Database::GetDelayQueueSize() const
+{
+    size_t size = 0;
+    for (SqlDelayThread* threadBody : m_threadBodies)
+        size += threadBody->GetQueueSize();
+    return size;
+}
+
+void Database::WaitForDelayThreads() const
+{
+    std::vector<std::future<void>> barriers;
+    for (SqlDelayThread* threadBody : m_threadBodies)
+    {
+        std::promise<void> done;
+        barriers.push_back(done.get_future());
+        threadBody->Delay(new SqlBarrierRequest(std::move(done)));
+    }
+
+    for (std::future<void> const& barrier : barriers)
+        barrier.wait();
+}
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = nullptr;
-    m_threadBody = nullptr;
+void Database::AddQueueMetrics(char const* name)
+{
+    Metrics::Gauge& queue = Metrics::GetGauge("mangos_db_async_queue", "Async requests waiting for a delay thread", std::string("database=\"") + name + "\"");
+    Metrics::AddCollector([this, &queue]() { queue.Set(int64(GetDelayQueueSize())); });
 }
 
 void Database::ThreadStart()
@@ -222,23 +342,54 @@ SqlConnection* Database::getQueryConnection()
     else
         nCount = ++m_nQueryCounter;
 
+    // skip lost connections and those busy with a streamed result, if none is left the request fails at once on the picked one
+    for (int i = 0; i < m_nQueryConnPoolSize; ++i)
+    {
+        SqlConnection* conn = m_pQueryConnections[(nCount + i) % m_nQueryConnPoolSize];
+        if (conn->IsHealthy() && !conn->IsStreaming())
+            return conn;
+    }
+
     return m_pQueryConnections[nCount % m_nQueryConnPoolSize];
 }
 
 void Database::Ping()
 {
-    const char* sql = "SELECT 1";
-
+    auto ping = [](SqlConnection* conn)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
-        delete guard->Query(sql);
-    }
+        SqlConnection::TryLock guard(conn);
+        if (guard.IsLocked() && guard->IsHealthy())
+            guard->Ping();
+    };
+
+    ping(m_pAsyncConn);
+
+    for (auto& m_pExtraAsyncConnection : m_pExtraAsyncConnections)
+        ping(m_pExtraAsyncConnection);
 
     for (int i = 0; i < m_nQueryConnPoolSize; ++i)
+        ping(m_pQueryConnections[i]);
+}
+
+void Database::ReconnectLostConnections()
+{
+    auto reconnect = [](SqlConnection* conn)
     {
-        SqlConnection::Lock guard(m_pQueryConnections[i]);
-        delete guard->Query(sql);
-    }
+        if (conn->IsHealthy())
+            return;
+
+        SqlConnection::Lock guard(conn);
+        if (!guard->IsHealthy() && guard->Reconnect())
+            sLog.outString("Database connection restored");
+    };
+
+    reconnect(m_pAsyncConn);
+
+    for (auto& m_pExtraAsyncConnection : m_pExtraAsyncConnections)
+        reconnect(m_pExtraAsyncConnection);
+
+    for (int i = 0; i < m_nQueryConnPoolSize; ++i)
+        reconnect(m_pQueryConnections[i]);
 }
 
 bool Database::PExecuteLog(const char* format, ...)
@@ -302,6 +453,25 @@ QueryResult* Database::PQuery(const char* format, ...)
     return Query(szQuery);
 }
 
+QueryResult* Database::PQueryBinary(const char* format, ...)
+{
+    if (!format) return nullptr;
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return nullptr;
+    }
+
+    return QueryBinary(szQuery);
+}
+
 QueryNamedResult* Database::PQueryNamed(const char* format, ...)
 {
     if (!format) return nullptr;
@@ -339,7 +509,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        GetDelayThread()->Delay(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -408,7 +578,7 @@ bool Database::CommitTransaction()
         return CommitTransactionDirect();
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_currentTransaction.release());
+    GetDelayThread()->Delay(m_currentTransaction.release());
     return true;
 }
 
@@ -563,7 +733,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        GetDelayThread()->Delay(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
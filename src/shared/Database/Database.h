@@ -48,10 +48,27 @@ class SqlConnection
         // public methods for making queries
         virtual QueryResult* Query(const char* sql) = 0;
         virtual QueryNamedResult* QueryNamed(const char* sql) = 0;
+        // query with typed binary result fields, engines without a binary protocol use the text one
+        virtual QueryResult* QueryBinary(const char* sql) { return Query(sql); }
+        // result reading the rows from the server while they are processed, the connection stays locked until it is deleted.
+        // the row count is unknown (0), engines without streaming buffer the whole result
+        virtual QueryResult* QueryStream(const char* sql) { return Query(sql); }
+        // run several queries, results[i] belongs to queries[i] (nullptr entries are skipped)
+        // engines able to send them in one round trip override this
+        virtual void QueryBatch(std::vector<const char*> const& queries, std::vector<QueryResult*>& results);
 
         // public methods for making requests
         virtual bool Execute(const char* sql) = 0;
 
+        // false after the server connection was lost, requests then fail at once until the health monitor reconnected it
+        bool IsHealthy() const { return m_healthy; }
+        // an unfinished streamed result occupies the connection
+        bool IsStreaming() const { return m_streaming; }
+        // checks the server can be reached, engines able to detect a lost connection mark it unhealthy
+        virtual void Ping() { delete Query("SELECT 1"); }
+        // replaces a lost server connection, the caller holds the connection lock
+        virtual bool Reconnect() { return false; }
+
         // escape string generation
         virtual unsigned long escape_string(char* to, const char* from, unsigned long length) { strncpy(to, from, length); return length; }
 
@@ -77,11 +94,26 @@ class SqlConnection
                 SqlConnection* const m_pConn;
         };
 
+        // lock only taken if the connection is idle
+        class TryLock
+        {
+            public:
+                TryLock(SqlConnection* conn) : m_pConn(conn), m_locked(conn->m_mutex.try_lock()) {}
+                ~TryLock() { if (m_locked) m_pConn->m_mutex.unlock(); }
+
+                bool IsLocked() const { return m_locked; }
+                SqlConnection* operator->() const { return m_pConn; }
+
+            private:
+                SqlConnection* const m_pConn;
+                bool const m_locked;
+        };
+
         // get DB object
         Database& DB() const { return m_db; }
 
     protected:
-        SqlConnection(Database& db) : m_db(db) {}
+        SqlConnection(Database& db) : m_db(db), m_healthy(true), m_streaming(false) {}
 
         virtual SqlPreparedStatement* CreateStatement(const std::string& fmt);
         // allocate prepared statement and return statement ID
@@ -92,9 +124,13 @@ class SqlConnection
         // free prepared statements objects
         void FreePreparedStatements();
 
-    private:
+        std::atomic<bool> m_healthy;
+        std::atomic<bool> m_streaming;
+
         std::recursive_mutex m_mutex;
 
+    private:
+
         typedef std::vector<SqlPreparedStatement* > StmtHolder;
         StmtHolder m_holder;
 };
@@ -104,7 +140,7 @@ class Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
         // start worker thread for async DB request execution
         virtual void InitDelayThread();
         // stop worker thread
@@ -123,8 +159,27 @@ class Database
             return guard->QueryNamed(sql);
         }
 
+        // binary protocol query, faster for large results with many numeric columns (table loading)
+        inline QueryResult* QueryBinary(const char* sql)
+        {
+            SqlConnection::Lock guard(getQueryConnection());
+            return guard->QueryBinary(sql);
+        }
+
+        // rows are read while they are processed instead of buffering the whole result, for huge tables at startup.
+        // GetRowCount() is 0 and no other sync query of this thread may use the connection before the result is deleted
+        inline QueryResult* QueryStream(const char* sql)
+        {
+            SqlConnection::Lock guard(getQueryConnection());
+            return guard->QueryStream(sql);
+        }
+
+        // amount of connections used by the synchronous queries
+        int GetQueryConnectionCount() const { return m_nQueryConnPoolSize; }
+
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
         QueryNamedResult* PQueryNamed(const char* format, ...) ATTR_PRINTF(2, 3);
+        QueryResult* PQueryBinary(const char* format, ...) ATTR_PRINTF(2, 3);
 
         bool DirectExecute(const char* sql) const
         {
@@ -188,6 +243,8 @@ class Database
         bool RollbackTransaction();
         // for sync transaction execution
         bool CommitTransactionDirect();
+        // true while the calling thread collects a transaction
+        bool IsInTransaction() const { return m_currentTransaction.get() != nullptr; }
 
         // PREPARED STATEMENT API
 
@@ -212,8 +269,24 @@ class Database
         bool CheckRequiredField(char const* table_name, char const* required_name);
         uint32 GetPingIntervall() const { return m_pingIntervallms; }
 
-        // function to ping database connections
+        // function to ping database connections, connections busy with a request are alive and skipped
         void Ping();
+        // called by the health monitor thread
+        void ReconnectLostConnections();
+
+        // async requests queued while a key is set on the calling thread go to the async connection picked by the key,
+        // so the requests of one key keep their order while other keys run in parallel.  returns the previous key
+        static uint32 SetAsyncKey(uint32 key);
+        static uint32 GetAsyncKey();
+
+        // async requests waiting in the queues of all delay threads, lets bulk writers pace themselves
+        size_t GetDelayQueueSize() const;
+
+        // blocks until every async request queued so far by any thread is executed
+        void WaitForDelayThreads() const;
+
+        // exports GetDelayQueueSize() on every metrics scrape, the endpoint must be gone before the delay threads are halted
+        void AddQueueMetrics(char const* name);
 
         // set this to allow async transactions
         // you should call it explicitly after your server successfully started up
@@ -222,8 +295,8 @@ class Database
 
     protected:
         Database() :
-            m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
-            m_threadBody(nullptr), m_delayThread(nullptr), m_allowAsyncTransactions(false),
+            m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_nAsyncConnPoolSize(1), m_pResultQueue(nullptr), m_healthMonitor(nullptr), m_healthMonitorThread(nullptr),
+            m_allowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -234,7 +307,7 @@ class Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn);
 
         // per-thread based storage for SqlTransaction object initialization - no locking is required
         boost::thread_specific_ptr<SqlTransaction> m_currentTransaction;
@@ -245,6 +318,8 @@ class Database
         SqlConnection* getQueryConnection();
         // for now return one single connection for async requests
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
+        // delay thread for the async key of the calling thread, unkeyed requests all go to the first one
+        SqlDelayThread* GetDelayThread() const;
 
         friend class SqlStatement;
         // PREPARED STATEMENT API
@@ -260,12 +335,17 @@ class Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
+        // connection for direct transactions and the first async executer
         SqlConnection* m_pAsyncConn;
+        // connections of the other async executers
+        SqlConnectionContainer m_pExtraAsyncConnections;
+        int m_nAsyncConnPoolSize;
 
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
+        std::vector<SqlDelayThread*> m_threadBodies;        ///< Delay sql executers (owned by m_delayThreads), one per async connection
+        std::vector<MaNGOS::Thread*> m_delayThreads;        ///< Executer threads
+        SqlHealthMonitor* m_healthMonitor;                  ///< Pings and reconnects the connections (owned by m_healthMonitorThread)
+        MaNGOS::Thread* m_healthMonitorThread;
 
         std::atomic<bool> m_allowAsyncTransactions;         ///< flag which specifies if async transactions are enabled
 
@@ -286,4 +366,18 @@ class Database
         std::string m_logsDir;
         uint32 m_pingIntervallms;
 };
+
+// Routes the async requests queued by the current thread to one async connection while in scope
+class SqlAsyncKeyScope
+{
+    public:
+        explicit SqlAsyncKeyScope(uint32 key) : m_previousKey(Database::SetAsyncKey(key)) {}
+        ~SqlAsyncKeyScope() { Database::SetAsyncKey(m_previousKey); }
+
+        SqlAsyncKeyScope(SqlAsyncKeyScope const&) = delete;
+        SqlAsyncKeyScope& operator=(SqlAsyncKeyScope const&) = delete;
+
+    private:
+        uint32 m_previousKey;
+};
 #endif
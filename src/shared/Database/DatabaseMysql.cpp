@@ -24,6 +24,7 @@
 #include "Threading.h"
 #include "DatabaseEnv.h"
 #include "Timer.h"
+#include "Database/SqlStatistics.h"
 
 size_t DatabaseMysql::db_count = 0;
 
@@ -132,10 +133,10 @@ bool MySQLConnection::Initialize(const char* infoString)
     }
 #endif
 
-    mMysql = mysql_real_connect(mysqlInit, host.c_str(), user.c_str(),
-                                password.c_str(), database.c_str(), port, unix_socket, 0);
+    MYSQL* mysql = mysql_real_connect(mysqlInit, host.c_str(), user.c_str(),
+                                      password.c_str(), database.c_str(), port, unix_socket, 0);
 
-    if (!mMysql)
+    if (!mysql)
     {
         sLog.outError("Could not connect to MySQL database at %s: %s\n",
                       host.c_str(), mysql_error(mysqlInit));
@@ -143,6 +144,13 @@ bool MySQLConnection::Initialize(const char* infoString)
         return false;
     }
 
+    {
+        std::lock_guard<std::mutex> guard(m_handleMutex);
+        mMysql = mysql;
+    }
+    m_infoString = infoString;
+    m_healthy = true;
+
     DETAIL_LOG("Connected to MySQL database %s@%s:%s/%s", user.c_str(), host.c_str(), port_or_socket.c_str(), database.c_str());
     sLog.outString("MySQL client library: %s", mysql_get_client_info());
     sLog.outString("MySQL server ver: %s ", mysql_get_server_info(mMysql));
@@ -174,15 +182,24 @@ bool MySQLConnection::Initialize(const char* infoString)
 
 bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
 {
-    if (!mMysql)
+    if (!mMysql || !m_healthy)
         return false;
 
+    // the server sends the rows of a streamed result until it is deleted, nothing else can run on the connection meanwhile
+    if (m_streaming)
+    {
+        sLog.outError("SQL: query on a connection busy with a streamed result: %s", sql);
+        return false;
+    }
+
     uint32 _s = WorldTimer::getMSTime();
+    SqlStatistics::Timer statTimer;
 
     if (mysql_query(mMysql, sql))
     {
         sLog.outErrorDb("SQL: %s", sql);
         sLog.outErrorDb("query ERROR: %s", mysql_error(mMysql));
+        CheckConnectionLost(mysql_errno(mMysql));
         return false;
     }
     DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
@@ -191,6 +208,8 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
     *pRowCount = mysql_affected_rows(mMysql);
     *pFieldCount = mysql_field_count(mMysql);
 
+    SqlStatistics::RecordQuery(sql, statTimer, *pResult ? *pRowCount : 0);
+
     if (!*pResult)
         return false;
 
@@ -240,21 +259,174 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
     return new QueryNamedResult(queryResult, names);
 }
 
+QueryResult* MySQLConnection::QueryBinary(const char* sql)
+{
+    if (!mMysql || !m_healthy)
+        return nullptr;
+
+    uint32 _s = WorldTimer::getMSTime();
+    SqlStatistics::Timer statTimer;
+
+    MYSQL_STMT* stmt = mysql_stmt_init(mMysql);
+    if (!stmt)
+    {
+        sLog.outError("SQL: mysql_stmt_init() failed ");
+        return nullptr;
+    }
+
+    my_bool updateMaxLength = 1;
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql)) ||
+            mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength) ||
+            mysql_stmt_execute(stmt) ||
+            mysql_stmt_store_result(stmt))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(stmt));
+        CheckConnectionLost(mysql_stmt_errno(stmt));
+        mysql_stmt_close(stmt);
+        return nullptr;
+    }
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+
+    // statements without result set (no SELECT) and empty results are reported like Query() does
+    MYSQL_RES* metadata = mysql_stmt_result_metadata(stmt);
+    uint64 rowCount = mysql_stmt_num_rows(stmt);
+    SqlStatistics::RecordQuery(sql, statTimer, metadata ? rowCount : 0);
+    if (!metadata || !rowCount)
+    {
+        if (metadata)
+            mysql_free_result(metadata);
+        mysql_stmt_free_result(stmt);
+        mysql_stmt_close(stmt);
+        return nullptr;
+    }
+
+    QueryResultMysqlBinary* queryResult = new QueryResultMysqlBinary(stmt, metadata, rowCount, mysql_stmt_field_count(stmt));
+
+    queryResult->NextRow();
+    return queryResult;
+}
+
+QueryResult* MySQLConnection::QueryStream(const char* sql)
+{
+    if (!mMysql || !m_healthy)
+        return nullptr;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    if (mysql_query(mMysql, sql))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_error(mMysql));
+        CheckConnectionLost(mysql_errno(mMysql));
+        return nullptr;
+    }
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL (streamed): %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+
+    MYSQL_RES* result = mysql_use_result(mMysql);
+    if (!result)
+        return nullptr;
+
+    QueryResultMysqlStream* queryResult = new QueryResultMysqlStream(*this, mMysql, result, mysql_fetch_fields(result), mysql_num_fields(result));
+
+    // empty results are reported like Query() does
+    if (!queryResult->NextRow())
+    {
+        delete queryResult;
+        return nullptr;
+    }
+
+    return queryResult;
+}
+
+void MySQLConnection::QueryBatch(std::vector<const char*> const& queries, std::vector<QueryResult*>& results)
+{
+    std::vector<size_t> indexes;
+    std::string sql;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        if (!queries[i])
+            continue;
+
+        if (!indexes.empty())
+            sql += ';';
+        sql += queries[i];
+        indexes.push_back(i);
+    }
+
+    // multi statements are only enabled for the batch, plain requests keep rejecting stacked queries
+    if (!mMysql || !m_healthy || indexes.size() < 2 || mysql_set_server_option(mMysql, MYSQL_OPTION_MULTI_STATEMENTS_ON))
+    {
+        SqlConnection::QueryBatch(queries, results);
+        return;
+    }
+
+    results.assign(queries.size(), nullptr);
+
+    uint32 _s = WorldTimer::getMSTime();
+    SqlStatistics::Timer statTimer;
+    uint64 batchRows = 0;
+
+    size_t done = 0;
+    int status = mysql_real_query(mMysql, sql.c_str(), sql.size());
+    if (!status)
+    {
+        do
+        {
+            if (MYSQL_RES* result = mysql_store_result(mMysql))
+            {
+                uint64 rowCount = mysql_num_rows(result);
+                batchRows += rowCount;
+                if (rowCount)
+                {
+                    QueryResultMysql* queryResult = new QueryResultMysql(result, mysql_fetch_fields(result), rowCount, mysql_num_fields(result));
+                    queryResult->NextRow();
+                    results[indexes[done]] = queryResult;
+                }
+                else
+                    mysql_free_result(result);
+            }
+            ++done;
+        }
+        while ((status = mysql_next_result(mMysql)) == 0);
+    }
+
+    // status -1 means all results were read, else the statement at 'done' failed and the server skipped the rest
+    if (status > 0)
+    {
+        sLog.outErrorDb("SQL: %s", queries[indexes[done]]);
+        sLog.outErrorDb("query ERROR: %s", mysql_error(mMysql));
+        CheckConnectionLost(mysql_errno(mMysql));
+        ++done;
+    }
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL batch of " SIZEFMTD " queries", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), indexes.size());
+    // the server does not time the single statements of a batch, the round trip is accounted as a whole
+    SqlStatistics::RecordStatement(SQL_STATISTICS_QUERY_BATCH, statTimer, batchRows);
+
+    mysql_set_server_option(mMysql, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+
+    for (; done < indexes.size(); ++done)
+        results[indexes[done]] = Query(queries[indexes[done]]);
+}
+
 bool MySQLConnection::Execute(const char* sql)
 {
-    if (!mMysql)
+    if (!mMysql || !m_healthy)
         return false;
 
     {
         uint32 _s = WorldTimer::getMSTime();
+        SqlStatistics::Timer statTimer;
 
         if (mysql_query(mMysql, sql))
         {
             sLog.outErrorDb("SQL: %s", sql);
             sLog.outErrorDb("SQL ERROR: %s", mysql_error(mMysql));
+            CheckConnectionLost(mysql_errno(mMysql));
             return false;
         }
         DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+        SqlStatistics::RecordQuery(sql, statTimer, mysql_affected_rows(mMysql));
         // end guarded block
     }
 
@@ -263,10 +435,14 @@ bool MySQLConnection::Execute(const char* sql)
 
 bool MySQLConnection::_TransactionCmd(const char* sql)
 {
+    if (!m_healthy)
+        return false;
+
     if (mysql_query(mMysql, sql))
     {
         sLog.outError("SQL: %s", sql);
         sLog.outError("SQL ERROR: %s", mysql_error(mMysql));
+        CheckConnectionLost(mysql_errno(mMysql));
         return false;
     }
     DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "SQL: %s", sql);
@@ -288,8 +464,47 @@ bool MySQLConnection::RollbackTransaction()
     return _TransactionCmd("ROLLBACK");
 }
 
+void MySQLConnection::Ping()
+{
+    if (mysql_ping(mMysql))
+        CheckConnectionLost(mysql_errno(mMysql));
+}
+
+bool MySQLConnection::Reconnect()
+{
+    // the lost handle still serves escape_string until Initialize replaced it
+    MYSQL* lostMysql = mMysql;
+
+    FreePreparedStatements();
+
+    std::string infoString = m_infoString;
+    if (!Initialize(infoString.c_str()))
+        return false;
+
+    mysql_close(lostMysql);
+    return true;
+}
+
+void MySQLConnection::CheckConnectionLost(unsigned int errNo)
+{
+    switch (errNo)
+    {
+        case CR_SERVER_GONE_ERROR:
+        case CR_SERVER_LOST:
+        case CR_CONNECTION_ERROR:
+        case CR_CONN_HOST_ERROR:
+            if (m_healthy.exchange(false))
+                sLog.outError("Database connection lost, requests on it fail until it is reconnected");
+            break;
+        default:
+            break;
+    }
+}
+
 unsigned long MySQLConnection::escape_string(char* to, const char* from, unsigned long length)
 {
+    std::lock_guard<std::mutex> guard(m_handleMutex);
+
     if (!mMysql || !to || !from || !length)
         return 0;
 
@@ -335,6 +550,7 @@ bool MySqlPreparedStatement::prepare()
     {
         sLog.outError("SQL: mysql_stmt_prepare() failed for '%s'", m_szFmt.c_str());
         sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        static_cast<MySQLConnection&>(m_pConn).CheckConnectionLost(mysql_stmt_errno(m_stmt));
         return false;
     }
 
@@ -452,13 +668,18 @@ bool MySqlPreparedStatement::execute()
     if (!isPrepared())
         return false;
 
+    SqlStatistics::Timer statTimer;
+
     if (mysql_stmt_execute(m_stmt))
     {
         sLog.outError("SQL: cannot execute '%s'", m_szFmt.c_str());
         sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        static_cast<MySQLConnection&>(m_pConn).CheckConnectionLost(mysql_stmt_errno(m_stmt));
         return false;
     }
 
+    SqlStatistics::RecordStatement(m_szFmt, statTimer, mysql_stmt_affected_rows(m_stmt));
+
     return true;
 }
 
@@ -27,10 +27,14 @@
 
 #ifdef _WIN32
 #include <mysql/mysql.h>
+#include <mysql/errmsg.h>
 #else
 #include <mysql.h>
+#include <errmsg.h>
 #endif
 
+#include <mutex>
+
 // MySQL prepared statement class
 class MySqlPreparedStatement : public SqlPreparedStatement
 {
@@ -75,8 +79,16 @@ class MySQLConnection : public SqlConnection
 
         QueryResult* Query(const char* sql) override;
         QueryNamedResult* QueryNamed(const char* sql) override;
+        QueryResult* QueryBinary(const char* sql) override;
+        QueryResult* QueryStream(const char* sql) override;
+        void QueryBatch(std::vector<const char*> const& queries, std::vector<QueryResult*>& results) override;
         bool Execute(const char* sql) override;
 
+        void Ping() override;
+        bool Reconnect() override;
+        // marks the connection unhealthy if the error means the server connection is gone
+        void CheckConnectionLost(unsigned int errNo);
+
         unsigned long escape_string(char* to, const char* from, unsigned long length);
 
         bool BeginTransaction() override;
@@ -87,10 +99,18 @@ class MySQLConnection : public SqlConnection
         SqlPreparedStatement* CreateStatement(const std::string& fmt) override;
 
     private:
+        friend class QueryResultMysqlStream;
+
+        // a streamed result keeps the connection locked for its lifetime
+        void BeginStream() { m_mutex.lock(); m_streaming = true; }
+        void EndStream() { m_streaming = false; m_mutex.unlock(); }
+
         bool _TransactionCmd(const char* sql);
         bool _Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount);
 
         MYSQL* mMysql;
+        std::mutex m_handleMutex;                           ///< escape_string runs without the connection lock, guards replacing mMysql
+        std::string m_infoString;
 };
 
 class DatabaseMysql : public Database
@@ -173,11 +173,82 @@ QueryNamedResult* PostgreSQLConnection::QueryNamed(const char* sql)
     return new QueryNamedResult(queryResult, names);
 }
 
+void PostgreSQLConnection::QueryBatch(std::vector<const char*> const& queries, std::vector<QueryResult*>& results)
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    if (!mPGconn || m_pipelined || !PQenterPipelineMode(mPGconn))
+    {
+        SqlConnection::QueryBatch(queries, results);
+        return;
+    }
+
+    results.assign(queries.size(), nullptr);
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    std::vector<size_t> indexes;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        if (!queries[i])
+            continue;
+
+        if (!PQsendQueryParams(mPGconn, queries[i], 0, nullptr, nullptr, nullptr, nullptr, 0))
+        {
+            sLog.outErrorDb("SQL: %s", queries[i]);
+            sLog.outErrorDb("SQL %s", PQerrorMessage(mPGconn));
+            break;
+        }
+        indexes.push_back(i);
+    }
+    PQpipelineSync(mPGconn);
+
+    for (size_t index : indexes)
+    {
+        // one result per query, closed by a null result
+        PGresult* res = PQgetResult(mPGconn);
+        if (!res)
+            break;
+
+        ExecStatusType status = PQresultStatus(res);
+        if (status == PGRES_TUPLES_OK && PQntuples(res))
+        {
+            QueryResultPostgre* queryResult = new QueryResultPostgre(res, PQntuples(res), PQnfields(res));
+            queryResult->NextRow();
+            results[index] = queryResult;
+        }
+        else
+        {
+            if (status != PGRES_TUPLES_OK && status != PGRES_PIPELINE_ABORTED)
+            {
+                sLog.outErrorDb("SQL : %s", queries[index]);
+                sLog.outErrorDb("SQL %s", PQresultErrorMessage(res));
+            }
+            PQclear(res);
+        }
+
+        while ((res = PQgetResult(mPGconn)))
+            PQclear(res);
+    }
+
+    _EndPipeline();
+
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL batch of " SIZEFMTD " queries", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), indexes.size());
+#else
+    SqlConnection::QueryBatch(queries, results);
+#endif
+}
+
 bool PostgreSQLConnection::Execute(const char* sql)
 {
     if (!mPGconn)
         return false;
 
+    if (m_pipelined)
+    {
+        _SendPipelined(sql);
+        return m_pipelineOk;
+    }
+
     uint32 _s = WorldTimer::getMSTime();
 
     PGresult* res = PQexec(mPGconn, sql);
@@ -215,18 +286,141 @@ bool PostgreSQLConnection::_TransactionCmd(const char* sql)
     return true;
 }
 
+void PostgreSQLConnection::_SendPipelined(const char* sql)
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    if (!m_pipelineOk)
+        return;
+
+    if (!PQsendQueryParams(mPGconn, sql, 0, nullptr, nullptr, nullptr, nullptr, 0))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("SQL %s", PQerrorMessage(mPGconn));
+        m_pipelineOk = false;
+        return;
+    }
+
+    m_pipelineSql.push_back(sql);
+
+    if (m_pipelineSql.size() - m_pipelineRead >= PIPELINE_DRAIN_AT)
+    {
+        PQsendFlushRequest(mPGconn);
+        PQflush(mPGconn);
+        _ReadPipelineResults();
+    }
+#endif
+}
+
+void PostgreSQLConnection::_ReadPipelineResults()
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    for (; m_pipelineRead < m_pipelineSql.size(); ++m_pipelineRead)
+    {
+        PGresult* res = PQgetResult(mPGconn);
+        if (!res)
+        {
+            sLog.outErrorDb("SQL %s", PQerrorMessage(mPGconn));
+            m_pipelineOk = false;
+            m_pipelineRead = m_pipelineSql.size();
+            return;
+        }
+
+        switch (PQresultStatus(res))
+        {
+            case PGRES_COMMAND_OK:
+            case PGRES_TUPLES_OK:
+                break;
+            case PGRES_PIPELINE_ABORTED:                    // skipped after an earlier error
+                m_pipelineOk = false;
+                break;
+            default:
+                sLog.outErrorDb("SQL: %s", m_pipelineSql[m_pipelineRead].c_str());
+                sLog.outErrorDb("SQL %s", PQresultErrorMessage(res));
+                m_pipelineOk = false;
+                break;
+        }
+        PQclear(res);
+
+        // the results of a request end with a null result
+        while ((res = PQgetResult(mPGconn)))
+            PQclear(res);
+    }
+#endif
+}
+
+bool PostgreSQLConnection::_EndPipeline()
+{
+#ifdef LIBPQ_HAS_PIPELINING
+    // the sync point result
+    while (PGresult* res = PQgetResult(mPGconn))
+    {
+        bool sync = PQresultStatus(res) == PGRES_PIPELINE_SYNC;
+        PQclear(res);
+        if (sync)
+            break;
+    }
+
+    m_pipelined = false;
+    m_pipelineSql.clear();
+    m_pipelineRead = 0;
+    return PQexitPipelineMode(mPGconn) != 0;
+#else
+    return true;
+#endif
+}
+
 bool PostgreSQLConnection::BeginTransaction()
 {
+#ifdef LIBPQ_HAS_PIPELINING
+    if (mPGconn && PQenterPipelineMode(mPGconn))
+    {
+        m_pipelined = true;
+        m_pipelineOk = true;
+        _SendPipelined("START TRANSACTION");
+        return m_pipelineOk;
+    }
+#endif
     return _TransactionCmd("START TRANSACTION");
 }
 
 bool PostgreSQLConnection::CommitTransaction()
 {
+#ifdef LIBPQ_HAS_PIPELINING
+    if (m_pipelined)
+    {
+        uint32 _s = WorldTimer::getMSTime();
+        size_t requests = m_pipelineSql.size();
+
+        _SendPipelined("COMMIT");
+        PQpipelineSync(mPGconn);
+        _ReadPipelineResults();
+        _EndPipeline();
+
+        // an error leaves the transaction block aborted, COMMIT was skipped with the rest
+        if (!m_pipelineOk)
+        {
+            if (PQtransactionStatus(mPGconn) != PQTRANS_IDLE)
+                _TransactionCmd("ROLLBACK");
+            return false;
+        }
+
+        DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL pipelined transaction of " SIZEFMTD " requests", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), requests);
+        return true;
+    }
+#endif
     return _TransactionCmd("COMMIT");
 }
 
 bool PostgreSQLConnection::RollbackTransaction()
 {
+#ifdef LIBPQ_HAS_PIPELINING
+    if (m_pipelined)
+    {
+        PQpipelineSync(mPGconn);
+        _ReadPipelineResults();
+        _EndPipeline();
+    }
+#endif
     return _TransactionCmd("ROLLBACK");
 }
 
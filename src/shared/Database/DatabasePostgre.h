@@ -23,6 +23,8 @@
 #include "Database.h"
 #include "Policies/Singleton.h"
 #include <stdarg.h>
+#include <string>
+#include <vector>
 
 #ifdef _WIN32
 #define FD_SETSIZE 1024
@@ -35,26 +37,45 @@
 class PostgreSQLConnection : public SqlConnection
 {
     public:
-        PostgreSQLConnection(Database& db) : SqlConnection(db), mPGconn(nullptr) {}
+        PostgreSQLConnection(Database& db) : SqlConnection(db), mPGconn(nullptr), m_pipelined(false), m_pipelineOk(true), m_pipelineRead(0) {}
         ~PostgreSQLConnection();
 
         bool Initialize(const char* infoString) override;
 
         QueryResult* Query(const char* sql) override;
         QueryNamedResult* QueryNamed(const char* sql) override;
+        // sends all queries in pipeline mode and waits once for their results
+        void QueryBatch(std::vector<const char*> const& queries, std::vector<QueryResult*>& results) override;
+        // inside a pipelined transaction only sends, errors are reported by CommitTransaction
         bool Execute(const char* sql) override;
 
-        unsigned long escape_string(char* to, const char* from, unsigned long length);
+        unsigned long escape_string(char* to, const char* from, unsigned long length) override;
 
+        // transactions run in pipeline mode when libpq supports it, their requests share one round trip
         bool BeginTransaction() override;
         bool CommitTransaction() override;
         bool RollbackTransaction() override;
 
     private:
+        enum
+        {
+            // pending results read while sending, so neither side blocks on full socket buffers
+            PIPELINE_DRAIN_AT = 256,
+        };
+
         bool _TransactionCmd(const char* sql);
-        bool _Query(const char* sql, PGresult** pResult, uint64* pRowCount, uint32* pFieldCount) override;
+        bool _Query(const char* sql, PGresult** pResult, uint64* pRowCount, uint32* pFieldCount);
+
+        void _SendPipelined(const char* sql);
+        void _ReadPipelineResults();
+        bool _EndPipeline();
 
         PGconn* mPGconn;
+
+        bool m_pipelined;
+        bool m_pipelineOk;
+        std::vector<std::string> m_pipelineSql;             // sent requests of the pipelined transaction, for error reports
+        size_t m_pipelineRead;                              // m_pipelineSql entries whose result was read
 };
 
 class DatabasePostgre : public Database
@@ -16,5 +16,18 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
-//#include "DatabaseEnv.h"
+#include "Field.h"
+
+void Field::BuildText() const
+{
+    switch (mStorage)
+    {
+        case STORAGE_INTEGER:  snprintf(mText, sizeof(mText), SI64FMTD, mData.i); break;
+        case STORAGE_UNSIGNED: snprintf(mText, sizeof(mText), UI64FMTD, mData.u); break;
+        case STORAGE_FLOAT:    snprintf(mText, sizeof(mText), "%g", mData.f);     break;
+        default:               mText[0] = '\0';                                   break;
+    }
+
+    mTextBuilt = true;
+}
 
@@ -34,8 +34,8 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN), mStorage(STORAGE_TEXT), mTextBuilt(false) { mData.i = 0; }
+        Field(const char* value, enum DataTypes type) : mValue(value), mType(type), mStorage(STORAGE_TEXT), mTextBuilt(false) { mData.i = 0; }
 
         ~Field() {}
 
@@ -44,21 +44,61 @@ class Field
 
         const char* GetString() const
         {
+            if (mStorage != STORAGE_TEXT && !mTextBuilt)
+                BuildText();
             return mValue ? mValue : ""; // We need this null check as we do not always null check what we get back from the database everywhere
         }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            return GetString();                             // std::string s = 0 have undefine result in C++
+        }
+        float GetFloat() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<float>(GetBinaryDouble());
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
+        }
+        bool GetBool() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return GetBinaryInteger() > 0;
+            return mValue ? atoi(mValue) > 0 : false;
+        }
+        int32 GetInt32() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<int32>(GetBinaryInteger());
+            return mValue ? static_cast<int32>(atol(mValue)) : int32(0);
+        }
+        uint8 GetUInt8() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint8>(GetBinaryInteger());
+            return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0);
+        }
+        uint16 GetUInt16() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint16>(GetBinaryInteger());
+            return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0);
+        }
+        int16 GetInt16() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<int16>(GetBinaryInteger());
+            return mValue ? static_cast<int16>(atol(mValue)) : int16(0);
+        }
+        uint32 GetUInt32() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint32>(GetBinaryInteger());
+            return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0);
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0); }
         uint64 GetUInt64() const
         {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint64>(GetBinaryInteger());
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
                 return 0;
@@ -69,13 +109,59 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         // no need for memory allocations to store resultset field strings
         // all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; }
+        void SetValue(const char* value) { mValue = value; mStorage = STORAGE_TEXT; }
+
+        // binary protocol results store numeric values directly, the text form is only built on request
+        void SetValue(int64 value) { mData.i = value; SetBinary(STORAGE_INTEGER); }
+        void SetValue(uint64 value) { mData.u = value; SetBinary(STORAGE_UNSIGNED); }
+        void SetValue(double value) { mData.f = value; SetBinary(STORAGE_FLOAT); }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        enum StorageTypes
+        {
+            STORAGE_TEXT,                                   // mValue points to the DBMS provided text
+            STORAGE_INTEGER,
+            STORAGE_UNSIGNED,
+            STORAGE_FLOAT
+        };
+
+        void SetBinary(StorageTypes storage)
+        {
+            mStorage = storage;
+            mTextBuilt = false;
+            mValue = mText;                                 // not NULL, text is filled by BuildText()
+        }
+
+        int64 GetBinaryInteger() const
+        {
+            return mStorage == STORAGE_FLOAT ? static_cast<int64>(mData.f) : mData.i;
+        }
+
+        double GetBinaryDouble() const
+        {
+            switch (mStorage)
+            {
+                case STORAGE_UNSIGNED: return static_cast<double>(mData.u);
+                case STORAGE_FLOAT:    return mData.f;
+                default:               return static_cast<double>(mData.i);
+            }
+        }
+
+        void BuildText() const;
+
         const char* mValue;
         enum DataTypes mType;
+        StorageTypes mStorage;
+        union
+        {
+            int64 i;
+            uint64 u;
+            double f;
+        } mData;
+        mutable bool mTextBuilt;
+        mutable char mText[32];
 };
 #endif
@@ -66,7 +66,7 @@ void QueryResultMysql::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
+enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType)
 {
     switch (mysqlType)
     {
@@ -96,4 +96,207 @@ enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysql
             return Field::DB_TYPE_UNKNOWN;
     }
 }
+QueryResultMysqlStream::QueryResultMysqlStream(MySQLConnection& conn, MYSQL* mysql, MYSQL_RES* result, MYSQL_FIELD* fields, uint32 fieldCount) :
+    QueryResult(0, fieldCount), mConnection(&conn), mMysql(mysql), mResult(result), mFetchedRows(0)
+{
+    mConnection->BeginStream();
+
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+}
+
+QueryResultMysqlStream::~QueryResultMysqlStream()
+{
+    EndQuery();
+}
+
+bool QueryResultMysqlStream::NextRow()
+{
+    if (!mResult)
+        return false;
+
+    MYSQL_ROW row = mysql_fetch_row(mResult);
+    if (!row)
+    {
+        // unlike a stored result the end of the rows can also be a lost connection
+        if (mysql_errno(mMysql))
+        {
+            sLog.outErrorDb("SQL: streamed result aborted after " UI64FMTD " rows: %s", mFetchedRows, mysql_error(mMysql));
+            mConnection->CheckConnectionLost(mysql_errno(mMysql));
+        }
+
+        EndQuery();
+        return false;
+    }
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        mCurrentRow[i].SetValue(row[i]);
+
+    ++mFetchedRows;
+    return true;
+}
+
+void QueryResultMysqlStream::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = nullptr;
+
+    if (mResult)
+    {
+        // reads and drops the rows not fetched yet, the connection can't be used before
+        mysql_free_result(mResult);
+        mResult = nullptr;
+
+        mConnection->EndStream();
+    }
+}
+
+QueryResultMysqlBinary::QueryResultMysqlBinary(MYSQL_STMT* stmt, MYSQL_RES* metadata, uint64 rowCount, uint32 fieldCount) :
+    QueryResult(rowCount, fieldCount), mStmt(stmt), mMetadata(metadata), mBinds(fieldCount), mColumns(fieldCount)
+{
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(mMetadata);
+    memset(mBinds.data(), 0, sizeof(MYSQL_BIND) * mFieldCount);
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+
+        Column& column = mColumns[i];
+        MYSQL_BIND& bind = mBinds[i];
+        column.value.i = 0;
+
+        switch (fields[i].type)
+        {
+            case FIELD_TYPE_TINY:
+            case FIELD_TYPE_SHORT:
+            case FIELD_TYPE_LONG:
+            case FIELD_TYPE_INT24:
+            case FIELD_TYPE_LONGLONG:
+                column.storage = (fields[i].flags & UNSIGNED_FLAG) ? COLUMN_UNSIGNED : COLUMN_INTEGER;
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.buffer = &column.value.i;
+                bind.is_unsigned = column.storage == COLUMN_UNSIGNED;
+                break;
+            case FIELD_TYPE_FLOAT:
+            case FIELD_TYPE_DOUBLE:
+                column.storage = COLUMN_FLOAT;
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &column.value.f;
+                break;
+            default:
+                // strings, blobs, decimals and dates are fetched as text, max_length is known after mysql_stmt_store_result()
+                column.storage = COLUMN_TEXT;
+                column.text.resize(std::max<unsigned long>(fields[i].max_length, 32) + 1);
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = column.text.data();
+                bind.buffer_length = column.text.size() - 1;
+                break;
+        }
+
+        bind.length = &column.length;
+        bind.is_null = &column.isNull;
+        bind.error = &column.error;
+    }
+
+    if (mysql_stmt_bind_result(mStmt, mBinds.data()))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed");
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(mStmt));
+        EndQuery();
+    }
+}
+
+QueryResultMysqlBinary::~QueryResultMysqlBinary()
+{
+    EndQuery();
+}
+
+bool QueryResultMysqlBinary::NextRow()
+{
+    if (!mStmt)
+        return false;
+
+    int status = mysql_stmt_fetch(mStmt);
+    if (status == MYSQL_DATA_TRUNCATED)
+        status = FetchTruncated() ? 0 : 1;
+
+    if (status != 0)
+    {
+        if (status != MYSQL_NO_DATA)
+            sLog.outError("SQL ERROR: %s", mysql_stmt_error(mStmt));
+
+        EndQuery();
+        return false;
+    }
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Column& column = mColumns[i];
+        if (column.isNull)
+        {
+            mCurrentRow[i].SetValue(static_cast<const char*>(nullptr));
+            continue;
+        }
+
+        switch (column.storage)
+        {
+            case COLUMN_INTEGER:  mCurrentRow[i].SetValue(column.value.i);                      break;
+            case COLUMN_UNSIGNED: mCurrentRow[i].SetValue(static_cast<uint64>(column.value.i)); break;
+            case COLUMN_FLOAT:    mCurrentRow[i].SetValue(column.value.f);                      break;
+            case COLUMN_TEXT:
+                column.text[column.length] = '\0';
+                mCurrentRow[i].SetValue(static_cast<const char*>(column.text.data()));
+                break;
+        }
+    }
+
+    return true;
+}
+
+// text columns longer than their buffer are grown and fetched again, the result binding is refreshed for the next rows
+bool QueryResultMysqlBinary::FetchTruncated()
+{
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Column& column = mColumns[i];
+        if (!column.error || column.storage != COLUMN_TEXT)
+            continue;
+
+        column.text.resize(column.length + 1);
+        mBinds[i].buffer = column.text.data();
+        mBinds[i].buffer_length = column.length;
+
+        if (mysql_stmt_fetch_column(mStmt, &mBinds[i], i, 0))
+            return false;
+
+        column.error = 0;
+    }
+
+    return mysql_stmt_bind_result(mStmt, mBinds.data()) == 0;
+}
+
+void QueryResultMysqlBinary::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = nullptr;
+
+    if (mMetadata)
+    {
+        mysql_free_result(mMetadata);
+        mMetadata = nullptr;
+    }
+
+    if (mStmt)
+    {
+        mysql_stmt_free_result(mStmt);
+        mysql_stmt_close(mStmt);
+        mStmt = nullptr;
+    }
+}
 #endif
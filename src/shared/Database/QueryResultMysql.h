@@ -23,6 +23,8 @@
 
 #include "Common.h"
 
+#include <vector>
+
 #ifdef _WIN32
 #include <WinSock2.h>
 #include <mysql/mysql.h>
@@ -39,11 +41,77 @@ class QueryResultMysql : public QueryResult
 
         bool NextRow() override;
 
+        static enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType);
+
+    private:
+        void EndQuery();
+
+        MYSQL_RES* mResult;
+};
+
+class MySQLConnection;
+class SqlConnection;
+
+// Rows fetched one by one from the server (mysql_use_result), only the current row is held in memory.
+// Keeps the connection locked and marked streaming until all rows were read or the result is deleted.
+class QueryResultMysqlStream : public QueryResult
+{
+    public:
+        QueryResultMysqlStream(MySQLConnection& conn, MYSQL* mysql, MYSQL_RES* result, MYSQL_FIELD* fields, uint32 fieldCount);
+
+        ~QueryResultMysqlStream();
+
+        bool NextRow() override;
+
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
         void EndQuery();
 
+        MySQLConnection* mConnection;
+        MYSQL* mMysql;
         MYSQL_RES* mResult;
+        uint64 mFetchedRows;
+};
+
+// Result of a query executed with the binary protocol, numeric columns arrive typed and are stored without text conversion
+class QueryResultMysqlBinary : public QueryResult
+{
+    public:
+        QueryResultMysqlBinary(MYSQL_STMT* stmt, MYSQL_RES* metadata, uint64 rowCount, uint32 fieldCount);
+
+        ~QueryResultMysqlBinary();
+
+        bool NextRow() override;
+
+    private:
+        enum ColumnStorage
+        {
+            COLUMN_INTEGER,
+            COLUMN_UNSIGNED,
+            COLUMN_FLOAT,
+            COLUMN_TEXT
+        };
+
+        struct Column
+        {
+            ColumnStorage storage;
+            union
+            {
+                int64 i;
+                double f;
+            } value;
+            std::vector<char> text;
+            unsigned long length;
+            my_bool isNull;
+            my_bool error;
+        };
+
+        bool FetchTruncated();
+        void EndQuery();
+
+        MYSQL_STMT* mStmt;
+        MYSQL_RES* mMetadata;
+        std::vector<MYSQL_BIND> mBinds;
+        std::vector<Column> mColumns;
 };
 #endif
 #endif
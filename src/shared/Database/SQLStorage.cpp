@@ -17,6 +17,7 @@
  */
 
 #include "SQLStorage.h"
+#include "MemoryTracker.h"
 
 // -----------------------------------  SQLStorageBase  ---------------------------------------- //
 
@@ -30,7 +31,12 @@ SQLStorageBase::SQLStorageBase() :
     m_recordCount(0),
     m_maxEntry(0),
     m_recordSize(0),
-    m_data(nullptr)
+    m_data(nullptr),
+    m_dataSize(0),
+    m_stringCursor(nullptr),
+    m_stringBlockLeft(0),
+    m_stringPoolSize(0),
+    m_stringCount(0)
 {}
 
 void SQLStorageBase::Initialize(const char* tableName, const char* entry_field, const char* src_format, const char* dst_format)
@@ -53,14 +59,83 @@ char* SQLStorageBase::createRecord(uint32 recordId)
     return newRecord;
 }
 
+// block size of the string pool, longer strings get a block of their own
+static size_t const STRING_BLOCK_SIZE = 16 * 1024;
+static size_t const STRING_OWN_BLOCK_SIZE = STRING_BLOCK_SIZE / 8;
+
+char* SQLStorageBase::InternString(char const* str)
+{
+    ++m_stringCount;
+
+    auto itr = m_internedStrings.find(str);
+    if (itr != m_internedStrings.end())
+        return const_cast<char*>(*itr);
+
+    size_t size = strlen(str) + 1;
+    char* dst;
+    if (size > STRING_OWN_BLOCK_SIZE)
+    {
+        dst = new char[size];
+        m_stringBlocks.push_back(std::make_pair(dst, size));
+        m_stringPoolSize += size;
+        MemoryTracker::Add(MEMORY_TAG_SQL_STORAGE, size);
+    }
+    else
+    {
+        if (size > m_stringBlockLeft)
+        {
+            m_stringCursor = new char[STRING_BLOCK_SIZE];
+            m_stringBlockLeft = STRING_BLOCK_SIZE;
+            m_stringBlocks.push_back(std::make_pair(m_stringCursor, STRING_BLOCK_SIZE));
+            m_stringPoolSize += STRING_BLOCK_SIZE;
+            MemoryTracker::Add(MEMORY_TAG_SQL_STORAGE, STRING_BLOCK_SIZE);
+        }
+
+        dst = m_stringCursor;
+        m_stringCursor += size;
+        m_stringBlockLeft -= size;
+    }
+
+    memcpy(dst, str, size);
+    m_internedStrings.insert(dst);
+    return dst;
+}
+
+bool SQLStorageBase::IsPooledString(char const* str) const
+{
+    for (auto const& block : m_stringBlocks)
+        if (str >= block.first && str < block.first + block.second)
+            return true;
+    return false;
+}
+
+void SQLStorageBase::FreeStringPool()
+{
+    for (auto const& block : m_stringBlocks)
+        delete[] block.first;
+
+    MemoryTracker::Remove(MEMORY_TAG_SQL_STORAGE, m_stringPoolSize);
+    m_stringBlocks.clear();
+    m_internedStrings.clear();
+    m_stringCursor = nullptr;
+    m_stringBlockLeft = 0;
+    m_stringPoolSize = 0;
+    m_stringCount = 0;
+}
+
 void SQLStorageBase::prepareToLoad(uint32 maxEntry, uint32 recordCount, uint32 recordSize)
 {
     m_maxEntry = maxEntry;
     m_recordSize = recordSize;
 
+    if (m_data)
+        MemoryTracker::Remove(MEMORY_TAG_SQL_STORAGE, m_dataSize);
+
     delete[] m_data;
-    m_data = new char[recordCount * m_recordSize];
-    memset(m_data, 0, recordCount * m_recordSize);
+    m_dataSize = recordCount * m_recordSize;
+    m_data = new char[m_dataSize];
+    memset(m_data, 0, m_dataSize);
+    MemoryTracker::Add(MEMORY_TAG_SQL_STORAGE, m_dataSize);
 
     m_recordCount = 0;
 }
@@ -81,8 +156,13 @@ void SQLStorageBase::Free()
                 break;
             case FT_STRING:
             {
+                // the pool owns the loaded strings, only a value replaced after loading is freed here
                 for (uint32 recordItr = 0; recordItr < m_recordCount; ++recordItr)
-                    delete[] *(char**)((char*)(m_data + (recordItr * m_recordSize)) + offset);
+                {
+                    char* str = *(char**)((char*)(m_data + (recordItr * m_recordSize)) + offset);
+                    if (!IsPooledString(str))
+                        delete[] str;
+                }
 
                 offset += sizeof(char*);
                 break;
@@ -100,7 +180,6 @@ void SQLStorageBase::Free()
                 offset += sizeof(float);
                 break;
             case FT_NA_POINTER:
-                // TODO- possible (and small) memleak here possible
                 offset += sizeof(char*);
                 break;
             case FT_64BITINT:
@@ -115,8 +194,12 @@ void SQLStorageBase::Free()
                 break;
         }
     }
+    FreeStringPool();
+
     delete[] m_data;
+    MemoryTracker::Remove(MEMORY_TAG_SQL_STORAGE, m_dataSize);
     m_data = nullptr;
+    m_dataSize = 0;
     m_recordCount = 0;
 }
 
@@ -130,6 +213,8 @@ void SQLStorage::EraseEntry(uint32 id)
 void SQLStorage::Free()
 {
     SQLStorageBase::Free();
+    if (m_Index)
+        MemoryTracker::Remove(MEMORY_TAG_SQL_STORAGE, GetMaxEntry() * sizeof(char*));
     delete[] m_Index;
     m_Index = nullptr;
 }
@@ -160,6 +245,7 @@ void SQLStorage::prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 re
     // Set index array
     m_Index = new char* [maxRecordId];
     memset(m_Index, 0, maxRecordId * sizeof(char*));
+    MemoryTracker::Add(MEMORY_TAG_SQL_STORAGE, maxRecordId * sizeof(char*));
 
     SQLStorageBase::prepareToLoad(maxRecordId, recordCount, recordSize);
 }
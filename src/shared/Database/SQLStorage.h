@@ -23,6 +23,9 @@
 #include "Database/DatabaseEnv.h"
 #include "DBCFileLoader.h"
 
+#include <unordered_set>
+#include <vector>
+
 class SQLStorageBase
 {
         template<class DerivedLoader, class StorageClass> friend class SQLStorageLoaderBase;
@@ -81,6 +84,27 @@ class SQLStorageBase
     private:
         char* createRecord(uint32 recordId);
 
+        // strings of the records live in the blocks of the string pool, equal strings share one copy
+        char* InternString(char const* str);
+        bool IsPooledString(char const* str) const;
+        void FreeStringPool();
+
+        struct StringHash
+        {
+            size_t operator()(char const* str) const
+            {
+                size_t hash = 2166136261u;                  // FNV-1a
+                for (; *str; ++str)
+                    hash = (hash ^ uint8(*str)) * 16777619u;
+                return hash;
+            }
+        };
+
+        struct StringEqual
+        {
+            bool operator()(char const* a, char const* b) const { return strcmp(a, b) == 0; }
+        };
+
         // Information about the table
         const char* m_tableName;
         const char* m_entry_field;
@@ -96,6 +120,15 @@ class SQLStorageBase
 
         // Data Storage
         char* m_data;
+        size_t m_dataSize;                                  // bytes of m_data accounted as MEMORY_TAG_SQL_STORAGE
+
+        // String pool
+        std::vector<std::pair<char*, size_t>> m_stringBlocks;   // block, its size
+        char* m_stringCursor;                               // free space of the current block
+        size_t m_stringBlockLeft;
+        size_t m_stringPoolSize;                            // bytes of m_stringBlocks accounted as MEMORY_TAG_SQL_STORAGE
+        uint32 m_stringCount;                               // strings stored by the loader, before interning
+        std::unordered_set<char const*, StringHash, StringEqual> m_internedStrings;     // only kept while loading
 };
 
 class SQLStorage : public SQLStorageBase
@@ -248,6 +281,8 @@ template <class DerivedLoader, class StorageClass>
 class SQLStorageLoaderBase
 {
     public:
+        SQLStorageLoaderBase() : m_store(nullptr) {}
+
         void Load(StorageClass& store, bool error_at_empty = true);
 
         template<class S, class D>
@@ -269,6 +304,10 @@ class SQLStorageLoaderBase
         void convert_from_str(uint32 field_pos, char* src, D& dst);
         void convert_str_to_str(uint32 field_pos, char* src, char*& dst);
 
+    protected:
+        // copy of str owned by the storage being loaded, freed with its records
+        char* AddString(char const* str) { return m_store->InternString(str ? str : ""); }
+
     private:
         template<class V>
         void storeValue(V value, StorageClass& store, char* p, uint32 x, uint32& offset);
@@ -276,6 +315,8 @@ class SQLStorageLoaderBase
 
         // trap, no body
         void storeValue(char* value, StorageClass& store, char* record, uint32 field_pos, uint32& offset);
+
+        StorageClass* m_store;
 };
 
 class SQLStorageLoader : public SQLStorageLoaderBase<SQLStorageLoader, SQLStorage>
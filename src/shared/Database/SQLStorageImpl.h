@@ -22,6 +22,9 @@
 #include "ProgressBar.h"
 #include "Log.h"
 #include "DBCFileLoader.h"
+#include "Database/SQLStorageSnapshot.h"
+
+#include <memory>
 
 template<class DerivedLoader, class StorageClass>
 template<class S, class D>                                  // S source-type, D destination-type
@@ -41,25 +44,14 @@ template<class DerivedLoader, class StorageClass>
 
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::convert_str_to_str(uint32 /*field_pos*/, char const* src, char*& dst)
 {
-    if (!src)
-    {
-        dst = new char[1];
-        *dst = 0;
-    }
-    else
-    {
-        uint32 l = strlen(src) + 1;
-        dst = new char[l];
-        memcpy(dst, src, l);
-    }
+    dst = AddString(src);
 }
 
 template<class DerivedLoader, class StorageClass>
 template<class S>                                           // S source-type
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::convert_to_str(uint32 /*field_pos*/, S /*src*/, char*& dst)
 {
-    dst = new char[1];
-    *dst = 0;
+    dst = AddString("");
 }
 
 template<class DerivedLoader, class StorageClass>
@@ -85,8 +77,7 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::default_fill(uint32 /*fi
 template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::default_fill_to_str(uint32 /*field_pos*/, char const* /*src*/, char*& dst)
 {
-    dst = new char[1];
-    *dst = 0;
+    dst = AddString("");
 }
 
 template<class DerivedLoader, class StorageClass>
@@ -190,38 +181,59 @@ template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store, bool error_at_empty /*= true*/)
 {
     Field* fields = nullptr;
-    QueryResult* result  = WorldDatabase.PQuery("SELECT MAX(%s) FROM %s", store.EntryFieldName(), store.GetTableName());
-    if (!result)
-    {
-        sLog.outError("Error loading %s table (not exist?)\n", store.GetTableName());
-        Log::WaitBeforeContinueIfNeed();
-        exit(1);                                            // Stop server at loading non exited table or not accessable table
-    }
-
-    uint32 maxRecordId = (*result)[0].GetUInt32() + 1;
+    uint32 maxRecordId = 0;
     uint32 recordCount = 0;
     uint32 recordsize = 0;
-    delete result;
 
-    result = WorldDatabase.PQuery("SELECT COUNT(*) FROM %s", store.GetTableName());
+    // an unchanged table is read from its snapshot file, otherwise the snapshot is rebuilt from the query
+    uint64 checksum = 0;
+    bool const useSnapshot = SQLStorageSnapshot::IsEnabled() && SQLStorageSnapshot::GetTableChecksum(store.GetTableName(), checksum);
+    std::unique_ptr<SQLStorageSnapshot::Writer> snapshot;
+
+    m_store = &store;
+
+    QueryResult* result = useSnapshot ? SQLStorageSnapshot::Open(store.GetTableName(), store.GetSrcFormat(), checksum, maxRecordId) : nullptr;
     if (result)
     {
-        fields = result->Fetch();
-        recordCount = fields[0].GetUInt32();
-        delete result;
+        recordCount = uint32(result->GetRowCount());
+        DETAIL_LOG("Loading %s from snapshot", store.GetTableName());
     }
+    else
+    {
+        result = WorldDatabase.PQuery("SELECT MAX(%s) FROM %s", store.EntryFieldName(), store.GetTableName());
+        if (!result)
+        {
+            sLog.outError("Error loading %s table (not exist?)\n", store.GetTableName());
+            Log::WaitBeforeContinueIfNeed();
+            exit(1);                                        // Stop server at loading non exited table or not accessable table
+        }
 
-    result = WorldDatabase.PQuery("SELECT * FROM %s", store.GetTableName());
+        maxRecordId = (*result)[0].GetUInt32() + 1;
+        delete result;
 
-    if (!result)
-    {
-        if (error_at_empty)
-            sLog.outError("%s table is empty!\n", store.GetTableName());
-        else
-            sLog.outString("%s table is empty!\n", store.GetTableName());
+        result = WorldDatabase.PQuery("SELECT COUNT(*) FROM %s", store.GetTableName());
+        if (result)
+        {
+            fields = result->Fetch();
+            recordCount = fields[0].GetUInt32();
+            delete result;
+        }
 
-        recordCount = 0;
-        return;
+        result = WorldDatabase.PQueryBinary("SELECT * FROM %s", store.GetTableName());
+
+        if (!result)
+        {
+            if (error_at_empty)
+                sLog.outError("%s table is empty!\n", store.GetTableName());
+            else
+                sLog.outString("%s table is empty!\n", store.GetTableName());
+
+            recordCount = 0;
+            return;
+        }
+
+        if (useSnapshot)
+            snapshot.reset(new SQLStorageSnapshot::Writer(store.GetTableName(), store.GetSrcFormat(), checksum));
     }
 
     if (store.GetSrcFieldCount() != result->GetFieldCount())
@@ -278,6 +290,9 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         fields = result->Fetch();
         bar.step();
 
+        if (snapshot)
+            snapshot->AddRow(fields);
+
         char* record = store.createRecord(fields[0].GetUInt32());
         offset = 0;
 
@@ -329,6 +344,14 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     while (result->NextRow());
 
     delete result;
+
+    if (snapshot)
+        snapshot->Save(maxRecordId);
+
+    // the interning set is only needed to find duplicates while loading
+    DETAIL_LOG("%s: %u records in " SIZEFMTD " bytes, %u strings in " SIZEFMTD " bytes of string pool (" SIZEFMTD " unique)",
+               store.GetTableName(), store.GetRecordCount(), store.m_dataSize, store.m_stringCount, store.m_stringPoolSize, store.m_internedStrings.size());
+    std::unordered_set<char const*, SQLStorageBase::StringHash, SQLStorageBase::StringEqual>().swap(store.m_internedStrings);
 }
 
 #endif
@@ -0,0 +1,293 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "Database/SQLStorageSnapshot.h"
+#include "Database/DatabaseEnv.h"
+#include "DBCFileLoader.h"
+#include "Log.h"
+
+#include <cstdio>
+
+std::string SQLStorageSnapshot::m_directory;
+
+namespace
+{
+    uint32 const SNAPSHOT_MAGIC   = 0x53535153;             // 'SQSS'
+    uint32 const SNAPSHOT_VERSION = 1;
+
+    // column 0 holds the record id and is always kept
+    bool IsStoredColumn(char const* srcFormat, uint32 column)
+    {
+        switch (srcFormat[column])
+        {
+            case FT_NA:
+            case FT_NA_BYTE:
+            case FT_NA_FLOAT:
+                return column == 0;
+            default:
+                return true;
+        }
+    }
+
+    // walks the rows once so a damaged file is never read past its end
+    bool IsComplete(std::vector<char> const& data, size_t pos, uint32 rowCount, char const* srcFormat)
+    {
+        uint32 const columns = strlen(srcFormat);
+        for (uint32 row = 0; row < rowCount; ++row)
+        {
+            for (uint32 i = 0; i < columns; ++i)
+            {
+                if (!IsStoredColumn(srcFormat, i))
+                    continue;
+
+                switch (srcFormat[i])
+                {
+                    case FT_64BITINT:
+                        pos += sizeof(uint64);
+                        break;
+                    case FT_STRING:
+                    {
+                        uint32 length;
+                        if (pos + sizeof(uint32) > data.size())
+                            return false;
+                        memcpy(&length, &data[pos], sizeof(uint32));
+                        pos += sizeof(uint32) + length + 1;
+                        if (pos > data.size() || data[pos - 1] != '\0')
+                            return false;
+                        break;
+                    }
+                    default:                                // uint32 and float
+                        pos += sizeof(uint32);
+                        break;
+                }
+
+                if (pos > data.size())
+                    return false;
+            }
+        }
+
+        return pos == data.size();
+    }
+
+    class SnapshotResult : public QueryResult
+    {
+        public:
+            SnapshotResult(std::vector<char>&& data, size_t rowsOffset, uint32 rowCount, std::string const& srcFormat) :
+                QueryResult(rowCount, srcFormat.size()), m_data(std::move(data)), m_pos(rowsOffset), m_rowsLeft(rowCount), m_srcFormat(srcFormat)
+            {
+                mCurrentRow = new Field[mFieldCount];
+            }
+
+            ~SnapshotResult() { delete[] mCurrentRow; }
+
+            bool NextRow() override
+            {
+                if (!m_rowsLeft)
+                    return false;
+
+                --m_rowsLeft;
+                for (uint32 i = 0; i < mFieldCount; ++i)
+                {
+                    Field& field = mCurrentRow[i];
+                    if (!IsStoredColumn(m_srcFormat.c_str(), i))
+                    {
+                        field.SetValue(static_cast<const char*>(nullptr));
+                        continue;
+                    }
+
+                    switch (m_srcFormat[i])
+                    {
+                        case FT_FLOAT:
+                            field.SetValue(static_cast<double>(Read<float>()));
+                            break;
+                        case FT_64BITINT:
+                            field.SetValue(Read<uint64>());
+                            break;
+                        case FT_STRING:
+                        {
+                            uint32 const length = Read<uint32>();
+                            field.SetValue(static_cast<const char*>(&m_data[m_pos]));
+                            m_pos += length + 1;
+                            break;
+                        }
+                        default:
+                            field.SetValue(static_cast<uint64>(Read<uint32>()));
+                            break;
+                    }
+                }
+
+                return true;
+            }
+
+        private:
+            template<typename T>
+            T Read()
+            {
+                T value;
+                memcpy(&value, &m_data[m_pos], sizeof(T));
+                m_pos += sizeof(T);
+                return value;
+            }
+
+            std::vector<char> m_data;
+            size_t m_pos;
+            uint32 m_rowsLeft;
+            std::string m_srcFormat;
+    };
+}
+
+std::string SQLStorageSnapshot::GetFileName(char const* tableName)
+{
+    std::string fileName = m_directory;
+    if (!fileName.empty() && fileName.back() != '/' && fileName.back() != '\\')
+        fileName += '/';
+
+    return fileName + tableName + ".snapshot";
+}
+
+bool SQLStorageSnapshot::GetTableChecksum(char const* tableName, uint64& checksum)
+{
+#ifndef DO_POSTGRESQL
+    QueryResult* result = WorldDatabase.PQuery("CHECKSUM TABLE %s", tableName);
+    if (!result)
+        return false;
+
+    // NULL checksum if the table does not exist
+    Field const* fields = result->Fetch();
+    bool const valid = !fields[1].IsNULL();
+    checksum = fields[1].GetUInt64();
+    delete result;
+    return valid;
+#else
+    return false;
+#endif
+}
+
+QueryResult* SQLStorageSnapshot::Open(char const* tableName, char const* srcFormat, uint64 checksum, uint32& maxRecordId)
+{
+    FILE* file = fopen(GetFileName(tableName).c_str(), "rb");
+    if (!file)
+        return nullptr;
+
+    // the whole file is read with one call, rows are converted directly from this buffer
+    fseek(file, 0, SEEK_END);
+    long const size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    std::vector<char> data(size > 0 ? size : 0);
+    bool const read = size > 0 && fread(data.data(), size, 1, file) == 1;
+    fclose(file);
+
+    uint32 const formatLength = strlen(srcFormat);
+    size_t const headerSize = 4 * sizeof(uint32) + sizeof(uint64) + formatLength + sizeof(uint32);
+    if (!read || data.size() < headerSize)
+        return nullptr;
+
+    uint32 header[3];
+    uint64 fileChecksum;
+    memcpy(header, data.data(), sizeof(header));
+    memcpy(&fileChecksum, data.data() + sizeof(header), sizeof(fileChecksum));
+    size_t pos = sizeof(header) + sizeof(fileChecksum);
+
+    if (header[0] != SNAPSHOT_MAGIC || header[1] != SNAPSHOT_VERSION || fileChecksum != checksum ||
+            header[2] != formatLength || memcmp(data.data() + pos, srcFormat, formatLength) != 0)
+        return nullptr;
+    pos += formatLength;
+
+    uint32 rowCount;
+    memcpy(&maxRecordId, data.data() + pos, sizeof(uint32));
+    memcpy(&rowCount, data.data() + pos + sizeof(uint32), sizeof(uint32));
+    pos += 2 * sizeof(uint32);
+
+    if (!rowCount || !IsComplete(data, pos, rowCount, srcFormat))
+        return nullptr;
+
+    SnapshotResult* result = new SnapshotResult(std::move(data), pos, rowCount, srcFormat);
+    result->NextRow();
+    return result;
+}
+
+SQLStorageSnapshot::Writer::Writer(char const* tableName, char const* srcFormat, uint64 checksum) :
+    m_tableName(tableName), m_srcFormat(srcFormat), m_checksum(checksum), m_rowCount(0)
+{
+}
+
+void SQLStorageSnapshot::Writer::AddRow(Field const* fields)
+{
+    for (uint32 i = 0; i < m_srcFormat.size(); ++i)
+    {
+        if (!IsStoredColumn(m_srcFormat.c_str(), i))
+            continue;
+
+        switch (m_srcFormat[i])
+        {
+            case FT_FLOAT:
+                Append(fields[i].GetFloat());
+                break;
+            case FT_64BITINT:
+                Append(fields[i].GetUInt64());
+                break;
+            case FT_STRING:
+            {
+                char const* value = fields[i].GetString();
+                uint32 const length = strlen(value);
+                Append(length);
+                m_data.insert(m_data.end(), value, value + length + 1);
+                break;
+            }
+            default:
+                Append(fields[i].GetUInt32());
+                break;
+        }
+    }
+
+    ++m_rowCount;
+}
+
+bool SQLStorageSnapshot::Writer::Save(uint32 maxRecordId) const
+{
+    std::string const fileName = GetFileName(m_tableName.c_str());
+    std::string const tmpName = fileName + ".tmp";
+
+    FILE* file = fopen(tmpName.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outError("SQLStorageSnapshot: can't create %s", tmpName.c_str());
+        return false;
+    }
+
+    uint32 const header[3] = { SNAPSHOT_MAGIC, SNAPSHOT_VERSION, uint32(m_srcFormat.size()) };
+    uint32 const counts[2] = { maxRecordId, m_rowCount };
+
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1;
+    ok = ok && fwrite(&m_checksum, sizeof(m_checksum), 1, file) == 1;
+    ok = ok && fwrite(m_srcFormat.data(), m_srcFormat.size(), 1, file) == 1;
+    ok = ok && fwrite(counts, sizeof(counts), 1, file) == 1;
+    ok = ok && (m_data.empty() || fwrite(m_data.data(), m_data.size(), 1, file) == 1);
+    ok = fclose(file) == 0 && ok;
+
+    // a partly written file must never replace a valid snapshot
+    if (!ok)
+    {
+        sLog.outError("SQLStorageSnapshot: can't write %s", tmpName.c_str());
+        remove(tmpName.c_str());
+        return false;
+    }
+
+    remove(fileName.c_str());
+    return rename(tmpName.c_str(), fileName.c_str()) == 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SQLSTORAGE_SNAPSHOT_H
+#define SQLSTORAGE_SNAPSHOT_H
+
+#include "Common.h"
+#include "Database/QueryResult.h"
+
+#include <string>
+#include <vector>
+
+// File cache of the rows of a world table loaded into a SQLStorage, used instead of the query while the table is unchanged.
+// Rows are kept in their source (column) form, so derived loaders still convert them like rows from the database.
+// A snapshot is valid for the table checksum reported by the server and the source format it was written with.
+class SQLStorageSnapshot
+{
+    public:
+        // empty directory disables snapshots
+        static void SetDirectory(std::string const& directory) { m_directory = directory; }
+        static bool IsEnabled() { return !m_directory.empty(); }
+
+        // server side content checksum of the table, false if not supported by the DBMS
+        static bool GetTableChecksum(char const* tableName, uint64& checksum);
+
+        // returns a result over the snapshot rows or nullptr if there is no snapshot matching checksum and format
+        static QueryResult* Open(char const* tableName, char const* srcFormat, uint64 checksum, uint32& maxRecordId);
+
+        // collects rows queried from the database
+        class Writer
+        {
+            public:
+                Writer(char const* tableName, char const* srcFormat, uint64 checksum);
+
+                void AddRow(Field const* fields);
+                // writes the file, replacing an outdated snapshot
+                bool Save(uint32 maxRecordId) const;
+
+            private:
+                template<typename T>
+                void Append(T value) { m_data.insert(m_data.end(), reinterpret_cast<char const*>(&value), reinterpret_cast<char const*>(&value) + sizeof(T)); }
+
+                std::string m_tableName;
+                std::string m_srcFormat;
+                uint64 m_checksum;
+                uint32 m_rowCount;
+                std::vector<char> m_data;
+        };
+
+    private:
+        static std::string GetFileName(char const* tableName);
+
+        static std::string m_directory;
+};
+
+#endif
@@ -20,7 +20,10 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+#include <algorithm>
+#include <chrono>
+
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_queueMutex("SqlDelayThread::m_queueMutex"), m_dbEngine(db), m_dbConnection(conn), m_running(true)
 {
 }
 
@@ -32,28 +35,25 @@ SqlDelayThread::~SqlDelayThread()
 
 void SqlDelayThread::run()
 {
+    MaNGOS::Thread::SetupCurrentThread("sql");
+
 #ifndef DO_POSTGRESQL
     mysql_thread_init();
 #endif
 
-    const uint32 loopSleepms = 10;
-
-    const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
-
-    uint32 loopCounter = 0;
     while (m_running)
     {
+        // sleep until there is work, requests are executed as soon as they arrive.
+        // while the connection is lost they stay queued until the health monitor restored it
+        {
+            std::unique_lock<ProfiledMutex> lock(m_queueMutex);
+            while ((m_sqlQueue.empty() || !m_dbConnection->IsHealthy()) && m_running)
+                m_queueCondition.wait_for(lock, std::chrono::seconds(1));
+        }
+
         // if the running state gets turned off while sleeping
         // empty the queue before exiting
-        MaNGOS::Thread::Sleep(loopSleepms);
-
         ProcessRequests();
-
-        if ((loopCounter++) >= pingEveryLoop)
-        {
-            loopCounter = 0;
-            m_dbEngine->Ping();
-        }
     }
 
 #ifndef DO_POSTGRESQL
@@ -63,7 +63,11 @@ void SqlDelayThread::run()
 
 void SqlDelayThread::Stop()
 {
-    m_running = false;
+    {
+        std::lock_guard<ProfiledMutex> guard(m_queueMutex);
+        m_running = false;
+    }
+    m_queueCondition.notify_all();
 }
 
 void SqlDelayThread::ProcessRequests()
@@ -73,7 +77,7 @@ void SqlDelayThread::ProcessRequests()
     // we need to move the contents of the queue to a local copy because executing these statements with the
     // lock in place can result in a deadlock with the world thread which calls Database::ProcessResultQueue()
     {
-        std::lock_guard<std::mutex> guard(m_queueMutex);
+        std::lock_guard<ProfiledMutex> guard(m_queueMutex);
         sqlQueue = std::move(m_sqlQueue);
     }
 
@@ -81,6 +85,68 @@ void SqlDelayThread::ProcessRequests()
     {
         auto const s = std::move(sqlQueue.front());
         sqlQueue.pop();
+        if (s->GetQueueTimer().IsActive())
+            SqlStatistics::RecordQueueWait(s->GetQueueTimer().ElapsedUs());
         s->Execute(m_dbConnection);
+
+        // connection lost, keep the not yet executed requests in front of the newer ones until it is back
+        if (!m_dbConnection->IsHealthy() && m_running && !sqlQueue.empty())
+        {
+            std::lock_guard<ProfiledMutex> guard(m_queueMutex);
+            while (!m_sqlQueue.empty())
+            {
+                sqlQueue.push(std::move(m_sqlQueue.front()));
+                m_sqlQueue.pop();
+            }
+            m_sqlQueue = std::move(sqlQueue);
+            return;
+        }
+    }
+}
+
+SqlHealthMonitor::SqlHealthMonitor(Database* db) : m_dbEngine(db), m_running(true)
+{
+}
+
+void SqlHealthMonitor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_stopMutex);
+        m_running = false;
+    }
+    m_stopCondition.notify_all();
+}
+
+void SqlHealthMonitor::run()
+{
+#ifndef DO_POSTGRESQL
+    mysql_thread_init();
+#endif
+
+    const auto reconnectInterval = std::chrono::seconds(5);
+    const auto pingInterval = std::chrono::milliseconds(std::max(m_dbEngine->GetPingIntervall(), uint32(IN_MILLISECONDS)));
+    auto nextPing = std::chrono::steady_clock::now() + pingInterval;
+
+    while (m_running)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_stopMutex);
+            m_stopCondition.wait_for(lock, reconnectInterval, [this]() { return !m_running; });
+        }
+
+        if (!m_running)
+            break;
+
+        m_dbEngine->ReconnectLostConnections();
+
+        if (std::chrono::steady_clock::now() >= nextPing)
+        {
+            nextPing = std::chrono::steady_clock::now() + pingInterval;
+            m_dbEngine->Ping();
+        }
     }
+
+#ifndef DO_POSTGRESQL
+    mysql_thread_end();
+#endif
 }
@@ -20,9 +20,11 @@
 #define __SQLDELAYTHREAD_H
 
 #include "Threading.h"
+#include "ProfiledMutex.h"
 #include "SqlOperations.h"
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -34,7 +36,8 @@ class SqlConnection;
 class SqlDelayThread : public MaNGOS::Runnable
 {
     private:
-        std::mutex m_queueMutex;
+        ProfiledMutex m_queueMutex;
+        std::condition_variable_any m_queueCondition;           ///< Signalled when a request is queued or the thread is stopped
         std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
         Database* m_dbEngine;                                   ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
@@ -50,12 +53,40 @@ class SqlDelayThread : public MaNGOS::Runnable
         ///< Put sql statement to delay queue
         bool Delay(SqlOperation* sql)
         {
-            std::lock_guard<std::mutex> guard(m_queueMutex);
-            m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            sql->MarkQueued();
+            {
+                std::lock_guard<ProfiledMutex> guard(m_queueMutex);
+                m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            }
+            m_queueCondition.notify_one();
             return true;
         }
 
+        ///< Requests waiting for the executer, a transaction counts as one
+        size_t GetQueueSize()
+        {
+            std::lock_guard<ProfiledMutex> guard(m_queueMutex);
+            return m_sqlQueue.size();
+        }
+
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
+
+// Keeps the connections of a database engine alive: pings idle connections and reconnects lost ones in the background,
+// so no world or map thread has to wait for a reconnect
+class SqlHealthMonitor : public MaNGOS::Runnable
+{
+    public:
+        explicit SqlHealthMonitor(Database* db);
+
+        void Stop();
+        void run() override;
+
+    private:
+        std::mutex m_stopMutex;
+        std::condition_variable m_stopCondition;
+        Database* m_dbEngine;
+        std::atomic<bool> m_running;
+};
 #endif                                                      //__SQLDELAYTHREAD_H
@@ -223,12 +223,16 @@ bool SqlQueryHolderEx::Execute(SqlConnection* conn)
     LOCK_DB_CONN(conn);
     /// we can do this, we are friends
     std::vector<SqlQueryHolder::SqlResultPair>& queries = m_holder->m_queries;
+
+    /// execute all queries in the holder at once and pass the results
+    std::vector<const char*> sqls(queries.size());
     for (size_t i = 0; i < queries.size(); ++i)
-    {
-        /// execute all queries in the holder and pass the results
-        char const* sql = queries[i].first;
-        if (sql) m_holder->SetResult(i, conn->Query(sql));
-    }
+        sqls[i] = queries[i].first;
+
+    std::vector<QueryResult*> results;
+    conn->QueryBatch(sqls, results);
+    for (size_t i = 0; i < results.size(); ++i)
+        m_holder->SetResult(i, results[i]);
 
     /// sync with the caller thread
     m_queue->Add(m_callback);
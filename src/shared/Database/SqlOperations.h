@@ -21,11 +21,13 @@
 
 #include "Common.h"
 #include "Utilities/Callback.h"
+#include "Database/SqlStatistics.h"
 
 #include <queue>
 #include <vector>
 #include <mutex>
 #include <memory>
+#include <future>
 
 /// ---- BASE ---
 
@@ -40,6 +42,13 @@ class SqlOperation
         virtual void OnRemove() { delete this; }
         virtual bool Execute(SqlConnection* conn) = 0;
         virtual ~SqlOperation() {}
+
+        // restarts the queue wait measurement, called when the operation is put into a delay thread queue
+        void MarkQueued() { m_queueTimer = SqlStatistics::Timer(); }
+        SqlStatistics::Timer const& GetQueueTimer() const { return m_queueTimer; }
+
+    private:
+        SqlStatistics::Timer m_queueTimer;
 };
 
 /// ---- ASYNC STATEMENTS / TRANSACTIONS ----
@@ -54,6 +63,16 @@ class SqlPlainRequest : public SqlOperation
         bool Execute(SqlConnection* conn) override;
 };
 
+// executed once everything queued before it on the same delay thread is done, lets the queuing thread wait for its writes
+class SqlBarrierRequest : public SqlOperation
+{
+    private:
+        std::promise<void> m_done;
+    public:
+        explicit SqlBarrierRequest(std::promise<void>&& done) : m_done(std::move(done)) {}
+        bool Execute(SqlConnection* /*conn*/) override { m_done.set_value(); return true; }
+};
+
 class SqlTransaction : public SqlOperation
 {
     private:
@@ -18,6 +18,9 @@
 
 #include "DatabaseEnv.h"
 
+#include <iomanip>
+#include <limits>
+
 SqlStmtParameters::SqlStmtParameters(uint32 nParams)
 {
     // reserve memory if needed
@@ -83,6 +86,80 @@ bool SqlStatement::DirectExecute()
     return m_pDB->DirectExecuteStmt(m_index, args);
 }
 
+//////////////////////////////////////////////////////////////////////////
+// keep single statements well below the default max_allowed_packet of the server
+#define MAX_BATCH_INSERT_LEN (64*1024)
+
+SqlBatchInsert::SqlBatchInsert(Database& db, const char* insert, uint32 columns) :
+    m_db(db), m_szInsert(insert), m_nColumns(columns), m_nRowValues(0), m_nRows(0)
+{
+    m_szInsert += " VALUES ";
+}
+
+bool SqlBatchInsert::Execute()
+{
+    if (m_nRowValues)
+    {
+        sLog.outError("SQL ERROR: incomplete row in batched insert (%u of %u values)", m_nRowValues, m_nColumns);
+        sLog.outError("SQL ERROR: statement: %s", m_szInsert.c_str());
+        MANGOS_ASSERT(false);
+        return false;
+    }
+
+    if (!m_nRows)
+        return true;
+
+    bool const result = m_db.Execute(m_szRequest.c_str());
+    m_szRequest.clear();
+    m_nRows = 0;
+    return result;
+}
+
+void SqlBatchInsert::addValue(const SqlStmtFieldData& data)
+{
+    if (!m_nRowValues)
+        m_szRequest += m_nRows ? ",(" : m_szInsert + "(";
+    else
+        m_szRequest += ',';
+
+    std::ostringstream fmt;
+    switch (data.type())
+    {
+        case FIELD_BOOL:    fmt << "'" << uint32(data.toBool()) << "'";     break;
+        case FIELD_UI8:     fmt << "'" << uint32(data.toUint8()) << "'";    break;
+        case FIELD_UI16:    fmt << "'" << uint32(data.toUint16()) << "'";   break;
+        case FIELD_UI32:    fmt << "'" << data.toUint32() << "'";           break;
+        case FIELD_UI64:    fmt << "'" << data.toUint64() << "'";           break;
+        case FIELD_I8:      fmt << "'" << int32(data.toInt8()) << "'";      break;
+        case FIELD_I16:     fmt << "'" << int32(data.toInt16()) << "'";     break;
+        case FIELD_I32:     fmt << "'" << data.toInt32() << "'";            break;
+        case FIELD_I64:     fmt << "'" << data.toInt64() << "'";            break;
+        // full precision, the values are sent as text instead of a binary bound parameter
+        case FIELD_FLOAT:   fmt << "'" << std::setprecision(std::numeric_limits<float>::max_digits10) << data.toFloat() << "'";    break;
+        case FIELD_DOUBLE:  fmt << "'" << std::setprecision(std::numeric_limits<double>::max_digits10) << data.toDouble() << "'"; break;
+        case FIELD_STRING:
+        {
+            std::string tmp = data.toStr();
+            m_db.escape_string(tmp);
+            fmt << "'" << tmp << "'";
+            break;
+        }
+        case FIELD_NONE:                                                    break;
+        default: throw std::domain_error("Unrecognized sql data type");
+    }
+    m_szRequest += fmt.str();
+
+    if (++m_nRowValues < m_nColumns)
+        return;
+
+    m_szRequest += ')';
+    m_nRowValues = 0;
+    ++m_nRows;
+
+    if (m_szRequest.size() >= MAX_BATCH_INSERT_LEN)
+        Execute();
+}
+
 //////////////////////////////////////////////////////////////////////////
 SqlPlainPreparedStatement::SqlPlainPreparedStatement(const std::string& fmt, SqlConnection& conn) : SqlPreparedStatement(fmt, conn)
 {
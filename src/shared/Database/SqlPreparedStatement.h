@@ -294,6 +294,51 @@ class SqlStatement
         SqlStmtParameters* m_pParams;
 };
 
+// collects rows of one INSERT shape and sends them as multi-row INSERT statements
+// rows are closed automatically after 'columns' values, Execute() sends the pending rows (also done at destruction)
+// like SqlStatement::Execute() the statements join the current transaction of the database if there is one
+class SqlBatchInsert
+{
+    public:
+        // insert is the statement up to VALUES, like "INSERT INTO character_spell (guid,spell,active,disabled)"
+        SqlBatchInsert(Database& db, const char* insert, uint32 columns);
+        ~SqlBatchInsert() { Execute(); }
+
+        uint32 rows() const { return m_nRows; }
+
+        bool Execute();
+
+        void addBool(bool var) { arg(var); }
+        void addUInt8(uint8 var) { arg(var); }
+        void addInt8(int8 var) { arg(var); }
+        void addUInt16(uint16 var) { arg(var); }
+        void addInt16(int16 var) { arg(var); }
+        void addUInt32(uint32 var) { arg(var); }
+        void addInt32(int32 var) { arg(var); }
+        void addUInt64(uint64 var) { arg(var); }
+        void addInt64(int64 var) { arg(var); }
+        void addFloat(float var) { arg(var); }
+        void addDouble(double var) { arg(var); }
+        void addString(const char* var) { arg(var); }
+        void addString(const std::string& var) { arg(var.c_str()); }
+
+    private:
+        SqlBatchInsert(const SqlBatchInsert&);
+        SqlBatchInsert& operator=(const SqlBatchInsert&);
+
+        template<typename ParamType>
+        void arg(ParamType val) { addValue(SqlStmtFieldData(val)); }
+
+        void addValue(const SqlStmtFieldData& data);
+
+        Database& m_db;
+        std::string m_szInsert;
+        std::string m_szRequest;
+        uint32 m_nColumns;
+        uint32 m_nRowValues;                                // values of the currently open row
+        uint32 m_nRows;                                     // complete rows in m_szRequest
+};
+
 // base prepared statement class
 class SqlPreparedStatement
 {
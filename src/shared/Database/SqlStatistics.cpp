@@ -0,0 +1,177 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "Database/SqlStatistics.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <unordered_map>
+
+std::atomic<bool> SqlStatistics::m_enabled(false);
+
+namespace
+{
+    // long statements (multi row inserts) are cut, so they share one entry whatever their row count is
+    size_t const MAX_STATEMENT_KEY_LEN = 200;
+
+    struct StatementEntry
+    {
+        StatementEntry() : count(0), totalUs(0), maxUs(0), rows(0), buckets() {}
+
+        uint64 count;
+        uint64 totalUs;
+        uint64 maxUs;
+        uint64 rows;
+        uint64 buckets[SQL_STATISTICS_BUCKETS];
+    };
+
+    std::mutex statisticsLock;
+    std::unordered_map<std::string, StatementEntry> statistics;
+
+    uint32 GetBucket(uint64 us)
+    {
+        uint32 bucket = 0;
+        while (us > 1 && bucket < SQL_STATISTICS_BUCKETS - 1)
+        {
+            us >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    // upper bound of the bucket holding the given percentile, exact enough to tell 1ms from 100ms
+    uint64 GetPercentile(StatementEntry const& entry, uint32 percent)
+    {
+        uint64 const rank = (entry.count * percent + 99) / 100;
+        uint64 seen = 0;
+        for (uint32 i = 0; i < SQL_STATISTICS_BUCKETS; ++i)
+        {
+            seen += entry.buckets[i];
+            if (seen >= rank)
+                return std::min(uint64(2) << i, entry.maxUs);
+        }
+        return entry.maxUs;
+    }
+}
+
+std::string SqlStatistics::Normalize(char const* sql)
+{
+    std::string key;
+    key.reserve(MAX_STATEMENT_KEY_LEN);
+
+    for (char const* c = sql; *c && key.size() < MAX_STATEMENT_KEY_LEN; ++c)
+    {
+        if (*c == '\'' || *c == '"')
+        {
+            char const quote = *c;
+            while (*(c + 1) && *(c + 1) != quote)
+            {
+                if (*(c + 1) == '\\' && *(c + 2))
+                    ++c;
+                ++c;
+            }
+            if (*(c + 1))
+                ++c;
+            key += "'?'";
+            continue;
+        }
+
+        // numbers which are not part of an identifier like `spell1`
+        bool const identifierChar = !key.empty() && (isalnum(uint8(key.back())) || key.back() == '_');
+        if (isdigit(uint8(*c)) && !identifierChar)
+        {
+            while (isdigit(uint8(*(c + 1))) || *(c + 1) == '.')
+                ++c;
+            key += '?';
+            continue;
+        }
+
+        key += *c;
+    }
+
+    return key;
+}
+
+void SqlStatistics::RecordQuery(char const* sql, Timer const& timer, uint64 rows)
+{
+    if (timer.IsActive())
+        Record(Normalize(sql), timer.ElapsedUs(), rows);
+}
+
+void SqlStatistics::RecordStatement(std::string const& statement, Timer const& timer, uint64 rows)
+{
+    if (timer.IsActive())
+        Record(statement, timer.ElapsedUs(), rows);
+}
+
+void SqlStatistics::RecordQueueWait(uint64 us)
+{
+    if (IsEnabled())
+        Record(SQL_STATISTICS_QUEUE_WAIT, us, 0);
+}
+
+void SqlStatistics::Record(std::string const& statement, uint64 us, uint64 rows)
+{
+    std::lock_guard<std::mutex> guard(statisticsLock);
+
+    StatementEntry& entry = statistics[statement];
+    ++entry.count;
+    entry.totalUs += us;
+    entry.maxUs = std::max(entry.maxUs, us);
+    entry.rows += rows;
+    ++entry.buckets[GetBucket(us)];
+}
+
+void SqlStatistics::Reset()
+{
+    std::lock_guard<std::mutex> guard(statisticsLock);
+    statistics.clear();
+}
+
+std::vector<SqlStatistics::Summary> SqlStatistics::GetTopStatements(size_t count)
+{
+    std::vector<Summary> summaries;
+    {
+        std::lock_guard<std::mutex> guard(statisticsLock);
+        summaries.reserve(statistics.size());
+        for (auto const& itr : statistics)
+        {
+            StatementEntry const& entry = itr.second;
+            summaries.push_back({ itr.first, entry.count, entry.totalUs, entry.maxUs, entry.rows, GetPercentile(entry, 50), GetPercentile(entry, 99) });
+        }
+    }
+
+    std::sort(summaries.begin(), summaries.end(), [](Summary const& a, Summary const& b) { return a.totalUs > b.totalUs; });
+    if (summaries.size() > count)
+        summaries.resize(count);
+
+    return summaries;
+}
+
+void SqlStatistics::LogReport(size_t count)
+{
+    std::vector<Summary> summaries = GetTopStatements(count);
+    if (summaries.empty())
+        return;
+
+    sLog.outString("SQL statistics, top " SIZEFMTD " statements by total time:", summaries.size());
+    for (Summary const& summary : summaries)
+        sLog.outString("%8" PRIu64 " calls %8" PRIu64 " ms total p50 " UI64FMTD " us p99 " UI64FMTD " us max " UI64FMTD " us " UI64FMTD " rows: %s",
+                       summary.count, summary.totalUs / 1000, summary.p50Us, summary.p99Us, summary.maxUs, summary.rows, summary.statement.c_str());
+}
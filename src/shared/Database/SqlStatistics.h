@@ -0,0 +1,86 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SQL_STATISTICS_H
+#define SQL_STATISTICS_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#define SQL_STATISTICS_BUCKETS 24                           // log2 microsecond buckets, the last one is open ended
+#define SQL_STATISTICS_QUEUE_WAIT "[async queue wait]"
+#define SQL_STATISTICS_QUERY_BATCH "[query holder batch]"
+
+// Per statement execution statistics of all database connections, collected while enabled.
+// Plain queries are keyed by their text with literals replaced by '?', prepared statements by their format.
+class SqlStatistics
+{
+    public:
+        struct Summary
+        {
+            std::string statement;
+            uint64 count;
+            uint64 totalUs;
+            uint64 maxUs;
+            uint64 rows;
+            uint64 p50Us;
+            uint64 p99Us;
+        };
+
+        // measures one execution, inactive when statistics were disabled at construction
+        class Timer
+        {
+            public:
+                Timer() : m_active(IsEnabled()) { if (m_active) m_start = std::chrono::steady_clock::now(); }
+
+                bool IsActive() const { return m_active; }
+                uint64 ElapsedUs() const { return uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count()); }
+
+            private:
+                bool m_active;
+                std::chrono::steady_clock::time_point m_start;
+        };
+
+        static void SetEnabled(bool enabled) { m_enabled = enabled; }
+        static bool IsEnabled() { return m_enabled; }
+
+        // plain sql text, normalized before it is used as key
+        static void RecordQuery(char const* sql, Timer const& timer, uint64 rows);
+        // prepared statement format or other already normalized key
+        static void RecordStatement(std::string const& statement, Timer const& timer, uint64 rows);
+        // time an async request spent in a SqlDelayThread queue before execution
+        static void RecordQueueWait(uint64 us);
+
+        static void Reset();
+
+        // statements ordered by total execution time
+        static std::vector<Summary> GetTopStatements(size_t count);
+        static void LogReport(size_t count);
+
+        static std::string Normalize(char const* sql);
+
+    private:
+        static void Record(std::string const& statement, uint64 us, uint64 rows);
+
+        static std::atomic<bool> m_enabled;
+};
+
+#endif
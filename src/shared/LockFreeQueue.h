@@ -0,0 +1,118 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _LOCK_FREE_QUEUE_H
+#define _LOCK_FREE_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Bounded lock free queue, safe for any number of producers and consumers.
+// Every cell carries a sequence number telling whether it is free for the producer
+// of a given lap or filled for its consumer, so neither side ever waits on the other.
+// Size must be a power of two.
+template <typename T, size_t Size>
+class LockFreeQueue
+{
+        static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "LockFreeQueue size must be a power of two");
+
+    public:
+        LockFreeQueue() : m_enqueuePos(0), m_dequeuePos(0)
+        {
+            for (size_t i = 0; i < Size; ++i)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        LockFreeQueue(const LockFreeQueue&) = delete;
+        LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+        // returns false when the queue is full, value is left untouched then
+        bool Push(T&& value)
+        {
+            Cell* cell;
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                cell = &m_cells[pos & (Size - 1)];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // returns false when the queue is empty
+        bool Pop(T& value)
+        {
+            Cell* cell;
+            size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                cell = &m_cells[pos & (Size - 1)];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1);
+
+                if (diff == 0)
+                {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+
+            value = std::move(cell->value);
+            cell->sequence.store(pos + Size, std::memory_order_release);
+            return true;
+        }
+
+        // only a hint while other threads push or pop
+        bool Empty() const { return m_dequeuePos.load(std::memory_order_acquire) == m_enqueuePos.load(std::memory_order_acquire); }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        // keep producer and consumer positions on separate cache lines
+        Cell m_cells[Size];
+        std::atomic<size_t> m_enqueuePos;
+        char m_pad[64 - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> m_dequeuePos;
+};
+
+#endif
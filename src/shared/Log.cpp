@@ -23,7 +23,10 @@
 #include "Util.h"
 #include "ByteBuffer.h"
 #include "ProgressBar.h"
+#include "Threading.h"
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <thread>
@@ -67,7 +70,8 @@ const int LogType_count = int(LogError) + 1;
 
 Log::Log() :
     raLogfile(nullptr), logfile(nullptr), gmLogfile(nullptr), charLogfile(nullptr), dberLogfile(nullptr),
-    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
+    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_worldLogMtx("Log::m_worldLogMtx"), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr),
+    m_async(false), m_asyncRunning(false), m_asyncQueuedBytes(0), m_asyncDropped(0)
 {
     Initialize();
 }
@@ -282,6 +286,9 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    if (sConfig.GetBoolDefault("LogAsync", false))
+        StartAsyncWriter();
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -314,7 +321,11 @@ FILE* Log::openGmlogPerAccount(uint32 account)
 
 void Log::outTimestamp(FILE* file)
 {
-    time_t t = time(nullptr);
+    outTimestamp(file, time(nullptr));
+}
+
+void Log::outTimestamp(FILE* file, time_t t)
+{
     tm* aTm = localtime(&t);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
@@ -353,9 +364,274 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
+namespace
+{
+    size_t const ASYNC_RING_SIZE          = 1024;          // records per logging thread
+    uint64 const ASYNC_MAX_QUEUED_BYTES   = 64 * 1024 * 1024;
+
+    void FormatAppend(std::string& out, const char* str, va_list ap)
+    {
+        va_list size_ap;
+        va_copy(size_ap, ap);
+        int size = vsnprintf(nullptr, 0, str, size_ap);
+        va_end(size_ap);
+        if (size <= 0)
+            return;
+
+        size_t offset = out.size();
+        out.resize(offset + size + 1);
+        vsnprintf(&out[offset], size + 1, str, ap);
+        out.resize(offset + size);
+    }
+}
+
+struct Log::AsyncRecord
+{
+    AsyncRecord() : file(nullptr), color(-1), time(0), incoming(false), opcode(0), opcodeName(nullptr) {}
+
+    FILE* file;                                             // nullptr for the console
+    int32 color;                                            // console color, -1 for none
+    time_t time;
+    std::string text;
+    // packet dumps are formatted by the writer thread, text is the socket
+    std::vector<uint8> packet;
+    bool incoming;
+    uint32 opcode;
+    char const* opcodeName;                                 // static opcode table name
+};
+
+// Single producer single consumer ring, the producer thread never waits and drops records when it is full
+class Log::AsyncRing
+{
+    public:
+        AsyncRing() : m_records(ASYNC_RING_SIZE), m_head(0), m_tail(0) {}
+
+        bool Push(AsyncRecord& record)
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            size_t next = (head + 1) % ASYNC_RING_SIZE;
+            if (next == m_tail.load(std::memory_order_acquire))
+                return false;
+
+            m_records[head] = std::move(record);
+            m_head.store(next, std::memory_order_release);
+            return true;
+        }
+
+        bool Pop(AsyncRecord& record)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_head.load(std::memory_order_acquire))
+                return false;
+
+            // moved out so a drained ring keeps no memory of large messages
+            record = std::move(m_records[tail]);
+            m_records[tail] = AsyncRecord();
+            m_tail.store((tail + 1) % ASYNC_RING_SIZE, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::vector<AsyncRecord> m_records;
+        std::atomic<size_t> m_head;                         // next slot the producer fills
+        std::atomic<size_t> m_tail;                         // next slot the writer empties
+};
+
+void Log::StartAsyncWriter()
+{
+    if (m_async)
+        return;
+
+    m_asyncRunning = true;
+    m_asyncThread = std::thread(&Log::AsyncWriterLoop, this);
+    m_async = true;
+}
+
+void Log::StopAsyncWriter()
+{
+    if (!m_async)
+        return;
+
+    // the writer drains every ring before it exits
+    m_asyncRunning = false;
+    m_asyncThread.join();
+    m_async = false;
+}
+
+bool Log::QueueAsync(AsyncRecord& record)
+{
+    static thread_local std::shared_ptr<AsyncRing> ring;
+    if (!ring)
+    {
+        ring = std::make_shared<AsyncRing>();
+        std::lock_guard<std::mutex> guard(m_asyncRingsLock);
+        m_asyncRings.push_back(ring);
+    }
+
+    uint64 bytes = record.text.size() + record.packet.size();
+    if (m_asyncQueuedBytes.load(std::memory_order_relaxed) + bytes > ASYNC_MAX_QUEUED_BYTES || !ring->Push(record))
+    {
+        m_asyncDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_asyncQueuedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    return true;
+}
+
+void Log::QueueFileAsync(FILE* file, char const* prefix, const char* str, va_list ap)
+{
+    AsyncRecord record;
+    record.file = file;
+    record.time = time(nullptr);
+    if (prefix)
+        record.text = prefix;
+    FormatAppend(record.text, str, ap);
+    QueueAsync(record);
+}
+
+void Log::QueueLevelAsync(LogLevel level, uint32 type, const char* str, va_list ap)
+{
+    bool toConsole = m_logLevel >= level;
+    bool toFile = logfile && m_logFileLevel >= level;
+    if (!toConsole && !toFile)
+        return;
+
+    // formatted once for both outputs
+    AsyncRecord record;
+    record.time = time(nullptr);
+    FormatAppend(record.text, str, ap);
+
+    if (toFile)
+    {
+        AsyncRecord fileRecord;
+        fileRecord.file = logfile;
+        fileRecord.time = record.time;
+        fileRecord.text = toConsole ? record.text : std::move(record.text);
+        QueueAsync(fileRecord);
+    }
+
+    if (toConsole)
+    {
+        record.color = m_colored ? int32(m_colors[type]) : -1;
+        QueueAsync(record);
+    }
+}
+
+void Log::WriteAsyncRecord(AsyncRecord& record, std::vector<FILE*>& flushFiles)
+{
+    if (!record.file)
+    {
+        if (record.color >= 0)
+            SetColor(true, Color(record.color));
+
+        if (m_includeTime)
+        {
+            tm* aTm = localtime(&record.time);
+            printf("%02d:%02d:%02d ", aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+        }
+
+        utf8printf(stdout, "%s", record.text.c_str());
+
+        if (record.color >= 0)
+            ResetColor(true);
+
+        printf("\n");
+        record.file = stdout;
+    }
+    else if (record.opcodeName)
+    {
+        outTimestamp(worldLogfile, record.time);
+
+        fprintf(worldLogfile, "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
+                record.incoming ? "CLIENT" : "SERVER",
+                record.text.c_str(), static_cast<uint32>(record.packet.size()), record.opcodeName, record.opcode);
+
+        size_t p = 0;
+        while (p < record.packet.size())
+        {
+            for (size_t j = 0; j < 16 && p < record.packet.size(); ++j)
+                fprintf(worldLogfile, "%.2X ", record.packet[p++]);
+
+            fprintf(worldLogfile, "\n");
+        }
+
+        fprintf(worldLogfile, "\n\n");
+    }
+    else
+    {
+        outTimestamp(record.file, record.time);
+        fprintf(record.file, "%s\n", record.text.c_str());
+    }
+
+    if (std::find(flushFiles.begin(), flushFiles.end(), record.file) == flushFiles.end())
+        flushFiles.push_back(record.file);
+}
+
+void Log::AsyncWriterLoop()
+{
+    MaNGOS::Thread::SetCurrentThreadName("log");
+
+    std::vector<std::shared_ptr<AsyncRing>> rings;
+    std::vector<FILE*> flushFiles;
+    uint64 droppedReported = 0;
+
+    while (true)
+    {
+        bool running = m_asyncRunning.load();
+
+        {
+            std::lock_guard<std::mutex> guard(m_asyncRingsLock);
+            rings = m_asyncRings;
+        }
+
+        bool written = false;
+        AsyncRecord record;
+        for (std::shared_ptr<AsyncRing> const& ring : rings)
+        {
+            while (ring->Pop(record))
+            {
+                m_asyncQueuedBytes.fetch_sub(record.text.size() + record.packet.size(), std::memory_order_relaxed);
+
+                // the synchronous output of other messages is not interleaved with a record
+                std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
+                WriteAsyncRecord(record, flushFiles);
+                written = true;
+            }
+        }
+
+        {
+            std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
+
+            uint64 dropped = m_asyncDropped.load(std::memory_order_relaxed);
+            if (dropped != droppedReported && logfile)
+            {
+                outTimestamp(logfile);
+                fprintf(logfile, "ERROR:" UI64FMTD " log messages dropped, the asynchronous log queues were full\n", dropped - droppedReported);
+                droppedReported = dropped;
+                if (std::find(flushFiles.begin(), flushFiles.end(), logfile) == flushFiles.end())
+                    flushFiles.push_back(logfile);
+            }
+
+            // one flush per file and batch instead of one per message
+            for (FILE* file : flushFiles)
+                fflush(file);
+            flushFiles.clear();
+        }
+
+        if (!written)
+        {
+            if (!running)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
 void Log::outString()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (m_includeTime)
         outTime();
     printf("\n");
@@ -374,7 +650,7 @@ void Log::outString(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
 
     if (m_colored)
         SetColor(true, m_colors[LogNormal]);
@@ -395,14 +671,17 @@ void Log::outString(const char* str, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        if (m_async)
+            QueueFileAsync(logfile, nullptr, str, ap);
+        else
+        {
+            outTimestamp(logfile);
+            vfprintf(logfile, str, ap);
+            fprintf(logfile, "\n");
+            fflush(logfile);
+        }
         va_end(ap);
-
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -413,7 +692,7 @@ void Log::outError(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
 
     if (m_colored)
         SetColor(false, m_colors[LogError]);
@@ -433,15 +712,18 @@ void Log::outError(const char* err, ...)
     fprintf(stderr, "\n");
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        if (m_async)
+            QueueFileAsync(logfile, "ERROR:", err, ap);
+        else
+        {
+            outTimestamp(logfile);
+            fprintf(logfile, "ERROR:");
+            vfprintf(logfile, err, ap);
+            fprintf(logfile, "\n");
+            fflush(logfile);
+        }
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stderr);
@@ -449,7 +731,7 @@ void Log::outError(const char* err, ...)
 
 void Log::outErrorDb()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
 
     if (m_includeTime)
         outTime();
@@ -478,7 +760,7 @@ void Log::outErrorDb(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
 
     if (m_colored)
         SetColor(false, m_colors[LogError]);
@@ -499,28 +781,33 @@ void Log::outErrorDb(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        if (m_async)
+            QueueFileAsync(logfile, "ERROR:", err, ap);
+        else
+        {
+            outTimestamp(logfile);
+            fprintf(logfile, "ERROR:");
+            vfprintf(logfile, err, ap);
+            fprintf(logfile, "\n");
+            fflush(logfile);
+        }
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (dberLogfile)
     {
-        outTimestamp(dberLogfile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
+        if (m_async)
+            QueueFileAsync(dberLogfile, nullptr, err, ap);
+        else
+        {
+            outTimestamp(dberLogfile);
+            vfprintf(dberLogfile, err, ap);
+            fprintf(dberLogfile, "\n");
+            fflush(dberLogfile);
+        }
         va_end(ap);
-
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
     }
 
     fflush(stderr);
@@ -528,7 +815,7 @@ void Log::outErrorDb(const char* err, ...)
 
 void Log::outErrorEventAI()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
 
     if (m_includeTime)
         outTime();
@@ -557,7 +844,7 @@ void Log::outErrorEventAI(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (m_colored)
         SetColor(false, m_colors[LogError]);
 
@@ -609,7 +896,16 @@ void Log::outBasic(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (m_async)
+    {
+        va_list ap;
+        va_start(ap, str);
+        QueueLevelAsync(LOG_LVL_BASIC, LogDetails, str, ap);
+        va_end(ap);
+        return;
+    }
+
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_BASIC)
     {
         if (m_colored)
@@ -648,7 +944,16 @@ void Log::outDetail(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (m_async)
+    {
+        va_list ap;
+        va_start(ap, str);
+        QueueLevelAsync(LOG_LVL_DETAIL, LogDetails, str, ap);
+        va_end(ap);
+        return;
+    }
+
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_DETAIL)
     {
         if (m_colored)
@@ -689,7 +994,16 @@ void Log::outDebug(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (m_async)
+    {
+        va_list ap;
+        va_start(ap, str);
+        QueueLevelAsync(LOG_LVL_DEBUG, LogDebug, str, ap);
+        va_end(ap);
+        return;
+    }
+
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_DEBUG)
     {
         if (m_colored)
@@ -730,7 +1044,7 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_DETAIL)
     {
         if (m_colored)
@@ -793,7 +1107,7 @@ void Log::outChar(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (charLogfile)
     {
         va_list ap;
@@ -808,7 +1122,7 @@ void Log::outChar(const char* str, ...)
 
 void Log::outErrorScriptLib()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (m_includeTime)
         outTime();
 
@@ -839,7 +1153,7 @@ void Log::outErrorScriptLib(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (m_colored)
         SetColor(false, m_colors[LogError]);
 
@@ -894,7 +1208,22 @@ void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opco
     if (!worldLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (m_async)
+    {
+        AsyncRecord record;
+        record.file = worldLogfile;
+        record.time = time(nullptr);
+        record.text = socket;
+        if (packet.size())
+            record.packet.assign(packet.contents(), packet.contents() + packet.size());
+        record.incoming = incoming;
+        record.opcode = opcode;
+        record.opcodeName = opcodeName;
+        QueueAsync(record);
+        return;
+    }
+
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
 
     outTimestamp(worldLogfile);
 
@@ -917,7 +1246,7 @@ void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opco
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
 
     if (charLogfile)
     {
@@ -931,7 +1260,7 @@ void Log::outRALog(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (raLogfile)
     {
         va_list ap;
@@ -951,7 +1280,7 @@ void Log::outCustomLog(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::lock_guard<ProfiledMutex> guard(m_worldLogMtx);
     if (customLogFile)
     {
         va_list ap;
@@ -21,8 +21,15 @@
 
 #include "Common.h"
 #include "Policies/Singleton.h"
+#include "ProfiledMutex.h"
 
+#include <atomic>
+#include <cstdarg>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 class Config;
 class ByteBuffer;
@@ -99,6 +106,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
 
         ~Log()
         {
+            StopAsyncWriter();
+
             if (logfile != nullptr)
                 fclose(logfile);
             logfile = nullptr;
@@ -178,12 +187,15 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         void ResetColor(bool stdout_stream);
         void outTime() const;
         static void outTimestamp(FILE* file);
+        static void outTimestamp(FILE* file, time_t t);
         static std::string GetTimestampStr();
         bool HasLogFilter(uint32 filter) const { return (m_logFilter & filter) != 0; }
         void SetLogFilter(LogFilters filter, bool on) { if (on) m_logFilter |= filter; else m_logFilter &= ~filter; }
         bool HasLogLevelOrHigher(LogLevel loglvl) const { return m_logLevel >= loglvl || (m_logFileLevel >= loglvl && logfile); }
         bool IsOutCharDump() const { return m_charLog_Dump; }
         bool IsIncludeTime() const { return m_includeTime; }
+        // messages lost because the queues of the asynchronous writer were full, see LogAsync
+        uint64 GetAsyncDroppedCount() const { return m_asyncDropped; }
 
         static void WaitBeforeContinueIfNeed();
 
@@ -194,6 +206,18 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
+        // Asynchronous writer, every logging thread fills its own ring that only the writer thread empties
+        struct AsyncRecord;
+        class AsyncRing;
+
+        void StartAsyncWriter();
+        void StopAsyncWriter();
+        void AsyncWriterLoop();
+        bool QueueAsync(AsyncRecord& record);
+        void QueueFileAsync(FILE* file, char const* prefix, const char* str, va_list ap);
+        void QueueLevelAsync(LogLevel level, uint32 type, const char* str, va_list ap);
+        void WriteAsyncRecord(AsyncRecord& record, std::vector<FILE*>& flushFiles);
+
         FILE* raLogfile;
         FILE* logfile;
         FILE* gmLogfile;
@@ -203,7 +227,7 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         FILE* scriptErrLogFile;
         FILE* worldLogfile;
         FILE* customLogFile;
-        std::mutex m_worldLogMtx;
+        ProfiledMutex m_worldLogMtx;
 
         // log/console control
         LogLevel m_logLevel;
@@ -225,6 +249,15 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         std::string m_gmlog_filename_format;
 
         char const* m_scriptLibName;
+
+        // asynchronous writer control
+        bool m_async;
+        std::atomic<bool> m_asyncRunning;
+        std::thread m_asyncThread;
+        std::mutex m_asyncRingsLock;                        // taken once by every thread to register its ring
+        std::vector<std::shared_ptr<AsyncRing>> m_asyncRings;
+        std::atomic<uint64> m_asyncQueuedBytes;
+        std::atomic<uint64> m_asyncDropped;
 };
 
 #define sLog MaNGOS::Singleton<Log>::Instance()
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "MemoryTracker.h"
+#include "Log.h"
+#include "Metrics/Metrics.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+std::atomic<int64> MemoryTracker::m_bytes[MAX_MEMORY_TAG];
+std::atomic<int64> MemoryTracker::m_counts[MAX_MEMORY_TAG];
+
+char const* MemoryTracker::GetTagName(MemoryTag tag)
+{
+    static char const* const names[MAX_MEMORY_TAG] =
+    {
+        "mmap", "vmap", "terrain", "sqlstorage", "dbc", "players", "creatures", "gameobjects", "items", "otherobjects", "loot", "auctions", "mail"
+    };
+
+    return tag < MAX_MEMORY_TAG ? names[tag] : "unknown";
+}
+
+uint64 MemoryTracker::GetResidentBytes()
+{
+#if defined(__linux__)
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file)
+        return 0;
+
+    unsigned long size = 0, resident = 0;
+    int const read = fscanf(file, "%lu %lu", &size, &resident);
+    fclose(file);
+
+    return read == 2 ? uint64(resident) * uint64(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+
+void MemoryTracker::AddMetrics()
+{
+    std::vector<Metrics::Gauge*> bytes, counts;
+    for (uint32 i = 0; i < MAX_MEMORY_TAG; ++i)
+    {
+        std::string const labels = std::string("subsystem=\"") + GetTagName(MemoryTag(i)) + "\"";
+        bytes.push_back(&Metrics::GetGauge("mangos_memory_bytes", "Tracked bytes per subsystem", labels));
+        counts.push_back(&Metrics::GetGauge("mangos_memory_allocations", "Tracked allocations or objects per subsystem", labels));
+    }
+
+    Metrics::Gauge& resident = Metrics::GetGauge("mangos_memory_resident_bytes", "Resident set size of the process");
+
+    Metrics::AddCollector([bytes, counts, &resident]()
+    {
+        for (uint32 i = 0; i < MAX_MEMORY_TAG; ++i)
+        {
+            bytes[i]->Set(GetBytes(MemoryTag(i)));
+            counts[i]->Set(GetCount(MemoryTag(i)));
+        }
+        resident.Set(int64(GetResidentBytes()));
+    });
+}
+
+void MemoryTracker::LogReport()
+{
+    int64 total = 0;
+    for (uint32 i = 0; i < MAX_MEMORY_TAG; ++i)
+    {
+        MemoryTag const tag = MemoryTag(i);
+        total += GetBytes(tag);
+        sLog.outString("  %-12s " SI64FMTD " KB in " SI64FMTD " allocations", GetTagName(tag), GetBytes(tag) / 1024, GetCount(tag));
+    }
+
+    sLog.outString("  tracked " SI64FMTD " KB, resident " UI64FMTD " KB", total / 1024, GetResidentBytes() / 1024);
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_MEMORYTRACKER_H
+#define MANGOS_MEMORYTRACKER_H
+
+#include "Common.h"
+
+#include <atomic>
+
+enum MemoryTag
+{
+    MEMORY_TAG_MMAP             = 0,                        // navmesh tile data, heap or mapped
+    MEMORY_TAG_VMAP             = 1,                        // world model files of the loaded model instances
+    MEMORY_TAG_TERRAIN          = 2,                        // GridMap height, area and liquid data
+    MEMORY_TAG_SQL_STORAGE      = 3,                        // SQLStorage records, index arrays and string pools
+    MEMORY_TAG_DBC              = 4,                        // DBC records, index and string pools
+    MEMORY_TAG_PLAYERS          = 5,
+    MEMORY_TAG_CREATURES        = 6,
+    MEMORY_TAG_GAMEOBJECTS      = 7,
+    MEMORY_TAG_ITEMS            = 8,
+    MEMORY_TAG_OTHER_OBJECTS    = 9,                        // dynamic objects and corpses
+    MEMORY_TAG_LOOT             = 10,
+    MEMORY_TAG_AUCTIONS         = 11,
+    MEMORY_TAG_MAIL             = 12,
+    MAX_MEMORY_TAG
+};
+
+// Bytes and allocation counts per subsystem, kept by the owners of the big allocations when they load and free them.
+// The figures are the payload the owner knows about, container overhead and allocator slack are not included,
+// so the sum is a lower bound of the process size and the distance to it is the untracked remainder.
+class MemoryTracker
+{
+    public:
+        static void Add(MemoryTag tag, size_t bytes)
+        {
+            m_bytes[tag].fetch_add(int64(bytes), std::memory_order_relaxed);
+            m_counts[tag].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void Remove(MemoryTag tag, size_t bytes)
+        {
+            m_bytes[tag].fetch_sub(int64(bytes), std::memory_order_relaxed);
+            m_counts[tag].fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // size changes of an already counted allocation
+        static void Grow(MemoryTag tag, size_t bytes) { m_bytes[tag].fetch_add(int64(bytes), std::memory_order_relaxed); }
+        static void Shrink(MemoryTag tag, size_t bytes) { m_bytes[tag].fetch_sub(int64(bytes), std::memory_order_relaxed); }
+
+        static int64 GetBytes(MemoryTag tag) { return m_bytes[tag].load(std::memory_order_relaxed); }
+        static int64 GetCount(MemoryTag tag) { return m_counts[tag].load(std::memory_order_relaxed); }
+        static char const* GetTagName(MemoryTag tag);
+
+        // resident set size of the process, 0 where it can not be read
+        static uint64 GetResidentBytes();
+
+        // exports the tags as mangos_memory_bytes and mangos_memory_allocations gauges on every metrics scrape
+        static void AddMetrics();
+
+        static void LogReport();
+
+    private:
+        static std::atomic<int64> m_bytes[MAX_MEMORY_TAG];
+        static std::atomic<int64> m_counts[MAX_MEMORY_TAG];
+};
+
+// Counts one object of the tag for the lifetime of the member, sized like the owning class
+template<MemoryTag Tag, class T>
+class TrackedMemory
+{
+    public:
+        TrackedMemory() { MemoryTracker::Add(Tag, sizeof(T)); }
+        TrackedMemory(TrackedMemory const&) { MemoryTracker::Add(Tag, sizeof(T)); }
+        ~TrackedMemory() { MemoryTracker::Remove(Tag, sizeof(T)); }
+        TrackedMemory& operator=(TrackedMemory const&) { return *this; }
+};
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Metrics.h"
+#include "Errors.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace
+{
+    enum MetricType
+    {
+        METRIC_COUNTER,
+        METRIC_GAUGE,
+        METRIC_HISTOGRAM
+    };
+
+    struct MetricSeries
+    {
+        std::unique_ptr<Metrics::Counter> counter;
+        std::unique_ptr<Metrics::Gauge> gauge;
+        std::unique_ptr<Metrics::Histogram> histogram;
+    };
+
+    struct MetricFamily
+    {
+        MetricType type;
+        std::string help;
+        std::map<std::string, MetricSeries> series;         // by label set
+    };
+
+    std::mutex s_metricsLock;
+    std::mutex s_collectorsLock;
+
+    std::vector<std::function<void()>>& GetCollectors()
+    {
+        static std::vector<std::function<void()>> collectors;
+        return collectors;
+    }
+
+    std::map<std::string, MetricFamily>& GetFamilies()
+    {
+        static std::map<std::string, MetricFamily> families;
+        return families;
+    }
+
+    MetricSeries& GetSeries(char const* name, char const* help, MetricType type, std::string const& labels)
+    {
+        auto result = GetFamilies().emplace(name, MetricFamily());
+        MetricFamily& family = result.first->second;
+        if (result.second)
+        {
+            family.type = type;
+            family.help = help;
+        }
+
+        // one name is one metric type, mixing them would render an invalid exposition
+        MANGOS_ASSERT(family.type == type);
+        return family.series[labels];
+    }
+
+    std::string JoinLabels(std::string const& labels, std::string const& extra)
+    {
+        if (labels.empty())
+            return extra.empty() ? std::string() : "{" + extra + "}";
+
+        return extra.empty() ? "{" + labels + "}" : "{" + labels + "," + extra + "}";
+    }
+}
+
+std::atomic<bool> Metrics::m_enabled(false);
+
+Metrics::Histogram::Histogram(std::vector<uint64> const& bounds) :
+    m_bounds(bounds), m_buckets(new std::atomic<uint64>[bounds.size()]), m_count(0), m_sum(0)
+{
+    for (size_t i = 0; i < m_bounds.size(); ++i)
+        m_buckets[i].store(0, std::memory_order_relaxed);
+}
+
+void Metrics::Histogram::Observe(uint64 value)
+{
+    // only the first bound at or above the value counts it, the exposition sums them up
+    size_t const index = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+    if (index < m_bounds.size())
+        m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+Metrics::Counter& Metrics::GetCounter(char const* name, char const* help, std::string const& labels)
+{
+    std::lock_guard<std::mutex> guard(s_metricsLock);
+    MetricSeries& series = GetSeries(name, help, METRIC_COUNTER, labels);
+    if (!series.counter)
+        series.counter.reset(new Counter());
+    return *series.counter;
+}
+
+Metrics::Gauge& Metrics::GetGauge(char const* name, char const* help, std::string const& labels)
+{
+    std::lock_guard<std::mutex> guard(s_metricsLock);
+    MetricSeries& series = GetSeries(name, help, METRIC_GAUGE, labels);
+    if (!series.gauge)
+        series.gauge.reset(new Gauge());
+    return *series.gauge;
+}
+
+Metrics::Histogram& Metrics::GetHistogram(char const* name, char const* help, std::vector<uint64> const& bounds, std::string const& labels)
+{
+    std::lock_guard<std::mutex> guard(s_metricsLock);
+    MetricSeries& series = GetSeries(name, help, METRIC_HISTOGRAM, labels);
+    if (!series.histogram)
+        series.histogram.reset(new Histogram(bounds));
+    return *series.histogram;
+}
+
+std::vector<uint64> const& Metrics::DurationBoundsMs()
+{
+    static std::vector<uint64> const bounds = { 1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000 };
+    return bounds;
+}
+
+void Metrics::AddCollector(std::function<void()> const& collector)
+{
+    std::lock_guard<std::mutex> guard(s_collectorsLock);
+    GetCollectors().push_back(collector);
+}
+
+std::string Metrics::Render()
+{
+    static char const* const typeNames[] = { "counter", "gauge", "histogram" };
+
+    // collectors register their series through the getters, so they run before the registry is locked
+    {
+        std::lock_guard<std::mutex> guard(s_collectorsLock);
+        for (auto const& collector : GetCollectors())
+            collector();
+    }
+
+    std::ostringstream ss;
+
+    std::lock_guard<std::mutex> guard(s_metricsLock);
+    for (auto const& familyItr : GetFamilies())
+    {
+        std::string const& name = familyItr.first;
+        MetricFamily const& family = familyItr.second;
+
+        ss << "# HELP " << name << " " << family.help << "\n";
+        ss << "# TYPE " << name << " " << typeNames[family.type] << "\n";
+
+        for (auto const& seriesItr : family.series)
+        {
+            std::string const& labels = seriesItr.first;
+            MetricSeries const& series = seriesItr.second;
+
+            switch (family.type)
+            {
+                case METRIC_COUNTER:
+                    ss << name << JoinLabels(labels, "") << " " << series.counter->Get() << "\n";
+                    break;
+                case METRIC_GAUGE:
+                    ss << name << JoinLabels(labels, "") << " " << series.gauge->Get() << "\n";
+                    break;
+                case METRIC_HISTOGRAM:
+                {
+                    Histogram const& histogram = *series.histogram;
+                    std::vector<uint64> const& bounds = histogram.GetBounds();
+                    uint64 cumulative = 0;
+                    for (size_t i = 0; i < bounds.size(); ++i)
+                    {
+                        std::ostringstream le;
+                        le << "le=\"" << bounds[i] << "\"";
+                        cumulative += histogram.GetBucket(i);
+                        ss << name << "_bucket" << JoinLabels(labels, le.str()) << " " << cumulative << "\n";
+                    }
+                    ss << name << "_bucket" << JoinLabels(labels, "le=\"+Inf\"") << " " << histogram.GetCount() << "\n";
+                    ss << name << "_sum" << JoinLabels(labels, "") << " " << histogram.GetSum() << "\n";
+                    ss << name << "_count" << JoinLabels(labels, "") << " " << histogram.GetCount() << "\n";
+                    break;
+                }
+            }
+        }
+    }
+
+    return ss.str();
+}
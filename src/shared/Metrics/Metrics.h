@@ -0,0 +1,105 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_METRICS_H
+#define MANGOS_METRICS_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Process wide counters, gauges and histograms, rendered in the Prometheus text exposition format.
+// Metrics are registered once by name and label set and live until the process exits, so callers keep the
+// returned reference in a function local static and only pay an atomic add per update. Updates are skipped while
+// disabled, which is the case unless a metrics endpoint was configured.
+class Metrics
+{
+    public:
+        // monotonically increasing value, e.g. bytes sent
+        class Counter
+        {
+            public:
+                Counter() : m_value(0) {}
+
+                void Add(uint64 value = 1) { m_value.fetch_add(value, std::memory_order_relaxed); }
+                uint64 Get() const { return m_value.load(std::memory_order_relaxed); }
+
+            private:
+                std::atomic<uint64> m_value;
+        };
+
+        // value that goes up and down, e.g. open sockets
+        class Gauge
+        {
+            public:
+                Gauge() : m_value(0) {}
+
+                void Set(int64 value) { m_value.store(value, std::memory_order_relaxed); }
+                void Add(int64 value) { m_value.fetch_add(value, std::memory_order_relaxed); }
+                int64 Get() const { return m_value.load(std::memory_order_relaxed); }
+
+            private:
+                std::atomic<int64> m_value;
+        };
+
+        // distribution of integral observations over fixed upper bounds, e.g. tick time in ms
+        class Histogram
+        {
+            public:
+                explicit Histogram(std::vector<uint64> const& bounds);
+
+                void Observe(uint64 value);
+
+                std::vector<uint64> const& GetBounds() const { return m_bounds; }
+                uint64 GetBucket(size_t index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+                uint64 GetCount() const { return m_count.load(std::memory_order_relaxed); }
+                uint64 GetSum() const { return m_sum.load(std::memory_order_relaxed); }
+
+            private:
+                std::vector<uint64> m_bounds;                   // ascending, values above the last one only count in m_count
+                std::unique_ptr<std::atomic<uint64>[]> m_buckets;
+                std::atomic<uint64> m_count;
+                std::atomic<uint64> m_sum;
+        };
+
+        static void SetEnabled(bool enabled) { m_enabled = enabled; }
+        static bool IsEnabled() { return m_enabled; }
+
+        // labels are given preformatted, e.g. "database=\"world\"", and must be the same for every lookup of one series
+        static Counter& GetCounter(char const* name, char const* help, std::string const& labels = "");
+        static Gauge& GetGauge(char const* name, char const* help, std::string const& labels = "");
+        static Histogram& GetHistogram(char const* name, char const* help, std::vector<uint64> const& bounds, std::string const& labels = "");
+
+        // default bounds for durations in milliseconds
+        static std::vector<uint64> const& DurationBoundsMs();
+
+        // run on the scraping thread right before every Render, for values cheaper to read on a scrape than to keep updated
+        static void AddCollector(std::function<void()> const& collector);
+
+        static std::string Render();
+
+    private:
+        static std::atomic<bool> m_enabled;
+};
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "MetricsSocket.h"
+#include "Metrics.h"
+#include "Log.h"
+
+#include <sstream>
+
+#define METRICS_MAX_REQUEST_SIZE 8192                       // headers of a scrape are a few hundred bytes
+
+MetricsSocket::MetricsSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
+    : Socket(service, closeHandler)
+{
+}
+
+bool MetricsSocket::ProcessIncomingData()
+{
+    std::string buffer;
+    buffer.resize(ReadLengthRemaining());
+    Read(&buffer[0], buffer.size());
+
+    m_request += buffer;
+
+    // pipelined requests are answered in order, a partial one waits for the next read
+    size_t end;
+    while ((end = m_request.find("\r\n\r\n")) != std::string::npos)
+    {
+        std::string const header = m_request.substr(0, end);
+        m_request.erase(0, end + 4);
+
+        HandleRequest(header.substr(0, header.find("\r\n")));
+    }
+
+    if (m_request.size() > METRICS_MAX_REQUEST_SIZE)
+    {
+        sLog.outError("MetricsSocket: request of %s exceeds %d bytes, closing", GetRemoteAddress().c_str(), METRICS_MAX_REQUEST_SIZE);
+        return false;
+    }
+
+    return true;
+}
+
+void MetricsSocket::HandleRequest(std::string const& requestLine)
+{
+    std::istringstream ss(requestLine);
+    std::string method, target;
+    ss >> method >> target;
+
+    // the query string of the scrape config does not select anything
+    target = target.substr(0, target.find('?'));
+
+    if (method == "GET" && (target == "/metrics" || target == "/"))
+        SendResponse("200 OK", Metrics::Render());
+    else
+        SendResponse("404 Not Found", "not found\n");
+}
+
+void MetricsSocket::SendResponse(char const* status, std::string const& body)
+{
+    std::ostringstream header;
+    header << "HTTP/1.1 " << status << "\r\n"
+           << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+           << "Content-Length: " << body.size() << "\r\n"
+           << "\r\n";
+
+    std::string const headerText = header.str();
+    Write(headerText.c_str(), int(headerText.size()), body.c_str(), int(body.size()));
+}
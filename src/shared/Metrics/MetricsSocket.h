@@ -0,0 +1,46 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_METRICS_SOCKET_H
+#define MANGOS_METRICS_SOCKET_H
+
+#include "Common.h"
+
+#include "Network/Socket.hpp"
+
+#include <functional>
+#include <string>
+
+// Minimal HTTP/1.1 endpoint answering "GET /metrics" with Metrics::Render(), for a Prometheus scraper.
+// Every other request gets a 404. The connection is never closed from this side, Close() would drop a reply still
+// being sent, the scraper reads Content-Length bytes and then reuses or closes it.
+class MetricsSocket : public MaNGOS::Socket
+{
+    private:
+        std::string m_request;
+
+        virtual bool ProcessIncomingData() override;
+        void HandleRequest(std::string const& requestLine);
+        void SendResponse(char const* status, std::string const& body);
+
+    public:
+        MetricsSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
+};
+
+#endif
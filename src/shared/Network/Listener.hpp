@@ -20,9 +20,11 @@
 #define __LISTENER_HPP_
 
 #include "NetworkThread.hpp"
+#include "Log.h"
 
 #include <boost/asio.hpp>
 
+#include <future>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -39,6 +41,10 @@ namespace MaNGOS
             std::thread m_acceptorThread;
             std::vector<std::unique_ptr<NetworkThread<SocketType>>> m_workerThreads;
 
+            // with SO_REUSEPORT every worker accepts on its own acceptor and the kernel shards incoming connections.
+            // declared after the workers so that they are destroyed before the services they are bound to
+            std::vector<std::unique_ptr<boost::asio::ip::tcp::acceptor>> m_shardAcceptors;
+
             // the time in milliseconds to sleep a worker thread at the end of each tick
             const int SleepInterval = 100;
 
@@ -61,25 +67,46 @@ namespace MaNGOS
                 return m_workerThreads[minIndex].get();
             }
 
+            bool OpenShardAcceptors(boost::asio::ip::tcp::endpoint const& endpoint);
+
             void BeginAccept();
             void OnAccept(NetworkThread<SocketType> *worker, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec);
 
+            void BeginShardAccept(size_t index);
+            void OnShardAccept(size_t index, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec);
+
         public:
-            Listener(std::string const& address, int port, int workerThreads);
+            Listener(std::string const& address, int port, int workerThreads, bool reusePort = false);
             ~Listener();
     };
 
     template <typename SocketType>
-    Listener<SocketType>::Listener(std::string const& address, int port, int workerThreads)
-    : m_service(), m_acceptor(m_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::address::from_string(address), port))
+    Listener<SocketType>::Listener(std::string const& address, int port, int workerThreads, bool reusePort)
+    : m_service(), m_acceptor(m_service)
     {
         m_workerThreads.reserve(workerThreads);
         for (auto i = 0; i < workerThreads; ++i)
             m_workerThreads.push_back(std::unique_ptr<NetworkThread<SocketType>>(new NetworkThread<SocketType>));
 
-        BeginAccept();
+        boost::asio::ip::tcp::endpoint const endpoint(boost::asio::ip::address::from_string(address), port);
 
-        m_acceptorThread = std::thread([this]() { m_service.run(); });
+        if (reusePort && workerThreads > 1 && OpenShardAcceptors(endpoint))
+        {
+            for (size_t i = 0; i < m_shardAcceptors.size(); ++i)
+                BeginShardAccept(i);
+        }
+        else
+        {
+            m_acceptor.open(endpoint.protocol());
+            m_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            m_acceptor.bind(endpoint);
+            m_acceptor.listen();
+
+            BeginAccept();
+        }
+
+        // when sharding, the acceptor service has no work and this thread exits right away
+        m_acceptorThread = std::thread([this]() { MaNGOS::Thread::SetCurrentThreadName("net-accept"); m_service.run(); });
     }
 
     template <typename SocketType>
@@ -91,6 +118,61 @@ namespace MaNGOS
         // using the m_acceptor object from multiple threads is unsafe!
         m_service.post( [this]() { m_acceptor.close(); } );
         m_acceptorThread.join();
+
+        // shard acceptors live on the worker services, close them there as well.  the aborted accept handler is
+        // queued by close(), so once the second post runs nothing refers to the acceptor anymore
+        for (size_t i = 0; i < m_shardAcceptors.size(); ++i)
+        {
+            boost::asio::io_service& service = m_workerThreads[i]->GetService();
+            std::promise<void> closed;
+
+            service.post([this, i, &service, &closed]()
+            {
+                m_shardAcceptors[i]->close();
+                service.post([&closed]() { closed.set_value(); });
+            });
+
+            closed.get_future().wait();
+        }
+    }
+
+    template <typename SocketType>
+    bool Listener<SocketType>::OpenShardAcceptors(boost::asio::ip::tcp::endpoint const& endpoint)
+    {
+#ifdef SO_REUSEPORT
+        typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> reuse_port;
+
+        boost::system::error_code ec;
+
+        for (auto& worker : m_workerThreads)
+        {
+            std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor(new boost::asio::ip::tcp::acceptor(worker->GetService()));
+
+            acceptor->open(endpoint.protocol(), ec);
+            if (!ec)
+                acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true), ec);
+            if (!ec)
+                acceptor->set_option(reuse_port(true), ec);
+            if (!ec)
+                acceptor->bind(endpoint, ec);
+            if (!ec)
+                acceptor->listen(boost::asio::socket_base::max_connections, ec);
+
+            if (ec)
+            {
+                sLog.outError("Listener: SO_REUSEPORT acceptor setup failed (%s), falling back to a single acceptor.", ec.message().c_str());
+                m_shardAcceptors.clear();
+                return false;
+            }
+
+            m_shardAcceptors.push_back(std::move(acceptor));
+        }
+
+        return true;
+#else
+        sLog.outError("Listener: SO_REUSEPORT is not supported on this platform, using a single acceptor.");
+        return false;
+#endif
     }
 
     template <typename SocketType>
@@ -118,6 +200,31 @@ namespace MaNGOS
         if (m_acceptor.is_open())
             BeginAccept();
     }
+
+    template <typename SocketType>
+    void Listener<SocketType>::BeginShardAccept(size_t index)
+    {
+        auto socket = m_workerThreads[index]->CreateSocket();
+
+        m_shardAcceptors[index]->async_accept(socket->GetAsioSocket(),
+            [this, index, socket] (const boost::system::error_code &ec)
+        {
+            this->OnShardAccept(index, socket, ec);
+        });
+    }
+
+    template <typename SocketType>
+    void Listener<SocketType>::OnShardAccept(size_t index, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec)
+    {
+        // an error has occurred
+        if (ec)
+            m_workerThreads[index]->RemoveSocket(socket.get());
+        else
+            socket->Open();
+
+        if (m_shardAcceptors[index]->is_open())
+            BeginShardAccept(index);
+    }
 }
 
 #endif /* !__LISTENER_HPP_ */
@@ -20,9 +20,12 @@
 #define __NETWORK_THREAD_HPP_
 
 #include "Socket.hpp"
+#include "Metrics/Metrics.h"
+#include "Threading.h"
 
 #include <boost/asio.hpp>
 
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <unordered_set>
@@ -38,13 +41,16 @@ namespace MaNGOS
             std::mutex m_socketLock;
             std::unordered_set<std::shared_ptr<SocketType>> m_sockets;
 
+            // read by the listener to balance connections, without taking m_socketLock
+            std::atomic<size_t> m_socketCount;
+
             // note that the work member *must* be declared after the service member for the work constructor to function correctly
             std::unique_ptr<boost::asio::io_service::work> m_work;
 
             std::thread m_serviceThread;
 
         public:
-            NetworkThread() : m_work(new boost::asio::io_service::work(m_service)), m_serviceThread([this] { boost::system::error_code ec; this->m_service.run(ec); })
+            NetworkThread() : m_socketCount(0), m_work(new boost::asio::io_service::work(m_service)), m_serviceThread([this] { MaNGOS::Thread::SetupCurrentThread("net"); boost::system::error_code ec; this->m_service.run(ec); })
             {
                 m_serviceThread.detach();
             }
@@ -65,14 +71,27 @@ namespace MaNGOS
                 }
             }
 
-            size_t Size() const { return m_sockets.size(); }
+            size_t Size() const { return m_socketCount.load(std::memory_order_relaxed); }
+
+            boost::asio::io_service& GetService() { return m_service; }
 
             std::shared_ptr<SocketType> CreateSocket();
 
             void RemoveSocket(Socket *socket)
             {
                 std::lock_guard<std::mutex> guard(m_socketLock);
-                m_sockets.erase(socket->shared<SocketType>());
+                if (m_sockets.erase(socket->shared<SocketType>()))
+                {
+                    --m_socketCount;
+                    OpenSockets().Add(-1);
+                }
+            }
+
+            // all socket types share the gauge, it is kept up to date even while metrics are disabled so it never drifts
+            static Metrics::Gauge& OpenSockets()
+            {
+                static Metrics::Gauge& gauge = Metrics::GetGauge("mangos_network_sockets", "Open sockets of all listeners");
+                return gauge;
             }
     };
 
@@ -85,6 +104,9 @@ namespace MaNGOS
 
         MANGOS_ASSERT(i.second);
 
+        ++m_socketCount;
+        OpenSockets().Add(1);
+
         return *i.first;
     }
 }
@@ -22,10 +22,85 @@
 #include <cassert>
 #include <vector>
 #include <cstring>
+#include <mutex>
 
 using namespace MaNGOS;
 
-PacketBuffer::PacketBuffer(int initialSize) : m_writePosition(0), m_readPosition(0), m_buffer(initialSize, 0) {}
+namespace
+{
+    // storages of DEFAULT_BUFFER_SIZE given back by idle sockets, kept for the next sockets needing one
+    const size_t MaxPooledStorages = 1024;
+
+    struct StoragePool
+    {
+        std::mutex lock;
+        std::vector<std::vector<uint8>> storages;
+    };
+
+    // never destroyed, sockets may still give storage back while the process exits
+    StoragePool& GetPool()
+    {
+        static StoragePool* pool = new StoragePool;
+        return *pool;
+    }
+
+    void AcquireStorage(std::vector<uint8>& storage, size_t size)
+    {
+        if (size <= DEFAULT_BUFFER_SIZE)
+        {
+            StoragePool& pool = GetPool();
+            std::lock_guard<std::mutex> guard(pool.lock);
+            if (!pool.storages.empty())
+            {
+                storage.swap(pool.storages.back());
+                pool.storages.pop_back();
+                return;
+            }
+            size = DEFAULT_BUFFER_SIZE;
+        }
+
+        storage.resize(size);
+    }
+
+    void ReleaseStorage(std::vector<uint8>& storage)
+    {
+        std::vector<uint8> released;
+        released.swap(storage);
+
+        if (released.size() != DEFAULT_BUFFER_SIZE)
+            return;
+
+        StoragePool& pool = GetPool();
+        std::lock_guard<std::mutex> guard(pool.lock);
+        if (pool.storages.size() < MaxPooledStorages)
+            pool.storages.push_back(std::move(released));
+    }
+}
+
+PacketBuffer::PacketBuffer(int initialSize) : m_writePosition(0), m_readPosition(0)
+{
+    if (initialSize > 0)
+        AcquireStorage(m_buffer, initialSize);
+}
+
+void PacketBuffer::Release()
+{
+    m_writePosition = m_readPosition = 0;
+
+    if (!m_buffer.empty())
+        ReleaseStorage(m_buffer);
+}
+
+void PacketBuffer::Shrink()
+{
+    m_writePosition = m_readPosition = 0;
+
+    if (m_buffer.size() > DEFAULT_BUFFER_SIZE)
+    {
+        ReleaseStorage(m_buffer);
+        AcquireStorage(m_buffer, DEFAULT_BUFFER_SIZE);
+    }
+}
 
 void PacketBuffer::Read(char* buffer, int length)
 {
@@ -43,6 +118,10 @@ void PacketBuffer::Write(const char* buffer, int length)
 
     const size_t newLength = m_writePosition + length;
 
+    if (m_buffer.empty())
+        AcquireStorage(m_buffer, newLength);
+
+    // grown storage is not pooled again, Shrink and Release free it
     if (m_buffer.size() < newLength)
         m_buffer.resize(newLength);
 
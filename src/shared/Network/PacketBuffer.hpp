@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <functional>
+#include <memory>
 
 #include "Platform/Define.h"
 
@@ -28,6 +29,9 @@
 
 namespace MaNGOS
 {
+    // immutable packet body which may be queued on any number of sockets without being copied
+    typedef std::shared_ptr<const std::vector<uint8>> SharedPacketBuffer;
+
     class PacketBuffer
     {
         friend class Socket;
@@ -39,7 +43,9 @@ namespace MaNGOS
             std::vector<uint8> m_buffer;
 
         public:
+            // storage of DEFAULT_BUFFER_SIZE comes from a pool shared by all sockets, an initialSize of 0 starts released
             PacketBuffer(int initialSize = DEFAULT_BUFFER_SIZE);
+            ~PacketBuffer() { Release(); }
 
             uint8 Peak() const { return m_buffer[m_readPosition]; }
 
@@ -47,6 +53,11 @@ namespace MaNGOS
             int ReadLengthRemaining() const { return m_writePosition - m_readPosition; }
 
             void Write(const char *buffer, int length);
+
+            // drops all data and gives the storage back, the next Write takes new storage
+            void Release();
+            // drops all data and returns storage grown above DEFAULT_BUFFER_SIZE, so a burst does not stay allocated
+            void Shrink();
     };
 }
 
@@ -18,9 +18,9 @@
 
 #include "Socket.hpp"
 #include "Log.h"
+#include "Metrics/Metrics.h"
 
 #include <boost/asio.hpp>
-#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/lexical_cast.hpp>
 
 #include <string>
@@ -32,9 +32,24 @@
 
 namespace MaNGOS
 {
+    namespace
+    {
+        Metrics::Counter& BytesReceived()
+        {
+            static Metrics::Counter& counter = Metrics::GetCounter("mangos_network_received_bytes_total", "Bytes read from all sockets");
+            return counter;
+        }
+
+        Metrics::Counter& BytesSent()
+        {
+            static Metrics::Counter& counter = Metrics::GetCounter("mangos_network_sent_bytes_total", "Bytes written to all sockets");
+            return counter;
+        }
+    }
+
     Socket::Socket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
         : m_writeState(WriteState::Idle), m_readState(ReadState::Idle), m_socket(service),
-          m_closeHandler(std::move(closeHandler)), m_outBufferFlushTimer(service), m_address("0.0.0.0") {}
+          m_closeHandler(std::move(closeHandler)), m_service(service), m_address("0.0.0.0") {}
 
     bool Socket::Open()
     {
@@ -49,8 +64,9 @@ namespace MaNGOS
             return false;
         }
 
-        m_outBuffer.reset(new PacketBuffer);
-        m_secondaryOutBuffer.reset(new PacketBuffer);
+        // the output buffers take their storage on the first write
+        m_outBuffer.reset(new PacketBuffer(0));
+        m_secondaryOutBuffer.reset(new PacketBuffer(0));
         m_inBuffer.reset(new PacketBuffer);
 
         StartAsyncRead();
@@ -104,6 +120,9 @@ namespace MaNGOS
 
         m_inBuffer->m_writePosition += length;
 
+        if (Metrics::IsEnabled())
+            BytesReceived().Add(length);
+
         const size_t available = m_socket.available();
 
         // if there is still data to read, increase the buffer size and do so (if necessary)
@@ -139,8 +158,8 @@ namespace MaNGOS
             }
         }
 
-        // at this point, the packet has been read and successfully processed.  reset the buffer.
-        m_inBuffer->m_writePosition = m_inBuffer->m_readPosition = 0;
+        // at this point, the packet has been read and successfully processed.  reset the buffer, dropping what a burst made it grow
+        m_inBuffer->Shrink();
 
         StartAsyncRead();
     }
@@ -165,41 +184,111 @@ namespace MaNGOS
         return true;
     }
 
-    void Socket::Write(const char* header, int headerSize, const char* content, int contentSize)
+    void Socket::Write(const char* header, int headerSize, const char* content, int contentSize, bool encryptHeader)
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
-
         // write the header
-        outBuffer->Write(header, headerSize);
+        AppendHeader(header, headerSize, encryptHeader);
 
         // write the content
-        outBuffer->Write(content, contentSize);
+        if (contentSize > 0)
+            AppendOut(content, contentSize);
 
         // flush data if need
         if (m_writeState == WriteState::Idle)
-            StartWriteFlushTimer();
+            ScheduleFlushOut();
     }
 
-    void Socket::Write(const char* buffer, int length)
+    void Socket::Write(const char* header, int headerSize, const SharedPacketBuffer& content, bool encryptHeader)
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        // write the header
+        AppendHeader(header, headerSize, encryptHeader);
+
+        // queue the content by reference, it is sent from its own storage
+        std::vector<OutSegment>& segments = m_writeState == WriteState::Sending ? m_secondaryOutSegments : m_outSegments;
+        segments.push_back({ 0, content->size(), content });
+
+        // flush data if need
+        if (m_writeState == WriteState::Idle)
+            ScheduleFlushOut();
+    }
+
+    void Socket::Write(const char* buffer, int length)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
 
         // write the header
-        outBuffer->Write(buffer, length);
+        AppendOut(buffer, length);
 
         // flush data if need
         if (m_writeState == WriteState::Idle)
-            StartWriteFlushTimer();
+            ScheduleFlushOut();
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::AppendOut(const char* buffer, int length)
+    {
+        // get the correct buffer depending on the current writing state
+        const bool sending = m_writeState == WriteState::Sending;
+        PacketBuffer* outBuffer = sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        std::vector<OutSegment>& segments = sending ? m_secondaryOutSegments : m_outSegments;
+
+        const size_t offset = outBuffer->m_writePosition;
+        outBuffer->Write(buffer, length);
+
+        // extend the last segment when it ends where this write starts
+        if (!segments.empty() && !segments.back().payload && segments.back().offset + segments.back().length == offset)
+            segments.back().length += length;
+        else
+            segments.push_back({ offset, size_t(length), nullptr });
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::AppendHeader(const char* header, int headerSize, bool encryptHeader)
+    {
+        if (encryptHeader)
+        {
+            const bool sending = m_writeState == WriteState::Sending;
+            PacketBuffer* outBuffer = sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+            std::vector<size_t>& headers = sending ? m_secondaryOutHeaders : m_outHeaders;
+            headers.push_back(outBuffer->m_writePosition);
+        }
+
+        AppendOut(header, headerSize);
     }
 
 // note that this function assumes that the socket mutex is locked
-    void Socket::StartWriteFlushTimer()
+    void Socket::StartSend()
+    {
+        // all headers queued since the last send are encrypted in one pass
+        if (!m_outHeaders.empty())
+        {
+            EncryptHeaders(&m_outBuffer->m_buffer[0], m_outHeaders);
+            m_outHeaders.clear();
+        }
+
+        m_sendBuffers.clear();
+        m_sendBuffers.reserve(m_outSegments.size());
+
+        for (OutSegment const& segment : m_outSegments)
+        {
+            if (segment.payload)
+                m_sendBuffers.emplace_back(segment.payload->data(), segment.length);
+            else
+                m_sendBuffers.emplace_back(&m_outBuffer->m_buffer[segment.offset], segment.length);
+        }
+
+        std::shared_ptr<Socket> ptr = shared<Socket>();
+        boost::asio::async_write(m_socket, m_sendBuffers,
+                                 make_custom_alloc_handler(m_allocator,
+        [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length); }));
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::ScheduleFlushOut()
     {
         if (m_writeState == WriteState::Buffering)
             return;
@@ -213,9 +302,10 @@ namespace MaNGOS
 
         m_writeState = WriteState::Buffering;
 
+        // an idle socket is flushed as soon as the network thread gets to it, anything written until then goes out
+        // in the same send.  under load the writes made while a send is underway are coalesced by OnWriteComplete()
         std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_outBufferFlushTimer.expires_from_now(boost::posix_time::milliseconds(int(BufferTimeout)));
-        m_outBufferFlushTimer.async_wait([ptr](const boost::system::error_code&) { ptr->FlushOut(); });
+        m_service.post([ptr]() { ptr->FlushOut(); });
     }
 
     void Socket::FlushOut()
@@ -234,18 +324,7 @@ namespace MaNGOS
         // at this point we are guarunteed that there is data to send in the primary buffer.  send it.
         m_writeState = WriteState::Sending;
 
-        std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                  make_custom_alloc_handler(m_allocator,
-        [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length); }));
-    }
-
-// if the write state is idle, this will do nothing, which is correct
-// if the write state is sending, this will do nothing, which is correct
-// if the write state is buffering, this will cancel the running timer, which will immediately trigger FlushOut()
-    void Socket::ForceFlushOut()
-    {
-        m_outBufferFlushTimer.cancel();
+        StartSend();
     }
 
     void Socket::OnWriteComplete(const boost::system::error_code& error, size_t length)
@@ -264,41 +343,32 @@ namespace MaNGOS
             return;
         }
 
+        if (Metrics::IsEnabled())
+            BytesSent().Add(length);
+
         std::lock_guard<std::mutex> guard(m_mutex);
 
         assert(m_writeState == WriteState::Sending);
-        assert(length <= m_outBuffer->m_writePosition);
 
-        // if there is data left to write, move it to the start of the buffer
-        if (length < m_outBuffer->m_writePosition)
-        {
-            memcpy(&(m_outBuffer->m_buffer[0]), &(m_outBuffer->m_buffer[length]), (m_outBuffer->m_writePosition - length) * sizeof(m_outBuffer->m_buffer[0]));
-            m_outBuffer->m_writePosition -= length;
-        }
-        // if not, reset the write pointer
-        else
-            m_outBuffer->m_writePosition = 0;
-
-        // if there is data in the secondary buffer, append it to the primary buffer
-        if (m_secondaryOutBuffer->m_writePosition > 0)
-        {
-            // do we have enough space? if not, resize
-            if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
-                m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
-
-            memcpy(&(m_outBuffer->m_buffer[m_outBuffer->m_writePosition]), &(m_secondaryOutBuffer->m_buffer[0]), (m_secondaryOutBuffer->m_writePosition) * sizeof(m_secondaryOutBuffer->m_buffer[0]));
+        // async_write only completes once the whole buffer sequence is sent, so the primary buffer is done with.
+        // dropping the segments releases any shared payloads they referenced
+        m_outBuffer->m_writePosition = 0;
+        m_outSegments.clear();
 
-            m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
-            m_secondaryOutBuffer->m_writePosition = 0;
-        }
+        // whatever was written in the meantime becomes the primary buffer
+        std::swap(m_outBuffer, m_secondaryOutBuffer);
+        std::swap(m_outSegments, m_secondaryOutSegments);
+        std::swap(m_outHeaders, m_secondaryOutHeaders);
 
-        std::shared_ptr<Socket> ptr = shared<Socket>();
         // if there is any data to write, do so immediately
-        if (m_outBuffer->m_writePosition > 0)
-            m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                      make_custom_alloc_handler(m_allocator,
-            [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length);}));
+        if (!m_outSegments.empty())
+            StartSend();
         else
+        {
+            // an idle socket keeps no output storage, the next write takes it from the pool again
+            m_outBuffer->Release();
+            m_secondaryOutBuffer->Release();
             m_writeState = WriteState::Idle;
+        }
     }
 }
@@ -29,20 +29,17 @@
 #include <string>
 #include <mutex>
 #include <functional>
+#include <vector>
 
 namespace MaNGOS
 {
     class Socket : public std::enable_shared_from_this<Socket>
     {
         private:
-            // buffer timeout period, in milliseconds.  higher values decrease responsiveness
-            // ingame but increase bandwidth efficiency by reducing tcp overhead.
-            static const int BufferTimeout = 50;
-
             enum class WriteState
             {
                 Idle,       // no write operation is currently underway
-                Buffering,  // a write operation has been performed, and we are currently awaiting others before sending
+                Buffering,  // a write operation has been performed, and a flush is queued on the network thread
                 Sending,    // a send operation is underway
             };
 
@@ -59,18 +56,40 @@ namespace MaNGOS
 
             std::function<void(Socket *)> m_closeHandler;
 
+            // a contiguous range of an output buffer, or a shared payload which is sent straight from its own storage
+            struct OutSegment
+            {
+                size_t offset;
+                size_t length;
+                SharedPacketBuffer payload;
+            };
+
             std::unique_ptr<PacketBuffer> m_inBuffer;
             std::unique_ptr<PacketBuffer> m_outBuffer;
             std::unique_ptr<PacketBuffer> m_secondaryOutBuffer;
 
+            // send order of the data in the matching output buffer
+            std::vector<OutSegment> m_outSegments;
+            std::vector<OutSegment> m_secondaryOutSegments;
+
+            // positions of the headers written with encryptHeader in the matching output buffer
+            std::vector<size_t> m_outHeaders;
+            std::vector<size_t> m_secondaryOutHeaders;
+
+            // buffer sequence of the write currently underway, built from m_outSegments
+            std::vector<boost::asio::const_buffer> m_sendBuffers;
+
             std::mutex m_mutex;
             std::mutex m_closeMutex;
-            boost::asio::deadline_timer m_outBufferFlushTimer;
+            boost::asio::io_service &m_service;
 
             void StartAsyncRead();
             void OnRead(const boost::system::error_code &error, size_t length);
 
-            void StartWriteFlushTimer();
+            void AppendOut(const char *buffer, int length);
+            void AppendHeader(const char *header, int headerSize, bool encryptHeader);
+            void StartSend();
+            void ScheduleFlushOut();
             void OnWriteComplete(const boost::system::error_code &error, size_t length);
             void FlushOut();
 
@@ -82,12 +101,14 @@ namespace MaNGOS
 
             virtual bool ProcessIncomingData() = 0;
 
+            // called with the socket mutex locked right before a send, gets the headers written with encryptHeader in write order
+            // so a stream cipher sees them in the order they go out
+            virtual void EncryptHeaders(uint8* /*buffer*/, std::vector<size_t> const& /*headerPositions*/) {}
+
             const uint8 *InPeak() const { return &m_inBuffer->m_buffer[m_inBuffer->m_readPosition]; }
 
             int ReadLengthRemaining() const { return m_inBuffer->ReadLengthRemaining(); }
 
-            void ForceFlushOut();
-
         public:
             Socket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler);
             virtual ~Socket() = default;
@@ -102,9 +123,12 @@ namespace MaNGOS
             void ReadSkip(int length) { m_inBuffer->Read(nullptr, length); }
 
             void Write(const char *buffer, int length);
-            void Write(const char *header, int headerSize, const char* content, int contentSize);
+            void Write(const char *header, int headerSize, const char* content, int contentSize, bool encryptHeader = false);
+            void Write(const char *header, int headerSize, const SharedPacketBuffer &content, bool encryptHeader = false);
 
             boost::asio::ip::tcp::socket &GetAsioSocket() { return m_socket; }
+            // service of the network thread running this socket, work posted here never runs in parallel with its reads
+            boost::asio::io_service &GetService() { return m_service; }
 
             const std::string &GetRemoteEndpoint() const { return m_remoteEndpoint; }
             const std::string &GetRemoteAddress() const { return m_address; }
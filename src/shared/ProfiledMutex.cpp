@@ -0,0 +1,161 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "ProfiledMutex.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+std::atomic<bool> LockProfiler::m_enabled(false);
+
+namespace
+{
+    struct LockRegistry
+    {
+        std::mutex lock;
+        std::map<std::string, std::unique_ptr<LockProfiler::Counters>> counters;
+        std::atomic<time_t> resetTime;
+
+        LockRegistry() : resetTime(time(nullptr)) {}
+    };
+
+    // function local so locks of other static objects can register during static initialization,
+    // never destroyed as locks of static objects may still be released at exit
+    LockRegistry& GetRegistry()
+    {
+        static LockRegistry* registry = new LockRegistry;
+        return *registry;
+    }
+
+    void UpdateMax(std::atomic<uint64>& max, uint64 value)
+    {
+        uint64 current = max.load(std::memory_order_relaxed);
+        while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+    }
+}
+
+void LockProfiler::Counters::Reset()
+{
+    acquisitions = 0;
+    contentions = 0;
+    waitNs = 0;
+    maxWaitNs = 0;
+    holdNs = 0;
+    maxHoldNs = 0;
+}
+
+LockProfiler::Counters* LockProfiler::Register(char const* name)
+{
+    LockRegistry& registry = GetRegistry();
+
+    std::lock_guard<std::mutex> guard(registry.lock);
+    std::unique_ptr<Counters>& counters = registry.counters[name];
+    if (!counters)
+        counters.reset(new Counters(name));
+    return counters.get();
+}
+
+void LockProfiler::Reset()
+{
+    LockRegistry& registry = GetRegistry();
+
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (auto& itr : registry.counters)
+        itr.second->Reset();
+    registry.resetTime = time(nullptr);
+}
+
+uint32 LockProfiler::GetCollectTime()
+{
+    return uint32(std::max<time_t>(time(nullptr) - GetRegistry().resetTime, 1));
+}
+
+std::vector<LockProfiler::Summary> LockProfiler::GetEntries()
+{
+    LockRegistry& registry = GetRegistry();
+    std::vector<Summary> summaries;
+
+    {
+        std::lock_guard<std::mutex> guard(registry.lock);
+        for (auto const& itr : registry.counters)
+        {
+            Counters const& counters = *itr.second;
+            uint64 acquisitions = counters.acquisitions.load(std::memory_order_relaxed);
+            if (!acquisitions)
+                continue;
+
+            Summary summary;
+            summary.name = counters.name;
+            summary.acquisitions = acquisitions;
+            summary.contentions = counters.contentions.load(std::memory_order_relaxed);
+            summary.waitUs = counters.waitNs.load(std::memory_order_relaxed) / 1000;
+            summary.maxWaitUs = counters.maxWaitNs.load(std::memory_order_relaxed) / 1000;
+            summary.holdUs = counters.holdNs.load(std::memory_order_relaxed) / 1000;
+            summary.maxHoldUs = counters.maxHoldNs.load(std::memory_order_relaxed) / 1000;
+            summaries.push_back(summary);
+        }
+    }
+
+    std::sort(summaries.begin(), summaries.end(), [](Summary const & a, Summary const & b) { return a.waitUs > b.waitUs; });
+    return summaries;
+}
+
+void LockProfiler::LogReport()
+{
+    std::vector<Summary> summaries = GetEntries();
+    if (summaries.empty())
+        return;
+
+    uint32 const seconds = GetCollectTime();
+    sLog.outString("Lock profile of the last %u seconds, by total wait time:", seconds);
+    for (Summary const& summary : summaries)
+        sLog.outString("%8" PRIu64 " locks %.1f/s, %5.1f%% contended, wait " UI64FMTD " ms max " UI64FMTD " us, hold " UI64FMTD " ms max " UI64FMTD " us: %s",
+                       summary.acquisitions, double(summary.acquisitions) / seconds, summary.contentions * 100.0 / summary.acquisitions,
+                       summary.waitUs / 1000, summary.maxWaitUs, summary.holdUs / 1000, summary.maxHoldUs, summary.name.c_str());
+}
+
+void ProfiledMutex::LockProfiled()
+{
+    m_counters->acquisitions.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_mutex.try_lock())
+    {
+        m_lockedAt = LockProfiler::Now();
+        return;
+    }
+
+    uint64 const start = LockProfiler::Now();
+    m_mutex.lock();
+    m_lockedAt = LockProfiler::Now();
+
+    uint64 const wait = m_lockedAt - start;
+    m_counters->contentions.fetch_add(1, std::memory_order_relaxed);
+    m_counters->waitNs.fetch_add(wait, std::memory_order_relaxed);
+    UpdateMax(m_counters->maxWaitNs, wait);
+}
+
+void ProfiledMutex::RecordHold()
+{
+    uint64 const hold = LockProfiler::Now() - m_lockedAt;
+    m_lockedAt = 0;
+    m_counters->holdNs.fetch_add(hold, std::memory_order_relaxed);
+    UpdateMax(m_counters->maxHoldNs, hold);
+}
@@ -0,0 +1,133 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_PROFILEDMUTEX_H
+#define MANGOS_PROFILEDMUTEX_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Wait time, hold time and contention counters of the instrumented locks, collected while enabled.
+// All instances constructed with the same name share one entry, so the lock of every map or session adds up.
+class LockProfiler
+{
+    public:
+        struct Counters
+        {
+            explicit Counters(char const* _name) : name(_name) { Reset(); }
+            void Reset();
+
+            std::string const name;
+            std::atomic<uint64> acquisitions;
+            std::atomic<uint64> contentions;                // acquisitions that found the lock taken
+            std::atomic<uint64> waitNs;
+            std::atomic<uint64> maxWaitNs;
+            std::atomic<uint64> holdNs;
+            std::atomic<uint64> maxHoldNs;
+        };
+
+        struct Summary
+        {
+            std::string name;
+            uint64 acquisitions;
+            uint64 contentions;
+            uint64 waitUs;
+            uint64 maxWaitUs;
+            uint64 holdUs;
+            uint64 maxHoldUs;
+        };
+
+        static void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+        static bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+        // entry of the name, created on first use and kept for the lifetime of the process
+        static Counters* Register(char const* name);
+
+        static void Reset();
+        // seconds since the last reset
+        static uint32 GetCollectTime();
+
+        // locks ordered by total wait time, the ones never taken are left out
+        static std::vector<Summary> GetEntries();
+        static void LogReport();
+
+        static uint64 Now() { return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()); }
+
+    private:
+        static std::atomic<bool> m_enabled;
+};
+
+// std::mutex that reports to the LockProfiler under its name. While profiling is disabled
+// lock and unlock only add a relaxed load of the enabled flag.
+// Use std::condition_variable_any to wait on it, the reacquisition after a wakeup counts as a normal lock.
+class ProfiledMutex
+{
+    public:
+        explicit ProfiledMutex(char const* name) : m_counters(LockProfiler::Register(name)), m_lockedAt(0) {}
+        ProfiledMutex(ProfiledMutex const&) = delete;
+        ProfiledMutex& operator=(ProfiledMutex const&) = delete;
+
+        void lock()
+        {
+            if (!LockProfiler::IsEnabled())
+            {
+                m_mutex.lock();
+                m_lockedAt = 0;
+                return;
+            }
+            LockProfiled();
+        }
+
+        bool try_lock()
+        {
+            if (!m_mutex.try_lock())
+                return false;
+
+            m_lockedAt = 0;
+            if (LockProfiler::IsEnabled())
+            {
+                m_counters->acquisitions.fetch_add(1, std::memory_order_relaxed);
+                m_lockedAt = LockProfiler::Now();
+            }
+            return true;
+        }
+
+        void unlock()
+        {
+            // only the owner writes m_lockedAt, locks taken before profiling was enabled are not timed
+            if (m_lockedAt)
+                RecordHold();
+            m_mutex.unlock();
+        }
+
+    private:
+        void LockProfiled();
+        void RecordHold();
+
+        std::mutex m_mutex;
+        LockProfiler::Counters* m_counters;
+        uint64 m_lockedAt;                                  // steady clock ns of the acquisition while profiled
+};
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "TaskGraph.h"
+#include "Log.h"
+#include "Timer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace MaNGOS
+{
+    bool TaskGraph::AddTask(std::string const& name, Task task, std::vector<std::string> const& dependsOn)
+    {
+        Node node;
+        node.name = name;
+        node.task = std::move(task);
+        node.dependencyCount = 0;
+        node.duration = 0;
+        node.finishedAt = 0;
+
+        size_t const index = m_nodes.size();
+        std::vector<size_t> dependencies;
+        for (std::string const& dependency : dependsOn)
+        {
+            auto itr = std::find_if(m_nodes.begin(), m_nodes.end(), [&dependency](Node const& other) { return other.name == dependency; });
+            if (itr == m_nodes.end())
+            {
+                sLog.outError("TaskGraph %s: task %s depends on unknown task %s", m_name.c_str(), name.c_str(), dependency.c_str());
+                return false;
+            }
+
+            dependencies.push_back(itr - m_nodes.begin());
+        }
+
+        for (size_t dependency : dependencies)
+            m_nodes[dependency].dependents.push_back(index);
+
+        node.dependencyCount = dependencies.size();
+        m_nodes.push_back(std::move(node));
+        return true;
+    }
+
+    void TaskGraph::Run(uint32 threadCount, Task threadStart, Task threadEnd)
+    {
+        uint32 const startTime = WorldTimer::getMSTime();
+
+        std::mutex lock;
+        std::condition_variable condition;
+        std::vector<size_t> ready;
+        std::vector<uint32> pending(m_nodes.size());
+        size_t remaining = m_nodes.size();
+
+        for (size_t i = 0; i < m_nodes.size(); ++i)
+        {
+            pending[i] = m_nodes[i].dependencyCount;
+            if (!pending[i])
+                ready.push_back(i);
+        }
+
+        // tasks are added in dependency order, so running them in that order is valid without threads
+        if (threadCount <= 1)
+        {
+            for (Node& node : m_nodes)
+            {
+                uint32 const taskStart = WorldTimer::getMSTime();
+                node.task();
+                node.duration = WorldTimer::getMSTimeDiff(taskStart, WorldTimer::getMSTime());
+                node.finishedAt = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+            }
+
+            m_totalTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+            return;
+        }
+
+        auto worker = [&]()
+        {
+            if (threadStart)
+                threadStart();
+
+            std::unique_lock<std::mutex> guard(lock);
+            while (remaining)
+            {
+                if (ready.empty())
+                {
+                    condition.wait(guard);
+                    continue;
+                }
+
+                size_t const index = ready.back();
+                ready.pop_back();
+                Node& node = m_nodes[index];
+
+                guard.unlock();
+                uint32 const taskStart = WorldTimer::getMSTime();
+                node.task();
+                uint32 const taskEnd = WorldTimer::getMSTime();
+                guard.lock();
+
+                node.duration = WorldTimer::getMSTimeDiff(taskStart, taskEnd);
+                node.finishedAt = WorldTimer::getMSTimeDiff(startTime, taskEnd);
+                for (size_t dependent : node.dependents)
+                    if (!--pending[dependent])
+                        ready.push_back(dependent);
+
+                --remaining;
+                condition.notify_all();
+            }
+            guard.unlock();
+
+            if (threadEnd)
+                threadEnd();
+        };
+
+        std::vector<std::thread> threads;
+        threadCount = std::min<uint32>(threadCount, m_nodes.size());
+        for (uint32 i = 0; i < threadCount; ++i)
+            threads.emplace_back(worker);
+
+        for (auto& thread : threads)
+            thread.join();
+
+        m_totalTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+    }
+
+    void TaskGraph::LogTimings() const
+    {
+        uint32 taskTime = 0;
+        for (Node const& node : m_nodes)
+        {
+            sLog.outString("  %-40s %6u ms (done at %u ms)", node.name.c_str(), node.duration, node.finishedAt);
+            taskTime += node.duration;
+        }
+
+        sLog.outString(">> %s: %u tasks in %u ms (%u ms if loaded one after another)", m_name.c_str(), uint32(m_nodes.size()), m_totalTime, taskTime);
+    }
+}
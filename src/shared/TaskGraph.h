@@ -0,0 +1,63 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MANGOS_TASKGRAPH_H
+#define MANGOS_TASKGRAPH_H
+
+#include "Common.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace MaNGOS
+{
+    // Runs named tasks on a set of worker threads, a task is started only after all tasks it depends on finished.
+    // Tasks without mutual dependency must not touch the same data.
+    class TaskGraph
+    {
+        public:
+            typedef std::function<void()> Task;
+
+            explicit TaskGraph(std::string const& name) : m_name(name) {}
+
+            // dependencies have to be added before the tasks depending on them
+            bool AddTask(std::string const& name, Task task, std::vector<std::string> const& dependsOn = std::vector<std::string>());
+
+            // threadStart/threadEnd are called in every worker thread, threadCount 1 or less runs all tasks in the calling thread
+            void Run(uint32 threadCount, Task threadStart = Task(), Task threadEnd = Task());
+
+            // per task duration and completion time of the last Run(), output to sLog
+            void LogTimings() const;
+
+        private:
+            struct Node
+            {
+                std::string name;
+                Task task;
+                std::vector<size_t> dependents;
+                uint32 dependencyCount;
+                uint32 duration;                            // in ms, filled when the task finished
+                uint32 finishedAt;                          // in ms since Run() start
+            };
+
+            std::string m_name;
+            std::vector<Node> m_nodes;
+            uint32 m_totalTime = 0;
+    };
+}
+#endif
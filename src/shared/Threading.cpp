@@ -18,9 +18,22 @@
 
 #include "Threading.h"
 #include "Errors.h"
+#include "Log.h"
 
 #include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
 #include <system_error>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 using namespace MaNGOS;
 
@@ -135,3 +148,170 @@ void Thread::Sleep(unsigned long msecs)
 {
     std::this_thread::sleep_for(std::chrono::milliseconds(msecs));
 }
+
+namespace
+{
+    struct ThreadPoolInfo
+    {
+        ThreadPoolInfo() : affinity(Affinity_None), started(0) {}
+
+        Affinity affinity;
+        size_t started;
+    };
+
+    std::mutex s_poolLock;
+    std::map<std::string, ThreadPoolInfo> s_pools;
+    std::vector<std::vector<int>> s_nodeProcessors;         // processors usable by the process, by NUMA node
+
+    void LoadProcessorTopology()
+    {
+        if (!s_nodeProcessors.empty())
+            return;
+
+        std::vector<int> usable;
+#if defined(_WIN32)
+        DWORD_PTR processMask, systemMask;
+        if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+            for (int i = 0; i < int(sizeof(DWORD_PTR) * 8); ++i)
+                if (processMask & (DWORD_PTR(1) << i))
+                    usable.push_back(i);
+#elif defined(__linux__)
+        cpu_set_t processSet;
+        CPU_ZERO(&processSet);
+        if (sched_getaffinity(0, sizeof(processSet), &processSet) == 0)
+            for (int i = 0; i < CPU_SETSIZE; ++i)
+                if (CPU_ISSET(i, &processSet))
+                    usable.push_back(i);
+
+        // the cpulist of each node reads like "0-7,16-23"
+        for (int node = 0;; ++node)
+        {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!file)
+                break;
+
+            std::vector<int> processors;
+            std::string range;
+            while (std::getline(file, range, ','))
+            {
+                int first = 0, last = 0;
+                char dash = 0;
+                std::istringstream rangeStream(range);
+                rangeStream >> first;
+                if (!(rangeStream >> dash >> last))
+                    last = first;
+
+                for (int i = first; i <= last; ++i)
+                    if (CPU_ISSET(i, &processSet))
+                        processors.push_back(i);
+            }
+
+            if (!processors.empty())
+                s_nodeProcessors.push_back(processors);
+        }
+#endif
+
+        // without node information all processors are one node
+        if (s_nodeProcessors.empty() && !usable.empty())
+            s_nodeProcessors.push_back(usable);
+    }
+
+    // fills the processors for the index-th thread of a pool
+    void SelectProcessors(Affinity affinity, size_t index, std::vector<int>& processors)
+    {
+        size_t const nodeCount = s_nodeProcessors.size();
+        switch (affinity)
+        {
+            case Affinity_Pin:
+            {
+                size_t total = 0;
+                for (auto const& node : s_nodeProcessors)
+                    total += node.size();
+
+                size_t position = index % total;
+                for (auto const& node : s_nodeProcessors)
+                {
+                    if (position < node.size())
+                    {
+                        processors.push_back(node[position]);
+                        break;
+                    }
+                    position -= node.size();
+                }
+                break;
+            }
+            case Affinity_Spread:
+            {
+                std::vector<int> const& node = s_nodeProcessors[index % nodeCount];
+                processors.push_back(node[(index / nodeCount) % node.size()]);
+                break;
+            }
+            case Affinity_NumaLocal:
+                processors = s_nodeProcessors[index % nodeCount];
+                break;
+            default:
+                break;
+        }
+    }
+
+    bool SetCurrentThreadProcessors(std::vector<int> const& processors)
+    {
+#if defined(_WIN32)
+        DWORD_PTR mask = 0;
+        for (int processor : processors)
+            mask |= DWORD_PTR(1) << processor;
+        return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int processor : processors)
+            CPU_SET(processor, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+}
+
+void Thread::SetPoolAffinity(char const* pool, Affinity affinity)
+{
+    std::lock_guard<std::mutex> guard(s_poolLock);
+    LoadProcessorTopology();
+    s_pools[pool].affinity = affinity;
+}
+
+void Thread::SetupCurrentThread(char const* pool)
+{
+    Affinity affinity;
+    size_t index;
+    std::vector<int> processors;
+    {
+        std::lock_guard<std::mutex> guard(s_poolLock);
+        ThreadPoolInfo& info = s_pools[pool];
+        affinity = info.affinity;
+        index = info.started++;
+
+        if (affinity != Affinity_None && !s_nodeProcessors.empty())
+            SelectProcessors(affinity, index, processors);
+    }
+
+    SetCurrentThreadName((std::string(pool) + "-" + std::to_string(index)).c_str());
+
+    if (!processors.empty() && !SetCurrentThreadProcessors(processors))
+        sLog.outError("Can't set the affinity of %s thread %u", pool, uint32(index));
+}
+
+void Thread::SetCurrentThreadName(char const* name)
+{
+#if defined(__linux__)
+    char shortName[16];
+    strncpy(shortName, name, sizeof(shortName) - 1);
+    shortName[sizeof(shortName) - 1] = '\0';
+    pthread_setname_np(pthread_self(), shortName);
+#elif defined(__APPLE__)
+    pthread_setname_np(name);
+#else
+    // SetThreadDescription needs a newer Windows SDK than the one supported
+    (void)name;
+#endif
+}
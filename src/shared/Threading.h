@@ -51,6 +51,15 @@ namespace MaNGOS
         Priority_Realtime,
     };
 
+    enum Affinity
+    {
+        Affinity_None,                                      // left to the OS
+        Affinity_Pin,                                       // one processor per thread, filling one NUMA node after the other
+        Affinity_Spread,                                    // one processor per thread, alternating between NUMA nodes
+        Affinity_NumaLocal,                                 // all processors of one NUMA node, alternating between nodes
+        Affinity_Max
+    };
+
     class Thread
     {
         public:
@@ -66,6 +75,13 @@ namespace MaNGOS
             static void Sleep(unsigned long msecs);
             static std::thread::id currentId();
 
+            // must be set before the threads of the pool start, the processor topology is read on the first call
+            static void SetPoolAffinity(char const* pool, Affinity affinity);
+            // names the calling thread "<pool>-<n>" and applies the affinity of its pool, n counts the started threads of the pool
+            static void SetupCurrentThread(char const* pool);
+            // visible in debuggers and top, truncated to 15 characters on Linux
+            static void SetCurrentThreadName(char const* name);
+
         private:
             Thread(const Thread&);
             Thread& operator=(const Thread&);
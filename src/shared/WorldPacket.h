@@ -23,6 +23,8 @@
 #include "ByteBuffer.h"
 #include "Server/Opcodes.h"
 #include <chrono>
+#include <memory>
+#include <vector>
 
 // Note: m_opcode and size stored in platfom dependent format
 // ignore endianess until send, and converted at receive
@@ -33,7 +35,10 @@ class WorldPacket : public ByteBuffer
         WorldPacket()                                       : ByteBuffer(0), m_opcode(MSG_NULL_ACTION)
         {
         }
-        explicit WorldPacket(Opcodes opcode, size_t res = 200) : ByteBuffer(res), m_opcode(opcode) { }
+        explicit WorldPacket(Opcodes opcode, size_t res = 200) : ByteBuffer(res), m_opcode(opcode)
+        {
+            CountOpcodeAllocation(opcode);
+        }
         // copy constructor
         WorldPacket(const WorldPacket& packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode)
         {
@@ -48,6 +53,7 @@ class WorldPacket : public ByteBuffer
             clear();
             _storage.reserve(newres);
             m_opcode = opcode;
+            CountOpcodeAllocation(opcode);
         }
 
         Opcodes GetOpcode() const { return m_opcode; }
@@ -61,4 +67,25 @@ class WorldPacket : public ByteBuffer
         Opcodes m_opcode;
         std::chrono::steady_clock::time_point m_receivedTime; // only set for a specific set of opcodes, for performance reasons.
 };
+
+// Body of a packet which is sent to many receivers. The payload is copied once on first use
+// and then queued by reference on every socket, only the header is encrypted per receiver.
+class SharedPacketPayload
+{
+    public:
+        explicit SharedPacketPayload(WorldPacket const& packet) : m_packet(packet) {}
+
+        WorldPacket const& GetPacket() const { return m_packet; }
+
+        std::shared_ptr<const std::vector<uint8>> const& GetPayload() const
+        {
+            if (!m_payload)
+                m_payload = std::make_shared<const std::vector<uint8>>(m_packet.contents(), m_packet.contents() + m_packet.size());
+            return m_payload;
+        }
+
+    private:
+        WorldPacket const& m_packet;
+        mutable std::shared_ptr<const std::vector<uint8>> m_payload;
+};
 #endif